@@ -0,0 +1,476 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../cJSON.h"
+#include "../cJSON_Utils.h"
+
+/* Every operation is repeated until it ran for at least this long */
+#define MINIMUM_SECONDS 0.25
+
+typedef struct
+{
+    const char *name;
+    char *json;
+    size_t length;
+    cJSON *tree;
+    size_t nodes;
+} document;
+
+static size_t allocations = 0;
+
+static void *counting_malloc(size_t size)
+{
+    allocations++;
+    return malloc(size);
+}
+
+static void counting_free(void *pointer)
+{
+    free(pointer);
+}
+
+static size_t count_nodes(const cJSON *item)
+{
+    size_t nodes = 1;
+    const cJSON *child = NULL;
+
+    for (child = item->child; child != NULL; child = child->next)
+    {
+        nodes += count_nodes(child);
+    }
+
+    return nodes;
+}
+
+static char *read_file(const char *filename, size_t *length)
+{
+    FILE *file = NULL;
+    long size = 0;
+    char *content = NULL;
+
+    file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    if ((fseek(file, 0, SEEK_END) != 0) || ((size = ftell(file)) < 0) || (fseek(file, 0, SEEK_SET) != 0))
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    content = (char*)malloc((size_t)size + 1);
+    if ((content != NULL) && (fread(content, 1, (size_t)size, file) != (size_t)size))
+    {
+        free(content);
+        content = NULL;
+    }
+    fclose(file);
+    if (content == NULL)
+    {
+        return NULL;
+    }
+    content[size] = '\0';
+    *length = (size_t)size;
+
+    return content;
+}
+
+/* Synthetic stand-ins for the usual benchmark files, so the benchmark runs without downloading anything. */
+
+/* like twitter.json: records with short strings, some unicode, nested objects */
+static cJSON *create_records(void)
+{
+    cJSON *records = cJSON_CreateArray();
+    int i = 0;
+
+    for (i = 0; i < 2000; i++)
+    {
+        cJSON *record = cJSON_CreateObject();
+        cJSON *user = cJSON_CreateObject();
+        int hashtags[3];
+
+        hashtags[0] = i;
+        hashtags[1] = i * 7;
+        hashtags[2] = i * 13;
+        cJSON_AddNumberToObject(record, "id", 500000000.0 + i);
+        cJSON_AddStringToObject(record, "created_at", "Sun Aug 31 00:29:15 +0000 2014");
+        cJSON_AddStringToObject(record, "text", "@aym0566x \xe5\x90\x8d\xe5\x89\x8d:\xe5\x89\x8d\xe7\x94\xb0\xe3\x81\x82\xe3\x82\x86\xe3\x81\xbf \"quoted\"\n\xe7\xac\xac\xe4\xb8\x80\xe5\x8d\xb0\xe8\xb1\xa1");
+        cJSON_AddFalseToObject(record, "truncated");
+        cJSON_AddNullToObject(record, "in_reply_to_status_id");
+        cJSON_AddNumberToObject(user, "id", 1186275104 + i);
+        cJSON_AddStringToObject(user, "screen_name", "ayuu0123");
+        cJSON_AddStringToObject(user, "location", "\xe6\x9d\xb1\xe4\xba\xac");
+        cJSON_AddNumberToObject(user, "followers_count", 262);
+        cJSON_AddTrueToObject(user, "verified");
+        cJSON_AddItemToObject(record, "user", user);
+        cJSON_AddItemToObject(record, "hashtags", cJSON_CreateIntArray(hashtags, 3));
+        cJSON_AddItemToArray(records, record);
+    }
+
+    return records;
+}
+
+/* like canada.json: lots of floating point coordinates */
+static cJSON *create_coordinates(void)
+{
+    cJSON *coordinates = cJSON_CreateArray();
+    int i = 0;
+
+    for (i = 0; i < 50000; i++)
+    {
+        double pair[2];
+        pair[0] = -65.613616999999977 + (i * 0.000123);
+        pair[1] = 43.420273000000009 - (i * 0.000077);
+        cJSON_AddItemToArray(coordinates, cJSON_CreateDoubleArray(pair, 2));
+    }
+
+    return coordinates;
+}
+
+/* like citm_catalog.json: an object with many members that map to small objects */
+static cJSON *create_catalog(void)
+{
+    cJSON *catalog = cJSON_CreateObject();
+    char name[32];
+    int i = 0;
+
+    for (i = 0; i < 5000; i++)
+    {
+        cJSON *event = cJSON_CreateObject();
+        int topics[2];
+
+        topics[0] = 324846099 + i;
+        topics[1] = 107888604;
+        sprintf(name, "%d", 138586341 + i);
+        cJSON_AddNullToObject(event, "description");
+        cJSON_AddNumberToObject(event, "id", 138586341 + i);
+        cJSON_AddNullToObject(event, "logo");
+        cJSON_AddStringToObject(event, "name", "30th Anniversary Tour");
+        cJSON_AddItemToObject(event, "subTopicIds", cJSON_CreateIntArray(topics, 2));
+        cJSON_AddItemToObject(catalog, name, event);
+    }
+
+    return catalog;
+}
+
+/* deeply nested arrays and objects */
+static cJSON *create_deep(void)
+{
+    cJSON *root = cJSON_CreateArray();
+    cJSON *current = root;
+    int i = 0;
+
+    for (i = 0; i < 900; i++)
+    {
+        cJSON *next = (i % 2) ? cJSON_CreateArray() : cJSON_CreateObject();
+        cJSON_AddNumberToObject(next, "level", i);
+        cJSON_AddItemToArray(current, next);
+        current = next;
+    }
+
+    return root;
+}
+
+/* long strings with the occasional escape sequence */
+static cJSON *create_strings(void)
+{
+    cJSON *strings = cJSON_CreateArray();
+    char *text = (char*)malloc(16384 + 1);
+    size_t position = 0;
+    int i = 0;
+
+    if (text == NULL)
+    {
+        return strings;
+    }
+    for (position = 0; position < 16384; position++)
+    {
+        text[position] = ((position % 97) == 0) ? '\n' : ((position % 89) == 0) ? '\"' : (char)('a' + (position % 26));
+    }
+    text[16384] = '\0';
+    for (i = 0; i < 64; i++)
+    {
+        cJSON_AddItemToArray(strings, cJSON_CreateString(text));
+    }
+    free(text);
+
+    return strings;
+}
+
+/* strings that are almost only \\u escapes, like CJK text from an ASCII-only encoder, with the occasional surrogate pair */
+static char *create_escapes(size_t *length)
+{
+    char *json = (char*)malloc(64 * (2 + 1024 * 6 + 3) + 3);
+    size_t position = 0;
+    int i = 0;
+    int j = 0;
+
+    if (json == NULL)
+    {
+        return NULL;
+    }
+    json[position++] = '[';
+    for (i = 0; i < 64; i++)
+    {
+        json[position++] = '\"';
+        for (j = 0; j < 1024; j++)
+        {
+            if ((j % 64) == 62)
+            {
+                /* the second half of the pair replaces the next character */
+                position += (size_t)sprintf(json + position, "\\ud83d\\ude%02x", j & 0x3F);
+                j++;
+                continue;
+            }
+            position += (size_t)sprintf(json + position, "\\u%04x", 0x4E00 + ((i * 1024 + j) % 0x5000));
+        }
+        json[position++] = '\"';
+        json[position++] = (i == 63) ? ']' : ',';
+    }
+    json[position] = '\0';
+    *length = position;
+
+    return json;
+}
+
+static cJSON_bool add_document(document * const corpus, size_t * const count, const char * const name, char * const json, const size_t length)
+{
+    document *current = &corpus[*count];
+
+    if (json == NULL)
+    {
+        fprintf(stderr, "Failed to load %s.\n", name);
+        return 0;
+    }
+    current->name = name;
+    current->json = json;
+    current->length = length;
+    current->tree = cJSON_Parse(json);
+    if (current->tree == NULL)
+    {
+        fprintf(stderr, "Failed to parse %s.\n", name);
+        free(json);
+        return 0;
+    }
+    current->nodes = count_nodes(current->tree);
+    (*count)++;
+
+    return 1;
+}
+
+static cJSON_bool add_generated(document * const corpus, size_t * const count, const char * const name, cJSON * const tree)
+{
+    char *json = cJSON_Print(tree);
+    cJSON_Delete(tree);
+
+    return add_document(corpus, count, name, json, (json == NULL) ? 0 : strlen(json));
+}
+
+enum operation
+{
+    PARSE,
+    PRINT_UNFORMATTED,
+    PRINT,
+    DUPLICATE,
+    DUPLICATE_ARENA,
+    MINIFY,
+    GENERATE_PATCHES,
+    OPERATIONS
+};
+
+static const char *operation_names[OPERATIONS] = { "parse", "print_unformatted", "print", "duplicate", "duplicate_arena", "minify", "generate_patches" };
+
+static void run_operation(const enum operation current, const document * const doc, char * const scratch, cJSON * const changed)
+{
+    cJSON *result = NULL;
+    cJSON *patches = NULL;
+    cJSON_Arena *arena = NULL;
+    char *text = NULL;
+
+    switch (current)
+    {
+        case PARSE:
+            result = cJSON_Parse(doc->json);
+            break;
+        case PRINT_UNFORMATTED:
+            text = cJSON_PrintUnformatted(doc->tree);
+            break;
+        case PRINT:
+            text = cJSON_Print(doc->tree);
+            break;
+        case DUPLICATE:
+            result = cJSON_Duplicate(doc->tree, 1);
+            break;
+        case DUPLICATE_ARENA:
+            arena = cJSON_CreateArena(0);
+            cJSON_DuplicateWithArena(arena, doc->tree, 1);
+            break;
+        case MINIFY:
+            memcpy(scratch, doc->json, doc->length + 1);
+            cJSON_Minify(scratch);
+            break;
+        case GENERATE_PATCHES:
+            /* generating patches sorts the objects, so it works on a copy */
+            result = cJSON_Duplicate(doc->tree, 1);
+            patches = cJSONUtils_GeneratePatches(result, changed);
+            break;
+        default:
+            break;
+    }
+
+    cJSON_Delete(result);
+    cJSON_Delete(patches);
+    cJSON_DeleteArena(arena);
+    free(text);
+}
+
+/* The second document for the patch benchmark: some numbers of the original are changed. */
+static cJSON *create_changed(const document * const doc)
+{
+    cJSON *changed = cJSON_Duplicate(doc->tree, 1);
+    cJSON *child = NULL;
+    int i = 0;
+
+    for (child = changed->child; child != NULL; child = child->next, i++)
+    {
+        if (((i % 10) == 0) && cJSON_IsNumber(child))
+        {
+            cJSON_SetNumberValue(child, child->valuedouble + 1);
+        }
+    }
+    if (cJSON_IsObject(changed))
+    {
+        cJSON_AddStringToObject(changed, "added", "member");
+    }
+
+    return changed;
+}
+
+static void benchmark(const document * const doc)
+{
+    char *scratch = (char*)malloc(doc->length + 1);
+    cJSON *changed = create_changed(doc);
+    enum operation current = PARSE;
+
+    if ((scratch == NULL) || (changed == NULL))
+    {
+        fprintf(stderr, "Out of memory.\n");
+        free(scratch);
+        cJSON_Delete(changed);
+        return;
+    }
+
+    for (current = PARSE; current < OPERATIONS; current = (enum operation)(current + 1))
+    {
+        size_t iterations = 0;
+        size_t allocations_before = 0;
+        double seconds = 0;
+        clock_t start = 0;
+
+        /* warm up and count the allocations of one run */
+        allocations_before = allocations;
+        run_operation(current, doc, scratch, changed);
+        allocations_before = allocations - allocations_before;
+
+        start = clock();
+        do
+        {
+            run_operation(current, doc, scratch, changed);
+            iterations++;
+            seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+        } while (seconds < MINIMUM_SECONDS);
+
+        printf("%-14s %-18s %10.1f MB/s %10.1f ns/node %10lu allocations\n",
+                doc->name,
+                operation_names[current],
+                ((double)doc->length * (double)iterations) / (seconds * 1024.0 * 1024.0),
+                (seconds * 1e9) / ((double)doc->nodes * (double)iterations),
+                (unsigned long)allocations_before);
+    }
+
+    free(scratch);
+    cJSON_Delete(changed);
+}
+
+int main(int argc, char **argv)
+{
+    cJSON_Hooks hooks;
+    document *corpus = NULL;
+    size_t count = 0;
+    size_t i = 0;
+    int argument = 0;
+
+    hooks.malloc_fn = counting_malloc;
+    hooks.free_fn = counting_free;
+    cJSON_InitHooks(&hooks);
+
+    corpus = (document*)malloc((6 + (size_t)argc) * sizeof(document));
+    if (corpus == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+
+    /* files given on the command line, for example the real twitter.json, canada.json and citm_catalog.json */
+    for (argument = 1; argument < argc; argument++)
+    {
+        size_t length = 0;
+        char *json = read_file(argv[argument], &length);
+        if (!add_document(corpus, &count, argv[argument], json, length))
+        {
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!add_generated(corpus, &count, "records", create_records())
+            || !add_generated(corpus, &count, "coordinates", create_coordinates())
+            || !add_generated(corpus, &count, "catalog", create_catalog())
+            || !add_generated(corpus, &count, "deep", create_deep())
+            || !add_generated(corpus, &count, "strings", create_strings()))
+    {
+        return EXIT_FAILURE;
+    }
+    {
+        size_t length = 0;
+        char *json = create_escapes(&length);
+        if (!add_document(corpus, &count, "escapes", json, length))
+        {
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        printf("%s: %lu bytes, %lu nodes\n", corpus[i].name, (unsigned long)corpus[i].length, (unsigned long)corpus[i].nodes);
+        benchmark(&corpus[i]);
+        cJSON_Delete(corpus[i].tree);
+        free(corpus[i].json);
+    }
+    free(corpus);
+
+    return EXIT_SUCCESS;
+}
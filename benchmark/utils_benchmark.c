@@ -0,0 +1,416 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+/* Times the operations of cJSON_Utils on documents from 1 KB to the size given on the command line (1 MB by default,
+ * 100 MB at most) and with 0.1% to 50% of the records changed, and prints how their time grows with the size. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "../cJSON.h"
+#include "../cJSON_Utils.h"
+
+/* Every operation is repeated until it ran for at least this long */
+#define MINIMUM_SECONDS 0.1
+/* about the printed size of one record */
+#define RECORD_BYTES 75
+/* the number of pointers that are looked up and found in one run */
+#define POINTERS 1000
+#define TARGETS 10
+
+#define SIZES 6
+#define RATIOS 4
+
+static const size_t sizes[SIZES] = { 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+static const double ratios[RATIOS] = { 0.001, 0.01, 0.1, 0.5 };
+
+enum operation
+{
+    GET_POINTER,
+    SORT_OBJECT,
+    FIND_POINTER,
+    /* the following depend on the number of changes */
+    GENERATE_PATCHES,
+    APPLY_PATCHES,
+    GENERATE_MERGE_PATCH,
+    MERGE_PATCH,
+    OPERATIONS
+};
+
+#define FIRST_CHANGE_OPERATION GENERATE_PATCHES
+
+static const char *operation_names[OPERATIONS] = { "get_pointer", "sort_object", "find_pointer", "generate_patches", "apply_patches", "generate_merge_patch", "merge_patch" };
+
+typedef struct
+{
+    cJSON *from;
+    cJSON *to; /* from with some records changed, removed or added */
+    cJSON *patches; /* from from to to */
+    cJSON *merge_patch; /* from from to to */
+    char *pointers[POINTERS];
+    cJSON *targets[TARGETS];
+    size_t records;
+    size_t length; /* of from, printed */
+} workload;
+
+/* a bijection on 32 bits, so the names are unique but not inserted in sorted order */
+static unsigned long scramble(const unsigned long number)
+{
+    return (number * 2654435761UL) & 0xFFFFFFFFUL;
+}
+
+static void record_name(char * const name, const size_t number)
+{
+    sprintf(name, "r%08lx", scramble((unsigned long)number));
+}
+
+static cJSON *create_record(const size_t number)
+{
+    cJSON *record = cJSON_CreateObject();
+    cJSON *tags = cJSON_CreateArray();
+    char name[32];
+
+    sprintf(name, "record %lu", (unsigned long)number);
+    cJSON_AddNumberToObject(record, "id", (double)number);
+    cJSON_AddStringToObject(record, "name", name);
+    cJSON_AddNumberToObject(record, "value", (double)(number % 1000) / 8.0);
+    cJSON_AddItemToArray(tags, cJSON_CreateString("a"));
+    cJSON_AddItemToArray(tags, cJSON_CreateString("b"));
+    cJSON_AddItemToObject(record, "tags", tags);
+
+    return record;
+}
+
+static cJSON *create_records(const size_t records)
+{
+    cJSON *object = cJSON_CreateObject();
+    char name[32];
+    size_t i = 0;
+
+    for (i = 0; i < records; i++)
+    {
+        record_name(name, i);
+        cJSON_AddItemToObject(object, name, create_record(i));
+    }
+
+    return object;
+}
+
+/* Spreads changes over the records: a third of them change a value, a third remove a record, a third add one. */
+static cJSON *create_changed(const cJSON * const from, const size_t records, const size_t changes)
+{
+    cJSON *to = cJSON_Duplicate(from, 1);
+    char name[32];
+    size_t i = 0;
+
+    for (i = 0; i < changes; i++)
+    {
+        size_t number = (i * records) / changes;
+        cJSON *record = NULL;
+
+        record_name(name, number);
+        switch (i % 3)
+        {
+            case 0:
+                record = cJSON_GetObjectItemCaseSensitive(to, name);
+                cJSON_ReplaceItemInObject(record, "value", cJSON_CreateNumber(-1));
+                break;
+            case 1:
+                cJSON_DeleteItemFromObject(to, name);
+                break;
+            default:
+                record_name(name, records + i);
+                cJSON_AddItemToObject(to, name, create_record(records + i));
+                break;
+        }
+    }
+
+    return to;
+}
+
+static cJSON_bool create_workload(workload * const work, const size_t size)
+{
+    char name[64];
+    char *printed = NULL;
+    size_t i = 0;
+
+    memset(work, '\0', sizeof(workload));
+    work->records = (size / RECORD_BYTES < 4) ? 4 : (size / RECORD_BYTES);
+    work->from = create_records(work->records);
+    printed = cJSON_PrintUnformatted(work->from);
+    if (printed == NULL)
+    {
+        return 0;
+    }
+    work->length = strlen(printed);
+    free(printed);
+
+    for (i = 0; i < POINTERS; i++)
+    {
+        record_name(name + 1, scramble((unsigned long)i) % work->records);
+        name[0] = '/';
+        strcat(name, "/value");
+        work->pointers[i] = (char*)malloc(strlen(name) + 1);
+        if (work->pointers[i] == NULL)
+        {
+            return 0;
+        }
+        strcpy(work->pointers[i], name);
+    }
+    for (i = 0; i < TARGETS; i++)
+    {
+        record_name(name, ((i + 1) * work->records) / (TARGETS + 1));
+        work->targets[i] = cJSON_GetObjectItemCaseSensitive(cJSON_GetObjectItemCaseSensitive(work->from, name), "value");
+    }
+
+    return 1;
+}
+
+static void delete_changes(workload * const work)
+{
+    cJSON_Delete(work->to);
+    cJSON_Delete(work->patches);
+    cJSON_Delete(work->merge_patch);
+    work->to = NULL;
+    work->patches = NULL;
+    work->merge_patch = NULL;
+}
+
+static cJSON_bool create_changes(workload * const work, const double ratio)
+{
+    size_t changes = (size_t)((double)work->records * ratio);
+    cJSON *from = NULL;
+    cJSON *to = NULL;
+
+    delete_changes(work);
+    work->to = create_changed(work->from, work->records, (changes == 0) ? 1 : changes);
+
+    /* generating patches sorts the objects, so it works on copies */
+    from = cJSON_Duplicate(work->from, 1);
+    to = cJSON_Duplicate(work->to, 1);
+    work->patches = cJSONUtils_GeneratePatches(from, to);
+    cJSON_Delete(from);
+    cJSON_Delete(to);
+    from = cJSON_Duplicate(work->from, 1);
+    to = cJSON_Duplicate(work->to, 1);
+    work->merge_patch = cJSONUtils_GenerateMergePatch(from, to);
+    cJSON_Delete(from);
+    cJSON_Delete(to);
+
+    return (work->to != NULL) && (work->patches != NULL) && (work->merge_patch != NULL);
+}
+
+static void delete_workload(workload * const work)
+{
+    size_t i = 0;
+
+    delete_changes(work);
+    cJSON_Delete(work->from);
+    for (i = 0; i < POINTERS; i++)
+    {
+        free(work->pointers[i]);
+    }
+    memset(work, '\0', sizeof(workload));
+}
+
+/* Runs an operation once and returns its time, the copies that it changes are made outside of the timing. */
+static double run_operation(const enum operation current, const workload * const work)
+{
+    cJSON *from = NULL;
+    cJSON *to = NULL;
+    cJSON *result = NULL;
+    clock_t start = 0;
+    clock_t end = 0;
+    size_t i = 0;
+
+    if (current != FIND_POINTER)
+    {
+        from = cJSON_Duplicate(work->from, 1);
+    }
+    if ((current == GENERATE_PATCHES) || (current == GENERATE_MERGE_PATCH))
+    {
+        to = cJSON_Duplicate(work->to, 1);
+    }
+
+    start = clock();
+    switch (current)
+    {
+        case GET_POINTER:
+            for (i = 0; i < POINTERS; i++)
+            {
+                cJSONUtils_GetPointer(from, work->pointers[i]);
+            }
+            break;
+        case SORT_OBJECT:
+            cJSONUtils_SortObject(from);
+            break;
+        case FIND_POINTER:
+            for (i = 0; i < TARGETS; i++)
+            {
+                free(cJSONUtils_FindPointerFromObjectTo(work->from, work->targets[i]));
+            }
+            break;
+        case GENERATE_PATCHES:
+            result = cJSONUtils_GeneratePatches(from, to);
+            break;
+        case APPLY_PATCHES:
+            cJSONUtils_ApplyPatches(from, work->patches);
+            break;
+        case GENERATE_MERGE_PATCH:
+            result = cJSONUtils_GenerateMergePatch(from, to);
+            break;
+        case MERGE_PATCH:
+            /* the patch is an object, so from is patched in place */
+            cJSONUtils_MergePatch(from, work->merge_patch);
+            break;
+        default:
+            break;
+    }
+    end = clock();
+
+    cJSON_Delete(from);
+    cJSON_Delete(to);
+    cJSON_Delete(result);
+
+    return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+static double time_operation(const enum operation current, const workload * const work)
+{
+    double seconds = 0;
+    size_t iterations = 0;
+
+    do
+    {
+        seconds += run_operation(current, work);
+        iterations++;
+    } while (seconds < MINIMUM_SECONDS);
+
+    return seconds / (double)iterations;
+}
+
+/* How the time grows with the size between two documents: 1 is linear, 2 is quadratic. */
+static double exponent(const double small_seconds, const size_t small_length, const double large_seconds, const size_t large_length)
+{
+    if ((small_seconds <= 0) || (large_seconds <= 0))
+    {
+        return 0;
+    }
+
+    return log(large_seconds / small_seconds) / log((double)large_length / (double)small_length);
+}
+
+static void print_curve(const char * const name, const double * const seconds, const size_t * const lengths, const size_t count)
+{
+    size_t i = 0;
+
+    printf("%-32s", name);
+    for (i = 1; i < count; i++)
+    {
+        printf(" %6.2f", exponent(seconds[i - 1], lengths[i - 1], seconds[i], lengths[i]));
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    static double seconds[OPERATIONS][RATIOS][SIZES];
+    size_t lengths[SIZES];
+    size_t maximum = 1000000;
+    size_t count = 0;
+    size_t ratio = 0;
+    enum operation current = GET_POINTER;
+    char name[64];
+    char changed[16];
+
+    if (argc > 1)
+    {
+        maximum = (size_t)strtoul(argv[1], NULL, 10);
+    }
+    if ((argc > 2) || (maximum < sizes[0]))
+    {
+        printf("Usage:\n");
+        printf("%s [maximum_bytes]\n", argv[0]);
+        printf("\t maximum_bytes: the size of the largest document, 1000 to 100000000, defaults to 1000000\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%-12s %-8s %-22s %14s %12s\n", "bytes", "changed", "operation", "ms/run", "ns/byte");
+    for (count = 0; (count < SIZES) && (sizes[count] <= maximum); count++)
+    {
+        workload work;
+
+        if (!create_workload(&work, sizes[count]))
+        {
+            fprintf(stderr, "Out of memory.\n");
+            delete_workload(&work);
+            return EXIT_FAILURE;
+        }
+        lengths[count] = work.length;
+
+        for (current = GET_POINTER; current < FIRST_CHANGE_OPERATION; current = (enum operation)(current + 1))
+        {
+            seconds[current][0][count] = time_operation(current, &work);
+            printf("%-12lu %-8s %-22s %14.3f %12.2f\n", (unsigned long)work.length, "-", operation_names[current],
+                    seconds[current][0][count] * 1e3, (seconds[current][0][count] * 1e9) / (double)work.length);
+        }
+        for (ratio = 0; ratio < RATIOS; ratio++)
+        {
+            if (!create_changes(&work, ratios[ratio]))
+            {
+                fprintf(stderr, "Out of memory.\n");
+                delete_workload(&work);
+                return EXIT_FAILURE;
+            }
+            for (current = FIRST_CHANGE_OPERATION; current < OPERATIONS; current = (enum operation)(current + 1))
+            {
+                seconds[current][ratio][count] = time_operation(current, &work);
+                sprintf(changed, "%.1f%%", ratios[ratio] * 100);
+                printf("%-12lu %-8s %-22s %14.3f %12.2f\n", (unsigned long)work.length, changed, operation_names[current],
+                        seconds[current][ratio][count] * 1e3, (seconds[current][ratio][count] * 1e9) / (double)work.length);
+            }
+        }
+
+        delete_workload(&work);
+    }
+
+    /* the exponent of the time between neighbouring sizes, 1 is linear, 2 is quadratic */
+    printf("\nscaling exponents between the sizes\n");
+    for (current = GET_POINTER; current < OPERATIONS; current = (enum operation)(current + 1))
+    {
+        if (current < FIRST_CHANGE_OPERATION)
+        {
+            print_curve(operation_names[current], seconds[current][0], lengths, count);
+            continue;
+        }
+        for (ratio = 0; ratio < RATIOS; ratio++)
+        {
+            sprintf(name, "%s (%.1f%%)", operation_names[current], ratios[ratio] * 100);
+            print_curve(name, seconds[current][ratio], lengths, count);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -23,14 +23,57 @@
 /* cJSON */
 /* JSON parser in C. */
 
+/* open, fstat and mmap for cJSON_OpenFile, define CJSON_NO_MMAP to read files with stdio only */
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(CJSON_NO_MMAP)
+#define CJSON_MMAP
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+#endif
+
 #pragma GCC visibility push(default)
 #include <string.h>
 #include <stdio.h>
+#ifndef CJSON_INTEGER_ONLY
 #include <math.h>
+#endif
 #include <stdlib.h>
 #include <float.h>
 #include <limits.h>
 #include <ctype.h>
+#include <locale.h>
+#include <time.h>
+/* scan strings 16 bytes at a time, define CJSON_NO_SIMD to use the portable loops only */
+#if defined(__SSE2__) && !defined(CJSON_NO_SIMD)
+#define CJSON_SSE2
+#include <emmintrin.h>
+#endif
+/* hint that an item is read soon, walking a tree is dominated by waiting for the next node */
+#if defined(__GNUC__)
+#define prefetch_item(item) __builtin_prefetch(item)
+#else
+#define prefetch_item(item) ((void)(item))
+#endif
+#if defined(CJSON_ENABLE_USDT) && !defined(CJSON_TRACE)
+#include <sys/sdt.h>
+#endif
+#ifdef CJSON_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#if defined(_MSC_VER)
+#define CJSON_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define CJSON_THREAD_LOCAL __thread
+#endif
+/* define CJSON_NODE_CACHE to cache freed nodes per thread instead of freeing them */
+#if defined(CJSON_NODE_CACHE) && !defined(CJSON_THREAD_LOCAL)
+/* without thread local storage there is no safe place for the cache */
+#undef CJSON_NODE_CACHE
+#endif
 #pragma GCC visibility pop
 
 #include "cJSON.h"
@@ -41,13 +84,14 @@
 
 static const unsigned char *global_ep = NULL;
 
+
 CJSON_PUBLIC(const char *) cJSON_GetErrorPtr(void)
 {
     return (const char*) global_ep;
 }
 
 /* This is a safeguard to prevent copy-pasters from using incompatible C and header files */
-#if (CJSON_VERSION_MAJOR != 1) || (CJSON_VERSION_MINOR != 4) || (CJSON_VERSION_PATCH != 0)
+#if (CJSON_VERSION_MAJOR != 2) || (CJSON_VERSION_MINOR != 0) || (CJSON_VERSION_PATCH != 0)
     #error cJSON.h and cJSON.c have different versions. Make sure that both have the same.
 #endif
 
@@ -81,14 +125,163 @@ static int cJSON_strcasecmp(const unsigned char *s1, const unsigned char *s2)
     return tolower(*s1) - tolower(*s2);
 }
 
+/* what a document parsed with cJSON_ParseWithLimits has used up so far */
+typedef struct parse_budget
+{
+    const cJSON_ParseLimits *limits;
+    size_t bytes;
+    size_t nodes;
+    /* the cJSON_Error_ code of the limit that was hit, which made an allocation fail */
+    int error_code;
+} parse_budget;
+
 typedef struct internal_hooks
 {
     void *(*allocate)(size_t size);
     void (*deallocate)(void *pointer);
     void *(*reallocate)(void *pointer, size_t size);
+    /* if set, memory is carved out of the arena and only released together with it */
+    cJSON_Arena *arena;
+    /* if set, the names of object members are interned in this table */
+    cJSON_KeyTable *keys;
+    /* if set, strings are unescaped into the input, which starts here */
+    unsigned char *in_situ;
+    /* if set (and CJSON_ENABLE_STATS is defined), parsing or printing is counted here */
+    cJSON_Stats *stats;
+    /* if set, arrays that only contain numbers are parsed into packed arrays */
+    cJSON_bool pack_numbers;
+    /* if set, numbers keep their text and are converted when they are read, see cJSON_ParseWithNumberText */
+    cJSON_bool lazy_numbers;
+    /* if set, strings keep their escaped text and are unescaped when they are read, see cJSON_ParseWithStringText */
+    cJSON_bool lazy_strings;
+    /* if set, strings have to be well-formed UTF-8 when they are parsed or printed, see cJSON_ParseStrictUTF8 */
+    cJSON_bool strict_utf8;
+    /* if set, only the members of objects that are part of it are built, see cJSON_ParseWithProjection */
+    const cJSON_Projection *projection;
+    /* if set, parsing fails once the document needs more than its limits allow, see cJSON_ParseWithLimits */
+    parse_budget *budget;
 } internal_hooks;
 
-static internal_hooks global_hooks = { malloc, free, realloc };
+static internal_hooks global_hooks = { malloc, free, realloc, NULL, NULL, NULL, NULL, false, false, false, false, NULL, NULL };
+
+#ifdef CJSON_ENABLE_STATS
+static void stats_allocation(const internal_hooks * const hooks, const size_t size)
+{
+    if (hooks->stats != NULL)
+    {
+        hooks->stats->allocations++;
+        hooks->stats->allocated_bytes += size;
+    }
+}
+
+static void stats_buffer(const internal_hooks * const hooks, const size_t size)
+{
+    if ((hooks->stats != NULL) && (size > hooks->stats->peak_buffer_size))
+    {
+        hooks->stats->peak_buffer_size = size;
+    }
+}
+
+static void stats_node(const internal_hooks * const hooks)
+{
+    if (hooks->stats != NULL)
+    {
+        hooks->stats->nodes++;
+    }
+}
+
+static void stats_depth(const internal_hooks * const hooks, const size_t depth)
+{
+    if ((hooks->stats != NULL) && (depth > hooks->stats->max_depth))
+    {
+        hooks->stats->max_depth = depth;
+    }
+}
+#else
+/* without CJSON_ENABLE_STATS the instrumentation disappears */
+#define stats_allocation(hooks, size)
+#define stats_buffer(hooks, size)
+#define stats_node(hooks)
+#define stats_depth(hooks, depth)
+#endif
+
+/* Tracepoints with two arguments each. With CJSON_ENABLE_USDT they are static probes of the provider cjson for perf and
+ * bpftrace, CJSON_TRACE can be defined as a macro of its own instead. Otherwise they disappear. */
+#ifndef CJSON_TRACE
+#ifdef CJSON_ENABLE_USDT
+#define CJSON_TRACE(probe, first, second) DTRACE_PROBE2(cjson, probe, first, second)
+#else
+#define CJSON_TRACE(probe, first, second)
+#endif
+#endif
+
+/* Take nodes and bytes out of the budget of the document, returns false once a limit is exceeded. */
+static cJSON_bool charge_budget(const internal_hooks * const hooks, const size_t nodes, const size_t bytes)
+{
+    parse_budget * const budget = hooks->budget;
+
+    if (budget == NULL)
+    {
+        return true;
+    }
+
+    if ((budget->limits->max_nodes != 0) && (nodes > (budget->limits->max_nodes - budget->nodes)))
+    {
+        budget->error_code = cJSON_Error_TooManyNodes;
+        return false;
+    }
+    if ((budget->limits->max_bytes != 0) && (bytes > (budget->limits->max_bytes - budget->bytes)))
+    {
+        budget->error_code = cJSON_Error_TooManyBytes;
+        return false;
+    }
+    budget->nodes += nodes;
+    budget->bytes += bytes;
+
+    return true;
+}
+
+/* how deeply arrays and objects may be nested */
+static size_t nesting_limit(const internal_hooks * const hooks)
+{
+    if ((hooks->budget != NULL) && (hooks->budget->limits->max_depth != 0) && (hooks->budget->limits->max_depth < CJSON_NESTING_LIMIT))
+    {
+        return hooks->budget->limits->max_depth;
+    }
+
+    return CJSON_NESTING_LIMIT;
+}
+
+static void *arena_allocate(cJSON_Arena * const arena, size_t size);
+
+/* allocate memory from the arena if there is one, otherwise from the allocator */
+static void *allocate_memory(size_t size, const internal_hooks * const hooks)
+{
+    if (!charge_budget(hooks, 0, size))
+    {
+        return NULL;
+    }
+
+    CJSON_TRACE(allocate, size, hooks->arena);
+    if (hooks->arena != NULL)
+    {
+        return arena_allocate(hooks->arena, size);
+    }
+
+    stats_allocation(hooks, size);
+    return hooks->allocate(size);
+}
+
+/* arena memory is never freed individually */
+static void deallocate_memory(void *pointer, const internal_hooks * const hooks)
+{
+    if ((pointer == NULL) || (hooks->arena != NULL))
+    {
+        return;
+    }
+
+    hooks->deallocate(pointer);
+}
 
 static unsigned char* cJSON_strdup(const unsigned char* str, const internal_hooks * const hooks)
 {
@@ -101,7 +294,7 @@ static unsigned char* cJSON_strdup(const unsigned char* str, const internal_hook
     }
 
     len = strlen((const char*)str) + 1;
-    if (!(copy = (unsigned char*)hooks->allocate(len)))
+    if (!(copy = (unsigned char*)allocate_memory(len, hooks)))
     {
         return NULL;
     }
@@ -110,8 +303,69 @@ static unsigned char* cJSON_strdup(const unsigned char* str, const internal_hook
     return copy;
 }
 
+/* the lengths in a node are 0 when they are unknown, which strings that don't fit into an unsigned int stay */
+static unsigned int length_to_store(const size_t length)
+{
+    return (length < UINT_MAX) ? (unsigned int)length : 0;
+}
+
+/* A stored length only counts for the string it was stored for, valuestring or string could have been assigned since. */
+static size_t stored_valuestring_length(const cJSON * const item)
+{
+    return (item->valuestring == item->stored_valuestring) ? item->valuestring_length : 0;
+}
+
+static size_t stored_name_length(const cJSON * const item)
+{
+    return (item->string == item->stored_string) ? item->string_length : 0;
+}
+
+static void store_valuestring_length(cJSON * const item, const size_t length)
+{
+    item->stored_valuestring = item->valuestring;
+    item->valuestring_length = length_to_store(length);
+}
+
+static void store_name_length(cJSON * const item, const size_t length)
+{
+    item->stored_string = item->string;
+    item->string_length = length_to_store(length);
+}
+
+static size_t valuestring_length(const cJSON * const item)
+{
+    const size_t length = stored_valuestring_length(item);
+    return (length != 0) ? length : strlen(item->valuestring);
+}
+
+static size_t name_length(const cJSON * const item)
+{
+    const size_t length = stored_name_length(item);
+    return (length != 0) ? length : strlen(item->string);
+}
+
+/* like cJSON_strdup, for strings whose length is known */
+static char *copy_string(const char * const string, const size_t length, const internal_hooks * const hooks)
+{
+    char *copy = (char*)allocate_memory(length + 1, hooks);
+    if (copy != NULL)
+    {
+        memcpy(copy, string, length + 1);
+    }
+
+    return copy;
+}
+
 CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks* hooks)
 {
+    cJSON_InitHooksWithRealloc(hooks, NULL);
+}
+
+CJSON_PUBLIC(void) cJSON_InitHooksWithRealloc(cJSON_Hooks* hooks, void *(*realloc_fn)(void *ptr, size_t sz))
+{
+    /* the cached nodes of this thread may belong to the old allocator */
+    cJSON_TrimNodeCache(0);
+
     if (hooks == NULL)
     {
         /* Reset hooks */
@@ -133,2049 +387,16197 @@ CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks* hooks)
         global_hooks.deallocate = hooks->free_fn;
     }
 
-    /* use realloc only if both free and malloc are used */
-    global_hooks.reallocate = NULL;
-    if ((global_hooks.allocate == malloc) && (global_hooks.deallocate == free))
+    /* without a realloc_fn, use realloc only if both free and malloc are used */
+    global_hooks.reallocate = realloc_fn;
+    if ((realloc_fn == NULL) && (global_hooks.allocate == malloc) && (global_hooks.deallocate == free))
     {
         global_hooks.reallocate = realloc;
     }
 }
 
-/* Internal constructor. */
-static cJSON *cJSON_New_Item(const internal_hooks * const hooks)
+/* Arena allocator */
+typedef struct arena_block
 {
-    cJSON* node = (cJSON*)hooks->allocate(sizeof(cJSON));
-    if (node)
-    {
-        memset(node, '\0', sizeof(cJSON));
-    }
+    struct arena_block *next;
+    size_t size; /* usable bytes after the header */
+    size_t used;
+} arena_block;
 
-    return node;
-}
+/* everything handed out by the arena is aligned for these types */
+typedef union arena_alignment
+{
+    void *pointer;
+    double number;
+    long integer;
+    size_t size;
+} arena_alignment;
 
-/* Delete a cJSON structure. */
-CJSON_PUBLIC(void) cJSON_Delete(cJSON *c)
+#define arena_align(size) (((size) + sizeof(arena_alignment) - 1) & ~(sizeof(arena_alignment) - 1))
+#define arena_block_data(block) (((unsigned char*)(block)) + arena_align(sizeof(arena_block)))
+
+#define CJSON_ARENA_DEFAULT_BLOCK_SIZE 16384
+
+struct cJSON_Arena
 {
-    cJSON *next = NULL;
-    while (c)
+    /* the block that is currently being filled comes first */
+    arena_block *blocks;
+    /* empty blocks that cJSON_ResetDocument kept for reuse */
+    arena_block *spare;
+    size_t block_size;
+    /* the allocator that was active when the arena was created */
+    internal_hooks hooks;
+};
+
+static arena_block *arena_new_block(cJSON_Arena * const arena, size_t size)
+{
+    arena_block *block = NULL;
+    arena_block **link = NULL;
+    arena_block **best = NULL;
+
+    /* the smallest spare block that is big enough, so the blocks of the same document fit again */
+    for (link = &arena->spare; *link != NULL; link = &(*link)->next)
     {
-        next = c->next;
-        if (!(c->type & cJSON_IsReference) && c->child)
-        {
-            cJSON_Delete(c->child);
-        }
-        if (!(c->type & cJSON_IsReference) && c->valuestring)
-        {
-            global_hooks.deallocate(c->valuestring);
-        }
-        if (!(c->type & cJSON_StringIsConst) && c->string)
+        if (((*link)->size >= size) && ((best == NULL) || ((*link)->size < (*best)->size)))
         {
-            global_hooks.deallocate(c->string);
+            best = link;
         }
-        global_hooks.deallocate(c);
-        c = next;
     }
-}
-
-/* Parse the input text to generate a number, and populate the result into item. */
-static const unsigned char *parse_number(cJSON * const item, const unsigned char * const input)
-{
-    double number = 0;
-    unsigned char *after_end = NULL;
-
-    if (input == NULL)
+    if (best != NULL)
     {
-        return NULL;
-    }
+        block = *best;
+        *best = block->next;
+        block->next = NULL;
+        block->used = 0;
 
-    number = strtod((const char*)input, (char**)&after_end);
-    if (input == after_end)
-    {
-        return NULL; /* parse_error */
+        return block;
     }
 
-    item->valuedouble = number;
-
-    /* use saturation in case of overflow */
-    if (number >= INT_MAX)
+    if (size > ((size_t)-1 - arena_align(sizeof(arena_block))))
     {
-        item->valueint = INT_MAX;
-    }
-    else if (number <= INT_MIN)
-    {
-        item->valueint = INT_MIN;
+        return NULL;
     }
-    else
+
+    block = (arena_block*)arena->hooks.allocate(arena_align(sizeof(arena_block)) + size);
+    if (block == NULL)
     {
-        item->valueint = (int)number;
+        return NULL;
     }
 
-    item->type = cJSON_Number;
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
 
-    return after_end;
+    return block;
 }
 
-/* don't ask me, but the original cJSON_SetNumberValue returns an integer or double */
-CJSON_PUBLIC(double) cJSON_SetNumberHelper(cJSON *object, double number)
+static void *arena_allocate(cJSON_Arena * const arena, size_t size)
 {
-    if (number >= INT_MAX)
+    arena_block *block = arena->blocks;
+    void *memory = NULL;
+
+    if (size > ((size_t)-1 - sizeof(arena_alignment)))
     {
-        object->valueint = INT_MAX;
+        return NULL;
     }
-    else if (number <= INT_MIN)
+    size = arena_align(size);
+
+    if ((block != NULL) && (size <= (block->size - block->used)))
     {
-        object->valueint = INT_MIN;
+        memory = arena_block_data(block) + block->used;
+        block->used += size;
+
+        return memory;
+    }
+
+    if (size > (arena->block_size / 4))
+    {
+        /* big allocations get a block of their own, so that the current block can keep being filled */
+        block = arena_new_block(arena, size);
+        if (block == NULL)
+        {
+            return NULL;
+        }
+        if (arena->blocks == NULL)
+        {
+            arena->blocks = block;
+        }
+        else
+        {
+            block->next = arena->blocks->next;
+            arena->blocks->next = block;
+        }
     }
     else
     {
-        object->valueint = cJSON_Number;
+        block = arena_new_block(arena, arena->block_size);
+        if (block == NULL)
+        {
+            return NULL;
+        }
+        block->next = arena->blocks;
+        arena->blocks = block;
     }
 
-    return object->valuedouble = number;
-}
+    block->used = size;
 
-typedef struct
-{
-    unsigned char *buffer;
-    size_t length;
-    size_t offset;
-    cJSON_bool noalloc;
-} printbuffer;
+    return arena_block_data(block);
+}
 
-/* realloc printbuffer if necessary to have at least "needed" bytes more */
-static unsigned char* ensure(printbuffer * const p, size_t needed, const internal_hooks * const hooks)
+CJSON_PUBLIC(cJSON_Arena *) cJSON_CreateArena(size_t block_size)
 {
-    unsigned char *newbuffer = NULL;
-    size_t newsize = 0;
+    cJSON_Arena *arena = NULL;
 
-    if ((p == NULL) || (p->buffer == NULL))
+    if (block_size == 0)
     {
-        return NULL;
+        block_size = CJSON_ARENA_DEFAULT_BLOCK_SIZE;
     }
-
-    if (needed > INT_MAX)
+    if (block_size > ((size_t)-1 - sizeof(arena_alignment)))
     {
-        /* sizes bigger than INT_MAX are currently not supported */
         return NULL;
     }
 
-    needed += p->offset;
-    if (needed <= p->length)
+    arena = (cJSON_Arena*)global_hooks.allocate(sizeof(cJSON_Arena));
+    if (arena == NULL)
     {
-        return p->buffer + p->offset;
+        return NULL;
     }
 
-    if (p->noalloc) {
-        return NULL;
+    arena->blocks = NULL;
+    arena->spare = NULL;
+    arena->block_size = arena_align(block_size);
+    arena->hooks = global_hooks;
+    arena->hooks.arena = NULL;
+
+    return arena;
+}
+
+CJSON_PUBLIC(void) cJSON_ResetArena(cJSON_Arena *arena)
+{
+    arena_block *block = NULL;
+    arena_block *kept = NULL;
+
+    if (arena == NULL)
+    {
+        return;
     }
 
-    /* calculate new buffer size */
-    newsize = needed * 2;
-    if (newsize > INT_MAX)
+    /* keep one regular sized block around for the next document */
+    block = arena->blocks;
+    while (block != NULL)
     {
-        /* overflow of int, use INT_MAX if possible */
-        if (needed <= INT_MAX)
+        arena_block *next = block->next;
+        if ((kept == NULL) && (block->size == arena->block_size))
         {
-            newsize = INT_MAX;
+            kept = block;
+            kept->next = NULL;
+            kept->used = 0;
         }
         else
         {
-            return NULL;
+            arena->hooks.deallocate(block);
         }
+        block = next;
     }
-
-    if (hooks->reallocate != NULL)
+    while (arena->spare != NULL)
     {
-        /* reallocate with realloc if available */
-        newbuffer = (unsigned char*)hooks->reallocate(p->buffer, newsize);
+        block = arena->spare;
+        arena->spare = block->next;
+        arena->hooks.deallocate(block);
     }
-    else
-    {
-        /* otherwise reallocate manually */
-        newbuffer = (unsigned char*)hooks->allocate(newsize);
-        if (!newbuffer)
-        {
-            hooks->deallocate(p->buffer);
-            p->length = 0;
-            p->buffer = NULL;
 
-            return NULL;
-        }
-        if (newbuffer)
+    arena->blocks = kept;
+}
+
+/* Free all documents in the arena, but keep blocks of up to limit bytes in total as spare blocks. */
+static void arena_retain(cJSON_Arena * const arena, const size_t limit)
+{
+    arena_block *lists[2];
+    arena_block *block = NULL;
+    size_t retained = 0;
+    size_t size = 0;
+    size_t i = 0;
+
+    lists[0] = arena->blocks;
+    lists[1] = arena->spare;
+    arena->blocks = NULL;
+    arena->spare = NULL;
+    for (i = 0; i < (sizeof(lists) / sizeof(lists[0])); i++)
+    {
+        while (lists[i] != NULL)
         {
-            memcpy(newbuffer, p->buffer, p->offset + 1);
+            block = lists[i];
+            lists[i] = block->next;
+            size = arena_align(sizeof(arena_block)) + block->size;
+            if (size <= (limit - retained))
+            {
+                retained += size;
+                block->next = arena->spare;
+                arena->spare = block;
+            }
+            else
+            {
+                arena->hooks.deallocate(block);
+            }
         }
-        hooks->deallocate(p->buffer);
     }
-    p->length = newsize;
-    p->buffer = newbuffer;
-
-    return newbuffer + p->offset;
 }
 
-/* calculate the new length of the string in a printbuffer and update the offset */
-static void update_offset(printbuffer * const buffer)
+CJSON_PUBLIC(void) cJSON_DeleteArena(cJSON_Arena *arena)
 {
-    const unsigned char *buffer_pointer = NULL;
-    if ((buffer == NULL) || (buffer->buffer == NULL))
+    if (arena == NULL)
     {
         return;
     }
-    buffer_pointer = buffer->buffer + buffer->offset;
 
-    buffer->offset += strlen((const char*)buffer_pointer);
+    cJSON_ResetArena(arena);
+    if (arena->blocks != NULL)
+    {
+        arena->hooks.deallocate(arena->blocks);
+    }
+    arena->hooks.deallocate(arena);
 }
 
-/* Removes trailing zeroes from the end of a printed number */
-static cJSON_bool trim_trailing_zeroes(printbuffer * const buffer)
+CJSON_PUBLIC(size_t) cJSON_GetArenaMemoryUsage(const cJSON_Arena *arena)
 {
-    size_t offset = 0;
-    unsigned char *content = NULL;
+    const arena_block *block = NULL;
+    size_t usage = 0;
 
-    if ((buffer == NULL) || (buffer->buffer == NULL) || (buffer->offset < 1))
+    if (arena == NULL)
     {
-        return false;
+        return 0;
     }
 
-    offset = buffer->offset - 1;
-    content = buffer->buffer;
-
-    while ((offset > 0) && (content[offset] == '0'))
+    usage = sizeof(cJSON_Arena);
+    for (block = arena->blocks; block != NULL; block = block->next)
     {
-        offset--;
+        usage += arena_align(sizeof(arena_block)) + block->size;
     }
-    if ((offset > 0) && (content[offset] == '.'))
+    for (block = arena->spare; block != NULL; block = block->next)
     {
-        offset--;
+        usage += arena_align(sizeof(arena_block)) + block->size;
     }
 
-    offset++;
-    content[offset] = '\0';
+    return usage;
+}
 
-    buffer->offset = offset;
+/* Key table for interning object member names */
+typedef struct
+{
+    char *name; /* NULL if the slot is free */
+    size_t length;
+    size_t hash;
+} key_entry;
 
-    return true;
+struct cJSON_KeyTable
+{
+    /* open addressing with linear probing, size is a power of two */
+    key_entry *entries;
+    size_t size;
+    size_t count;
+    /* the allocator that was active when the table was created */
+    internal_hooks hooks;
+};
+
+#define KEY_TABLE_MINIMUM_SIZE 64
+
+/* FNV-1a */
+static size_t hash_key(const unsigned char * const name, const size_t length)
+{
+    size_t hash = 2166136261u;
+    size_t position = 0;
+
+    for (position = 0; position < length; position++)
+    {
+        hash = (hash ^ name[position]) * 16777619u;
+    }
+
+    return hash;
 }
 
-/* Render the number nicely from the given item into a string. */
-static cJSON_bool print_number(const cJSON * const item, printbuffer * const output_buffer, const internal_hooks * const hooks)
+static cJSON_bool key_table_grow(cJSON_KeyTable * const table)
 {
-    unsigned char *output_pointer = NULL;
-    double d = item->valuedouble;
-    int length = 0;
-    cJSON_bool trim_zeroes = true; /* should at the end be removed? */
+    const size_t size = (table->size == 0) ? KEY_TABLE_MINIMUM_SIZE : (table->size * 2);
+    key_entry *entries = NULL;
+    size_t old = 0;
+    size_t slot = 0;
 
-    if (output_buffer == NULL)
+    if ((size < table->size) || (size > ((size_t)-1 / sizeof(key_entry))))
+    {
+        return false;
+    }
+    entries = (key_entry*)table->hooks.allocate(size * sizeof(key_entry));
+    if (entries == NULL)
     {
         return false;
     }
+    memset(entries, '\0', size * sizeof(key_entry));
 
-    /* This is a nice tradeoff. */
-    output_pointer = ensure(output_buffer, 64, hooks);
-    if (output_pointer != NULL)
+    for (old = 0; old < table->size; old++)
     {
-        /* This checks for NaN and Infinity */
-        if ((d * 0) != 0)
-        {
-            length = sprintf((char*)output_pointer, "null");
-        }
-        else if ((fabs(floor(d) - d) <= DBL_EPSILON) && (fabs(d) < 1.0e60))
-        {
-            /* integer */
-            length = sprintf((char*)output_pointer, "%.0f", d);
-            trim_zeroes = false; /* don't remove zeroes for "big integers" */
-        }
-        else if ((fabs(d) < 1.0e-6) || (fabs(d) > 1.0e9))
+        if (table->entries[old].name == NULL)
         {
-            length = sprintf((char*)output_pointer, "%e", d);
-            trim_zeroes = false; /* don't remove zeroes in engineering notation */
+            continue;
         }
-        else
+        for (slot = table->entries[old].hash & (size - 1); entries[slot].name != NULL; slot = (slot + 1) & (size - 1))
         {
-            length = sprintf((char*)output_pointer, "%f", d);
         }
+        entries[slot] = table->entries[old];
     }
 
-    /* sprintf failed */
-    if (length < 0)
-    {
-        return false;
-    }
-
-    output_buffer->offset += (size_t)length;
-
-    if (trim_zeroes)
+    if (table->entries != NULL)
     {
-        return trim_trailing_zeroes(output_buffer);
+        table->hooks.deallocate(table->entries);
     }
+    table->entries = entries;
+    table->size = size;
 
     return true;
 }
 
-/* parse 4 digit hexadecimal number */
-static unsigned parse_hex4(const unsigned char * const input)
+/* Returns the copy of name in the table, adding it if it isn't there yet. NULL if memory runs out. */
+static char *intern_key(cJSON_KeyTable * const table, const unsigned char * const name, const size_t length)
 {
-    unsigned int h = 0;
-    size_t i = 0;
+    const size_t hash = hash_key(name, length);
+    size_t slot = 0;
+    char *copy = NULL;
 
-    for (i = 0; i < 4; i++)
+    if (table->size != 0)
     {
-        /* parse digit */
-        if ((input[i] >= '0') && (input[i] <= '9'))
-        {
-            h += (unsigned int) input[i] - '0';
-        }
-        else if ((input[i] >= 'A') && (input[i] <= 'F'))
+        for (slot = hash & (table->size - 1); table->entries[slot].name != NULL; slot = (slot + 1) & (table->size - 1))
         {
-            h += (unsigned int) 10 + input[i] - 'A';
-        }
-        else if ((input[i] >= 'a') && (input[i] <= 'f'))
-        {
-            h += (unsigned int) 10 + input[i] - 'a';
-        }
-        else /* invalid */
-        {
-            return 0;
-        }
-
-        if (i < 3)
-        {
-            /* shift left to make place for the next nibble */
-            h = h << 4;
+            const key_entry *entry = &table->entries[slot];
+            if ((entry->hash == hash) && (entry->length == length) && (memcmp(entry->name, name, length) == 0))
+            {
+                return entry->name;
+            }
         }
     }
 
-    return h;
-}
-
-/* converts a UTF-16 literal to UTF-8
- * A literal can be one or two sequences of the form \uXXXX */
-static unsigned char utf16_literal_to_utf8(const unsigned char * const input_pointer, const unsigned char * const input_end, unsigned char **output_pointer, const unsigned char **error_pointer)
-{
-    long unsigned int codepoint = 0;
-    unsigned int first_code = 0;
-    const unsigned char *first_sequence = input_pointer;
-    unsigned char utf8_length = 0;
-    unsigned char utf8_position = 0;
-    unsigned char sequence_length = 0;
-    unsigned char first_byte_mark = 0;
-
-    if ((input_end - first_sequence) < 6)
+    /* keep at least a quarter of the slots free */
+    if (((table->count + 1) * 4 > table->size * 3) && !key_table_grow(table))
     {
-        /* input ends unexpectedly */
-        *error_pointer = first_sequence;
-        goto fail;
+        return NULL;
     }
 
-    /* get the first utf16 sequence */
-    first_code = parse_hex4(first_sequence + 2);
+    copy = (char*)table->hooks.allocate(length + 1);
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+    memcpy(copy, name, length);
+    copy[length] = '\0';
 
-    /* check that the code is valid */
-    if (((first_code >= 0xDC00) && (first_code <= 0xDFFF)) || (first_code == 0))
+    for (slot = hash & (table->size - 1); table->entries[slot].name != NULL; slot = (slot + 1) & (table->size - 1))
     {
-        *error_pointer = first_sequence;
-        goto fail;
     }
+    table->entries[slot].name = copy;
+    table->entries[slot].length = length;
+    table->entries[slot].hash = hash;
+    table->count++;
 
-    /* UTF16 surrogate pair */
-    if ((first_code >= 0xD800) && (first_code <= 0xDBFF))
+    return copy;
+}
+
+CJSON_PUBLIC(cJSON_KeyTable *) cJSON_CreateKeyTable(void)
+{
+    cJSON_KeyTable *table = (cJSON_KeyTable*)global_hooks.allocate(sizeof(cJSON_KeyTable));
+    if (table == NULL)
     {
-        const unsigned char *second_sequence = first_sequence + 6;
-        unsigned int second_code = 0;
-        sequence_length = 12; /* \uXXXX\uXXXX */
+        return NULL;
+    }
 
-        if ((input_end - second_sequence) < 6)
-        {
-            /* input ends unexpectedly */
-            *error_pointer = first_sequence;
-            goto fail;
-        }
+    table->entries = NULL;
+    table->size = 0;
+    table->count = 0;
+    table->hooks = global_hooks;
+    table->hooks.arena = NULL;
+    table->hooks.keys = NULL;
 
-        if ((second_sequence[0] != '\\') || (second_sequence[1] != 'u'))
-        {
-            /* missing second half of the surrogate pair */
-            *error_pointer = first_sequence;
-            goto fail;
-        }
+    return table;
+}
 
-        /* get the second utf16 sequence */
-        second_code = parse_hex4(second_sequence + 2);
-        /* check that the code is valid */
-        if ((second_code < 0xDC00) || (second_code > 0xDFFF))
-        {
-            /* invalid second half of the surrogate pair */
-            *error_pointer = first_sequence;
-            goto fail;
-        }
+CJSON_PUBLIC(size_t) cJSON_GetKeyTableCount(const cJSON_KeyTable *table)
+{
+    return (table == NULL) ? 0 : table->count;
+}
 
+CJSON_PUBLIC(void) cJSON_DeleteKeyTable(cJSON_KeyTable *table)
+{
+    size_t slot = 0;
 
-        /* calculate the unicode codepoint from the surrogate pair */
-        codepoint = 0x10000 + (((first_code & 0x3FF) << 10) | (second_code & 0x3FF));
-    }
-    else
+    if (table == NULL)
     {
-        sequence_length = 6; /* \uXXXX */
-        codepoint = first_code;
+        return;
     }
 
-    /* encode as UTF-8
-     * takes at maximum 4 bytes to encode:
-     * 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx */
-    if (codepoint < 0x80)
+    for (slot = 0; slot < table->size; slot++)
     {
-        /* normal ascii, encoding 0xxxxxxx */
-        utf8_length = 1;
+        if (table->entries[slot].name != NULL)
+        {
+            table->hooks.deallocate(table->entries[slot].name);
+        }
     }
-    else if (codepoint < 0x800)
+    if (table->entries != NULL)
     {
-        /* two bytes, encoding 110xxxxx 10xxxxxx */
-        utf8_length = 2;
-        first_byte_mark = 0xC0; /* 11000000 */
+        table->hooks.deallocate(table->entries);
     }
-    else if (codepoint < 0x10000)
+    table->hooks.deallocate(table);
+}
+
+/* The memory of a node. With CJSON_INLINE_STRINGS it has room for a short name and string behind the item. */
+typedef struct
+{
+    cJSON item;
+#ifdef CJSON_INLINE_STRINGS
+    char name[CJSON_INLINE_STRING_SIZE];
+    char value[CJSON_INLINE_STRING_SIZE];
+#endif
+} node_storage;
+
+/* The room of item for its name or string, if size bytes fit into it. NULL otherwise and without CJSON_INLINE_STRINGS. */
+static char *inline_string(cJSON * const item, const cJSON_bool name, const size_t size)
+{
+#ifdef CJSON_INLINE_STRINGS
+    node_storage *storage = (node_storage*)item;
+    if (size <= CJSON_INLINE_STRING_SIZE)
     {
-        /* three bytes, encoding 1110xxxx 10xxxxxx 10xxxxxx */
-        utf8_length = 3;
-        first_byte_mark = 0xE0; /* 11100000 */
+        return name ? storage->name : storage->value;
     }
-    else if (codepoint <= 0x10FFFF)
+#else
+    (void)item;
+    (void)name;
+    (void)size;
+#endif
+
+    return NULL;
+}
+
+/* whether string is stored in the room of item, so it must not be freed on its own */
+static cJSON_bool is_inline_string(const cJSON * const item, const char * const string)
+{
+#ifdef CJSON_INLINE_STRINGS
+    const node_storage *storage = (const node_storage*)item;
+    return (string != NULL) && ((string == storage->name) || (string == storage->value));
+#else
+    (void)item;
+    (void)string;
+
+    return false;
+#endif
+}
+
+/* Free a name or string of item that isn't stored in its room. */
+static void deallocate_string(const cJSON * const item, char * const string, const internal_hooks * const hooks)
+{
+    if (!is_inline_string(item, string))
     {
-        /* four bytes, encoding 1110xxxx 10xxxxxx 10xxxxxx 10xxxxxx */
-        utf8_length = 4;
-        first_byte_mark = 0xF0; /* 11110000 */
+        deallocate_memory(string, hooks);
     }
-    else
+}
+
+/* Copy the length bytes of string (and the '\0' behind them) into the room of item if they fit, or a new allocation. */
+static char *store_string(cJSON * const item, const cJSON_bool name, const char * const string, const size_t length, const internal_hooks * const hooks)
+{
+    char *copy = inline_string(item, name, length + 1);
+    if (copy == NULL)
     {
-        /* invalid unicode codepoint */
-        *error_pointer = first_sequence;
-        goto fail;
+        return copy_string(string, length, hooks);
     }
+    memmove(copy, string, length + 1);
 
-    /* encode as utf8 */
-    for (utf8_position = (unsigned char)(utf8_length - 1); utf8_position > 0; utf8_position--)
+    return copy;
+}
+
+/* Make the string of item its name, for names that were parsed like strings. */
+static void move_string_to_name(cJSON * const item)
+{
+    const size_t stored_length = stored_valuestring_length(item);
+    size_t length = 0;
+
+    item->string = item->valuestring;
+    if (is_inline_string(item, item->valuestring))
     {
-        /* 10xxxxxx */
-        (*output_pointer)[utf8_position] = (unsigned char)((codepoint | 0x80) & 0xBF);
-        codepoint >>= 6;
+        /* the room for the string is needed by the value */
+        length = valuestring_length(item);
+        item->string = inline_string(item, true, length + 1);
+        memcpy(item->string, item->valuestring, length + 1);
     }
-    /* encode first byte */
-    if (utf8_length > 1)
+    store_name_length(item, stored_length);
+    item->valuestring = NULL;
+    item->valuestring_length = 0;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_IsInlineString(const cJSON *item, const char *string)
+{
+    return (item != NULL) && is_inline_string(item, string);
+}
+
+/* Internal constructor. */
+#ifdef CJSON_NODE_CACHE
+/* Nodes that were freed by the calling thread, linked through ->next. They belong to the allocator they were freed
+ * with, using another one empties the cache first. */
+typedef struct
+{
+    cJSON *nodes;
+    size_t count;
+    void *(*allocate)(size_t size);
+    void (*deallocate)(void *pointer);
+} node_cache;
+
+static CJSON_THREAD_LOCAL node_cache thread_node_cache = { NULL, 0, NULL, NULL };
+
+static void trim_node_cache(node_cache * const cache, const size_t keep)
+{
+    cJSON *node = NULL;
+    while (cache->count > keep)
     {
-        (*output_pointer)[0] = (unsigned char)((codepoint | first_byte_mark) & 0xFF);
+        node = cache->nodes;
+        cache->nodes = node->next;
+        cache->count--;
+        cache->deallocate(node);
     }
-    else
+}
+#endif
+
+static cJSON *allocate_node(const internal_hooks * const hooks)
+{
+#ifdef CJSON_NODE_CACHE
+    node_cache *cache = &thread_node_cache;
+    cJSON *node = cache->nodes;
+    if ((node != NULL) && (hooks->arena == NULL) && (hooks->allocate == cache->allocate) && (hooks->deallocate == cache->deallocate))
     {
-        (*output_pointer)[0] = (unsigned char)(codepoint & 0x7F);
+        if (!charge_budget(hooks, 0, sizeof(node_storage)))
+        {
+            return NULL;
+        }
+        cache->nodes = node->next;
+        cache->count--;
+        CJSON_TRACE(node, node, 1);
+        return node;
     }
+#endif
 
-    *output_pointer += utf8_length;
+    CJSON_TRACE(node, NULL, 0);
+    return (cJSON*)allocate_memory(sizeof(node_storage), hooks);
+}
 
-    return sequence_length;
+static void deallocate_node(cJSON * const node, const internal_hooks * const hooks)
+{
+#ifdef CJSON_NODE_CACHE
+    node_cache *cache = &thread_node_cache;
+    if (hooks->arena == NULL)
+    {
+        if ((hooks->allocate != cache->allocate) || (hooks->deallocate != cache->deallocate))
+        {
+            trim_node_cache(cache, 0);
+            cache->allocate = hooks->allocate;
+            cache->deallocate = hooks->deallocate;
+        }
+        if (cache->count < CJSON_NODE_CACHE_SIZE)
+        {
+            node->next = cache->nodes;
+            cache->nodes = node;
+            cache->count++;
+            return;
+        }
+    }
+#endif
 
-fail:
-    return 0;
+    deallocate_memory(node, hooks);
 }
 
-/* Parse the input text into an unescaped cinput, and populate item. */
-static const unsigned char *parse_string(cJSON * const item, const unsigned char * const input, const unsigned char ** const error_pointer, const internal_hooks * const hooks)
+CJSON_PUBLIC(void) cJSON_TrimNodeCache(size_t keep)
 {
-    const unsigned char *input_pointer = input + 1;
-    const unsigned char *input_end = input + 1;
-    unsigned char *output_pointer = NULL;
-    unsigned char *output = NULL;
+#ifdef CJSON_NODE_CACHE
+    trim_node_cache(&thread_node_cache, keep);
+#else
+    (void)keep;
+#endif
+}
 
-    /* not a string */
-    if (*input != '\"')
+static cJSON *cJSON_New_Item(const internal_hooks * const hooks)
+{
+    cJSON* node = charge_budget(hooks, 1, 0) ? allocate_node(hooks) : NULL;
+    stats_node(hooks);
+    if (node)
     {
-        *error_pointer = input;
-        goto fail;
+        memset(node, '\0', sizeof(cJSON));
     }
 
+    return node;
+}
+
+struct cJSON_Index;
+
+static void delete_index(struct cJSON_Index * const index);
+
+/* The index of an array or object, kept in its valuestring while it is flagged with cJSON_IsIndexed. NULL if it has none. */
+static struct cJSON_Index *get_index(const cJSON * const item)
+{
+    return (item->type & cJSON_IsIndexed) ? (struct cJSON_Index*)(void*)item->valuestring : NULL;
+}
+
+static void set_index(cJSON * const item, struct cJSON_Index * const index)
+{
+    item->valuestring = (char*)(void*)index;
+    item->type = (index != NULL) ? (item->type | cJSON_IsIndexed) : (item->type & ~cJSON_IsIndexed);
+}
+
+/* Delete at most count items of the list that starts with item, with all of their children, releasing their memory
+ * through the given hooks. Returns the items that are left.
+ * Instead of recursing, the children of an item are moved in front of the items that are still to be deleted. */
+static cJSON *delete_items(cJSON *item, size_t count, const internal_hooks * const hooks)
+{
+    cJSON *next = NULL;
+    cJSON *last_child = NULL;
+
+    for (; (item != NULL) && (count > 0); count--)
     {
-        /* calculate approximate size of the output (overestimate) */
-        size_t allocation_length = 0;
-        size_t skipped_bytes = 0;
-        while ((*input_end != '\"') && (*input_end != '\0'))
+        next = item->next;
+        if (!(item->type & cJSON_IsReference) && (item->child != NULL))
         {
-            /* is escape sequence */
-            if (input_end[0] == '\\')
+            /* the first child points to the last one, lists that were linked by hand may not have that */
+            last_child = item->child->prev;
+            if ((last_child == NULL) || (last_child->next != NULL))
             {
-                if (input_end[1] == '\0')
+                last_child = item->child;
+                while (last_child->next != NULL)
                 {
-                    /* prevent buffer overflow when last input character is a backslash */
-                    goto fail;
+                    last_child = last_child->next;
                 }
-                skipped_bytes++;
-                input_end++;
             }
-            input_end++;
+            last_child->next = next;
+            next = item->child;
         }
-        if (*input_end == '\0')
+        if (!(item->type & (cJSON_IsReference | cJSON_IsLazy | cJSON_IsIndexed)) && (item->valuestring != NULL))
         {
-            goto fail; /* string ended unexpectedly */
+            deallocate_string(item, item->valuestring, hooks);
         }
-
-        /* This is at most how much we need for the output */
-        allocation_length = (size_t) (input_end - input) - skipped_bytes;
-        output = (unsigned char*)hooks->allocate(allocation_length + sizeof('\0'));
-        if (output == NULL)
+        if (!(item->type & cJSON_StringIsConst) && (item->string != NULL))
         {
-            goto fail; /* allocation failure */
+            deallocate_string(item, item->string, hooks);
+        }
+        if (get_index(item) != NULL)
+        {
+            delete_index(get_index(item));
         }
+        deallocate_node(item, hooks);
+        item = next;
     }
 
-    output_pointer = output;
-    /* loop through the string literal */
-    while (input_pointer < input_end)
+    return item;
+}
+
+/* Delete a cJSON structure, releasing its memory through the given hooks. */
+static void delete_item(cJSON *item, const internal_hooks * const hooks)
+{
+    delete_items(item, (size_t)-1, hooks);
+}
+
+/* Delete a cJSON structure. */
+CJSON_PUBLIC(void) cJSON_Delete(cJSON *c)
+{
+    delete_item(c, &global_hooks);
+}
+
+struct cJSON_Reclaimer
+{
+    /* the items that are still to be deleted, linked through ->next */
+    cJSON *pending;
+};
+
+CJSON_PUBLIC(cJSON_Reclaimer *) cJSON_CreateReclaimer(void)
+{
+    cJSON_Reclaimer *reclaimer = (cJSON_Reclaimer*)global_hooks.allocate(sizeof(cJSON_Reclaimer));
+    if (reclaimer == NULL)
     {
-        if (*input_pointer != '\\')
-        {
-            *output_pointer++ = *input_pointer++;
-        }
-        /* escape sequence */
-        else
-        {
-            unsigned char sequence_length = 2;
-            switch (input_pointer[1])
-            {
-                case 'b':
-                    *output_pointer++ = '\b';
-                    break;
-                case 'f':
-                    *output_pointer++ = '\f';
-                    break;
-                case 'n':
-                    *output_pointer++ = '\n';
-                    break;
-                case 'r':
-                    *output_pointer++ = '\r';
-                    break;
-                case 't':
-                    *output_pointer++ = '\t';
-                    break;
-                case '\"':
-                case '\\':
-                case '/':
-                    *output_pointer++ = input_pointer[1];
-                    break;
-
-                /* UTF-16 literal */
-                case 'u':
-                    sequence_length = utf16_literal_to_utf8(input_pointer, input_end, &output_pointer, error_pointer);
-                    if (sequence_length == 0)
-                    {
-                        /* failed to convert UTF16-literal to UTF-8 */
-                        goto fail;
-                    }
-                    break;
-
-                default:
-                    *error_pointer = input_pointer;
-                    goto fail;
-            }
-            input_pointer += sequence_length;
-        }
+        return NULL;
     }
+    reclaimer->pending = NULL;
 
-    /* zero terminate the output */
-    *output_pointer = '\0';
-
-    item->type = cJSON_String;
-    item->valuestring = (char*)output;
+    return reclaimer;
+}
 
-    return input_end + 1;
+CJSON_PUBLIC(void) cJSON_DeleteDeferred(cJSON_Reclaimer *reclaimer, cJSON *item)
+{
+    cJSON *last = item;
 
-fail:
-    if (output != NULL)
+    if (reclaimer == NULL)
+    {
+        cJSON_Delete(item);
+        return;
+    }
+    if (item == NULL)
     {
-        hooks->deallocate(output);
+        return;
     }
 
-    return NULL;
+    /* like cJSON_Delete, the items after item go too */
+    while (last->next != NULL)
+    {
+        last = last->next;
+    }
+    last->next = reclaimer->pending;
+    reclaimer->pending = item;
 }
 
-/* Render the cstring provided to an escaped version that can be printed. */
-static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffer * const output_buffer, const internal_hooks * const hooks)
+CJSON_PUBLIC(cJSON_bool) cJSON_Reclaim(cJSON_Reclaimer *reclaimer, size_t count)
 {
-    const unsigned char *input_pointer = NULL;
-    unsigned char *output = NULL;
-    unsigned char *output_pointer = NULL;
-    size_t output_length = 0;
-    /* numbers of additional characters needed for escaping */
-    size_t escape_characters = 0;
-
-    if (output_buffer == NULL)
+    if ((reclaimer == NULL) || (reclaimer->pending == NULL))
     {
         return false;
     }
 
-    /* empty string */
-    if (input == NULL)
-    {
-        output = ensure(output_buffer, sizeof("\"\""), hooks);
-        if (output == NULL)
-        {
-            return false;
-        }
-        strcpy((char*)output, "\"\"");
+    reclaimer->pending = delete_items(reclaimer->pending, count, &global_hooks);
 
-        return true;
-    }
+    return reclaimer->pending != NULL;
+}
 
-    /* set "flag" to 1 if something needs to be escaped */
-    for (input_pointer = input; *input_pointer; input_pointer++)
+CJSON_PUBLIC(void) cJSON_DeleteReclaimer(cJSON_Reclaimer *reclaimer)
+{
+    if (reclaimer == NULL)
     {
-        if (strchr("\"\\\b\f\n\r\t", *input_pointer))
-        {
-            /* one character escape sequence */
-            escape_characters++;
-        }
-        else if (*input_pointer < 32)
-        {
-            /* UTF-16 escape sequence uXXXX */
-            escape_characters += 5;
-        }
+        return;
     }
-    output_length = (size_t)(input_pointer - input) + escape_characters;
 
-    output = ensure(output_buffer, output_length + sizeof("\"\""), hooks);
-    if (output == NULL)
-    {
-        return false;
-    }
+    delete_item(reclaimer->pending, &global_hooks);
+    global_hooks.deallocate(reclaimer);
+}
 
-    /* no characters have to be escaped */
-    if (escape_characters == 0)
-    {
-        output[0] = '\"';
-        memcpy(output + 1, input, output_length);
-        output[output_length + 1] = '\"';
-        output[output_length + 2] = '\0';
+/* A member of an object in the order of canonical printing, position breaks ties between duplicate keys. */
+typedef struct
+{
+    const cJSON *item;
+    size_t position;
+} sorted_member;
 
-        return true;
-    }
+/* One level of nesting while walking or building a tree without recursion. */
+typedef struct
+{
+    const cJSON *source; /* the array or object that is read */
+    const cJSON *current; /* the child of source that is read */
+    cJSON *container; /* the array or object that is built */
+    cJSON *last; /* the last child of container */
+    size_t index; /* a position or count that belongs to the level */
+    sorted_member *members; /* the members of source in printing order, terminated by a NULL item (canonical printing) */
+    size_t start; /* where the text of source begins in the output (printing with a cJSON_PrintCache) */
+} nesting_frame;
+
+#define is_container(item) ((((item)->type & 0xFF) == cJSON_Array) || (((item)->type & 0xFF) == cJSON_Object))
+
+/* the buffer of a packed array (flagged cJSON_IsPacked), valueint is the number of elements */
+static double *packed_numbers(const cJSON * const item)
+{
+    return (double*)(void*)item->valuestring;
+}
 
-    output[0] = '\"';
-    output_pointer = output + 1;
-    /* copy the string */
-    for (input_pointer = input; *input_pointer != '\0'; (void)input_pointer++, output_pointer++)
+/* frames that fit on the C stack, deeper nesting moves them to the heap */
+#define NESTING_LOCAL_FRAMES 16
+
+typedef struct
+{
+    nesting_frame *frames;
+    size_t depth;
+    size_t size;
+    const internal_hooks *hooks;
+    nesting_frame local_frames[NESTING_LOCAL_FRAMES];
+} nesting_stack;
+
+static void nesting_init(nesting_stack * const stack, const internal_hooks * const hooks)
+{
+    stack->frames = stack->local_frames;
+    stack->depth = 0;
+    stack->size = NESTING_LOCAL_FRAMES;
+    stack->hooks = hooks;
+}
+
+/* Returns the new top of the stack (frames may have moved) or NULL if out of memory. */
+static nesting_frame *nesting_push(nesting_stack * const stack)
+{
+    nesting_frame *frames = NULL;
+    nesting_frame *frame = NULL;
+
+    if (stack->depth == stack->size)
     {
-        if ((*input_pointer > 31) && (*input_pointer != '\"') && (*input_pointer != '\\'))
+        if (stack->size > (((size_t)-1) / sizeof(nesting_frame) / 2))
         {
-            /* normal character, copy */
-            *output_pointer = *input_pointer;
+            return NULL;
         }
-        else
+
+        /* the stack isn't part of the tree, so it doesn't go into an arena */
+        stats_allocation(stack->hooks, stack->size * 2 * sizeof(nesting_frame));
+        frames = (nesting_frame*)stack->hooks->allocate(stack->size * 2 * sizeof(nesting_frame));
+        if (frames == NULL)
         {
-            /* character needs to be escaped */
-            *output_pointer++ = '\\';
-            switch (*input_pointer)
-            {
-                case '\\':
-                    *output_pointer = '\\';
-                    break;
-                case '\"':
-                    *output_pointer = '\"';
-                    break;
-                case '\b':
-                    *output_pointer = 'b';
-                    break;
-                case '\f':
-                    *output_pointer = 'f';
-                    break;
-                case '\n':
-                    *output_pointer = 'n';
-                    break;
-                case '\r':
-                    *output_pointer = 'r';
-                    break;
-                case '\t':
-                    *output_pointer = 't';
-                    break;
-                default:
-                    /* escape and print as unicode codepoint */
-                    sprintf((char*)output_pointer, "u%04x", *input_pointer);
-                    output_pointer += 4;
-                    break;
-            }
+            return NULL;
+        }
+        memcpy(frames, stack->frames, stack->size * sizeof(nesting_frame));
+        if (stack->frames != stack->local_frames)
+        {
+            stack->hooks->deallocate(stack->frames);
         }
+        stack->frames = frames;
+        stack->size *= 2;
     }
-    output[output_length + 1] = '\"';
-    output[output_length + 2] = '\0';
 
-    return true;
+    frame = &stack->frames[stack->depth++];
+    stats_depth(stack->hooks, stack->depth);
+    memset(frame, '\0', sizeof(nesting_frame));
+
+    return frame;
 }
 
-/* Invoke print_string_ptr (which is useful) on an item. */
-static cJSON_bool print_string(const cJSON * const item, printbuffer * const p, const internal_hooks * const hooks)
+static void nesting_free(nesting_stack * const stack)
 {
-    return print_string_ptr((unsigned char*)item->valuestring, p, hooks);
+    if (stack->frames != stack->local_frames)
+    {
+        stack->hooks->deallocate(stack->frames);
+    }
+    stack->frames = stack->local_frames;
+    stack->depth = 0;
 }
 
-/* Predeclare these prototypes. */
-static const unsigned char *parse_value(cJSON * const item, const unsigned char * const input, const unsigned char ** const ep, const internal_hooks * const hooks);
-static cJSON_bool print_value(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks);
-static const unsigned char *parse_array(cJSON * const item, const unsigned char *input, const unsigned char ** const ep, const internal_hooks * const hooks);
-static cJSON_bool print_array(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks);
-static const unsigned char *parse_object(cJSON * const item, const unsigned char *input, const unsigned char ** const ep, const internal_hooks * const hooks);
-static cJSON_bool print_object(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks);
-
-/* Utility to jump whitespace and cr/lf */
-static const unsigned char *skip_whitespace(const unsigned char *in)
+/* don't ask me, but the original cJSON_SetNumberValue returns an integer or double */
+CJSON_PUBLIC(double) cJSON_SetNumberHelper(cJSON *object, double number)
 {
-    while (in && *in && (*in <= 32))
+    if (object->type & cJSON_IsFrozen)
     {
-        in++;
+        return object->valuedouble;
+    }
+    object->type &= ~(cJSON_IsRendered | cJSON_IsHashed);
+    if (((object->type & 0xFF) == cJSON_Number) && (object->type & cJSON_IsLazy))
+    {
+        /* the text doesn't match anymore */
+        object->type &= ~cJSON_IsLazy;
+        object->valuestring = NULL;
+        object->valuestring_length = 0;
+    }
+    if (number >= INT_MAX)
+    {
+        object->valueint = INT_MAX;
+    }
+    else if (number <= INT_MIN)
+    {
+        object->valueint = INT_MIN;
+    }
+    else
+    {
+        object->valueint = (int)number;
     }
 
-    return in;
+    return object->valuedouble = number;
 }
 
-/* Parse an object - create a new root, and populate. */
-CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
+CJSON_PUBLIC(char*) cJSON_SetValuestring(cJSON *object, const char *valuestring)
 {
-    const unsigned char *end = NULL;
-    /* use global error pointer if no specific one was given */
-    const unsigned char **ep = return_parse_end ? (const unsigned char**)return_parse_end : &global_ep;
-    cJSON *c = cJSON_New_Item(&global_hooks);
-    *ep = NULL;
-    if (!c) /* memory fail */
-    {
-        return NULL;
-    }
+    size_t length = 0;
+    size_t old_length = 0;
+    char *copy = NULL;
 
-    end = parse_value(c, skip_whitespace((const unsigned char*)value), ep, &global_hooks);
-    if (!end)
+    if ((object == NULL) || (valuestring == NULL) || ((object->type & 0xFF) != cJSON_String)
+            || (object->type & (cJSON_IsReference | cJSON_IsFrozen)))
     {
-        /* parse failure. ep is set. */
-        cJSON_Delete(c);
         return NULL;
     }
-
-    /* if we require null-terminated JSON without appended garbage, skip and then check for a null terminator */
-    if (require_null_terminated)
+    if ((object->valuestring != NULL) && !(object->type & (cJSON_IsLazy | cJSON_IsBinary)))
     {
-        end = skip_whitespace(end);
-        if (*end)
+        old_length = valuestring_length(object);
+        if ((valuestring >= object->valuestring) && (valuestring <= (object->valuestring + old_length)))
         {
-            cJSON_Delete(c);
-            *ep = end;
             return NULL;
         }
     }
-    if (return_parse_end)
+
+    length = strlen(valuestring);
+    if (!(object->type & (cJSON_IsLazy | cJSON_IsBinary)) && (object->valuestring != NULL) && (length <= old_length))
     {
-        *return_parse_end = (const char*)end;
+        /* fits into the memory of the old one */
+        copy = object->valuestring;
+        memcpy(copy, valuestring, length + 1);
+    }
+    else
+    {
+        copy = store_string(object, false, valuestring, length, &global_hooks);
+        if (copy == NULL)
+        {
+            return NULL;
+        }
+        if (!(object->type & cJSON_IsLazy) && (object->valuestring != NULL) && (object->valuestring != copy))
+        {
+            deallocate_string(object, object->valuestring, &global_hooks);
+        }
     }
+    object->type &= ~(cJSON_IsLazy | cJSON_IsBinary | cJSON_IsRendered | cJSON_IsHashed);
+    object->valueint = 0;
+    object->valuestring = copy;
+    store_valuestring_length(object, length);
 
-    return c;
+    return copy;
 }
 
-/* Default options for cJSON_Parse */
-CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value)
+typedef struct
 {
-    return cJSON_ParseWithOpts(value, 0, 0);
-}
+    unsigned char *buffer;
+    size_t length;
+    size_t offset;
+    cJSON_bool noalloc;
+    /* if set, a full buffer is handed to the writer and reused instead of growing it */
+    cJSON_WriteFunction writer;
+    void *writer_context;
+    /* print RFC 8785 canonical JSON: members sorted by key and numbers like ECMAScript */
+    cJSON_bool canonical;
+    /* if set, the positions of slots are recorded in this template instead of failing to print them */
+    cJSON_Template *slots;
+    /* if set, a full buffer is kept as a chunk of this list and printing continues in the next chunk */
+    cJSON_ChunkList *chunks;
+    /* if set, unchanged arrays and objects are copied from this cache and the others are added to it */
+    cJSON_PrintCache *print_cache;
+} printbuffer;
 
-#define min(a, b) ((a < b) ? a : b)
+/* size of the buffer for cJSON_PrintToWriter */
+#define CJSON_WRITER_BUFFER_SIZE 4096
 
-static unsigned char *print(const cJSON * const item, cJSON_bool format, const internal_hooks * const hooks)
+struct cJSON_ChunkList
 {
-    printbuffer buffer[1];
-    unsigned char *printed = NULL;
-
-    memset(buffer, 0, sizeof(buffer));
+    size_t chunk_size;
+    /* the chunks of the last document */
+    cJSON_Chunk *chunks;
+    size_t count;
+    /* chunks with a buffer, the ones after count are kept for the next document */
+    size_t allocated;
+    size_t capacity;
+    /* the size of the buffer of every chunk */
+    size_t *sizes;
+};
+
+/* Finish the current chunk of p and continue in the next one, which has at least needed bytes. */
+static unsigned char *next_chunk(printbuffer * const p, const size_t needed, const internal_hooks * const hooks)
+{
+    cJSON_ChunkList * const list = p->chunks;
+    cJSON_Chunk *chunks = NULL;
+    size_t *sizes = NULL;
+    size_t size = 0;
 
-    /* create buffer */
-    buffer->buffer = (unsigned char*) hooks->allocate(256);
-    if (buffer->buffer == NULL)
+    if (list->count > 0)
     {
-        goto fail;
+        if (p->offset == 0)
+        {
+            /* the current chunk is still empty, replace it */
+            list->count--;
+        }
+        else
+        {
+            list->chunks[list->count - 1].length = p->offset;
+        }
     }
 
-    /* print the value */
-    if (!print_value(item, 0, format, buffer, hooks))
+    if (list->count == list->capacity)
     {
-        goto fail;
+        list->capacity = (list->capacity == 0) ? 8 : (list->capacity * 2);
+        chunks = (cJSON_Chunk*)hooks->allocate(list->capacity * sizeof(cJSON_Chunk));
+        sizes = (size_t*)hooks->allocate(list->capacity * sizeof(size_t));
+        if ((chunks == NULL) || (sizes == NULL))
+        {
+            if (chunks != NULL)
+            {
+                hooks->deallocate(chunks);
+            }
+            if (sizes != NULL)
+            {
+                hooks->deallocate(sizes);
+            }
+            list->capacity = list->count;
+            return NULL;
+        }
+        if (list->chunks != NULL)
+        {
+            memcpy(chunks, list->chunks, list->allocated * sizeof(cJSON_Chunk));
+            memcpy(sizes, list->sizes, list->allocated * sizeof(size_t));
+            hooks->deallocate(list->chunks);
+            hooks->deallocate(list->sizes);
+        }
+        list->chunks = chunks;
+        list->sizes = sizes;
     }
-    update_offset(buffer);
 
-    /* copy the buffer over to a new one */
-    printed = (unsigned char*) hooks->allocate(buffer->offset + 1);
-    if (printed == NULL)
+    if (list->count == list->allocated)
     {
-        goto fail;
+        list->chunks[list->count].base = NULL;
+        list->allocated++;
     }
-    strncpy((char*)printed, (char*)buffer->buffer, min(buffer->length, buffer->offset + 1));
-    printed[buffer->offset] = '\0'; /* just to be sure */
-
-    /* free the buffer */
-    hooks->deallocate(buffer->buffer);
-
-    return printed;
-
-fail:
-    if (buffer->buffer != NULL)
+    else if ((list->chunks[list->count].base != NULL) && (list->sizes[list->count] < needed))
     {
-        hooks->deallocate(buffer->buffer);
+        /* a pooled chunk that is too small for a single large value */
+        hooks->deallocate(list->chunks[list->count].base);
+        list->chunks[list->count].base = NULL;
     }
-
-    if (printed != NULL)
+    if (list->chunks[list->count].base == NULL)
     {
-        hooks->deallocate(printed);
+        size = (needed > list->chunk_size) ? needed : list->chunk_size;
+        stats_allocation(hooks, size);
+        list->chunks[list->count].base = hooks->allocate(size);
+        if (list->chunks[list->count].base == NULL)
+        {
+            return NULL;
+        }
+        list->sizes[list->count] = size;
     }
 
-    return NULL;
-}
+    list->chunks[list->count].length = 0;
+    p->buffer = (unsigned char*)list->chunks[list->count].base;
+    p->length = list->sizes[list->count];
+    p->offset = 0;
+    list->count++;
 
-/* Render a cJSON item/entity/structure to text. */
-CJSON_PUBLIC(char *) cJSON_Print(const cJSON *item)
-{
-    return (char*)print(item, true, &global_hooks);
+    return p->buffer;
 }
 
-CJSON_PUBLIC(char *) cJSON_PrintUnformatted(const cJSON *item)
+/* realloc printbuffer if necessary to have at least "needed" bytes more */
+static unsigned char* ensure(printbuffer * const p, size_t needed, const internal_hooks * const hooks)
 {
-    return (char*)print(item, false, &global_hooks);
-}
-
-CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON_bool fmt)
-{
-    printbuffer p;
+    unsigned char *newbuffer = NULL;
+    size_t newsize = 0;
 
-    if (prebuffer < 0)
+    if ((p == NULL) || (p->buffer == NULL))
     {
         return NULL;
     }
 
-    p.buffer = (unsigned char*)global_hooks.allocate((size_t)prebuffer);
-    if (!p.buffer)
+    if (needed > ((size_t)-1 - p->offset))
     {
         return NULL;
     }
 
-    p.length = (size_t)prebuffer;
-    p.offset = 0;
-    p.noalloc = false;
-
-    if (!print_value(item, 0, fmt, &p, &global_hooks))
+    needed += p->offset;
+    if (needed <= p->length)
     {
-        return NULL;
+        return p->buffer + p->offset;
     }
 
-    return (char*)p.buffer;
-}
-
-CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buf, const int len, const cJSON_bool fmt)
-{
-    printbuffer p;
-
-    if (len < 0)
+    if (p->writer != NULL)
     {
-        return false;
+        /* everything before offset is complete, hand it to the writer and start over */
+        if ((p->offset > 0) && !p->writer((const char*)p->buffer, p->offset, p->writer_context))
+        {
+            return NULL;
+        }
+        needed -= p->offset;
+        p->offset = 0;
+        if (needed <= p->length)
+        {
+            return p->buffer;
+        }
+        /* only a single value that is larger than the buffer makes it grow */
     }
 
-    p.buffer = (unsigned char*)buf;
-    p.length = (size_t)len;
-    p.offset = 0;
-    p.noalloc = true;
-    return print_value(item, 0, fmt, &p, &global_hooks);
-}
-
-/* Parser core - when encountering text, process appropriately. */
-static const unsigned  char *parse_value(cJSON * const item, const unsigned char * const input, const unsigned char ** const error_pointer, const internal_hooks * const hooks)
-{
-    if (input == NULL)
+    if (p->chunks != NULL)
     {
-        return NULL; /* no input */
+        return next_chunk(p, needed - p->offset, hooks);
     }
 
-    /* parse the different types of values */
-    /* null */
-    if (!strncmp((const char*)input, "null", 4))
-    {
-        item->type = cJSON_NULL;
-        return input + 4;
+    if (p->noalloc) {
+        return NULL;
     }
-    /* false */
-    if (!strncmp((const char*)input, "false", 5))
+
+    /* calculate new buffer size */
+    newsize = needed * 2;
+    if (needed > ((size_t)-1 / 2))
     {
-        item->type = cJSON_False;
-        return input + 5;
+        /* overflow of size_t, use the largest size instead */
+        newsize = (size_t)-1;
     }
-    /* true */
-    if (!strncmp((const char*)input, "true", 4))
+
+    CJSON_TRACE(buffer_grow, p->length, newsize);
+    stats_allocation(hooks, newsize);
+    stats_buffer(hooks, newsize);
+    if (hooks->reallocate != NULL)
     {
-        item->type = cJSON_True;
-        item->valueint = 1;
-        return input + 4;
+        /* reallocate with realloc if available */
+        newbuffer = (unsigned char*)hooks->reallocate(p->buffer, newsize);
     }
-    /* string */
-    if (*input == '\"')
+    else
     {
-        return parse_string(item, input, error_pointer, hooks);
+        /* otherwise reallocate manually */
+        newbuffer = (unsigned char*)hooks->allocate(newsize);
+        if (!newbuffer)
+        {
+            hooks->deallocate(p->buffer);
+            p->length = 0;
+            p->buffer = NULL;
+
+            return NULL;
+        }
+        if (newbuffer)
+        {
+            memcpy(newbuffer, p->buffer, p->offset + 1);
+        }
+        hooks->deallocate(p->buffer);
     }
-    /* number */
-    if ((*input == '-') || ((*input >= '0') && (*input <= '9')))
+    p->length = newsize;
+    p->buffer = newbuffer;
+
+    return newbuffer + p->offset;
+}
+
+/* calculate the new length of the string in a printbuffer and update the offset */
+static void update_offset(printbuffer * const buffer)
+{
+    const unsigned char *buffer_pointer = NULL;
+    if ((buffer == NULL) || (buffer->buffer == NULL))
     {
-        return parse_number(item, input);
+        return;
     }
-    /* array */
-    if (*input == '[')
+    buffer_pointer = buffer->buffer + buffer->offset;
+
+    buffer->offset += strlen((const char*)buffer_pointer);
+}
+
+#ifndef CJSON_INTEGER_ONLY
+/* get the decimal point character of the current locale */
+static unsigned char get_decimal_point(void)
+{
+    struct lconv *lconv = localeconv();
+    return (unsigned char) lconv->decimal_point[0];
+}
+#endif
+
+/* Render an integer without going through sprintf, returns the number of characters written. */
+static size_t print_integer(unsigned char * const output, const long integer)
+{
+    unsigned char digits[sizeof(long) * 3];
+    size_t digit_count = 0;
+    size_t length = 0;
+    /* the magnitude of LONG_MIN doesn't fit into a long */
+    unsigned long magnitude = (integer < 0) ? (0ul - (unsigned long)integer) : (unsigned long)integer;
+
+    do
+    {
+        digits[digit_count++] = (unsigned char)('0' + (magnitude % 10));
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (integer < 0)
     {
-        return parse_array(item, input, error_pointer, hooks);
+        output[length++] = '-';
     }
-    /* object */
-    if (*input == '{')
+    while (digit_count > 0)
     {
-        return parse_object(item, input, error_pointer, hooks);
+        output[length++] = digits[--digit_count];
     }
+    output[length] = '\0';
 
-    /* failure. */
-    *error_pointer = input;
-    return NULL;
+    return length;
 }
 
-/* Render a value to text. */
-static cJSON_bool print_value(const cJSON * const item, const size_t depth, const cJSON_bool format,  printbuffer * const output_buffer, const internal_hooks * const hooks)
-{
-    unsigned char *output = NULL;
+#define NUMBER_BUFFER_SIZE 26
 
-    if ((item == NULL) || (output_buffer == NULL))
-    {
-        return false;
-    }
+/* true on machines that store the least significant byte first */
+static cJSON_bool is_little_endian(void)
+{
+    const unsigned int probe = 1;
 
-    switch ((item->type) & 0xFF)
-    {
-        case cJSON_NULL:
-            output = ensure(output_buffer, 5, hooks);
-            if (output == NULL)
-            {
-                return false;
-            }
-            strcpy((char*)output, "null");
-            return true;
+    return *((const unsigned char*)&probe) == 1;
+}
 
-        case cJSON_False:
-            output = ensure(output_buffer, 6, hooks);
-            if (output == NULL)
-            {
-                return false;
-            }
-            strcpy((char*)output, "false");
-            return true;
+/* The shortest digits of a number are found with Grisu3 (Florian Loitsch, "Printing Floating-Point Numbers Quickly
+ * and Accurately with Integers"). C89 has no 64 bit integer type, so those are kept as two 32 bit halves. */
+typedef struct
+{
+    unsigned long high;
+    unsigned long low;
+} grisu_uint64;
 
-        case cJSON_True:
-            output = ensure(output_buffer, 5, hooks);
-            if (output == NULL)
-            {
-                return false;
-            }
-            strcpy((char*)output, "true");
-            return true;
+/* f * 2^e */
+typedef struct
+{
+    grisu_uint64 f;
+    int e;
+} grisu_fp;
 
-        case cJSON_Number:
-            return print_number(item, output_buffer, hooks);
+/* a normalized power of ten 10^decimal_exponent = f * 2^binary_exponent */
+typedef struct
+{
+    unsigned long high;
+    unsigned long low;
+    short binary_exponent;
+    short decimal_exponent;
+} grisu_power;
 
-        case cJSON_Raw:
-        {
-            size_t raw_length = 0;
-            if (item->valuestring == NULL)
-            {
-                if (!output_buffer->noalloc)
-                {
-                    hooks->deallocate(output_buffer->buffer);
-                }
-                return false;
-            }
+#define GRISU_MASK_32 0xFFFFFFFFUL
+#define GRISU_POWER_OFFSET 348 /* -decimal_exponent of the first cached power */
+#define GRISU_POWER_DISTANCE 8 /* decimal exponents between two cached powers */
 
-            raw_length = strlen(item->valuestring) + sizeof('\0');
-            output = ensure(output_buffer, raw_length, hooks);
-            if (output == NULL)
-            {
-                return false;
-            }
-            memcpy(output, item->valuestring, raw_length);
-            return true;
-        }
+static const grisu_power grisu_powers[] =
+{
+    { 0xFA8FD5A0UL, 0x081C0288UL, -1220, -348 },
+    { 0xBAAEE17FUL, 0xA23EBF76UL, -1193, -340 },
+    { 0x8B16FB20UL, 0x3055AC76UL, -1166, -332 },
+    { 0xCF42894AUL, 0x5DCE35EAUL, -1140, -324 },
+    { 0x9A6BB0AAUL, 0x55653B2DUL, -1113, -316 },
+    { 0xE61ACF03UL, 0x3D1A45DFUL, -1087, -308 },
+    { 0xAB70FE17UL, 0xC79AC6CAUL, -1060, -300 },
+    { 0xFF77B1FCUL, 0xBEBCDC4FUL, -1034, -292 },
+    { 0xBE5691EFUL, 0x416BD60CUL, -1007, -284 },
+    { 0x8DD01FADUL, 0x907FFC3CUL, -980, -276 },
+    { 0xD3515C28UL, 0x31559A83UL, -954, -268 },
+    { 0x9D71AC8FUL, 0xADA6C9B5UL, -927, -260 },
+    { 0xEA9C2277UL, 0x23EE8BCBUL, -901, -252 },
+    { 0xAECC4991UL, 0x4078536DUL, -874, -244 },
+    { 0x823C1279UL, 0x5DB6CE57UL, -847, -236 },
+    { 0xC2109436UL, 0x4DFB5637UL, -821, -228 },
+    { 0x9096EA6FUL, 0x3848984FUL, -794, -220 },
+    { 0xD77485CBUL, 0x25823AC7UL, -768, -212 },
+    { 0xA086CFCDUL, 0x97BF97F4UL, -741, -204 },
+    { 0xEF340A98UL, 0x172AACE5UL, -715, -196 },
+    { 0xB23867FBUL, 0x2A35B28EUL, -688, -188 },
+    { 0x84C8D4DFUL, 0xD2C63F3BUL, -661, -180 },
+    { 0xC5DD4427UL, 0x1AD3CDBAUL, -635, -172 },
+    { 0x936B9FCEUL, 0xBB25C996UL, -608, -164 },
+    { 0xDBAC6C24UL, 0x7D62A584UL, -582, -156 },
+    { 0xA3AB6658UL, 0x0D5FDAF6UL, -555, -148 },
+    { 0xF3E2F893UL, 0xDEC3F126UL, -529, -140 },
+    { 0xB5B5ADA8UL, 0xAAFF80B8UL, -502, -132 },
+    { 0x87625F05UL, 0x6C7C4A8BUL, -475, -124 },
+    { 0xC9BCFF60UL, 0x34C13053UL, -449, -116 },
+    { 0x964E858CUL, 0x91BA2655UL, -422, -108 },
+    { 0xDFF97724UL, 0x70297EBDUL, -396, -100 },
+    { 0xA6DFBD9FUL, 0xB8E5B88FUL, -369, -92 },
+    { 0xF8A95FCFUL, 0x88747D94UL, -343, -84 },
+    { 0xB9447093UL, 0x8FA89BCFUL, -316, -76 },
+    { 0x8A08F0F8UL, 0xBF0F156BUL, -289, -68 },
+    { 0xCDB02555UL, 0x653131B6UL, -263, -60 },
+    { 0x993FE2C6UL, 0xD07B7FACUL, -236, -52 },
+    { 0xE45C10C4UL, 0x2A2B3B06UL, -210, -44 },
+    { 0xAA242499UL, 0x697392D3UL, -183, -36 },
+    { 0xFD87B5F2UL, 0x8300CA0EUL, -157, -28 },
+    { 0xBCE50864UL, 0x92111AEBUL, -130, -20 },
+    { 0x8CBCCC09UL, 0x6F5088CCUL, -103, -12 },
+    { 0xD1B71758UL, 0xE219652CUL, -77, -4 },
+    { 0x9C400000UL, 0x00000000UL, -50, 4 },
+    { 0xE8D4A510UL, 0x00000000UL, -24, 12 },
+    { 0xAD78EBC5UL, 0xAC620000UL, 3, 20 },
+    { 0x813F3978UL, 0xF8940984UL, 30, 28 },
+    { 0xC097CE7BUL, 0xC90715B3UL, 56, 36 },
+    { 0x8F7E32CEUL, 0x7BEA5C70UL, 83, 44 },
+    { 0xD5D238A4UL, 0xABE98068UL, 109, 52 },
+    { 0x9F4F2726UL, 0x179A2245UL, 136, 60 },
+    { 0xED63A231UL, 0xD4C4FB27UL, 162, 68 },
+    { 0xB0DE6538UL, 0x8CC8ADA8UL, 189, 76 },
+    { 0x83C7088EUL, 0x1AAB65DBUL, 216, 84 },
+    { 0xC45D1DF9UL, 0x42711D9AUL, 242, 92 },
+    { 0x924D692CUL, 0xA61BE758UL, 269, 100 },
+    { 0xDA01EE64UL, 0x1A708DEAUL, 295, 108 },
+    { 0xA26DA399UL, 0x9AEF774AUL, 322, 116 },
+    { 0xF209787BUL, 0xB47D6B85UL, 348, 124 },
+    { 0xB454E4A1UL, 0x79DD1877UL, 375, 132 },
+    { 0x865B8692UL, 0x5B9BC5C2UL, 402, 140 },
+    { 0xC83553C5UL, 0xC8965D3DUL, 428, 148 },
+    { 0x952AB45CUL, 0xFA97A0B3UL, 455, 156 },
+    { 0xDE469FBDUL, 0x99A05FE3UL, 481, 164 },
+    { 0xA59BC234UL, 0xDB398C25UL, 508, 172 },
+    { 0xF6C69A72UL, 0xA3989F5CUL, 534, 180 },
+    { 0xB7DCBF53UL, 0x54E9BECEUL, 561, 188 },
+    { 0x88FCF317UL, 0xF22241E2UL, 588, 196 },
+    { 0xCC20CE9BUL, 0xD35C78A5UL, 614, 204 },
+    { 0x98165AF3UL, 0x7B2153DFUL, 641, 212 },
+    { 0xE2A0B5DCUL, 0x971F303AUL, 667, 220 },
+    { 0xA8D9D153UL, 0x5CE3B396UL, 694, 228 },
+    { 0xFB9B7CD9UL, 0xA4A7443CUL, 720, 236 },
+    { 0xBB764C4CUL, 0xA7A44410UL, 747, 244 },
+    { 0x8BAB8EEFUL, 0xB6409C1AUL, 774, 252 },
+    { 0xD01FEF10UL, 0xA657842CUL, 800, 260 },
+    { 0x9B10A4E5UL, 0xE9913129UL, 827, 268 },
+    { 0xE7109BFBUL, 0xA19C0C9DUL, 853, 276 },
+    { 0xAC2820D9UL, 0x623BF429UL, 880, 284 },
+    { 0x80444B5EUL, 0x7AA7CF85UL, 907, 292 },
+    { 0xBF21E440UL, 0x03ACDD2DUL, 933, 300 },
+    { 0x8E679C2FUL, 0x5E44FF8FUL, 960, 308 },
+    { 0xD433179DUL, 0x9C8CB841UL, 986, 316 },
+    { 0x9E19DB92UL, 0xB4E31BA9UL, 1013, 324 },
+    { 0xEB96BF6EUL, 0xBADF77D9UL, 1039, 332 },
+    { 0xAF87023BUL, 0x9BF0EE6BUL, 1066, 340 }
+};
+
+static grisu_uint64 grisu_make(const unsigned long high, const unsigned long low)
+{
+    grisu_uint64 result;
+    result.high = high & GRISU_MASK_32;
+    result.low = low & GRISU_MASK_32;
 
-        case cJSON_String:
-            return print_string(item, output_buffer, hooks);
+    return result;
+}
 
-        case cJSON_Array:
-            return print_array(item, depth, format, output_buffer, hooks);
+static grisu_uint64 grisu_add(const grisu_uint64 a, const grisu_uint64 b)
+{
+    const unsigned long low = (a.low + b.low) & GRISU_MASK_32;
 
-        case cJSON_Object:
-            return print_object(item, depth, format, output_buffer, hooks);
+    return grisu_make(a.high + b.high + ((low < a.low) ? 1 : 0), low);
+}
 
-        default:
-            return false;
-    }
+static grisu_uint64 grisu_subtract(const grisu_uint64 a, const grisu_uint64 b)
+{
+    return grisu_make(a.high - b.high - ((a.low < b.low) ? 1 : 0), a.low - b.low);
 }
 
-/* Build an array from input text. */
-static const unsigned char *parse_array(cJSON * const item, const unsigned char *input, const unsigned char ** const error_pointer, const internal_hooks * const hooks)
+static cJSON_bool grisu_less(const grisu_uint64 a, const grisu_uint64 b)
 {
-    cJSON *head = NULL; /* head of the linked list */
-    cJSON *current_item = NULL;
+    return (a.high < b.high) || ((a.high == b.high) && (a.low < b.low));
+}
 
-    if (*input != '[')
+static grisu_uint64 grisu_shift_left(const grisu_uint64 a, const int bits)
+{
+    if (bits == 0)
     {
-        /* not an array */
-        *error_pointer = input;
-        goto fail;
+        return a;
     }
-
-    input = skip_whitespace(input + 1);
-    if (*input == ']')
+    if (bits >= 32)
     {
-        /* empty array */
-        goto success;
+        return grisu_make(a.low << (bits - 32), 0);
     }
 
-    /* step back to character in front of the first element */
-    input--;
-    /* loop through the comma separated array elements */
-    do
-    {
-        /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(hooks);
-        if (new_item == NULL)
-        {
-            goto fail; /* allocation failure */
-        }
-
-        /* attach next item to list */
-        if (head == NULL)
-        {
-            /* start the linked list */
-            current_item = head = new_item;
-        }
-        else
-        {
-            /* add to the end and advance */
-            current_item->next = new_item;
-            new_item->prev = current_item;
-            current_item = new_item;
-        }
+    return grisu_make((a.high << bits) | (a.low >> (32 - bits)), a.low << bits);
+}
 
-        /* parse next value */
-        input = skip_whitespace(input + 1);
-        input = parse_value(current_item, input, error_pointer, hooks);
-        input = skip_whitespace(input);
-        if (input == NULL)
-        {
-            goto fail; /* failed to parse value */
-        }
+static grisu_uint64 grisu_shift_right(const grisu_uint64 a, const int bits)
+{
+    if (bits == 0)
+    {
+        return a;
     }
-    while (*input == ',');
-
-    if (*input != ']')
+    if (bits >= 32)
     {
-        *error_pointer = input;
-        goto fail; /* expected end of array */
+        return grisu_make(0, a.high >> (bits - 32));
     }
 
-success:
-    item->type = cJSON_Array;
-    item->child = head;
+    return grisu_make(a.high >> bits, (a.low >> bits) | (a.high << (32 - bits)));
+}
+
+/* the lowest bits (32 to 63) of a */
+static grisu_uint64 grisu_low_bits(const grisu_uint64 a, const int bits)
+{
+    return grisu_make(a.high & ((1UL << (bits - 32)) - 1), a.low);
+}
 
-    return input + 1;
+static grisu_uint64 grisu_times10(const grisu_uint64 a)
+{
+    return grisu_add(grisu_shift_left(a, 3), grisu_shift_left(a, 1));
+}
 
-fail:
-    if (head != NULL)
-    {
-        cJSON_Delete(head);
-    }
+/* the full 64 bit product of two 32 bit numbers */
+static grisu_uint64 grisu_multiply_32(const unsigned long a, const unsigned long b)
+{
+    const unsigned long low_low = (a & 0xFFFF) * (b & 0xFFFF);
+    const unsigned long low_high = (a & 0xFFFF) * (b >> 16);
+    const unsigned long high_low = (a >> 16) * (b & 0xFFFF);
+    const unsigned long middle = (low_low >> 16) + (low_high & 0xFFFF) + (high_low & 0xFFFF);
 
-    return NULL;
+    return grisu_make(((a >> 16) * (b >> 16)) + (low_high >> 16) + (high_low >> 16) + (middle >> 16), ((middle & 0xFFFF) << 16) | (low_low & 0xFFFF));
 }
 
-/* Render an array to text */
-static cJSON_bool print_array(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks)
+/* the upper 64 bits of the product, rounded */
+static grisu_fp grisu_multiply(const grisu_fp x, const grisu_fp y)
 {
-    unsigned char *output_pointer = NULL;
-    size_t length = 0;
-    cJSON *current_element = item->child;
+    const grisu_uint64 ac = grisu_multiply_32(x.f.high, y.f.high);
+    const grisu_uint64 bc = grisu_multiply_32(x.f.low, y.f.high);
+    const grisu_uint64 ad = grisu_multiply_32(x.f.high, y.f.low);
+    const grisu_uint64 bd = grisu_multiply_32(x.f.low, y.f.low);
+    grisu_uint64 middle = grisu_add(grisu_add(grisu_make(0, bd.high), grisu_make(0, ad.low)), grisu_make(0, bc.low));
+    grisu_fp result;
+
+    middle = grisu_add(middle, grisu_make(0, 0x80000000UL));
+    result.f = grisu_add(grisu_add(grisu_add(ac, grisu_make(0, ad.high)), grisu_make(0, bc.high)), grisu_make(0, middle.high));
+    result.e = x.e + y.e + 64;
+
+    return result;
+}
 
-    if (output_buffer == NULL)
-    {
-        return false;
-    }
+static grisu_fp grisu_normalize(grisu_fp x)
+{
+    unsigned long top = (x.f.high != 0) ? x.f.high : x.f.low;
+    int bits = (x.f.high != 0) ? 0 : 32;
 
-    /* Compose the output array. */
-    /* opening square bracket */
-    output_pointer = ensure(output_buffer, 1, hooks);
-    if (output_pointer == NULL)
+    while ((top & 0x80000000UL) == 0)
     {
-        return false;
+        top <<= 1;
+        bits++;
     }
+    x.f = grisu_shift_left(x.f, bits);
+    x.e -= bits;
+
+    return x;
+}
 
-    *output_pointer = '[';
-    output_buffer->offset++;
+/* Move the last digit towards w as long as that keeps it in the interval, then check that the digits are certain to
+ * be the closest ones. All distances are from too_high in units of 2^e, ten_kappa is the weight of the last digit. */
+static cJSON_bool grisu_round_weed(char * const digits, const int length, const grisu_uint64 distance_too_high_w, const grisu_uint64 unsafe_interval, grisu_uint64 rest, const grisu_uint64 ten_kappa, const grisu_uint64 unit)
+{
+    const grisu_uint64 small_distance = grisu_subtract(distance_too_high_w, unit);
+    const grisu_uint64 big_distance = grisu_add(distance_too_high_w, unit);
 
-    while (current_element != NULL)
+    while (grisu_less(rest, small_distance)
+            && !grisu_less(grisu_subtract(unsafe_interval, rest), ten_kappa)
+            && (grisu_less(grisu_add(rest, ten_kappa), small_distance)
+                || !grisu_less(grisu_subtract(small_distance, rest), grisu_subtract(grisu_add(rest, ten_kappa), small_distance))))
     {
-        if (!print_value(current_element, depth + 1, format, output_buffer, hooks))
-        {
-            return false;
-        }
-        update_offset(output_buffer);
-        if (current_element->next)
-        {
-            length = format ? 2 : 1;
-            output_pointer = ensure(output_buffer, length + 1, hooks);
-            if (output_pointer == NULL)
-            {
-                return false;
-            }
-            *output_pointer++ = ',';
-            if(format)
-            {
-                *output_pointer++ = ' ';
-            }
-            *output_pointer = '\0';
-            output_buffer->offset += length;
-        }
-        current_element = current_element->next;
+        digits[length - 1]--;
+        rest = grisu_add(rest, ten_kappa);
     }
 
-    output_pointer = ensure(output_buffer, 2, hooks);
-    if (output_pointer == NULL)
+    if (grisu_less(rest, big_distance)
+            && !grisu_less(grisu_subtract(unsafe_interval, rest), ten_kappa)
+            && (grisu_less(grisu_add(rest, ten_kappa), big_distance)
+                || grisu_less(grisu_subtract(grisu_add(rest, ten_kappa), big_distance), grisu_subtract(big_distance, rest))))
     {
         return false;
     }
-    *output_pointer++ = ']';
-    *output_pointer = '\0';
 
-    return true;
+    return !grisu_less(rest, grisu_shift_left(unit, 1)) && !grisu_less(grisu_subtract(unsafe_interval, grisu_shift_left(unit, 2)), rest);
 }
 
-/* Build an object from the text. */
-static const unsigned char *parse_object(cJSON * const item, const unsigned char *input, const unsigned char ** const error_pointer, const internal_hooks * const hooks)
+/* Generate the shortest digits of a number between low and high, w is the number itself.
+ * Returns the number of digits and the decimal exponent of the last one in kappa, or 0 if they aren't certain. */
+static int grisu_digits(const grisu_fp low, const grisu_fp w, const grisu_fp high, char * const digits, int * const kappa, const cJSON_bool safe)
 {
-    cJSON *head = NULL; /* linked list head */
-    cJSON *current_item = NULL;
+    /* All three are imprecise by less than one unit. Grisu3 widens the interval by that and checks the digits
+     * afterwards, Grisu2 narrows it so the digits are certain to be inside. */
+    grisu_uint64 unit = grisu_make(0, safe ? 0 : 1);
+    const grisu_uint64 too_low = safe ? grisu_add(low.f, grisu_make(0, 1)) : grisu_subtract(low.f, unit);
+    const grisu_uint64 too_high = safe ? grisu_subtract(high.f, grisu_make(0, 1)) : grisu_add(high.f, unit);
+    grisu_uint64 unsafe_interval = grisu_subtract(too_high, too_low);
+    grisu_uint64 distance_too_high_w = grisu_subtract(too_high, w.f);
+    /* w.e is between -60 and -32, so the integral part fits into 32 bits */
+    const int shift = -w.e;
+    const grisu_uint64 one = grisu_shift_left(grisu_make(0, 1), shift);
+    unsigned long integrals = grisu_shift_right(too_high, shift).low;
+    grisu_uint64 fractionals = grisu_low_bits(too_high, shift);
+    grisu_uint64 rest;
+    unsigned long divisor = 1;
+    int length = 0;
 
-    if (*input != '{')
+    *kappa = 0;
+    if (integrals > 0)
     {
-        *error_pointer = input;
-        goto fail; /* not an object */
+        *kappa = 1;
+        while ((*kappa < 10) && ((integrals / divisor) >= 10))
+        {
+            divisor *= 10;
+            (*kappa)++;
+        }
     }
 
-    input = skip_whitespace(input + 1);
-    if (*input == '}')
+    while (*kappa > 0)
     {
-        goto success; /* empty object */
+        digits[length++] = (char)('0' + (integrals / divisor));
+        integrals %= divisor;
+        (*kappa)--;
+        rest = grisu_add(grisu_shift_left(grisu_make(0, integrals), shift), fractionals);
+        if (grisu_less(rest, unsafe_interval))
+        {
+            return (grisu_round_weed(digits, length, distance_too_high_w, unsafe_interval, rest, grisu_shift_left(grisu_make(0, divisor), shift), unit) || safe) ? length : 0;
+        }
+        divisor /= 10;
     }
 
-    /* step back to character in front of the first element */
-    input--;
-    /* loop through the comma separated array elements */
-    do
+    for (;;)
     {
-        /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(hooks);
-        if (new_item == NULL)
+        fractionals = grisu_times10(fractionals);
+        unit = grisu_times10(unit);
+        unsafe_interval = grisu_times10(unsafe_interval);
+        distance_too_high_w = grisu_times10(distance_too_high_w);
+        digits[length++] = (char)('0' + grisu_shift_right(fractionals, shift).low);
+        fractionals = grisu_low_bits(fractionals, shift);
+        (*kappa)--;
+        if (grisu_less(fractionals, unsafe_interval))
         {
-            goto fail; /* allocation failure */
+            return (grisu_round_weed(digits, length, distance_too_high_w, unsafe_interval, fractionals, one, unit) || safe) ? length : 0;
         }
+    }
+}
 
-        /* attach next item to list */
-        if (head == NULL)
-        {
-            /* start the linked list */
-            current_item = head = new_item;
-        }
-        else
-        {
-            /* add to the end and advance */
-            current_item->next = new_item;
-            new_item->prev = current_item;
-            current_item = new_item;
-        }
+/* Find digits of the positive finite number d, its value is 0.digits * 10^point. Returns the number of digits.
+ * If safe is false, the digits are the shortest ones, but in rare cases Grisu3 can't be sure of them and returns 0.
+ * If safe is true, the digits always parse back to d, but they can be longer than needed (that is Grisu2). */
+static int grisu(const double d, char * const digits, int * const point, const cJSON_bool safe)
+{
+    unsigned char bytes[sizeof(double)];
+    unsigned long biased_exponent = 0;
+    double scaled = 0;
+    cJSON_bool lower_boundary_is_closer = false;
+    grisu_fp w;
+    grisu_fp boundary_minus;
+    grisu_fp boundary_plus;
+    grisu_fp ten_mk;
+    const grisu_power *power = NULL;
+    int k = 0;
+    int length = 0;
+    int kappa = 0;
+    size_t i = 0;
 
-        /* parse the name of the child */
-        input = skip_whitespace(input + 1);
-        input = parse_string(current_item, input, error_pointer, hooks);
-        input = skip_whitespace(input);
-        if (input == NULL)
-        {
-            goto fail; /* faile to parse name */
-        }
+    /* read the IEEE 754 bits in big endian order, frexp would need libm */
+    for (i = 0; i < sizeof(double); i++)
+    {
+        bytes[i] = ((const unsigned char*)&d)[is_little_endian() ? (sizeof(double) - 1 - i) : i];
+    }
+    biased_exponent = ((unsigned long)(bytes[0] & 0x7F) << 4) | ((unsigned long)bytes[1] >> 4);
+    w.f = grisu_make(((unsigned long)(bytes[1] & 0x0F) << 16) | ((unsigned long)bytes[2] << 8) | bytes[3],
+            ((unsigned long)bytes[4] << 24) | ((unsigned long)bytes[5] << 16) | ((unsigned long)bytes[6] << 8) | bytes[7]);
+    if (biased_exponent == 0)
+    {
+        /* subnormal numbers have fewer significant bits */
+        w.e = -1074;
+    }
+    else
+    {
+        /* add the hidden bit */
+        w.f.high |= 0x100000UL;
+        w.e = (int)biased_exponent - 1075;
+    }
+    /* the gap to the next lower number is only half as wide at a power of two */
+    lower_boundary_is_closer = (w.f.high == 0x100000UL) && (w.f.low == 0) && (biased_exponent > 1);
+
+    /* the boundaries are halfway to the neighbouring numbers */
+    boundary_plus.f = grisu_add(grisu_shift_left(w.f, 1), grisu_make(0, 1));
+    boundary_plus.e = w.e - 1;
+    boundary_plus = grisu_normalize(boundary_plus);
+    if (lower_boundary_is_closer)
+    {
+        boundary_minus.f = grisu_subtract(grisu_shift_left(w.f, 2), grisu_make(0, 1));
+        boundary_minus.e = w.e - 2;
+    }
+    else
+    {
+        boundary_minus.f = grisu_subtract(grisu_shift_left(w.f, 1), grisu_make(0, 1));
+        boundary_minus.e = w.e - 1;
+    }
+    boundary_minus.f = grisu_shift_left(boundary_minus.f, boundary_minus.e - boundary_plus.e);
+    boundary_minus.e = boundary_plus.e;
+    w = grisu_normalize(w);
+
+    /* a cached power of ten that scales the exponent into -60 to -32, k = ceil((-60 - (w.e + 64) + 63) * log10(2)) */
+    scaled = (double)(-61 - w.e) * 0.30102999566398114;
+    k = (int)scaled;
+    if ((double)k < scaled)
+    {
+        k++;
+    }
+    power = &grisu_powers[(GRISU_POWER_OFFSET + k - 1) / GRISU_POWER_DISTANCE + 1];
+    ten_mk.f = grisu_make(power->high, power->low);
+    ten_mk.e = power->binary_exponent;
 
-        /* swap valuestring and string, because we parsed the name */
-        current_item->string = current_item->valuestring;
-        current_item->valuestring = NULL;
+    length = grisu_digits(grisu_multiply(boundary_minus, ten_mk), grisu_multiply(w, ten_mk), grisu_multiply(boundary_plus, ten_mk), digits, &kappa, safe);
+    *point = length + kappa - power->decimal_exponent;
+
+    return length;
+}
+
+#ifndef CJSON_INTEGER_ONLY
+/* Find the shortest digits of the positive finite number d with printf, its value is 0.digits * 10^point.
+ * 15 significant digits always round trip for normal numbers, subnormal numbers can need fewer. */
+static int printf_digits(const double d, char * const digits, int * const point)
+{
+    char printed[NUMBER_BUFFER_SIZE];
+    const char *pointer = printed;
+    int precision = 0;
+    int digit_count = 0;
+    double test = 0;
 
-        if (*input != ':')
+    for (precision = (d < DBL_MIN) ? 0 : 14; precision < 16; precision++)
+    {
+        sprintf(printed, "%.*e", precision, d);
+        if ((sscanf(printed, "%lg", &test) == 1) && (test == d))
         {
-            *error_pointer = input;
-            goto fail; /* invalid object */
+            break;
         }
+    }
+    if (precision == 16)
+    {
+        sprintf(printed, "%.16e", d);
+    }
 
-        /* parse the value */
-        input = skip_whitespace(input + 1);
-        input = parse_value(current_item, input, error_pointer, hooks);
-        input = skip_whitespace(input);
-        if (input == NULL)
+    /* collect the significant digits, the decimal point in between depends on the locale */
+    for (; (*pointer != 'e') && (*pointer != '\0'); pointer++)
+    {
+        if ((*pointer >= '0') && (*pointer <= '9'))
         {
-            goto fail; /* failed to parse value */
+            digits[digit_count++] = *pointer;
         }
     }
-    while (*input == ',');
-
-    if (*input != '}')
+    if (*pointer != 'e')
+    {
+        return 0;
+    }
+    while ((digit_count > 1) && (digits[digit_count - 1] == '0'))
     {
-        *error_pointer = input;
-        goto fail; /* expected end of object */
+        digit_count--;
     }
+    *point = atoi(pointer + 1) + 1;
 
-success:
-    item->type = cJSON_Object;
-    item->child = head;
+    return digit_count;
+}
 
-    return input + 1;
+/* Find the shortest digits that parse back to the positive finite number d, if there are several the closest ones.
+ * Its value is 0.digits * 10^point. Returns the number of digits (at most 17) or 0 on failure. */
+static int shortest_digits(const double d, char * const digits, int * const point)
+{
+    const int digit_count = grisu(d, digits, point, false);
+    if (digit_count > 0)
+    {
+        return digit_count;
+    }
 
-fail:
-    if (head != NULL)
+    return printf_digits(d, digits, point);
+}
+#else
+/* Find the shortest digits that parse back to the positive finite number d, its value is 0.digits * 10^point.
+ * Without printf, the rare numbers Grisu3 gives up on get digits that round trip, but can be longer than needed. */
+static int shortest_digits(const double d, char * const digits, int * const point)
+{
+    const int digit_count = grisu(d, digits, point, false);
+    if (digit_count > 0)
     {
-        cJSON_Delete(head);
+        return digit_count;
     }
 
-    return NULL;
+    return grisu(d, digits, point, true);
 }
+#endif
 
-/* Render an object to text. */
-static cJSON_bool print_object(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks)
+/* Render a number into number_buffer (NUMBER_BUFFER_SIZE bytes) like %g with as many significant digits as it
+ * takes to round trip, but at least 15. Returns the length of the text or 0 on failure. */
+static size_t render_number(const double d, unsigned char * const number_buffer)
 {
-    unsigned char *output_pointer = NULL;
-    size_t length = 0;
-    cJSON *current_item = item->child;
+    const double negative_zero = -0.0;
+    char digits[NUMBER_BUFFER_SIZE];
+    unsigned char *output = number_buffer;
+    int digit_count = 0;
+    int point = 0; /* position of the decimal point relative to the first digit */
+    int exponent = 0;
+    int i = 0;
+
+    /* integers are the common case, they don't need the digit search */
+    if ((d != 0) && (d >= INT_MIN) && (d <= INT_MAX) && ((double)(int)d == d))
+    {
+        return print_integer(number_buffer, (int)d);
+    }
 
-    if (output_buffer == NULL)
+    /* This checks for NaN and Infinity */
+    if ((d * 0) != 0)
     {
-        return false;
+        memcpy(number_buffer, "null", sizeof("null"));
+        return sizeof("null") - 1;
     }
 
-    /* Compose the output: */
-    length = format ? 2 : 1; /* fmt: {\n */
-    output_pointer = ensure(output_buffer, length + 1, hooks);
-    if (output_pointer == NULL)
+    if (d == 0)
     {
-        return false;
+        /* -0 keeps its sign */
+        if (memcmp(&d, &negative_zero, sizeof(d)) == 0)
+        {
+            *output++ = '-';
+        }
+        *output++ = '0';
+        *output = '\0';
+        return (size_t)(output - number_buffer);
     }
 
-    *output_pointer++ = '{';
-    if (format)
+    if (d < 0)
     {
-        *output_pointer++ = '\n';
+        *output++ = '-';
+    }
+    digit_count = shortest_digits((d < 0) ? -d : d, digits, &point);
+    if (digit_count == 0)
+    {
+        return 0;
     }
-    output_buffer->offset += length;
 
-    while (current_item)
+    exponent = point - 1;
+    if ((exponent < -4) || (exponent >= ((digit_count > 15) ? digit_count : 15)))
     {
-        if (format)
+        *output++ = (unsigned char)digits[0];
+        if (digit_count > 1)
         {
-            size_t i;
-            output_pointer = ensure(output_buffer, depth + 1, hooks);
-            if (output_pointer == NULL)
-            {
-                return false;
-            }
-            for (i = 0; i < depth + 1; i++)
-            {
-                *output_pointer++ = '\t';
-            }
-            output_buffer->offset += depth + 1;
+            *output++ = '.';
+            memcpy(output, digits + 1, (size_t)(digit_count - 1));
+            output += digit_count - 1;
         }
-
-        /* print key */
-        if (!print_string_ptr((unsigned char*)current_item->string, output_buffer, hooks))
+        /* the exponent has a sign and at least two digits */
+        *output++ = 'e';
+        *output++ = (exponent < 0) ? '-' : '+';
+        if ((exponent > -10) && (exponent < 10))
         {
-            return false;
+            *output++ = '0';
         }
-        update_offset(output_buffer);
-
-        length = format ? 2 : 1;
-        output_pointer = ensure(output_buffer, length, hooks);
-        if (output_pointer == NULL)
+        output += print_integer(output, (exponent < 0) ? -exponent : exponent);
+    }
+    else if (point <= 0)
+    {
+        *output++ = '0';
+        *output++ = '.';
+        for (i = point; i < 0; i++)
         {
-            return false;
+            *output++ = '0';
         }
-        *output_pointer++ = ':';
-        if (format)
+        memcpy(output, digits, (size_t)digit_count);
+        output += digit_count;
+    }
+    else if (point >= digit_count)
+    {
+        /* integer, padded with zeroes */
+        memcpy(output, digits, (size_t)digit_count);
+        output += digit_count;
+        for (i = digit_count; i < point; i++)
         {
-            *output_pointer++ = '\t';
+            *output++ = '0';
         }
-        output_buffer->offset += length;
+    }
+    else
+    {
+        memcpy(output, digits, (size_t)point);
+        output += point;
+        *output++ = '.';
+        memcpy(output, digits + point, (size_t)(digit_count - point));
+        output += digit_count - point;
+    }
+    *output = '\0';
 
-        /* print value */
-        if (!print_value(current_item, depth + 1, format, output_buffer, hooks))
-        {
-            return false;
-        }
-        update_offset(output_buffer);
+    return (size_t)(output - number_buffer);
+}
 
-        /* print comma if not last */
-        length = (size_t) (format ? 1 : 0) + (current_item->next ? 1 : 0);
-        output_pointer = ensure(output_buffer, length + 1, hooks);
-        if (output_pointer == NULL)
-        {
-            return false;
-        }
-        if (current_item->next)
-        {
-            *output_pointer++ = ',';
-        }
+/* Render a number like ECMAScript's Number.prototype.toString, as RFC 8785 requires.
+ * Returns the length of the text or 0 for NaN and Infinity, which have no canonical form. */
+static size_t render_canonical_number(const double d, unsigned char * const number_buffer)
+{
+    char digits[NUMBER_BUFFER_SIZE];
+    unsigned char *output = number_buffer;
+    int digit_count = 0;
+    int point = 0; /* position of the decimal point relative to the first digit */
+    int i = 0;
 
-        if (format)
-        {
-            *output_pointer++ = '\n';
-        }
-        *output_pointer = '\0';
-        output_buffer->offset += length;
+    if ((d * 0) != 0)
+    {
+        return 0;
+    }
 
-        current_item = current_item->next;
+    /* the integer fast path is canonical as well, zero is printed without a sign */
+    if ((d == 0) || ((d >= INT_MIN) && (d <= INT_MAX) && ((double)(int)d == d)))
+    {
+        return print_integer(number_buffer, (int)d);
     }
 
-    output_pointer = ensure(output_buffer, format ? (depth + 2) : 2, hooks);
-    if (output_pointer == NULL)
+    if (d < 0)
     {
-        return false;
+        *output++ = '-';
     }
-    if (format)
+    digit_count = shortest_digits((d < 0) ? -d : d, digits, &point);
+    if (digit_count == 0)
     {
-        size_t i;
-        for (i = 0; i < (depth); i++)
+        return 0;
+    }
+
+    if ((point >= digit_count) && (point <= 21))
+    {
+        /* integer, padded with zeroes */
+        memcpy(output, digits, (size_t)digit_count);
+        output += digit_count;
+        for (i = digit_count; i < point; i++)
         {
-            *output_pointer++ = '\t';
+            *output++ = '0';
         }
     }
-    *output_pointer++ = '}';
-    *output_pointer = '\0';
-
-    return true;
-}
-
-/* Get Array size/item / object item. */
-CJSON_PUBLIC(int) cJSON_GetArraySize(const cJSON *array)
-{
-    cJSON *c = array->child;
-    size_t i = 0;
-    while(c)
+    else if ((point > 0) && (point <= 21))
     {
-        i++;
-        c = c->next;
+        memcpy(output, digits, (size_t)point);
+        output += point;
+        *output++ = '.';
+        memcpy(output, digits + point, (size_t)(digit_count - point));
+        output += digit_count - point;
     }
-
-    /* FIXME: Can overflow here. Cannot be fixed without breaking the API */
-
-    return (int)i;
-}
-
-CJSON_PUBLIC(cJSON *) cJSON_GetArrayItem(const cJSON *array, int item)
-{
-    cJSON *c = array ? array->child : NULL;
-    while (c && item > 0)
+    else if ((point > -6) && (point <= 0))
     {
-        item--;
-        c = c->next;
+        *output++ = '0';
+        *output++ = '.';
+        for (i = point; i < 0; i++)
+        {
+            *output++ = '0';
+        }
+        memcpy(output, digits, (size_t)digit_count);
+        output += digit_count;
+    }
+    else
+    {
+        /* exponential notation, the exponent always has a sign */
+        *output++ = (unsigned char)digits[0];
+        if (digit_count > 1)
+        {
+            *output++ = '.';
+            memcpy(output, digits + 1, (size_t)(digit_count - 1));
+            output += digit_count - 1;
+        }
+        *output++ = 'e';
+        *output++ = (point > 0) ? '+' : '-';
+        output += print_integer(output, (point > 0) ? (point - 1) : (1 - point));
     }
+    *output = '\0';
 
-    return c;
+    return (size_t)(output - number_buffer);
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_GetObjectItem(const cJSON *object, const char *string)
+/* Render the number nicely into a string. */
+static cJSON_bool print_double(const double number, printbuffer * const output_buffer, const internal_hooks * const hooks)
 {
-    cJSON *c = object ? object->child : NULL;
-    while (c && cJSON_strcasecmp((unsigned char*)c->string, (const unsigned char*)string))
+    unsigned char *output_pointer = NULL;
+    unsigned char number_buffer[NUMBER_BUFFER_SIZE]; /* temporary buffer to print the number into */
+    size_t length = 0;
+
+    if (output_buffer == NULL)
     {
-        c = c->next;
+        return false;
     }
-    return c;
-}
-
-CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemCaseSensitive(const cJSON * const object, const char * const string)
-{
-    cJSON *current_element = NULL;
 
-    if ((object == NULL) || (string == NULL))
+    if (output_buffer->canonical)
     {
-        return NULL;
+        length = render_canonical_number(number, number_buffer);
+    }
+    else
+    {
+        length = render_number(number, number_buffer);
+    }
+    if (length == 0)
+    {
+        return false;
     }
 
-    current_element = object->child;
-    while ((current_element != NULL) && (strcmp(string, current_element->string) != 0))
+    /* reserve appropriate space in the output */
+    output_pointer = ensure(output_buffer, length + 1, hooks);
+    if (output_pointer == NULL)
     {
-        current_element = current_element->next;
+        return false;
     }
+    memcpy(output_pointer, number_buffer, length + 1);
+    output_buffer->offset += length;
 
-    return current_element;
+    return true;
 }
 
-CJSON_PUBLIC(cJSON_bool) cJSON_HasObjectItem(const cJSON *object, const char *string)
+/* the value of every hexadecimal digit, 16 for anything else */
+static const unsigned char hex_digit_values[256] =
 {
-    return cJSON_GetObjectItem(object, string) ? 1 : 0;
-}
-
-/* Utility for array list handling. */
-static void suffix_object(cJSON *prev, cJSON *item)
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 16, 16, 16, 16, 16, 16,
+    16, 10, 11, 12, 13, 14, 15, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 10, 11, 12, 13, 14, 15, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16
+};
+
+/* parse 4 digit hexadecimal number, returns 0 if one of them isn't a digit */
+static unsigned parse_hex4(const unsigned char * const input)
 {
-    prev->next = item;
-    item->prev = prev;
-}
+    const unsigned int digit0 = hex_digit_values[input[0]];
+    const unsigned int digit1 = hex_digit_values[input[1]];
+    const unsigned int digit2 = hex_digit_values[input[2]];
+    const unsigned int digit3 = hex_digit_values[input[3]];
 
-/* Utility for handling references. */
-static cJSON *create_reference(const cJSON *item, const internal_hooks * const hooks)
-{
-    cJSON *ref = cJSON_New_Item(hooks);
-    if (!ref)
+    /* only an invalid digit has bit 4 set, so one test covers all four */
+    if (((digit0 | digit1 | digit2 | digit3) & 0x10) != 0)
     {
-        return NULL;
+        return 0;
     }
-    memcpy(ref, item, sizeof(cJSON));
-    ref->string = NULL;
-    ref->type |= cJSON_IsReference;
-    ref->next = ref->prev = NULL;
-    return ref;
+
+    return (digit0 << 12) | (digit1 << 8) | (digit2 << 4) | digit3;
 }
 
-/* Add item to array/object. */
-CJSON_PUBLIC(void) cJSON_AddItemToArray(cJSON *array, cJSON *item)
+typedef struct
 {
-    cJSON *child = NULL;
+    const internal_hooks *hooks;
+    /* where and why parsing failed */
+    const unsigned char *error_position;
+    int error_code;
+    /* one past the last byte of the input, the parser never reads beyond it */
+    const unsigned char *end;
+    /* the item that was allocated last, parse_string may store a short string in its room (see CJSON_INLINE_STRINGS) */
+    cJSON *inline_item;
+} parse_context;
+
+/* get the character at pointer, reading past the end of the input yields '\0' */
+#define char_at(context, pointer) (((pointer) < (context)->end) ? *(pointer) : (unsigned char)'\0')
+/* check if length bytes can be read, starting at pointer */
+#define can_read(context, pointer, length) ((size_t)((context)->end - (pointer)) >= (length))
+
+/* record a parse error, always returns NULL */
+static const unsigned char *parse_error(parse_context * const context, const unsigned char * const position, const int code)
+{
+    CJSON_TRACE(error, code, position);
+    context->error_position = position;
+    context->error_code = code;
 
-    if ((item == NULL) || (array == NULL))
-    {
-        return;
-    }
+    return NULL;
+}
 
-    child = array->child;
+#ifdef CJSON_INTEGER_ONLY
+/* The double nearest to the positive number x, built from its IEEE 754 bits because ldexp would need libm. */
+static double grisu_to_double(grisu_fp x)
+{
+    unsigned char bytes[sizeof(double)];
+    grisu_uint64 bits = grisu_make(0, 0);
+    grisu_uint64 mantissa;
+    grisu_uint64 rest;
+    double number = 0;
+    int exponent = 0;
+    int shift = 11; /* x.f has 64 significant bits, a double keeps 53 of them */
+    size_t i = 0;
 
-    if (child == NULL)
+    x = grisu_normalize(x);
+    exponent = x.e + 63 + 1023;
+    if (exponent >= 2047)
     {
-        /* list is empty, start new one */
-        array->child = item;
+        /* too large, that is infinity */
+        bits = grisu_make(0x7FF00000UL, 0);
     }
     else
     {
-        /* append to the end */
-        while (child->next)
+        if (exponent < 1)
         {
-            child = child->next;
+            /* subnormal numbers have fewer significant bits */
+            shift += 1 - exponent;
+            exponent = 1;
+        }
+        if (shift < 64)
+        {
+            /* round to nearest, ties to even. A carry out of the mantissa increments the exponent as it should */
+            mantissa = grisu_shift_right(x.f, shift);
+            rest = grisu_shift_left(x.f, 64 - shift);
+            if ((rest.high & 0x80000000UL) && ((mantissa.low & 1) || (rest.high & 0x7FFFFFFFUL) || rest.low))
+            {
+                mantissa = grisu_add(mantissa, grisu_make(0, 1));
+            }
+            bits = grisu_add(grisu_make((unsigned long)(exponent - 1) << 20, 0), mantissa);
+        }
+        else if ((shift == 64) && ((x.f.high != 0x80000000UL) || (x.f.low != 0)))
+        {
+            /* more than half of the smallest subnormal number */
+            bits = grisu_make(0, 1);
         }
-        suffix_object(child, item);
     }
-}
-
-CJSON_PUBLIC(void) cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item)
-{
-    /* call cJSON_AddItemToObjectCS for code reuse */
-    cJSON_AddItemToObjectCS(object, (char*)cJSON_strdup((const unsigned char*)string, &global_hooks), item);
-    /* remove cJSON_StringIsConst flag */
-    item->type &= ~cJSON_StringIsConst;
-}
 
-/* Add an item to an object with constant string as key */
-CJSON_PUBLIC(void) cJSON_AddItemToObjectCS(cJSON *object, const char *string, cJSON *item)
-{
-    if (!item)
-    {
-        return;
-    }
-    if (!(item->type & cJSON_StringIsConst) && item->string)
+    for (i = 0; i < sizeof(double); i++)
     {
-        global_hooks.deallocate(item->string);
+        const unsigned long word = (i < 4) ? bits.high : bits.low;
+        bytes[is_little_endian() ? (sizeof(double) - 1 - i) : i] = (unsigned char)((word >> (8 * (3 - (i % 4)))) & 0xFF);
     }
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wcast-qual"
-    item->string = (char*)string;
-#pragma GCC diagnostic pop
-    item->type |= cJSON_StringIsConst;
-    cJSON_AddItemToArray(object, item);
-}
-
-CJSON_PUBLIC(void) cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item)
-{
-    cJSON_AddItemToArray(array, create_reference(item, &global_hooks));
-}
+    memcpy(&number, bytes, sizeof(number));
 
-CJSON_PUBLIC(void) cJSON_AddItemReferenceToObject(cJSON *object, const char *string, cJSON *item)
-{
-    cJSON_AddItemToObject(object, string, create_reference(item, &global_hooks));
+    return number;
 }
 
-static cJSON *DetachItemFromArray(cJSON *array, size_t which)
+/* Convert a number without strtod. Up to 19 significant digits are scaled by a cached power of ten with 64 bits of
+ * precision and rounded once, which gives the nearest double unless the number is very close to halfway between two. */
+static const unsigned char *parse_number_slow(double * const number, const unsigned char * const input, parse_context * const context)
 {
-    cJSON *c = array->child;
-    while (c && (which > 0))
+    const unsigned char *pointer = input;
+    const unsigned char *digits_start = NULL;
+    grisu_fp scaled;
+    grisu_fp power;
+    const grisu_power *cached = NULL;
+    unsigned long remainder_power = 1;
+    size_t digits = 0;
+    long exponent = 0;
+    long explicit_exponent = 0;
+    long remainder = 0;
+    cJSON_bool negative = false;
+    cJSON_bool negative_exponent = false;
+
+    scaled.f = grisu_make(0, 0);
+    scaled.e = 0;
+
+    if (char_at(context, pointer) == '-')
     {
-        c = c->next;
-        which--;
+        negative = true;
+        pointer++;
     }
-    if (!c)
+
+    /* integer part, the digits after the first 19 only count for the exponent */
+    digits_start = pointer;
+    while ((char_at(context, pointer) >= '0') && (char_at(context, pointer) <= '9'))
+    {
+        if ((digits > 0) || (*pointer != '0'))
+        {
+            if (digits < 19)
+            {
+                scaled.f = grisu_add(grisu_times10(scaled.f), grisu_make(0, (unsigned long)(*pointer - '0')));
+            }
+            else
+            {
+                exponent++;
+            }
+            digits++;
+        }
+        pointer++;
+    }
+    if (pointer == digits_start)
     {
-        /* item doesn't exist */
         return NULL;
     }
-    if (c->prev)
+
+    /* fraction, the digits after the first 19 are dropped */
+    if (char_at(context, pointer) == '.')
     {
-        /* not the first element */
-        c->prev->next = c->next;
+        pointer++;
+        digits_start = pointer;
+        while ((char_at(context, pointer) >= '0') && (char_at(context, pointer) <= '9'))
+        {
+            if (((digits > 0) || (*pointer != '0')) && (digits >= 19))
+            {
+                pointer++;
+                continue;
+            }
+            if ((digits > 0) || (*pointer != '0'))
+            {
+                scaled.f = grisu_add(grisu_times10(scaled.f), grisu_make(0, (unsigned long)(*pointer - '0')));
+                digits++;
+            }
+            exponent--;
+            pointer++;
+        }
+        if (pointer == digits_start)
+        {
+            return NULL;
+        }
     }
-    if (c->next)
+
+    /* exponent */
+    if ((char_at(context, pointer) == 'e') || (char_at(context, pointer) == 'E'))
     {
-        c->next->prev = c->prev;
+        pointer++;
+        if ((char_at(context, pointer) == '+') || (char_at(context, pointer) == '-'))
+        {
+            negative_exponent = (*pointer == '-');
+            pointer++;
+        }
+        digits_start = pointer;
+        while ((char_at(context, pointer) >= '0') && (char_at(context, pointer) <= '9'))
+        {
+            /* anything this large is infinity or zero anyway */
+            if (explicit_exponent < 10000)
+            {
+                explicit_exponent = (explicit_exponent * 10) + (*pointer - '0');
+            }
+            pointer++;
+        }
+        if (pointer == digits_start)
+        {
+            return NULL;
+        }
+        exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
     }
-    if (c==array->child)
+
+    if (digits == 0)
     {
-        array->child = c->next;
+        *number = 0;
+    }
+    else if (exponent == 0)
+    {
+        /* the significand is the exact value */
+        *number = grisu_to_double(scaled);
+    }
+    else if (exponent < -GRISU_POWER_OFFSET)
+    {
+        /* below 10^19 * 10^-349, less than half of the smallest subnormal number */
+        *number = 0;
+    }
+    else if (((exponent + GRISU_POWER_OFFSET) / GRISU_POWER_DISTANCE) >= (long)(sizeof(grisu_powers) / sizeof(grisu_powers[0])))
+    {
+        /* above 10^348, infinity */
+        scaled.e = 2048;
+        *number = grisu_to_double(scaled);
+    }
+    else
+    {
+        /* the cached power just below, times the rest that is exact in 32 bits */
+        cached = &grisu_powers[(exponent + GRISU_POWER_OFFSET) / GRISU_POWER_DISTANCE];
+        for (remainder = exponent - cached->decimal_exponent; remainder > 0; remainder--)
+        {
+            remainder_power *= 10;
+        }
+        power.f = grisu_make(0, remainder_power);
+        power.e = 0;
+        scaled = grisu_multiply(grisu_normalize(scaled), grisu_normalize(power));
+        power.f = grisu_make(cached->high, cached->low);
+        power.e = cached->binary_exponent;
+        *number = grisu_to_double(grisu_multiply(grisu_normalize(scaled), power));
+    }
+    if (negative)
+    {
+        *number = -*number;
     }
-    /* make sure the detached item doesn't point anywhere anymore */
-    c->prev = c->next = NULL;
 
-    return c;
+    return pointer;
 }
-CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromArray(cJSON *array, int which)
+#else
+/* Convert a number with strtod. This is the fallback for everything the fast path can't convert exactly. */
+static const unsigned char *parse_number_slow(double * const number, const unsigned char * const input, parse_context * const context)
 {
-    if (which < 0)
+    unsigned char *after_end = NULL;
+    unsigned char number_c_string[64];
+    unsigned char *number_string = number_c_string;
+    unsigned char decimal_point = get_decimal_point();
+    size_t length = 0;
+    size_t i = 0;
+
+    /* find the characters that can be part of the number */
+    while (can_read(context, input, length + 1))
     {
-        return NULL;
+        switch (input[length])
+        {
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+            case '+':
+            case '-':
+            case 'e':
+            case 'E':
+            case '.':
+                length++;
+                continue;
+
+            default:
+                break;
+        }
+        break;
     }
 
-    return DetachItemFromArray(array, (size_t)which);
-}
-
-CJSON_PUBLIC(void) cJSON_DeleteItemFromArray(cJSON *array, int which)
-{
-    cJSON_Delete(cJSON_DetachItemFromArray(array, which));
-}
+    /* strtod needs a null terminated copy, the input doesn't have to end after the number */
+    if (length >= sizeof(number_c_string))
+    {
+        stats_allocation(context->hooks, length + 1);
+        number_string = (unsigned char*)context->hooks->allocate(length + 1);
+        if (number_string == NULL)
+        {
+            return NULL;
+        }
+    }
+    /* JSON always uses '.', strtod expects the decimal point of the current locale */
+    for (i = 0; i < length; i++)
+    {
+        number_string[i] = (input[i] == '.') ? decimal_point : input[i];
+    }
+    number_string[length] = '\0';
 
-CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromObject(cJSON *object, const char *string)
-{
-    size_t i = 0;
-    cJSON *c = object->child;
-    while (c && cJSON_strcasecmp((unsigned char*)c->string, (const unsigned char*)string))
+    *number = strtod((const char*)number_string, (char**)&after_end);
+    length = (size_t)(after_end - number_string);
+    if (number_string != number_c_string)
     {
-        i++;
-        c = c->next;
+        context->hooks->deallocate(number_string);
     }
-    if (c)
+    if (length == 0)
     {
-        return DetachItemFromArray(object, i);
+        return NULL; /* parse_error */
     }
 
-    return NULL;
+    return input + length;
 }
+#endif
 
-CJSON_PUBLIC(void) cJSON_DeleteItemFromObject(cJSON *object, const char *string)
-{
-    cJSON_Delete(cJSON_DetachItemFromObject(object, string));
-}
+/* with excess precision (e.g. x87), multiplying or dividing by a power of ten would round twice */
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD != 0)
+#define CJSON_EXACT_DOUBLE_ARITHMETIC 0
+#else
+#define CJSON_EXACT_DOUBLE_ARITHMETIC 1
+#endif
 
-/* Replace array/object items with new ones. */
-CJSON_PUBLIC(void) cJSON_InsertItemInArray(cJSON *array, int which, cJSON *newitem)
+/* doubles can represent every integer with up to 15 decimal digits and the powers of ten up to 1e22 exactly */
+#define FAST_PATH_MAX_DIGITS 15
+#define FAST_PATH_MAX_EXPONENT 22
+static const double powers_of_ten[FAST_PATH_MAX_EXPONENT + 1] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Convert numbers of the form -?[0-9]+(\.[0-9]+)?([eE][+-]?[0-9]+)? whose significand fits into a double exactly.
+ * In that case, a single multiplication or division by an exact power of ten is correctly rounded (Clinger's fast path).
+ * Returns NULL if the number has to be converted by parse_number_slow. */
+static const unsigned char *parse_number_fast(double * const number, const unsigned char *input, const parse_context * const context)
 {
-    cJSON *c = array->child;
-    while (c && (which > 0))
+    double significand = 0;
+    size_t digits = 0;
+    long exponent = 0;
+    long explicit_exponent = 0;
+    cJSON_bool negative = false;
+    cJSON_bool negative_exponent = false;
+    const unsigned char *digits_start = NULL;
+
+    if (char_at(context, input) == '-')
     {
-        c = c->next;
-        which--;
+        negative = true;
+        input++;
     }
-    if (!c)
+
+    /* integer part */
+    digits_start = input;
+    while ((char_at(context, input) >= '0') && (char_at(context, input) <= '9'))
     {
-        cJSON_AddItemToArray(array, newitem);
-        return;
+        /* leading zeroes are not significant */
+        if ((digits > 0) || (*input != '0'))
+        {
+            significand = (significand * 10) + (double)(*input - '0');
+            digits++;
+        }
+        input++;
     }
-    newitem->next = c;
-    newitem->prev = c->prev;
-    c->prev = newitem;
-    if (c == array->child)
+    if (input == digits_start)
     {
-        array->child = newitem;
+        return NULL;
     }
-    else
+
+    /* fraction */
+    if (char_at(context, input) == '.')
     {
-        newitem->prev->next = newitem;
+        input++;
+        digits_start = input;
+        while ((char_at(context, input) >= '0') && (char_at(context, input) <= '9'))
+        {
+            if ((digits > 0) || (*input != '0'))
+            {
+                significand = (significand * 10) + (double)(*input - '0');
+                digits++;
+            }
+            exponent--;
+            input++;
+        }
+        if (input == digits_start)
+        {
+            return NULL;
+        }
     }
-}
 
-static void ReplaceItemInArray(cJSON *array, size_t which, cJSON *newitem)
-{
-    cJSON *c = array->child;
-    while (c && (which > 0))
+    if (digits > FAST_PATH_MAX_DIGITS)
     {
-        c = c->next;
-        which--;
+        return NULL;
     }
-    if (!c)
+
+    /* exponent */
+    if ((char_at(context, input) == 'e') || (char_at(context, input) == 'E'))
     {
-        return;
+        input++;
+        if ((char_at(context, input) == '+') || (char_at(context, input) == '-'))
+        {
+            negative_exponent = (*input == '-');
+            input++;
+        }
+        digits_start = input;
+        while ((char_at(context, input) >= '0') && (char_at(context, input) <= '9'))
+        {
+            /* anything this large is out of range for the fast path anyway */
+            if (explicit_exponent < 10000)
+            {
+                explicit_exponent = (explicit_exponent * 10) + (*input - '0');
+            }
+            input++;
+        }
+        if (input == digits_start)
+        {
+            return NULL;
+        }
+        exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
     }
-    newitem->next = c->next;
-    newitem->prev = c->prev;
-    if (newitem->next)
+
+    if (significand == 0)
     {
-        newitem->next->prev = newitem;
+        /* zero stays zero, no matter the exponent */
     }
-    if (c == array->child)
+    else if (exponent == 0)
     {
-        array->child = newitem;
+        /* the significand is the exact value */
     }
-    else
+#if CJSON_EXACT_DOUBLE_ARITHMETIC
+    else if ((exponent > 0) && (exponent <= FAST_PATH_MAX_EXPONENT))
     {
-        newitem->prev->next = newitem;
+        significand *= powers_of_ten[exponent];
     }
-    c->next = c->prev = NULL;
-    cJSON_Delete(c);
-}
-CJSON_PUBLIC(void) cJSON_ReplaceItemInArray(cJSON *array, int which, cJSON *newitem)
-{
-    if (which < 0)
+    else if ((exponent < 0) && (exponent >= -FAST_PATH_MAX_EXPONENT))
     {
-        return;
+        significand /= powers_of_ten[-exponent];
+    }
+#endif
+    else
+    {
+        return NULL;
     }
 
-    ReplaceItemInArray(array, (size_t)which, newitem);
+    *number = negative ? -significand : significand;
+
+    return input;
 }
 
-CJSON_PUBLIC(void) cJSON_ReplaceItemInObject(cJSON *object, const char *string, cJSON *newitem)
+/* Parse the input text to generate a number, and populate the result into item. */
+/* Set the value of a number item, valueint saturates in case of overflow. */
+static void store_number(cJSON * const item, const double number)
 {
-    size_t i = 0;
-    cJSON *c = object->child;
-    while(c && cJSON_strcasecmp((unsigned char*)c->string, (const unsigned char*)string))
+    item->valuedouble = number;
+
+    if (number >= INT_MAX)
     {
-        i++;
-        c = c->next;
+        item->valueint = INT_MAX;
     }
-    if(c)
+    else if (number <= INT_MIN)
     {
-        /* free the old string if not const */
-        if (!(newitem->type & cJSON_StringIsConst) && newitem->string)
-        {
-             global_hooks.deallocate(newitem->string);
-        }
-
-        newitem->string = (char*)cJSON_strdup((const unsigned char*)string, &global_hooks);
-        ReplaceItemInArray(object, i, newitem);
+        item->valueint = INT_MIN;
     }
-}
-
-/* Create basic types: */
-CJSON_PUBLIC(cJSON *) cJSON_CreateNull(void)
-{
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    else if (number == number)
     {
-        item->type = cJSON_NULL;
+        item->valueint = (int)number;
     }
-
-    return item;
-}
-
-CJSON_PUBLIC(cJSON *) cJSON_CreateTrue(void)
-{
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    else
     {
-        item->type = cJSON_True;
+        /* NaN, which the binary formats can carry, has no integer value */
+        item->valueint = 0;
     }
-
-    return item;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateFalse(void)
+static const unsigned char *parse_number(cJSON * const item, const unsigned char * const input, parse_context * const context)
 {
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    double number = 0;
+    const unsigned char *end = NULL;
+
+    if (input == NULL)
     {
-        item->type = cJSON_False;
+        return NULL;
     }
 
-    return item;
-}
-
-CJSON_PUBLIC(cJSON *) cJSON_CreateBool(cJSON_bool b)
-{
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    end = parse_number_fast(&number, input, context);
+    if (end == NULL)
     {
-        item->type = b ? cJSON_True : cJSON_False;
+        end = parse_number_slow(&number, input, context);
+        if (end == NULL)
+        {
+            return NULL; /* parse_error */
+        }
     }
 
-    return item;
+    store_number(item, number);
+    item->type = cJSON_Number | (item->type & cJSON_StringIsConst);
+
+    return end;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateNumber(double num)
+/* Returns the end of the number at input if it is valid JSON, NULL otherwise. Nothing is converted. */
+static const unsigned char *scan_number(const unsigned char *input, const parse_context * const context)
 {
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    if (char_at(context, input) == '-')
     {
-        item->type = cJSON_Number;
-        item->valuedouble = num;
-
-        /* use saturation in case of overflow */
-        if (num >= INT_MAX)
+        input++;
+    }
+    if (char_at(context, input) == '0')
+    {
+        input++;
+    }
+    else if ((char_at(context, input) >= '1') && (char_at(context, input) <= '9'))
+    {
+        while ((char_at(context, input) >= '0') && (char_at(context, input) <= '9'))
         {
-            item->valueint = INT_MAX;
+            input++;
         }
-        else if (num <= INT_MIN)
+    }
+    else
+    {
+        return NULL;
+    }
+
+    if (char_at(context, input) == '.')
+    {
+        input++;
+        if ((char_at(context, input) < '0') || (char_at(context, input) > '9'))
         {
-            item->valueint = INT_MIN;
+            return NULL;
         }
-        else
+        while ((char_at(context, input) >= '0') && (char_at(context, input) <= '9'))
         {
-            item->valueint = (int)num;
+            input++;
         }
     }
 
-    return item;
-}
-
-CJSON_PUBLIC(cJSON *) cJSON_CreateString(const char *string)
-{
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    if ((char_at(context, input) == 'e') || (char_at(context, input) == 'E'))
     {
-        item->type = cJSON_String;
-        item->valuestring = (char*)cJSON_strdup((const unsigned char*)string, &global_hooks);
-        if(!item->valuestring)
+        input++;
+        if ((char_at(context, input) == '+') || (char_at(context, input) == '-'))
+        {
+            input++;
+        }
+        if ((char_at(context, input) < '0') || (char_at(context, input) > '9'))
         {
-            cJSON_Delete(item);
             return NULL;
         }
+        while ((char_at(context, input) >= '0') && (char_at(context, input) <= '9'))
+        {
+            input++;
+        }
     }
 
-    return item;
+    return input;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateRaw(const char *raw)
+/* Make item a lazy number that keeps the text at input. Numbers that aren't valid JSON are left to parse_number. */
+static const unsigned char *parse_lazy_number(cJSON * const item, const unsigned char * const input, parse_context * const context)
 {
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    const unsigned char *end = scan_number(input, context);
+    if ((end == NULL) || ((size_t)(end - input) > INT_MAX) || ((char_at(context, end) != '\0') && (strchr("0123456789+-.eE", char_at(context, end)) != NULL)))
     {
-        item->type = cJSON_Raw;
-        item->valuestring = (char*)cJSON_strdup((const unsigned char*)raw, &global_hooks);
-        if(!item->valuestring)
-        {
-            cJSON_Delete(item);
-            return NULL;
-        }
+        /* the regular parser takes in more characters */
+        return parse_number(item, input, context);
     }
 
-    return item;
+    item->type = cJSON_Number | cJSON_IsLazy | (item->type & cJSON_StringIsConst);
+    /* valuestring is never written through for lazy items */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-qual"
+    item->valuestring = (char*)input;
+#pragma GCC diagnostic pop
+    item->valuestring_length = 0;
+    item->valueint = (int)(end - input);
+    item->valuedouble = 0;
+
+    return end;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateArray(void)
+/* The value of a number. Lazy numbers are converted from their text every time, without changing them. */
+static double number_value(const cJSON * const item)
 {
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
-    {
-        item->type=cJSON_Array;
+    parse_context context;
+    const unsigned char *text = (const unsigned char*)item->valuestring;
+    double number = 0;
+
+    if (!(item->type & cJSON_IsLazy))
+    {
+        return item->valuedouble;
+    }
+
+    context.hooks = &global_hooks;
+    context.error_position = NULL;
+    context.error_code = cJSON_Error_None;
+    context.inline_item = NULL;
+    context.end = text + item->valueint;
+    if ((parse_number_fast(&number, text, &context) == NULL) && (parse_number_slow(&number, text, &context) == NULL))
+    {
+        return 0;
+    }
+
+    return number;
+}
+
+/* Render the number of the given item. Lazy numbers are printed as they were parsed, unless the output is canonical. */
+static cJSON_bool print_number(const cJSON * const item, printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    unsigned char *output_pointer = NULL;
+    const size_t length = (size_t)item->valueint;
+
+    if ((output_buffer == NULL) || !(item->type & cJSON_IsLazy) || output_buffer->canonical)
+    {
+        return print_double(number_value(item), output_buffer, hooks);
+    }
+
+    output_pointer = ensure(output_buffer, length + 1, hooks);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+    memcpy(output_pointer, item->valuestring, length);
+    output_pointer[length] = '\0';
+    output_buffer->offset += length;
+
+    return true;
+}
+
+/* converts a UTF-16 literal to UTF-8
+ * A literal can be one or two sequences of the form \uXXXX */
+static unsigned char utf16_literal_to_utf8(const unsigned char * const input_pointer, const unsigned char * const input_end, unsigned char **output_pointer)
+{
+    long unsigned int codepoint = 0;
+    unsigned int first_code = 0;
+    const unsigned char *first_sequence = input_pointer;
+    unsigned char utf8_length = 0;
+    unsigned char utf8_position = 0;
+    unsigned char sequence_length = 0;
+    unsigned char first_byte_mark = 0;
+
+    if ((input_end - first_sequence) < 6)
+    {
+        /* input ends unexpectedly */
+        goto fail;
+    }
+
+    /* get the first utf16 sequence */
+    first_code = parse_hex4(first_sequence + 2);
+
+    /* check that the code is valid */
+    if (((first_code >= 0xDC00) && (first_code <= 0xDFFF)) || (first_code == 0))
+    {
+        goto fail;
+    }
+
+    /* UTF16 surrogate pair */
+    if ((first_code >= 0xD800) && (first_code <= 0xDBFF))
+    {
+        const unsigned char *second_sequence = first_sequence + 6;
+        unsigned int second_code = 0;
+        sequence_length = 12; /* \uXXXX\uXXXX */
+
+        if ((input_end - second_sequence) < 6)
+        {
+            /* input ends unexpectedly */
+            goto fail;
+        }
+
+        if ((second_sequence[0] != '\\') || (second_sequence[1] != 'u'))
+        {
+            /* missing second half of the surrogate pair */
+            goto fail;
+        }
+
+        /* get the second utf16 sequence */
+        second_code = parse_hex4(second_sequence + 2);
+        /* check that the code is valid */
+        if ((second_code < 0xDC00) || (second_code > 0xDFFF))
+        {
+            /* invalid second half of the surrogate pair */
+            goto fail;
+        }
+
+
+        /* calculate the unicode codepoint from the surrogate pair, it always takes four bytes */
+        codepoint = 0x10000 + (((first_code & 0x3FF) << 10) | (second_code & 0x3FF));
+        (*output_pointer)[0] = (unsigned char)(0xF0 | (codepoint >> 18));
+        (*output_pointer)[1] = (unsigned char)(0x80 | ((codepoint >> 12) & 0x3F));
+        (*output_pointer)[2] = (unsigned char)(0x80 | ((codepoint >> 6) & 0x3F));
+        (*output_pointer)[3] = (unsigned char)(0x80 | (codepoint & 0x3F));
+        *output_pointer += 4;
+
+        return sequence_length;
+    }
+    else if (first_code >= 0x800)
+    {
+        /* the rest of the basic multilingual plane (CJK for example) takes three bytes */
+        (*output_pointer)[0] = (unsigned char)(0xE0 | (first_code >> 12));
+        (*output_pointer)[1] = (unsigned char)(0x80 | ((first_code >> 6) & 0x3F));
+        (*output_pointer)[2] = (unsigned char)(0x80 | (first_code & 0x3F));
+        *output_pointer += 3;
+
+        return 6; /* \uXXXX */
+    }
+    else
+    {
+        sequence_length = 6; /* \uXXXX */
+        codepoint = first_code;
+    }
+
+    /* encode as UTF-8
+     * takes at maximum 4 bytes to encode:
+     * 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx */
+    if (codepoint < 0x80)
+    {
+        /* normal ascii, encoding 0xxxxxxx */
+        utf8_length = 1;
+    }
+    else if (codepoint < 0x800)
+    {
+        /* two bytes, encoding 110xxxxx 10xxxxxx */
+        utf8_length = 2;
+        first_byte_mark = 0xC0; /* 11000000 */
+    }
+    else if (codepoint < 0x10000)
+    {
+        /* three bytes, encoding 1110xxxx 10xxxxxx 10xxxxxx */
+        utf8_length = 3;
+        first_byte_mark = 0xE0; /* 11100000 */
+    }
+    else if (codepoint <= 0x10FFFF)
+    {
+        /* four bytes, encoding 1110xxxx 10xxxxxx 10xxxxxx 10xxxxxx */
+        utf8_length = 4;
+        first_byte_mark = 0xF0; /* 11110000 */
+    }
+    else
+    {
+        /* invalid unicode codepoint */
+        goto fail;
+    }
+
+    /* encode as utf8 */
+    for (utf8_position = (unsigned char)(utf8_length - 1); utf8_position > 0; utf8_position--)
+    {
+        /* 10xxxxxx */
+        (*output_pointer)[utf8_position] = (unsigned char)((codepoint | 0x80) & 0xBF);
+        codepoint >>= 6;
+    }
+    /* encode first byte */
+    if (utf8_length > 1)
+    {
+        (*output_pointer)[0] = (unsigned char)((codepoint | first_byte_mark) & 0xFF);
+    }
+    else
+    {
+        (*output_pointer)[0] = (unsigned char)(codepoint & 0x7F);
+    }
+
+    *output_pointer += utf8_length;
+
+    return sequence_length;
+
+fail:
+    return 0;
+}
+
+/* Returns the first '\"', '\\' or '\0' in [pointer, end), or end if there is none. */
+static const unsigned char *find_string_special(const unsigned char *pointer, const unsigned char * const end)
+{
+#ifdef CJSON_SSE2
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i zero = _mm_setzero_si128();
+
+    while ((size_t)(end - pointer) >= sizeof(__m128i))
+    {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*)(const void*)pointer);
+        const __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                _mm_cmpeq_epi8(chunk, zero));
+        if (_mm_movemask_epi8(special) != 0)
+        {
+            /* the loop below finds the exact position */
+            break;
+        }
+        pointer += sizeof(__m128i);
+    }
+#endif
+
+    while ((pointer < end) && (*pointer != '\"') && (*pointer != '\\') && (*pointer != '\0'))
+    {
+        pointer++;
+    }
+
+    return pointer;
+}
+
+/* Returns the first byte in [pointer, end) that isn't part of well-formed UTF-8 (RFC 3629), or end if there is none. */
+static const unsigned char *find_invalid_utf8(const unsigned char *pointer, const unsigned char * const end)
+{
+    unsigned char second_min = 0;
+    unsigned char second_max = 0;
+    size_t length = 0;
+    size_t i = 0;
+
+    while (pointer < end)
+    {
+#ifdef CJSON_SSE2
+        /* skip ASCII in blocks, only bytes >= 0x80 have the sign bit set */
+        while (((size_t)(end - pointer) >= sizeof(__m128i))
+                && (_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(const void*)pointer)) == 0))
+        {
+            pointer += sizeof(__m128i);
+        }
+        if (pointer == end)
+        {
+            break;
+        }
+#endif
+        if (*pointer < 0x80)
+        {
+            pointer++;
+            continue;
+        }
+
+        second_min = 0x80;
+        second_max = 0xBF;
+        if ((*pointer >= 0xC2) && (*pointer <= 0xDF))
+        {
+            length = 2;
+        }
+        else if ((*pointer >= 0xE0) && (*pointer <= 0xEF))
+        {
+            length = 3;
+            if (*pointer == 0xE0)
+            {
+                second_min = 0xA0; /* overlong */
+            }
+            else if (*pointer == 0xED)
+            {
+                second_max = 0x9F; /* surrogates */
+            }
+        }
+        else if ((*pointer >= 0xF0) && (*pointer <= 0xF4))
+        {
+            length = 4;
+            if (*pointer == 0xF0)
+            {
+                second_min = 0x90; /* overlong */
+            }
+            else if (*pointer == 0xF4)
+            {
+                second_max = 0x8F; /* beyond U+10FFFF */
+            }
+        }
+        else
+        {
+            return pointer;
+        }
+
+        if (((size_t)(end - pointer) < length) || (pointer[1] < second_min) || (pointer[1] > second_max))
+        {
+            return pointer;
+        }
+        for (i = 2; i < length; i++)
+        {
+            if ((pointer[i] & 0xC0) != 0x80)
+            {
+                return pointer;
+            }
+        }
+        pointer += length;
+    }
+
+    return end;
+}
+
+/* Find the end of the string at input without unescaping it. Returns a pointer behind the closing quote. */
+static const unsigned char *skip_string(const unsigned char * const input, parse_context * const context)
+{
+    const unsigned char *pointer = NULL;
+
+    for (pointer = find_string_special(input + 1, context->end);
+         (pointer < context->end) && (*pointer == '\\') && ((pointer + 1) < context->end);
+         pointer = find_string_special(pointer + 2, context->end))
+    {
+    }
+    if ((pointer >= context->end) || (*pointer != '\"'))
+    {
+        return parse_error(context, pointer, cJSON_Error_UnexpectedEnd);
+    }
+
+    return pointer + 1;
+}
+
+/* Parse the input text into an unescaped cinput, and populate item. */
+static const unsigned char *parse_string(cJSON * const item, const unsigned char * const input, parse_context * const context)
+{
+    const unsigned char *input_pointer = input + 1;
+    const unsigned char *input_end = input + 1;
+    unsigned char *output_pointer = NULL;
+    unsigned char *output = NULL;
+
+    /* not a string */
+    if (char_at(context, input) != '\"')
+    {
+        parse_error(context, input, cJSON_Error_InvalidValue);
+        goto fail;
+    }
+
+    {
+        /* calculate approximate size of the output (overestimate) */
+        size_t allocation_length = 0;
+        size_t skipped_bytes = 0;
+        for (input_end = find_string_special(input_end, context->end);
+             char_at(context, input_end) == '\\';
+             input_end = find_string_special(input_end + 2, context->end))
+        {
+            /* is escape sequence */
+            if (char_at(context, input_end + 1) == '\0')
+            {
+                /* prevent buffer overflow when last input character is a backslash */
+                parse_error(context, input_end + 1, cJSON_Error_UnexpectedEnd);
+                goto fail;
+            }
+            skipped_bytes++;
+        }
+        if (char_at(context, input_end) == '\0')
+        {
+            parse_error(context, input_end, cJSON_Error_UnexpectedEnd);
+            goto fail; /* string ended unexpectedly */
+        }
+
+        if (context->hooks->in_situ != NULL)
+        {
+            /* the unescaped string is never longer than the escaped one, so it overwrites the input, behind the quote */
+            output = context->hooks->in_situ + (input_pointer - context->hooks->in_situ);
+        }
+        else
+        {
+            /* This is at most how much we need for the output */
+            allocation_length = (size_t) (input_end - input) - skipped_bytes;
+            if (item == context->inline_item)
+            {
+                /* the opening quote is counted too, which leaves room for the '\0' */
+                output = (unsigned char*)inline_string(item, false, allocation_length);
+            }
+            if (output == NULL)
+            {
+                output = (unsigned char*)allocate_memory(allocation_length + sizeof('\0'), context->hooks);
+            }
+            if (output == NULL)
+            {
+                parse_error(context, input, cJSON_Error_OutOfMemory);
+                goto fail; /* allocation failure */
+            }
+        }
+    }
+
+    output_pointer = output;
+    /* loop through the string literal */
+    while (input_pointer < input_end)
+    {
+        if (*input_pointer != '\\')
+        {
+            /* copy everything up to the next escape sequence at once */
+            const unsigned char *run_end = find_string_special(input_pointer, input_end);
+            if (context->hooks->strict_utf8)
+            {
+                /* escapes always decode to valid UTF-8, so only the runs between them are checked */
+                const unsigned char *invalid = find_invalid_utf8(input_pointer, run_end);
+                if (invalid != run_end)
+                {
+                    parse_error(context, invalid, cJSON_Error_InvalidUTF8);
+                    goto fail;
+                }
+            }
+            if (output_pointer != input_pointer)
+            {
+                memmove(output_pointer, input_pointer, (size_t)(run_end - input_pointer));
+            }
+            output_pointer += run_end - input_pointer;
+            input_pointer = run_end;
+        }
+        /* escape sequence */
+        else
+        {
+            unsigned char sequence_length = 2;
+            switch (input_pointer[1])
+            {
+                case 'b':
+                    *output_pointer++ = '\b';
+                    break;
+                case 'f':
+                    *output_pointer++ = '\f';
+                    break;
+                case 'n':
+                    *output_pointer++ = '\n';
+                    break;
+                case 'r':
+                    *output_pointer++ = '\r';
+                    break;
+                case 't':
+                    *output_pointer++ = '\t';
+                    break;
+                case '\"':
+                case '\\':
+                case '/':
+                    *output_pointer++ = input_pointer[1];
+                    break;
+
+                /* UTF-16 literal */
+                case 'u':
+                    sequence_length = utf16_literal_to_utf8(input_pointer, input_end, &output_pointer);
+                    if (sequence_length == 0)
+                    {
+                        /* failed to convert UTF16-literal to UTF-8 */
+                        parse_error(context, input_pointer, cJSON_Error_InvalidUnicode);
+                        goto fail;
+                    }
+                    break;
+
+                default:
+                    parse_error(context, input_pointer, cJSON_Error_InvalidEscape);
+                    goto fail;
+            }
+            input_pointer += sequence_length;
+        }
+    }
+
+    /* zero terminate the output */
+    *output_pointer = '\0';
+    if ((context->hooks->budget != NULL) && (context->hooks->budget->limits->max_string_length != 0)
+            && ((size_t)(output_pointer - output) > context->hooks->budget->limits->max_string_length))
+    {
+        parse_error(context, input, cJSON_Error_StringTooLong);
+        goto fail;
+    }
+
+    item->type = cJSON_String | (item->type & cJSON_StringIsConst);
+    if (context->hooks->in_situ != NULL)
+    {
+        /* the string belongs to the input */
+        item->type |= cJSON_IsReference;
+    }
+    item->valuestring = (char*)output;
+    store_valuestring_length(item, (size_t)(output_pointer - output));
+
+    return input_end + 1;
+
+fail:
+    if ((output != NULL) && (context->hooks->in_situ == NULL))
+    {
+        deallocate_string(item, (char*)output, context->hooks);
+    }
+
+    return NULL;
+}
+
+/* Check the string at input like parse_string does, without unescaping it. Returns a pointer to the closing quote. */
+static const unsigned char *check_string(const unsigned char * const input, parse_context * const context)
+{
+    const unsigned char *input_end = NULL;
+    const unsigned char *pointer = NULL;
+    unsigned char decoded[4];
+    unsigned char *decoded_pointer = NULL;
+    unsigned char sequence_length = 0;
+
+    if (char_at(context, input) != '\"')
+    {
+        return parse_error(context, input, cJSON_Error_InvalidValue);
+    }
+
+    /* find the end first, like parse_string */
+    for (input_end = find_string_special(input + 1, context->end);
+         char_at(context, input_end) == '\\';
+         input_end = find_string_special(input_end + 2, context->end))
+    {
+        if (char_at(context, input_end + 1) == '\0')
+        {
+            return parse_error(context, input_end + 1, cJSON_Error_UnexpectedEnd);
+        }
+    }
+    if (char_at(context, input_end) == '\0')
+    {
+        return parse_error(context, input_end, cJSON_Error_UnexpectedEnd); /* string ended unexpectedly */
+    }
+
+    for (pointer = find_string_special(input + 1, input_end);
+         pointer < input_end;
+         pointer = find_string_special(pointer + sequence_length, input_end))
+    {
+        sequence_length = 2;
+        switch (pointer[1])
+        {
+            case 'b':
+            case 'f':
+            case 'n':
+            case 'r':
+            case 't':
+            case '\"':
+            case '\\':
+            case '/':
+                break;
+
+            case 'u':
+                /* the UTF-8 goes nowhere, it only has to be valid */
+                decoded_pointer = decoded;
+                sequence_length = utf16_literal_to_utf8(pointer, input_end, &decoded_pointer);
+                if (sequence_length == 0)
+                {
+                    return parse_error(context, pointer, cJSON_Error_InvalidUnicode);
+                }
+                break;
+
+            default:
+                return parse_error(context, pointer, cJSON_Error_InvalidEscape);
+        }
+    }
+
+    return input_end;
+}
+
+/* Make item a lazy string that keeps the escaped text at input. The escape sequences are checked, but not unescaped. */
+static const unsigned char *parse_string_text(cJSON * const item, const unsigned char * const input, parse_context * const context)
+{
+    const unsigned char * const input_end = check_string(input, context);
+
+    if (input_end == NULL)
+    {
+        return NULL;
+    }
+    if ((size_t)(input_end - input - 1) > INT_MAX)
+    {
+        return parse_string(item, input, context); /* the length has to fit into valueint */
+    }
+
+    item->type = cJSON_String | cJSON_IsLazy | (item->type & cJSON_StringIsConst);
+    /* valuestring is never written through for lazy items */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-qual"
+    item->valuestring = (char*)(input + 1);
+#pragma GCC diagnostic pop
+    item->valuestring_length = 0;
+    item->valueint = (int)(input_end - input - 1);
+
+    return input_end + 1;
+}
+
+/* Returns the first character in [pointer, end) that has to be escaped, or end if there is none. */
+static const unsigned char *find_escape_character(const unsigned char *pointer, const unsigned char * const end)
+{
+#ifdef CJSON_SSE2
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i last_control = _mm_set1_epi8(31);
+
+    while ((size_t)(end - pointer) >= sizeof(__m128i))
+    {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*)(const void*)pointer);
+        /* there is no unsigned compare in SSE2, but max(c, 31) == 31 is the same as c <= 31 */
+        const __m128i escape = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                _mm_cmpeq_epi8(_mm_max_epu8(chunk, last_control), last_control));
+        if (_mm_movemask_epi8(escape) != 0)
+        {
+            /* the loop below finds the exact position */
+            break;
+        }
+        pointer += sizeof(__m128i);
+    }
+#endif
+
+    while ((pointer < end) && (*pointer > 31) && (*pointer != '\"') && (*pointer != '\\'))
+    {
+        pointer++;
+    }
+
+    return pointer;
+}
+
+/* Count the additional characters needed to escape [input, input_end). */
+static size_t count_escape_characters(const unsigned char * const input, const unsigned char * const input_end)
+{
+    const unsigned char *input_pointer = NULL;
+    size_t escape_characters = 0;
+
+    for (input_pointer = find_escape_character(input, input_end);
+         input_pointer < input_end;
+         input_pointer = find_escape_character(input_pointer + 1, input_end))
+    {
+        if (strchr("\"\\\b\f\n\r\t", *input_pointer))
+        {
+            /* one character escape sequence */
+            escape_characters++;
+        }
+        else if (*input_pointer < 32)
+        {
+            /* UTF-16 escape sequence uXXXX */
+            escape_characters += 5;
+        }
+    }
+
+    return escape_characters;
+}
+
+/* Render the length bytes at input to an escaped version that can be printed. */
+static cJSON_bool print_string_length(const unsigned char * const input, const size_t length, printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    const unsigned char *input_pointer = NULL;
+    const unsigned char *input_end = NULL;
+    unsigned char *output = NULL;
+    unsigned char *output_pointer = NULL;
+    size_t output_length = 0;
+    /* numbers of additional characters needed for escaping */
+    size_t escape_characters = 0;
+
+    if (output_buffer == NULL)
+    {
+        return false;
+    }
+
+    /* empty string */
+    if (input == NULL)
+    {
+        output = ensure(output_buffer, sizeof("\"\""), hooks);
+        if (output == NULL)
+        {
+            return false;
+        }
+        strcpy((char*)output, "\"\"");
+
+        return true;
+    }
+
+    /* count the additional characters needed for escaping */
+    input_end = input + length;
+    if (hooks->strict_utf8 && (find_invalid_utf8(input, input_end) != input_end))
+    {
+        return false;
+    }
+    escape_characters = count_escape_characters(input, input_end);
+    output_length = (size_t)(input_end - input) + escape_characters;
+
+    output = ensure(output_buffer, output_length + sizeof("\"\""), hooks);
+    if (output == NULL)
+    {
+        return false;
+    }
+
+    /* no characters have to be escaped */
+    if (escape_characters == 0)
+    {
+        output[0] = '\"';
+        memcpy(output + 1, input, output_length);
+        output[output_length + 1] = '\"';
+        output[output_length + 2] = '\0';
+
+        return true;
+    }
+
+    output[0] = '\"';
+    output_pointer = output + 1;
+    /* copy the string */
+    for (input_pointer = input; input_pointer < input_end; (void)input_pointer++, output_pointer++)
+    {
+        /* normal characters, copy everything up to the next one that needs escaping at once */
+        const unsigned char *run_end = find_escape_character(input_pointer, input_end);
+        memcpy(output_pointer, input_pointer, (size_t)(run_end - input_pointer));
+        output_pointer += run_end - input_pointer;
+        input_pointer = run_end;
+        if (input_pointer == input_end)
+        {
+            break;
+        }
+
+        /* character needs to be escaped */
+        *output_pointer++ = '\\';
+        switch (*input_pointer)
+        {
+            case '\\':
+                *output_pointer = '\\';
+                break;
+            case '\"':
+                *output_pointer = '\"';
+                break;
+            case '\b':
+                *output_pointer = 'b';
+                break;
+            case '\f':
+                *output_pointer = 'f';
+                break;
+            case '\n':
+                *output_pointer = 'n';
+                break;
+            case '\r':
+                *output_pointer = 'r';
+                break;
+            case '\t':
+                *output_pointer = 't';
+                break;
+            default:
+                /* escape and print as unicode codepoint */
+                sprintf((char*)output_pointer, "u%04x", *input_pointer);
+                output_pointer += 4;
+                break;
+        }
+    }
+    output[output_length + 1] = '\"';
+    output[output_length + 2] = '\0';
+
+    return true;
+}
+
+/* Predeclare these prototypes. */
+static const unsigned char *parse_value(cJSON * const item, const unsigned char * const input, parse_context * const context);
+static cJSON_bool print_value(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks);
+static const unsigned char *parse_array(cJSON * const item, const unsigned char *input, parse_context * const context);
+static cJSON_bool print_array(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks);
+static const unsigned char *parse_object(cJSON * const item, const unsigned char *input, parse_context * const context);
+static cJSON_bool print_object(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks);
+static const unsigned char *parse_lazy(cJSON * const item, const unsigned char * const input, parse_context * const context);
+static cJSON_bool load_lazy(const cJSON * const lazy_item);
+static cJSON_bool load_lazy_tree(const cJSON * const item);
+static const unsigned char *parse_packed(cJSON * const item, const unsigned char *input, parse_context * const context);
+static cJSON_bool append_numbers(cJSON * const array, const double * const numbers, const size_t count, const internal_hooks * const hooks);
+static cJSON_bool print_cache_copy(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks);
+static void print_cache_add(cJSON_PrintCache * const cache, const cJSON * const item, const size_t depth, const cJSON_bool format, const unsigned char * const text, const size_t length);
+
+static const unsigned char base64_digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* the length of the padded base64 text of length bytes */
+static size_t base64_length(const size_t length)
+{
+    return ((length + 2) / 3) * 4;
+}
+
+#ifdef CJSON_SSE2
+/* Encode 12 bytes into 16 digits. Every 32 bit lane gets 3 bytes, whose 6 bit parts are spread over its bytes and then
+ * mapped to the digits with comparisons instead of a table. */
+static void encode_base64_block(unsigned char * const output, const unsigned char * const input)
+{
+    const __m128i bits = _mm_set_epi32(
+            (int)(((unsigned int)input[9] << 16) | ((unsigned int)input[10] << 8) | input[11]),
+            (int)(((unsigned int)input[6] << 16) | ((unsigned int)input[7] << 8) | input[8]),
+            (int)(((unsigned int)input[3] << 16) | ((unsigned int)input[4] << 8) | input[5]),
+            (int)(((unsigned int)input[0] << 16) | ((unsigned int)input[1] << 8) | input[2]));
+    const __m128i indices = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(_mm_srli_epi32(bits, 18), _mm_set1_epi32(0x3F)),
+                _mm_and_si128(_mm_srli_epi32(bits, 4), _mm_set1_epi32(0x3F00))),
+            _mm_or_si128(_mm_and_si128(_mm_slli_epi32(bits, 10), _mm_set1_epi32(0x3F0000)),
+                _mm_and_si128(_mm_slli_epi32(bits, 24), _mm_set1_epi32(0x3F000000))));
+    /* 'A' + index, then the offsets of a-z, 0-9, '+' and '/' are added where the index reaches them */
+    __m128i digits = _mm_add_epi8(indices, _mm_set1_epi8('A'));
+    digits = _mm_add_epi8(digits, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(25)), _mm_set1_epi8(6)));
+    digits = _mm_sub_epi8(digits, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(51)), _mm_set1_epi8(75)));
+    digits = _mm_sub_epi8(digits, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(61)), _mm_set1_epi8(15)));
+    digits = _mm_add_epi8(digits, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(62)), _mm_set1_epi8(3)));
+
+    _mm_storeu_si128((__m128i*)(void*)output, digits);
+}
+
+/* Decode 16 digits into 12 bytes (unless output is NULL), returns false if one of them isn't a digit. */
+static cJSON_bool decode_base64_block(unsigned char * const output, const unsigned char * const input)
+{
+    const __m128i chunk = _mm_loadu_si128((const __m128i*)(const void*)input);
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(chunk, _mm_set1_epi8('Z' + 1)));
+    const __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(chunk, _mm_set1_epi8('z' + 1)));
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1)));
+    const __m128i plus = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('+'));
+    const __m128i slash = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('/'));
+    __m128i values;
+    __m128i bits;
+    unsigned char packed[16];
+    size_t i = 0;
+
+    /* bytes >= 0x80 are negative and in none of the ranges */
+    if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), slash)) != 0xFFFF)
+    {
+        return false;
+    }
+    if (output == NULL)
+    {
+        return true;
+    }
+
+    values = _mm_add_epi8(chunk, _mm_and_si128(upper, _mm_set1_epi8(-'A')));
+    values = _mm_add_epi8(values, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+    values = _mm_add_epi8(values, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+    values = _mm_add_epi8(values, _mm_and_si128(plus, _mm_set1_epi8(62 - '+')));
+    values = _mm_add_epi8(values, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+    /* the 4 values of every lane become its low 24 bits */
+    bits = _mm_or_si128(
+            _mm_or_si128(_mm_slli_epi32(_mm_and_si128(values, _mm_set1_epi32(0x3F)), 18),
+                _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(values, 8), _mm_set1_epi32(0x3F)), 12)),
+            _mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(values, 16), _mm_set1_epi32(0x3F)), 6),
+                _mm_srli_epi32(values, 24)));
+    _mm_storeu_si128((__m128i*)(void*)packed, bits);
+    for (i = 0; i < 4; i++)
+    {
+        output[(3 * i)] = packed[(4 * i) + 2];
+        output[(3 * i) + 1] = packed[(4 * i) + 1];
+        output[(3 * i) + 2] = packed[4 * i];
+    }
+
+    return true;
+}
+#endif
+
+/* Write the base64_length(length) digits of length bytes of input to output, which may be input itself if it has the
+ * room: the groups are encoded from the end, so each is read before the digits in front of it overwrite it. */
+static void encode_base64(unsigned char * const output, const unsigned char * const input, const size_t length)
+{
+    size_t groups = length / 3;
+    unsigned long bits = 0;
+
+    if ((length % 3) != 0)
+    {
+        bits = (unsigned long)input[3 * groups] << 16;
+        if ((length % 3) == 2)
+        {
+            bits |= (unsigned long)input[(3 * groups) + 1] << 8;
+        }
+        output[(4 * groups)] = base64_digits[(bits >> 18) & 0x3F];
+        output[(4 * groups) + 1] = base64_digits[(bits >> 12) & 0x3F];
+        output[(4 * groups) + 2] = ((length % 3) == 2) ? base64_digits[(bits >> 6) & 0x3F] : '=';
+        output[(4 * groups) + 3] = '=';
+    }
+    while (groups > 0)
+    {
+#ifdef CJSON_SSE2
+        if (groups >= 4)
+        {
+            groups -= 4;
+            encode_base64_block(output + (4 * groups), input + (3 * groups));
+            continue;
+        }
+#endif
+        groups--;
+        bits = ((unsigned long)input[3 * groups] << 16) | ((unsigned long)input[(3 * groups) + 1] << 8) | input[(3 * groups) + 2];
+        output[(4 * groups)] = base64_digits[(bits >> 18) & 0x3F];
+        output[(4 * groups) + 1] = base64_digits[(bits >> 12) & 0x3F];
+        output[(4 * groups) + 2] = base64_digits[(bits >> 6) & 0x3F];
+        output[(4 * groups) + 3] = base64_digits[bits & 0x3F];
+    }
+}
+
+/* the value of a base64 digit, 64 if it isn't one */
+static unsigned int base64_value(const unsigned char digit)
+{
+    if ((digit >= 'A') && (digit <= 'Z'))
+    {
+        return (unsigned int)(digit - 'A');
+    }
+    if ((digit >= 'a') && (digit <= 'z'))
+    {
+        return (unsigned int)(digit - 'a') + 26;
+    }
+    if ((digit >= '0') && (digit <= '9'))
+    {
+        return (unsigned int)(digit - '0') + 52;
+    }
+    if (digit == '+')
+    {
+        return 62;
+    }
+    if (digit == '/')
+    {
+        return 63;
+    }
+
+    return 64;
+}
+
+/* Decode length digits of padded base64 into output, which may be input, or only check them if output is NULL. Returns
+ * the number of bytes or (size_t)-1 if input isn't base64, output may have been written to then. */
+static size_t decode_base64(unsigned char * const output, const unsigned char * const input, const size_t length)
+{
+    unsigned int values[4];
+    unsigned long bits = 0;
+    size_t padding = 0;
+    size_t position = 0;
+    size_t decoded = 0;
+    size_t i = 0;
+
+    if ((length % 4) != 0)
+    {
+        return (size_t)-1;
+    }
+    if ((length > 0) && (input[length - 1] == '='))
+    {
+        padding = (input[length - 2] == '=') ? 2 : 1;
+    }
+
+    while (position < length)
+    {
+#ifdef CJSON_SSE2
+        /* the last group may have padding, it is left to the loop below */
+        if (((length - position) >= 20) && decode_base64_block((output != NULL) ? (output + decoded) : NULL, input + position))
+        {
+            position += 16;
+            decoded += 12;
+            continue;
+        }
+#endif
+        for (i = 0; i < 4; i++)
+        {
+            values[i] = base64_value(input[position + i]);
+        }
+        if ((position + 4) == length)
+        {
+            for (i = 4 - padding; i < 4; i++)
+            {
+                values[i] = 0;
+            }
+        }
+        if ((values[0] | values[1] | values[2] | values[3]) > 63)
+        {
+            return (size_t)-1;
+        }
+        bits = ((unsigned long)values[0] << 18) | ((unsigned long)values[1] << 12) | ((unsigned long)values[2] << 6) | values[3];
+        position += 4;
+        for (i = 0; i < (((position == length) ? (3 - padding) : 3)); i++)
+        {
+            if (output != NULL)
+            {
+                output[decoded] = (unsigned char)((bits >> (16 - (8 * i))) & 0xFF);
+            }
+            decoded++;
+        }
+    }
+
+    return decoded;
+}
+
+/* Render the cstring provided to an escaped version that can be printed. */
+static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    return print_string_length(input, (input != NULL) ? strlen((const char*)input) : 0, output_buffer, hooks);
+}
+
+/* Invoke print_string_ptr (which is useful) on an item. Lazy strings are copied as they were parsed, unless the output is
+ * canonical. */
+static cJSON_bool print_string(const cJSON * const item, printbuffer * const p, const internal_hooks * const hooks)
+{
+    unsigned char *output_pointer = NULL;
+    const size_t length = (size_t)item->valueint;
+
+    if (item->type & cJSON_IsBinary)
+    {
+        /* base64 never needs escapes */
+        output_pointer = ensure(p, base64_length(length) + sizeof("\"\""), hooks);
+        if (output_pointer == NULL)
+        {
+            return false;
+        }
+        output_pointer[0] = '\"';
+        encode_base64(output_pointer + 1, (const unsigned char*)item->valuestring, length);
+        output_pointer[base64_length(length) + 1] = '\"';
+        output_pointer[base64_length(length) + 2] = '\0';
+
+        return true;
+    }
+    if ((item->type & cJSON_IsLazy) && !p->canonical)
+    {
+        output_pointer = ensure(p, length + sizeof("\"\""), hooks);
+        if (output_pointer == NULL)
+        {
+            return false;
+        }
+        output_pointer[0] = '\"';
+        memcpy(output_pointer + 1, item->valuestring, length);
+        output_pointer[length + 1] = '\"';
+        output_pointer[length + 2] = '\0';
+
+        return true;
+    }
+    if (!load_lazy(item))
+    {
+        return false;
+    }
+
+    if (item->valuestring == NULL)
+    {
+        return print_string_ptr(NULL, p, hooks);
+    }
+
+    return print_string_length((unsigned char*)item->valuestring, valuestring_length(item), p, hooks);
+}
+
+/* Utility to jump whitespace and cr/lf */
+static const unsigned char *skip_whitespace(const parse_context * const context, const unsigned char *in)
+{
+    if (in == NULL)
+    {
+        return NULL;
+    }
+
+#ifdef CJSON_SSE2
+    if ((in < context->end) && (*in <= 32))
+    {
+        const __m128i last_whitespace = _mm_set1_epi8(32);
+        const __m128i zero = _mm_setzero_si128();
+
+        /* long runs like indentation are skipped in blocks, unsigned c <= 32 is max(c, 32) == 32 */
+        while ((size_t)(context->end - in) >= sizeof(__m128i))
+        {
+            const __m128i chunk = _mm_loadu_si128((const __m128i*)(const void*)in);
+            const __m128i whitespace = _mm_andnot_si128(_mm_cmpeq_epi8(chunk, zero),
+                    _mm_cmpeq_epi8(_mm_max_epu8(chunk, last_whitespace), last_whitespace));
+            if (_mm_movemask_epi8(whitespace) != 0xFFFF)
+            {
+                /* the loop below finds the exact position */
+                break;
+            }
+            in += sizeof(__m128i);
+        }
+    }
+#endif
+
+    while ((in < context->end) && (*in != '\0') && (*in <= 32))
+    {
+        in++;
+    }
+
+    return in;
+}
+
+/* calculate line and column of an error */
+static void fill_parse_error(cJSON_ParseError * const error, const unsigned char * const start, const parse_context * const context)
+{
+    const unsigned char *pointer = NULL;
+
+    error->code = context->error_code;
+    error->position = 0;
+    error->line = 0;
+    error->column = 0;
+    if ((context->error_position == NULL) || (start == NULL))
+    {
+        return;
+    }
+
+    error->position = (size_t)(context->error_position - start);
+    error->line = 1;
+    error->column = 1;
+    for (pointer = start; pointer < context->error_position; pointer++)
+    {
+        if (*pointer == '\n')
+        {
+            error->line++;
+            error->column = 1;
+        }
+        else
+        {
+            error->column++;
+        }
+    }
+}
+
+/* Parse an object - create a new root, and populate.
+ * On failure return_parse_end is set to the position of the error. */
+static cJSON *parse(const unsigned char * const value, const size_t length, const unsigned char ** const return_parse_end, const cJSON_bool require_null_terminated, const cJSON_bool lazy, const internal_hooks * const hooks, cJSON_ParseError * const error)
+{
+    const unsigned char *end = NULL;
+    parse_context context;
+    cJSON *c = NULL;
+
+    context.hooks = hooks;
+    context.error_position = NULL;
+    context.error_code = cJSON_Error_None;
+    context.inline_item = NULL;
+    context.end = NULL;
+
+    CJSON_TRACE(parse_start, value, length);
+    if (value == NULL)
+    {
+        goto fail;
+    }
+    context.end = value + length;
+
+    c = cJSON_New_Item(hooks);
+    if (!c) /* memory fail */
+    {
+        parse_error(&context, value, cJSON_Error_OutOfMemory);
+        goto fail;
+    }
+    context.inline_item = c;
+
+    end = skip_whitespace(&context, value);
+    if (lazy && ((char_at(&context, end) == '[') || (char_at(&context, end) == '{')))
+    {
+        end = parse_lazy(c, end, &context);
+    }
+    else
+    {
+        end = parse_value(c, end, &context);
+    }
+    if (!end)
+    {
+        /* parse failure. context has the error. */
+        goto fail;
+    }
+
+    /* if we require null-terminated JSON without appended garbage, skip and then check for a null terminator */
+    if (require_null_terminated)
+    {
+        end = skip_whitespace(&context, end);
+        if (char_at(&context, end) != '\0')
+        {
+            parse_error(&context, end, cJSON_Error_TrailingCharacters);
+            goto fail;
+        }
+    }
+
+    if (return_parse_end != NULL)
+    {
+        *return_parse_end = end;
+    }
+    if (error != NULL)
+    {
+        fill_parse_error(error, value, &context);
+    }
+    CJSON_TRACE(parse_end, c, cJSON_Error_None);
+
+    return c;
+
+fail:
+    if (c != NULL)
+    {
+        delete_item(c, hooks);
+    }
+    if ((hooks->budget != NULL) && (hooks->budget->error_code != cJSON_Error_None))
+    {
+        /* the allocation didn't fail for lack of memory */
+        context.error_code = hooks->budget->error_code;
+    }
+    if (return_parse_end != NULL)
+    {
+        *return_parse_end = context.error_position;
+    }
+    if (error != NULL)
+    {
+        fill_parse_error(error, value, &context);
+    }
+    CJSON_TRACE(parse_end, NULL, context.error_code);
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    if (value == NULL)
+    {
+        return cJSON_ParseWithLengthOpts(NULL, 0, return_parse_end, require_null_terminated);
+    }
+
+    return cJSON_ParseWithLengthOpts(value, strlen(value), return_parse_end, require_null_terminated);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    const unsigned char *end = NULL;
+    cJSON *item = parse((const unsigned char*)value, buffer_length, &end, require_null_terminated, false, &global_hooks, NULL);
+
+    /* use global error pointer if no specific one was given */
+    if (return_parse_end != NULL)
+    {
+        *return_parse_end = (const char*)end;
+    }
+    else
+    {
+        global_ep = (item == NULL) ? end : NULL;
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithStats(const char *value, size_t buffer_length, cJSON_Stats *stats)
+{
+    internal_hooks stats_hooks = global_hooks;
+    const unsigned char *end = NULL;
+    cJSON *item = NULL;
+    clock_t start = 0;
+
+    if (stats == NULL)
+    {
+        return cJSON_ParseWithLength(value, buffer_length);
+    }
+
+    memset(stats, '\0', sizeof(cJSON_Stats));
+    stats_hooks.stats = stats;
+    start = clock();
+    item = parse((const unsigned char*)value, buffer_length, &end, false, false, &stats_hooks, NULL);
+    stats->seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    global_ep = (item == NULL) ? end : NULL;
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSitu(char *buffer, size_t buffer_length)
+{
+    internal_hooks in_situ_hooks = global_hooks;
+    const unsigned char *end = NULL;
+    cJSON *item = NULL;
+
+    in_situ_hooks.in_situ = (unsigned char*)buffer;
+    item = parse((const unsigned char*)buffer, buffer_length, &end, false, false, &in_situ_hooks, NULL);
+    global_ep = (item == NULL) ? end : NULL;
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseLazy(const char *value, size_t buffer_length)
+{
+    const unsigned char *end = NULL;
+    cJSON *item = parse((const unsigned char*)value, buffer_length, &end, true, true, &global_hooks, NULL);
+
+    global_ep = (item == NULL) ? end : NULL;
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_LoadLazy(cJSON *item)
+{
+    if (item == NULL)
+    {
+        return false;
+    }
+
+    return load_lazy_tree(item);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithNumberText(const char *value, size_t buffer_length)
+{
+    internal_hooks lazy_hooks = global_hooks;
+    const unsigned char *end = NULL;
+    cJSON *item = NULL;
+
+    lazy_hooks.lazy_numbers = true;
+    item = parse((const unsigned char*)value, buffer_length, &end, false, false, &lazy_hooks, NULL);
+    global_ep = (item == NULL) ? end : NULL;
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithStringText(const char *value, size_t buffer_length)
+{
+    internal_hooks lazy_hooks = global_hooks;
+    const unsigned char *end = NULL;
+    cJSON *item = NULL;
+
+    lazy_hooks.lazy_strings = true;
+    item = parse((const unsigned char*)value, buffer_length, &end, false, false, &lazy_hooks, NULL);
+    global_ep = (item == NULL) ? end : NULL;
+
+    return item;
+}
+
+CJSON_PUBLIC(char *) cJSON_GetStringValue(const cJSON *item)
+{
+    if ((item == NULL) || ((item->type & 0xFF) != cJSON_String) || !load_lazy(item))
+    {
+        return NULL;
+    }
+
+    return item->valuestring;
+}
+
+CJSON_PUBLIC(size_t) cJSON_GetStringLength(const cJSON *item)
+{
+    if ((item == NULL) || ((item->type & 0xFF) != cJSON_String) || !load_lazy(item) || (item->valuestring == NULL))
+    {
+        return 0;
+    }
+
+    return valuestring_length(item);
+}
+
+CJSON_PUBLIC(size_t) cJSON_GetNameLength(const cJSON *item)
+{
+    if ((item == NULL) || (item->string == NULL))
+    {
+        return 0;
+    }
+
+    return name_length(item);
+}
+
+CJSON_PUBLIC(double) cJSON_GetNumberValue(const cJSON *item)
+{
+    if ((item == NULL) || ((item->type & 0xFF) != cJSON_Number))
+    {
+        return 0;
+    }
+
+    return number_value(item);
+}
+
+CJSON_PUBLIC(const char *) cJSON_GetNumberText(const cJSON *item, size_t *length)
+{
+    if ((item == NULL) || ((item->type & 0xFF) != cJSON_Number) || !(item->type & cJSON_IsLazy))
+    {
+        return NULL;
+    }
+    if (length != NULL)
+    {
+        *length = (size_t)item->valueint;
+    }
+
+    return item->valuestring;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParsePacked(const char *value, size_t buffer_length)
+{
+    internal_hooks packing_hooks = global_hooks;
+    const unsigned char *end = NULL;
+    cJSON *item = NULL;
+
+    packing_hooks.pack_numbers = true;
+    item = parse((const unsigned char*)value, buffer_length, &end, false, false, &packing_hooks, NULL);
+    global_ep = (item == NULL) ? end : NULL;
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithError(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated, cJSON_ParseError *error)
+{
+    return parse((const unsigned char*)value, (value == NULL) ? 0 : strlen(value), (const unsigned char**)return_parse_end, require_null_terminated, false, &global_hooks, error);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithLimits(const char *value, size_t buffer_length, const cJSON_ParseLimits *limits, cJSON_ParseError *error)
+{
+    internal_hooks limited_hooks = global_hooks;
+    parse_budget budget;
+
+    if (limits == NULL)
+    {
+        return parse((const unsigned char*)value, buffer_length, NULL, true, false, &global_hooks, error);
+    }
+
+    memset(&budget, '\0', sizeof(budget));
+    budget.limits = limits;
+    limited_hooks.budget = &budget;
+
+    return parse((const unsigned char*)value, buffer_length, NULL, true, false, &limited_hooks, error);
+}
+
+CJSON_PUBLIC(const char *) cJSON_GetErrorMessage(int code)
+{
+    switch (code)
+    {
+        case cJSON_Error_None:
+            return "no error";
+        case cJSON_Error_OutOfMemory:
+            return "out of memory";
+        case cJSON_Error_UnexpectedEnd:
+            return "unexpected end of input";
+        case cJSON_Error_InvalidValue:
+            return "invalid value";
+        case cJSON_Error_InvalidNumber:
+            return "invalid number";
+        case cJSON_Error_InvalidEscape:
+            return "invalid escape sequence in string";
+        case cJSON_Error_InvalidUnicode:
+            return "invalid unicode escape sequence in string";
+        case cJSON_Error_ExpectedName:
+            return "expected a string as object member name";
+        case cJSON_Error_ExpectedColon:
+            return "expected ':' after object member name";
+        case cJSON_Error_ExpectedArrayEnd:
+            return "expected ',' or ']' in array";
+        case cJSON_Error_ExpectedObjectEnd:
+            return "expected ',' or '}' in object";
+        case cJSON_Error_TrailingCharacters:
+            return "unexpected characters after the end of the document";
+        case cJSON_Error_Aborted:
+            return "aborted by the handler";
+        case cJSON_Error_TooDeep:
+            return "arrays or objects are nested too deeply";
+        case cJSON_Error_InvalidUTF8:
+            return "invalid UTF-8 in string";
+        case cJSON_Error_File:
+            return "failed to read the file";
+        case cJSON_Error_TooManyBytes:
+            return "the document needs more memory than allowed";
+        case cJSON_Error_TooManyNodes:
+            return "the document has more values than allowed";
+        case cJSON_Error_StringTooLong:
+            return "a string or name is longer than allowed";
+        case cJSON_Error_Codec:
+            return "failed to decode the input";
+        default:
+            return "unknown error";
+    }
+}
+
+struct cJSON_File
+{
+    char *data;
+    size_t length;
+    /* if set, data is mapped, otherwise it was read into a buffer */
+    cJSON_bool mapped;
+};
+
+/* Read all of stream into a buffer of file, which is null terminated. */
+static cJSON_bool read_stream(cJSON_File * const file, FILE * const stream)
+{
+    size_t capacity = 4096;
+    size_t read_length = 0;
+    char *buffer = NULL;
+
+    file->data = (char*)global_hooks.allocate(capacity);
+    if (file->data == NULL)
+    {
+        return false;
+    }
+    for (;;)
+    {
+        read_length = fread(file->data + file->length, 1, capacity - file->length - 1, stream);
+        file->length += read_length;
+        if (read_length == 0)
+        {
+            break;
+        }
+        if ((capacity - file->length) > 1)
+        {
+            continue;
+        }
+
+        if (capacity > ((size_t)-1) / 2)
+        {
+            return false;
+        }
+        buffer = (char*)global_hooks.allocate(capacity * 2);
+        if (buffer == NULL)
+        {
+            return false;
+        }
+        memcpy(buffer, file->data, file->length);
+        global_hooks.deallocate(file->data);
+        file->data = buffer;
+        capacity *= 2;
+    }
+    file->data[file->length] = '\0';
+
+    return ferror(stream) == 0;
+}
+
+CJSON_PUBLIC(cJSON_File *) cJSON_OpenFile(const char *path)
+{
+    cJSON_File *file = NULL;
+    FILE *stream = NULL;
+
+    if (path == NULL)
+    {
+        return NULL;
+    }
+    file = (cJSON_File*)global_hooks.allocate(sizeof(cJSON_File));
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    file->data = NULL;
+    file->length = 0;
+    file->mapped = false;
+
+#ifdef CJSON_MMAP
+    {
+        struct stat status;
+        const int descriptor = open(path, O_RDONLY);
+        if (descriptor >= 0)
+        {
+            /* empty files can't be mapped, and neither can pipes and the like */
+            if ((fstat(descriptor, &status) == 0) && S_ISREG(status.st_mode) && (status.st_size > 0)
+                    && ((off_t)(size_t)status.st_size == status.st_size))
+            {
+                void *mapping = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                if (mapping != MAP_FAILED)
+                {
+                    file->data = (char*)mapping;
+                    file->length = (size_t)status.st_size;
+                    file->mapped = true;
+                }
+            }
+            close(descriptor);
+            if (file->mapped)
+            {
+                return file;
+            }
+        }
+    }
+#endif
+
+    stream = fopen(path, "rb");
+    if ((stream == NULL) || !read_stream(file, stream))
+    {
+        if (stream != NULL)
+        {
+            fclose(stream);
+        }
+        cJSON_CloseFile(file);
+        return NULL;
+    }
+    fclose(stream);
+
+    return file;
+}
+
+CJSON_PUBLIC(const char *) cJSON_GetFileData(const cJSON_File *file)
+{
+    return (file == NULL) ? NULL : file->data;
+}
+
+CJSON_PUBLIC(size_t) cJSON_GetFileLength(const cJSON_File *file)
+{
+    return (file == NULL) ? 0 : file->length;
+}
+
+CJSON_PUBLIC(void) cJSON_CloseFile(cJSON_File *file)
+{
+    if (file == NULL)
+    {
+        return;
+    }
+#ifdef CJSON_MMAP
+    if (file->mapped)
+    {
+        munmap(file->data, file->length);
+        global_hooks.deallocate(file);
+        return;
+    }
+#endif
+    if (file->data != NULL)
+    {
+        global_hooks.deallocate(file->data);
+    }
+    global_hooks.deallocate(file);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseFile(const char *path, cJSON_ParseError *error)
+{
+    cJSON_File *file = cJSON_OpenFile(path);
+    cJSON *item = NULL;
+
+    if (file == NULL)
+    {
+        if (error != NULL)
+        {
+            memset(error, '\0', sizeof(cJSON_ParseError));
+            error->code = cJSON_Error_File;
+        }
+        return NULL;
+    }
+
+    item = parse((const unsigned char*)file->data, file->length, NULL, true, false, &global_hooks, error);
+    cJSON_CloseFile(file);
+
+    return item;
+}
+
+/* Default options for cJSON_Parse */
+CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value)
+{
+    return cJSON_ParseWithOpts(value, 0, 0);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithLength(const char *value, size_t buffer_length)
+{
+    return cJSON_ParseWithLengthOpts(value, buffer_length, 0, 0);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithArenaOpts(cJSON_Arena *arena, const char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    internal_hooks arena_hooks;
+    const unsigned char *end = NULL;
+    cJSON *item = NULL;
+
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    arena_hooks = arena->hooks;
+    arena_hooks.arena = arena;
+
+    item = parse((const unsigned char*)value, (value == NULL) ? 0 : strlen(value), &end, require_null_terminated, false, &arena_hooks, NULL);
+    if (return_parse_end != NULL)
+    {
+        *return_parse_end = (const char*)end;
+    }
+    else
+    {
+        global_ep = (item == NULL) ? end : NULL;
+    }
+
+    return item;
+}
+
+/* Reusable document */
+struct cJSON_Document
+{
+    cJSON_Arena *arena;
+    /* the most bytes of blocks that are kept when the document is reset */
+    size_t retain_limit;
+};
+
+CJSON_PUBLIC(cJSON_Document *) cJSON_CreateDocument(size_t block_size, size_t retain_limit)
+{
+    cJSON_Document *document = (cJSON_Document*)global_hooks.allocate(sizeof(cJSON_Document));
+
+    if (document == NULL)
+    {
+        return NULL;
+    }
+
+    document->arena = cJSON_CreateArena(block_size);
+    if (document->arena == NULL)
+    {
+        global_hooks.deallocate(document);
+        return NULL;
+    }
+    document->retain_limit = retain_limit;
+
+    return document;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseInto(cJSON_Document *document, const char *value, size_t buffer_length, cJSON_ParseError *error)
+{
+    internal_hooks arena_hooks;
+
+    if (document == NULL)
+    {
+        return NULL;
+    }
+
+    cJSON_ResetDocument(document);
+    arena_hooks = document->arena->hooks;
+    arena_hooks.arena = document->arena;
+
+    return parse((const unsigned char*)value, buffer_length, NULL, true, false, &arena_hooks, error);
+}
+
+CJSON_PUBLIC(void) cJSON_ResetDocument(cJSON_Document *document)
+{
+    if (document == NULL)
+    {
+        return;
+    }
+
+    arena_retain(document->arena, document->retain_limit);
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteDocument(cJSON_Document *document)
+{
+    if (document == NULL)
+    {
+        return;
+    }
+
+    cJSON_DeleteArena(document->arena);
+    global_hooks.deallocate(document);
+}
+
+CJSON_PUBLIC(size_t) cJSON_GetDocumentMemoryUsage(const cJSON_Document *document)
+{
+    if (document == NULL)
+    {
+        return 0;
+    }
+
+    return sizeof(cJSON_Document) + cJSON_GetArenaMemoryUsage(document->arena);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithKeyTable(cJSON_KeyTable *table, const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    internal_hooks key_hooks;
+    const unsigned char *end = NULL;
+    cJSON *item = NULL;
+
+    if (table == NULL)
+    {
+        return NULL;
+    }
+
+    key_hooks = global_hooks;
+    key_hooks.keys = table;
+
+    item = parse((const unsigned char*)value, buffer_length, &end, require_null_terminated, false, &key_hooks, NULL);
+    if (return_parse_end != NULL)
+    {
+        *return_parse_end = (const char*)end;
+    }
+    else
+    {
+        global_ep = (item == NULL) ? end : NULL;
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithArena(cJSON_Arena *arena, const char *value)
+{
+    return cJSON_ParseWithArenaOpts(arena, value, 0, 0);
+}
+
+CJSON_PUBLIC(size_t) cJSON_ParseMany(const char *value, size_t buffer_length, cJSON_Arena *arena, cJSON_DocumentCallback callback, void *user_data, cJSON_ParseError *error)
+{
+    internal_hooks hooks = global_hooks;
+    parse_context context;
+    const unsigned char *input = (const unsigned char*)value;
+    cJSON *document = NULL;
+    size_t count = 0;
+
+    if (arena != NULL)
+    {
+        hooks = arena->hooks;
+        hooks.arena = arena;
+    }
+
+    /* one context for the whole buffer, so error positions are relative to its start */
+    context.hooks = &hooks;
+    context.error_position = NULL;
+    context.error_code = cJSON_Error_None;
+    context.inline_item = NULL;
+    context.end = input + buffer_length;
+
+    if ((value == NULL) || (callback == NULL))
+    {
+        parse_error(&context, NULL, cJSON_Error_InvalidValue);
+        goto end;
+    }
+
+    for (;;)
+    {
+        /* documents are separated by whitespace (if at all), a '\0' ends the input like the end of the buffer */
+        input = skip_whitespace(&context, input);
+        if (char_at(&context, input) == '\0')
+        {
+            break;
+        }
+
+        document = cJSON_New_Item(&hooks);
+        if (document == NULL)
+        {
+            parse_error(&context, input, cJSON_Error_OutOfMemory);
+            break;
+        }
+        context.inline_item = document;
+        input = parse_value(document, input, &context);
+        if (input == NULL)
+        {
+            delete_item(document, &hooks);
+            break;
+        }
+
+        count++;
+        if (!callback(document, user_data))
+        {
+            parse_error(&context, input, cJSON_Error_Aborted);
+            break;
+        }
+    }
+
+end:
+    if (error != NULL)
+    {
+        fill_parse_error(error, (const unsigned char*)value, &context);
+    }
+
+    return count;
+}
+
+/* A range of array elements that is parsed by one task of cJSON_ParseParallel */
+typedef struct
+{
+    const unsigned char *start; /* behind the '[' or ',' before the first element */
+    cJSON *first;
+    cJSON *last;
+    parse_context context; /* end is behind the ',' or ']' that follows the last element */
+} parse_range;
+
+/* Find the closing bracket of the array at input and split its elements into at most *count ranges of similar size at
+ * top level commas. Returns the closing bracket and sets *count to the number of ranges. */
+static const unsigned char *split_array(const unsigned char * const input, parse_range * const ranges, size_t * const count, parse_context * const context)
+{
+    const size_t step = (size_t)(context->end - input) / *count;
+    const unsigned char *pointer = NULL;
+    size_t depth = 0;
+    size_t found = 1;
+
+    ranges[0].start = input + 1;
+    for (pointer = input; pointer < context->end; pointer++)
+    {
+        switch (*pointer)
+        {
+            case '[':
+            case '{':
+                depth++;
+                break;
+
+            case ']':
+            case '}':
+                /* mismatched brackets are found when the elements are parsed */
+                depth--;
+                if (depth == 0)
+                {
+                    *count = found;
+                    return pointer;
+                }
+                break;
+
+            case ',':
+                if ((depth == 1) && (found < *count) && ((size_t)(pointer - input) >= (found * step)))
+                {
+                    ranges[found].start = pointer + 1;
+                    found++;
+                }
+                break;
+
+            case '\"':
+                pointer = skip_string(pointer, context);
+                if (pointer == NULL)
+                {
+                    return NULL;
+                }
+                /* at the closing quote */
+                pointer--;
+                break;
+
+            case '\0':
+                return parse_error(context, pointer, cJSON_Error_UnexpectedEnd);
+
+            default:
+                break;
+        }
+    }
+
+    return parse_error(context, pointer, cJSON_Error_UnexpectedEnd);
+}
+
+/* Task of cJSON_ParseParallel: parse the elements of one range into a list. */
+static void parse_range_task(void *task_data, size_t index)
+{
+    parse_range * const range = &((parse_range*)task_data)[index];
+    parse_context * const context = &range->context;
+    const unsigned char *input = range->start;
+    cJSON *item = NULL;
+
+    for (;;)
+    {
+        item = cJSON_New_Item(context->hooks);
+        if (item == NULL)
+        {
+            parse_error(context, input, cJSON_Error_OutOfMemory);
+            return;
+        }
+        context->inline_item = item;
+        if (range->last == NULL)
+        {
+            range->first = item;
+        }
+        else
+        {
+            range->last->next = item;
+            item->prev = range->last;
+        }
+        range->first->prev = item;
+        range->last = item;
+
+        input = parse_value(item, skip_whitespace(context, input), context);
+        input = skip_whitespace(context, input);
+        if (input == NULL)
+        {
+            return;
+        }
+        if (input == (context->end - 1))
+        {
+            return; /* reached the next range */
+        }
+        if (char_at(context, input) != ',')
+        {
+            parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedArrayEnd);
+            return;
+        }
+        input++;
+    }
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseParallel(const char *value, size_t buffer_length, const cJSON_Executor *executor, size_t tasks, cJSON_ParseError *error)
+{
+    parse_context context;
+    parse_range *ranges = NULL;
+    cJSON *array = NULL;
+    const unsigned char *input = (const unsigned char*)value;
+    const unsigned char *closing = NULL;
+    size_t count = tasks;
+    size_t i = 0;
+
+    context.hooks = &global_hooks;
+    context.error_position = NULL;
+    context.error_code = cJSON_Error_None;
+    context.inline_item = NULL;
+    context.end = input + buffer_length;
+
+    input = skip_whitespace(&context, input);
+    if ((value == NULL) || (executor == NULL) || (executor->run == NULL) || (tasks < 2) || (char_at(&context, input) != '[')
+            || (tasks > ((size_t)-1 / sizeof(parse_range))))
+    {
+        /* nothing to split */
+        return parse((const unsigned char*)value, buffer_length, NULL, true, false, &global_hooks, error);
+    }
+
+    ranges = (parse_range*)global_hooks.allocate(tasks * sizeof(parse_range));
+    if (ranges == NULL)
+    {
+        parse_error(&context, input, cJSON_Error_OutOfMemory);
+        goto fail;
+    }
+    memset(ranges, '\0', tasks * sizeof(parse_range));
+
+    closing = split_array(input, ranges, &count, &context);
+    if (closing == NULL)
+    {
+        goto fail;
+    }
+
+    array = cJSON_New_Item(&global_hooks);
+    if (array == NULL)
+    {
+        parse_error(&context, input, cJSON_Error_OutOfMemory);
+        goto fail;
+    }
+    array->type = cJSON_Array;
+
+    if (skip_whitespace(&context, input + 1) != closing)
+    {
+        for (i = 0; i < count; i++)
+        {
+            ranges[i].context.hooks = &global_hooks;
+            ranges[i].context.error_position = NULL;
+            ranges[i].context.error_code = cJSON_Error_None;
+            ranges[i].context.inline_item = NULL;
+            ranges[i].context.end = ((i + 1) < count) ? ranges[i + 1].start : (closing + 1);
+        }
+
+        executor->run(parse_range_task, ranges, count, executor->executor_data);
+
+        /* the first failed range has the same error as parsing everything at once would have */
+        for (i = 0; i < count; i++)
+        {
+            if (ranges[i].context.error_code != cJSON_Error_None)
+            {
+                context.error_position = ranges[i].context.error_position;
+                context.error_code = ranges[i].context.error_code;
+                goto fail;
+            }
+        }
+
+        /* link the ranges together */
+        for (i = 0; i < count; i++)
+        {
+            if (array->child == NULL)
+            {
+                array->child = ranges[i].first;
+            }
+            else
+            {
+                ranges[i - 1].last->next = ranges[i].first;
+                ranges[i].first->prev = ranges[i - 1].last;
+            }
+            array->child->prev = ranges[i].last;
+            ranges[i].first = NULL;
+        }
+    }
+
+    if (*closing != ']')
+    {
+        parse_error(&context, closing, cJSON_Error_ExpectedArrayEnd);
+        goto fail;
+    }
+    input = skip_whitespace(&context, closing + 1);
+    if (char_at(&context, input) != '\0')
+    {
+        parse_error(&context, input, cJSON_Error_TrailingCharacters);
+        goto fail;
+    }
+
+    global_hooks.deallocate(ranges);
+    if (error != NULL)
+    {
+        fill_parse_error(error, (const unsigned char*)value, &context);
+    }
+
+    return array;
+
+fail:
+    if (ranges != NULL)
+    {
+        for (i = 0; i < count; i++)
+        {
+            if (ranges[i].first != NULL)
+            {
+                delete_item(ranges[i].first, &global_hooks);
+            }
+        }
+        global_hooks.deallocate(ranges);
+    }
+    if (array != NULL)
+    {
+        delete_item(array, &global_hooks);
+    }
+    if (error != NULL)
+    {
+        fill_parse_error(error, (const unsigned char*)value, &context);
+    }
+
+    return NULL;
+}
+
+/* what the event parser expects next, outside of strings, numbers and literals */
+typedef enum
+{
+    sax_value,
+    sax_value_or_array_end,
+    sax_name,
+    sax_name_or_object_end,
+    sax_colon,
+    sax_comma_or_end
+} sax_state;
+
+/* the token that is currently being collected */
+typedef enum
+{
+    sax_no_token,
+    sax_string_token,
+    sax_name_token,
+    sax_number_token,
+    sax_literal_token
+} sax_token;
+
+struct cJSON_SAXParser
+{
+    cJSON_SAXHandler handler;
+    void *context;
+    sax_state state;
+    /* one '[' or '{' for every open array or object */
+    unsigned char *stack;
+    size_t depth;
+    size_t stack_size;
+    /* strings and numbers are collected here so they can be converted by parse_string and parse_number */
+    sax_token token;
+    unsigned char *token_buffer;
+    size_t token_length;
+    size_t token_size;
+    cJSON_bool escaped;
+    /* type and remaining characters of true, false or null */
+    int literal_type;
+    const char *literal;
+    /* where the current token started */
+    size_t token_position;
+    size_t token_line;
+    size_t token_column;
+    /* position of the next character of the input */
+    size_t position;
+    size_t line;
+    size_t line_start;
+    size_t documents;
+    cJSON_ParseError error;
+};
+
+#define SAX_INITIAL_SIZE 64
+
+static cJSON_bool sax_fail(cJSON_SAXParser * const parser, const size_t position, const int code)
+{
+    parser->error.code = code;
+    parser->error.position = position;
+    parser->error.line = parser->line;
+    parser->error.column = position - parser->line_start + 1;
+
+    return false;
+}
+
+/* fail inside of the current token */
+static cJSON_bool sax_token_fail(cJSON_SAXParser * const parser, const size_t offset, const int code)
+{
+    parser->error.code = code;
+    parser->error.position = parser->token_position + offset;
+    parser->error.line = parser->token_line;
+    parser->error.column = parser->token_column + offset;
+
+    return false;
+}
+
+/* double the size of a buffer until it can hold needed bytes */
+static cJSON_bool sax_reserve(unsigned char ** const buffer, size_t * const size, const size_t needed)
+{
+    unsigned char *new_buffer = NULL;
+    size_t new_size = (*size == 0) ? SAX_INITIAL_SIZE : *size;
+
+    if (needed <= *size)
+    {
+        return true;
+    }
+
+    while (new_size < needed)
+    {
+        if (new_size > (((size_t)-1) / 2))
+        {
+            return false;
+        }
+        new_size *= 2;
+    }
+
+    new_buffer = (unsigned char*)global_hooks.allocate(new_size);
+    if (new_buffer == NULL)
+    {
+        return false;
+    }
+    if (*buffer != NULL)
+    {
+        memcpy(new_buffer, *buffer, *size);
+        global_hooks.deallocate(*buffer);
+    }
+    *buffer = new_buffer;
+    *size = new_size;
+
+    return true;
+}
+
+static cJSON_bool sax_append(cJSON_SAXParser * const parser, const unsigned char * const data, const size_t length)
+{
+    if (!sax_reserve(&parser->token_buffer, &parser->token_size, parser->token_length + length))
+    {
+        return sax_token_fail(parser, parser->token_length, cJSON_Error_OutOfMemory);
+    }
+    memcpy(parser->token_buffer + parser->token_length, data, length);
+    parser->token_length += length;
+
+    return true;
+}
+
+/* a value is complete, find out what comes next */
+static void sax_value_done(cJSON_SAXParser * const parser)
+{
+    if (parser->depth == 0)
+    {
+        /* another document may follow */
+        parser->state = sax_value;
+        parser->documents++;
+        return;
+    }
+
+    parser->state = sax_comma_or_end;
+}
+
+static cJSON_bool sax_emit_value(cJSON_SAXParser * const parser, const cJSON * const value)
+{
+    if ((parser->handler.value != NULL) && !parser->handler.value(value, parser->context))
+    {
+        return sax_token_fail(parser, 0, cJSON_Error_Aborted);
+    }
+    sax_value_done(parser);
+
+    return true;
+}
+
+/* convert the collected string or number and pass it to the handler */
+static cJSON_bool sax_finish_token(cJSON_SAXParser * const parser)
+{
+    parse_context context = { &global_hooks, NULL, cJSON_Error_None, NULL, NULL };
+    cJSON item[1];
+    const unsigned char *end = NULL;
+    cJSON_bool success = true;
+    sax_token token = parser->token;
+
+    parser->token = sax_no_token;
+    context.end = parser->token_buffer + parser->token_length;
+    memset(item, '\0', sizeof(item));
+
+    if (token == sax_number_token)
+    {
+        end = parse_number(item, parser->token_buffer, &context);
+        if (end != context.end)
+        {
+            return sax_token_fail(parser, (end == NULL) ? 0 : (size_t)(end - parser->token_buffer), cJSON_Error_InvalidNumber);
+        }
+
+        return sax_emit_value(parser, item);
+    }
+
+    if (parse_string(item, parser->token_buffer, &context) == NULL)
+    {
+        return sax_token_fail(parser, (size_t)(context.error_position - parser->token_buffer), context.error_code);
+    }
+
+    if (token == sax_name_token)
+    {
+        if ((parser->handler.key != NULL) && !parser->handler.key(item->valuestring, parser->context))
+        {
+            success = sax_token_fail(parser, 0, cJSON_Error_Aborted);
+        }
+        parser->state = sax_colon;
+    }
+    else
+    {
+        success = sax_emit_value(parser, item);
+    }
+    global_hooks.deallocate(item->valuestring);
+
+    return success;
+}
+
+static void sax_start_token(cJSON_SAXParser * const parser, const sax_token token)
+{
+    parser->token = token;
+    parser->token_length = 0;
+    parser->escaped = false;
+    parser->token_position = parser->position;
+    parser->token_line = parser->line;
+    parser->token_column = parser->position - parser->line_start + 1;
+}
+
+static cJSON_bool sax_open(cJSON_SAXParser * const parser, const unsigned char container)
+{
+    cJSON_bool (*callback)(void *context) = (container == '[') ? parser->handler.start_array : parser->handler.start_object;
+
+    if (parser->depth >= CJSON_NESTING_LIMIT)
+    {
+        return sax_fail(parser, parser->position, cJSON_Error_TooDeep);
+    }
+    if (!sax_reserve(&parser->stack, &parser->stack_size, parser->depth + 1))
+    {
+        return sax_fail(parser, parser->position, cJSON_Error_OutOfMemory);
+    }
+    parser->stack[parser->depth++] = container;
+
+    if ((callback != NULL) && !callback(parser->context))
+    {
+        return sax_fail(parser, parser->position, cJSON_Error_Aborted);
+    }
+    parser->state = (container == '[') ? sax_value_or_array_end : sax_name_or_object_end;
+
+    return true;
+}
+
+static cJSON_bool sax_close(cJSON_SAXParser * const parser)
+{
+    cJSON_bool (*callback)(void *context) = (parser->stack[parser->depth - 1] == '[') ? parser->handler.end_array : parser->handler.end_object;
+
+    parser->depth--;
+    if ((callback != NULL) && !callback(parser->context))
+    {
+        return sax_fail(parser, parser->position, cJSON_Error_Aborted);
+    }
+    sax_value_done(parser);
+
+    return true;
+}
+
+static cJSON_bool sax_start_value(cJSON_SAXParser * const parser, const unsigned char character)
+{
+    switch (character)
+    {
+        case '{':
+        case '[':
+            return sax_open(parser, character);
+
+        case '\"':
+            sax_start_token(parser, sax_string_token);
+            return sax_append(parser, &character, 1);
+
+        case 't':
+            sax_start_token(parser, sax_literal_token);
+            parser->literal_type = cJSON_True;
+            parser->literal = "rue";
+            return true;
+
+        case 'f':
+            sax_start_token(parser, sax_literal_token);
+            parser->literal_type = cJSON_False;
+            parser->literal = "alse";
+            return true;
+
+        case 'n':
+            sax_start_token(parser, sax_literal_token);
+            parser->literal_type = cJSON_NULL;
+            parser->literal = "ull";
+            return true;
+
+        default:
+            if ((character == '-') || ((character >= '0') && (character <= '9')))
+            {
+                sax_start_token(parser, sax_number_token);
+                return sax_append(parser, &character, 1);
+            }
+
+            return sax_fail(parser, parser->position, (character == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_InvalidValue);
+    }
+}
+
+/* the literal is complete */
+static cJSON_bool sax_finish_literal(cJSON_SAXParser * const parser)
+{
+    cJSON item[1];
+    memset(item, '\0', sizeof(item));
+
+    parser->token = sax_no_token;
+    item->type = parser->literal_type;
+    item->valueint = (parser->literal_type == cJSON_True) ? 1 : 0;
+
+    return sax_emit_value(parser, item);
+}
+
+/* Consume a character outside of tokens. */
+static cJSON_bool sax_structure(cJSON_SAXParser * const parser, const unsigned char character)
+{
+    /* same whitespace as skip_whitespace */
+    if ((character != '\0') && (character <= 32))
+    {
+        if (character == '\n')
+        {
+            parser->line++;
+            parser->line_start = parser->position + 1;
+        }
+        return true;
+    }
+
+    switch (parser->state)
+    {
+        case sax_value_or_array_end:
+            if (character == ']')
+            {
+                return sax_close(parser);
+            }
+            return sax_start_value(parser, character);
+
+        case sax_value:
+            return sax_start_value(parser, character);
+
+        case sax_name_or_object_end:
+            if (character == '}')
+            {
+                return sax_close(parser);
+            }
+            if (character == '\"')
+            {
+                sax_start_token(parser, sax_name_token);
+                return sax_append(parser, &character, 1);
+            }
+            return sax_fail(parser, parser->position, cJSON_Error_ExpectedName);
+
+        case sax_name:
+            if (character == '\"')
+            {
+                sax_start_token(parser, sax_name_token);
+                return sax_append(parser, &character, 1);
+            }
+            return sax_fail(parser, parser->position, cJSON_Error_ExpectedName);
+
+        case sax_colon:
+            if (character == ':')
+            {
+                parser->state = sax_value;
+                return true;
+            }
+            return sax_fail(parser, parser->position, cJSON_Error_ExpectedColon);
+
+        case sax_comma_or_end:
+            if (parser->stack[parser->depth - 1] == '[')
+            {
+                if (character == ',')
+                {
+                    parser->state = sax_value;
+                    return true;
+                }
+                if (character == ']')
+                {
+                    return sax_close(parser);
+                }
+                return sax_fail(parser, parser->position, cJSON_Error_ExpectedArrayEnd);
+            }
+            if (character == ',')
+            {
+                parser->state = sax_name;
+                return true;
+            }
+            if (character == '}')
+            {
+                return sax_close(parser);
+            }
+            return sax_fail(parser, parser->position, cJSON_Error_ExpectedObjectEnd);
+
+        default:
+            return sax_fail(parser, parser->position, cJSON_Error_InvalidValue);
+    }
+}
+
+CJSON_PUBLIC(cJSON_SAXParser *) cJSON_CreateSAXParser(const cJSON_SAXHandler *handler, void *context)
+{
+    cJSON_SAXParser *parser = NULL;
+
+    if (handler == NULL)
+    {
+        return NULL;
+    }
+
+    parser = (cJSON_SAXParser*)global_hooks.allocate(sizeof(cJSON_SAXParser));
+    if (parser == NULL)
+    {
+        return NULL;
+    }
+    memset(parser, '\0', sizeof(cJSON_SAXParser));
+
+    parser->handler = *handler;
+    parser->context = context;
+    parser->state = sax_value;
+    parser->token = sax_no_token;
+    parser->line = 1;
+
+    return parser;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_SAXParserFeed(cJSON_SAXParser *parser, const char *data, size_t length)
+{
+    const unsigned char *pointer = (const unsigned char*)data;
+    const unsigned char *end = pointer + length;
+
+    if ((parser == NULL) || ((data == NULL) && (length > 0)) || (parser->error.code != cJSON_Error_None))
+    {
+        return false;
+    }
+
+    while (pointer < end)
+    {
+        switch (parser->token)
+        {
+            case sax_string_token:
+            case sax_name_token:
+            {
+                const unsigned char *run_end = NULL;
+                const unsigned char *newline = NULL;
+                cJSON_bool closed = false;
+
+                if (parser->escaped)
+                {
+                    parser->escaped = false;
+                    run_end = pointer + 1;
+                }
+                else
+                {
+                    /* everything up to the next quote, backslash or '\0' goes into the token at once */
+                    run_end = find_string_special(pointer, end);
+                    if (run_end < end)
+                    {
+                        if (*run_end == '\0')
+                        {
+                            parser->position += (size_t)(run_end - pointer);
+                            return sax_fail(parser, parser->position, cJSON_Error_UnexpectedEnd);
+                        }
+                        parser->escaped = (*run_end == '\\');
+                        closed = (*run_end == '\"');
+                        run_end++;
+                    }
+                }
+
+                if (!sax_append(parser, pointer, (size_t)(run_end - pointer)))
+                {
+                    return false;
+                }
+                for (newline = pointer; (newline = (const unsigned char*)memchr(newline, '\n', (size_t)(run_end - newline))) != NULL; newline++)
+                {
+                    parser->line++;
+                    parser->line_start = parser->position + (size_t)(newline - pointer) + 1;
+                }
+                parser->position += (size_t)(run_end - pointer);
+                pointer = run_end;
+
+                if (closed && !sax_finish_token(parser))
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            case sax_number_token:
+                switch (*pointer)
+                {
+                    case '0':
+                    case '1':
+                    case '2':
+                    case '3':
+                    case '4':
+                    case '5':
+                    case '6':
+                    case '7':
+                    case '8':
+                    case '9':
+                    case '+':
+                    case '-':
+                    case 'e':
+                    case 'E':
+                    case '.':
+                        if (!sax_append(parser, pointer, 1))
+                        {
+                            return false;
+                        }
+                        pointer++;
+                        parser->position++;
+                        continue;
+
+                    default:
+                        /* the character after the number still has to be processed */
+                        if (!sax_finish_token(parser))
+                        {
+                            return false;
+                        }
+                        continue;
+                }
+
+            case sax_literal_token:
+                if (*pointer != (unsigned char)*parser->literal)
+                {
+                    return sax_fail(parser, parser->position, cJSON_Error_InvalidValue);
+                }
+                parser->literal++;
+                pointer++;
+                parser->position++;
+                if ((*parser->literal == '\0') && !sax_finish_literal(parser))
+                {
+                    return false;
+                }
+                continue;
+
+            default:
+                if (!sax_structure(parser, *pointer))
+                {
+                    return false;
+                }
+                pointer++;
+                parser->position++;
+                continue;
+        }
+    }
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_SAXParserFinish(cJSON_SAXParser *parser)
+{
+    if ((parser == NULL) || (parser->error.code != cJSON_Error_None))
+    {
+        return false;
+    }
+
+    /* only numbers can end with the input */
+    if ((parser->token == sax_number_token) && !sax_finish_token(parser))
+    {
+        return false;
+    }
+
+    if ((parser->token != sax_no_token) || (parser->depth > 0) || (parser->documents == 0))
+    {
+        return sax_fail(parser, parser->position, cJSON_Error_UnexpectedEnd);
+    }
+
+    return true;
+}
+
+CJSON_PUBLIC(void) cJSON_SAXParserGetError(const cJSON_SAXParser *parser, cJSON_ParseError *error)
+{
+    if ((parser == NULL) || (error == NULL))
+    {
+        return;
+    }
+
+    *error = parser->error;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteSAXParser(cJSON_SAXParser *parser)
+{
+    if (parser == NULL)
+    {
+        return;
+    }
+
+    if (parser->stack != NULL)
+    {
+        global_hooks.deallocate(parser->stack);
+    }
+    if (parser->token_buffer != NULL)
+    {
+        global_hooks.deallocate(parser->token_buffer);
+    }
+    global_hooks.deallocate(parser);
+}
+
+struct cJSON_StreamParser
+{
+    cJSON_SAXParser *events;
+    /* the arrays and objects that are still open, frame->container */
+    nesting_stack stack;
+    /* name of the next member, taken by the item that follows */
+    char *name;
+    /* the document that is being built */
+    cJSON *root;
+    /* complete documents that weren't taken yet, linked by next */
+    cJSON *first;
+    cJSON *last;
+    size_t documents;
+    /* set if only one document may be parsed, trailing is set when another one starts */
+    cJSON_bool single;
+    cJSON_bool trailing;
+};
+
+/* Add a complete item to the open container or the finished documents. */
+static void stream_add(cJSON_StreamParser * const parser, cJSON * const item)
+{
+    cJSON *container = NULL;
+
+    if (parser->stack.depth == 0)
+    {
+        parser->documents++;
+        if (parser->last == NULL)
+        {
+            parser->first = item;
+        }
+        else
+        {
+            parser->last->next = item;
+        }
+        parser->last = item;
+        return;
+    }
+
+    container = parser->stack.frames[parser->stack.depth - 1].container;
+    if ((container->type & 0xFF) == cJSON_Object)
+    {
+        item->string = parser->name;
+        parser->name = NULL;
+    }
+
+    cJSON_AddItemToArray(container, item);
+}
+
+/* Returns false if a document starts where only one may be parsed. */
+static cJSON_bool stream_may_start(cJSON_StreamParser * const parser)
+{
+    if (parser->single && (parser->stack.depth == 0) && (parser->documents > 0))
+    {
+        parser->trailing = true;
+        return false;
+    }
+
+    return true;
+}
+
+static cJSON_bool stream_open(cJSON_StreamParser * const parser, cJSON * const container)
+{
+    nesting_frame *frame = NULL;
+
+    if (container == NULL)
+    {
+        return false;
+    }
+    if (parser->stack.depth == 0)
+    {
+        parser->root = container;
+    }
+    else
+    {
+        stream_add(parser, container);
+    }
+
+    frame = nesting_push(&parser->stack);
+    if (frame == NULL)
+    {
+        return false;
+    }
+    frame->container = container;
+
+    return true;
+}
+
+static cJSON_bool stream_start_object(void *context)
+{
+    return stream_may_start((cJSON_StreamParser*)context) && stream_open((cJSON_StreamParser*)context, cJSON_CreateObject());
+}
+
+static cJSON_bool stream_start_array(void *context)
+{
+    return stream_may_start((cJSON_StreamParser*)context) && stream_open((cJSON_StreamParser*)context, cJSON_CreateArray());
+}
+
+static cJSON_bool stream_end(void *context)
+{
+    cJSON_StreamParser * const parser = (cJSON_StreamParser*)context;
+
+    parser->stack.depth--;
+    if (parser->stack.depth == 0)
+    {
+        stream_add(parser, parser->root);
+        parser->root = NULL;
+    }
+
+    return true;
+}
+
+static cJSON_bool stream_key(const char *name, void *context)
+{
+    cJSON_StreamParser * const parser = (cJSON_StreamParser*)context;
+
+    if (parser->name != NULL)
+    {
+        global_hooks.deallocate(parser->name);
+    }
+    parser->name = (char*)cJSON_strdup((const unsigned char*)name, &global_hooks);
+
+    return parser->name != NULL;
+}
+
+static cJSON_bool stream_value(const cJSON *item, void *context)
+{
+    cJSON_StreamParser * const parser = (cJSON_StreamParser*)context;
+    cJSON *copy = NULL;
+
+    if (!stream_may_start(parser))
+    {
+        return false;
+    }
+    copy = cJSON_Duplicate(item, false);
+    if (copy == NULL)
+    {
+        return false;
+    }
+    stream_add(parser, copy);
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_StreamParser *) cJSON_CreateStreamParser(void)
+{
+    cJSON_SAXHandler handler;
+    cJSON_StreamParser *parser = (cJSON_StreamParser*)global_hooks.allocate(sizeof(cJSON_StreamParser));
+
+    if (parser == NULL)
+    {
+        return NULL;
+    }
+    memset(parser, '\0', sizeof(cJSON_StreamParser));
+    nesting_init(&parser->stack, &global_hooks);
+
+    handler.start_object = stream_start_object;
+    handler.end_object = stream_end;
+    handler.start_array = stream_start_array;
+    handler.end_array = stream_end;
+    handler.key = stream_key;
+    handler.value = stream_value;
+    parser->events = cJSON_CreateSAXParser(&handler, parser);
+    if (parser->events == NULL)
+    {
+        global_hooks.deallocate(parser);
+        return NULL;
+    }
+
+    return parser;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_StreamParserFeed(cJSON_StreamParser *parser, const char *data, size_t length)
+{
+    if (parser == NULL)
+    {
+        return false;
+    }
+
+    return cJSON_SAXParserFeed(parser->events, data, length);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_StreamParserFinish(cJSON_StreamParser *parser)
+{
+    if (parser == NULL)
+    {
+        return false;
+    }
+
+    return cJSON_SAXParserFinish(parser->events);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_StreamParserNext(cJSON_StreamParser *parser)
+{
+    cJSON *document = NULL;
+
+    if ((parser == NULL) || (parser->first == NULL))
+    {
+        return NULL;
+    }
+
+    document = parser->first;
+    parser->first = document->next;
+    if (parser->first == NULL)
+    {
+        parser->last = NULL;
+    }
+    document->next = NULL;
+
+    return document;
+}
+
+CJSON_PUBLIC(void) cJSON_StreamParserGetError(const cJSON_StreamParser *parser, cJSON_ParseError *error)
+{
+    if ((parser == NULL) || (error == NULL))
+    {
+        return;
+    }
+
+    cJSON_SAXParserGetError(parser->events, error);
+    if (parser->trailing && (error->code == cJSON_Error_Aborted))
+    {
+        error->code = cJSON_Error_TrailingCharacters;
+    }
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteStreamParser(cJSON_StreamParser *parser)
+{
+    if (parser == NULL)
+    {
+        return;
+    }
+
+    /* the documents that weren't taken are one chain, cJSON_Delete frees all of it */
+    cJSON_Delete(parser->first);
+    cJSON_Delete(parser->root);
+    if (parser->name != NULL)
+    {
+        global_hooks.deallocate(parser->name);
+    }
+    nesting_free(&parser->stack);
+    cJSON_DeleteSAXParser(parser->events);
+    global_hooks.deallocate(parser);
+}
+
+struct cJSON_ParseState
+{
+    cJSON_StreamParser *stream;
+    const char *input;
+    size_t length;
+    size_t offset;
+    int status;
+};
+
+CJSON_PUBLIC(cJSON_ParseState *) cJSON_CreateParseState(const char *value, size_t buffer_length)
+{
+    cJSON_ParseState *state = NULL;
+    const char *end = NULL;
+
+    if (value == NULL)
+    {
+        return NULL;
+    }
+
+    state = (cJSON_ParseState*)global_hooks.allocate(sizeof(cJSON_ParseState));
+    if (state == NULL)
+    {
+        return NULL;
+    }
+    state->stream = cJSON_CreateStreamParser();
+    if (state->stream == NULL)
+    {
+        global_hooks.deallocate(state);
+        return NULL;
+    }
+    state->stream->single = true;
+
+    /* the input ends at a '\0' like it does for cJSON_ParseWithLength */
+    end = (const char*)memchr(value, '\0', buffer_length);
+    state->input = value;
+    state->length = (end != NULL) ? (size_t)(end - value) : buffer_length;
+    state->offset = 0;
+    state->status = cJSON_Step_More;
+
+    return state;
+}
+
+CJSON_PUBLIC(int) cJSON_ParseStep(cJSON_ParseState *state, size_t max_bytes)
+{
+    size_t chunk = 0;
+
+    if (state == NULL)
+    {
+        return cJSON_Step_Failed;
+    }
+    if (state->status != cJSON_Step_More)
+    {
+        return state->status;
+    }
+
+    chunk = state->length - state->offset;
+    if (max_bytes == 0)
+    {
+        max_bytes = 1; /* always make progress */
+    }
+    if (chunk > max_bytes)
+    {
+        chunk = max_bytes;
+    }
+    if ((chunk > 0) && !cJSON_StreamParserFeed(state->stream, state->input + state->offset, chunk))
+    {
+        state->status = cJSON_Step_Failed;
+        return state->status;
+    }
+    state->offset += chunk;
+
+    if (state->offset == state->length)
+    {
+        state->status = cJSON_StreamParserFinish(state->stream) ? cJSON_Step_Done : cJSON_Step_Failed;
+    }
+
+    return state->status;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseStateTakeResult(cJSON_ParseState *state)
+{
+    if ((state == NULL) || (state->status != cJSON_Step_Done))
+    {
+        return NULL;
+    }
+
+    return cJSON_StreamParserNext(state->stream);
+}
+
+CJSON_PUBLIC(void) cJSON_ParseStateGetError(const cJSON_ParseState *state, cJSON_ParseError *error)
+{
+    if (state == NULL)
+    {
+        return;
+    }
+
+    cJSON_StreamParserGetError(state->stream, error);
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteParseState(cJSON_ParseState *state)
+{
+    if (state == NULL)
+    {
+        return;
+    }
+
+    cJSON_DeleteStreamParser(state->stream);
+    global_hooks.deallocate(state);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_StreamParserWrite(const char *data, size_t length, void *parser)
+{
+    return cJSON_StreamParserFeed((cJSON_StreamParser*)parser, data, length);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithCodec(const cJSON_Codec *codec, const char *data, size_t length, cJSON_ParseError *error)
+{
+    cJSON_StreamParser *parser = NULL;
+    cJSON *document = NULL;
+    cJSON_bool decoded = true;
+    size_t offset = 0;
+    size_t chunk = 0;
+
+    if ((codec == NULL) || (codec->transform == NULL) || ((data == NULL) && (length > 0)))
+    {
+        return NULL;
+    }
+    parser = cJSON_CreateStreamParser();
+    if (parser == NULL)
+    {
+        if (error != NULL)
+        {
+            memset(error, '\0', sizeof(cJSON_ParseError));
+            error->code = cJSON_Error_OutOfMemory;
+        }
+        return NULL;
+    }
+    parser->single = true;
+
+    /* the input is handed to the codec in pieces, which hands every piece it decoded to the parser */
+    do
+    {
+        chunk = ((length - offset) > CJSON_WRITER_BUFFER_SIZE) ? CJSON_WRITER_BUFFER_SIZE : (length - offset);
+        decoded = codec->transform(codec->codec_data, (data == NULL) ? "" : (data + offset), chunk, (offset + chunk) == length, cJSON_StreamParserWrite, parser);
+        offset += chunk;
+    } while (decoded && (offset < length));
+
+    if (decoded && cJSON_StreamParserFinish(parser))
+    {
+        document = cJSON_StreamParserNext(parser);
+    }
+    if (error != NULL)
+    {
+        cJSON_StreamParserGetError(parser, error);
+        if (!decoded && (error->code == cJSON_Error_None))
+        {
+            /* the parser was fine, so it was the codec that failed */
+            error->code = cJSON_Error_Codec;
+        }
+    }
+    cJSON_DeleteStreamParser(parser);
+
+    return document;
+}
+
+/* type of the entry in front of an object member that holds its name */
+#define TAPE_NAME (1 << 10)
+/* set on the members of objects */
+#define TAPE_MEMBER (1 << 11)
+
+struct cJSON_TapeValue
+{
+    /* cJSON type, TAPE_NAME or a cJSON type with TAPE_MEMBER */
+    unsigned int type;
+    /* distance in entries to the next value at the same level, 0 for the last one */
+    unsigned int next;
+    union
+    {
+        double number;
+        /* strings and names, they point into the input unless they had to be unescaped */
+        struct
+        {
+            const char *text;
+            size_t length;
+        } string;
+        /* number of children of arrays and objects */
+        size_t count;
+    } value;
+};
+
+struct cJSON_Tape
+{
+    cJSON_TapeValue *values;
+    size_t count;
+    size_t size;
+    /* unescaped strings, created when the first one is needed */
+    cJSON_Arena *strings;
+};
+
+/* Returns the index of a new entry, or (size_t)-1 if out of memory. */
+static size_t tape_append(cJSON_Tape * const tape, const unsigned int type, const internal_hooks * const hooks)
+{
+    cJSON_TapeValue *values = NULL;
+
+    if (tape->count == tape->size)
+    {
+        /* distances between the entries are 32 bits */
+        if (tape->size > (UINT_MAX / 2))
+        {
+            return (size_t)-1;
+        }
+
+        values = (cJSON_TapeValue*)hooks->allocate(tape->size * 2 * sizeof(cJSON_TapeValue));
+        if (values == NULL)
+        {
+            return (size_t)-1;
+        }
+        if (tape->values != NULL)
+        {
+            memcpy(values, tape->values, tape->count * sizeof(cJSON_TapeValue));
+            hooks->deallocate(tape->values);
+        }
+        tape->values = values;
+        tape->size *= 2;
+    }
+
+    memset(&tape->values[tape->count], '\0', sizeof(cJSON_TapeValue));
+    tape->values[tape->count].type = type;
+
+    return tape->count++;
+}
+
+/* Add a string (or name) to the tape. */
+static const unsigned char *tape_string(cJSON_Tape * const tape, const unsigned int type, const unsigned char * const input, parse_context * const context)
+{
+    const unsigned char *input_end = find_string_special(input + 1, context->end);
+    const internal_hooks *hooks = context->hooks;
+    internal_hooks arena_hooks;
+    cJSON item;
+    size_t index = tape_append(tape, type, context->hooks);
+
+    if (index == (size_t)-1)
+    {
+        return parse_error(context, input, cJSON_Error_OutOfMemory);
+    }
+
+    if ((input_end < context->end) && (*input_end == '\"'))
+    {
+        /* nothing to unescape, point into the input */
+        tape->values[index].value.string.text = (const char*)input + 1;
+        tape->values[index].value.string.length = (size_t)(input_end - input) - 1;
+
+        return input_end + 1;
+    }
+
+    /* let parse_string unescape it (or report the error) into the arena */
+    if (tape->strings == NULL)
+    {
+        tape->strings = cJSON_CreateArena(0);
+        if (tape->strings == NULL)
+        {
+            return parse_error(context, input, cJSON_Error_OutOfMemory);
+        }
+    }
+    arena_hooks = tape->strings->hooks;
+    arena_hooks.arena = tape->strings;
+
+    memset(&item, '\0', sizeof(item));
+    context->hooks = &arena_hooks;
+    input_end = parse_string(&item, input, context);
+    context->hooks = hooks;
+    if (input_end == NULL)
+    {
+        return NULL;
+    }
+    tape->values[index].value.string.text = item.valuestring;
+    tape->values[index].value.string.length = strlen(item.valuestring);
+
+    return input_end;
+}
+
+/* Count a new element of the array or object at container and add its name. input points behind the '[', '{' or ','.
+ * Returns a pointer to the value of the element. */
+static const unsigned char *tape_element_start(cJSON_Tape * const tape, const size_t container, const unsigned char *input, parse_context * const context)
+{
+    tape->values[container].value.count++;
+
+    input = skip_whitespace(context, input);
+    if (tape->values[container].type & cJSON_Array)
+    {
+        return input;
+    }
+
+    if (char_at(context, input) != '\"')
+    {
+        return parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedName);
+    }
+    input = tape_string(tape, TAPE_NAME, input, context);
+    input = skip_whitespace(context, input);
+    if (input == NULL)
+    {
+        return NULL; /* failed to parse name */
+    }
+
+    if (char_at(context, input) != ':')
+    {
+        return parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedColon);
+    }
+
+    return skip_whitespace(context, input + 1);
+}
+
+/* Parse a value into the tape, with the same explicit stack as parse_nested. */
+static const unsigned char *tape_parse(cJSON_Tape * const tape, const unsigned char *input, parse_context * const context)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    unsigned char character = '\0';
+    unsigned int member = 0;
+    size_t finished = 0;
+    cJSON item;
+
+    nesting_init(&stack, context->hooks);
+    for (;;)
+    {
+        member = ((stack.depth > 0) && (tape->values[stack.frames[stack.depth - 1].index].type & cJSON_Object)) ? TAPE_MEMBER : 0;
+        character = char_at(context, input);
+        if ((character == '[') || (character == '{'))
+        {
+            if (stack.depth >= CJSON_NESTING_LIMIT)
+            {
+                parse_error(context, input, cJSON_Error_TooDeep);
+                goto fail; /* too deeply nested */
+            }
+            finished = tape_append(tape, ((character == '[') ? cJSON_Array : cJSON_Object) | member, context->hooks);
+            frame = (finished == (size_t)-1) ? NULL : nesting_push(&stack);
+            if (frame == NULL)
+            {
+                parse_error(context, input, cJSON_Error_OutOfMemory);
+                goto fail; /* allocation failure */
+            }
+            frame->index = finished;
+
+            input = skip_whitespace(context, input + 1);
+            if (char_at(context, input) != ((character == '[') ? ']' : '}'))
+            {
+                input = tape_element_start(tape, frame->index, input, context);
+                if (input == NULL)
+                {
+                    goto fail; /* failed to parse the first element */
+                }
+                continue;
+            }
+            /* empty array or object, it is closed below */
+        }
+        else if (character == '\"')
+        {
+            input = tape_string(tape, cJSON_String | member, input, context);
+            if (input == NULL)
+            {
+                goto fail; /* failed to parse string */
+            }
+            finished = tape->count - 1;
+        }
+        else
+        {
+            /* numbers and literals don't allocate anything */
+            memset(&item, '\0', sizeof(item));
+            input = parse_value(&item, input, context);
+            if (input == NULL)
+            {
+                goto fail; /* failed to parse value */
+            }
+            finished = tape_append(tape, (unsigned int)item.type | member, context->hooks);
+            if (finished == (size_t)-1)
+            {
+                parse_error(context, input, cJSON_Error_OutOfMemory);
+                goto fail; /* allocation failure */
+            }
+            tape->values[finished].value.number = item.valuedouble;
+        }
+
+        /* the value is complete, close the arrays and objects that end here */
+        while (stack.depth > 0)
+        {
+            frame = &stack.frames[stack.depth - 1];
+            input = skip_whitespace(context, input);
+            if (char_at(context, input) == ',')
+            {
+                break;
+            }
+
+            if (tape->values[frame->index].type & cJSON_Array)
+            {
+                if (char_at(context, input) != ']')
+                {
+                    parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedArrayEnd);
+                    goto fail; /* expected end of array */
+                }
+            }
+            else if (char_at(context, input) != '}')
+            {
+                parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedObjectEnd);
+                goto fail; /* expected end of object */
+            }
+            input++;
+            finished = frame->index;
+            stack.depth--;
+        }
+
+        if (stack.depth == 0)
+        {
+            nesting_free(&stack);
+            return input;
+        }
+
+        /* the next element starts at the end of the tape, behind its name if it has one */
+        tape->values[finished].next = (unsigned int)(tape->count - finished + ((tape->values[frame->index].type & cJSON_Object) ? 1 : 0));
+        input = tape_element_start(tape, frame->index, input + 1, context);
+        if (input == NULL)
+        {
+            goto fail;
+        }
+    }
+
+fail:
+    nesting_free(&stack);
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON_Tape *) cJSON_ParseTape(const char *value, size_t buffer_length, cJSON_ParseError *error)
+{
+    const unsigned char *end = NULL;
+    parse_context context;
+    cJSON_Tape *tape = NULL;
+
+    context.hooks = &global_hooks;
+    context.error_position = NULL;
+    context.error_code = cJSON_Error_None;
+    context.inline_item = NULL;
+    context.end = NULL;
+
+    if (value == NULL)
+    {
+        goto fail;
+    }
+    context.end = (const unsigned char*)value + buffer_length;
+
+    tape = (cJSON_Tape*)global_hooks.allocate(sizeof(cJSON_Tape));
+    if (tape == NULL)
+    {
+        parse_error(&context, (const unsigned char*)value, cJSON_Error_OutOfMemory);
+        goto fail;
+    }
+    memset(tape, '\0', sizeof(cJSON_Tape));
+    /* a guess, most documents take fewer entries */
+    tape->size = (buffer_length / 16) + 16;
+    tape->values = (cJSON_TapeValue*)global_hooks.allocate(tape->size * sizeof(cJSON_TapeValue));
+    if (tape->values == NULL)
+    {
+        parse_error(&context, (const unsigned char*)value, cJSON_Error_OutOfMemory);
+        goto fail;
+    }
+
+    end = tape_parse(tape, skip_whitespace(&context, (const unsigned char*)value), &context);
+    if (end == NULL)
+    {
+        goto fail;
+    }
+
+    end = skip_whitespace(&context, end);
+    if (char_at(&context, end) != '\0')
+    {
+        parse_error(&context, end, cJSON_Error_TrailingCharacters);
+        goto fail;
+    }
+
+    if (error != NULL)
+    {
+        fill_parse_error(error, (const unsigned char*)value, &context);
+    }
+
+    return tape;
+
+fail:
+    cJSON_DeleteTape(tape);
+    if (error != NULL)
+    {
+        fill_parse_error(error, (const unsigned char*)value, &context);
+    }
+
+    return NULL;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteTape(cJSON_Tape *tape)
+{
+    if (tape == NULL)
+    {
+        return;
+    }
+
+    if (tape->values != NULL)
+    {
+        global_hooks.deallocate(tape->values);
+    }
+    cJSON_DeleteArena(tape->strings);
+    global_hooks.deallocate(tape);
+}
+
+CJSON_PUBLIC(const cJSON_TapeValue *) cJSON_TapeGetRoot(const cJSON_Tape *tape)
+{
+    if ((tape == NULL) || (tape->count == 0))
+    {
+        return NULL;
+    }
+
+    return tape->values;
+}
+
+CJSON_PUBLIC(int) cJSON_TapeGetType(const cJSON_TapeValue *item)
+{
+    return (item == NULL) ? cJSON_Invalid : (int)(item->type & 0xFF);
+}
+
+CJSON_PUBLIC(double) cJSON_TapeGetNumber(const cJSON_TapeValue *item)
+{
+    if ((item == NULL) || !(item->type & cJSON_Number))
+    {
+        return 0;
+    }
+
+    return item->value.number;
+}
+
+CJSON_PUBLIC(const char *) cJSON_TapeGetString(const cJSON_TapeValue *item, size_t *length)
+{
+    if ((item == NULL) || !(item->type & cJSON_String))
+    {
+        return NULL;
+    }
+
+    if (length != NULL)
+    {
+        *length = item->value.string.length;
+    }
+
+    return item->value.string.text;
+}
+
+CJSON_PUBLIC(const char *) cJSON_TapeGetName(const cJSON_TapeValue *item, size_t *length)
+{
+    if ((item == NULL) || !(item->type & TAPE_MEMBER))
+    {
+        return NULL;
+    }
+
+    /* the name is the entry in front of the member */
+    if (length != NULL)
+    {
+        *length = item[-1].value.string.length;
+    }
+
+    return item[-1].value.string.text;
+}
+
+CJSON_PUBLIC(const cJSON_TapeValue *) cJSON_TapeGetChild(const cJSON_TapeValue *item)
+{
+    if ((item == NULL) || !(item->type & (cJSON_Array | cJSON_Object)) || (item->value.count == 0))
+    {
+        return NULL;
+    }
+
+    /* the first child follows its parent, members behind their name */
+    return (item->type & cJSON_Object) ? (item + 2) : (item + 1);
+}
+
+CJSON_PUBLIC(const cJSON_TapeValue *) cJSON_TapeGetNext(const cJSON_TapeValue *item)
+{
+    if ((item == NULL) || (item->next == 0))
+    {
+        return NULL;
+    }
+
+    return item + item->next;
+}
+
+CJSON_PUBLIC(int) cJSON_TapeGetArraySize(const cJSON_TapeValue *array)
+{
+    if ((array == NULL) || !(array->type & (cJSON_Array | cJSON_Object)))
+    {
+        return 0;
+    }
+
+    return (int)array->value.count;
+}
+
+CJSON_PUBLIC(const cJSON_TapeValue *) cJSON_TapeGetArrayItem(const cJSON_TapeValue *array, int index)
+{
+    const cJSON_TapeValue *current_element = cJSON_TapeGetChild(array);
+
+    if (index < 0)
+    {
+        return NULL;
+    }
+
+    while ((current_element != NULL) && (index > 0))
+    {
+        current_element = cJSON_TapeGetNext(current_element);
+        index--;
+    }
+
+    return current_element;
+}
+
+static const cJSON_TapeValue *tape_get_object_item(const cJSON_TapeValue * const object, const char * const name, const cJSON_bool case_sensitive)
+{
+    const cJSON_TapeValue *current_element = NULL;
+    size_t name_length = 0;
+
+    if ((object == NULL) || !(object->type & cJSON_Object) || (name == NULL))
+    {
+        return NULL;
+    }
+
+    name_length = strlen(name);
+    for (current_element = cJSON_TapeGetChild(object); current_element != NULL; current_element = cJSON_TapeGetNext(current_element))
+    {
+        size_t length = 0;
+        const char *current_name = cJSON_TapeGetName(current_element, &length);
+        size_t i = 0;
+
+        if (length != name_length)
+        {
+            continue;
+        }
+        if (case_sensitive)
+        {
+            if (memcmp(current_name, name, length) == 0)
+            {
+                return current_element;
+            }
+            continue;
+        }
+        while ((i < length) && (tolower((unsigned char)current_name[i]) == tolower((unsigned char)name[i])))
+        {
+            i++;
+        }
+        if (i == length)
+        {
+            return current_element;
+        }
+    }
+
+    return NULL;
+}
+
+CJSON_PUBLIC(const cJSON_TapeValue *) cJSON_TapeGetObjectItem(const cJSON_TapeValue *object, const char *string)
+{
+    return tape_get_object_item(object, string, false);
+}
+
+CJSON_PUBLIC(const cJSON_TapeValue *) cJSON_TapeGetObjectItemCaseSensitive(const cJSON_TapeValue *object, const char *string)
+{
+    return tape_get_object_item(object, string, true);
+}
+
+/* Add the length of the text of a value (without the terminating '\0') to length, leaving out the values of its children. */
+static cJSON_bool node_length(const cJSON * const item, const size_t depth, const cJSON_bool format, size_t * const length)
+{
+    unsigned char number_buffer[NUMBER_BUFFER_SIZE];
+    const unsigned char *string = NULL;
+    const cJSON *child = NULL;
+    size_t number_length = 0;
+
+    switch ((item->type) & 0xFF)
+    {
+        case cJSON_NULL:
+        case cJSON_True:
+            *length += 4;
+            return true;
+
+        case cJSON_False:
+            *length += 5;
+            return true;
+
+        case cJSON_Number:
+            if (item->type & cJSON_IsLazy)
+            {
+                *length += (size_t)item->valueint;
+                return true;
+            }
+            number_length = render_number(item->valuedouble, number_buffer);
+            *length += number_length;
+            return number_length != 0;
+
+        case cJSON_Raw:
+            if (item->valuestring == NULL)
+            {
+                return false;
+            }
+            *length += strlen(item->valuestring);
+            return true;
+
+        case cJSON_String:
+            if (item->type & cJSON_IsBinary)
+            {
+                *length += base64_length((size_t)item->valueint) + sizeof("\"\"") - 1;
+                return true;
+            }
+            if (item->type & cJSON_IsLazy)
+            {
+                *length += (size_t)item->valueint + sizeof("\"\"") - 1;
+                return true;
+            }
+            string = (const unsigned char*)item->valuestring;
+            if (string == NULL)
+            {
+                *length += sizeof("\"\"") - 1;
+                return true;
+            }
+            number_length = strlen((const char*)string);
+            *length += number_length + count_escape_characters(string, string + number_length) + sizeof("\"\"") - 1;
+            return true;
+
+        case cJSON_Array:
+            if (item->type & cJSON_IsPacked)
+            {
+                size_t i = 0;
+                for (i = 0; i < (size_t)item->valueint; i++)
+                {
+                    number_length = render_number(packed_numbers(item)[i], number_buffer);
+                    if (number_length == 0)
+                    {
+                        return false;
+                    }
+                    *length += number_length + ((i == 0) ? 2 : (format ? 2 : 1));
+                }
+                return true;
+            }
+            if (!load_lazy(item))
+            {
+                return false;
+            }
+            /* [] and ", " or "," between the elements */
+            *length += 2;
+            for (child = item->child; (child != NULL) && (child->next != NULL); child = child->next)
+            {
+                *length += format ? 2 : 1;
+            }
+            return true;
+
+        case cJSON_Object:
+            if (!load_lazy(item))
+            {
+                return false;
+            }
+            /* {} and "{\n" ... "\t}" when formatted */
+            *length += format ? (depth + 3) : 2;
+            for (child = item->child; child != NULL; child = child->next)
+            {
+                string = (const unsigned char*)child->string;
+                if (string == NULL)
+                {
+                    *length += sizeof("\"\"") - 1;
+                }
+                else
+                {
+                    number_length = strlen((const char*)string);
+                    *length += number_length + count_escape_characters(string, string + number_length) + sizeof("\"\"") - 1;
+                }
+                /* ":\t" when formatted, then indentation, "," and "\n" around the member */
+                *length += format ? (depth + 1 + 2 + 1) : 1;
+                if (child->next != NULL)
+                {
+                    *length += 1;
+                }
+            }
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/* Add the length of the text of a value (without the terminating '\0') to length. */
+static cJSON_bool printed_length(const cJSON * const item, const cJSON_bool format, size_t * const length, const internal_hooks * const hooks)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    const cJSON *current_item = item;
+
+    nesting_init(&stack, hooks);
+    for (;;)
+    {
+        if (!node_length(current_item, stack.depth, format, length))
+        {
+            nesting_free(&stack);
+            return false;
+        }
+
+        if (is_container(current_item) && (current_item->child != NULL))
+        {
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                nesting_free(&stack);
+                return false;
+            }
+            frame->current = current_item->child;
+            current_item = current_item->child;
+            continue;
+        }
+
+        /* go to the next element, leaving the arrays and objects that end here */
+        while ((stack.depth > 0) && (stack.frames[stack.depth - 1].current->next == NULL))
+        {
+            stack.depth--;
+        }
+        if (stack.depth == 0)
+        {
+            nesting_free(&stack);
+            return true;
+        }
+        frame = &stack.frames[stack.depth - 1];
+        frame->current = frame->current->next;
+        current_item = frame->current;
+    }
+}
+
+static unsigned char *print(const cJSON * const item, cJSON_bool format, const internal_hooks * const hooks)
+{
+    printbuffer buffer[1];
+    size_t length = 0;
+
+    CJSON_TRACE(print_start, item, format);
+    if ((item == NULL) || !printed_length(item, format, &length, hooks) || (length == (size_t)-1))
+    {
+        CJSON_TRACE(print_end, item, 0);
+        return NULL;
+    }
+
+    /* the text is rendered into a buffer of exactly the right size, so it doesn't have to grow or be copied */
+    memset(buffer, 0, sizeof(buffer));
+    stats_allocation(hooks, length + 1);
+    stats_buffer(hooks, length + 1);
+    buffer->buffer = (unsigned char*) hooks->allocate(length + 1);
+    if (buffer->buffer == NULL)
+    {
+        CJSON_TRACE(print_end, item, 0);
+        return NULL;
+    }
+    buffer->length = length + 1;
+    buffer->noalloc = true;
+
+    if (!print_value(item, 0, format, buffer, hooks))
+    {
+        hooks->deallocate(buffer->buffer);
+        CJSON_TRACE(print_end, item, 0);
+        return NULL;
+    }
+    buffer->buffer[length] = '\0'; /* just to be sure */
+    CJSON_TRACE(print_end, item, length);
+
+    return buffer->buffer;
+}
+
+/* Render a cJSON item/entity/structure to text. */
+CJSON_PUBLIC(char *) cJSON_Print(const cJSON *item)
+{
+    return (char*)print(item, true, &global_hooks);
+}
+
+CJSON_PUBLIC(char *) cJSON_PrintUnformatted(const cJSON *item)
+{
+    return (char*)print(item, false, &global_hooks);
+}
+
+CJSON_PUBLIC(char *) cJSON_PrintCanonical(const cJSON *item)
+{
+    printbuffer buffer[1];
+
+    if (item == NULL)
+    {
+        return NULL;
+    }
+
+    /* printed_length doesn't know canonical numbers, so the buffer grows as needed */
+    memset(buffer, 0, sizeof(buffer));
+    buffer->buffer = (unsigned char*)global_hooks.allocate(256);
+    if (buffer->buffer == NULL)
+    {
+        return NULL;
+    }
+    buffer->length = 256;
+    buffer->canonical = true;
+
+    if (!print_value(item, 0, false, buffer, &global_hooks))
+    {
+        if (buffer->buffer != NULL)
+        {
+            global_hooks.deallocate(buffer->buffer);
+        }
+        return NULL;
+    }
+
+    return (char*)buffer->buffer;
+}
+
+CJSON_PUBLIC(char *) cJSON_PrintWithStats(const cJSON *item, cJSON_bool format, cJSON_Stats *stats)
+{
+    internal_hooks stats_hooks = global_hooks;
+    char *printed = NULL;
+    clock_t start = 0;
+
+    if (stats == NULL)
+    {
+        return (char*)print(item, format, &global_hooks);
+    }
+
+    memset(stats, '\0', sizeof(cJSON_Stats));
+    stats_hooks.stats = stats;
+    start = clock();
+    printed = (char*)print(item, format, &stats_hooks);
+    stats->seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    return printed;
+}
+
+CJSON_PUBLIC(size_t) cJSON_PrintedLength(const cJSON *item, cJSON_bool fmt)
+{
+    size_t length = 0;
+
+    if ((item == NULL) || !printed_length(item, fmt, &length, &global_hooks))
+    {
+        return 0;
+    }
+
+    return length;
+}
+
+CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON_bool fmt)
+{
+    if (prebuffer < 0)
+    {
+        return NULL;
+    }
+
+    return cJSON_PrintBufferedWithSize(item, (size_t)prebuffer, fmt);
+}
+
+CJSON_PUBLIC(char *) cJSON_PrintBufferedWithSize(const cJSON *item, size_t prebuffer, cJSON_bool fmt)
+{
+    printbuffer p;
+
+    p.buffer = (unsigned char*)global_hooks.allocate(prebuffer);
+    if (!p.buffer)
+    {
+        return NULL;
+    }
+
+    p.length = prebuffer;
+    p.offset = 0;
+    p.noalloc = false;
+    p.writer = NULL;
+    p.writer_context = NULL;
+    p.canonical = false;
+    p.slots = NULL;
+    p.chunks = NULL;
+    p.print_cache = NULL;
+
+    CJSON_TRACE(print_start, item, fmt);
+    if (!print_value(item, 0, fmt, &p, &global_hooks))
+    {
+        if (p.buffer != NULL)
+        {
+            global_hooks.deallocate(p.buffer);
+        }
+        CJSON_TRACE(print_end, item, 0);
+        return NULL;
+    }
+    CJSON_TRACE(print_end, item, p.offset);
+
+    return (char*)p.buffer;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buf, const int len, const cJSON_bool fmt)
+{
+    if (len < 0)
+    {
+        return false;
+    }
+
+    return cJSON_PrintPreallocatedWithSize(item, buf, (size_t)len, fmt);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocatedWithSize(const cJSON *item, char *buf, size_t len, cJSON_bool fmt)
+{
+    printbuffer p;
+    cJSON_bool success = false;
+
+    p.buffer = (unsigned char*)buf;
+    p.length = len;
+    p.offset = 0;
+    p.noalloc = true;
+    p.writer = NULL;
+    p.writer_context = NULL;
+    p.canonical = false;
+    p.slots = NULL;
+    p.chunks = NULL;
+    p.print_cache = NULL;
+
+    CJSON_TRACE(print_start, item, fmt);
+    success = print_value(item, 0, fmt, &p, &global_hooks);
+    CJSON_TRACE(print_end, item, success ? p.offset : 0);
+
+    return success;
+}
+
+struct cJSON_Printer
+{
+    unsigned char *buffer;
+    size_t capacity;
+    size_t high_water_mark;
+};
+
+#define PRINTER_INITIAL_SIZE 256
+
+CJSON_PUBLIC(cJSON_Printer *) cJSON_CreatePrinter(size_t high_water_mark)
+{
+    cJSON_Printer *printer = (cJSON_Printer*)global_hooks.allocate(sizeof(cJSON_Printer));
+    if (printer == NULL)
+    {
+        return NULL;
+    }
+
+    printer->buffer = NULL;
+    printer->capacity = 0;
+    printer->high_water_mark = high_water_mark;
+
+    return printer;
+}
+
+CJSON_PUBLIC(void) cJSON_DeletePrinter(cJSON_Printer *printer)
+{
+    if (printer == NULL)
+    {
+        return;
+    }
+
+    if (printer->buffer != NULL)
+    {
+        global_hooks.deallocate(printer->buffer);
+    }
+    global_hooks.deallocate(printer);
+}
+
+CJSON_PUBLIC(void) cJSON_ResetPrinter(cJSON_Printer *printer)
+{
+    if ((printer == NULL) || (printer->buffer == NULL))
+    {
+        return;
+    }
+
+    /* give back the memory a large document made the buffer grow to */
+    if ((printer->high_water_mark != 0) && (printer->capacity > printer->high_water_mark))
+    {
+        global_hooks.deallocate(printer->buffer);
+        printer->buffer = NULL;
+        printer->capacity = 0;
+    }
+}
+
+CJSON_PUBLIC(const char *) cJSON_PrinterPrint(cJSON_Printer *printer, const cJSON *item, cJSON_bool fmt, size_t *length)
+{
+    printbuffer buffer[1];
+    cJSON_bool success = false;
+
+    if ((printer == NULL) || (item == NULL))
+    {
+        return NULL;
+    }
+
+    cJSON_ResetPrinter(printer);
+    if (printer->buffer == NULL)
+    {
+        printer->capacity = PRINTER_INITIAL_SIZE;
+        if ((printer->high_water_mark != 0) && (printer->capacity > printer->high_water_mark))
+        {
+            printer->capacity = printer->high_water_mark;
+        }
+        printer->buffer = (unsigned char*)global_hooks.allocate(printer->capacity);
+        if (printer->buffer == NULL)
+        {
+            printer->capacity = 0;
+            return NULL;
+        }
+    }
+
+    memset(buffer, 0, sizeof(buffer));
+    buffer->buffer = printer->buffer;
+    buffer->length = printer->capacity;
+
+    success = print_value(item, 0, fmt, buffer, &global_hooks);
+
+    /* ensure may have moved the buffer, or freed it when growing failed */
+    printer->buffer = buffer->buffer;
+    printer->capacity = (buffer->buffer != NULL) ? buffer->length : 0;
+    if (!success)
+    {
+        return NULL;
+    }
+    update_offset(buffer);
+
+    if (length != NULL)
+    {
+        *length = buffer->offset;
+    }
+
+    return (const char*)buffer->buffer;
+}
+
+CJSON_PUBLIC(cJSON_ChunkList *) cJSON_CreateChunkList(size_t chunk_size)
+{
+    cJSON_ChunkList *list = (cJSON_ChunkList*)global_hooks.allocate(sizeof(cJSON_ChunkList));
+    if (list == NULL)
+    {
+        return NULL;
+    }
+
+    memset(list, '\0', sizeof(cJSON_ChunkList));
+    list->chunk_size = (chunk_size == 0) ? CJSON_WRITER_BUFFER_SIZE : chunk_size;
+
+    return list;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteChunkList(cJSON_ChunkList *list)
+{
+    size_t i = 0;
+
+    if (list == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < list->allocated; i++)
+    {
+        if (list->chunks[i].base != NULL)
+        {
+            global_hooks.deallocate(list->chunks[i].base);
+        }
+    }
+    if (list->chunks != NULL)
+    {
+        global_hooks.deallocate(list->chunks);
+        global_hooks.deallocate(list->sizes);
+    }
+    global_hooks.deallocate(list);
+}
+
+CJSON_PUBLIC(const cJSON_Chunk *) cJSON_PrintChunks(cJSON_ChunkList *list, const cJSON *item, cJSON_bool fmt, size_t *count)
+{
+    printbuffer buffer[1];
+
+    if ((list == NULL) || (item == NULL))
+    {
+        return NULL;
+    }
+
+    /* the chunks of the previous document are reused */
+    list->count = 0;
+    memset(buffer, 0, sizeof(buffer));
+    buffer->chunks = list;
+    if ((next_chunk(buffer, 1, &global_hooks) == NULL) || !print_value(item, 0, fmt, buffer, &global_hooks))
+    {
+        list->count = 0;
+        return NULL;
+    }
+    update_offset(buffer);
+    list->chunks[list->count - 1].length = buffer->offset;
+
+    if (count != NULL)
+    {
+        *count = list->count;
+    }
+
+    return list->chunks;
+}
+
+static cJSON_bool print_to_writer(const cJSON * const item, const cJSON_bool fmt, const cJSON_bool canonical, cJSON_WriteFunction writer, void *context)
+{
+    printbuffer buffer[1];
+    cJSON_bool success = false;
+
+    if ((item == NULL) || (writer == NULL))
+    {
+        return false;
+    }
+
+    memset(buffer, 0, sizeof(buffer));
+    buffer->buffer = (unsigned char*)global_hooks.allocate(CJSON_WRITER_BUFFER_SIZE);
+    if (buffer->buffer == NULL)
+    {
+        return false;
+    }
+    buffer->length = CJSON_WRITER_BUFFER_SIZE;
+    buffer->writer = writer;
+    buffer->writer_context = context;
+    buffer->canonical = canonical;
+
+    CJSON_TRACE(print_start, item, fmt);
+    if (print_value(item, 0, fmt, buffer, &global_hooks))
+    {
+        /* write what is left */
+        update_offset(buffer);
+        success = (buffer->offset == 0) || writer((const char*)buffer->buffer, buffer->offset, context);
+    }
+    CJSON_TRACE(print_end, item, success);
+
+    if (buffer->buffer != NULL)
+    {
+        global_hooks.deallocate(buffer->buffer);
+    }
+
+    return success;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintToWriter(const cJSON *item, cJSON_bool fmt, cJSON_WriteFunction writer, void *context)
+{
+    return print_to_writer(item, fmt, false, writer, context);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintCanonicalToWriter(const cJSON *item, cJSON_WriteFunction writer, void *context)
+{
+    return print_to_writer(item, false, true, writer, context);
+}
+
+static cJSON_bool write_to_file(const char *data, size_t length, void *file)
+{
+    return fwrite(data, 1, length, (FILE*)file) == length;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintToFile(const cJSON *item, cJSON_bool fmt, FILE *file)
+{
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    return cJSON_PrintToWriter(item, fmt, write_to_file, file);
+}
+
+/* where cJSON_PrintToCodec sends the chunks of the printed text */
+typedef struct
+{
+    const cJSON_Codec *codec;
+    cJSON_WriteFunction writer;
+    void *context;
+} codec_output;
+
+static cJSON_bool write_to_codec(const char *data, size_t length, void *context)
+{
+    const codec_output * const output = (const codec_output*)context;
+
+    return output->codec->transform(output->codec->codec_data, data, length, false, output->writer, output->context);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintToCodec(const cJSON *item, cJSON_bool fmt, const cJSON_Codec *codec, cJSON_WriteFunction writer, void *context)
+{
+    codec_output output;
+
+    if ((codec == NULL) || (codec->transform == NULL) || (writer == NULL))
+    {
+        return false;
+    }
+    output.codec = codec;
+    output.writer = writer;
+    output.context = context;
+
+    /* the codec has the chance to write what it still holds at the end */
+    return print_to_writer(item, fmt, false, write_to_codec, &output)
+        && codec->transform(codec->codec_data, "", 0, true, writer, context);
+}
+
+struct cJSON_NDJSONWriter
+{
+    unsigned char *buffer;
+    size_t capacity;
+    /* the complete records in buffer, each followed by a newline */
+    size_t length;
+    size_t flush_threshold;
+    cJSON_WriteFunction writer;
+    void *context;
+};
+
+#define NDJSON_DEFAULT_THRESHOLD 65536
+
+CJSON_PUBLIC(cJSON_NDJSONWriter *) cJSON_CreateNDJSONWriter(size_t flush_threshold, cJSON_WriteFunction writer, void *context)
+{
+    cJSON_NDJSONWriter *ndjson = (cJSON_NDJSONWriter*)global_hooks.allocate(sizeof(cJSON_NDJSONWriter));
+    if (ndjson == NULL)
+    {
+        return NULL;
+    }
+
+    memset(ndjson, '\0', sizeof(cJSON_NDJSONWriter));
+    ndjson->flush_threshold = (flush_threshold == 0) ? NDJSON_DEFAULT_THRESHOLD : flush_threshold;
+    ndjson->writer = writer;
+    ndjson->context = context;
+
+    return ndjson;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteNDJSONWriter(cJSON_NDJSONWriter *ndjson)
+{
+    if (ndjson == NULL)
+    {
+        return;
+    }
+
+    if (ndjson->buffer != NULL)
+    {
+        global_hooks.deallocate(ndjson->buffer);
+    }
+    global_hooks.deallocate(ndjson);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_NDJSONWriterAdd(cJSON_NDJSONWriter *ndjson, const cJSON *item)
+{
+    printbuffer buffer[1];
+    unsigned char *output = NULL;
+    cJSON_bool success = false;
+
+    if ((ndjson == NULL) || (item == NULL))
+    {
+        return false;
+    }
+
+    if (ndjson->buffer == NULL)
+    {
+        ndjson->capacity = PRINTER_INITIAL_SIZE;
+        ndjson->buffer = (unsigned char*)global_hooks.allocate(ndjson->capacity);
+        if (ndjson->buffer == NULL)
+        {
+            ndjson->capacity = 0;
+            return false;
+        }
+        ndjson->length = 0;
+    }
+
+    /* the record is printed behind the ones before it, the buffer grows like that of cJSON_PrintBuffered */
+    memset(buffer, 0, sizeof(buffer));
+    buffer->buffer = ndjson->buffer;
+    buffer->length = ndjson->capacity;
+    buffer->offset = ndjson->length;
+
+    success = print_value(item, 0, false, buffer, &global_hooks);
+    if (success)
+    {
+        update_offset(buffer);
+        output = ensure(buffer, 2, &global_hooks);
+        success = (output != NULL);
+    }
+
+    /* ensure may have moved the buffer, or freed it when growing failed */
+    ndjson->buffer = buffer->buffer;
+    ndjson->capacity = (buffer->buffer != NULL) ? buffer->length : 0;
+    if (ndjson->buffer == NULL)
+    {
+        ndjson->length = 0;
+        return false;
+    }
+    if (!success)
+    {
+        /* drop what was printed of the record */
+        ndjson->buffer[ndjson->length] = '\0';
+        return false;
+    }
+    output[0] = '\n';
+    output[1] = '\0';
+    ndjson->length = buffer->offset + 1;
+
+    if ((ndjson->writer != NULL) && (ndjson->length >= ndjson->flush_threshold))
+    {
+        return cJSON_NDJSONWriterFlush(ndjson);
+    }
+
+    return true;
+}
+
+CJSON_PUBLIC(const char *) cJSON_NDJSONWriterText(const cJSON_NDJSONWriter *ndjson, size_t *length)
+{
+    if (ndjson == NULL)
+    {
+        return NULL;
+    }
+
+    if (length != NULL)
+    {
+        *length = ndjson->length;
+    }
+
+    return (ndjson->buffer != NULL) ? (const char*)ndjson->buffer : "";
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_NDJSONWriterFlush(cJSON_NDJSONWriter *ndjson)
+{
+    if (ndjson == NULL)
+    {
+        return false;
+    }
+
+    if ((ndjson->length > 0) && (ndjson->writer != NULL) && !ndjson->writer((const char*)ndjson->buffer, ndjson->length, ndjson->context))
+    {
+        /* the records are kept for the next try */
+        return false;
+    }
+    ndjson->length = 0;
+    if (ndjson->buffer != NULL)
+    {
+        ndjson->buffer[0] = '\0';
+    }
+
+    return true;
+}
+
+/* Parser core - when encountering text, process appropriately. */
+static const unsigned  char *parse_value(cJSON * const item, const unsigned char * const input, parse_context * const context)
+{
+    if (input == NULL)
+    {
+        return NULL; /* no input */
+    }
+
+    /* parse the different types of values */
+    /* null */
+    if (can_read(context, input, 4) && !strncmp((const char*)input, "null", 4))
+    {
+        item->type = cJSON_NULL | (item->type & cJSON_StringIsConst);
+        return input + 4;
+    }
+    /* false */
+    if (can_read(context, input, 5) && !strncmp((const char*)input, "false", 5))
+    {
+        item->type = cJSON_False | (item->type & cJSON_StringIsConst);
+        return input + 5;
+    }
+    /* true */
+    if (can_read(context, input, 4) && !strncmp((const char*)input, "true", 4))
+    {
+        item->type = cJSON_True | (item->type & cJSON_StringIsConst);
+        item->valueint = 1;
+        return input + 4;
+    }
+    /* string */
+    if (char_at(context, input) == '\"')
+    {
+        return context->hooks->lazy_strings ? parse_string_text(item, input, context) : parse_string(item, input, context);
+    }
+    /* number */
+    if ((char_at(context, input) == '-') || ((char_at(context, input) >= '0') && (char_at(context, input) <= '9')))
+    {
+        const unsigned char *end = context->hooks->lazy_numbers ? parse_lazy_number(item, input, context) : parse_number(item, input, context);
+        if (end == NULL)
+        {
+            return parse_error(context, input, cJSON_Error_InvalidNumber);
+        }
+
+        return end;
+    }
+    /* array */
+    if (char_at(context, input) == '[')
+    {
+        return parse_array(item, input, context);
+    }
+    /* object */
+    if (char_at(context, input) == '{')
+    {
+        return parse_object(item, input, context);
+    }
+
+    /* failure. */
+    if (char_at(context, input) == '\0')
+    {
+        return parse_error(context, input, cJSON_Error_UnexpectedEnd);
+    }
+
+    return parse_error(context, input, cJSON_Error_InvalidValue);
+}
+
+/* Render a value to text. */
+typedef struct
+{
+    /* position in the text of the template */
+    size_t offset;
+    size_t depth;
+    /* the types the value may have, cJSON_Invalid for any */
+    int types;
+} template_slot;
+
+struct cJSON_Template
+{
+    unsigned char *text;
+    size_t length;
+    cJSON_bool format;
+    size_t count;
+    size_t capacity;
+    template_slot *slots;
+};
+
+/* Remember where the value of a slot goes when a template is compiled. */
+static cJSON_bool record_slot(const cJSON * const item, const size_t depth, printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    cJSON_Template * const compiled = output_buffer->slots;
+    template_slot *slots = NULL;
+    unsigned char *output = NULL;
+
+    if (compiled == NULL)
+    {
+        return false;
+    }
+
+    if (compiled->count == compiled->capacity)
+    {
+        compiled->capacity = (compiled->capacity == 0) ? 8 : (compiled->capacity * 2);
+        slots = (template_slot*)hooks->allocate(compiled->capacity * sizeof(template_slot));
+        if (slots == NULL)
+        {
+            return false;
+        }
+        if (compiled->slots != NULL)
+        {
+            memcpy(slots, compiled->slots, compiled->count * sizeof(template_slot));
+            hooks->deallocate(compiled->slots);
+        }
+        compiled->slots = slots;
+    }
+
+    /* the slot itself takes no space in the text */
+    output = ensure(output_buffer, 1, hooks);
+    if (output == NULL)
+    {
+        return false;
+    }
+    *output = '\0';
+
+    compiled->slots[compiled->count].offset = output_buffer->offset;
+    compiled->slots[compiled->count].depth = depth;
+    compiled->slots[compiled->count].types = item->valueint;
+    compiled->count++;
+
+    return true;
+}
+
+static cJSON_bool print_value(const cJSON * const item, const size_t depth, const cJSON_bool format,  printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    unsigned char *output = NULL;
+
+    if ((item == NULL) || (output_buffer == NULL))
+    {
+        return false;
+    }
+
+    if (!is_container(item))
+    {
+        /* arrays and objects are counted by print_container_start */
+        stats_node(hooks);
+    }
+    switch ((item->type) & 0xFF)
+    {
+        case cJSON_NULL:
+            output = ensure(output_buffer, 5, hooks);
+            if (output == NULL)
+            {
+                return false;
+            }
+            strcpy((char*)output, "null");
+            return true;
+
+        case cJSON_False:
+            output = ensure(output_buffer, 6, hooks);
+            if (output == NULL)
+            {
+                return false;
+            }
+            strcpy((char*)output, "false");
+            return true;
+
+        case cJSON_True:
+            output = ensure(output_buffer, 5, hooks);
+            if (output == NULL)
+            {
+                return false;
+            }
+            strcpy((char*)output, "true");
+            return true;
+
+        case cJSON_Number:
+            return print_number(item, output_buffer, hooks);
+
+        case cJSON_Raw:
+        {
+            size_t raw_length = 0;
+            if (item->valuestring == NULL)
+            {
+                return record_slot(item, depth, output_buffer, hooks);
+            }
+
+            raw_length = strlen(item->valuestring) + sizeof("");
+            output = ensure(output_buffer, raw_length, hooks);
+            if (output == NULL)
+            {
+                return false;
+            }
+            memcpy(output, item->valuestring, raw_length);
+            return true;
+        }
+
+        case cJSON_String:
+            return print_string(item, output_buffer, hooks);
+
+        case cJSON_Array:
+            return print_array(item, depth, format, output_buffer, hooks);
+
+        case cJSON_Object:
+            return print_object(item, depth, format, output_buffer, hooks);
+
+        default:
+            return false;
+    }
+}
+
+/* Parse the name of an object member at input into the key table, item->string then points into the table. */
+static const unsigned char *parse_interned_name(cJSON * const item, const unsigned char * const input, parse_context * const context)
+{
+    const unsigned char *name_end = find_string_special(input + 1, context->end);
+    const unsigned char *end = NULL;
+    char *name = NULL;
+    size_t length = 0;
+
+    if ((name_end < context->end) && (*name_end == '\"'))
+    {
+        /* no escape sequences, so the name can be looked up without copying it first */
+        length = (size_t)(name_end - input - 1);
+        name = intern_key(context->hooks->keys, input + 1, length);
+        end = name_end + 1;
+    }
+    else
+    {
+        end = parse_string(item, input, context);
+        if (end == NULL)
+        {
+            return NULL;
+        }
+        length = valuestring_length(item);
+        name = intern_key(context->hooks->keys, (const unsigned char*)item->valuestring, length);
+        deallocate_string(item, item->valuestring, context->hooks);
+        item->valuestring = NULL;
+        item->valuestring_length = 0;
+    }
+    if (name == NULL)
+    {
+        return parse_error(context, input, cJSON_Error_OutOfMemory);
+    }
+
+    item->string = name;
+    store_name_length(item, length);
+    item->type |= cJSON_StringIsConst;
+
+    return end;
+}
+
+/* A member name of a projection. The children of a node are the names below it, a node that was the end of a path is
+ * kept as a whole (or captured raw, see cJSON_CreateRawCapture). */
+typedef struct
+{
+    unsigned char *name;
+    size_t length;
+    size_t first_child; /* 0 if there is none, the root can't be a child */
+    size_t next;
+    cJSON_bool whole;
+    cJSON_bool raw;
+} projection_node;
+
+struct cJSON_Projection
+{
+    projection_node *nodes; /* nodes[0] is the root */
+    size_t count;
+    size_t capacity;
+    /* if set, members that aren't part of the projection are kept instead of skipped */
+    cJSON_bool keep_others;
+    /* arrays and objects nested this deep are captured raw, 0 for none */
+    size_t raw_depth;
+    internal_hooks hooks;
+};
+
+/* the projection of a value that is kept completely */
+#define PROJECTION_ALL ((size_t)-1)
+/* the projection of the value after the members of an object that were skipped, which means there is none */
+#define PROJECTION_NONE ((size_t)-2)
+
+/* Returns the child of node with the name, or 0 if there is none. */
+static size_t projection_child(const cJSON_Projection * const projection, const size_t node, const unsigned char * const name, const size_t length)
+{
+    size_t child = 0;
+
+    for (child = projection->nodes[node].first_child; child != 0; child = projection->nodes[child].next)
+    {
+        if ((projection->nodes[child].length == length) && (memcmp(projection->nodes[child].name, name, length) == 0))
+        {
+            return child;
+        }
+    }
+
+    return 0;
+}
+
+/* Add the JSON pointer path to projection, the value at its end is captured raw if raw is set. Returns false if it isn't
+ * a valid JSON pointer or out of memory. */
+static cJSON_bool projection_add(cJSON_Projection * const projection, const unsigned char *path, const cJSON_bool raw)
+{
+    projection_node *nodes = NULL;
+    unsigned char *name = NULL;
+    size_t node = 0;
+    size_t child = 0;
+    size_t length = 0;
+    size_t i = 0;
+
+    if ((*path != '\0') && (*path != '/'))
+    {
+        return false;
+    }
+    while ((*path == '/') && !projection->nodes[node].whole && !projection->nodes[node].raw)
+    {
+        path++;
+        for (length = 0; (path[length] != '\0') && (path[length] != '/'); length++)
+        {
+        }
+        name = (unsigned char*)projection->hooks.allocate(length + 1);
+        if (name == NULL)
+        {
+            return false;
+        }
+        /* decode "~0" to '~' and "~1" to '/' */
+        for (i = 0; length > 0; length--, path++)
+        {
+            if (*path == '~')
+            {
+                if ((path[1] != '0') && (path[1] != '1'))
+                {
+                    projection->hooks.deallocate(name);
+                    return false;
+                }
+                name[i++] = (path[1] == '0') ? '~' : '/';
+                path++;
+                length--;
+                continue;
+            }
+            name[i++] = *path;
+        }
+
+        child = projection_child(projection, node, name, i);
+        if (child != 0)
+        {
+            projection->hooks.deallocate(name);
+            node = child;
+            continue;
+        }
+
+        if (projection->count == projection->capacity)
+        {
+            nodes = (projection_node*)projection->hooks.allocate(projection->capacity * 2 * sizeof(projection_node));
+            if (nodes == NULL)
+            {
+                projection->hooks.deallocate(name);
+                return false;
+            }
+            memcpy(nodes, projection->nodes, projection->count * sizeof(projection_node));
+            projection->hooks.deallocate(projection->nodes);
+            projection->nodes = nodes;
+            projection->capacity *= 2;
+        }
+        child = projection->count++;
+        projection->nodes[child].name = name;
+        projection->nodes[child].length = i;
+        projection->nodes[child].first_child = 0;
+        projection->nodes[child].next = projection->nodes[node].first_child;
+        projection->nodes[child].whole = false;
+        projection->nodes[child].raw = false;
+        projection->nodes[node].first_child = child;
+        node = child;
+    }
+    if ((*path == '\0') && !projection->nodes[node].raw)
+    {
+        /* the end of the path, longer paths below it don't matter anymore */
+        projection->nodes[node].whole = !raw;
+        projection->nodes[node].raw = raw;
+    }
+
+    return true;
+}
+
+static cJSON_Projection *create_projection(const char * const *paths, const size_t count, const cJSON_bool raw, const size_t raw_depth)
+{
+    cJSON_Projection *projection = (cJSON_Projection*)global_hooks.allocate(sizeof(cJSON_Projection));
+    size_t i = 0;
+
+    if (projection == NULL)
+    {
+        return NULL;
+    }
+    projection->hooks = global_hooks;
+    projection->count = 1;
+    projection->capacity = 8;
+    projection->keep_others = raw;
+    projection->raw_depth = raw_depth;
+    projection->nodes = (projection_node*)global_hooks.allocate(projection->capacity * sizeof(projection_node));
+    if (projection->nodes == NULL)
+    {
+        global_hooks.deallocate(projection);
+        return NULL;
+    }
+    memset(projection->nodes, '\0', sizeof(projection_node));
+
+    for (i = 0; i < count; i++)
+    {
+        if ((paths == NULL) || (paths[i] == NULL) || !projection_add(projection, (const unsigned char*)paths[i], raw))
+        {
+            cJSON_DeleteProjection(projection);
+            return NULL;
+        }
+    }
+
+    return projection;
+}
+
+CJSON_PUBLIC(cJSON_Projection *) cJSON_CreateProjection(const char * const *paths, size_t count)
+{
+    return create_projection(paths, count, false, 0);
+}
+
+CJSON_PUBLIC(cJSON_Projection *) cJSON_CreateRawCapture(const char * const *paths, size_t count, size_t depth)
+{
+    return create_projection(paths, count, true, depth);
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteProjection(cJSON_Projection *projection)
+{
+    size_t i = 0;
+
+    if (projection == NULL)
+    {
+        return;
+    }
+    for (i = 1; i < projection->count; i++)
+    {
+        projection->hooks.deallocate(projection->nodes[i].name);
+    }
+    projection->hooks.deallocate(projection->nodes);
+    projection->hooks.deallocate(projection);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithProjection(const cJSON_Projection *projection, const char *value, size_t buffer_length, cJSON_ParseError *error)
+{
+    internal_hooks projection_hooks = global_hooks;
+
+    if (projection == NULL)
+    {
+        return NULL;
+    }
+    projection_hooks.projection = projection;
+
+    return parse((const unsigned char*)value, buffer_length, NULL, true, false, &projection_hooks, error);
+}
+
+/* The projection of the root of a document. */
+static size_t projection_root(const cJSON_Projection * const projection)
+{
+    return ((projection == NULL) || projection->nodes[0].whole) ? PROJECTION_ALL : 0;
+}
+
+/* Whether a value that starts with character is captured raw, given its projection node and its nesting depth. */
+static cJSON_bool is_captured(const cJSON_Projection * const projection, const size_t node, const size_t depth, const unsigned char character)
+{
+    if (projection == NULL)
+    {
+        return false;
+    }
+    if ((node != PROJECTION_ALL) && projection->nodes[node].raw)
+    {
+        return true;
+    }
+
+    return (projection->raw_depth != 0) && (depth >= projection->raw_depth) && ((character == '[') || (character == '{'));
+}
+
+static const unsigned char *skip_nested(const unsigned char * const input, parse_context * const context);
+
+/* Find the end of the value at input without building it. Strings and nested values are only checked as far as
+ * skip_string and skip_nested do. */
+static const unsigned char *skip_value(const unsigned char * const input, parse_context * const context)
+{
+    cJSON scratch;
+
+    switch (char_at(context, input))
+    {
+        case '\"':
+            return skip_string(input, context);
+        case '[':
+        case '{':
+            return skip_nested(input, context);
+        default:
+            /* numbers and literals don't allocate */
+            memset(&scratch, '\0', sizeof(scratch));
+            return parse_value(&scratch, input, context);
+    }
+}
+
+/* Capture the value at input as a cJSON_Raw item that holds a copy of its text. */
+static const unsigned char *parse_captured(cJSON * const item, const unsigned char * const input, parse_context * const context)
+{
+    const unsigned char *end = skip_value(input, context);
+    unsigned char *text = NULL;
+
+    if (end == NULL)
+    {
+        return NULL;
+    }
+    text = (unsigned char*)allocate_memory((size_t)(end - input) + sizeof(""), context->hooks);
+    if (text == NULL)
+    {
+        return parse_error(context, input, cJSON_Error_OutOfMemory);
+    }
+    memcpy(text, input, (size_t)(end - input));
+    text[end - input] = '\0';
+
+    item->type = cJSON_Raw | (item->type & cJSON_StringIsConst);
+    item->valuestring = (char*)text;
+    store_valuestring_length(item, (size_t)(end - input));
+
+    return end;
+}
+
+/* Skip the members of the object of frame that aren't part of its projection, starting with the one at input (behind the
+ * '{' or ','), which must not be the end of the object. Returns a pointer to the next member and stores its projection in
+ * projection, which is PROJECTION_NONE if the members up to the end of the object were skipped. Arrays and unprojected objects keep all elements. */
+static const unsigned char *skip_unprojected(const nesting_frame * const frame, const unsigned char *input, size_t * const projection, parse_context * const context)
+{
+    const cJSON_Projection * const projected = context->hooks->projection;
+    const unsigned char *name_end = NULL;
+    size_t child = 0;
+    cJSON scratch;
+
+    *projection = frame->index;
+    if ((frame->index == PROJECTION_ALL) || ((frame->container->type & 0xFF) != cJSON_Object))
+    {
+        return input;
+    }
+
+    for (;;)
+    {
+        input = skip_whitespace(context, input);
+        if (char_at(context, input) != '\"')
+        {
+            return parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedName);
+        }
+        name_end = skip_string(input, context);
+        if (name_end == NULL)
+        {
+            return NULL;
+        }
+        if (find_string_special(input + 1, name_end - 1) == (name_end - 1))
+        {
+            child = projection_child(projected, frame->index, input + 1, (size_t)(name_end - input - 2));
+        }
+        else
+        {
+            /* the name has to be unescaped to compare it */
+            memset(&scratch, '\0', sizeof(scratch));
+            if (parse_string(&scratch, input, context) == NULL)
+            {
+                return NULL;
+            }
+            child = projection_child(projected, frame->index, (const unsigned char*)scratch.valuestring, valuestring_length(&scratch));
+            deallocate_memory(scratch.valuestring, context->hooks);
+        }
+        if ((child != 0) || projected->keep_others)
+        {
+            *projection = ((child == 0) || projected->nodes[child].whole) ? PROJECTION_ALL : child;
+            return input;
+        }
+
+        input = skip_whitespace(context, name_end);
+        if (char_at(context, input) != ':')
+        {
+            return parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedColon);
+        }
+        input = skip_value(skip_whitespace(context, input + 1), context);
+        if (input == NULL)
+        {
+            return NULL;
+        }
+        input = skip_whitespace(context, input);
+        if (char_at(context, input) != ',')
+        {
+            /* the closing brace is checked like after any other member */
+            *projection = PROJECTION_NONE;
+            return input;
+        }
+        input++;
+    }
+}
+
+/* Append a new element to the container of frame. If the container is an object, the name of the element is parsed too.
+ * input points behind the '[', '{' or ','. Returns a pointer to the value of the element. */
+static const unsigned char *parse_element_start(nesting_frame * const frame, const unsigned char *input, parse_context * const context)
+{
+    cJSON *new_item = cJSON_New_Item(context->hooks);
+    if (new_item == NULL)
+    {
+        return parse_error(context, input, cJSON_Error_OutOfMemory); /* allocation failure */
+    }
+    context->inline_item = new_item;
+
+    /* attach the item to the end of the list right away, so it is deleted together with the container on failure */
+    if (frame->last == NULL)
+    {
+        frame->container->child = new_item;
+    }
+    else
+    {
+        frame->last->next = new_item;
+        new_item->prev = frame->last;
+    }
+    /* the first child points to the last one, see cJSON_AddItemToArray */
+    frame->container->child->prev = new_item;
+    frame->last = new_item;
+
+    input = skip_whitespace(context, input);
+    if ((frame->container->type & 0xFF) != cJSON_Object)
+    {
+        return input;
+    }
+
+    /* parse the name of the child */
+    if (char_at(context, input) != '\"')
+    {
+        return parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedName);
+    }
+    if (context->hooks->keys != NULL)
+    {
+        input = parse_interned_name(new_item, input, context);
+    }
+    else
+    {
+        input = parse_string(new_item, input, context);
+        if (input != NULL)
+        {
+            /* swap valuestring and string, because we parsed the name */
+            move_string_to_name(new_item);
+            if (new_item->type & cJSON_IsReference)
+            {
+                /* the name was unescaped in situ */
+                new_item->type = (new_item->type & ~cJSON_IsReference) | cJSON_StringIsConst;
+            }
+        }
+    }
+    input = skip_whitespace(context, input);
+    if (input == NULL)
+    {
+        return NULL; /* failed to parse name */
+    }
+
+    if (char_at(context, input) != ':')
+    {
+        return parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedColon);
+    }
+
+    return skip_whitespace(context, input + 1);
+}
+
+/* Build an array or object from input text. Nested arrays and objects are kept on an explicit stack instead of
+ * recursing, so the C stack usage doesn't depend on the input. */
+static const unsigned char *parse_nested(cJSON * const item, const unsigned char *input, parse_context * const context)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    cJSON *current_item = item;
+    const int type = item->type;
+    unsigned char character = '\0';
+    const unsigned char *end = NULL;
+    /* the projection of current_item, see cJSON_ParseWithProjection */
+    size_t projection = projection_root(context->hooks->projection);
+
+    nesting_init(&stack, context->hooks);
+    for (;;)
+    {
+        /* the value of current_item starts at input */
+        character = char_at(context, input);
+        if (is_captured(context->hooks->projection, projection, stack.depth, character))
+        {
+            input = parse_captured(current_item, input, context);
+            if (input == NULL)
+            {
+                goto fail; /* failed to capture value */
+            }
+        }
+        else if ((character == '[') && context->hooks->pack_numbers && ((end = parse_packed(current_item, input, context)) != NULL))
+        {
+            input = end;
+        }
+        else if ((character == '[') || (character == '{'))
+        {
+            if (stack.depth >= nesting_limit(context->hooks))
+            {
+                parse_error(context, input, cJSON_Error_TooDeep);
+                goto fail; /* too deeply nested */
+            }
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                parse_error(context, input, cJSON_Error_OutOfMemory);
+                goto fail; /* allocation failure */
+            }
+            frame->container = current_item;
+            frame->index = projection;
+            current_item->type = ((character == '[') ? cJSON_Array : cJSON_Object) | (current_item->type & cJSON_StringIsConst);
+
+            input = skip_whitespace(context, input + 1);
+            if ((char_at(context, input) != ((character == '[') ? ']' : '}')) && (projection != PROJECTION_ALL))
+            {
+                input = skip_unprojected(frame, input, &projection, context);
+                if (input == NULL)
+                {
+                    goto fail; /* failed to skip a member */
+                }
+            }
+            if ((char_at(context, input) != ((character == '[') ? ']' : '}')) && (projection != PROJECTION_NONE))
+            {
+                input = parse_element_start(frame, input, context);
+                if (input == NULL)
+                {
+                    goto fail; /* failed to parse the first element */
+                }
+                current_item = frame->last;
+                continue;
+            }
+            /* empty array or object, it is closed below */
+        }
+        else
+        {
+            input = parse_value(current_item, input, context);
+            if (input == NULL)
+            {
+                goto fail; /* failed to parse value */
+            }
+        }
+
+        /* the value is complete, close the arrays and objects that end here */
+close:
+        while (stack.depth > 0)
+        {
+            frame = &stack.frames[stack.depth - 1];
+            input = skip_whitespace(context, input);
+            if (char_at(context, input) == ',')
+            {
+                break;
+            }
+
+            if ((frame->container->type & 0xFF) == cJSON_Array)
+            {
+                if (char_at(context, input) != ']')
+                {
+                    parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedArrayEnd);
+                    goto fail; /* expected end of array */
+                }
+            }
+            else if (char_at(context, input) != '}')
+            {
+                parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedObjectEnd);
+                goto fail; /* expected end of object */
+            }
+            input++;
+            stack.depth--;
+        }
+
+        if (stack.depth == 0)
+        {
+            nesting_free(&stack);
+            return input;
+        }
+
+        /* parse the element after the comma */
+        input++;
+        projection = PROJECTION_ALL;
+        if (frame->index != PROJECTION_ALL)
+        {
+            input = skip_unprojected(frame, input, &projection, context);
+            if (input == NULL)
+            {
+                goto fail; /* failed to skip a member */
+            }
+            if (projection == PROJECTION_NONE)
+            {
+                goto close;
+            }
+        }
+        input = parse_element_start(frame, input, context);
+        if (input == NULL)
+        {
+            goto fail;
+        }
+        current_item = frame->last;
+    }
+
+fail:
+    nesting_free(&stack);
+    /* leave item as it was */
+    item->type = type;
+    if (item->child != NULL)
+    {
+        delete_item(item->child, context->hooks);
+        item->child = NULL;
+    }
+
+    return NULL;
+}
+
+/* Build an array from input text. */
+static const unsigned char *parse_array(cJSON * const item, const unsigned char *input, parse_context * const context)
+{
+    if (char_at(context, input) != '[')
+    {
+        return parse_error(context, input, cJSON_Error_InvalidValue); /* not an array */
+    }
+
+    return parse_nested(item, input, context);
+}
+
+/* Build an object from the text. */
+static const unsigned char *parse_object(cJSON * const item, const unsigned char *input, parse_context * const context)
+{
+    if (char_at(context, input) != '{')
+    {
+        return parse_error(context, input, cJSON_Error_InvalidValue); /* not an object */
+    }
+
+    return parse_nested(item, input, context);
+}
+
+/* Returns the first '\"', '[', ']', '{', '}' or '\0' in [pointer, end), or end if there is none. */
+static const unsigned char *find_structural(const unsigned char *pointer, const unsigned char * const end)
+{
+#ifdef CJSON_SSE2
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i array_start = _mm_set1_epi8('[');
+    const __m128i array_end = _mm_set1_epi8(']');
+    const __m128i object_start = _mm_set1_epi8('{');
+    const __m128i object_end = _mm_set1_epi8('}');
+    const __m128i zero = _mm_setzero_si128();
+
+    while ((size_t)(end - pointer) >= sizeof(__m128i))
+    {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*)(const void*)pointer);
+        const __m128i brackets = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, array_start), _mm_cmpeq_epi8(chunk, array_end)),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, object_start), _mm_cmpeq_epi8(chunk, object_end)));
+        const __m128i special = _mm_or_si128(brackets, _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, zero)));
+        if (_mm_movemask_epi8(special) != 0)
+        {
+            /* the loop below finds the exact position */
+            break;
+        }
+        pointer += sizeof(__m128i);
+    }
+#endif
+
+    while ((pointer < end) && (*pointer != '\"') && (*pointer != '[') && (*pointer != ']')
+            && (*pointer != '{') && (*pointer != '}') && (*pointer != '\0'))
+    {
+        pointer++;
+    }
+
+    return pointer;
+}
+
+/* Find the end of the array or object at input without building anything. Only the brackets and the ends of strings
+ * are checked, everything else is checked once the children are loaded. Returns a pointer behind the closing bracket. */
+static const unsigned char *skip_nested(const unsigned char * const input, parse_context * const context)
+{
+    /* one bit per level, set for objects */
+    unsigned char objects[(CJSON_NESTING_LIMIT + CHAR_BIT - 1) / CHAR_BIT];
+    const unsigned char *pointer = input;
+    size_t depth = 0;
+    cJSON_bool is_object = false;
+
+    for (pointer = find_structural(pointer, context->end); pointer < context->end; pointer = find_structural(pointer + 1, context->end))
+    {
+        switch (*pointer)
+        {
+            case '[':
+            case '{':
+                if (depth >= CJSON_NESTING_LIMIT)
+                {
+                    return parse_error(context, pointer, cJSON_Error_TooDeep);
+                }
+                if (*pointer == '{')
+                {
+                    objects[depth / CHAR_BIT] = (unsigned char)(objects[depth / CHAR_BIT] | (1u << (depth % CHAR_BIT)));
+                }
+                else
+                {
+                    objects[depth / CHAR_BIT] = (unsigned char)(objects[depth / CHAR_BIT] & ~(1u << (depth % CHAR_BIT)));
+                }
+                depth++;
+                break;
+
+            case ']':
+            case '}':
+                if (depth == 0)
+                {
+                    return parse_error(context, pointer, cJSON_Error_InvalidValue);
+                }
+                depth--;
+                is_object = (objects[depth / CHAR_BIT] & (1u << (depth % CHAR_BIT))) != 0;
+                if (is_object != (*pointer == '}'))
+                {
+                    return parse_error(context, pointer, is_object ? cJSON_Error_ExpectedObjectEnd : cJSON_Error_ExpectedArrayEnd);
+                }
+                if (depth == 0)
+                {
+                    return pointer + 1;
+                }
+                break;
+
+            case '\"':
+                pointer = skip_string(pointer, context);
+                if (pointer == NULL)
+                {
+                    return NULL;
+                }
+                /* at the closing quote */
+                pointer--;
+                break;
+
+            default:
+                /* '\0' */
+                return parse_error(context, pointer, cJSON_Error_UnexpectedEnd);
+        }
+    }
+
+    return parse_error(context, pointer, cJSON_Error_UnexpectedEnd);
+}
+
+/* Check the string at input, and its UTF-8 if strict_utf8 is set. Returns a pointer behind the closing quote. */
+static const unsigned char *validate_string(const unsigned char * const input, const cJSON_bool strict_utf8, parse_context * const context)
+{
+    const unsigned char * const input_end = check_string(input, context);
+    const unsigned char *invalid = NULL;
+
+    if (input_end == NULL)
+    {
+        return NULL;
+    }
+    if (strict_utf8)
+    {
+        invalid = find_invalid_utf8(input + 1, input_end);
+        if (invalid != input_end)
+        {
+            return parse_error(context, invalid, cJSON_Error_InvalidUTF8);
+        }
+    }
+
+    return input_end + 1;
+}
+
+/* Check the value at input with the grammar of parse_value and parse_nested, without building it. The nesting is kept
+ * in one bit per level like in skip_nested, so nothing is allocated (apart from parse_number copying numbers of 64 or
+ * more characters that scan_number rejects). Returns a pointer behind the value. */
+static const unsigned char *validate_value(const unsigned char *input, const cJSON_bool strict_utf8, parse_context * const context)
+{
+    /* one bit per level, set for objects */
+    unsigned char objects[(CJSON_NESTING_LIMIT + CHAR_BIT - 1) / CHAR_BIT];
+    size_t depth = 0;
+    cJSON_bool is_object = false;
+    unsigned char character = '\0';
+    const unsigned char *end = NULL;
+    cJSON scratch;
+
+    for (;;)
+    {
+        /* a value starts at input */
+        character = char_at(context, input);
+        if ((character == '[') || (character == '{'))
+        {
+            if (depth >= CJSON_NESTING_LIMIT)
+            {
+                return parse_error(context, input, cJSON_Error_TooDeep);
+            }
+            is_object = (character == '{');
+            if (is_object)
+            {
+                objects[depth / CHAR_BIT] = (unsigned char)(objects[depth / CHAR_BIT] | (1u << (depth % CHAR_BIT)));
+            }
+            else
+            {
+                objects[depth / CHAR_BIT] = (unsigned char)(objects[depth / CHAR_BIT] & ~(1u << (depth % CHAR_BIT)));
+            }
+            depth++;
+
+            input = skip_whitespace(context, input + 1);
+            if (char_at(context, input) != (is_object ? '}' : ']'))
+            {
+                goto element;
+            }
+            /* empty array or object, it is closed below */
+        }
+        else if (character == '\"')
+        {
+            input = validate_string(input, strict_utf8, context);
+        }
+        else if ((character == '-') || ((character >= '0') && (character <= '9')))
+        {
+            end = scan_number(input, context);
+            if ((end == NULL) || ((char_at(context, end) != '\0') && (strchr("0123456789+-.eE", char_at(context, end)) != NULL)))
+            {
+                /* the regular parser takes in more characters, see parse_lazy_number */
+                memset(&scratch, '\0', sizeof(scratch));
+                end = parse_number(&scratch, input, context);
+                if (end == NULL)
+                {
+                    return parse_error(context, input, cJSON_Error_InvalidNumber);
+                }
+            }
+            input = end;
+        }
+        else
+        {
+            /* true, false, null or an error, none of which allocate */
+            memset(&scratch, '\0', sizeof(scratch));
+            input = parse_value(&scratch, input, context);
+        }
+        if (input == NULL)
+        {
+            return NULL;
+        }
+
+        /* the value is complete, close the arrays and objects that end here */
+        while (depth > 0)
+        {
+            is_object = (objects[(depth - 1) / CHAR_BIT] & (1u << ((depth - 1) % CHAR_BIT))) != 0;
+            input = skip_whitespace(context, input);
+            if (char_at(context, input) == ',')
+            {
+                break;
+            }
+            if (char_at(context, input) != (is_object ? '}' : ']'))
+            {
+                return parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd
+                        : (is_object ? cJSON_Error_ExpectedObjectEnd : cJSON_Error_ExpectedArrayEnd));
+            }
+            input++;
+            depth--;
+        }
+        if (depth == 0)
+        {
+            return input;
+        }
+        input++;
+
+element:
+        /* an element starts at input, like in parse_element_start */
+        input = skip_whitespace(context, input);
+        if (!is_object)
+        {
+            continue;
+        }
+        if (char_at(context, input) != '\"')
+        {
+            return parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedName);
+        }
+        input = skip_whitespace(context, validate_string(input, strict_utf8, context));
+        if (input == NULL)
+        {
+            return NULL;
+        }
+        if (char_at(context, input) != ':')
+        {
+            return parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedColon);
+        }
+        input = skip_whitespace(context, input + 1);
+    }
+}
+
+static cJSON_bool validate(const char * const value, const size_t buffer_length, const cJSON_bool strict_utf8, cJSON_ParseError * const error)
+{
+    const unsigned char * const start = (const unsigned char*)value;
+    const unsigned char *end = NULL;
+    parse_context context;
+
+    context.hooks = &global_hooks;
+    context.error_position = NULL;
+    context.error_code = cJSON_Error_None;
+    context.inline_item = NULL;
+    context.end = start + ((value == NULL) ? 0 : buffer_length);
+
+    if (value != NULL)
+    {
+        end = validate_value(skip_whitespace(&context, start), strict_utf8, &context);
+        end = skip_whitespace(&context, end);
+        if ((end != NULL) && (char_at(&context, end) != '\0'))
+        {
+            end = parse_error(&context, end, cJSON_Error_TrailingCharacters);
+        }
+    }
+    if (error != NULL)
+    {
+        fill_parse_error(error, start, &context);
+    }
+
+    return end != NULL;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_Validate(const char *value, size_t buffer_length, cJSON_ParseError *error)
+{
+    return validate(value, buffer_length, false, error);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_ValidateUTF8(const char *value, size_t buffer_length, cJSON_ParseError *error)
+{
+    return validate(value, buffer_length, true, error);
+}
+
+/* Reads the unescaped bytes of a string literal one at a time, for cJSON_TextEquals. */
+typedef struct
+{
+    const unsigned char *pointer; /* the next byte of the literal */
+    const unsigned char *end; /* the closing quote */
+    unsigned char decoded[4]; /* the UTF-8 of a \u escape, of which decoded_position bytes were read */
+    unsigned char decoded_length;
+    unsigned char decoded_position;
+} string_reader;
+
+/* Returns the next byte or -1 at the end. The literal was checked by check_string. */
+static int read_string_byte(string_reader * const reader)
+{
+    unsigned char *decoded_pointer = NULL;
+    unsigned char character = '\0';
+
+    if (reader->decoded_position < reader->decoded_length)
+    {
+        return reader->decoded[reader->decoded_position++];
+    }
+    if (reader->pointer >= reader->end)
+    {
+        return -1;
+    }
+    if (*reader->pointer != '\\')
+    {
+        return *reader->pointer++;
+    }
+
+    character = reader->pointer[1];
+    reader->pointer += 2;
+    switch (character)
+    {
+        case 'b':
+            return '\b';
+        case 'f':
+            return '\f';
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+        case 'u':
+            decoded_pointer = reader->decoded;
+            reader->pointer += utf16_literal_to_utf8(reader->pointer - 2, reader->end, &decoded_pointer) - 2;
+            reader->decoded_length = (unsigned char)(decoded_pointer - reader->decoded);
+            reader->decoded_position = 1;
+            return reader->decoded[0];
+        default:
+            /* '\"', '\\' and '/' */
+            return character;
+    }
+}
+
+/* Compare the string literals at a and b after unescaping them. Returns false if they differ or one is invalid,
+ * otherwise a and b are moved behind them. */
+static cJSON_bool literals_equal(const unsigned char ** const a, parse_context * const a_context, const unsigned char ** const b, parse_context * const b_context, const cJSON_bool case_sensitive)
+{
+    string_reader a_reader;
+    string_reader b_reader;
+    int a_byte = 0;
+    int b_byte = 0;
+
+    memset(&a_reader, '\0', sizeof(a_reader));
+    memset(&b_reader, '\0', sizeof(b_reader));
+    a_reader.end = check_string(*a, a_context);
+    b_reader.end = check_string(*b, b_context);
+    if ((a_reader.end == NULL) || (b_reader.end == NULL))
+    {
+        return false;
+    }
+    a_reader.pointer = *a + 1;
+    b_reader.pointer = *b + 1;
+
+    /* runs without escapes are compared at once */
+    if (case_sensitive && (memchr(a_reader.pointer, '\\', (size_t)(a_reader.end - a_reader.pointer)) == NULL)
+            && (memchr(b_reader.pointer, '\\', (size_t)(b_reader.end - b_reader.pointer)) == NULL))
+    {
+        if (((a_reader.end - a_reader.pointer) != (b_reader.end - b_reader.pointer))
+                || (memcmp(a_reader.pointer, b_reader.pointer, (size_t)(a_reader.end - a_reader.pointer)) != 0))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        do
+        {
+            a_byte = read_string_byte(&a_reader);
+            b_byte = read_string_byte(&b_reader);
+            if (!case_sensitive && (a_byte >= 0) && (b_byte >= 0))
+            {
+                a_byte = tolower(a_byte);
+                b_byte = tolower(b_byte);
+            }
+            if (a_byte != b_byte)
+            {
+                return false;
+            }
+        } while (a_byte >= 0);
+    }
+
+    *a = a_reader.end + 1;
+    *b = b_reader.end + 1;
+
+    return true;
+}
+
+/* Find the member named like the name at name in the members that start at members (behind the '{'). Returns a pointer
+ * to its value or NULL if there is none, or if the object is invalid. */
+static const unsigned char *find_text_member(const unsigned char *members, parse_context * const members_context, const unsigned char * const name, parse_context * const name_context, const cJSON_bool case_sensitive)
+{
+    const unsigned char *name_end = NULL;
+
+    while (char_at(members_context, members) == '\"')
+    {
+        name_end = name;
+        if (literals_equal(&name_end, name_context, &members, members_context, case_sensitive))
+        {
+            members = skip_whitespace(members_context, members);
+            return (char_at(members_context, members) == ':') ? skip_whitespace(members_context, members + 1) : NULL;
+        }
+        members = skip_whitespace(members_context, skip_string(members, members_context));
+        if ((members == NULL) || (char_at(members_context, members) != ':'))
+        {
+            return NULL;
+        }
+        members = skip_whitespace(members_context, skip_value(skip_whitespace(members_context, members + 1), members_context));
+        if ((members == NULL) || (char_at(members_context, members) != ','))
+        {
+            return NULL;
+        }
+        members = skip_whitespace(members_context, members + 1);
+    }
+
+    return NULL;
+}
+
+/* One level of nesting in cJSON_TextEquals. */
+typedef struct
+{
+    cJSON_bool is_object;
+    cJSON_bool in_order; /* all members so far were in the same order in both texts */
+    const unsigned char *a_members; /* behind the '{' of a and b, unordered members are looked up from there */
+    const unsigned char *b_members;
+    size_t count; /* the members of a so far */
+} text_frame;
+
+#define TEXT_LOCAL_FRAMES 32
+
+/* Count the members of b (or check them against the members of a if they weren't in the same order) when the object of
+ * frame ends in a. Returns a pointer behind the object in b or NULL if the members differ. */
+static const unsigned char *end_unordered_object(const text_frame * const frame, parse_context * const a_context, parse_context * const b_context, const cJSON_bool case_sensitive)
+{
+    const unsigned char *member = frame->b_members;
+    size_t count = 0;
+
+    while (char_at(b_context, member) == '\"')
+    {
+        count++;
+        if (!frame->in_order && (find_text_member(frame->a_members, a_context, member, b_context, case_sensitive) == NULL))
+        {
+            return NULL;
+        }
+        member = skip_whitespace(b_context, skip_string(member, b_context));
+        if ((member == NULL) || (char_at(b_context, member) != ':'))
+        {
+            return NULL;
+        }
+        member = skip_whitespace(b_context, skip_value(skip_whitespace(b_context, member + 1), b_context));
+        if (member == NULL)
+        {
+            return NULL;
+        }
+        if (char_at(b_context, member) == ',')
+        {
+            member = skip_whitespace(b_context, member + 1);
+        }
+        else if (char_at(b_context, member) != '}')
+        {
+            return NULL;
+        }
+    }
+    if ((char_at(b_context, member) != '}') || (count != frame->count))
+    {
+        return NULL;
+    }
+
+    return member + 1;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_TextEquals(const char *a, size_t a_length, const char *b, size_t b_length, int flags)
+{
+    const cJSON_bool unordered = (flags & cJSON_TextEquals_Unordered) != 0;
+    const cJSON_bool case_sensitive = (flags & cJSON_TextEquals_CaseInsensitive) == 0;
+    text_frame local_frames[TEXT_LOCAL_FRAMES];
+    text_frame *frames = local_frames;
+    text_frame *grown = NULL;
+    text_frame *frame = NULL;
+    size_t size = TEXT_LOCAL_FRAMES;
+    size_t depth = 0;
+    parse_context a_context;
+    parse_context b_context;
+    const unsigned char *a_pointer = (const unsigned char*)a;
+    const unsigned char *b_pointer = (const unsigned char*)b;
+    const unsigned char *member = NULL;
+    unsigned char character = '\0';
+    unsigned char close = '\0';
+    cJSON_bool equal = false;
+    cJSON a_scratch;
+    cJSON b_scratch;
+
+    if ((a == NULL) || (b == NULL))
+    {
+        return false;
+    }
+    memset(&a_context, '\0', sizeof(a_context));
+    a_context.hooks = &global_hooks;
+    b_context = a_context;
+    a_context.end = a_pointer + a_length;
+    b_context.end = b_pointer + b_length;
+
+    a_pointer = skip_whitespace(&a_context, a_pointer);
+    b_pointer = skip_whitespace(&b_context, b_pointer);
+    for (;;)
+    {
+        /* a value starts at a_pointer and b_pointer */
+        character = char_at(&a_context, a_pointer);
+        if ((character == '[') || (character == '{'))
+        {
+            if ((char_at(&b_context, b_pointer) != character) || (depth >= CJSON_NESTING_LIMIT))
+            {
+                goto end;
+            }
+            if (depth == size)
+            {
+                grown = (text_frame*)global_hooks.allocate(2 * size * sizeof(text_frame));
+                if (grown == NULL)
+                {
+                    goto end;
+                }
+                memcpy(grown, frames, size * sizeof(text_frame));
+                if (frames != local_frames)
+                {
+                    global_hooks.deallocate(frames);
+                }
+                frames = grown;
+                size *= 2;
+            }
+            frame = &frames[depth++];
+            frame->is_object = (character == '{');
+            frame->in_order = true;
+            frame->count = 0;
+            close = frame->is_object ? '}' : ']';
+
+            a_pointer = skip_whitespace(&a_context, a_pointer + 1);
+            b_pointer = skip_whitespace(&b_context, b_pointer + 1);
+            frame->a_members = a_pointer;
+            frame->b_members = b_pointer;
+            if ((char_at(&a_context, a_pointer) == close) != (char_at(&b_context, b_pointer) == close))
+            {
+                goto end;
+            }
+            if (char_at(&a_context, a_pointer) != close)
+            {
+                goto element;
+            }
+            /* empty on both sides, closed below */
+        }
+        else if (character == '\"')
+        {
+            if ((char_at(&b_context, b_pointer) != '\"') || !literals_equal(&a_pointer, &a_context, &b_pointer, &b_context, true))
+            {
+                goto end;
+            }
+        }
+        else
+        {
+            /* numbers by value, true, false, null or an error, none of which allocate */
+            character = char_at(&b_context, b_pointer);
+            if ((character == '\"') || (character == '[') || (character == '{'))
+            {
+                goto end;
+            }
+            memset(&a_scratch, '\0', sizeof(a_scratch));
+            memset(&b_scratch, '\0', sizeof(b_scratch));
+            a_pointer = parse_value(&a_scratch, a_pointer, &a_context);
+            b_pointer = parse_value(&b_scratch, b_pointer, &b_context);
+            if ((a_pointer == NULL) || (b_pointer == NULL) || (a_scratch.type != b_scratch.type)
+                    || (cJSON_IsNumber(&a_scratch) && (a_scratch.valuedouble != b_scratch.valuedouble)))
+            {
+                goto end;
+            }
+        }
+
+        /* the value is complete, close the arrays and objects that end here */
+        while (depth > 0)
+        {
+            frame = &frames[depth - 1];
+            close = frame->is_object ? '}' : ']';
+            a_pointer = skip_whitespace(&a_context, a_pointer);
+            b_pointer = skip_whitespace(&b_context, b_pointer);
+            if (char_at(&a_context, a_pointer) == ',')
+            {
+                if (char_at(&b_context, b_pointer) == ',')
+                {
+                    b_pointer++;
+                }
+                else if (!unordered || !frame->is_object || (char_at(&b_context, b_pointer) != '}'))
+                {
+                    goto end;
+                }
+                break;
+            }
+            if (char_at(&a_context, a_pointer) != close)
+            {
+                goto end;
+            }
+            a_pointer++;
+            /* if all members were in the same order and b ends with a, it has the same members */
+            if (unordered && frame->is_object && !(frame->in_order && (char_at(&b_context, b_pointer) == '}')))
+            {
+                b_pointer = end_unordered_object(frame, &a_context, &b_context, case_sensitive);
+            }
+            else if (char_at(&b_context, b_pointer) == close)
+            {
+                b_pointer++;
+            }
+            else
+            {
+                goto end;
+            }
+            if (b_pointer == NULL)
+            {
+                goto end;
+            }
+            depth--;
+        }
+        if (depth == 0)
+        {
+            a_pointer = skip_whitespace(&a_context, a_pointer);
+            b_pointer = skip_whitespace(&b_context, b_pointer);
+            equal = (char_at(&a_context, a_pointer) == '\0') && (char_at(&b_context, b_pointer) == '\0');
+            goto end;
+        }
+        a_pointer++;
+
+element:
+        /* an element starts at a_pointer and b_pointer */
+        a_pointer = skip_whitespace(&a_context, a_pointer);
+        b_pointer = skip_whitespace(&b_context, b_pointer);
+        if (!frame->is_object)
+        {
+            continue;
+        }
+        if (char_at(&a_context, a_pointer) != '\"')
+        {
+            goto end;
+        }
+        frame->count++;
+        member = a_pointer;
+        if ((char_at(&b_context, b_pointer) != '\"') || !literals_equal(&a_pointer, &a_context, &b_pointer, &b_context, case_sensitive))
+        {
+            if (!unordered)
+            {
+                goto end;
+            }
+            /* not in the same order, the member is looked up in b */
+            frame->in_order = false;
+            b_pointer = find_text_member(frame->b_members, &b_context, member, &a_context, case_sensitive);
+            a_pointer = skip_string(member, &a_context);
+            if ((b_pointer == NULL) || (a_pointer == NULL))
+            {
+                goto end;
+            }
+        }
+        else
+        {
+            b_pointer = skip_whitespace(&b_context, b_pointer);
+            if (char_at(&b_context, b_pointer) != ':')
+            {
+                goto end;
+            }
+            b_pointer = skip_whitespace(&b_context, b_pointer + 1);
+        }
+        a_pointer = skip_whitespace(&a_context, a_pointer);
+        if (char_at(&a_context, a_pointer) != ':')
+        {
+            goto end;
+        }
+        a_pointer = skip_whitespace(&a_context, a_pointer + 1);
+    }
+
+end:
+    if (frames != local_frames)
+    {
+        global_hooks.deallocate(frames);
+    }
+
+    return equal;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseStrictUTF8(const char *value, size_t buffer_length, cJSON_ParseError *error)
+{
+    internal_hooks strict_hooks = global_hooks;
+
+    strict_hooks.strict_utf8 = true;
+    return parse((const unsigned char*)value, buffer_length, NULL, true, false, &strict_hooks, error);
+}
+
+CJSON_PUBLIC(char *) cJSON_PrintStrictUTF8(const cJSON *item, cJSON_bool format)
+{
+    internal_hooks strict_hooks = global_hooks;
+
+    strict_hooks.strict_utf8 = true;
+    return (char*)print(item, format, &strict_hooks);
+}
+
+/* Parse an array that only contains numbers into a packed array. Returns NULL if the array at input is empty or contains
+ * anything else, it is then parsed as usual (which also reports the errors). */
+static const unsigned char *parse_packed(cJSON * const item, const unsigned char *input, parse_context * const context)
+{
+    double *numbers = NULL;
+    double *grown = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    const unsigned char *end = NULL;
+
+    input = skip_whitespace(context, input + 1);
+    if (char_at(context, input) == ']')
+    {
+        return NULL;
+    }
+    for (;;)
+    {
+        if ((char_at(context, input) != '-') && ((char_at(context, input) < '0') || (char_at(context, input) > '9')))
+        {
+            goto fail;
+        }
+        if (count == capacity)
+        {
+            capacity = (capacity == 0) ? 16 : (capacity * 2);
+            if (capacity > INT_MAX)
+            {
+                goto fail; /* the count has to fit into valueint */
+            }
+            grown = (double*)allocate_memory(capacity * sizeof(double), context->hooks);
+            if (grown == NULL)
+            {
+                goto fail;
+            }
+            if (numbers != NULL)
+            {
+                memcpy(grown, numbers, count * sizeof(double));
+                deallocate_memory(numbers, context->hooks);
+            }
+            numbers = grown;
+        }
+
+        end = parse_number_fast(&numbers[count], input, context);
+        if (end == NULL)
+        {
+            end = parse_number_slow(&numbers[count], input, context);
+            if (end == NULL)
+            {
+                goto fail;
+            }
+        }
+        count++;
+
+        input = skip_whitespace(context, end);
+        if (char_at(context, input) == ']')
+        {
+            break;
+        }
+        if (char_at(context, input) != ',')
+        {
+            goto fail;
+        }
+        input = skip_whitespace(context, input + 1);
+    }
+
+    item->type = cJSON_Array | cJSON_IsPacked | (item->type & cJSON_StringIsConst);
+    item->valuestring = (char*)numbers;
+    item->valueint = (int)count;
+
+    return input + 1;
+
+fail:
+    deallocate_memory(numbers, context->hooks);
+
+    return NULL;
+}
+
+/* Make item a lazy array or object that covers the text at input. */
+static const unsigned char *parse_lazy(cJSON * const item, const unsigned char * const input, parse_context * const context)
+{
+    const unsigned char *end = skip_nested(input, context);
+    if (end == NULL)
+    {
+        return NULL;
+    }
+    if ((size_t)(end - input) > INT_MAX)
+    {
+        return parse_error(context, input, cJSON_Error_InvalidValue); /* the length has to fit into valueint */
+    }
+
+    item->type = ((*input == '[') ? cJSON_Array : cJSON_Object) | cJSON_IsLazy | (item->type & cJSON_StringIsConst);
+    /* valuestring is never written through for lazy items */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-qual"
+    item->valuestring = (char*)input;
+#pragma GCC diagnostic pop
+    item->valueint = (int)(end - input);
+
+    return end;
+}
+
+/* Create the elements of a packed array and release its buffer. */
+static cJSON_bool unpack_numbers(cJSON * const item)
+{
+    double *numbers = packed_numbers(item);
+
+    if (!append_numbers(item, numbers, (size_t)item->valueint, &global_hooks))
+    {
+        return false;
+    }
+    item->type &= ~cJSON_IsPacked;
+    item->valuestring = NULL;
+    item->valueint = 0;
+    deallocate_memory(numbers, &global_hooks);
+
+    return true;
+}
+
+/* Unescape the text of a lazy string into a string of its own. */
+static cJSON_bool unescape_string(cJSON * const item)
+{
+    parse_context context;
+    /* the text starts behind the quote */
+    const unsigned char *input = (const unsigned char*)item->valuestring - 1;
+
+    context.hooks = &global_hooks;
+    context.error_position = NULL;
+    context.error_code = cJSON_Error_None;
+    context.inline_item = item;
+    context.end = input + item->valueint + 2;
+
+    if (parse_string(item, input, &context) == NULL)
+    {
+        return false;
+    }
+    item->valueint = 0;
+
+    return true;
+}
+
+/* Replace the bytes of a binary string with their base64 text, its buffer has the room for it. */
+static cJSON_bool encode_binary(cJSON * const item)
+{
+    const size_t length = base64_length((size_t)item->valueint);
+
+    encode_base64((unsigned char*)item->valuestring, (const unsigned char*)item->valuestring, (size_t)item->valueint);
+    item->valuestring[length] = '\0';
+    store_valuestring_length(item, length);
+    item->valueint = 0;
+    item->type &= ~cJSON_IsBinary;
+
+    return true;
+}
+
+/* Parse the children of a lazy array or object (the arrays and objects among them are lazy as well), convert a lazy
+ * number, unescape a lazy string, encode a binary string or unpack a packed array. Returns false and leaves item lazy if
+ * the text turns out to be invalid. */
+static cJSON_bool load_lazy(const cJSON * const lazy_item)
+{
+    parse_context context;
+    nesting_frame frame;
+    cJSON *item = NULL;
+    const unsigned char *input = NULL;
+    unsigned char end_character = '\0';
+
+    if ((lazy_item == NULL) || !(lazy_item->type & (cJSON_IsLazy | cJSON_IsPacked | cJSON_IsBinary)))
+    {
+        return true;
+    }
+    /* loading doesn't change the value, so it is allowed through const pointers */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-qual"
+    item = (cJSON*)lazy_item;
+#pragma GCC diagnostic pop
+    if (item->type & cJSON_IsPacked)
+    {
+        return unpack_numbers(item);
+    }
+    if (item->type & cJSON_IsBinary)
+    {
+        return encode_binary(item);
+    }
+    if ((item->type & 0xFF) == cJSON_Number)
+    {
+        store_number(item, number_value(item));
+        item->type &= ~cJSON_IsLazy;
+        item->valuestring = NULL;
+        return true;
+    }
+    if ((item->type & 0xFF) == cJSON_String)
+    {
+        return unescape_string(item);
+    }
+    input = (const unsigned char*)item->valuestring;
+
+    context.hooks = &global_hooks;
+    context.error_position = NULL;
+    context.error_code = cJSON_Error_None;
+    context.inline_item = NULL;
+    context.end = input + item->valueint;
+
+    memset(&frame, '\0', sizeof(frame));
+    frame.container = item;
+    item->type &= ~cJSON_IsLazy;
+    end_character = ((item->type & 0xFF) == cJSON_Array) ? ']' : '}';
+
+    input = skip_whitespace(&context, input + 1);
+    if (char_at(&context, input) != end_character)
+    {
+        for (;;)
+        {
+            input = parse_element_start(&frame, input, &context);
+            if (input == NULL)
+            {
+                goto fail;
+            }
+            if ((char_at(&context, input) == '[') || (char_at(&context, input) == '{'))
+            {
+                input = parse_lazy(frame.last, input, &context);
+            }
+            else
+            {
+                input = parse_value(frame.last, input, &context);
+            }
+            input = skip_whitespace(&context, input);
+            if (input == NULL)
+            {
+                goto fail;
+            }
+            if (char_at(&context, input) != ',')
+            {
+                break;
+            }
+            input++;
+        }
+        if (char_at(&context, input) != end_character)
+        {
+            goto fail;
+        }
+    }
+
+    item->valuestring = NULL;
+    item->valueint = 0;
+
+    return true;
+
+fail:
+    if (item->child != NULL)
+    {
+        delete_item(item->child, &global_hooks);
+        item->child = NULL;
+    }
+    item->type |= cJSON_IsLazy;
+
+    return false;
+}
+
+/* Load all lazy arrays and objects in a tree. */
+static cJSON_bool load_lazy_tree(const cJSON * const item)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    const cJSON *current_item = item;
+
+    nesting_init(&stack, &global_hooks);
+    for (;;)
+    {
+        if (!load_lazy(current_item))
+        {
+            nesting_free(&stack);
+            return false;
+        }
+
+        if (is_container(current_item) && (current_item->child != NULL))
+        {
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                nesting_free(&stack);
+                return false;
+            }
+            frame->current = current_item->child;
+            current_item = current_item->child;
+            continue;
+        }
+
+        /* go to the next element, leaving the arrays and objects that end here */
+        while ((stack.depth > 0) && (stack.frames[stack.depth - 1].current->next == NULL))
+        {
+            stack.depth--;
+        }
+        if (stack.depth == 0)
+        {
+            nesting_free(&stack);
+            return true;
+        }
+        frame = &stack.frames[stack.depth - 1];
+        frame->current = frame->current->next;
+        current_item = frame->current;
+    }
+}
+
+/* Write the opening bracket of an array or object. */
+static cJSON_bool print_container_start(const cJSON * const item, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    unsigned char *output_pointer = NULL;
+    size_t length = 0;
+
+    stats_node(hooks);
+    if ((item->type & 0xFF) == cJSON_Array)
+    {
+        output_pointer = ensure(output_buffer, 1, hooks);
+        if (output_pointer == NULL)
+        {
+            return false;
+        }
+        *output_pointer = '[';
+        output_buffer->offset++;
+
+        return true;
+    }
+
+    length = format ? 2 : 1; /* fmt: {\n */
+    output_pointer = ensure(output_buffer, length + 1, hooks);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+    *output_pointer++ = '{';
+    if (format)
+    {
+        *output_pointer++ = '\n';
+    }
+    output_buffer->offset += length;
+
+    return true;
+}
+
+/* Rendered names of object members, for names that are shared by many members (constant or interned ones). A name is
+ * found by its pointer, names that don't fit into the text are always rendered. */
+#define KEY_CACHE_SIZE 32
+#define KEY_CACHE_TEXT_SIZE 48
+typedef struct
+{
+    /* the names are only cleared when the first one is printed */
+    cJSON_bool used;
+    const char *names[KEY_CACHE_SIZE];
+    unsigned char lengths[KEY_CACHE_SIZE];
+    /* "name": and the tab behind it if the output is formatted */
+    unsigned char texts[KEY_CACHE_SIZE][KEY_CACHE_TEXT_SIZE];
+} key_cache;
+
+static size_t key_cache_slot(const char * const name)
+{
+    const unsigned char *bytes = (const unsigned char*)&name;
+    size_t slot = 0;
+    size_t i = 0;
+
+    for (i = 0; i < sizeof(name); i++)
+    {
+        slot = (slot * 31) + bytes[i];
+    }
+
+    return slot & (KEY_CACHE_SIZE - 1);
+}
+
+/* Render the name of element and the ':' behind it into the slot of keys for it. */
+static cJSON_bool key_cache_render(key_cache * const keys, const size_t slot, const cJSON * const element, const cJSON_bool format, const internal_hooks * const hooks)
+{
+    printbuffer text;
+
+    memset(&text, '\0', sizeof(text));
+    text.buffer = keys->texts[slot];
+    text.length = KEY_CACHE_TEXT_SIZE;
+    text.noalloc = true;
+    if (!print_string_length((const unsigned char*)element->string, name_length(element), &text, hooks))
+    {
+        return false;
+    }
+    update_offset(&text);
+    if ((text.offset + 2) > KEY_CACHE_TEXT_SIZE)
+    {
+        return false;
+    }
+    text.buffer[text.offset++] = ':';
+    if (format)
+    {
+        text.buffer[text.offset++] = '\t';
+    }
+    keys->names[slot] = element->string;
+    keys->lengths[slot] = (unsigned char)text.offset;
+
+    return true;
+}
+
+/* Print the name of element from keys, rendering it first if it isn't there. Returns false if it can't be cached. */
+static cJSON_bool print_cached_key(key_cache * const keys, const cJSON * const element, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    const size_t slot = key_cache_slot(element->string);
+    unsigned char *output_pointer = NULL;
+
+    if (!keys->used)
+    {
+        memset((void*)keys->names, '\0', sizeof(keys->names));
+        keys->used = true;
+    }
+    if ((keys->names[slot] != element->string) && !key_cache_render(keys, slot, element, format, hooks))
+    {
+        /* a name that was there before is gone now */
+        keys->names[slot] = NULL;
+        return false;
+    }
+
+    output_pointer = ensure(output_buffer, keys->lengths[slot], hooks);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+    memcpy(output_pointer, keys->texts[slot], keys->lengths[slot]);
+    output_buffer->offset += keys->lengths[slot];
+
+    return true;
+}
+
+/* Write what comes in front of the value of an element, that is the indentation and name of an object member. keys,
+ * if set, caches the names that are shared by many members. */
+static cJSON_bool print_element_start(const cJSON * const container, const cJSON * const element, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, key_cache * const keys, const internal_hooks * const hooks)
+{
+    unsigned char *output_pointer = NULL;
+    size_t length = 0;
+
+    if ((container->type & 0xFF) == cJSON_Array)
+    {
+        return true;
+    }
+
+    if (format)
+    {
+        size_t i;
+        output_pointer = ensure(output_buffer, depth, hooks);
+        if (output_pointer == NULL)
+        {
+            return false;
+        }
+        for (i = 0; i < depth; i++)
+        {
+            *output_pointer++ = '\t';
+        }
+        output_buffer->offset += depth;
+    }
+
+    if ((keys != NULL) && (element->type & cJSON_StringIsConst) && (element->string != NULL) && print_cached_key(keys, element, format, output_buffer, hooks))
+    {
+        return true;
+    }
+
+    /* print key */
+    if ((element->string != NULL) ? !print_string_length((unsigned char*)element->string, name_length(element), output_buffer, hooks) : !print_string_ptr(NULL, output_buffer, hooks))
+    {
+        return false;
+    }
+    update_offset(output_buffer);
+
+    length = format ? 2 : 1;
+    output_pointer = ensure(output_buffer, length, hooks);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+    *output_pointer++ = ':';
+    if (format)
+    {
+        *output_pointer++ = '\t';
+    }
+    output_buffer->offset += length;
+
+    return true;
+}
+
+/* Write what comes after the value of an element, the comma if it isn't the last one. */
+static cJSON_bool print_element_end(const cJSON * const container, const cJSON_bool last, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    unsigned char *output_pointer = NULL;
+    size_t length = 0;
+
+    if ((container->type & 0xFF) == cJSON_Array)
+    {
+        if (last)
+        {
+            return true;
+        }
+        length = format ? 2 : 1;
+        output_pointer = ensure(output_buffer, length + 1, hooks);
+        if (output_pointer == NULL)
+        {
+            return false;
+        }
+        *output_pointer++ = ',';
+        if (format)
+        {
+            *output_pointer++ = ' ';
+        }
+        *output_pointer = '\0';
+        output_buffer->offset += length;
+
+        return true;
+    }
+
+    /* print comma if not last */
+    length = (size_t) (format ? 1 : 0) + (last ? 0 : 1);
+    output_pointer = ensure(output_buffer, length + 1, hooks);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+    if (!last)
+    {
+        *output_pointer++ = ',';
+    }
+    if (format)
+    {
+        *output_pointer++ = '\n';
+    }
+    *output_pointer = '\0';
+    output_buffer->offset += length;
+
+    return true;
+}
+
+/* Write the closing bracket of an array or object. */
+static cJSON_bool print_container_end(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    unsigned char *output_pointer = NULL;
+
+    if ((item->type & 0xFF) == cJSON_Array)
+    {
+        output_pointer = ensure(output_buffer, 2, hooks);
+        if (output_pointer == NULL)
+        {
+            return false;
+        }
+        *output_pointer++ = ']';
+        *output_pointer = '\0';
+
+        return true;
+    }
+
+    output_pointer = ensure(output_buffer, format ? (depth + 2) : 2, hooks);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+    if (format)
+    {
+        size_t i;
+        for (i = 0; i < (depth); i++)
+        {
+            *output_pointer++ = '\t';
+        }
+    }
+    *output_pointer++ = '}';
+    *output_pointer = '\0';
+
+    return true;
+}
+
+/* Compare keys by their UTF-16 code units like RFC 8785 does. UTF-8 bytes sort like code points, which only differs
+ * for characters above U+FFFF: they are surrogate pairs in UTF-16 and come before U+E000 to U+FFFF. */
+static int compare_canonical_keys(const unsigned char *a, const unsigned char *b)
+{
+    while ((*a == *b) && (*a != '\0'))
+    {
+        a++;
+        b++;
+    }
+
+    if ((*a >= 0xF0) && (*b >= 0xEE) && (*b < 0xF0))
+    {
+        return -1;
+    }
+    if ((*b >= 0xF0) && (*a >= 0xEE) && (*a < 0xF0))
+    {
+        return 1;
+    }
+
+    return (int)*a - (int)*b;
+}
+
+static int compare_sorted_members(const void *a, const void *b)
+{
+    const sorted_member *member_a = (const sorted_member*)a;
+    const sorted_member *member_b = (const sorted_member*)b;
+    const unsigned char *key_a = (member_a->item->string != NULL) ? (const unsigned char*)member_a->item->string : (const unsigned char*)"";
+    const unsigned char *key_b = (member_b->item->string != NULL) ? (const unsigned char*)member_b->item->string : (const unsigned char*)"";
+    int comparison = compare_canonical_keys(key_a, key_b);
+
+    if (comparison != 0)
+    {
+        return comparison;
+    }
+
+    return (member_a->position < member_b->position) ? -1 : (member_a->position > member_b->position);
+}
+
+/* Returns the members of object in canonical order without touching the object. */
+static sorted_member *sort_members(const cJSON * const object, const internal_hooks * const hooks)
+{
+    sorted_member *members = NULL;
+    const cJSON *child = NULL;
+    size_t count = 0;
+
+    for (child = object->child; child != NULL; child = child->next)
+    {
+        count++;
+    }
+    if (count >= (((size_t)-1) / sizeof(sorted_member)))
+    {
+        return NULL;
+    }
+
+    stats_allocation(hooks, (count + 1) * sizeof(sorted_member));
+    members = (sorted_member*)hooks->allocate((count + 1) * sizeof(sorted_member));
+    if (members == NULL)
+    {
+        return NULL;
+    }
+    count = 0;
+    for (child = object->child; child != NULL; child = child->next)
+    {
+        members[count].item = child;
+        members[count].position = count;
+        count++;
+    }
+    qsort(members, count, sizeof(sorted_member), compare_sorted_members);
+    members[count].item = NULL;
+    members[count].position = count;
+
+    return members;
+}
+
+/* The element that is printed after the current one of frame. */
+static const cJSON *next_element(const nesting_frame * const frame)
+{
+    if (frame->members != NULL)
+    {
+        return frame->members[frame->index + 1].item;
+    }
+
+    return frame->current->next;
+}
+
+/* Render a packed array without creating nodes for its elements. */
+static cJSON_bool print_packed(const cJSON * const item, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    const double *numbers = packed_numbers(item);
+    const size_t count = (size_t)item->valueint;
+    size_t i = 0;
+
+    if (!print_container_start(item, format, output_buffer, hooks))
+    {
+        return false;
+    }
+    for (i = 0; i < count; i++)
+    {
+        stats_node(hooks);
+        if (!print_double(numbers[i], output_buffer, hooks) || !print_element_end(item, (i + 1) == count, format, output_buffer, hooks))
+        {
+            return false;
+        }
+    }
+
+    return print_container_end(item, 0, format, output_buffer, hooks);
+}
+
+/* Render an array or object to text. Like the parser, it keeps nested arrays and objects on an explicit stack. */
+static cJSON_bool print_nested(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    const cJSON *current_item = item;
+    size_t current_depth = depth;
+    key_cache keys;
+
+    if (output_buffer == NULL)
+    {
+        return false;
+    }
+
+    keys.used = false;
+    nesting_init(&stack, hooks);
+    for (;;)
+    {
+        if (current_item->type & cJSON_IsPacked)
+        {
+            if (!print_packed(current_item, format, output_buffer, hooks))
+            {
+                goto fail;
+            }
+        }
+        else if ((output_buffer->print_cache != NULL) && print_cache_copy(current_item, current_depth, format, output_buffer, hooks))
+        {
+            /* unchanged since it was printed */
+        }
+        else if (is_container(current_item))
+        {
+            const size_t start = output_buffer->offset;
+
+            if (!load_lazy(current_item) || !print_container_start(current_item, format, output_buffer, hooks))
+            {
+                goto fail;
+            }
+            if (current_item->child != NULL)
+            {
+                frame = nesting_push(&stack);
+                if (frame == NULL)
+                {
+                    goto fail;
+                }
+                frame->source = current_item;
+                frame->current = current_item->child;
+                frame->start = start;
+                if (output_buffer->canonical && ((current_item->type & 0xFF) == cJSON_Object))
+                {
+                    frame->members = sort_members(current_item, hooks);
+                    if (frame->members == NULL)
+                    {
+                        goto fail;
+                    }
+                    frame->current = frame->members[0].item;
+                }
+                current_item = frame->current;
+                current_depth++;
+                if (!print_element_start(frame->source, current_item, current_depth, format, output_buffer, &keys, hooks))
+                {
+                    goto fail;
+                }
+                continue;
+            }
+            if (!print_container_end(current_item, current_depth, format, output_buffer, hooks))
+            {
+                goto fail;
+            }
+        }
+        else if (!print_value(current_item, current_depth, format, output_buffer, hooks))
+        {
+            goto fail;
+        }
+        update_offset(output_buffer);
+
+        /* the value is complete, close the arrays and objects that end here */
+        while (stack.depth > 0)
+        {
+            frame = &stack.frames[stack.depth - 1];
+            if (!print_element_end(frame->source, next_element(frame) == NULL, format, output_buffer, hooks))
+            {
+                goto fail;
+            }
+            if (next_element(frame) != NULL)
+            {
+                break;
+            }
+            if (!print_container_end(frame->source, depth + stack.depth - 1, format, output_buffer, hooks))
+            {
+                goto fail;
+            }
+            update_offset(output_buffer);
+            if (output_buffer->print_cache != NULL)
+            {
+                print_cache_add(output_buffer->print_cache, frame->source, depth + stack.depth - 1, format, output_buffer->buffer + frame->start, output_buffer->offset - frame->start);
+            }
+            if (frame->members != NULL)
+            {
+                hooks->deallocate(frame->members);
+            }
+            stack.depth--;
+        }
+
+        if (stack.depth == 0)
+        {
+            nesting_free(&stack);
+            return true;
+        }
+
+        /* continue with the next element */
+        frame->current = next_element(frame);
+        frame->index++;
+        current_item = frame->current;
+        current_depth = depth + stack.depth;
+        if (!print_element_start(frame->source, current_item, current_depth, format, output_buffer, &keys, hooks))
+        {
+            goto fail;
+        }
+    }
+
+fail:
+    while (stack.depth > 0)
+    {
+        stack.depth--;
+        if (stack.frames[stack.depth].members != NULL)
+        {
+            hooks->deallocate(stack.frames[stack.depth].members);
+        }
+    }
+    nesting_free(&stack);
+
+    return false;
+}
+
+/* Render an array to text */
+static cJSON_bool print_array(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    return print_nested(item, depth, format, output_buffer, hooks);
+}
+
+/* Render an object to text. */
+static cJSON_bool print_object(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    return print_nested(item, depth, format, output_buffer, hooks);
+}
+
+/* A range of elements that is printed by one task of cJSON_PrintParallel */
+typedef struct
+{
+    const cJSON *container;
+    const cJSON *first;
+    size_t count;
+    cJSON_bool format;
+    cJSON_bool failed;
+    printbuffer buffer;
+} print_range;
+
+/* Task of cJSON_PrintParallel: print the elements of one range, including the commas behind them. */
+static void print_range_task(void *task_data, size_t index)
+{
+    print_range * const range = &((print_range*)task_data)[index];
+    const cJSON *element = range->first;
+    size_t printed = 0;
+
+    range->buffer.buffer = (unsigned char*)global_hooks.allocate(256);
+    range->buffer.length = 256;
+    range->failed = (range->buffer.buffer == NULL);
+    for (printed = 0; !range->failed && (printed < range->count); printed++)
+    {
+        range->failed = !print_element_start(range->container, element, 1, range->format, &range->buffer, NULL, &global_hooks)
+            || !print_nested(element, 1, range->format, &range->buffer, &global_hooks);
+        if (!range->failed)
+        {
+            update_offset(&range->buffer);
+            range->failed = !print_element_end(range->container, element->next == NULL, range->format, &range->buffer, &global_hooks);
+        }
+        element = element->next;
+    }
+}
+
+CJSON_PUBLIC(char *) cJSON_PrintParallel(const cJSON *item, cJSON_bool format, const cJSON_Executor *executor, size_t tasks)
+{
+    print_range *ranges = NULL;
+    printbuffer output;
+    const cJSON *element = NULL;
+    size_t elements = 0;
+    size_t length = 0;
+    size_t i = 0;
+
+    if ((item == NULL) || !is_container(item) || (item->type & cJSON_IsPacked) || !load_lazy(item))
+    {
+        return (char*)print(item, format, &global_hooks);
+    }
+    for (element = item->child; element != NULL; element = element->next)
+    {
+        elements++;
+    }
+    if (tasks > elements)
+    {
+        tasks = elements;
+    }
+    if ((executor == NULL) || (executor->run == NULL) || (tasks < 2) || (tasks > ((size_t)-1 / sizeof(print_range))))
+    {
+        /* nothing to split */
+        return (char*)print(item, format, &global_hooks);
+    }
+
+    ranges = (print_range*)global_hooks.allocate(tasks * sizeof(print_range));
+    if (ranges == NULL)
+    {
+        return NULL;
+    }
+    memset(ranges, '\0', tasks * sizeof(print_range));
+
+    /* every range gets about the same number of elements */
+    element = item->child;
+    for (i = 0; i < tasks; i++)
+    {
+        ranges[i].container = item;
+        ranges[i].first = element;
+        ranges[i].count = (elements / tasks) + ((i < (elements % tasks)) ? 1 : 0);
+        ranges[i].format = format;
+        for (length = 0; length < ranges[i].count; length++)
+        {
+            element = element->next;
+        }
+    }
+
+    executor->run(print_range_task, ranges, tasks, executor->executor_data);
+
+    length = 0;
+    for (i = 0; i < tasks; i++)
+    {
+        if (ranges[i].failed)
+        {
+            goto fail;
+        }
+        length += ranges[i].buffer.offset;
+    }
+
+    /* brackets, the newline after "{" and the terminating '\0' */
+    memset(&output, '\0', sizeof(output));
+    output.length = length + 4;
+    output.noalloc = true;
+    output.buffer = (unsigned char*)global_hooks.allocate(output.length);
+    if (output.buffer == NULL)
+    {
+        goto fail;
+    }
+    if (!print_container_start(item, format, &output, &global_hooks))
+    {
+        global_hooks.deallocate(output.buffer);
+        goto fail;
+    }
+    for (i = 0; i < tasks; i++)
+    {
+        memcpy(output.buffer + output.offset, ranges[i].buffer.buffer, ranges[i].buffer.offset);
+        output.offset += ranges[i].buffer.offset;
+        global_hooks.deallocate(ranges[i].buffer.buffer);
+    }
+    global_hooks.deallocate(ranges);
+    print_container_end(item, 0, format, &output, &global_hooks);
+
+    return (char*)output.buffer;
+
+fail:
+    for (i = 0; i < tasks; i++)
+    {
+        if (ranges[i].buffer.buffer != NULL)
+        {
+            global_hooks.deallocate(ranges[i].buffer.buffer);
+        }
+    }
+    global_hooks.deallocate(ranges);
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateSlot(int types)
+{
+    cJSON *item = cJSON_New_Item(&global_hooks);
+    if (item)
+    {
+        item->type = cJSON_Raw;
+        item->valueint = types;
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON_Template *) cJSON_CreateTemplate(const cJSON *skeleton, cJSON_bool format)
+{
+    printbuffer buffer[1];
+    cJSON_Template *compiled = NULL;
+
+    if (skeleton == NULL)
+    {
+        return NULL;
+    }
+
+    compiled = (cJSON_Template*)global_hooks.allocate(sizeof(cJSON_Template));
+    if (compiled == NULL)
+    {
+        return NULL;
+    }
+    memset(compiled, '\0', sizeof(cJSON_Template));
+    compiled->format = format;
+
+    memset(buffer, 0, sizeof(buffer));
+    buffer->buffer = (unsigned char*)global_hooks.allocate(256);
+    if (buffer->buffer == NULL)
+    {
+        goto fail;
+    }
+    buffer->length = 256;
+    buffer->slots = compiled;
+
+    if (!print_value(skeleton, 0, format, buffer, &global_hooks))
+    {
+        goto fail;
+    }
+    update_offset(buffer);
+
+    compiled->text = buffer->buffer;
+    compiled->length = buffer->offset;
+
+    return compiled;
+
+fail:
+    if (buffer->buffer != NULL)
+    {
+        global_hooks.deallocate(buffer->buffer);
+    }
+    cJSON_DeleteTemplate(compiled);
+
+    return NULL;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteTemplate(cJSON_Template *compiled)
+{
+    if (compiled == NULL)
+    {
+        return;
+    }
+
+    if (compiled->text != NULL)
+    {
+        global_hooks.deallocate(compiled->text);
+    }
+    if (compiled->slots != NULL)
+    {
+        global_hooks.deallocate(compiled->slots);
+    }
+    global_hooks.deallocate(compiled);
+}
+
+CJSON_PUBLIC(int) cJSON_GetTemplateSlotCount(const cJSON_Template *compiled)
+{
+    if (compiled == NULL)
+    {
+        return 0;
+    }
+
+    return (int)compiled->count;
+}
+
+/* Copy the text between the slots and print the values into them. */
+static cJSON_bool render_template(const cJSON_Template * const compiled, const cJSON * const * const values, printbuffer * const output_buffer)
+{
+    const template_slot *slot = NULL;
+    const cJSON *value = NULL;
+    unsigned char *output = NULL;
+    size_t start = 0;
+    size_t end = 0;
+    size_t i = 0;
+
+    if ((values == NULL) && (compiled->count != 0))
+    {
+        return false;
+    }
+
+    for (i = 0; ; i++)
+    {
+        end = (i < compiled->count) ? compiled->slots[i].offset : compiled->length;
+        output = ensure(output_buffer, end - start + 1, &global_hooks);
+        if (output == NULL)
+        {
+            return false;
+        }
+        memcpy(output, compiled->text + start, end - start);
+        output[end - start] = '\0';
+        output_buffer->offset += end - start;
+        if (i == compiled->count)
+        {
+            return true;
+        }
+
+        slot = &compiled->slots[i];
+        value = values[i];
+        if ((value == NULL) || ((slot->types != cJSON_Invalid) && ((value->type & 0xFF & slot->types) == 0)))
+        {
+            return false;
+        }
+        if (!print_value(value, slot->depth, compiled->format, output_buffer, &global_hooks))
+        {
+            return false;
+        }
+        update_offset(output_buffer);
+        start = end;
+    }
+}
+
+CJSON_PUBLIC(char *) cJSON_RenderTemplate(const cJSON_Template *compiled, const cJSON * const *values)
+{
+    printbuffer buffer[1];
+
+    if (compiled == NULL)
+    {
+        return NULL;
+    }
+
+    memset(buffer, 0, sizeof(buffer));
+    /* room for the text and short values */
+    buffer->length = compiled->length + (compiled->count * 16) + 1;
+    buffer->buffer = (unsigned char*)global_hooks.allocate(buffer->length);
+    if (buffer->buffer == NULL)
+    {
+        return NULL;
+    }
+
+    if (!render_template(compiled, values, buffer))
+    {
+        global_hooks.deallocate(buffer->buffer);
+        return NULL;
+    }
+
+    return (char*)buffer->buffer;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_RenderTemplatePreallocated(const cJSON_Template *compiled, const cJSON * const *values, char *buffer, const int length)
+{
+    printbuffer p;
+
+    if ((compiled == NULL) || (buffer == NULL) || (length <= 0))
+    {
+        return false;
+    }
+
+    memset(&p, 0, sizeof(p));
+    p.buffer = (unsigned char*)buffer;
+    p.length = (size_t)length;
+    p.noalloc = true;
+
+    return render_template(compiled, values, &p);
+}
+
+/* The index of an array is a vector of its items.
+ * The index of an object is a hash table of its members. Members with the same hash are chained in the order of the
+ * member list, so a lookup finds the same item as a linear search, even with duplicate names. */
+typedef struct index_entry
+{
+    cJSON *item;
+    /* next entry in the chain + 1, 0 ends the chain */
+    size_t next;
+} index_entry;
+
+struct cJSON_Index
+{
+    /* arrays: the items in order */
+    cJSON **items;
+    /* objects: the members */
+    index_entry *entries;
+    /* first entry of every chain + 1, 0 for empty chains */
+    size_t *buckets;
+    /* number of buckets and entries (or capacity of items), always a power of two */
+    size_t size;
+    /* number of items or entries in use */
+    size_t count;
+    /* entries below this have been used before */
+    size_t used;
+    /* first released entry + 1, 0 if there is none */
+    size_t free_entries;
+    /* the member list was changed in a way the index can't follow, rebuild it before the next lookup */
+    cJSON_bool stale;
+};
+
+#define INDEX_MINIMUM_SIZE 16
+
+/* djb2 of the lower case name, so case insensitive lookups can use the index as well */
+static size_t hash_name(const char * const name)
+{
+    const unsigned char *pointer = (const unsigned char*)name;
+    size_t hash = 5381;
+
+    if (pointer == NULL)
+    {
+        return 0;
+    }
+
+    for (; *pointer != '\0'; pointer++)
+    {
+        hash = (hash * 33) ^ (size_t)tolower(*pointer);
+    }
+
+    return hash;
+}
+
+/* Append item to the end of its chain, the index must not be full. */
+static void index_insert(struct cJSON_Index * const index, cJSON * const item)
+{
+    size_t *link = &index->buckets[hash_name(item->string) & (index->size - 1)];
+    size_t entry = 0;
+
+    if (index->free_entries != 0)
+    {
+        entry = index->free_entries - 1;
+        index->free_entries = index->entries[entry].next;
+    }
+    else
+    {
+        entry = index->used++;
+    }
+
+    while (*link != 0)
+    {
+        link = &index->entries[*link - 1].next;
+    }
+    *link = entry + 1;
+
+    index->entries[entry].item = item;
+    index->entries[entry].next = 0;
+    index->count++;
+}
+
+/* (Re)build the index from the list of children, with room for at least as many new children. */
+static cJSON_bool index_rebuild(struct cJSON_Index * const index, const cJSON * const object)
+{
+    index_entry *entries = NULL;
+    cJSON *child = NULL;
+    size_t count = 0;
+    size_t size = INDEX_MINIMUM_SIZE;
+
+    for (child = object->child; child != NULL; child = child->next)
+    {
+        count++;
+    }
+    while (size < (count * 2))
+    {
+        size *= 2;
+    }
+
+    if ((object->type & 0xFF) == cJSON_Array)
+    {
+        cJSON **items = (cJSON**)global_hooks.allocate(size * sizeof(cJSON*));
+        if (items == NULL)
+        {
+            return false;
+        }
+        if (index->items != NULL)
+        {
+            global_hooks.deallocate(index->items);
+        }
+
+        index->items = items;
+        index->size = size;
+        index->count = 0;
+        index->stale = false;
+
+        for (child = object->child; child != NULL; child = child->next)
+        {
+            index->items[index->count++] = child;
+        }
+
+        return true;
+    }
+
+    /* the buckets live behind the entries */
+    entries = (index_entry*)global_hooks.allocate(size * (sizeof(index_entry) + sizeof(size_t)));
+    if (entries == NULL)
+    {
+        return false;
+    }
+    if (index->entries != NULL)
+    {
+        global_hooks.deallocate(index->entries);
+    }
+
+    index->entries = entries;
+    index->buckets = (size_t*)(void*)(entries + size);
+    memset(index->buckets, 0, size * sizeof(size_t));
+    index->size = size;
+    index->count = 0;
+    index->used = 0;
+    index->free_entries = 0;
+    index->stale = false;
+
+    for (child = object->child; child != NULL; child = child->next)
+    {
+        index_insert(index, child);
+    }
+
+    return true;
+}
+
+/* item has been appended to the children of parent */
+static void index_append(cJSON * const parent, cJSON * const item)
+{
+    struct cJSON_Index *index = get_index(parent);
+
+    if (index->stale)
+    {
+        return;
+    }
+
+    if (index->count == index->size)
+    {
+        /* grow, the new item is already part of the list */
+        if (!index_rebuild(index, parent))
+        {
+            index->stale = true;
+        }
+        return;
+    }
+
+    if (index->items != NULL)
+    {
+        index->items[index->count++] = item;
+        return;
+    }
+
+    index_insert(index, item);
+}
+
+/* item has been inserted into the children of parent at position */
+static void index_insert_at(cJSON * const parent, const size_t position, cJSON * const item)
+{
+    struct cJSON_Index *index = get_index(parent);
+
+    if (index->stale)
+    {
+        return;
+    }
+
+    if ((index->items == NULL) || (position > index->count))
+    {
+        /* positions in the chains would have to move, rebuild on the next lookup instead */
+        index->stale = true;
+        return;
+    }
+
+    if (index->count == index->size)
+    {
+        /* grow, the new item is already part of the list */
+        if (!index_rebuild(index, parent))
+        {
+            index->stale = true;
+        }
+        return;
+    }
+
+    memmove(&index->items[position + 1], &index->items[position], (index->count - position) * sizeof(cJSON*));
+    index->items[position] = item;
+    index->count++;
+}
+
+/* Position of item in the items of an array index, count if it isn't there. */
+static size_t index_position(const struct cJSON_Index * const index, const cJSON * const item)
+{
+    size_t position = 0;
+
+    while ((position < index->count) && (index->items[position] != item))
+    {
+        position++;
+    }
+
+    return position;
+}
+
+/* Find the link to the entry of item, NULL if it isn't in the index. */
+static size_t *index_find_entry(struct cJSON_Index * const index, const cJSON * const item)
+{
+    size_t *link = &index->buckets[hash_name(item->string) & (index->size - 1)];
+
+    while ((*link != 0) && (index->entries[*link - 1].item != item))
+    {
+        link = &index->entries[*link - 1].next;
+    }
+
+    return (*link != 0) ? link : NULL;
+}
+
+/* item has been removed from the list of children */
+static void index_remove(struct cJSON_Index * const index, const cJSON * const item)
+{
+    size_t *link = NULL;
+    size_t entry = 0;
+
+    if (index->stale)
+    {
+        return;
+    }
+
+    if (index->items != NULL)
+    {
+        size_t position = index_position(index, item);
+        if (position == index->count)
+        {
+            index->stale = true;
+            return;
+        }
+
+        memmove(&index->items[position], &index->items[position + 1], (index->count - position - 1) * sizeof(cJSON*));
+        index->count--;
+        return;
+    }
+
+    link = index_find_entry(index, item);
+    if (link == NULL)
+    {
+        /* the name has been changed behind our back */
+        index->stale = true;
+        return;
+    }
+
+    entry = *link - 1;
+    *link = index->entries[entry].next;
+    index->entries[entry].next = index->free_entries;
+    index->free_entries = entry + 1;
+    index->count--;
+}
+
+/* item has been replaced by replacement at the same position of the list of children */
+static void index_replace(struct cJSON_Index * const index, const cJSON * const item, cJSON * const replacement)
+{
+    size_t *link = NULL;
+
+    if (index->stale)
+    {
+        return;
+    }
+
+    if (index->items != NULL)
+    {
+        size_t position = index_position(index, item);
+        if (position == index->count)
+        {
+            index->stale = true;
+            return;
+        }
+
+        index->items[position] = replacement;
+        return;
+    }
+
+    link = index_find_entry(index, item);
+    /* the entry can only stay where it is if it belongs to the same chain */
+    if ((link == NULL) || (((hash_name(item->string) ^ hash_name(replacement->string)) & (index->size - 1)) != 0))
+    {
+        index->stale = true;
+        return;
+    }
+
+    index->entries[*link - 1].item = replacement;
+}
+
+/* Returns the index of parent if there is one that can be used, rebuilding it if necessary. */
+static struct cJSON_Index *usable_index(const cJSON * const parent)
+{
+    struct cJSON_Index * const index = get_index(parent);
+
+    if ((index == NULL) || (index->stale && !index_rebuild(index, parent)))
+    {
+        return NULL;
+    }
+
+    return index;
+}
+
+static void delete_index(struct cJSON_Index * const index)
+{
+    if (index->items != NULL)
+    {
+        global_hooks.deallocate(index->items);
+    }
+    if (index->entries != NULL)
+    {
+        global_hooks.deallocate(index->entries);
+    }
+    global_hooks.deallocate(index);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_BuildIndex(cJSON *item)
+{
+    struct cJSON_Index *index = NULL;
+
+    if ((item == NULL) || (((item->type & 0xFF) != cJSON_Object) && ((item->type & 0xFF) != cJSON_Array)) || !load_lazy(item))
+    {
+        return false;
+    }
+
+    if (item->type & cJSON_IsFrozen)
+    {
+        /* frozen indexes are always up to date */
+        return get_index(item) != NULL;
+    }
+    if (get_index(item) != NULL)
+    {
+        return index_rebuild(get_index(item), item);
+    }
+
+    index = (struct cJSON_Index*)global_hooks.allocate(sizeof(struct cJSON_Index));
+    if (index == NULL)
+    {
+        return false;
+    }
+    memset(index, '\0', sizeof(struct cJSON_Index));
+
+    if (!index_rebuild(index, item))
+    {
+        global_hooks.deallocate(index);
+        return false;
+    }
+    set_index(item, index);
+
+    return true;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteIndex(cJSON *item)
+{
+    if ((item == NULL) || (get_index(item) == NULL) || (item->type & cJSON_IsFrozen))
+    {
+        return;
+    }
+
+    delete_index(get_index(item));
+    set_index(item, NULL);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_Freeze(cJSON *item)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    cJSON *current_item = item;
+    const cJSON *child = NULL;
+    size_t count = 0;
+
+    if ((item == NULL) || !load_lazy_tree(item))
+    {
+        return false;
+    }
+
+    nesting_init(&stack, &global_hooks);
+    for (;;)
+    {
+        if (!(current_item->type & cJSON_IsFrozen) && is_container(current_item))
+        {
+            for ((void)(count = 0), child = current_item->child; (child != NULL) && (count < INDEX_MINIMUM_SIZE); child = child->next)
+            {
+                count++;
+            }
+            /* short lists are searched without an index, existing indexes are brought up to date */
+            if (((count == INDEX_MINIMUM_SIZE) || (get_index(current_item) != NULL)) && !cJSON_BuildIndex(current_item))
+            {
+                nesting_free(&stack);
+                return false;
+            }
+        }
+        current_item->type |= cJSON_IsFrozen;
+
+        if (is_container(current_item) && (current_item->child != NULL))
+        {
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                nesting_free(&stack);
+                return false;
+            }
+            frame->last = current_item->child;
+            current_item = current_item->child;
+            continue;
+        }
+
+        /* go to the next element, leaving the arrays and objects that end here */
+        while ((stack.depth > 0) && (stack.frames[stack.depth - 1].last->next == NULL))
+        {
+            stack.depth--;
+        }
+        if (stack.depth == 0)
+        {
+            nesting_free(&stack);
+            return true;
+        }
+        frame = &stack.frames[stack.depth - 1];
+        frame->last = frame->last->next;
+        current_item = frame->last;
+    }
+}
+
+/* The bytes allocated for item itself and what it owns, apart from its children. */
+static size_t item_memory_usage(const cJSON * const item)
+{
+    size_t usage = sizeof(node_storage);
+    const struct cJSON_Index * const index = get_index(item);
+
+    if (item->type & cJSON_IsPacked)
+    {
+        usage += (size_t)item->valueint * sizeof(double);
+    }
+    else if ((item->type & cJSON_IsBinary) && !is_inline_string(item, item->valuestring))
+    {
+        usage += base64_length((size_t)item->valueint) + sizeof("");
+    }
+    else if (!(item->type & (cJSON_IsReference | cJSON_IsLazy | cJSON_IsIndexed)) && (item->valuestring != NULL) && !is_inline_string(item, item->valuestring))
+    {
+        usage += valuestring_length(item) + sizeof("");
+    }
+    if (!(item->type & cJSON_StringIsConst) && (item->string != NULL) && !is_inline_string(item, item->string))
+    {
+        usage += name_length(item) + sizeof("");
+    }
+    if (index != NULL)
+    {
+        usage += sizeof(struct cJSON_Index);
+        if (index->items != NULL)
+        {
+            usage += index->size * sizeof(cJSON*);
+        }
+        if (index->entries != NULL)
+        {
+            usage += index->size * (sizeof(index_entry) + sizeof(size_t));
+        }
+    }
+
+    return usage;
+}
+
+CJSON_PUBLIC(size_t) cJSON_MemoryUsage(const cJSON *item)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    const cJSON *current = item;
+    size_t usage = 0;
+
+    if (item == NULL)
+    {
+        return 0;
+    }
+
+    nesting_init(&stack, &global_hooks);
+    for (;;)
+    {
+        usage += item_memory_usage(current);
+        if (!(current->type & cJSON_IsReference) && (current->child != NULL))
+        {
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                nesting_free(&stack);
+                return 0;
+            }
+            frame->current = current->child;
+            current = current->child;
+            continue;
+        }
+
+        /* the next sibling, of this level or the ones above */
+        while ((stack.depth > 0) && (stack.frames[stack.depth - 1].current->next == NULL))
+        {
+            stack.depth--;
+        }
+        if (stack.depth == 0)
+        {
+            break;
+        }
+        frame = &stack.frames[stack.depth - 1];
+        frame->current = frame->current->next;
+        current = frame->current;
+    }
+    nesting_free(&stack);
+
+    return usage;
+}
+
+/* Depth first cursor */
+struct cJSON_Cursor
+{
+    /* the open arrays and objects (source) and their child that comes next (current) */
+    nesting_stack stack;
+    const cJSON *root;
+    /* the item of the last event */
+    const cJSON *item;
+    /* the item that comes next, NULL if the innermost open container is left next */
+    const cJSON *pending;
+    size_t depth;
+};
+
+CJSON_PUBLIC(cJSON_Cursor *) cJSON_CreateCursor(const cJSON *item)
+{
+    cJSON_Cursor *cursor = NULL;
+
+    if (item == NULL)
+    {
+        return NULL;
+    }
+
+    cursor = (cJSON_Cursor*)global_hooks.allocate(sizeof(cJSON_Cursor));
+    if (cursor == NULL)
+    {
+        return NULL;
+    }
+    memset(cursor, '\0', sizeof(cJSON_Cursor));
+    nesting_init(&cursor->stack, &global_hooks);
+    cursor->root = item;
+    cursor->pending = item;
+
+    return cursor;
+}
+
+CJSON_PUBLIC(int) cJSON_CursorNext(cJSON_Cursor *cursor)
+{
+    nesting_frame *frame = NULL;
+    const cJSON *item = NULL;
+
+    if (cursor == NULL)
+    {
+        return cJSON_CursorDone;
+    }
+    if ((cursor->pending == NULL) && (cursor->stack.depth == 0))
+    {
+        cursor->item = NULL;
+        return cJSON_CursorDone;
+    }
+
+    item = cursor->pending;
+    if (item == NULL)
+    {
+        /* the innermost container has no children left */
+        frame = &cursor->stack.frames[--cursor->stack.depth];
+        cursor->item = frame->source;
+        cursor->depth = cursor->stack.depth;
+        cursor->pending = (cursor->stack.depth > 0) ? frame->source->next : NULL;
+        return cJSON_CursorLeave;
+    }
+
+    if (!load_lazy(item))
+    {
+        cursor->pending = NULL;
+        cursor->stack.depth = 0;
+        cursor->item = NULL;
+        return cJSON_CursorInvalid;
+    }
+    cursor->item = item;
+    cursor->depth = cursor->stack.depth;
+    /* both are read by the next calls */
+    prefetch_item(item->next);
+    prefetch_item(item->child);
+
+    if (!is_container(item))
+    {
+        cursor->pending = (cursor->stack.depth > 0) ? item->next : NULL;
+        return cJSON_CursorValue;
+    }
+
+    frame = nesting_push(&cursor->stack);
+    if (frame == NULL)
+    {
+        cursor->pending = NULL;
+        cursor->stack.depth = 0;
+        cursor->item = NULL;
+        return cJSON_CursorInvalid;
+    }
+    frame->source = item;
+    cursor->pending = item->child;
+
+    return cJSON_CursorEnter;
+}
+
+CJSON_PUBLIC(const cJSON *) cJSON_CursorItem(const cJSON_Cursor *cursor)
+{
+    return (cursor == NULL) ? NULL : cursor->item;
+}
+
+CJSON_PUBLIC(size_t) cJSON_CursorDepth(const cJSON_Cursor *cursor)
+{
+    return (cursor == NULL) ? 0 : cursor->depth;
+}
+
+CJSON_PUBLIC(const char *) cJSON_CursorKey(const cJSON_Cursor *cursor)
+{
+    const cJSON *parent = NULL;
+
+    if ((cursor == NULL) || (cursor->item == NULL) || (cursor->depth == 0))
+    {
+        return NULL;
+    }
+
+    parent = cursor->stack.frames[cursor->depth - 1].source;
+
+    return ((parent->type & 0xFF) == cJSON_Object) ? cursor->item->string : NULL;
+}
+
+CJSON_PUBLIC(void) cJSON_CursorSkip(cJSON_Cursor *cursor)
+{
+    if ((cursor == NULL) || (cursor->stack.depth == 0) || (cursor->item != cursor->stack.frames[cursor->stack.depth - 1].source))
+    {
+        return;
+    }
+
+    cursor->pending = NULL;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteCursor(cJSON_Cursor *cursor)
+{
+    if (cursor == NULL)
+    {
+        return;
+    }
+
+    nesting_free(&cursor->stack);
+    global_hooks.deallocate(cursor);
+}
+
+/* Get Array size/item / object item. */
+CJSON_PUBLIC(int) cJSON_GetArraySize(const cJSON *array)
+{
+    /* FIXME: Can overflow here. Cannot be fixed without breaking the API, use cJSON_GetArrayLength instead */
+
+    return (int)cJSON_GetArrayLength(array);
+}
+
+CJSON_PUBLIC(size_t) cJSON_GetArrayLength(const cJSON *array)
+{
+    cJSON *c = NULL;
+    size_t i = 0;
+    const struct cJSON_Index *index = NULL;
+
+    if (array == NULL)
+    {
+        return 0;
+    }
+    if (array->type & cJSON_IsPacked)
+    {
+        return (size_t)array->valueint;
+    }
+    if (!load_lazy(array))
+    {
+        return 0;
+    }
+    c = array->child;
+    index = usable_index(array);
+
+    if (index != NULL)
+    {
+        return index->count;
+    }
+
+    while(c)
+    {
+        i++;
+        c = c->next;
+    }
+
+    return i;
+}
+
+static cJSON *get_array_item(const cJSON * const array, size_t position)
+{
+    cJSON *current_child = NULL;
+    const struct cJSON_Index *index = NULL;
+
+    if ((array == NULL) || !load_lazy(array))
+    {
+        return NULL;
+    }
+
+    index = usable_index(array);
+    if ((index != NULL) && (index->items != NULL))
+    {
+        return (position < index->count) ? index->items[position] : NULL;
+    }
+
+    current_child = array->child;
+    while ((current_child != NULL) && (position > 0))
+    {
+        position--;
+        current_child = current_child->next;
+    }
+
+    return current_child;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_GetArrayItem(const cJSON *array, int item)
+{
+    /* negative indices have always returned the first item */
+    return get_array_item(array, (item > 0) ? (size_t)item : 0);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_GetArrayItemAt(const cJSON *array, size_t index)
+{
+    return get_array_item(array, index);
+}
+
+CJSON_PUBLIC(int) cJSON_GetNumberArray(const cJSON *array, double *out, size_t cap)
+{
+    const cJSON *element = NULL;
+    size_t count = 0;
+
+    if ((array == NULL) || ((array->type & 0xFF) != cJSON_Array) || ((out == NULL) && (cap > 0)))
+    {
+        return -1;
+    }
+    if (array->type & cJSON_IsPacked)
+    {
+        count = (size_t)array->valueint;
+        if (cap > 0)
+        {
+            memcpy(out, packed_numbers(array), ((count < cap) ? count : cap) * sizeof(double));
+        }
+        return (int)count;
+    }
+    if (!load_lazy(array))
+    {
+        return -1;
+    }
+
+    for (element = array->child; element != NULL; element = element->next)
+    {
+        if (((element->type & 0xFF) != cJSON_Number) || (count >= INT_MAX))
+        {
+            return -1;
+        }
+        if (count < cap)
+        {
+            out[count] = number_value(element);
+        }
+        count++;
+    }
+
+    return (int)count;
+}
+
+/* Store number at out[count] if it is below cap. Unlike valueint there is no saturation, the number has to fit. */
+static cJSON_bool store_int(const double number, int * const out, const size_t count, const size_t cap)
+{
+    if (!((number >= INT_MIN) && (number <= INT_MAX)) || ((double)(int)number != number))
+    {
+        return false;
+    }
+    if (count < cap)
+    {
+        out[count] = (int)number;
+    }
+
+    return true;
+}
+
+CJSON_PUBLIC(int) cJSON_GetIntArray(const cJSON *array, int *out, size_t cap)
+{
+    const cJSON *element = NULL;
+    size_t count = 0;
+
+    if ((array == NULL) || ((array->type & 0xFF) != cJSON_Array) || ((out == NULL) && (cap > 0)))
+    {
+        return -1;
+    }
+    if (array->type & cJSON_IsPacked)
+    {
+        for (count = 0; count < (size_t)array->valueint; count++)
+        {
+            if (!store_int(packed_numbers(array)[count], out, count, cap))
+            {
+                return -1;
+            }
+        }
+        return (int)count;
+    }
+    if (!load_lazy(array))
+    {
+        return -1;
+    }
+
+    for (element = array->child; element != NULL; element = element->next)
+    {
+        if (((element->type & 0xFF) != cJSON_Number) || (count >= INT_MAX) || !store_int(number_value(element), out, count, cap))
+        {
+            return -1;
+        }
+        count++;
+    }
+
+    return (int)count;
+}
+
+/* length is the length of name, names of another length are rejected without looking at them if theirs is known */
+static cJSON_bool name_matches(const cJSON * const item, const char * const name, const size_t length, const cJSON_bool case_sensitive)
+{
+    if ((stored_name_length(item) != 0) && (stored_name_length(item) != length))
+    {
+        return false;
+    }
+    if (case_sensitive)
+    {
+        return (item->string != NULL) && (strcmp(name, item->string) == 0);
+    }
+
+    return cJSON_strcasecmp((const unsigned char*)name, (const unsigned char*)item->string) == 0;
+}
+
+static cJSON *get_object_item(const cJSON * const object, const char * const name, const cJSON_bool case_sensitive)
+{
+    cJSON *current_element = NULL;
+    const struct cJSON_Index *index = NULL;
+    size_t length = 0;
+
+    if ((object == NULL) || (name == NULL) || !load_lazy(object))
+    {
+        return NULL;
+    }
+
+    length = strlen(name);
+    index = usable_index(object);
+    if ((index != NULL) && (index->entries != NULL))
+    {
+        size_t entry = index->buckets[hash_name(name) & (index->size - 1)];
+        while (entry != 0)
+        {
+            current_element = index->entries[entry - 1].item;
+            if (name_matches(current_element, name, length, case_sensitive))
+            {
+                return current_element;
+            }
+            entry = index->entries[entry - 1].next;
+        }
+
+        return NULL;
+    }
+
+    current_element = object->child;
+    while ((current_element != NULL) && !name_matches(current_element, name, length, case_sensitive))
+    {
+        current_element = current_element->next;
+    }
+
+    return current_element;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_GetObjectItem(const cJSON *object, const char *string)
+{
+    return get_object_item(object, string, false);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemCaseSensitive(const cJSON * const object, const char * const string)
+{
+    return get_object_item(object, string, true);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_HasObjectItem(const cJSON *object, const char *string)
+{
+    return cJSON_GetObjectItem(object, string) ? 1 : 0;
+}
+
+CJSON_PUBLIC(size_t) cJSON_HashName(const char *name)
+{
+    return hash_name(name);
+}
+
+/* name has no '\0' in its length bytes, so strncmp only matches names that are at least that long */
+static cJSON_bool name_matches_length(const cJSON * const item, const char * const name, const size_t length)
+{
+    if (stored_name_length(item) != 0)
+    {
+        return (stored_name_length(item) == length) && (memcmp(item->string, name, length) == 0);
+    }
+
+    return (item->string != NULL) && (strncmp(item->string, name, length) == 0) && (item->string[length] == '\0');
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemWithHash(const cJSON *object, const char *name, size_t length, size_t hash)
+{
+    cJSON *current_element = NULL;
+    const struct cJSON_Index *index = NULL;
+
+    if ((object == NULL) || (name == NULL) || !load_lazy(object))
+    {
+        return NULL;
+    }
+
+    index = usable_index(object);
+    if ((index != NULL) && (index->entries != NULL))
+    {
+        size_t entry = index->buckets[hash & (index->size - 1)];
+        while (entry != 0)
+        {
+            current_element = index->entries[entry - 1].item;
+            if (name_matches_length(current_element, name, length))
+            {
+                return current_element;
+            }
+            entry = index->entries[entry - 1].next;
+        }
+
+        return NULL;
+    }
+
+    current_element = object->child;
+    while ((current_element != NULL) && !name_matches_length(current_element, name, length))
+    {
+        current_element = current_element->next;
+    }
+
+    return current_element;
+}
+
+/* Utility for array list handling. */
+static void suffix_object(cJSON *prev, cJSON *item)
+{
+    prev->next = item;
+    item->prev = prev;
+}
+
+/* Utility for handling references. */
+static cJSON *create_reference(const cJSON *item, const internal_hooks * const hooks)
+{
+    cJSON *ref = NULL;
+
+    /* the reference has to see the children of the original */
+    if (!load_lazy(item))
+    {
+        return NULL;
+    }
+    ref = cJSON_New_Item(hooks);
+    if (!ref)
+    {
+        return NULL;
+    }
+    memcpy(ref, item, sizeof(cJSON));
+    ref->string = NULL;
+    ref->string_length = 0;
+    if (ref->type & cJSON_IsIndexed)
+    {
+        /* the index belongs to the original */
+        set_index(ref, NULL);
+    }
+    ref->type |= cJSON_IsReference;
+    ref->next = ref->prev = NULL;
+    return ref;
+}
+
+/* Add item to array/object. */
+CJSON_PUBLIC(void) cJSON_AddItemToArray(cJSON *array, cJSON *item)
+{
+    cJSON *child = NULL;
+
+    if ((item == NULL) || (array == NULL) || (array->type & cJSON_IsFrozen) || !load_lazy(array))
+    {
+        return;
+    }
+    array->type &= ~(cJSON_IsRendered | cJSON_IsHashed);
+
+    child = array->child;
+
+    if (child == NULL)
+    {
+        /* list is empty, start new one */
+        array->child = item;
+    }
+    else
+    {
+        /* the first child points to the last one, lists that were linked by hand may not have that */
+        child = child->prev;
+        if (child == NULL)
+        {
+            for (child = array->child; child->next; child = child->next)
+            {
+            }
+        }
+        suffix_object(child, item);
+    }
+    array->child->prev = item;
+
+    if (get_index(array) != NULL)
+    {
+        index_append(array, item);
+    }
+}
+
+/* the key is copied with hooks unless constant_key is set */
+static void add_item_to_object(cJSON * const object, const char * const string, cJSON * const item, const internal_hooks * const hooks, const cJSON_bool constant_key)
+{
+    char *key = NULL;
+    size_t length = 0;
+
+    if (!item || ((object != NULL) && (object->type & cJSON_IsFrozen)))
+    {
+        return;
+    }
+    if (string != NULL)
+    {
+        length = strlen(string);
+    }
+    if (constant_key)
+    {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-qual"
+        key = (char*)string;
+#pragma GCC diagnostic pop
+    }
+    else if (string != NULL)
+    {
+        /* if string is the old name in the room of item, it is copied onto itself */
+        key = store_string(item, true, string, length, hooks);
+    }
+    if (!(item->type & cJSON_StringIsConst) && item->string)
+    {
+        deallocate_string(item, item->string, hooks);
+    }
+    item->string = key;
+    store_name_length(item, (key != NULL) ? length : 0);
+    if (constant_key)
+    {
+        item->type |= cJSON_StringIsConst;
+    }
+    else
+    {
+        item->type &= ~cJSON_StringIsConst;
+    }
+    cJSON_AddItemToArray(object, item);
+}
+
+CJSON_PUBLIC(void) cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item)
+{
+    add_item_to_object(object, string, item, &global_hooks, false);
+}
+
+/* Add an item to an object with constant string as key */
+CJSON_PUBLIC(void) cJSON_AddItemToObjectCS(cJSON *object, const char *string, cJSON *item)
+{
+    add_item_to_object(object, string, item, &global_hooks, true);
+}
+
+CJSON_PUBLIC(void) cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item)
+{
+    cJSON_AddItemToArray(array, create_reference(item, &global_hooks));
+}
+
+CJSON_PUBLIC(void) cJSON_AddItemReferenceToObject(cJSON *object, const char *string, cJSON *item)
+{
+    cJSON_AddItemToObject(object, string, create_reference(item, &global_hooks));
+}
+
+/* the elements one thread has added, padded so threads that append to neighbouring lanes don't share a cache line */
+typedef union
+{
+    struct
+    {
+        cJSON *first;
+        cJSON *last;
+        size_t count;
+    } list;
+    unsigned char padding[64];
+} builder_lane;
+
+struct cJSON_ArrayBuilder
+{
+    builder_lane *lanes;
+    size_t count;
+};
+
+CJSON_PUBLIC(cJSON_ArrayBuilder *) cJSON_CreateArrayBuilder(size_t lanes)
+{
+    cJSON_ArrayBuilder *builder = NULL;
+
+    if ((lanes == 0) || (lanes > ((size_t)-1 / sizeof(builder_lane))))
+    {
+        return NULL;
+    }
+
+    builder = (cJSON_ArrayBuilder*)global_hooks.allocate(sizeof(cJSON_ArrayBuilder));
+    if (builder == NULL)
+    {
+        return NULL;
+    }
+    builder->lanes = (builder_lane*)global_hooks.allocate(lanes * sizeof(builder_lane));
+    if (builder->lanes == NULL)
+    {
+        global_hooks.deallocate(builder);
+        return NULL;
+    }
+    memset(builder->lanes, '\0', lanes * sizeof(builder_lane));
+    builder->count = lanes;
+
+    return builder;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteArrayBuilder(cJSON_ArrayBuilder *builder)
+{
+    size_t i = 0;
+
+    if (builder == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < builder->count; i++)
+    {
+        if (builder->lanes[i].list.first != NULL)
+        {
+            delete_item(builder->lanes[i].list.first, &global_hooks);
+        }
+    }
+    global_hooks.deallocate(builder->lanes);
+    global_hooks.deallocate(builder);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_ArrayBuilderAdd(cJSON_ArrayBuilder *builder, size_t lane, cJSON *item)
+{
+    builder_lane *target = NULL;
+
+    if ((builder == NULL) || (lane >= builder->count) || (item == NULL))
+    {
+        return false;
+    }
+
+    /* only the lane is touched, nothing shared with the other threads */
+    target = &builder->lanes[lane];
+    item->next = NULL;
+    item->prev = target->list.last;
+    if (target->list.last == NULL)
+    {
+        target->list.first = item;
+    }
+    else
+    {
+        target->list.last->next = item;
+    }
+    target->list.last = item;
+    target->list.count++;
+
+    return true;
+}
+
+CJSON_PUBLIC(size_t) cJSON_ArrayBuilderCount(const cJSON_ArrayBuilder *builder)
+{
+    size_t count = 0;
+    size_t i = 0;
+
+    if (builder == NULL)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < builder->count; i++)
+    {
+        count += builder->lanes[i].list.count;
+    }
+
+    return count;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_ArrayBuilderFinish(cJSON_ArrayBuilder *builder, cJSON *array)
+{
+    cJSON *last = NULL;
+    size_t i = 0;
+
+    if ((builder == NULL) || !cJSON_IsArray(array) || (array->type & cJSON_IsFrozen) || !load_lazy(array))
+    {
+        return false;
+    }
+    array->type &= ~(cJSON_IsRendered | cJSON_IsHashed);
+
+    /* the first child points to the last one */
+    if (array->child != NULL)
+    {
+        last = array->child->prev;
+        if (last == NULL)
+        {
+            for (last = array->child; last->next != NULL; last = last->next)
+            {
+            }
+        }
+    }
+    for (i = 0; i < builder->count; i++)
+    {
+        builder_lane * const lane = &builder->lanes[i];
+        if (lane->list.first == NULL)
+        {
+            continue;
+        }
+        if (last == NULL)
+        {
+            array->child = lane->list.first;
+        }
+        else
+        {
+            suffix_object(last, lane->list.first);
+        }
+        last = lane->list.last;
+        memset(lane, '\0', sizeof(builder_lane));
+    }
+    if (last != NULL)
+    {
+        array->child->prev = last;
+    }
+
+    /* the index is brought up to date the next time it is used */
+    if (get_index(array) != NULL)
+    {
+        get_index(array)->stale = true;
+    }
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_DetachItemViaPointer(cJSON *parent, cJSON * const c)
+{
+    if ((parent == NULL) || (c == NULL) || (parent->type & cJSON_IsFrozen))
+    {
+        return NULL;
+    }
+
+    parent->type &= ~(cJSON_IsRendered | cJSON_IsHashed);
+    if ((c != parent->child) && (c->prev != NULL))
+    {
+        /* not the first element */
+        c->prev->next = c->next;
+    }
+    if (c->next)
+    {
+        /* the first child takes over the pointer to the last one */
+        c->next->prev = c->prev;
+    }
+    if (c == parent->child)
+    {
+        parent->child = c->next;
+    }
+    else if ((c->next == NULL) && (parent->child != NULL))
+    {
+        /* the last one was removed */
+        parent->child->prev = c->prev;
+    }
+    /* make sure the detached item doesn't point anywhere anymore */
+    c->prev = c->next = NULL;
+
+    if (get_index(parent) != NULL)
+    {
+        index_remove(get_index(parent), c);
+    }
+
+    return c;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromArray(cJSON *array, int which)
+{
+    if (which < 0)
+    {
+        return NULL;
+    }
+
+    return cJSON_DetachItemViaPointer(array, get_array_item(array, (size_t)which));
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteItemFromArray(cJSON *array, int which)
+{
+    cJSON_Delete(cJSON_DetachItemFromArray(array, which));
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromObject(cJSON *object, const char *string)
+{
+    return cJSON_DetachItemViaPointer(object, get_object_item(object, string, false));
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteItemFromObject(cJSON *object, const char *string)
+{
+    cJSON_Delete(cJSON_DetachItemFromObject(object, string));
+}
+
+/* Replace array/object items with new ones. */
+CJSON_PUBLIC(void) cJSON_InsertItemInArray(cJSON *array, int which, cJSON *newitem)
+{
+    size_t position = (which > 0) ? (size_t)which : 0;
+    cJSON *c = NULL;
+    if ((array == NULL) || (array->type & cJSON_IsFrozen))
+    {
+        return;
+    }
+    c = get_array_item(array, position);
+    if (!c)
+    {
+        cJSON_AddItemToArray(array, newitem);
+        return;
+    }
+    array->type &= ~(cJSON_IsRendered | cJSON_IsHashed);
+    newitem->next = c;
+    newitem->prev = c->prev;
+    c->prev = newitem;
+    if (c == array->child)
+    {
+        array->child = newitem;
+    }
+    else
+    {
+        newitem->prev->next = newitem;
+    }
+
+    if (get_index(array) != NULL)
+    {
+        index_insert_at(array, position, newitem);
+    }
+}
+
+static void replace_item(cJSON * const parent, cJSON * const c, cJSON * const newitem)
+{
+    parent->type &= ~(cJSON_IsRendered | cJSON_IsHashed);
+    if (get_index(parent) != NULL)
+    {
+        index_replace(get_index(parent), c, newitem);
+    }
+
+    newitem->next = c->next;
+    newitem->prev = c->prev;
+    if (newitem->next)
+    {
+        newitem->next->prev = newitem;
+    }
+    if (c == parent->child)
+    {
+        if (c->prev == c)
+        {
+            /* the only child points to itself */
+            newitem->prev = newitem;
+        }
+        parent->child = newitem;
+    }
+    else
+    {
+        newitem->prev->next = newitem;
+        if (newitem->next == NULL)
+        {
+            parent->child->prev = newitem;
+        }
+    }
+    c->next = c->prev = NULL;
+}
+
+CJSON_PUBLIC(void) cJSON_ReplaceItemInArray(cJSON *array, int which, cJSON *newitem)
+{
+    cJSON *c = NULL;
+
+    if (which < 0)
+    {
+        return;
+    }
+
+    c = get_array_item(array, (size_t)which);
+    if ((c == NULL) || (newitem == NULL) || (c == newitem) || (array->type & cJSON_IsFrozen))
+    {
+        return;
+    }
+
+    /* unlike cJSON_ReplaceItemViaPointer the key of the old item is not moved over */
+    replace_item(array, c, newitem);
+    cJSON_Delete(c);
+}
+
+CJSON_PUBLIC(void) cJSON_ReplaceItemInObject(cJSON *object, const char *string, cJSON *newitem)
+{
+    cJSON *c = get_object_item(object, string, false);
+    size_t length = 0;
+    if ((c == NULL) || (newitem == NULL) || (c == newitem) || (object->type & cJSON_IsFrozen))
+    {
+        return;
+    }
+
+    /* free the old string if not const */
+    if (!(newitem->type & cJSON_StringIsConst) && newitem->string)
+    {
+         deallocate_string(newitem, newitem->string, &global_hooks);
+    }
+
+    length = strlen(string);
+    newitem->string = store_string(newitem, true, string, length, &global_hooks);
+    store_name_length(newitem, (newitem->string != NULL) ? length : 0);
+    newitem->type &= ~cJSON_StringIsConst;
+    cJSON_ReplaceItemViaPointer(object, c, newitem);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemViaPointer(cJSON * const parent, cJSON * const item, cJSON *replacement)
+{
+    cJSON_bool move_key = false;
+
+    if ((parent == NULL) || (item == NULL) || (replacement == NULL) || (item == replacement) || (parent->type & cJSON_IsFrozen))
+    {
+        return false;
+    }
+
+    move_key = (replacement->string == NULL) && (item->string != NULL);
+    if (move_key)
+    {
+        replacement->string = item->string;
+        if (is_inline_string(item, item->string))
+        {
+            /* the room of item goes away with it, the name fits into the room of replacement as well */
+            replacement->string = store_string(replacement, true, item->string, name_length(item), &global_hooks);
+        }
+        store_name_length(replacement, stored_name_length(item));
+        replacement->type = (replacement->type & ~cJSON_StringIsConst) | (item->type & cJSON_StringIsConst);
+    }
+    replace_item(parent, item, replacement);
+    if (move_key)
+    {
+        item->string = NULL;
+        item->string_length = 0;
+    }
+    cJSON_Delete(item);
+
+    return true;
+}
+
+/* Create basic types: */
+static cJSON *create_item(const int type, const internal_hooks * const hooks)
+{
+    cJSON *item = cJSON_New_Item(hooks);
+    if (item)
+    {
+        item->type = type;
+    }
+
+    return item;
+}
+
+static cJSON *create_number(const double num, const internal_hooks * const hooks)
+{
+    cJSON *item = cJSON_New_Item(hooks);
+    if(item)
+    {
+        item->type = cJSON_Number;
+        item->valuedouble = num;
+
+        /* use saturation in case of overflow */
+        if (num >= INT_MAX)
+        {
+            item->valueint = INT_MAX;
+        }
+        else if (num <= INT_MIN)
+        {
+            item->valueint = INT_MIN;
+        }
+        else
+        {
+            item->valueint = (int)num;
+        }
+    }
+
+    return item;
+}
+
+/* strings and raw JSON */
+static cJSON *create_string(const int type, const char * const string, const internal_hooks * const hooks)
+{
+    cJSON *item = cJSON_New_Item(hooks);
+    if(item)
+    {
+        size_t length = (string != NULL) ? strlen(string) : 0;
+        item->type = type;
+        item->valuestring = (string != NULL) ? store_string(item, false, string, length, hooks) : NULL;
+        if(!item->valuestring)
+        {
+            delete_item(item, hooks);
+            return NULL;
+        }
+        store_valuestring_length(item, length);
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateNull(void)
+{
+    return create_item(cJSON_NULL, &global_hooks);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateTrue(void)
+{
+    return create_item(cJSON_True, &global_hooks);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateFalse(void)
+{
+    return create_item(cJSON_False, &global_hooks);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateBool(cJSON_bool b)
+{
+    return create_item(b ? cJSON_True : cJSON_False, &global_hooks);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateNumber(double num)
+{
+    return create_number(num, &global_hooks);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateString(const char *string)
+{
+    return create_string(cJSON_String, string, &global_hooks);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateRaw(const char *raw)
+{
+    return create_string(cJSON_Raw, raw, &global_hooks);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateArray(void)
+{
+    return create_item(cJSON_Array, &global_hooks);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateObject(void)
+{
+    return create_item(cJSON_Object, &global_hooks);
+}
+
+/* Create Arrays: */
+/* Append count number items to array, which has no children yet. */
+static cJSON_bool append_numbers(cJSON * const array, const double * const numbers, const size_t count, const internal_hooks * const hooks)
+{
+    cJSON *last = NULL;
+    cJSON *number = NULL;
+    size_t i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        number = create_number(numbers[i], hooks);
+        if (number == NULL)
+        {
+            if (array->child != NULL)
+            {
+                delete_item(array->child, hooks);
+                array->child = NULL;
+            }
+            return false;
+        }
+        if (last == NULL)
+        {
+            array->child = number;
+        }
+        else
+        {
+            suffix_object(last, number);
+        }
+        last = number;
+    }
+    if (array->child != NULL)
+    {
+        array->child->prev = last;
+    }
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateIntArray(const int *numbers, int count)
+{
+    size_t i = 0;
+    cJSON *n = NULL;
+    cJSON *p = NULL;
+    cJSON *a = NULL;
+
+    if (count < 0)
+    {
+        return NULL;
+    }
+
+    a = cJSON_CreateArray();
+    for(i = 0; a && (i < (size_t)count); i++)
+    {
+        n = cJSON_CreateNumber(numbers[i]);
+        if (!n)
+        {
+            cJSON_Delete(a);
+            return NULL;
+        }
+        if(!i)
+        {
+            a->child = n;
+        }
+        else
+        {
+            suffix_object(p, n);
+        }
+        p = n;
+    }
+    if ((a != NULL) && (a->child != NULL))
+    {
+        a->child->prev = n;
+    }
+
+    return a;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateFloatArray(const float *numbers, int count)
+{
+    size_t i = 0;
+    cJSON *n = NULL;
+    cJSON *p = NULL;
+    cJSON *a = NULL;
+
+    if (count < 0)
+    {
+        return NULL;
+    }
+
+    a = cJSON_CreateArray();
+
+    for(i = 0; a && (i < (size_t)count); i++)
+    {
+        n = cJSON_CreateNumber((double)numbers[i]);
+        if(!n)
+        {
+            cJSON_Delete(a);
+            return NULL;
+        }
+        if(!i)
+        {
+            a->child = n;
+        }
+        else
+        {
+            suffix_object(p, n);
+        }
+        p = n;
+    }
+    if ((a != NULL) && (a->child != NULL))
+    {
+        a->child->prev = n;
+    }
+
+    return a;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateDoubleArray(const double *numbers, int count)
+{
+    size_t i = 0;
+    cJSON *n = NULL;
+    cJSON *p = NULL;
+    cJSON *a = NULL;
+
+    if (count < 0)
+    {
+        return NULL;
+    }
+
+    a = cJSON_CreateArray();
+
+    for(i = 0;a && (i < (size_t)count); i++)
+    {
+        n = cJSON_CreateNumber(numbers[i]);
+        if(!n)
+        {
+            cJSON_Delete(a);
+            return NULL;
+        }
+        if(!i)
+        {
+            a->child = n;
+        }
+        else
+        {
+            suffix_object(p, n);
+        }
+        p = n;
+    }
+    if ((a != NULL) && (a->child != NULL))
+    {
+        a->child->prev = n;
+    }
+
+    return a;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateStringArray(const char **strings, int count)
+{
+    size_t i = 0;
+    cJSON *n = NULL;
+    cJSON *p = NULL;
+    cJSON *a = NULL;
+
+    if (count < 0)
+    {
+        return NULL;
+    }
+
+    a = cJSON_CreateArray();
+
+    for (i = 0; a && (i < (size_t)count); i++)
+    {
+        n = cJSON_CreateString(strings[i]);
+        if(!n)
+        {
+            cJSON_Delete(a);
+            return NULL;
+        }
+        if(!i)
+        {
+            a->child = n;
+        }
+        else
+        {
+            suffix_object(p,n);
+        }
+        p = n;
+    }
+    if ((a != NULL) && (a->child != NULL))
+    {
+        a->child->prev = n;
+    }
+
+    return a;
+}
+
+/* Create the count elements of values and types (and the names in keys if that isn't NULL) and link them into container
+ * in one pass. */
+static cJSON *create_from_arrays(const int type, const char * const * const keys, const cJSON_Value * const values, const int * const types, const size_t count, const internal_hooks * const hooks)
+{
+    cJSON *container = NULL;
+    cJSON *element = NULL;
+    cJSON *last = NULL;
+    size_t length = 0;
+    size_t i = 0;
+
+    if (((count > 0) && ((values == NULL) || (types == NULL))) || ((keys == NULL) && (type == cJSON_Object)))
+    {
+        return NULL;
+    }
+    container = create_item(type, hooks);
+    for (i = 0; (container != NULL) && (i < count); i++)
+    {
+        switch (types[i])
+        {
+            case cJSON_NULL:
+            case cJSON_False:
+            case cJSON_True:
+                element = create_item(types[i], hooks);
+                break;
+            case cJSON_Number:
+                element = create_number(values[i].number, hooks);
+                break;
+            case cJSON_String:
+            case cJSON_Raw:
+                element = create_string(types[i], values[i].string, hooks);
+                break;
+            default:
+                element = NULL;
+                break;
+        }
+        if ((element != NULL) && (keys != NULL))
+        {
+            length = (keys[i] != NULL) ? strlen(keys[i]) : 0;
+            element->string = (keys[i] != NULL) ? store_string(element, true, keys[i], length, hooks) : NULL;
+            store_name_length(element, length);
+            if (element->string == NULL)
+            {
+                delete_item(element, hooks);
+                element = NULL;
+            }
+        }
+        if (element == NULL)
+        {
+            delete_item(container, hooks);
+            return NULL;
+        }
+
+        if (last == NULL)
+        {
+            container->child = element;
+        }
+        else
+        {
+            suffix_object(last, element);
+        }
+        last = element;
+    }
+    if ((container != NULL) && (container->child != NULL))
+    {
+        container->child->prev = last;
+    }
+
+    return container;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateObjectFromArrays(const char * const *keys, const cJSON_Value *values, const int *types, size_t count)
+{
+    return create_from_arrays(cJSON_Object, keys, values, types, count, &global_hooks);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateArrayFromArrays(const cJSON_Value *values, const int *types, size_t count)
+{
+    return create_from_arrays(cJSON_Array, NULL, values, types, count, &global_hooks);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreatePackedArray(const double *numbers, int count)
+{
+    double *copy = NULL;
+    cJSON *a = NULL;
+
+    if ((count < 0) || ((numbers == NULL) && (count > 0)) || ((size_t)count > (((size_t)-1) / sizeof(double))))
+    {
+        return NULL;
+    }
+
+    a = cJSON_CreateArray();
+    if ((a == NULL) || (count == 0))
+    {
+        /* an empty array has nothing to pack */
+        return a;
+    }
+
+    copy = (double*)global_hooks.allocate((size_t)count * sizeof(double));
+    if (copy == NULL)
+    {
+        cJSON_Delete(a);
+        return NULL;
+    }
+    memcpy(copy, numbers, (size_t)count * sizeof(double));
+    a->type |= cJSON_IsPacked;
+    a->valuestring = (char*)copy;
+    a->valueint = count;
+
+    return a;
+}
+
+CJSON_PUBLIC(double *) cJSON_GetPackedNumbers(cJSON *array)
+{
+    if ((array == NULL) || !(array->type & cJSON_IsPacked))
+    {
+        return NULL;
+    }
+
+    return packed_numbers(array);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateBinary(const void *data, size_t length)
+{
+    cJSON *item = NULL;
+
+    if (((data == NULL) && (length > 0)) || (length > INT_MAX))
+    {
+        return NULL;
+    }
+
+    item = cJSON_New_Item(&global_hooks);
+    if (item == NULL)
+    {
+        return NULL;
+    }
+    /* the text is made in the same buffer */
+    item->valuestring = (char*)global_hooks.allocate(base64_length(length) + 1);
+    if (item->valuestring == NULL)
+    {
+        cJSON_Delete(item);
+        return NULL;
+    }
+    if (length > 0)
+    {
+        memcpy(item->valuestring, data, length);
+    }
+    item->valuestring[length] = '\0';
+    item->type = cJSON_String | cJSON_IsBinary;
+    item->valueint = (int)length;
+
+    return item;
+}
+
+CJSON_PUBLIC(unsigned char *) cJSON_GetBinaryValue(const cJSON *item, size_t *length)
+{
+    cJSON *binary = NULL;
+    unsigned char *bytes = NULL;
+    size_t text_length = 0;
+    size_t decoded = 0;
+
+    if ((item == NULL) || ((item->type & 0xFF) != cJSON_String) || (item->valuestring == NULL))
+    {
+        return NULL;
+    }
+    if (!(item->type & cJSON_IsBinary))
+    {
+        if (item->type & (cJSON_IsReference | cJSON_IsFrozen))
+        {
+            return NULL;
+        }
+        /* decoding doesn't change the value, so it is allowed through const pointers */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-qual"
+        binary = (cJSON*)item;
+#pragma GCC diagnostic pop
+        if ((item->type & cJSON_IsLazy) && (memchr(item->valuestring, '\\', (size_t)item->valueint) == NULL))
+        {
+            /* straight from the parsed text, which isn't ours to write to */
+            text_length = (size_t)item->valueint;
+            bytes = (unsigned char*)allocate_memory(text_length + 1, &global_hooks);
+            if (bytes == NULL)
+            {
+                return NULL;
+            }
+            decoded = decode_base64(bytes, (const unsigned char*)item->valuestring, text_length);
+            if (decoded == (size_t)-1)
+            {
+                deallocate_memory(bytes, &global_hooks);
+                return NULL;
+            }
+        }
+        else
+        {
+            if (!load_lazy(item))
+            {
+                return NULL;
+            }
+            /* in place, after checking all of it so a failure leaves the text as it was */
+            bytes = (unsigned char*)item->valuestring;
+            text_length = valuestring_length(item);
+            if (((text_length / 4) * 3 > INT_MAX) || (decode_base64(NULL, bytes, text_length) == (size_t)-1))
+            {
+                return NULL;
+            }
+            decoded = decode_base64(bytes, bytes, text_length);
+        }
+        bytes[decoded] = '\0';
+        binary->valuestring = (char*)bytes;
+        binary->valuestring_length = 0;
+        binary->valueint = (int)decoded;
+        binary->type = (binary->type & ~cJSON_IsLazy) | cJSON_IsBinary;
+    }
+
+    if (length != NULL)
+    {
+        *length = (size_t)item->valueint;
+    }
+
+    return (unsigned char*)item->valuestring;
+}
+
+/* Copy an item without its children. */
+static cJSON *duplicate_item(const cJSON * const item, const internal_hooks * const hooks)
+{
+    cJSON *newitem = cJSON_New_Item(hooks);
+    if (!newitem)
+    {
+        return NULL;
+    }
+    /* Copy over all vars */
+    newitem->type = item->type & ~(cJSON_IsReference | cJSON_IsFrozen | cJSON_IsHashed | cJSON_IsIndexed);
+    newitem->valueint = item->valueint;
+    newitem->valuedouble = item->valuedouble;
+    if (item->type & cJSON_IsLazy)
+    {
+        /* the copy is lazy too and shares the text */
+        newitem->valuestring = item->valuestring;
+    }
+    else if ((item->type & cJSON_IsPacked) && (hooks != &global_hooks))
+    {
+        /* packed arrays are unpacked with the global hooks, so other copies get their nodes right away */
+        newitem->type &= ~cJSON_IsPacked;
+        newitem->valueint = 0;
+        if (!append_numbers(newitem, packed_numbers(item), (size_t)item->valueint, hooks))
+        {
+            goto fail;
+        }
+    }
+    else if (item->type & cJSON_IsPacked)
+    {
+        newitem->valuestring = (char*)allocate_memory((size_t)item->valueint * sizeof(double), hooks);
+        if (!newitem->valuestring)
+        {
+            goto fail;
+        }
+        memcpy(newitem->valuestring, item->valuestring, (size_t)item->valueint * sizeof(double));
+    }
+    else if (item->type & cJSON_IsBinary)
+    {
+        /* with the room for the text, like the original */
+        newitem->valuestring = (char*)allocate_memory(base64_length((size_t)item->valueint) + 1, hooks);
+        if (!newitem->valuestring)
+        {
+            goto fail;
+        }
+        memcpy(newitem->valuestring, item->valuestring, (size_t)item->valueint + 1);
+    }
+    else if (item->valuestring && !(item->type & cJSON_IsIndexed))
+    {
+        const size_t length = valuestring_length(item);
+        newitem->valuestring = store_string(newitem, false, item->valuestring, length, hooks);
+        if (!newitem->valuestring)
+        {
+            goto fail;
+        }
+        store_valuestring_length(newitem, length);
+    }
+    if (item->string)
+    {
+        const size_t length = name_length(item);
+        newitem->string = (item->type&cJSON_StringIsConst) ? item->string : store_string(newitem, true, item->string, length, hooks);
+        if (!newitem->string)
+        {
+            goto fail;
+        }
+        store_name_length(newitem, length);
+    }
+
+    return newitem;
+
+fail:
+    delete_item(newitem, hooks);
+
+    return NULL;
+}
+
+static cJSON *duplicate(const cJSON * const item, const cJSON_bool recurse, const internal_hooks * const hooks)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    cJSON *newitem = NULL;
+    cJSON *newchild = NULL;
+
+    /* Bail on bad ptr */
+    if (!item)
+    {
+        return NULL;
+    }
+    /* Create new item */
+    newitem = duplicate_item(item, hooks);
+    /* If non-recursive, then we're done! */
+    if ((newitem == NULL) || !recurse || (item->child == NULL))
+    {
+        return newitem;
+    }
+
+    /* Walk the tree with an explicit stack, every frame copies the children of one item */
+    nesting_init(&stack, hooks);
+    frame = nesting_push(&stack); /* can't fail, the first frames are on the C stack */
+    frame->current = item->child;
+    frame->container = newitem;
+    for (;;)
+    {
+        newchild = duplicate_item(frame->current, hooks);
+        if (!newchild)
+        {
+            goto fail;
+        }
+        if (frame->last != NULL)
+        {
+            /* If the container already has a child, then crosswire ->prev and ->next and move on */
+            frame->last->next = newchild;
+            newchild->prev = frame->last;
+        }
+        else
+        {
+            frame->container->child = newchild;
+        }
+        frame->container->child->prev = newchild;
+        frame->last = newchild;
+
+        if (frame->current->child != NULL)
+        {
+            const cJSON *child = frame->current->child;
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                goto fail;
+            }
+            frame->current = child;
+            frame->container = newchild;
+            continue;
+        }
+
+        /* go to the next item, leaving the ones whose children are all copied */
+        while ((stack.depth > 0) && (stack.frames[stack.depth - 1].current->next == NULL))
+        {
+            stack.depth--;
+        }
+        if (stack.depth == 0)
+        {
+            break;
+        }
+        frame = &stack.frames[stack.depth - 1];
+        frame->current = frame->current->next;
+    }
+    nesting_free(&stack);
+
+    return newitem;
+
+fail:
+    nesting_free(&stack);
+    delete_item(newitem, hooks);
+
+    return NULL;
+}
+
+/* Duplication */
+CJSON_PUBLIC(cJSON *) cJSON_Duplicate(const cJSON *item, cJSON_bool recurse)
+{
+    return duplicate(item, recurse, &global_hooks);
+}
+
+/* FNV-1a */
+static unsigned long hash_bytes(unsigned long hash, const unsigned char *bytes, const size_t length)
+{
+    size_t i = 0;
+    for (i = 0; i < length; i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619UL;
+    }
+
+    return hash;
+}
+
+typedef struct
+{
+    const cJSON *item;
+    unsigned long hash;
+} hash_cache_entry;
+
+struct cJSON_HashCache
+{
+    hash_cache_entry *entries;
+    /* a power of two */
+    size_t size;
+    size_t count;
+};
+
+static size_t hash_pointer(const cJSON * const item)
+{
+    return (size_t)hash_bytes(2166136261UL, (const unsigned char*)&item, sizeof(item));
+}
+
+static cJSON_bool hash_cache_lookup(cJSON_HashCache * const cache, const cJSON * const item, unsigned long * const hash)
+{
+    size_t slot = 0;
+
+    if ((cache == NULL) || (cache->count == 0))
+    {
+        return false;
+    }
+
+    for (slot = hash_pointer(item) & (cache->size - 1); cache->entries[slot].item != NULL; slot = (slot + 1) & (cache->size - 1))
+    {
+        if (cache->entries[slot].item == item)
+        {
+            *hash = cache->entries[slot].hash;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void hash_cache_insert(cJSON_HashCache * const cache, const cJSON * const item, const unsigned long hash)
+{
+    size_t slot = 0;
+
+    if (cache == NULL)
+    {
+        return;
+    }
+    for (slot = hash_pointer(item) & (cache->size - 1); cache->entries[slot].item != NULL; slot = (slot + 1) & (cache->size - 1))
+    {
+        if (cache->entries[slot].item == item)
+        {
+            /* the item was changed or its memory is used by another one now */
+            cache->entries[slot].hash = hash;
+            return;
+        }
+    }
+
+    /* keep the table at most half full */
+    if ((2 * (cache->count + 1)) > cache->size)
+    {
+        size_t new_size = 2 * cache->size;
+        size_t i = 0;
+        cJSON_HashCache grown = *cache;
+
+        grown.entries = (hash_cache_entry*)global_hooks.allocate(new_size * sizeof(hash_cache_entry));
+        if (grown.entries == NULL)
+        {
+            return;
+        }
+        memset(grown.entries, '\0', new_size * sizeof(hash_cache_entry));
+        grown.size = new_size;
+        grown.count = 0;
+        for (i = 0; i < cache->size; i++)
+        {
+            if (cache->entries[i].item != NULL)
+            {
+                hash_cache_insert(&grown, cache->entries[i].item, cache->entries[i].hash);
+            }
+        }
+        global_hooks.deallocate(cache->entries);
+        *cache = grown;
+    }
+
+    for (slot = hash_pointer(item) & (cache->size - 1); cache->entries[slot].item != NULL; slot = (slot + 1) & (cache->size - 1))
+    {
+    }
+    cache->entries[slot].item = item;
+    cache->entries[slot].hash = hash;
+    cache->count++;
+}
+
+/* Mark item as hashed with a cache. That doesn't change its value, so it is allowed through const pointers. */
+static void mark_hashed(const cJSON * const hashed_item)
+{
+    cJSON *item = NULL;
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-qual"
+    item = (cJSON*)hashed_item;
+#pragma GCC diagnostic pop
+    item->type |= cJSON_IsHashed;
+}
+
+/* whether all elements of item were hashed with a cache and not changed since, frozen ones can't be changed */
+static cJSON_bool elements_unchanged(const cJSON * const item)
+{
+    const cJSON *child = NULL;
+
+    for (child = item->child; child != NULL; child = child->next)
+    {
+        if (!(child->type & cJSON_IsFrozen) && (!(child->type & cJSON_IsHashed) || !elements_unchanged(child)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static unsigned long hash_item(const cJSON * const item, cJSON_HashCache *cache)
+{
+    const cJSON *child = NULL;
+    unsigned long hash = 2166136261UL ^ (unsigned long)(item->type & 0xFF);
+    unsigned long members = 0;
+    unsigned long cached = 0;
+    const cJSON_bool unchanged = (item->type & cJSON_IsHashed) != 0;
+
+    if (item->type & cJSON_IsFrozen)
+    {
+        /* frozen items may be read by several threads, so they aren't marked */
+        cache = NULL;
+    }
+    else if (cache != NULL)
+    {
+        mark_hashed(item);
+    }
+
+    switch (item->type & 0xFF)
+    {
+        case cJSON_Number:
+        {
+            /* 0.0 == -0.0 */
+            double number = (number_value(item) == 0) ? 0 : number_value(item);
+            return hash_bytes(hash, (const unsigned char*)&number, sizeof(number));
+        }
+
+        case cJSON_String:
+        case cJSON_Raw:
+            if ((item->valuestring == NULL) || !load_lazy(item))
+            {
+                return hash;
+            }
+            return hash_bytes(hash, (const unsigned char*)item->valuestring, valuestring_length(item));
+
+        case cJSON_Array:
+        case cJSON_Object:
+            break;
+
+        default:
+            return hash;
+    }
+
+    if (!load_lazy(item))
+    {
+        return hash;
+    }
+    if (unchanged && hash_cache_lookup(cache, item, &cached) && elements_unchanged(item))
+    {
+        return cached;
+    }
+    for (child = item->child; child != NULL; child = child->next)
+    {
+        if ((item->type & 0xFF) == cJSON_Array)
+        {
+            hash = (hash ^ hash_item(child, cache)) * 16777619UL;
+        }
+        else
+        {
+            /* summed up, so the order of the members doesn't matter. keys are case insensitive like lookups */
+            members += ((unsigned long)hash_name(child->string) ^ hash_item(child, cache)) * 16777619UL;
+        }
+    }
+    hash = (hash ^ members) * 16777619UL;
+    hash_cache_insert(cache, item, hash);
+
+    return hash;
+}
+
+CJSON_PUBLIC(unsigned long) cJSON_Hash(const cJSON *item)
+{
+    if (item == NULL)
+    {
+        return 0;
+    }
+
+    return hash_item(item, NULL);
+}
+
+CJSON_PUBLIC(cJSON_HashCache *) cJSON_CreateHashCache(void)
+{
+    cJSON_HashCache *cache = (cJSON_HashCache*)global_hooks.allocate(sizeof(cJSON_HashCache));
+    if (cache == NULL)
+    {
+        return NULL;
+    }
+    memset(cache, '\0', sizeof(cJSON_HashCache));
+    cache->size = 64;
+    cache->entries = (hash_cache_entry*)global_hooks.allocate(cache->size * sizeof(hash_cache_entry));
+    if (cache->entries == NULL)
+    {
+        global_hooks.deallocate(cache);
+        return NULL;
+    }
+    memset(cache->entries, '\0', cache->size * sizeof(hash_cache_entry));
+
+    return cache;
+}
+
+CJSON_PUBLIC(unsigned long) cJSON_HashWithCache(cJSON_HashCache *cache, const cJSON *item)
+{
+    if (item == NULL)
+    {
+        return 0;
+    }
+
+    return hash_item(item, cache);
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteHashCache(cJSON_HashCache *cache)
+{
+    if (cache == NULL)
+    {
+        return;
+    }
+
+    global_hooks.deallocate(cache->entries);
+    global_hooks.deallocate(cache);
+}
+
+/* Deduplication: the first of equal strings and arrays or objects keeps them, the others refer to it */
+typedef struct
+{
+    hash_cache_entry *entries;
+    /* a power of two */
+    size_t size;
+    size_t count;
+} shared_items;
+
+/* Whether a and b print the same, apart from their names. Equal arrays and objects below them share their children
+ * already, so comparing the children of arrays and objects doesn't have to go deeper. */
+static cJSON_bool same_value(const cJSON * const a, const cJSON * const b)
+{
+    if ((a->type & 0xFF) != (b->type & 0xFF))
+    {
+        return false;
+    }
+
+    switch (a->type & 0xFF)
+    {
+        case cJSON_Number:
+            /* bitwise, 0 and -0 print differently */
+            return (a->valueint == b->valueint) && (memcmp(&a->valuedouble, &b->valuedouble, sizeof(double)) == 0);
+
+        case cJSON_String:
+        case cJSON_Raw:
+            if (a->valuestring == b->valuestring)
+            {
+                return true;
+            }
+            return (a->valuestring != NULL) && (b->valuestring != NULL) && (valuestring_length(a) == valuestring_length(b))
+                && (memcmp(a->valuestring, b->valuestring, valuestring_length(a)) == 0);
+
+        case cJSON_Array:
+        case cJSON_Object:
+            return a->child == b->child;
+
+        default:
+            return true;
+    }
+}
+
+static unsigned long shallow_hash(const cJSON * const item)
+{
+    const unsigned long hash = 2166136261UL ^ (unsigned long)(item->type & 0xFF);
+
+    switch (item->type & 0xFF)
+    {
+        case cJSON_Number:
+            return hash_bytes(hash, (const unsigned char*)&item->valuedouble, sizeof(item->valuedouble));
+
+        case cJSON_String:
+        case cJSON_Raw:
+            return (item->valuestring == NULL) ? hash : hash_bytes(hash, (const unsigned char*)item->valuestring, valuestring_length(item));
+
+        case cJSON_Array:
+        case cJSON_Object:
+            return hash_bytes(hash, (const unsigned char*)&item->child, sizeof(item->child));
+
+        default:
+            return hash;
+    }
+}
+
+/* the hash of a string, or of the children of an array or object in order */
+static unsigned long shared_hash(const cJSON * const item)
+{
+    const cJSON *child = NULL;
+    unsigned long hash = 2166136261UL ^ (unsigned long)(item->type & 0xFF);
+
+    if (!is_container(item))
+    {
+        return shallow_hash(item);
+    }
+    for (child = item->child; child != NULL; child = child->next)
+    {
+        if (child->string != NULL)
+        {
+            hash = hash_bytes(hash, (const unsigned char*)child->string, name_length(child));
+        }
+        hash = (hash ^ shallow_hash(child)) * 16777619UL;
+    }
+
+    return hash;
+}
+
+static cJSON_bool same_content(const cJSON * const a, const cJSON * const b)
+{
+    const cJSON *a_child = NULL;
+    const cJSON *b_child = NULL;
+
+    if (!is_container(a) || ((a->type & 0xFF) != (b->type & 0xFF)))
+    {
+        return same_value(a, b);
+    }
+
+    for (a_child = a->child, b_child = b->child; (a_child != NULL) && (b_child != NULL); a_child = a_child->next, b_child = b_child->next)
+    {
+        if (((a_child->string == NULL) != (b_child->string == NULL))
+            || ((a_child->string != NULL) && (strcmp(a_child->string, b_child->string) != 0))
+            || !same_value(a_child, b_child))
+        {
+            return false;
+        }
+    }
+
+    return (a_child == NULL) && (b_child == NULL);
+}
+
+/* Let item share the string or children of an equal item that came before, or remember it for the ones that follow.
+ * Returns 0 if out of memory. */
+static cJSON_bool share_item(shared_items * const shared, cJSON * const item)
+{
+    const cJSON *original = NULL;
+    unsigned long hash = 0;
+    size_t slot = 0;
+
+    if (item->type & cJSON_IsReference)
+    {
+        return true;
+    }
+    if (is_container(item) ? (item->child == NULL) : ((((item->type & 0xFF) != cJSON_String) && ((item->type & 0xFF) != cJSON_Raw))
+        || (item->valuestring == NULL) || is_inline_string(item, item->valuestring)))
+    {
+        /* nothing that could be shared */
+        return true;
+    }
+
+    hash = shared_hash(item);
+    for (slot = (size_t)hash & (shared->size - 1); shared->entries[slot].item != NULL; slot = (slot + 1) & (shared->size - 1))
+    {
+        if ((shared->entries[slot].hash == hash) && same_content(shared->entries[slot].item, item))
+        {
+            original = shared->entries[slot].item;
+            break;
+        }
+    }
+
+    if (original != NULL)
+    {
+        if (is_container(item))
+        {
+            delete_item(item->child, &global_hooks);
+            if (get_index(item) != NULL)
+            {
+                delete_index(get_index(item));
+                set_index(item, NULL);
+            }
+            item->child = original->child;
+        }
+        else
+        {
+            deallocate_string(item, item->valuestring, &global_hooks);
+            item->valuestring = original->valuestring;
+        }
+        item->type |= cJSON_IsReference;
+
+        return true;
+    }
+
+    /* keep the table at most half full */
+    if ((2 * (shared->count + 1)) > shared->size)
+    {
+        shared_items grown;
+        size_t i = 0;
+
+        grown.size = 2 * shared->size;
+        grown.count = 0;
+        grown.entries = (hash_cache_entry*)global_hooks.allocate(grown.size * sizeof(hash_cache_entry));
+        if (grown.entries == NULL)
+        {
+            return false;
+        }
+        memset(grown.entries, '\0', grown.size * sizeof(hash_cache_entry));
+        for (i = 0; i < shared->size; i++)
+        {
+            if (shared->entries[i].item != NULL)
+            {
+                for (slot = (size_t)shared->entries[i].hash & (grown.size - 1); grown.entries[slot].item != NULL; slot = (slot + 1) & (grown.size - 1))
+                {
+                }
+                grown.entries[slot] = shared->entries[i];
+                grown.count++;
+            }
+        }
+        global_hooks.deallocate(shared->entries);
+        *shared = grown;
+        for (slot = (size_t)hash & (shared->size - 1); shared->entries[slot].item != NULL; slot = (slot + 1) & (shared->size - 1))
+        {
+        }
+    }
+    shared->entries[slot].item = item;
+    shared->entries[slot].hash = hash;
+    shared->count++;
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_Deduplicate(cJSON *item)
+{
+    shared_items shared;
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    cJSON *current = item;
+    cJSON_bool success = true;
+
+    if ((item == NULL) || (item->type & cJSON_IsFrozen) || !load_lazy_tree(item))
+    {
+        return false;
+    }
+
+    shared.size = 64;
+    shared.count = 0;
+    shared.entries = (hash_cache_entry*)global_hooks.allocate(shared.size * sizeof(hash_cache_entry));
+    if (shared.entries == NULL)
+    {
+        return false;
+    }
+    memset(shared.entries, '\0', shared.size * sizeof(hash_cache_entry));
+
+    /* children come before their parents, so equal arrays and objects below a parent share their children already */
+    nesting_init(&stack, &global_hooks);
+    while (success)
+    {
+        if (is_container(current) && !(current->type & cJSON_IsReference) && (current->child != NULL))
+        {
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                success = false;
+                break;
+            }
+            frame->container = current;
+            current = current->child;
+            continue;
+        }
+
+        success = share_item(&shared, current);
+        /* leave the arrays and objects that end here */
+        while (success && (stack.depth > 0) && (current->next == NULL))
+        {
+            current = stack.frames[--stack.depth].container;
+            success = share_item(&shared, current);
+        }
+        if (stack.depth == 0)
+        {
+            break;
+        }
+        current = current->next;
+    }
+    nesting_free(&stack);
+    global_hooks.deallocate(shared.entries);
+
+    /* what is shared must not be changed through one of the items that share it */
+    return cJSON_Freeze(item) && success;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_Compare(const cJSON *a, const cJSON *b, cJSON_bool case_sensitive)
+{
+    const cJSON *a_child = NULL;
+    const cJSON *b_child = NULL;
+
+    if ((a == NULL) || (b == NULL) || ((a->type & 0xFF) != (b->type & 0xFF)))
+    {
+        return false;
+    }
+    if (a == b)
+    {
+        return true;
+    }
+
+    switch (a->type & 0xFF)
+    {
+        case cJSON_Number:
+            return number_value(a) == number_value(b);
+
+        case cJSON_String:
+        case cJSON_Raw:
+            if ((a->valuestring == NULL) || (b->valuestring == NULL))
+            {
+                return a->valuestring == b->valuestring;
+            }
+            if (!load_lazy(a) || !load_lazy(b))
+            {
+                return false;
+            }
+            if ((stored_valuestring_length(a) != 0) && (stored_valuestring_length(b) != 0) && (stored_valuestring_length(a) != stored_valuestring_length(b)))
+            {
+                return false;
+            }
+            return strcmp(a->valuestring, b->valuestring) == 0;
+
+        case cJSON_Array:
+            if (!load_lazy(a) || !load_lazy(b))
+            {
+                return false;
+            }
+            for ((void)(a_child = a->child), b_child = b->child; (a_child != NULL) && (b_child != NULL); (void)(a_child = a_child->next), b_child = b_child->next)
+            {
+                if (!cJSON_Compare(a_child, b_child, case_sensitive))
+                {
+                    return false;
+                }
+            }
+            return (a_child == NULL) && (b_child == NULL);
+
+        case cJSON_Object:
+            if (!load_lazy(a) || !load_lazy(b))
+            {
+                return false;
+            }
+            /* members in the same order are the usual case */
+            for ((void)(a_child = a->child), b_child = b->child; (a_child != NULL) && (b_child != NULL); (void)(a_child = a_child->next), b_child = b_child->next)
+            {
+                if (!name_matches(b_child, a_child->string, (a_child->string != NULL) ? name_length(a_child) : 0, case_sensitive))
+                {
+                    break;
+                }
+                if (!cJSON_Compare(a_child, b_child, case_sensitive))
+                {
+                    return false;
+                }
+            }
+            if ((a_child == NULL) || (b_child == NULL))
+            {
+                return (a_child == NULL) && (b_child == NULL);
+            }
+
+            /* otherwise every member has to be found in the other object */
+            for (a_child = a->child; a_child != NULL; a_child = a_child->next)
+            {
+                if (!cJSON_Compare(a_child, get_object_item(b, a_child->string, case_sensitive), case_sensitive))
+                {
+                    return false;
+                }
+            }
+            for (b_child = b->child; b_child != NULL; b_child = b_child->next)
+            {
+                if (!cJSON_Compare(b_child, get_object_item(a, b_child->string, case_sensitive), case_sensitive))
+                {
+                    return false;
+                }
+            }
+            return true;
+
+        default:
+            break;
+    }
+
+    /* null, true or false */
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_CompareWithCache(cJSON_HashCache *cache, const cJSON *a, const cJSON *b, cJSON_bool case_sensitive)
+{
+    if ((a == NULL) || (b == NULL))
+    {
+        return false;
+    }
+    /* with case sensitive keys, equal items still have the same hash */
+    if (hash_item(a, cache) != hash_item(b, cache))
+    {
+        return false;
+    }
+
+    return cJSON_Compare(a, b, case_sensitive);
+}
+
+/* Walk item in pre-order and count the nodes and string bytes of a copy. With nodes, the copy is also built from
+ * nodes (the root comes first) and strings, which must have room for what was counted before. */
+static cJSON_bool copy_tree(const cJSON * const item, const cJSON_bool recurse, node_storage * const nodes, unsigned char *strings, size_t * const node_count, size_t * const string_size, const internal_hooks * const hooks)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    const cJSON *current = item;
+    cJSON *copy = NULL;
+    size_t length = 0;
+
+    *node_count = 0;
+    *string_size = 0;
+    nesting_init(&stack, hooks);
+    for (;;)
+    {
+        /* the copy has no allocator to load lazy parts with later */
+        if (!load_lazy(current))
+        {
+            nesting_free(&stack);
+            return false;
+        }
+
+        if (nodes != NULL)
+        {
+            copy = &nodes[*node_count].item;
+            memset(copy, '\0', sizeof(cJSON));
+            copy->type = current->type & ~(cJSON_IsReference | cJSON_IsFrozen | cJSON_IsHashed | cJSON_IsIndexed);
+            copy->valueint = current->valueint;
+            copy->valuedouble = current->valuedouble;
+            if (stack.depth > 0)
+            {
+                frame = &stack.frames[stack.depth - 1];
+                if (frame->last != NULL)
+                {
+                    frame->last->next = copy;
+                    copy->prev = frame->last;
+                }
+                else
+                {
+                    frame->container->child = copy;
+                }
+                frame->container->child->prev = copy;
+                frame->last = copy;
+            }
+        }
+        (*node_count)++;
+
+        if ((current->valuestring != NULL) && !(current->type & cJSON_IsIndexed))
+        {
+            length = valuestring_length(current) + 1;
+            if (nodes != NULL)
+            {
+                memcpy(strings, current->valuestring, length);
+                copy->valuestring = (char*)strings;
+                store_valuestring_length(copy, length - 1);
+                strings += length;
+            }
+            *string_size += length;
+        }
+        if ((current->string != NULL) && (current->type & cJSON_StringIsConst))
+        {
+            if (nodes != NULL)
+            {
+                copy->string = current->string;
+                store_name_length(copy, stored_name_length(current));
+            }
+        }
+        else if (current->string != NULL)
+        {
+            length = name_length(current) + 1;
+            if (nodes != NULL)
+            {
+                memcpy(strings, current->string, length);
+                copy->string = (char*)strings;
+                store_name_length(copy, length - 1);
+                strings += length;
+            }
+            *string_size += length;
+        }
+
+        if (recurse && (current->child != NULL))
+        {
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                nesting_free(&stack);
+                return false;
+            }
+            frame->current = current->child;
+            frame->container = copy;
+            current = current->child;
+            continue;
+        }
+
+        /* go to the next item, leaving the ones whose children are all copied */
+        while ((stack.depth > 0) && (stack.frames[stack.depth - 1].current->next == NULL))
+        {
+            stack.depth--;
+        }
+        if (stack.depth == 0)
+        {
+            nesting_free(&stack);
+            return true;
+        }
+        frame = &stack.frames[stack.depth - 1];
+        frame->current = frame->current->next;
+        current = frame->current;
+    }
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_DuplicateWithArena(cJSON_Arena *arena, const cJSON *item, cJSON_bool recurse)
+{
+    size_t node_count = 0;
+    size_t string_size = 0;
+    node_storage *nodes = NULL;
+
+    if ((arena == NULL) || (item == NULL))
+    {
+        return NULL;
+    }
+
+    /* measure first, so that the whole copy fits into one allocation */
+    if (!copy_tree(item, recurse, NULL, NULL, &node_count, &string_size, &arena->hooks)
+            || (node_count > (((size_t)-1 - string_size) / sizeof(node_storage))))
+    {
+        return NULL;
+    }
+
+    nodes = (node_storage*)arena_allocate(arena, node_count * sizeof(node_storage) + string_size);
+    if (nodes == NULL)
+    {
+        return NULL;
+    }
+    if (!copy_tree(item, recurse, nodes, (unsigned char*)(nodes + node_count), &node_count, &string_size, &arena->hooks))
+    {
+        /* can only fail while measuring */
+        return NULL;
+    }
+
+    return &nodes->item;
+}
+
+/* Context allocators */
+struct cJSON_Context
+{
+    internal_hooks hooks;
+};
+
+CJSON_PUBLIC(cJSON_Context *) cJSON_CreateContext(const cJSON_Hooks *hooks, void *(*realloc_fn)(void *ptr, size_t sz))
+{
+    internal_hooks context_hooks = { malloc, free, realloc, NULL, NULL, NULL, NULL, false, false, false, false, NULL, NULL };
+    cJSON_Context *context = NULL;
+
+    if (hooks != NULL)
+    {
+        if (hooks->malloc_fn != NULL)
+        {
+            context_hooks.allocate = hooks->malloc_fn;
+        }
+        if (hooks->free_fn != NULL)
+        {
+            context_hooks.deallocate = hooks->free_fn;
+        }
+        /* same rule as cJSON_InitHooksWithRealloc */
+        context_hooks.reallocate = realloc_fn;
+        if ((realloc_fn == NULL) && (context_hooks.allocate == malloc) && (context_hooks.deallocate == free))
+        {
+            context_hooks.reallocate = realloc;
+        }
+    }
+
+    /* the context lives in its own allocator */
+    context = (cJSON_Context*)context_hooks.allocate(sizeof(cJSON_Context));
+    if (context != NULL)
+    {
+        context->hooks = context_hooks;
+    }
+
+    return context;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteContext(cJSON_Context *context)
+{
+    if (context != NULL)
+    {
+        /* the cached nodes of this thread may belong to the context */
+#ifdef CJSON_NODE_CACHE
+        if ((thread_node_cache.allocate == context->hooks.allocate) && (thread_node_cache.deallocate == context->hooks.deallocate))
+        {
+            trim_node_cache(&thread_node_cache, 0);
+        }
+#endif
+        context->hooks.deallocate(context);
+    }
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ContextParse(cJSON_Context *context, const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    const unsigned char *end = NULL;
+    cJSON *item = NULL;
+
+    if (context == NULL)
+    {
+        return NULL;
+    }
+
+    item = parse((const unsigned char*)value, buffer_length, &end, require_null_terminated, false, &context->hooks, NULL);
+    if (return_parse_end != NULL)
+    {
+        *return_parse_end = (const char*)end;
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(char *) cJSON_ContextPrint(cJSON_Context *context, const cJSON *item, cJSON_bool format)
+{
+    if (context == NULL)
+    {
+        return NULL;
+    }
+
+    return (char*)print(item, format, &context->hooks);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ContextDuplicate(cJSON_Context *context, const cJSON *item, cJSON_bool recurse)
+{
+    if (context == NULL)
+    {
+        return NULL;
+    }
+
+    return duplicate(item, recurse, &context->hooks);
+}
+
+CJSON_PUBLIC(void) cJSON_ContextDelete(cJSON_Context *context, cJSON *item)
+{
+    if (context != NULL)
+    {
+        delete_item(item, &context->hooks);
+    }
+}
+
+CJSON_PUBLIC(void) cJSON_ContextFree(cJSON_Context *context, void *pointer)
+{
+    if ((context != NULL) && (pointer != NULL))
+    {
+        context->hooks.deallocate(pointer);
+    }
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateNull(cJSON_Context *context)
+{
+    return (context != NULL) ? create_item(cJSON_NULL, &context->hooks) : NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateBool(cJSON_Context *context, cJSON_bool boolean)
+{
+    return (context != NULL) ? create_item(boolean ? cJSON_True : cJSON_False, &context->hooks) : NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateNumber(cJSON_Context *context, double num)
+{
+    return (context != NULL) ? create_number(num, &context->hooks) : NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateString(cJSON_Context *context, const char *string)
+{
+    return (context != NULL) ? create_string(cJSON_String, string, &context->hooks) : NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateRaw(cJSON_Context *context, const char *raw)
+{
+    return (context != NULL) ? create_string(cJSON_Raw, raw, &context->hooks) : NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateArray(cJSON_Context *context)
+{
+    return (context != NULL) ? create_item(cJSON_Array, &context->hooks) : NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateObject(cJSON_Context *context)
+{
+    return (context != NULL) ? create_item(cJSON_Object, &context->hooks) : NULL;
+}
+
+CJSON_PUBLIC(void) cJSON_ContextAddItemToObject(cJSON_Context *context, cJSON *object, const char *string, cJSON *item)
+{
+    if (context != NULL)
+    {
+        add_item_to_object(object, string, item, &context->hooks, false);
+    }
+}
+
+/* Shared documents and copy-on-write views */
+struct cJSON_Shared
+{
+    cJSON *document;
+    /* the owner and every view */
+    size_t references;
+};
+
+struct cJSON_View
+{
+    cJSON *root;
+    cJSON_Shared *shared;
+};
+
+CJSON_PUBLIC(cJSON_Shared *) cJSON_CreateShared(cJSON *document)
+{
+    cJSON_Shared *shared = NULL;
+
+    /* views must never change the document, not even by loading it */
+    if ((document == NULL) || !load_lazy_tree(document))
+    {
+        return NULL;
+    }
+
+    shared = (cJSON_Shared*)global_hooks.allocate(sizeof(cJSON_Shared));
+    if (shared == NULL)
+    {
+        return NULL;
+    }
+    shared->document = document;
+    shared->references = 1;
+
+    return shared;
+}
+
+CJSON_PUBLIC(const cJSON *) cJSON_GetSharedDocument(const cJSON_Shared *shared)
+{
+    return (shared != NULL) ? shared->document : NULL;
+}
+
+CJSON_PUBLIC(void) cJSON_ReleaseShared(cJSON_Shared *shared)
+{
+    if (shared == NULL)
+    {
+        return;
+    }
+
+    shared->references--;
+    if (shared->references == 0)
+    {
+        cJSON_Delete(shared->document);
+        global_hooks.deallocate(shared);
+    }
+}
+
+/* A node of a view that refers to a shared one, flagged cJSON_IsReference. Its key is its own. */
+static cJSON *share_node(const cJSON * const node)
+{
+    cJSON *copy = cJSON_New_Item(&global_hooks);
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(copy, node, sizeof(cJSON));
+    copy->next = copy->prev = NULL;
+    if (copy->type & cJSON_IsIndexed)
+    {
+        set_index(copy, NULL);
+    }
+    copy->type = (copy->type & ~(cJSON_IsFrozen | cJSON_IsHashed)) | cJSON_IsReference;
+    if (!(node->type & cJSON_StringIsConst) && (node->string != NULL))
+    {
+        copy->string = store_string(copy, true, node->string, name_length(node), &global_hooks);
+        if (copy->string == NULL)
+        {
+            delete_item(copy, &global_hooks);
+            return NULL;
+        }
+    }
+
+    return copy;
+}
+
+/* Make a node of a view writable: its string or its list of children is copied, the children themselves stay shared. */
+static cJSON_bool unshare_node(cJSON * const node)
+{
+    const cJSON *shared = NULL;
+    cJSON *children = NULL;
+    cJSON *last = NULL;
+    cJSON *copy = NULL;
+
+    if (!(node->type & cJSON_IsReference))
+    {
+        return true;
+    }
+
+    if (is_container(node))
+    {
+        for (shared = node->child; shared != NULL; shared = shared->next)
+        {
+            copy = share_node(shared);
+            if (copy == NULL)
+            {
+                delete_item(children, &global_hooks);
+                return false;
+            }
+            if (last == NULL)
+            {
+                children = copy;
+            }
+            else
+            {
+                suffix_object(last, copy);
+            }
+            last = copy;
+        }
+        node->child = children;
+        if (children != NULL)
+        {
+            children->prev = last;
+        }
+    }
+    else if (node->valuestring != NULL)
+    {
+        node->valuestring = store_string(node, false, node->valuestring, valuestring_length(node), &global_hooks);
+        if (node->valuestring == NULL)
+        {
+            return false;
+        }
+    }
+    node->type &= ~cJSON_IsReference;
+
+    return true;
+}
+
+/* Find the child of parent that the next reference token of a JSON pointer names, *pointer is moved past it. */
+static cJSON *get_pointer_child(const cJSON * const parent, const char ** const pointer)
+{
+    const char *token = *pointer;
+    const char *end = token;
+    cJSON *child = NULL;
+    size_t index = 0;
+
+    while ((*end != '/') && (*end != '\0'))
+    {
+        end++;
+    }
+    *pointer = end;
+
+    if ((parent->type & 0xFF) == cJSON_Array)
+    {
+        /* decimal without leading zeros */
+        if ((token == end) || ((token[0] == '0') && (end - token) > 1))
+        {
+            return NULL;
+        }
+        for (; token < end; token++)
+        {
+            if ((*token < '0') || (*token > '9') || (index > (((size_t)-1 - 9) / 10)))
+            {
+                return NULL;
+            }
+            index = (index * 10) + (size_t)(*token - '0');
+        }
+        for (child = parent->child; (child != NULL) && (index > 0); child = child->next)
+        {
+            index--;
+        }
+
+        return child;
+    }
+
+    if ((parent->type & 0xFF) != cJSON_Object)
+    {
+        return NULL;
+    }
+    for (child = parent->child; child != NULL; child = child->next)
+    {
+        const char *name = child->string;
+        const char *position = token;
+        if (name == NULL)
+        {
+            continue;
+        }
+        /* compare with "~0" standing for '~' and "~1" for '/' */
+        while ((position < end) && (*name != '\0'))
+        {
+            char character = *position;
+            if (character == '~')
+            {
+                if (((position + 1) == end) || ((position[1] != '0') && (position[1] != '1')))
+                {
+                    return NULL;
+                }
+                character = (position[1] == '0') ? '~' : '/';
+                position++;
+            }
+            if (character != *name)
+            {
+                break;
+            }
+            position++;
+            name++;
+        }
+        if ((position == end) && (*name == '\0'))
+        {
+            return child;
+        }
+    }
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON_View *) cJSON_CreateView(cJSON_Shared *shared)
+{
+    cJSON_View *view = NULL;
+
+    if (shared == NULL)
+    {
+        return NULL;
+    }
+
+    view = (cJSON_View*)global_hooks.allocate(sizeof(cJSON_View));
+    if (view == NULL)
+    {
+        return NULL;
+    }
+    view->root = share_node(shared->document);
+    if (view->root == NULL)
+    {
+        global_hooks.deallocate(view);
+        return NULL;
+    }
+    view->shared = shared;
+    shared->references++;
+
+    return view;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_GetViewRoot(const cJSON_View *view)
+{
+    return (view != NULL) ? view->root : NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_GetWritableViewItem(cJSON_View *view, const char *pointer)
+{
+    cJSON *current = NULL;
+
+    if ((view == NULL) || (pointer == NULL))
+    {
+        return NULL;
+    }
+
+    current = view->root;
+    if (!unshare_node(current))
+    {
+        return NULL;
+    }
+    while (*pointer == '/')
+    {
+        pointer++;
+        current = get_pointer_child(current, &pointer);
+        if ((current == NULL) || !unshare_node(current))
+        {
+            return NULL;
+        }
+    }
+    if (*pointer != '\0')
+    {
+        return NULL;
+    }
+
+    return current;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteView(cJSON_View *view)
+{
+    if (view == NULL)
+    {
+        return;
+    }
+
+    delete_item(view->root, &global_hooks);
+    cJSON_ReleaseShared(view->shared);
+    global_hooks.deallocate(view);
+}
+
+/* A document of the parse cache, it is in the list of its bucket and in the list of all entries from the most to the
+ * least recently used. */
+typedef struct parse_cache_entry
+{
+    struct parse_cache_entry *next;
+    struct parse_cache_entry *newer;
+    struct parse_cache_entry *older;
+    unsigned long hash;
+    /* a copy of the input, to tell inputs with the same hash apart */
+    unsigned char *text;
+    size_t length;
+    cJSON_Shared *shared;
+    /* what the entry costs of the budget */
+    size_t usage;
+} parse_cache_entry;
+
+struct cJSON_ParseCache
+{
+    parse_cache_entry **buckets;
+    /* a power of two */
+    size_t size;
+    size_t count;
+    parse_cache_entry *newest;
+    parse_cache_entry *oldest;
+    size_t budget;
+    size_t usage;
+};
+
+#define PARSE_CACHE_MINIMUM_SIZE 16
+
+CJSON_PUBLIC(cJSON_ParseCache *) cJSON_CreateParseCache(size_t budget)
+{
+    cJSON_ParseCache *cache = (cJSON_ParseCache*)global_hooks.allocate(sizeof(cJSON_ParseCache));
+    if (cache == NULL)
+    {
+        return NULL;
+    }
+
+    cache->buckets = (parse_cache_entry**)global_hooks.allocate(PARSE_CACHE_MINIMUM_SIZE * sizeof(parse_cache_entry*));
+    if (cache->buckets == NULL)
+    {
+        global_hooks.deallocate(cache);
+        return NULL;
+    }
+    memset(cache->buckets, '\0', PARSE_CACHE_MINIMUM_SIZE * sizeof(parse_cache_entry*));
+    cache->size = PARSE_CACHE_MINIMUM_SIZE;
+    cache->count = 0;
+    cache->newest = NULL;
+    cache->oldest = NULL;
+    cache->budget = budget;
+    cache->usage = 0;
+
+    return cache;
+}
+
+static void parse_cache_unlink(cJSON_ParseCache * const cache, parse_cache_entry * const entry)
+{
+    if (entry->newer != NULL)
+    {
+        entry->newer->older = entry->older;
+    }
+    else
+    {
+        cache->newest = entry->older;
+    }
+    if (entry->older != NULL)
+    {
+        entry->older->newer = entry->newer;
+    }
+    else
+    {
+        cache->oldest = entry->newer;
+    }
+}
+
+static void parse_cache_make_newest(cJSON_ParseCache * const cache, parse_cache_entry * const entry)
+{
+    entry->newer = NULL;
+    entry->older = cache->newest;
+    if (cache->newest != NULL)
+    {
+        cache->newest->newer = entry;
+    }
+    cache->newest = entry;
+    if (cache->oldest == NULL)
+    {
+        cache->oldest = entry;
+    }
+}
+
+/* Remove the least recently used entry. Views of its document stay valid. */
+static void parse_cache_evict(cJSON_ParseCache * const cache)
+{
+    parse_cache_entry * const entry = cache->oldest;
+    parse_cache_entry **link = &cache->buckets[entry->hash & (cache->size - 1)];
+
+    while (*link != entry)
+    {
+        link = &(*link)->next;
+    }
+    *link = entry->next;
+    parse_cache_unlink(cache, entry);
+
+    cache->count--;
+    cache->usage -= entry->usage;
+    cJSON_ReleaseShared(entry->shared);
+    global_hooks.deallocate(entry->text);
+    global_hooks.deallocate(entry);
+}
+
+/* Double the number of buckets. Returns false if out of memory, the cache then keeps working with fewer buckets. */
+static cJSON_bool parse_cache_grow(cJSON_ParseCache * const cache)
+{
+    parse_cache_entry **buckets = NULL;
+    parse_cache_entry *entry = NULL;
+    size_t i = 0;
+
+    if (cache->size > (((size_t)-1) / sizeof(parse_cache_entry*) / 2))
+    {
+        return false;
+    }
+    buckets = (parse_cache_entry**)global_hooks.allocate(cache->size * 2 * sizeof(parse_cache_entry*));
+    if (buckets == NULL)
+    {
+        return false;
+    }
+    memset(buckets, '\0', cache->size * 2 * sizeof(parse_cache_entry*));
+
+    for (entry = cache->newest; entry != NULL; entry = entry->older)
+    {
+        i = entry->hash & (cache->size * 2 - 1);
+        entry->next = buckets[i];
+        buckets[i] = entry;
+    }
+    global_hooks.deallocate(cache->buckets);
+    cache->buckets = buckets;
+    cache->size *= 2;
+
+    return true;
+}
+
+/* Keep the document of text in the cache, evicting as much as it takes to stay within the budget. It isn't kept if it
+ * doesn't fit at all or memory runs out. */
+static void parse_cache_insert(cJSON_ParseCache * const cache, const unsigned long hash, const unsigned char * const text, const size_t length, cJSON_Shared * const shared)
+{
+    parse_cache_entry *entry = NULL;
+    const size_t usage = sizeof(parse_cache_entry) + length + sizeof(cJSON_Shared) + cJSON_MemoryUsage(shared->document);
+
+    if ((usage > cache->budget) || (length == (size_t)-1))
+    {
+        return;
+    }
+    while ((cache->budget - cache->usage) < usage)
+    {
+        parse_cache_evict(cache);
+    }
+    if (cache->count >= cache->size)
+    {
+        parse_cache_grow(cache);
+    }
+
+    entry = (parse_cache_entry*)global_hooks.allocate(sizeof(parse_cache_entry));
+    if (entry == NULL)
+    {
+        return;
+    }
+    entry->text = (unsigned char*)global_hooks.allocate(length + 1);
+    if (entry->text == NULL)
+    {
+        global_hooks.deallocate(entry);
+        return;
+    }
+    memcpy(entry->text, text, length);
+    entry->length = length;
+    entry->hash = hash;
+    entry->usage = usage;
+    /* the cache holds a reference of its own */
+    entry->shared = shared;
+    shared->references++;
+
+    entry->next = cache->buckets[hash & (cache->size - 1)];
+    cache->buckets[hash & (cache->size - 1)] = entry;
+    parse_cache_make_newest(cache, entry);
+    cache->count++;
+    cache->usage += usage;
+}
+
+CJSON_PUBLIC(cJSON_View *) cJSON_ParseCached(cJSON_ParseCache *cache, const char *value, size_t buffer_length, cJSON_ParseError *error)
+{
+    cJSON_Shared *shared = NULL;
+    cJSON_View *view = NULL;
+    parse_cache_entry *entry = NULL;
+    unsigned long hash = 0;
+    cJSON *document = NULL;
+
+    if ((cache == NULL) || (value == NULL))
+    {
+        return NULL;
+    }
+
+    hash = hash_bytes(2166136261UL, (const unsigned char*)value, buffer_length);
+    for (entry = cache->buckets[hash & (cache->size - 1)]; entry != NULL; entry = entry->next)
+    {
+        if ((entry->hash == hash) && (entry->length == buffer_length) && (memcmp(entry->text, value, buffer_length) == 0))
+        {
+            break;
+        }
+    }
+    if (entry != NULL)
+    {
+        parse_cache_unlink(cache, entry);
+        parse_cache_make_newest(cache, entry);
+        if (error != NULL)
+        {
+            memset(error, '\0', sizeof(cJSON_ParseError));
+        }
+
+        return cJSON_CreateView(entry->shared);
+    }
+
+    document = parse((const unsigned char*)value, buffer_length, NULL, true, false, &global_hooks, error);
+    if (document == NULL)
+    {
+        return NULL;
+    }
+    shared = cJSON_CreateShared(document);
+    if (shared == NULL)
+    {
+        cJSON_Delete(document);
+        return NULL;
+    }
+
+    parse_cache_insert(cache, hash, (const unsigned char*)value, buffer_length, shared);
+    view = cJSON_CreateView(shared);
+    /* the view (and the cache) keep the document alive */
+    cJSON_ReleaseShared(shared);
+
+    return view;
+}
+
+CJSON_PUBLIC(size_t) cJSON_GetParseCacheUsage(const cJSON_ParseCache *cache)
+{
+    return (cache == NULL) ? 0 : cache->usage;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteParseCache(cJSON_ParseCache *cache)
+{
+    if (cache == NULL)
+    {
+        return;
+    }
+
+    while (cache->oldest != NULL)
+    {
+        parse_cache_evict(cache);
+    }
+    global_hooks.deallocate(cache->buckets);
+    global_hooks.deallocate(cache);
+}
+
+typedef struct print_cache_entry
+{
+    struct print_cache_entry *next;
+    const cJSON *item;
+    /* what the text was printed with */
+    size_t depth;
+    cJSON_bool format;
+    /* the last cJSON_PrintWithCache that found the item unchanged or printed it */
+    unsigned long pass;
+    unsigned char *text;
+    size_t length;
+} print_cache_entry;
+
+struct cJSON_PrintCache
+{
+    print_cache_entry **buckets;
+    /* a power of two */
+    size_t size;
+    size_t count;
+    unsigned long pass;
+};
+
+#define PRINT_CACHE_MINIMUM_SIZE 64
+
+CJSON_PUBLIC(cJSON_PrintCache *) cJSON_CreatePrintCache(void)
+{
+    cJSON_PrintCache *cache = (cJSON_PrintCache*)global_hooks.allocate(sizeof(cJSON_PrintCache));
+    if (cache == NULL)
+    {
+        return NULL;
+    }
+
+    cache->buckets = (print_cache_entry**)global_hooks.allocate(PRINT_CACHE_MINIMUM_SIZE * sizeof(print_cache_entry*));
+    if (cache->buckets == NULL)
+    {
+        global_hooks.deallocate(cache);
+        return NULL;
+    }
+    memset(cache->buckets, '\0', PRINT_CACHE_MINIMUM_SIZE * sizeof(print_cache_entry*));
+    cache->size = PRINT_CACHE_MINIMUM_SIZE;
+    cache->count = 0;
+    cache->pass = 0;
+
+    return cache;
+}
+
+/* The link that points to the entry of item, or to NULL at the end of its bucket. */
+static print_cache_entry **print_cache_link(cJSON_PrintCache * const cache, const cJSON * const item)
+{
+    print_cache_entry **link = &cache->buckets[hash_pointer(item) & (cache->size - 1)];
+
+    while ((*link != NULL) && ((*link)->item != item))
+    {
+        link = &(*link)->next;
+    }
+
+    return link;
+}
+
+static void print_cache_remove(cJSON_PrintCache * const cache, print_cache_entry ** const link)
+{
+    print_cache_entry * const entry = *link;
+
+    *link = entry->next;
+    cache->count--;
+    global_hooks.deallocate(entry->text);
+    global_hooks.deallocate(entry);
+}
+
+/* Remove the entries that weren't used by the current pass, with remove_all the others too. */
+static void print_cache_sweep(cJSON_PrintCache * const cache, const cJSON_bool remove_all)
+{
+    size_t i = 0;
+
+    for (i = 0; i < cache->size; i++)
+    {
+        print_cache_entry **link = &cache->buckets[i];
+        while (*link != NULL)
+        {
+            if (remove_all || ((*link)->pass != cache->pass))
+            {
+                print_cache_remove(cache, link);
+            }
+            else
+            {
+                link = &(*link)->next;
+            }
+        }
+    }
+}
+
+/* Double the number of buckets. If memory runs out, the cache keeps working with fewer buckets. */
+static void print_cache_grow(cJSON_PrintCache * const cache)
+{
+    print_cache_entry **buckets = NULL;
+    print_cache_entry *entry = NULL;
+    size_t i = 0;
+
+    if (cache->size > (((size_t)-1) / sizeof(print_cache_entry*) / 2))
+    {
+        return;
+    }
+    buckets = (print_cache_entry**)global_hooks.allocate(cache->size * 2 * sizeof(print_cache_entry*));
+    if (buckets == NULL)
+    {
+        return;
+    }
+    memset(buckets, '\0', cache->size * 2 * sizeof(print_cache_entry*));
+
+    for (i = 0; i < cache->size; i++)
+    {
+        while (cache->buckets[i] != NULL)
+        {
+            entry = cache->buckets[i];
+            cache->buckets[i] = entry->next;
+            entry->next = buckets[hash_pointer(entry->item) & (cache->size * 2 - 1)];
+            buckets[hash_pointer(entry->item) & (cache->size * 2 - 1)] = entry;
+        }
+    }
+    global_hooks.deallocate(cache->buckets);
+    cache->buckets = buckets;
+    cache->size *= 2;
+}
+
+/* Keep the text of item for the current pass if it is still valid at depth, otherwise drop it. Returns whether it's kept. */
+static cJSON_bool print_cache_keep(cJSON_PrintCache * const cache, const cJSON * const item, const size_t depth, const cJSON_bool format, const cJSON_bool unchanged)
+{
+    print_cache_entry ** const link = print_cache_link(cache, item);
+    print_cache_entry * const entry = *link;
+
+    if (entry == NULL)
+    {
+        return false;
+    }
+    /* only the indentation of formatted text depends on the depth */
+    if (unchanged && (entry->format == format) && (!format || (entry->depth == depth)))
+    {
+        entry->pass = cache->pass;
+        return true;
+    }
+    print_cache_remove(cache, link);
+
+    return false;
+}
+
+/* Remember the text of an array or object that was just printed. If memory runs out, it is printed again next time. */
+static void print_cache_add(cJSON_PrintCache * const cache, const cJSON * const item, const size_t depth, const cJSON_bool format, const unsigned char * const text, const size_t length)
+{
+    print_cache_entry **link = print_cache_link(cache, item);
+    print_cache_entry *entry = NULL;
+
+    if (*link != NULL)
+    {
+        print_cache_remove(cache, link);
+    }
+    if (cache->count >= cache->size)
+    {
+        print_cache_grow(cache);
+    }
+
+    entry = (print_cache_entry*)global_hooks.allocate(sizeof(print_cache_entry));
+    if (entry == NULL)
+    {
+        return;
+    }
+    entry->text = (unsigned char*)global_hooks.allocate(length);
+    if (entry->text == NULL)
+    {
+        global_hooks.deallocate(entry);
+        return;
+    }
+    memcpy(entry->text, text, length);
+    entry->length = length;
+    entry->item = item;
+    entry->depth = depth;
+    entry->format = format;
+    entry->pass = cache->pass;
+
+    link = &cache->buckets[hash_pointer(item) & (cache->size - 1)];
+    entry->next = *link;
+    *link = entry;
+    cache->count++;
+}
+
+/* Copy the text of an unchanged array or object from the cache of output_buffer. Returns false if it has to be printed. */
+static cJSON_bool print_cache_copy(const cJSON * const item, const size_t depth, const cJSON_bool format, printbuffer * const output_buffer, const internal_hooks * const hooks)
+{
+    cJSON_PrintCache * const cache = output_buffer->print_cache;
+    const print_cache_entry *entry = NULL;
+    unsigned char *output_pointer = NULL;
+
+    if (!is_container(item) || (item->child == NULL))
+    {
+        return false;
+    }
+    entry = *print_cache_link(cache, item);
+    if ((entry == NULL) || (entry->pass != cache->pass) || (entry->format != format) || (format && (entry->depth != depth)))
+    {
+        return false;
+    }
+
+    output_pointer = ensure(output_buffer, entry->length + 1, hooks);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+    memcpy(output_pointer, entry->text, entry->length);
+    output_pointer[entry->length] = '\0';
+    output_buffer->offset += entry->length;
+
+    return true;
+}
+
+/* Mark the items of item with cJSON_IsRendered and keep the text of the arrays and objects that are unchanged, that is
+ * they and all of their elements were marked before. Empty arrays and objects aren't cached. */
+static cJSON_bool print_cache_prepare(cJSON_PrintCache * const cache, cJSON * const item, const cJSON_bool format)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    cJSON *current = item;
+    cJSON_bool unchanged = false;
+
+    nesting_init(&stack, &global_hooks);
+    for (;;)
+    {
+        unchanged = (current->type & cJSON_IsRendered) != 0;
+        current->type |= cJSON_IsRendered;
+        if (current->type & cJSON_IsPacked)
+        {
+            /* the numbers can be changed through cJSON_GetPackedNumbers */
+            unchanged = false;
+        }
+        else if (is_container(current) && (current->type & cJSON_IsLazy))
+        {
+            /* printed as a whole, its children don't exist yet */
+            unchanged = print_cache_keep(cache, current, stack.depth, format, unchanged);
+        }
+        else if (is_container(current) && (current->child != NULL))
+        {
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                nesting_free(&stack);
+                return false;
+            }
+            frame->container = current;
+            frame->last = current->child;
+            frame->index = unchanged ? 1 : 0;
+            current = current->child;
+            continue;
+        }
+
+        /* the value is complete, finish the arrays and objects that end here */
+        for (;;)
+        {
+            if (stack.depth == 0)
+            {
+                nesting_free(&stack);
+                return true;
+            }
+            frame = &stack.frames[stack.depth - 1];
+            frame->index = (unchanged && (frame->index != 0)) ? 1 : 0;
+            if (frame->last->next != NULL)
+            {
+                break;
+            }
+            stack.depth--;
+            unchanged = print_cache_keep(cache, frame->container, stack.depth, format, frame->index != 0);
+        }
+
+        frame->last = frame->last->next;
+        current = frame->last;
+    }
+}
+
+CJSON_PUBLIC(char *) cJSON_PrintWithCache(cJSON_PrintCache *cache, cJSON *item, cJSON_bool format)
+{
+    printbuffer buffer[1];
+
+    if ((cache == NULL) || (item == NULL) || (item->type & cJSON_IsFrozen))
+    {
+        /* the items of frozen trees can't be marked */
+        return NULL;
+    }
+
+    cache->pass++;
+    if (!print_cache_prepare(cache, item, format))
+    {
+        /* some items are marked without being printed */
+        print_cache_sweep(cache, true);
+        return NULL;
+    }
+
+    memset(buffer, 0, sizeof(buffer));
+    buffer->buffer = (unsigned char*)global_hooks.allocate(256);
+    if (buffer->buffer != NULL)
+    {
+        buffer->length = 256;
+        buffer->print_cache = cache;
+        if (!print_value(item, 0, format, buffer, &global_hooks))
+        {
+            if (buffer->buffer != NULL)
+            {
+                global_hooks.deallocate(buffer->buffer);
+            }
+            buffer->buffer = NULL;
+        }
+    }
+    print_cache_sweep(cache, false);
+
+    return (char*)buffer->buffer;
+}
+
+CJSON_PUBLIC(void) cJSON_DeletePrintCache(cJSON_PrintCache *cache)
+{
+    if (cache == NULL)
+    {
+        return;
+    }
+
+    print_cache_sweep(cache, true);
+    global_hooks.deallocate(cache->buckets);
+    global_hooks.deallocate(cache);
+}
+
+/* A node of a compact document. The nodes are stored in pre-order in one block, followed by the numbers and the strings.
+ * The 32 bit offsets are relative to the node, so a node can be read without a pointer to its document. */
+struct cJSON_Compact
+{
+    /* cJSON type without the flags */
+    unsigned int type;
+    /* distance in nodes to the next sibling, 0 for the last one (the first child always follows its parent) */
+    unsigned int next;
+    /* distance in bytes to the name, 0 if it has none */
+    unsigned int name;
+    /* strings: distance in bytes to the text, numbers: distance in bytes to the double, arrays and objects: number of children */
+    unsigned int value;
+};
+
+/* The block starts with a header of the size of a node. Together with the relative offsets this makes the block a
+ * position independent image that can be stored and used again in place. */
+typedef struct
+{
+    /* identifies the format, it doesn't match on machines with a different byte order */
+    unsigned int magic;
+    /* of the whole block, including the header */
+    unsigned int size;
+    unsigned int nodes;
+    unsigned int numbers;
+} compact_header;
+
+#define COMPACT_MAGIC 0x634A5331U
+#define COMPACT_HEADER_SIZE sizeof(compact_header)
+
+#define compact_node(block, index) (((cJSON_Compact*)(void*)((block) + COMPACT_HEADER_SIZE)) + (index))
+#define read_compact_node(block, index) (((const cJSON_Compact*)(const void*)((block) + COMPACT_HEADER_SIZE)) + (index))
+
+typedef struct
+{
+    /* NULL while measuring */
+    unsigned char *block;
+    size_t nodes;
+    size_t numbers;
+    size_t strings;
+    /* offsets of the numbers and the strings in the block */
+    size_t numbers_start;
+    size_t strings_start;
+} compact_builder;
+
+/* Add a string to the document, returns its distance from the node at node_offset. */
+static unsigned int compact_string(compact_builder * const builder, const size_t node_offset, const char * const string)
+{
+    size_t length = (string == NULL) ? 0 : strlen(string);
+    size_t offset = builder->strings_start + builder->strings;
+
+    builder->strings += length + 1;
+    if (builder->block == NULL)
+    {
+        return 0;
+    }
+
+    if (length > 0)
+    {
+        memcpy(builder->block + offset, string, length);
+    }
+    builder->block[offset + length] = '\0';
+
+    return (unsigned int)(offset - node_offset);
+}
+
+/* Add a node for item without its children, returns its index. */
+static size_t compact_item(compact_builder * const builder, const cJSON * const item, const cJSON_bool named)
+{
+    const size_t index = builder->nodes++;
+    const size_t node_offset = COMPACT_HEADER_SIZE + index * sizeof(cJSON_Compact);
+    const cJSON *child = NULL;
+    unsigned int name = 0;
+    unsigned int value = 0;
+    size_t offset = 0;
+
+    if (named)
+    {
+        name = compact_string(builder, node_offset, item->string);
+    }
+
+    switch (item->type & 0xFF)
+    {
+        case cJSON_Number:
+            offset = builder->numbers_start + builder->numbers * sizeof(double);
+            builder->numbers++;
+            if (builder->block != NULL)
+            {
+                memcpy(builder->block + offset, &item->valuedouble, sizeof(double));
+                value = (unsigned int)(offset - node_offset);
+            }
+            break;
+
+        case cJSON_String:
+        case cJSON_Raw:
+            value = compact_string(builder, node_offset, item->valuestring);
+            break;
+
+        case cJSON_Array:
+        case cJSON_Object:
+            for (child = item->child; child != NULL; child = child->next)
+            {
+                value++;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if (builder->block != NULL)
+    {
+        cJSON_Compact *node = compact_node(builder->block, index);
+        node->type = (unsigned int)(item->type & 0xFF);
+        node->next = 0;
+        node->name = name;
+        node->value = value;
+    }
+
+    return index;
+}
+
+/* Add the nodes of the whole tree in pre-order. */
+static cJSON_bool compact_tree(compact_builder * const builder, const cJSON * const item)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    const cJSON *current_item = item;
+    size_t index = 0;
+
+    nesting_init(&stack, &global_hooks);
+    compact_item(builder, item, false);
+    for (;;)
+    {
+        if (is_container(current_item) && (current_item->child != NULL))
+        {
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                nesting_free(&stack);
+                return false;
+            }
+            frame->source = current_item;
+            frame->current = current_item->child;
+            frame->index = compact_item(builder, frame->current, (current_item->type & 0xFF) == cJSON_Object);
+            current_item = frame->current;
+            continue;
+        }
+
+        /* go to the next sibling, leaving the arrays and objects that end here */
+        while ((stack.depth > 0) && (stack.frames[stack.depth - 1].current->next == NULL))
+        {
+            stack.depth--;
+        }
+        if (stack.depth == 0)
+        {
+            nesting_free(&stack);
+            return true;
+        }
+        frame = &stack.frames[stack.depth - 1];
+        frame->current = frame->current->next;
+        index = compact_item(builder, frame->current, (frame->source->type & 0xFF) == cJSON_Object);
+        if (builder->block != NULL)
+        {
+            compact_node(builder->block, frame->index)->next = (unsigned int)(index - frame->index);
+        }
+        frame->index = index;
+        current_item = frame->current;
+    }
+}
+
+CJSON_PUBLIC(cJSON_Compact *) cJSON_CreateCompact(const cJSON *item)
+{
+    compact_builder builder;
+    compact_header *header = NULL;
+    size_t size = 0;
+
+    if (item == NULL)
+    {
+        return NULL;
+    }
+
+    if (!load_lazy_tree(item))
+    {
+        return NULL;
+    }
+
+    /* measure first, so the document fits into one allocation */
+    memset(&builder, '\0', sizeof(builder));
+    if (!compact_tree(&builder, item))
+    {
+        return NULL;
+    }
+    builder.numbers_start = COMPACT_HEADER_SIZE + builder.nodes * sizeof(cJSON_Compact);
+    builder.strings_start = builder.numbers_start + builder.numbers * sizeof(double);
+    size = builder.strings_start + builder.strings;
+    if (size > UINT_MAX)
+    {
+        /* the offsets are 32 bits */
+        return NULL;
+    }
+
+    builder.block = (unsigned char*)global_hooks.allocate(size);
+    if (builder.block == NULL)
+    {
+        return NULL;
+    }
+    header = (compact_header*)(void*)builder.block;
+    header->magic = COMPACT_MAGIC;
+    header->size = (unsigned int)size;
+    header->nodes = (unsigned int)builder.nodes;
+    header->numbers = (unsigned int)builder.numbers;
+    builder.nodes = 0;
+    builder.numbers = 0;
+    builder.strings = 0;
+    if (!compact_tree(&builder, item))
+    {
+        global_hooks.deallocate(builder.block);
+        return NULL;
+    }
+
+    return compact_node(builder.block, 0);
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteCompact(cJSON_Compact *document)
+{
+    if (document != NULL)
+    {
+        global_hooks.deallocate(((unsigned char*)document) - COMPACT_HEADER_SIZE);
+    }
+}
+
+#define compact_header_of(document) ((const compact_header*)(const void*)(((const unsigned char*)(document)) - COMPACT_HEADER_SIZE))
+
+CJSON_PUBLIC(size_t) cJSON_GetCompactSize(const cJSON_Compact *document)
+{
+    return (document == NULL) ? 0 : compact_header_of(document)->size;
+}
+
+CJSON_PUBLIC(const void *) cJSON_GetCompactImage(const cJSON_Compact *document)
+{
+    return (document == NULL) ? NULL : compact_header_of(document);
+}
+
+/* Check that a string at offset from the node at node_offset is in the string area, which ends with a '\0'. */
+static cJSON_bool verify_compact_string(const compact_header * const header, const size_t strings_start, const size_t node_offset, const unsigned int offset)
+{
+    const size_t string_offset = node_offset + offset;
+
+    return (string_offset >= strings_start) && (string_offset < header->size);
+}
+
+/* Check the fields of a node, but not how it links to the others. */
+static cJSON_bool verify_compact_node(const compact_header * const header, const size_t index, const cJSON_bool named)
+{
+    const cJSON_Compact *node = read_compact_node((const unsigned char*)header, index);
+    const size_t node_offset = COMPACT_HEADER_SIZE + index * sizeof(cJSON_Compact);
+    const size_t numbers_start = COMPACT_HEADER_SIZE + header->nodes * sizeof(cJSON_Compact);
+    const size_t strings_start = numbers_start + header->numbers * sizeof(double);
+    size_t number_offset = 0;
+
+    if (named != (node->name != 0))
+    {
+        return false;
+    }
+    if (named && !verify_compact_string(header, strings_start, node_offset, node->name))
+    {
+        return false;
+    }
+
+    switch (node->type)
+    {
+        case cJSON_False:
+        case cJSON_True:
+        case cJSON_NULL:
+            return true;
+
+        case cJSON_Number:
+            number_offset = node_offset + node->value;
+            return (number_offset >= numbers_start) && (number_offset <= (strings_start - sizeof(double)));
+
+        case cJSON_String:
+        case cJSON_Raw:
+            return verify_compact_string(header, strings_start, node_offset, node->value);
+
+        case cJSON_Array:
+        case cJSON_Object:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/* Check the children of the array or object at index, following their links. */
+static cJSON_bool verify_compact_children(const compact_header * const header, const size_t index)
+{
+    const cJSON_Compact *node = read_compact_node((const unsigned char*)header, index);
+    const cJSON_bool named = (node->type == cJSON_Object);
+    size_t child = index + 1;
+    size_t count = 0;
+    size_t next = 0;
+
+    for (;;)
+    {
+        if ((child >= header->nodes) || !verify_compact_node(header, child, named))
+        {
+            return false;
+        }
+        count++;
+        next = read_compact_node((const unsigned char*)header, child)->next;
+        if (next == 0)
+        {
+            break;
+        }
+        if (next >= (header->nodes - child))
+        {
+            return false;
+        }
+        child += next;
+    }
+
+    return count == node->value;
+}
+
+/* Check that the nodes form a tree in pre-order, so that every way of reading them stays inside the image. */
+static cJSON_bool verify_compact(const compact_header * const header)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    const unsigned char *block = (const unsigned char*)header;
+    const cJSON_Compact *node = read_compact_node(block, 0);
+    size_t index = 0;
+
+    if (!verify_compact_node(header, 0, false) || (node->next != 0))
+    {
+        return false;
+    }
+    if (((node->type != cJSON_Array) && (node->type != cJSON_Object)) || (node->value == 0))
+    {
+        return header->nodes == 1;
+    }
+    if (!verify_compact_children(header, 0))
+    {
+        return false;
+    }
+
+    /* the nodes have been checked with their parents, what's left is that a sibling follows the subtree before it */
+    nesting_init(&stack, &global_hooks);
+    frame = nesting_push(&stack); /* can't fail, the first frames are on the C stack */
+    /* the position of the next child, 0 after the last one */
+    frame->index = 1;
+    for (index = 1; stack.depth > 0; index++)
+    {
+        frame = &stack.frames[stack.depth - 1];
+        if ((index >= header->nodes) || (frame->index != index))
+        {
+            goto fail;
+        }
+        node = read_compact_node(block, index);
+        frame->index = (node->next == 0) ? 0 : (index + node->next);
+
+        if (((node->type == cJSON_Array) || (node->type == cJSON_Object)) && (node->value != 0))
+        {
+            if (!verify_compact_children(header, index))
+            {
+                goto fail;
+            }
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                goto fail;
+            }
+            frame->index = index + 1;
+            continue;
+        }
+
+        while ((stack.depth > 0) && (stack.frames[stack.depth - 1].index == 0))
+        {
+            stack.depth--;
+        }
+    }
+    nesting_free(&stack);
+
+    return index == header->nodes;
+
+fail:
+    nesting_free(&stack);
+
+    return false;
+}
+
+CJSON_PUBLIC(const cJSON_Compact *) cJSON_LoadCompact(const void *image, size_t length, cJSON_bool verify)
+{
+    const compact_header *header = (const compact_header*)image;
+    size_t strings_start = 0;
+
+    if ((image == NULL) || (length < (COMPACT_HEADER_SIZE + sizeof(cJSON_Compact))))
+    {
+        return NULL;
+    }
+    if ((header->magic != COMPACT_MAGIC) || (header->size > length) || (header->nodes == 0))
+    {
+        return NULL;
+    }
+    /* the counts can't be large enough to overflow, the header has been checked against the size */
+    if ((header->nodes > (header->size / sizeof(cJSON_Compact))) || (header->numbers > (header->size / sizeof(double))))
+    {
+        return NULL;
+    }
+    strings_start = COMPACT_HEADER_SIZE + header->nodes * sizeof(cJSON_Compact) + header->numbers * sizeof(double);
+    if ((strings_start > header->size)
+        || ((strings_start < header->size) && (((const unsigned char*)image)[header->size - 1] != '\0')))
+    {
+        return NULL;
+    }
+
+    if (verify && !verify_compact(header))
+    {
+        return NULL;
+    }
+
+    return read_compact_node((const unsigned char*)image, 0);
+}
+
+CJSON_PUBLIC(int) cJSON_CompactGetType(const cJSON_Compact *item)
+{
+    return (item == NULL) ? cJSON_Invalid : (int)item->type;
+}
+
+CJSON_PUBLIC(double) cJSON_CompactGetNumber(const cJSON_Compact *item)
+{
+    double number = 0;
+
+    if ((item != NULL) && (item->type == cJSON_Number))
+    {
+        memcpy(&number, ((const unsigned char*)item) + item->value, sizeof(number));
+    }
+
+    return number;
+}
+
+CJSON_PUBLIC(const char *) cJSON_CompactGetString(const cJSON_Compact *item)
+{
+    if ((item == NULL) || ((item->type != cJSON_String) && (item->type != cJSON_Raw)))
+    {
+        return NULL;
+    }
+
+    return ((const char*)item) + item->value;
+}
+
+CJSON_PUBLIC(const char *) cJSON_CompactGetName(const cJSON_Compact *item)
+{
+    if ((item == NULL) || (item->name == 0))
+    {
+        return NULL;
+    }
+
+    return ((const char*)item) + item->name;
+}
+
+CJSON_PUBLIC(const cJSON_Compact *) cJSON_CompactGetChild(const cJSON_Compact *item)
+{
+    if ((item == NULL) || ((item->type != cJSON_Array) && (item->type != cJSON_Object)) || (item->value == 0))
+    {
+        return NULL;
+    }
+
+    return item + 1;
+}
+
+CJSON_PUBLIC(const cJSON_Compact *) cJSON_CompactGetNext(const cJSON_Compact *item)
+{
+    if ((item == NULL) || (item->next == 0))
+    {
+        return NULL;
+    }
+
+    return item + item->next;
+}
+
+CJSON_PUBLIC(int) cJSON_CompactGetArraySize(const cJSON_Compact *array)
+{
+    if ((array == NULL) || ((array->type != cJSON_Array) && (array->type != cJSON_Object)))
+    {
+        return 0;
+    }
+
+    return (int)array->value;
+}
+
+CJSON_PUBLIC(const cJSON_Compact *) cJSON_CompactGetArrayItem(const cJSON_Compact *array, int index)
+{
+    const cJSON_Compact *current_element = cJSON_CompactGetChild(array);
+
+    if (index < 0)
+    {
+        return NULL;
+    }
+
+    while ((current_element != NULL) && (index > 0))
+    {
+        current_element = cJSON_CompactGetNext(current_element);
+        index--;
+    }
+
+    return current_element;
+}
+
+static const cJSON_Compact *compact_get_object_item(const cJSON_Compact * const object, const char * const name, const cJSON_bool case_sensitive)
+{
+    const cJSON_Compact *current_element = NULL;
+
+    if ((object == NULL) || (object->type != cJSON_Object) || (name == NULL))
+    {
+        return NULL;
+    }
+
+    for (current_element = cJSON_CompactGetChild(object); current_element != NULL; current_element = cJSON_CompactGetNext(current_element))
+    {
+        const char *current_name = cJSON_CompactGetName(current_element);
+        if (case_sensitive ? (strcmp(name, current_name) == 0) : (cJSON_strcasecmp((const unsigned char*)name, (const unsigned char*)current_name) == 0))
+        {
+            return current_element;
+        }
+    }
+
+    return NULL;
+}
+
+CJSON_PUBLIC(const cJSON_Compact *) cJSON_CompactGetObjectItem(const cJSON_Compact *object, const char *string)
+{
+    return compact_get_object_item(object, string, false);
+}
+
+CJSON_PUBLIC(const cJSON_Compact *) cJSON_CompactGetObjectItemCaseSensitive(const cJSON_Compact *object, const char *string)
+{
+    return compact_get_object_item(object, string, true);
+}
+
+/* Create a cJSON item from a node without its children. */
+static cJSON *expand_compact_item(const cJSON_Compact * const node)
+{
+    cJSON *item = cJSON_New_Item(&global_hooks);
+    if (item == NULL)
+    {
+        return NULL;
+    }
+
+    item->type = (int)node->type;
+    if (node->type == cJSON_Number)
+    {
+        cJSON_SetNumberHelper(item, cJSON_CompactGetNumber(node));
+    }
+    else if (node->type == cJSON_True)
+    {
+        item->valueint = 1;
+    }
+    else if ((node->type == cJSON_String) || (node->type == cJSON_Raw))
+    {
+        item->valuestring = (char*)cJSON_strdup((const unsigned char*)cJSON_CompactGetString(node), &global_hooks);
+        if (item->valuestring == NULL)
+        {
+            goto fail;
+        }
+    }
+
+    if (node->name != 0)
+    {
+        item->string = (char*)cJSON_strdup((const unsigned char*)cJSON_CompactGetName(node), &global_hooks);
+        if (item->string == NULL)
+        {
+            goto fail;
+        }
+    }
+
+    return item;
+
+fail:
+    cJSON_Delete(item);
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ExpandCompact(const cJSON_Compact *item)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    const cJSON_Compact *node = item;
+    cJSON *root = NULL;
+    cJSON *copy = NULL;
+
+    if (item == NULL)
+    {
+        return NULL;
+    }
+
+    root = expand_compact_item(item);
+    if ((root == NULL) || (cJSON_CompactGetChild(item) == NULL))
+    {
+        return root;
+    }
+
+    nesting_init(&stack, &global_hooks);
+    frame = nesting_push(&stack); /* can't fail, the first frames are on the C stack */
+    frame->container = root;
+    /* the nodes of a subtree are stored one after the other, a level ends with a node without a next sibling */
+    for (node = item + 1; stack.depth > 0; node++)
+    {
+        frame = &stack.frames[stack.depth - 1];
+        copy = expand_compact_item(node);
+        if (copy == NULL)
+        {
+            goto fail;
+        }
+        if (frame->last == NULL)
+        {
+            frame->container->child = copy;
+        }
+        else
+        {
+            frame->last->next = copy;
+            copy->prev = frame->last;
+        }
+        frame->container->child->prev = copy;
+        frame->last = copy;
+        frame->index = node->next;
+
+        if (cJSON_CompactGetChild(node) != NULL)
+        {
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                goto fail;
+            }
+            frame->container = copy;
+            continue;
+        }
+
+        /* leave the arrays and objects that end here */
+        while ((stack.depth > 0) && (stack.frames[stack.depth - 1].index == 0))
+        {
+            stack.depth--;
+        }
+    }
+    nesting_free(&stack);
+
+    return root;
+
+fail:
+    nesting_free(&stack);
+    cJSON_Delete(root);
+
+    return NULL;
+}
+
+/* Binary encodings: CBOR (RFC 8949) and MessagePack. Both map directly to cJSON types, so there is no separate model. */
+typedef enum
+{
+    binary_cbor,
+    binary_message_pack
+} binary_format;
+
+/* Store the integer value (below 2^64) in bytes big endian bytes. */
+static void put_unsigned(unsigned char * const output, const double value, const size_t bytes)
+{
+    unsigned long part = 0;
+    size_t i = 0;
+
+    if (bytes == 8)
+    {
+        part = (unsigned long)(value / 4294967296.0);
+        put_unsigned(output, (double)part, 4);
+        put_unsigned(output + 4, value - ((double)part * 4294967296.0), 4);
+        return;
+    }
+
+    part = (unsigned long)value;
+    for (i = bytes; i > 0; i--)
+    {
+        output[i - 1] = (unsigned char)(part & 0xFF);
+        part >>= 8;
+    }
+}
+
+/* Read a big endian integer of 1, 2, 4 or 8 bytes. */
+static double get_unsigned(const unsigned char * const input, const size_t bytes)
+{
+    unsigned long value = 0;
+    size_t i = 0;
+
+    if (bytes == 8)
+    {
+        return (get_unsigned(input, 4) * 4294967296.0) + get_unsigned(input + 4, 4);
+    }
+
+    for (i = 0; i < bytes; i++)
+    {
+        value = (value << 8) | input[i];
+    }
+
+    return (double)value;
+}
+
+/* Copy bytes between the byte order of the machine and big endian. */
+static void copy_big_endian(unsigned char * const output, const unsigned char * const input, const size_t bytes)
+{
+    size_t i = 0;
+
+    if (!is_little_endian())
+    {
+        memcpy(output, input, bytes);
+        return;
+    }
+
+    for (i = 0; i < bytes; i++)
+    {
+        output[i] = input[bytes - 1 - i];
+    }
+}
+
+static double get_float(const unsigned char * const input)
+{
+    float number = 0;
+
+    copy_big_endian((unsigned char*)&number, input, sizeof(float));
+
+    return (double)number;
+}
+
+static double get_double(const unsigned char * const input)
+{
+    double number = 0;
+
+    copy_big_endian((unsigned char*)&number, input, sizeof(double));
+
+    return number;
+}
+
+/* 2 to the power of exponent, exact and without libm. */
+static double power_of_two(int exponent)
+{
+    double power = 1;
+
+    for (; exponent > 0; exponent--)
+    {
+        power *= 2;
+    }
+    for (; exponent < 0; exponent++)
+    {
+        power /= 2;
+    }
+
+    return power;
+}
+
+/* floor for 0 <= magnitude < 2^64 without libm, the halves are truncated separately so the result stays exact. */
+static double floor_magnitude(const double magnitude)
+{
+    const double high = (double)(unsigned long)(magnitude / 4294967296.0) * 4294967296.0;
+
+    return high + (double)(unsigned long)(magnitude - high);
+}
+
+/* Convert an IEEE 754 half precision float. */
+static double get_half(const unsigned char * const input)
+{
+    const unsigned int half = (unsigned int)((input[0] << 8) | input[1]);
+    const unsigned int exponent = (half >> 10) & 0x1F;
+    const unsigned int mantissa = half & 0x3FF;
+    unsigned char single[4];
+    double number = 0;
+
+    if (exponent == 0x1F)
+    {
+        /* infinity and NaN, as a single precision float with the same payload */
+        put_unsigned(single, (double)((unsigned long)((half & 0x8000) << 16) | 0x7F800000UL | ((unsigned long)mantissa << 13)), 4);
+        return get_float(single);
+    }
+
+    number = (exponent == 0) ? ((double)mantissa * power_of_two(-24)) : ((double)(mantissa + 0x400) * power_of_two((int)exponent - 25));
+
+    return (half & 0x8000) ? -number : number;
+}
+
+/* The largest magnitude up to which all integers can be represented by a double. */
+#define BINARY_INTEGER_LIMIT 9007199254740992.0
+
+/* Check if a number is encoded as an integer, -0 is kept as a float. */
+static cJSON_bool is_binary_integer(const double number)
+{
+    const double negative_zero = -0.0;
+
+    /* -0 is told apart by its bits, dividing by it would trap with float-divide-by-zero sanitizers */
+    return (number >= -BINARY_INTEGER_LIMIT) && (number <= BINARY_INTEGER_LIMIT)
+        && (floor_magnitude((number < 0) ? -number : number) == ((number < 0) ? -number : number))
+        && !((number == 0) && (memcmp(&number, &negative_zero, sizeof(number)) == 0));
+}
+
+/* Append a CBOR head: the major type and its argument in the shortest form. */
+static cJSON_bool put_cbor_head(printbuffer * const output_buffer, const unsigned int major, const double argument)
+{
+    unsigned char *output = ensure(output_buffer, 9, &global_hooks);
+    size_t bytes = 0;
+
+    if (output == NULL)
+    {
+        return false;
+    }
+
+    if (argument < 24)
+    {
+        output[0] = (unsigned char)((major << 5) | (unsigned int)argument);
+        output_buffer->offset++;
+        return true;
+    }
+
+    bytes = (argument <= 0xFF) ? 1 : ((argument <= 0xFFFF) ? 2 : ((argument <= 4294967295.0) ? 4 : 8));
+    output[0] = (unsigned char)((major << 5) | ((bytes == 1) ? 24U : ((bytes == 2) ? 25U : ((bytes == 4) ? 26U : 27U))));
+    put_unsigned(output + 1, argument, bytes);
+    output_buffer->offset += bytes + 1;
+
+    return true;
+}
+
+/* Append a MessagePack marker followed by value in bytes bytes. */
+static cJSON_bool put_message_pack_head(printbuffer * const output_buffer, const unsigned char marker, const double value, const size_t bytes)
+{
+    unsigned char *output = ensure(output_buffer, bytes + 1, &global_hooks);
+
+    if (output == NULL)
+    {
+        return false;
+    }
+
+    output[0] = marker;
+    put_unsigned(output + 1, value, bytes);
+    output_buffer->offset += bytes + 1;
+
+    return true;
+}
+
+/* Append the head of a string (size in bytes), array or object (size in elements). */
+static cJSON_bool put_binary_size(printbuffer * const output_buffer, const binary_format format, const int type, const size_t size)
+{
+    /* fix, 8, 16 and 32 bit markers of MessagePack, there is no 8 bit size for arrays and maps */
+    static const unsigned char string_markers[] = { 0xA0, 0xD9, 0xDA, 0xDB };
+    static const unsigned char array_markers[] = { 0x90, 0x00, 0xDC, 0xDD };
+    static const unsigned char object_markers[] = { 0x80, 0x00, 0xDE, 0xDF };
+    const unsigned char *markers = (type == cJSON_String) ? string_markers : ((type == cJSON_Array) ? array_markers : object_markers);
+
+    if (format == binary_cbor)
+    {
+        return put_cbor_head(output_buffer, (type == cJSON_String) ? 3U : ((type == cJSON_Array) ? 4U : 5U), (double)size);
+    }
+
+    if (size < ((type == cJSON_String) ? 32U : 16U))
+    {
+        return put_message_pack_head(output_buffer, (unsigned char)(markers[0] | size), 0, 0);
+    }
+    if ((size <= 0xFF) && (type == cJSON_String))
+    {
+        return put_message_pack_head(output_buffer, markers[1], (double)size, 1);
+    }
+    if (size <= 0xFFFF)
+    {
+        return put_message_pack_head(output_buffer, markers[2], (double)size, 2);
+    }
+    if ((double)size <= 4294967295.0)
+    {
+        return put_message_pack_head(output_buffer, markers[3], (double)size, 4);
+    }
+
+    return false;
+}
+
+static cJSON_bool put_binary_string(printbuffer * const output_buffer, const binary_format format, const char * const string)
+{
+    const size_t length = strlen(string);
+    unsigned char *output = NULL;
+
+    if (!put_binary_size(output_buffer, format, cJSON_String, length))
+    {
+        return false;
+    }
+    output = ensure(output_buffer, length, &global_hooks);
+    if (output == NULL)
+    {
+        return false;
+    }
+    memcpy(output, string, length);
+    output_buffer->offset += length;
+
+    return true;
+}
+
+static cJSON_bool put_binary_number(printbuffer * const output_buffer, const binary_format format, const double number)
+{
+    unsigned char *output = NULL;
+    const unsigned char *bytes = NULL;
+    double magnitude = 0;
+    float single = 0;
+    size_t size = sizeof(double);
+
+    if (is_binary_integer(number))
+    {
+        if (format == binary_cbor)
+        {
+            /* negative integers are stored as -1 - n */
+            return (number < 0) ? put_cbor_head(output_buffer, 1, -1 - number) : put_cbor_head(output_buffer, 0, number);
+        }
+
+        if (number >= 0)
+        {
+            if (number < 128)
+            {
+                return put_message_pack_head(output_buffer, (unsigned char)number, 0, 0);
+            }
+            return (number <= 0xFF) ? put_message_pack_head(output_buffer, 0xCC, number, 1)
+                : ((number <= 0xFFFF) ? put_message_pack_head(output_buffer, 0xCD, number, 2)
+                : ((number <= 4294967295.0) ? put_message_pack_head(output_buffer, 0xCE, number, 4)
+                : put_message_pack_head(output_buffer, 0xCF, number, 8)));
+        }
+
+        /* two's complement */
+        if (number >= -32)
+        {
+            return put_message_pack_head(output_buffer, (unsigned char)(256 + number), 0, 0);
+        }
+        if (number >= -2147483648.0)
+        {
+            return (number >= -128) ? put_message_pack_head(output_buffer, 0xD0, 256 + number, 1)
+                : ((number >= -32768) ? put_message_pack_head(output_buffer, 0xD1, 65536 + number, 2)
+                : put_message_pack_head(output_buffer, 0xD2, 4294967296.0 + number, 4));
+        }
+        /* 2^64 + number isn't exact as a double, so the halves are inverted separately: -n = ~(n - 1) */
+        magnitude = -number - 1;
+        if (!put_message_pack_head(output_buffer, 0xD3, 4294967295.0 - floor_magnitude(magnitude / 4294967296.0), 4))
+        {
+            return false;
+        }
+        output = ensure(output_buffer, 4, &global_hooks);
+        if (output == NULL)
+        {
+            return false;
+        }
+        put_unsigned(output, 4294967295.0 - (magnitude - (floor_magnitude(magnitude / 4294967296.0) * 4294967296.0)), 4);
+        output_buffer->offset += 4;
+        return true;
+    }
+
+    /* single precision is enough if it keeps the value, infinity and NaN are stored with double precision */
+    if ((number <= (double)FLT_MAX) && (number >= -(double)FLT_MAX) && ((double)(float)number == number))
+    {
+        size = sizeof(float);
+    }
+
+    output = ensure(output_buffer, size + 1, &global_hooks);
+    if (output == NULL)
+    {
+        return false;
+    }
+    if (size == sizeof(float))
+    {
+        single = (float)number;
+        bytes = (const unsigned char*)&single;
+        output[0] = (format == binary_cbor) ? 0xFA : 0xCA;
+    }
+    else
+    {
+        bytes = (const unsigned char*)&number;
+        output[0] = (format == binary_cbor) ? 0xFB : 0xCB;
+    }
+    copy_big_endian(output + 1, bytes, size);
+    output_buffer->offset += size + 1;
+
+    return true;
+}
+
+/* Append an item without its children, named items are preceded by their name. */
+static cJSON_bool put_binary_item(printbuffer * const output_buffer, const binary_format format, const cJSON * const item, const cJSON_bool named)
+{
+    static const unsigned char cbor_literals[] = { 0xF4, 0xF5, 0xF6 };
+    static const unsigned char message_pack_literals[] = { 0xC2, 0xC3, 0xC0 };
+    const unsigned char *literals = (format == binary_cbor) ? cbor_literals : message_pack_literals;
+    const cJSON *child = NULL;
+    const double *numbers = NULL;
+    size_t count = 0;
+    int i = 0;
+
+    if (named && ((item->string == NULL) || !put_binary_string(output_buffer, format, item->string)))
+    {
+        return false;
+    }
+
+    if (item->type & cJSON_IsPacked)
+    {
+        numbers = packed_numbers(item);
+        if (!put_binary_size(output_buffer, format, cJSON_Array, (size_t)item->valueint))
+        {
+            return false;
+        }
+        for (i = 0; i < item->valueint; i++)
+        {
+            if (!put_binary_number(output_buffer, format, numbers[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (!load_lazy(item))
+    {
+        return false;
+    }
+
+    switch (item->type & 0xFF)
+    {
+        case cJSON_False:
+        case cJSON_True:
+        case cJSON_NULL:
+            return put_message_pack_head(output_buffer, literals[((item->type & 0xFF) == cJSON_False) ? 0 : (((item->type & 0xFF) == cJSON_True) ? 1 : 2)], 0, 0);
+
+        case cJSON_Number:
+            return put_binary_number(output_buffer, format, item->valuedouble);
+
+        case cJSON_String:
+            return (item->valuestring != NULL) && put_binary_string(output_buffer, format, item->valuestring);
+
+        case cJSON_Array:
+        case cJSON_Object:
+            for (child = item->child; child != NULL; child = child->next)
+            {
+                count++;
+            }
+            return put_binary_size(output_buffer, format, item->type & 0xFF, count);
+
+        default:
+            /* raw json has no binary form */
+            return false;
+    }
+}
+
+/* Append the whole tree in pre-order, arrays and objects start with the number of their elements. */
+static cJSON_bool print_binary(const cJSON * const item, const binary_format format, printbuffer * const output_buffer)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    const cJSON *current_item = item;
+
+    if (!put_binary_item(output_buffer, format, item, false))
+    {
+        return false;
+    }
+
+    nesting_init(&stack, &global_hooks);
+    for (;;)
+    {
+        if (is_container(current_item) && (current_item->child != NULL))
+        {
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                goto fail;
+            }
+            frame->source = current_item;
+            frame->current = current_item->child;
+        }
+        else
+        {
+            /* go to the next sibling, leaving the arrays and objects that end here */
+            while ((stack.depth > 0) && (stack.frames[stack.depth - 1].current->next == NULL))
+            {
+                stack.depth--;
+            }
+            if (stack.depth == 0)
+            {
+                nesting_free(&stack);
+                return true;
+            }
+            frame = &stack.frames[stack.depth - 1];
+            frame->current = frame->current->next;
+        }
+
+        if (!put_binary_item(output_buffer, format, frame->current, (frame->source->type & 0xFF) == cJSON_Object))
+        {
+            goto fail;
+        }
+        current_item = frame->current;
+    }
+
+fail:
+    nesting_free(&stack);
+
+    return false;
+}
+
+static unsigned char *print_binary_document(const cJSON * const item, const binary_format format, size_t * const length)
+{
+    printbuffer buffer[1];
+
+    if (item == NULL)
+    {
+        return NULL;
+    }
+
+    memset(buffer, 0, sizeof(buffer));
+    buffer->buffer = (unsigned char*)global_hooks.allocate(256);
+    if (buffer->buffer == NULL)
+    {
+        return NULL;
+    }
+    buffer->length = 256;
+
+    if (!print_binary(item, format, buffer))
+    {
+        if (buffer->buffer != NULL)
+        {
+            global_hooks.deallocate(buffer->buffer);
+        }
+        return NULL;
+    }
+
+    if (length != NULL)
+    {
+        *length = buffer->offset;
+    }
+
+    return buffer->buffer;
+}
+
+CJSON_PUBLIC(unsigned char *) cJSON_PrintCBOR(const cJSON *item, size_t *length)
+{
+    return print_binary_document(item, binary_cbor, length);
+}
+
+CJSON_PUBLIC(unsigned char *) cJSON_PrintMessagePack(const cJSON *item, size_t *length)
+{
+    return print_binary_document(item, binary_message_pack, length);
+}
+
+/* Parses one value of a binary encoding into item. For arrays and objects, only the head is read and the number of
+ * elements is stored in *count. Returns the position after what was read. */
+typedef const unsigned char *(*binary_value_parser)(cJSON * const item, const unsigned char * const input, parse_context * const context, size_t * const count);
+
+/* Make item a string of the length bytes at input, strings that contain '\0' aren't supported. */
+static const unsigned char *parse_binary_string(cJSON * const item, const unsigned char * const head, const unsigned char * const input, const double length, parse_context * const context)
+{
+    if ((double)(context->end - input) < length)
+    {
+        return parse_error(context, head, cJSON_Error_UnexpectedEnd);
+    }
+    if (memchr(input, '\0', (size_t)length) != NULL)
+    {
+        return parse_error(context, head, cJSON_Error_InvalidValue);
+    }
+
+    item->valuestring = (char*)allocate_memory((size_t)length + 1, context->hooks);
+    if (item->valuestring == NULL)
+    {
+        return parse_error(context, head, cJSON_Error_OutOfMemory);
+    }
+    memcpy(item->valuestring, input, (size_t)length);
+    item->valuestring[(size_t)length] = '\0';
+    store_valuestring_length(item, (size_t)length);
+    item->type = cJSON_String;
+
+    return input + (size_t)length;
+}
+
+/* Make item an array or an object of count elements, each of which takes at least size bytes. */
+static const unsigned char *parse_binary_container(cJSON * const item, const int type, const unsigned char * const head, const unsigned char * const input, const double count, const size_t size, parse_context * const context, size_t * const element_count)
+{
+    if (((double)(context->end - input) / (double)size) < count)
+    {
+        /* the elements can't fit in the rest of the input */
+        return parse_error(context, head, cJSON_Error_UnexpectedEnd);
+    }
+
+    item->type = type;
+    *element_count = (size_t)count;
+
+    return input;
+}
+
+static const unsigned char *parse_binary_number(cJSON * const item, const double number, const unsigned char * const input)
+{
+    store_number(item, number);
+    item->type = cJSON_Number;
+
+    return input;
+}
+
+static const unsigned char *parse_cbor_value(cJSON * const item, const unsigned char * const input, parse_context * const context, size_t * const count)
+{
+    const unsigned char *head = input;
+    unsigned int major = 0;
+    unsigned int info = 0;
+    size_t bytes = 0;
+    double argument = 0;
+
+    for (;;)
+    {
+        if (!can_read(context, head, 1))
+        {
+            return parse_error(context, head, cJSON_Error_UnexpectedEnd);
+        }
+        major = (unsigned int)(head[0] >> 5);
+        info = (unsigned int)(head[0] & 0x1F);
+        if (info > 27)
+        {
+            /* indefinite lengths aren't supported */
+            return parse_error(context, head, cJSON_Error_InvalidValue);
+        }
+        bytes = (info < 24) ? 0 : ((size_t)1 << (info - 24));
+        if (!can_read(context, head + 1, bytes))
+        {
+            return parse_error(context, head, cJSON_Error_UnexpectedEnd);
+        }
+        argument = (info < 24) ? (double)info : get_unsigned(head + 1, bytes);
+        if (major != 6)
+        {
+            break;
+        }
+        /* tags only add a meaning to the value that follows, which cJSON can't keep */
+        head += bytes + 1;
+    }
+
+    switch (major)
+    {
+        case 0:
+            return parse_binary_number(item, argument, head + bytes + 1);
+
+        case 1:
+            return parse_binary_number(item, -1 - argument, head + bytes + 1);
+
+        case 3:
+            return parse_binary_string(item, head, head + bytes + 1, argument, context);
+
+        case 4:
+            return parse_binary_container(item, cJSON_Array, head, head + bytes + 1, argument, 1, context, count);
+
+        case 5:
+            return parse_binary_container(item, cJSON_Object, head, head + bytes + 1, argument, 2, context, count);
+
+        case 7:
+            switch (info)
+            {
+                case 20:
+                    item->type = cJSON_False;
+                    return head + 1;
+
+                case 21:
+                    item->type = cJSON_True;
+                    item->valueint = 1;
+                    return head + 1;
+
+                case 22:
+                case 23:
+                    /* null and undefined */
+                    item->type = cJSON_NULL;
+                    return head + 1;
+
+                case 25:
+                    return parse_binary_number(item, get_half(head + 1), head + 3);
+
+                case 26:
+                    return parse_binary_number(item, get_float(head + 1), head + 5);
+
+                case 27:
+                    return parse_binary_number(item, get_double(head + 1), head + 9);
+
+                default:
+                    return parse_error(context, head, cJSON_Error_InvalidValue);
+            }
+
+        default:
+            /* byte strings */
+            return parse_error(context, head, cJSON_Error_InvalidValue);
+    }
+}
+
+/* Read the signed integer of 1, 2, 4 or 8 bytes in two's complement at input. */
+static double get_signed(const unsigned char * const input, const size_t bytes)
+{
+    if (!(input[0] & 0x80))
+    {
+        return get_unsigned(input, bytes);
+    }
+    if (bytes == 8)
+    {
+        /* -(~n + 1), the halves are inverted separately so the result stays exact */
+        return -(((4294967295.0 - get_unsigned(input, 4)) * 4294967296.0) + (4294967295.0 - get_unsigned(input + 4, 4)) + 1);
+    }
+
+    return get_unsigned(input, bytes) - power_of_two((int)(bytes * 8));
+}
+
+static const unsigned char *parse_message_pack_value(cJSON * const item, const unsigned char * const input, parse_context * const context, size_t * const count)
+{
+    unsigned char marker = 0;
+    size_t bytes = 0;
+
+    if (!can_read(context, input, 1))
+    {
+        return parse_error(context, input, cJSON_Error_UnexpectedEnd);
+    }
+    marker = input[0];
+
+    /* markers that contain their value */
+    if ((marker <= 0x7F) || (marker >= 0xE0))
+    {
+        return parse_binary_number(item, (marker <= 0x7F) ? (double)marker : ((double)marker - 256), input + 1);
+    }
+    if (marker <= 0x8F)
+    {
+        return parse_binary_container(item, cJSON_Object, input, input + 1, (double)(marker & 0x0F), 2, context, count);
+    }
+    if (marker <= 0x9F)
+    {
+        return parse_binary_container(item, cJSON_Array, input, input + 1, (double)(marker & 0x0F), 1, context, count);
+    }
+    if (marker <= 0xBF)
+    {
+        return parse_binary_string(item, input, input + 1, (double)(marker & 0x1F), context);
+    }
+
+    /* the size of what follows the marker */
+    switch (marker)
+    {
+        case 0xCC:
+        case 0xD0:
+        case 0xD9:
+            bytes = 1;
+            break;
+
+        case 0xCD:
+        case 0xD1:
+        case 0xDA:
+        case 0xDC:
+        case 0xDE:
+            bytes = 2;
+            break;
+
+        case 0xCA:
+        case 0xCE:
+        case 0xD2:
+        case 0xDB:
+        case 0xDD:
+        case 0xDF:
+            bytes = 4;
+            break;
+
+        case 0xCB:
+        case 0xCF:
+        case 0xD3:
+            bytes = 8;
+            break;
+
+        default:
+            bytes = 0;
+            break;
+    }
+    if (!can_read(context, input + 1, bytes))
+    {
+        return parse_error(context, input, cJSON_Error_UnexpectedEnd);
+    }
+
+    switch (marker)
+    {
+        case 0xC0:
+            item->type = cJSON_NULL;
+            return input + 1;
+
+        case 0xC2:
+            item->type = cJSON_False;
+            return input + 1;
+
+        case 0xC3:
+            item->type = cJSON_True;
+            item->valueint = 1;
+            return input + 1;
+
+        case 0xCA:
+            return parse_binary_number(item, get_float(input + 1), input + 5);
+
+        case 0xCB:
+            return parse_binary_number(item, get_double(input + 1), input + 9);
+
+        case 0xCC:
+        case 0xCD:
+        case 0xCE:
+        case 0xCF:
+            return parse_binary_number(item, get_unsigned(input + 1, bytes), input + bytes + 1);
+
+        case 0xD0:
+        case 0xD1:
+        case 0xD2:
+        case 0xD3:
+            return parse_binary_number(item, get_signed(input + 1, bytes), input + bytes + 1);
+
+        case 0xD9:
+        case 0xDA:
+        case 0xDB:
+            return parse_binary_string(item, input, input + bytes + 1, get_unsigned(input + 1, bytes), context);
+
+        case 0xDC:
+        case 0xDD:
+            return parse_binary_container(item, cJSON_Array, input, input + bytes + 1, get_unsigned(input + 1, bytes), 1, context, count);
+
+        case 0xDE:
+        case 0xDF:
+            return parse_binary_container(item, cJSON_Object, input, input + bytes + 1, get_unsigned(input + 1, bytes), 2, context, count);
+
+        default:
+            /* binary data, extension types and unused markers */
+            return parse_error(context, input, cJSON_Error_InvalidValue);
+    }
+}
+
+/* Build the tree of the value at input without recursion. Returns the position after it. */
+static const unsigned char *parse_binary(cJSON * const item, const unsigned char *input, parse_context * const context, const binary_value_parser parse_value_function)
+{
+    nesting_stack stack;
+    nesting_frame *frame = NULL;
+    cJSON *current_item = item;
+    cJSON *element = NULL;
+    const unsigned char *name = NULL;
+    size_t count = 0;
+
+    nesting_init(&stack, context->hooks);
+    for (;;)
+    {
+        count = 0;
+        input = parse_value_function(current_item, input, context, &count);
+        if (input == NULL)
+        {
+            goto fail;
+        }
+        if (count > 0)
+        {
+            if (stack.depth >= CJSON_NESTING_LIMIT)
+            {
+                parse_error(context, input, cJSON_Error_TooDeep);
+                goto fail; /* too deeply nested */
+            }
+            frame = nesting_push(&stack);
+            if (frame == NULL)
+            {
+                parse_error(context, input, cJSON_Error_OutOfMemory);
+                goto fail; /* allocation failure */
+            }
+            frame->container = current_item;
+            frame->index = count;
+        }
+
+        /* leave the arrays and objects that are complete */
+        while ((stack.depth > 0) && (stack.frames[stack.depth - 1].index == 0))
+        {
+            stack.depth--;
+        }
+        if (stack.depth == 0)
+        {
+            nesting_free(&stack);
+            return input;
+        }
+
+        frame = &stack.frames[stack.depth - 1];
+        frame->index--;
+        element = cJSON_New_Item(context->hooks);
+        if (element == NULL)
+        {
+            parse_error(context, input, cJSON_Error_OutOfMemory);
+            goto fail; /* allocation failure */
+        }
+        if (frame->last == NULL)
+        {
+            frame->container->child = element;
+        }
+        else
+        {
+            frame->last->next = element;
+            element->prev = frame->last;
+        }
+        frame->container->child->prev = element;
+        frame->last = element;
+
+        if ((frame->container->type & 0xFF) == cJSON_Object)
+        {
+            /* the name is read like a value and moved */
+            name = input;
+            input = parse_value_function(element, input, context, &count);
+            if (input == NULL)
+            {
+                goto fail;
+            }
+            if (element->type != cJSON_String)
+            {
+                parse_error(context, name, cJSON_Error_ExpectedName);
+                goto fail;
+            }
+            move_string_to_name(element);
+            element->type = cJSON_Invalid;
+        }
+        current_item = element;
+    }
+
+fail:
+    nesting_free(&stack);
+
+    return NULL;
+}
+
+static cJSON *parse_binary_document(const void * const value, const size_t length, const binary_value_parser parse_value_function, cJSON_ParseError * const error)
+{
+    parse_context context;
+    const unsigned char *input = (const unsigned char*)value;
+    const unsigned char *end = NULL;
+    cJSON *item = NULL;
+
+    context.hooks = &global_hooks;
+    context.error_position = NULL;
+    context.error_code = cJSON_Error_None;
+    context.inline_item = NULL;
+    context.end = input + length;
+
+    if (value == NULL)
+    {
+        parse_error(&context, NULL, cJSON_Error_InvalidValue);
+        goto fail;
+    }
+
+    item = cJSON_New_Item(&global_hooks);
+    if (item == NULL)
+    {
+        parse_error(&context, input, cJSON_Error_OutOfMemory);
+        goto fail;
+    }
+
+    end = parse_binary(item, input, &context, parse_value_function);
+    if (end == NULL)
+    {
+        goto fail;
+    }
+    if (end != context.end)
+    {
+        parse_error(&context, end, cJSON_Error_TrailingCharacters);
+        goto fail;
+    }
+
+    if (error != NULL)
+    {
+        memset(error, '\0', sizeof(cJSON_ParseError));
+    }
+
+    return item;
+
+fail:
+    if (item != NULL)
+    {
+        delete_item(item, &global_hooks);
+    }
+    if (error != NULL)
+    {
+        /* there are no lines in binary data */
+        memset(error, '\0', sizeof(cJSON_ParseError));
+        error->code = context.error_code;
+        if (context.error_position != NULL)
+        {
+            error->position = (size_t)(context.error_position - input);
+        }
+    }
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseCBOR(const void *value, size_t length, cJSON_ParseError *error)
+{
+    return parse_binary_document(value, length, parse_cbor_value, error);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseMessagePack(const void *value, size_t length, cJSON_ParseError *error)
+{
+    return parse_binary_document(value, length, parse_message_pack_value, error);
+}
+
+/* A compiled list of fields. Nested structs have a schema of their own that knows its parent, so parsing can go back to
+ * it without a stack. All schemas of a root are kept in a list. */
+typedef struct
+{
+    const cJSON_Field *field;
+    size_t name_length;
+    /* the escaped name with quotes and the colon, ready to be printed */
+    unsigned char *key;
+    size_t key_length;
+    /* cJSON_FieldObject */
+    struct cJSON_Schema *nested;
+} schema_field;
+
+struct cJSON_Schema
+{
+    /* NULL for the root */
+    struct cJSON_Schema *parent;
+    /* the next schema in the list of the root */
+    struct cJSON_Schema *next;
+    /* the table of fields that is compiled */
+    const cJSON_Field *source;
+    /* offset of the struct from the struct of the root */
+    size_t base;
+    /* position of the field in the parent */
+    size_t index;
+    size_t depth;
+    size_t count;
+    schema_field *fields;
+};
+
+/* Escape the name of a field once, so printing only has to copy it. */
+static cJSON_bool compile_key(schema_field * const field)
+{
+    printbuffer buffer[1];
+    unsigned char *output = NULL;
+
+    memset(buffer, 0, sizeof(buffer));
+    buffer->length = field->name_length + sizeof("\"\":");
+    buffer->buffer = (unsigned char*)global_hooks.allocate(buffer->length);
+    if (buffer->buffer == NULL)
+    {
+        return false;
+    }
+
+    if (!print_string_ptr((const unsigned char*)field->field->name, buffer, &global_hooks))
+    {
+        goto fail;
+    }
+    update_offset(buffer);
+    output = ensure(buffer, 1, &global_hooks);
+    if (output == NULL)
+    {
+        goto fail;
+    }
+    *output = ':';
+
+    field->key = buffer->buffer;
+    field->key_length = buffer->offset + 1;
+
+    return true;
+
+fail:
+    if (buffer->buffer != NULL)
+    {
+        global_hooks.deallocate(buffer->buffer);
+    }
+
+    return false;
+}
+
+/* Compile the fields of schema, nested schemas are appended to the list after *last. */
+static cJSON_bool compile_schema(cJSON_Schema * const schema, cJSON_Schema ** const last)
+{
+    const cJSON_Field * const fields = schema->source;
+    cJSON_Schema *nested = NULL;
+    size_t count = 0;
+    size_t i = 0;
+
+    for (count = 0; fields[count].name != NULL; count++)
+    {
+    }
+    if (count == 0)
+    {
+        return true;
+    }
+
+    schema->fields = (schema_field*)global_hooks.allocate(count * sizeof(schema_field));
+    if (schema->fields == NULL)
+    {
+        return false;
+    }
+    memset(schema->fields, '\0', count * sizeof(schema_field));
+    schema->count = count;
+
+    for (i = 0; i < count; i++)
+    {
+        schema->fields[i].field = &fields[i];
+        schema->fields[i].name_length = strlen(fields[i].name);
+        if (!compile_key(&schema->fields[i]))
+        {
+            return false;
+        }
+        switch (fields[i].type)
+        {
+            case cJSON_FieldBool:
+            case cJSON_FieldInt:
+            case cJSON_FieldDouble:
+            case cJSON_FieldString:
+                break;
+
+            case cJSON_FieldChars:
+                if (fields[i].size == 0)
+                {
+                    return false;
+                }
+                break;
+
+            case cJSON_FieldObject:
+                /* tables that contain themselves end here */
+                if ((fields[i].fields == NULL) || (schema->depth >= CJSON_NESTING_LIMIT))
+                {
+                    return false;
+                }
+                nested = (cJSON_Schema*)global_hooks.allocate(sizeof(cJSON_Schema));
+                if (nested == NULL)
+                {
+                    return false;
+                }
+                memset(nested, '\0', sizeof(cJSON_Schema));
+                nested->parent = schema;
+                nested->source = fields[i].fields;
+                nested->base = schema->base + fields[i].offset;
+                nested->index = i;
+                nested->depth = schema->depth + 1;
+                (*last)->next = nested;
+                *last = nested;
+                schema->fields[i].nested = nested;
+                break;
+
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_Schema *) cJSON_CreateSchema(const cJSON_Field *fields)
+{
+    cJSON_Schema *root = NULL;
+    cJSON_Schema *schema = NULL;
+    cJSON_Schema *last = NULL;
+
+    if (fields == NULL)
+    {
+        return NULL;
+    }
+
+    root = (cJSON_Schema*)global_hooks.allocate(sizeof(cJSON_Schema));
+    if (root == NULL)
+    {
+        return NULL;
+    }
+    memset(root, '\0', sizeof(cJSON_Schema));
+    root->source = fields;
+
+    /* the list grows while it is compiled, so nested structs don't need recursion */
+    last = root;
+    for (schema = root; schema != NULL; schema = schema->next)
+    {
+        if (!compile_schema(schema, &last))
+        {
+            cJSON_DeleteSchema(root);
+            return NULL;
+        }
+    }
+
+    return root;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteSchema(cJSON_Schema *schema)
+{
+    cJSON_Schema *next = NULL;
+    size_t i = 0;
+
+    for (; schema != NULL; schema = next)
+    {
+        next = schema->next;
+        for (i = 0; i < schema->count; i++)
+        {
+            if (schema->fields[i].key != NULL)
+            {
+                global_hooks.deallocate(schema->fields[i].key);
+            }
+        }
+        if (schema->fields != NULL)
+        {
+            global_hooks.deallocate(schema->fields);
+        }
+        global_hooks.deallocate(schema);
+    }
+}
+
+CJSON_PUBLIC(void) cJSON_FreeStructStrings(const cJSON_Schema *schema, void *target)
+{
+    char **string = NULL;
+    size_t i = 0;
+
+    if (target == NULL)
+    {
+        return;
+    }
+
+    for (; schema != NULL; schema = schema->next)
+    {
+        for (i = 0; i < schema->count; i++)
+        {
+            if (schema->fields[i].field->type != cJSON_FieldString)
+            {
+                continue;
+            }
+            string = (char**)(void*)((unsigned char*)target + schema->base + schema->fields[i].field->offset);
+            if (*string != NULL)
+            {
+                global_hooks.deallocate(*string);
+                *string = NULL;
+            }
+        }
+    }
+}
+
+/* Find the text of the string at input. Strings without escape sequences are used in place, the others are unescaped
+ * into scratch->valuestring, which the caller frees. Returns the position after the string. */
+static const unsigned char *parse_struct_string(cJSON * const scratch, const unsigned char * const input, parse_context * const context, const unsigned char ** const text, size_t * const length)
+{
+    const unsigned char *end = find_string_special(input + 1, context->end);
+
+    if (char_at(context, end) == '\"')
+    {
+        *text = input + 1;
+        *length = (size_t)(end - input - 1);
+        return end + 1;
+    }
+
+    end = parse_string(scratch, input, context);
+    if (end == NULL)
+    {
+        return NULL;
+    }
+    *text = (const unsigned char*)scratch->valuestring;
+    *length = valuestring_length(scratch);
+
+    return end;
+}
+
+/* Parse a member name and find its field, *field is NULL for members that aren't in the schema. Returns the position
+ * of the value. */
+static const unsigned char *parse_struct_name(const cJSON_Schema * const schema, const unsigned char *input, parse_context * const context, const schema_field ** const field)
+{
+    cJSON scratch;
+    const unsigned char *name = NULL;
+    size_t length = 0;
+    size_t i = 0;
+
+    if (char_at(context, input) != '\"')
+    {
+        return parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedName);
+    }
+
+    memset(&scratch, '\0', sizeof(scratch));
+    input = parse_struct_string(&scratch, input, context, &name, &length);
+    if (input == NULL)
+    {
+        return NULL;
+    }
+
+    *field = NULL;
+    for (i = 0; i < schema->count; i++)
+    {
+        if ((schema->fields[i].name_length == length) && (memcmp(schema->fields[i].field->name, name, length) == 0))
+        {
+            *field = &schema->fields[i];
+            break;
+        }
+    }
+    if (scratch.valuestring != NULL)
+    {
+        global_hooks.deallocate(scratch.valuestring);
     }
 
-    return item;
+    input = skip_whitespace(context, input);
+    if (char_at(context, input) != ':')
+    {
+        return parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedColon);
+    }
+
+    return skip_whitespace(context, input + 1);
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateObject(void)
+/* Skip the value of a member that isn't stored. */
+static const unsigned char *skip_struct_value(const unsigned char * const input, parse_context * const context)
 {
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if (item)
+    cJSON scratch;
+
+    if ((char_at(context, input) == '[') || (char_at(context, input) == '{'))
     {
-        item->type = cJSON_Object;
+        return skip_nested(input, context);
+    }
+    if (char_at(context, input) == '\"')
+    {
+        return skip_string(input, context);
     }
 
-    return item;
+    /* numbers and literals don't allocate anything */
+    memset(&scratch, '\0', sizeof(scratch));
+    return parse_value(&scratch, input, context);
 }
 
-/* Create Arrays: */
-CJSON_PUBLIC(cJSON *) cJSON_CreateIntArray(const int *numbers, int count)
+/* Store the value at input in the member of field, which isn't a nested struct. */
+static const unsigned char *parse_struct_value(const schema_field * const field, unsigned char * const member, const unsigned char * const input, parse_context * const context)
+{
+    cJSON scratch;
+    const unsigned char *end = NULL;
+    const unsigned char *text = NULL;
+    size_t length = 0;
+    char *copy = NULL;
+
+    memset(&scratch, '\0', sizeof(scratch));
+    switch (field->field->type)
+    {
+        case cJSON_FieldBool:
+            end = parse_value(&scratch, input, context);
+            if ((end == NULL) || ((scratch.type != cJSON_True) && (scratch.type != cJSON_False)))
+            {
+                return parse_error(context, input, cJSON_Error_InvalidValue);
+            }
+            *(cJSON_bool*)(void*)member = (scratch.type == cJSON_True);
+            return end;
+
+        case cJSON_FieldInt:
+        case cJSON_FieldDouble:
+            if ((char_at(context, input) != '-') && ((char_at(context, input) < '0') || (char_at(context, input) > '9')))
+            {
+                return parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_InvalidValue);
+            }
+            end = parse_number(&scratch, input, context);
+            if (end == NULL)
+            {
+                return parse_error(context, input, cJSON_Error_InvalidNumber);
+            }
+            if (field->field->type == cJSON_FieldInt)
+            {
+                *(int*)(void*)member = scratch.valueint;
+            }
+            else
+            {
+                *(double*)(void*)member = scratch.valuedouble;
+            }
+            return end;
+
+        case cJSON_FieldString:
+        case cJSON_FieldChars:
+            if (char_at(context, input) != '\"')
+            {
+                return parse_error(context, input, (char_at(context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_InvalidValue);
+            }
+            end = parse_struct_string(&scratch, input, context, &text, &length);
+            if (end == NULL)
+            {
+                return NULL;
+            }
+            if (field->field->type == cJSON_FieldChars)
+            {
+                if (length >= field->field->size)
+                {
+                    end = parse_error(context, input, cJSON_Error_InvalidValue);
+                }
+                else
+                {
+                    memcpy(member, text, length);
+                    member[length] = '\0';
+                }
+            }
+            else if (scratch.valuestring != NULL)
+            {
+                /* the unescaped string is used as it is */
+                copy = scratch.valuestring;
+                scratch.valuestring = NULL;
+            }
+            else
+            {
+                copy = (char*)global_hooks.allocate(length + 1);
+                if (copy == NULL)
+                {
+                    return parse_error(context, input, cJSON_Error_OutOfMemory);
+                }
+                memcpy(copy, text, length);
+                copy[length] = '\0';
+            }
+            if (copy != NULL)
+            {
+                /* a member that appears more than once replaces the string of the first one */
+                if (*(char**)(void*)member != NULL)
+                {
+                    global_hooks.deallocate(*(char**)(void*)member);
+                }
+                *(char**)(void*)member = copy;
+            }
+            if (scratch.valuestring != NULL)
+            {
+                global_hooks.deallocate(scratch.valuestring);
+            }
+            return end;
+
+        default:
+            return parse_error(context, input, cJSON_Error_InvalidValue);
+    }
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_ParseStruct(const cJSON_Schema *schema, const char *value, size_t buffer_length, void *target, cJSON_ParseError *error)
+{
+    parse_context context;
+    const unsigned char *input = (const unsigned char*)value;
+    unsigned char * const root = (unsigned char*)target;
+    const schema_field *field = NULL;
+    unsigned char character = '\0';
+
+    context.hooks = &global_hooks;
+    context.error_position = NULL;
+    context.error_code = cJSON_Error_None;
+    context.inline_item = NULL;
+    context.end = input + buffer_length;
+
+    if ((schema == NULL) || (value == NULL) || (target == NULL))
+    {
+        parse_error(&context, NULL, cJSON_Error_InvalidValue);
+        goto fail;
+    }
+
+    input = skip_whitespace(&context, input);
+    if (char_at(&context, input) != '{')
+    {
+        parse_error(&context, input, (char_at(&context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_InvalidValue);
+        goto fail;
+    }
+
+    /* input is at the '{' of an object of schema or behind a value of it */
+    for (;;)
+    {
+        character = char_at(&context, input);
+        if ((character == '{') || (character == ','))
+        {
+            input = skip_whitespace(&context, input + 1);
+            if ((character == '{') && (char_at(&context, input) == '}'))
+            {
+                /* empty object, it is closed below */
+                continue;
+            }
+
+            input = parse_struct_name(schema, input, &context, &field);
+            if (input == NULL)
+            {
+                goto fail;
+            }
+            if ((field == NULL) || (char_at(&context, input) == 'n'))
+            {
+                /* unknown members and null are skipped */
+                input = skip_struct_value(input, &context);
+            }
+            else if (field->nested != NULL)
+            {
+                if (char_at(&context, input) != '{')
+                {
+                    parse_error(&context, input, (char_at(&context, input) == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_InvalidValue);
+                    goto fail;
+                }
+                schema = field->nested;
+                continue;
+            }
+            else
+            {
+                input = parse_struct_value(field, root + schema->base + field->field->offset, input, &context);
+            }
+            if (input == NULL)
+            {
+                goto fail;
+            }
+            input = skip_whitespace(&context, input);
+            continue;
+        }
+
+        if (character != '}')
+        {
+            parse_error(&context, input, (character == '\0') ? cJSON_Error_UnexpectedEnd : cJSON_Error_ExpectedObjectEnd);
+            goto fail;
+        }
+        input = skip_whitespace(&context, input + 1);
+        if (schema->parent == NULL)
+        {
+            break;
+        }
+        schema = schema->parent;
+    }
+
+    if (char_at(&context, input) != '\0')
+    {
+        parse_error(&context, input, cJSON_Error_TrailingCharacters);
+        goto fail;
+    }
+
+    if (error != NULL)
+    {
+        memset(error, '\0', sizeof(cJSON_ParseError));
+    }
+
+    return true;
+
+fail:
+    if (error != NULL)
+    {
+        fill_parse_error(error, (const unsigned char*)value, &context);
+    }
+
+    return false;
+}
+
+/* Print the member of field, which isn't a nested struct. */
+static cJSON_bool print_struct_value(const schema_field * const field, const unsigned char * const member, printbuffer * const output_buffer)
+{
+    const char *literal = NULL;
+    const char *string = NULL;
+    unsigned char *output = NULL;
+    size_t length = 0;
+
+    switch (field->field->type)
+    {
+        case cJSON_FieldBool:
+            literal = *(const cJSON_bool*)(const void*)member ? "true" : "false";
+            break;
+
+        case cJSON_FieldInt:
+            return print_double((double)*(const int*)(const void*)member, output_buffer, &global_hooks);
+
+        case cJSON_FieldDouble:
+            return print_double(*(const double*)(const void*)member, output_buffer, &global_hooks);
+
+        case cJSON_FieldString:
+            string = *(char* const*)(const void*)member;
+            if (string == NULL)
+            {
+                literal = "null";
+                break;
+            }
+            return print_string_ptr((const unsigned char*)string, output_buffer, &global_hooks);
+
+        case cJSON_FieldChars:
+            if (memchr(member, '\0', field->field->size) == NULL)
+            {
+                return false; /* not terminated */
+            }
+            return print_string_ptr(member, output_buffer, &global_hooks);
+
+        default:
+            return false;
+    }
+
+    length = strlen(literal);
+    output = ensure(output_buffer, length + 1, &global_hooks);
+    if (output == NULL)
+    {
+        return false;
+    }
+    memcpy(output, literal, length + 1);
+    output_buffer->offset += length;
+
+    return true;
+}
+
+CJSON_PUBLIC(char *) cJSON_PrintStruct(const cJSON_Schema *schema, const void *source)
 {
+    printbuffer buffer[1];
+    const unsigned char * const root = (const unsigned char*)source;
+    const schema_field *field = NULL;
+    unsigned char *output = NULL;
     size_t i = 0;
-    cJSON *n = NULL;
-    cJSON *p = NULL;
-    cJSON *a = NULL;
 
-    if (count < 0)
+    if ((schema == NULL) || (source == NULL))
     {
         return NULL;
     }
 
-    a = cJSON_CreateArray();
-    for(i = 0; a && (i < (size_t)count); i++)
+    memset(buffer, 0, sizeof(buffer));
+    buffer->buffer = (unsigned char*)global_hooks.allocate(256);
+    if (buffer->buffer == NULL)
     {
-        n = cJSON_CreateNumber(numbers[i]);
-        if (!n)
+        return NULL;
+    }
+    buffer->length = 256;
+    buffer->buffer[buffer->offset++] = '{';
+
+    /* like parsing, nested structs go back to their parent without a stack */
+    for (;;)
+    {
+        if (i < schema->count)
+        {
+            field = &schema->fields[i];
+            /* room for the comma, the key and the '{' of a nested struct */
+            output = ensure(buffer, field->key_length + 2, &global_hooks);
+            if (output == NULL)
+            {
+                goto fail;
+            }
+            if (i > 0)
+            {
+                *output++ = ',';
+            }
+            memcpy(output, field->key, field->key_length);
+            output += field->key_length;
+            buffer->offset = (size_t)(output - buffer->buffer);
+
+            if (field->nested != NULL)
+            {
+                buffer->buffer[buffer->offset++] = '{';
+                schema = field->nested;
+                i = 0;
+                continue;
+            }
+            if (!print_struct_value(field, root + schema->base + field->field->offset, buffer))
+            {
+                goto fail;
+            }
+            update_offset(buffer);
+            i++;
+            continue;
+        }
+
+        output = ensure(buffer, 2, &global_hooks);
+        if (output == NULL)
+        {
+            goto fail;
+        }
+        *output = '}';
+        buffer->offset++;
+        if (schema->parent == NULL)
+        {
+            break;
+        }
+        i = schema->index + 1;
+        schema = schema->parent;
+    }
+    buffer->buffer[buffer->offset] = '\0';
+
+    return (char*)buffer->buffer;
+
+fail:
+    if (buffer->buffer != NULL)
+    {
+        global_hooks.deallocate(buffer->buffer);
+    }
+
+    return NULL;
+}
+
+#define is_minify_whitespace(character) (((character) == ' ') || ((character) == '\t') || ((character) == '\r') || ((character) == '\n'))
+
+#ifdef CJSON_SSE2
+/* Returns the position of the lowest set bit of mask, which must not be 0. */
+static size_t lowest_bit(unsigned int mask)
+{
+#ifdef __GNUC__
+    return (size_t)__builtin_ctz(mask);
+#else
+    size_t position = 0;
+    while ((mask & 1) == 0)
+    {
+        mask >>= 1;
+        position++;
+    }
+
+    return position;
+#endif
+}
+#endif
+
+/* Copy [input, end) to *output without whitespace until the first '\"' or '/', which is returned (or end). */
+static const unsigned char *minify_plain(unsigned char ** const output, const unsigned char *input, const unsigned char * const end)
+{
+    unsigned char *into = *output;
+
+#ifdef CJSON_SSE2
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i carriage_return = _mm_set1_epi8('\r');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i slash = _mm_set1_epi8('/');
+
+    while ((size_t)(end - input) >= sizeof(__m128i))
+    {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*)(const void*)input);
+        const unsigned int whitespace = (unsigned int)_mm_movemask_epi8(_mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, carriage_return), _mm_cmpeq_epi8(chunk, newline))));
+        const unsigned int special = (unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, slash)));
+        size_t length = (special != 0) ? lowest_bit(special) : sizeof(__m128i);
+        size_t position = 0;
+
+        if ((whitespace == 0) && (length == sizeof(__m128i)))
+        {
+            /* the whole block is kept, it is read already so it may overlap what is written */
+            _mm_storeu_si128((__m128i*)(void*)into, chunk);
+            into += sizeof(__m128i);
+        }
+        else if (whitespace == 0xFFFF)
+        {
+            /* indentation */
+        }
+        else
+        {
+            /* compact the block up to the special character, with a store for every byte but without branches */
+            unsigned char block[sizeof(__m128i)];
+            _mm_storeu_si128((__m128i*)(void*)block, chunk);
+            for (position = 0; position < length; position++)
+            {
+                *into = block[position];
+                into += ((whitespace >> position) & 1) ^ 1;
+            }
+        }
+        input += length;
+
+        if (length != sizeof(__m128i))
+        {
+            *output = into;
+            return input;
+        }
+    }
+#endif
+
+    while ((input < end) && (*input != '\"') && (*input != '/'))
+    {
+        if (!is_minify_whitespace(*input))
+        {
+            *into++ = *input;
+        }
+        input++;
+    }
+
+    *output = into;
+    return input;
+}
+
+/* Copy the rest of a string literal from input to *output, including the closing '\"'. Returns what follows it. */
+static const unsigned char *minify_string(unsigned char ** const output, const unsigned char *input, const unsigned char * const end)
+{
+    unsigned char *into = *output;
+
+    while (input < end)
+    {
+#ifdef CJSON_SSE2
+        const __m128i quote = _mm_set1_epi8('\"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+
+        while ((size_t)(end - input) >= sizeof(__m128i))
+        {
+            const __m128i chunk = _mm_loadu_si128((const __m128i*)(const void*)input);
+            if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash))) != 0)
+            {
+                /* the loop below finds the exact position */
+                break;
+            }
+            /* all of it is read already, so the store may overlap it */
+            _mm_storeu_si128((__m128i*)(void*)into, chunk);
+            into += sizeof(__m128i);
+            input += sizeof(__m128i);
+        }
+#endif
+        while ((input < end) && (*input != '\"') && (*input != '\\'))
+        {
+            *into++ = *input++;
+        }
+        if (input == end)
+        {
+            break;
+        }
+
+        if (*input == '\"')
+        {
+            *into++ = *input++;
+            break;
+        }
+        /* a backslash and the escaped character */
+        *into++ = *input++;
+        if (input < end)
+        {
+            *into++ = *input++;
+        }
+    }
+
+    *output = into;
+    return input;
+}
+
+CJSON_PUBLIC(void) cJSON_Minify(char *json)
+{
+    unsigned char *into = (unsigned char*)json;
+    const unsigned char *input = (const unsigned char*)json;
+    const unsigned char *end = NULL;
+
+    if (json == NULL)
+    {
+        return;
+    }
+
+    /* with a known end, the input can be read in blocks */
+    end = input + strlen(json);
+    while (input < end)
+    {
+        input = minify_plain(&into, input, end);
+        if (input == end)
+        {
+            break;
+        }
+
+        if ((*input == '/') && (input[1] == '/'))
+        {
+            /* double-slash comments, to end of line. */
+            input = (const unsigned char*)memchr(input, '\n', (size_t)(end - input));
+            if (input == NULL)
+            {
+                input = end;
+            }
+        }
+        else if ((*input == '/') && (input[1] == '*'))
         {
-            cJSON_Delete(a);
-            return NULL;
+            /* multiline comments. */
+            for (input += 2; (input < end) && !((*input == '*') && (input[1] == '/')); input++)
+            {
+            }
+            input = (input < end) ? (input + 2) : end;
         }
-        if(!i)
+        else if (*input == '\"')
         {
-            a->child = n;
+            /* string literals, which are \" sensitive. */
+            *into++ = *input++;
+            input = minify_string(&into, input, end);
         }
         else
         {
-            suffix_object(p, n);
+            /* a '/' that doesn't start a comment */
+            *into++ = *input++;
         }
-        p = n;
     }
 
-    return a;
+    /* and null-terminate. */
+    *into = '\0';
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateFloatArray(const float *numbers, int count)
+/* Streaming minifier */
+typedef enum
 {
-    size_t i = 0;
-    cJSON *n = NULL;
-    cJSON *p = NULL;
-    cJSON *a = NULL;
+    minify_plain_state,
+    minify_string_state,
+    minify_escape_state,
+    /* a '/' that may start a comment */
+    minify_slash_state,
+    minify_line_comment_state,
+    minify_block_comment_state,
+    /* a '*' inside a block comment that may end it */
+    minify_block_comment_star_state
+} minify_state;
+
+#define MINIFIER_BUFFER_SIZE 4096
+
+struct cJSON_Minifier
+{
+    cJSON_WriteFunction writer;
+    void *context;
+    minify_state state;
+    /* the writer failed, everything else is ignored */
+    cJSON_bool failed;
+    size_t used;
+    /* set by cJSON_CreateFormatter, which writes the layout of cJSON_Print instead */
+    cJSON_bool format;
+    /* the next token starts a new line of an object */
+    cJSON_bool indent_pending;
+    size_t depth;
+    /* a set bit for every open object, a clear one for every open array */
+    unsigned char objects[(CJSON_NESTING_LIMIT + 7) / 8];
+    unsigned char buffer[MINIFIER_BUFFER_SIZE];
+};
+
+CJSON_PUBLIC(cJSON_Minifier *) cJSON_CreateMinifier(cJSON_WriteFunction writer, void *context)
+{
+    cJSON_Minifier *minifier = NULL;
 
-    if (count < 0)
+    if (writer == NULL)
     {
         return NULL;
     }
 
-    a = cJSON_CreateArray();
-
-    for(i = 0; a && (i < (size_t)count); i++)
+    minifier = (cJSON_Minifier*)global_hooks.allocate(sizeof(cJSON_Minifier));
+    if (minifier == NULL)
     {
-        n = cJSON_CreateNumber((double)numbers[i]);
-        if(!n)
-        {
-            cJSON_Delete(a);
-            return NULL;
-        }
-        if(!i)
-        {
-            a->child = n;
-        }
-        else
-        {
-            suffix_object(p, n);
-        }
-        p = n;
+        return NULL;
     }
+    memset(minifier, '\0', sizeof(cJSON_Minifier));
 
-    return a;
+    minifier->writer = writer;
+    minifier->context = context;
+    minifier->state = minify_plain_state;
+
+    return minifier;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateDoubleArray(const double *numbers, int count)
+CJSON_PUBLIC(cJSON_Minifier *) cJSON_CreateFormatter(cJSON_WriteFunction writer, void *context)
 {
-    size_t i = 0;
-    cJSON *n = NULL;
-    cJSON *p = NULL;
-    cJSON *a = NULL;
+    cJSON_Minifier *formatter = cJSON_CreateMinifier(writer, context);
 
-    if (count < 0)
+    if (formatter != NULL)
     {
-        return NULL;
+        formatter->format = true;
     }
 
-    a = cJSON_CreateArray();
+    return formatter;
+}
 
-    for(i = 0;a && (i < (size_t)count); i++)
+static cJSON_bool minifier_flush(cJSON_Minifier * const minifier)
+{
+    if (!minifier->failed && (minifier->used > 0))
     {
-        n = cJSON_CreateNumber(numbers[i]);
-        if(!n)
-        {
-            cJSON_Delete(a);
-            return NULL;
-        }
-        if(!i)
-        {
-            a->child = n;
-        }
-        else
-        {
-            suffix_object(p, n);
-        }
-        p = n;
+        minifier->failed = !minifier->writer((const char*)minifier->buffer, minifier->used, minifier->context);
     }
+    minifier->used = 0;
 
-    return a;
+    return !minifier->failed;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateStringArray(const char **strings, int count)
+static void format_put(cJSON_Minifier * const formatter, const unsigned char character)
 {
-    size_t i = 0;
-    cJSON *n = NULL;
-    cJSON *p = NULL;
-    cJSON *a = NULL;
-
-    if (count < 0)
+    if (formatter->used == MINIFIER_BUFFER_SIZE)
     {
-        return NULL;
+        minifier_flush(formatter);
     }
+    formatter->buffer[formatter->used++] = character;
+}
 
-    a = cJSON_CreateArray();
+static void format_indent(cJSON_Minifier * const formatter, size_t count)
+{
+    for (; count > 0; count--)
+    {
+        format_put(formatter, '\t');
+    }
+}
 
-    for (i = 0; a && (i < (size_t)count); i++)
+/* Start a token, on a new line if it is the next member of an object. */
+static void format_token(cJSON_Minifier * const formatter)
+{
+    if (formatter->indent_pending)
     {
-        n = cJSON_CreateString(strings[i]);
-        if(!n)
-        {
-            cJSON_Delete(a);
-            return NULL;
-        }
-        if(!i)
-        {
-            a->child = n;
-        }
-        else
-        {
-            suffix_object(p,n);
-        }
-        p = n;
+        format_indent(formatter, formatter->depth);
+        formatter->indent_pending = false;
     }
+}
 
-    return a;
+static cJSON_bool format_in_object(const cJSON_Minifier * const formatter)
+{
+    const size_t open = formatter->depth - 1;
+
+    return (formatter->depth > 0) && ((formatter->objects[open / 8] & (1 << (open % 8))) != 0);
 }
 
-/* Duplication */
-CJSON_PUBLIC(cJSON *) cJSON_Duplicate(const cJSON *item, cJSON_bool recurse)
+/* Reformat [input, end) up to a string or a '/', like print_object and print_array lay it out. Afterwards the buffer
+ * has room for the rest of the input and one more byte, like minify_chunk expects. */
+static const unsigned char *format_plain(cJSON_Minifier * const formatter, const unsigned char *input, const unsigned char * const end)
 {
-    cJSON *newitem = NULL;
-    cJSON *child = NULL;
-    cJSON *next = NULL;
-    cJSON *newchild = NULL;
+    size_t open = 0;
 
-    /* Bail on bad ptr */
-    if (!item)
+    for (; (input < end) && (*input != '\"') && (*input != '/'); input++)
     {
-        goto fail;
+        switch (*input)
+        {
+            case ' ':
+            case '\t':
+            case '\r':
+            case '\n':
+                break;
+
+            case '{':
+            case '[':
+                format_token(formatter);
+                if (formatter->depth == CJSON_NESTING_LIMIT)
+                {
+                    /* the nesting can't be tracked anymore */
+                    formatter->failed = true;
+                    return end;
+                }
+                open = formatter->depth++;
+                if (*input == '{')
+                {
+                    formatter->objects[open / 8] = (unsigned char)(formatter->objects[open / 8] | (1 << (open % 8)));
+                    format_put(formatter, '{');
+                    format_put(formatter, '\n');
+                    formatter->indent_pending = true;
+                }
+                else
+                {
+                    formatter->objects[open / 8] = (unsigned char)(formatter->objects[open / 8] & ~(1 << (open % 8)));
+                    format_put(formatter, '[');
+                }
+                break;
+
+            case '}':
+                if (formatter->depth > 0)
+                {
+                    if (!formatter->indent_pending)
+                    {
+                        format_put(formatter, '\n');
+                    }
+                    formatter->indent_pending = false;
+                    format_indent(formatter, --formatter->depth);
+                }
+                format_put(formatter, '}');
+                break;
+
+            case ']':
+                format_token(formatter);
+                if (formatter->depth > 0)
+                {
+                    formatter->depth--;
+                }
+                format_put(formatter, ']');
+                break;
+
+            case ',':
+                format_put(formatter, ',');
+                if (format_in_object(formatter))
+                {
+                    format_put(formatter, '\n');
+                    formatter->indent_pending = true;
+                }
+                else
+                {
+                    format_put(formatter, ' ');
+                }
+                break;
+
+            case ':':
+                format_put(formatter, ':');
+                format_put(formatter, '\t');
+                break;
+
+            default:
+                format_token(formatter);
+                format_put(formatter, *input);
+                break;
+        }
     }
-    /* Create new item */
-    newitem = cJSON_New_Item(&global_hooks);
-    if (!newitem)
+
+    if ((input < end) && (*input == '\"'))
     {
-        goto fail;
+        /* minify_chunk copies the string */
+        format_token(formatter);
     }
-    /* Copy over all vars */
-    newitem->type = item->type & (~cJSON_IsReference);
-    newitem->valueint = item->valueint;
-    newitem->valuedouble = item->valuedouble;
-    if (item->valuestring)
+    if ((MINIFIER_BUFFER_SIZE - formatter->used) <= (size_t)(end - input))
     {
-        newitem->valuestring = (char*)cJSON_strdup((unsigned char*)item->valuestring, &global_hooks);
-        if (!newitem->valuestring)
-        {
-            goto fail;
-        }
+        minifier_flush(formatter);
     }
-    if (item->string)
+
+    return input;
+}
+
+/* Minify [input, end) into the buffer, which has room for all of it. Returns the state at the end. */
+static minify_state minify_chunk(cJSON_Minifier * const minifier, const unsigned char *input, const unsigned char * const end)
+{
+    unsigned char *into = minifier->buffer + minifier->used;
+    const unsigned char *run_end = NULL;
+    minify_state state = minifier->state;
+
+    while (input < end)
     {
-        newitem->string = (item->type&cJSON_StringIsConst) ? item->string : (char*)cJSON_strdup((unsigned char*)item->string, &global_hooks);
-        if (!newitem->string)
+        switch (state)
         {
-            goto fail;
+            case minify_plain_state:
+                if (minifier->format)
+                {
+                    minifier->used = (size_t)(into - minifier->buffer);
+                    input = format_plain(minifier, input, end);
+                    into = minifier->buffer + minifier->used;
+                }
+                else
+                {
+                    input = minify_plain(&into, input, end);
+                }
+                if (input == end)
+                {
+                    break;
+                }
+                if (*input == '\"')
+                {
+                    *into++ = *input;
+                    state = minify_string_state;
+                }
+                else
+                {
+                    state = minify_slash_state;
+                }
+                input++;
+                break;
+
+            case minify_string_state:
+                run_end = find_string_special(input, end);
+                memcpy(into, input, (size_t)(run_end - input));
+                into += run_end - input;
+                input = run_end;
+                if (input == end)
+                {
+                    break;
+                }
+                if (*input == '\"')
+                {
+                    state = minify_plain_state;
+                }
+                else if (*input == '\\')
+                {
+                    state = minify_escape_state;
+                }
+                /* '\0' is kept as it is */
+                *into++ = *input++;
+                break;
+
+            case minify_escape_state:
+                *into++ = *input++;
+                state = minify_string_state;
+                break;
+
+            case minify_slash_state:
+                if (*input == '/')
+                {
+                    state = minify_line_comment_state;
+                    input++;
+                }
+                else if (*input == '*')
+                {
+                    state = minify_block_comment_state;
+                    input++;
+                }
+                else
+                {
+                    /* a '/' that doesn't start a comment */
+                    *into++ = '/';
+                    state = minify_plain_state;
+                }
+                break;
+
+            case minify_line_comment_state:
+                run_end = (const unsigned char*)memchr(input, '\n', (size_t)(end - input));
+                if (run_end == NULL)
+                {
+                    input = end;
+                }
+                else
+                {
+                    input = run_end;
+                    state = minify_plain_state;
+                }
+                break;
+
+            case minify_block_comment_state:
+                run_end = (const unsigned char*)memchr(input, '*', (size_t)(end - input));
+                if (run_end == NULL)
+                {
+                    input = end;
+                }
+                else
+                {
+                    input = run_end + 1;
+                    state = minify_block_comment_star_state;
+                }
+                break;
+
+            case minify_block_comment_star_state:
+                if (*input == '/')
+                {
+                    state = minify_plain_state;
+                }
+                else if (*input != '*')
+                {
+                    state = minify_block_comment_state;
+                }
+                input++;
+                break;
+
+            default:
+                input = end;
+                break;
         }
     }
-    /* If non-recursive, then we're done! */
-    if (!recurse)
+
+    minifier->used = (size_t)(into - minifier->buffer);
+
+    return state;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_MinifierFeed(cJSON_Minifier *minifier, const char *data, size_t length)
+{
+    const unsigned char *input = (const unsigned char*)data;
+    size_t piece = 0;
+
+    if ((minifier == NULL) || ((data == NULL) && (length > 0)))
     {
-        return newitem;
+        return false;
     }
-    /* Walk the ->next chain for the child. */
-    child = item->child;
-    while (child != NULL)
+
+    while ((length > 0) && !minifier->failed)
     {
-        newchild = cJSON_Duplicate(child, true); /* Duplicate (with recurse) each item in the ->next chain */
-        if (!newchild)
+        /* the output of a piece is never longer than the piece (a pending '/' is at most one more byte) */
+        if ((MINIFIER_BUFFER_SIZE - minifier->used) < 2)
         {
-            goto fail;
-        }
-        if (next != NULL)
-        {
-            /* If newitem->child already set, then crosswire ->prev and ->next and move on */
-            next->next = newchild;
-            newchild->prev = next;
-            next = newchild;
+            minifier_flush(minifier);
+            continue;
         }
-        else
+        piece = MINIFIER_BUFFER_SIZE - minifier->used - 1;
+        if (piece > length)
         {
-            /* Set newitem->child and move to it */
-            newitem->child = newchild;
-            next = newchild;
+            piece = length;
         }
-        child = child->next;
+        minifier->state = minify_chunk(minifier, input, input + piece);
+        input += piece;
+        length -= piece;
     }
 
-    return newitem;
+    return !minifier->failed;
+}
 
-fail:
-    if (newitem != NULL)
+CJSON_PUBLIC(cJSON_bool) cJSON_MinifierFinish(cJSON_Minifier *minifier)
+{
+    if (minifier == NULL)
     {
-        cJSON_Delete(newitem);
+        return false;
     }
 
-    return NULL;
-}
-
-CJSON_PUBLIC(void) cJSON_Minify(char *json)
-{
-    unsigned char *into = (unsigned char*)json;
-    while (*json)
+    if ((minifier->state == minify_slash_state) && !minifier->failed)
     {
-        if (*json == ' ')
-        {
-            json++;
-        }
-        else if (*json == '\t')
-        {
-            /* Whitespace characters. */
-            json++;
-        }
-        else if (*json == '\r')
-        {
-            json++;
-        }
-        else if (*json=='\n')
-        {
-            json++;
-        }
-        else if ((*json == '/') && (json[1] == '/'))
-        {
-            /* double-slash comments, to end of line. */
-            while (*json && (*json != '\n'))
-            {
-                json++;
-            }
-        }
-        else if ((*json == '/') && (json[1] == '*'))
-        {
-            /* multiline comments. */
-            while (*json && !((*json == '*') && (json[1] == '/')))
-            {
-                json++;
-            }
-            json += 2;
-        }
-        else if (*json == '\"')
-        {
-            /* string literals, which are \" sensitive. */
-            *into++ = (unsigned char)*json++;
-            while (*json && (*json != '\"'))
-            {
-                if (*json == '\\')
-                {
-                    *into++ = (unsigned char)*json++;
-                }
-                *into++ = (unsigned char)*json++;
-            }
-            *into++ = (unsigned char)*json++;
-        }
-        else
+        /* the input ended with a '/' */
+        if (minifier->used == MINIFIER_BUFFER_SIZE)
         {
-            /* All other characters. */
-            *into++ = (unsigned char)*json++;
+            minifier_flush(minifier);
         }
+        minifier->buffer[minifier->used++] = '/';
     }
+    minifier->state = minify_plain_state;
+    minifier->indent_pending = false;
+    minifier->depth = 0;
 
-    /* and null-terminate. */
-    *into = '\0';
+    return minifier_flush(minifier);
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteMinifier(cJSON_Minifier *minifier)
+{
+    if (minifier != NULL)
+    {
+        global_hooks.deallocate(minifier);
+    }
 }
 
 CJSON_PUBLIC(cJSON_bool) cJSON_IsInvalid(const cJSON * const item)
@@ -29,11 +29,12 @@ extern "C"
 #endif
 
 /* project version */
-#define CJSON_VERSION_MAJOR 1
-#define CJSON_VERSION_MINOR 4
+#define CJSON_VERSION_MAJOR 2
+#define CJSON_VERSION_MINOR 0
 #define CJSON_VERSION_PATCH 0
 
 #include <stddef.h>
+#include <stdio.h>
 
 /* cJSON Types: */
 #define cJSON_Invalid (0)
@@ -48,11 +49,22 @@ extern "C"
 
 #define cJSON_IsReference 256
 #define cJSON_StringIsConst 512
+#define cJSON_IsLazy 1024 /* the children of an array or object are not parsed yet (see cJSON_ParseLazy), or a number or
+                           * string is not converted yet (see cJSON_ParseWithNumberText and cJSON_ParseWithStringText) */
+#define cJSON_IsPacked 8192 /* the elements of an array are numbers kept in one buffer, see cJSON_CreatePackedArray */
+/* the item was printed by cJSON_PrintWithCache, cleared when it or one of its elements is changed through cJSON's functions */
+#define cJSON_IsRendered 16384
+#define cJSON_IsFrozen 32768 /* the item is read only, see cJSON_Freeze */
+#define cJSON_IsBinary 65536 /* a string whose valuestring holds the bytes its base64 text stands for, see cJSON_CreateBinary */
+/* the item was hashed by cJSON_HashWithCache, cleared when it or one of its elements is changed through cJSON's functions */
+#define cJSON_IsHashed 131072
+#define cJSON_IsIndexed 262144 /* an array or object whose valuestring holds its index, see cJSON_BuildIndex */
 
 /* The cJSON structure: */
 typedef struct cJSON
 {
-    /* next/prev allow you to walk array/object chains. Alternatively, use GetArraySize/GetArrayItem/GetObjectItem */
+    /* next/prev allow you to walk array/object chains. Alternatively, use GetArraySize/GetArrayItem/GetObjectItem.
+     * The prev of the first child points to the last one, so appending doesn't have to walk the chain. */
     struct cJSON *next;
     struct cJSON *prev;
     /* An array or object item will have a child pointer pointing to a chain of the items in the array/object. */
@@ -70,6 +82,16 @@ typedef struct cJSON
 
     /* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
     char *string;
+
+    /* The lengths of valuestring and string without the '\0' as cJSON stored them, and the strings they were stored
+     * for. A length is only used while its string is still that one, so assigning another valuestring or string is safe.
+     * A string of another length at the same address isn't noticed: set the length to 0 when writing into the old
+     * memory, or when the new string is allocated after the old one was freed, or use cJSON_SetValuestring. These
+     * fields come after the ones above, which keep their offsets, but they make the struct larger than in 1.x. */
+    const char *stored_valuestring;
+    const char *stored_string;
+    unsigned int valuestring_length;
+    unsigned int string_length;
 } cJSON;
 
 typedef struct cJSON_Hooks
@@ -80,6 +102,24 @@ typedef struct cJSON_Hooks
 
 typedef int cJSON_bool;
 
+/* Filled by cJSON_ParseWithStats and cJSON_PrintWithStats. Only seconds is measured unless cJSON is compiled with
+ * CJSON_ENABLE_STATS, the counters stay 0 otherwise. Allocations from an arena are not counted. */
+typedef struct cJSON_Stats
+{
+    size_t allocations;
+    size_t allocated_bytes;
+    /* the largest buffer that was used for printing */
+    size_t peak_buffer_size;
+    /* items that were created (parsing) or rendered (printing) */
+    size_t nodes;
+    size_t max_depth;
+    /* processor time as measured by clock() */
+    double seconds;
+} cJSON_Stats;
+
+/* Receives length bytes of printed JSON (not null terminated), returns 0 to abort printing. */
+typedef cJSON_bool (*cJSON_WriteFunction)(const char *data, size_t length, void *context);
+
 #if !defined(__WINDOWS__) && (defined(WIN32) || defined(WIN64) || defined(_MSC_VER) || defined(_WIN32))
 #define __WINDOWS__
 #endif
@@ -117,11 +157,47 @@ then using the CJSON_API_VISIBILITY flag to "export" the same symbols the way CJ
 #endif
 #endif
 
+/* Limits how deeply nested arrays/objects can be before cJSON rejects to parse them.
+ * Parsing and printing use an explicit stack on the heap, so this doesn't affect the C stack. */
+#ifndef CJSON_NESTING_LIMIT
+#define CJSON_NESTING_LIMIT 1000
+#endif
+
+/* If cJSON is compiled with CJSON_NODE_CACHE, every thread keeps up to this many deleted items for reuse instead of
+ * freeing them. They are kept for the allocator they came from, an item from another one empties the cache. */
+#ifndef CJSON_NODE_CACHE_SIZE
+#define CJSON_NODE_CACHE_SIZE 1024
+#endif
+
+/* If cJSON is compiled with CJSON_INLINE_STRINGS, every item has room for a name and a string of up to this many bytes
+ * (with the '\0'), which are stored there instead of being allocated. */
+#ifndef CJSON_INLINE_STRING_SIZE
+#define CJSON_INLINE_STRING_SIZE 16
+#endif
+
+/* If cJSON is compiled with CJSON_INTEGER_ONLY (for targets without an FPU or libm), numbers are converted without strtod,
+ * sprintf, sscanf and libm. They are still doubles. Numbers outside of the exact fast path are parsed with 64 bit integer
+ * arithmetic, which can be off by one bit very close to halfway between two doubles, and in rare cases they are printed
+ * with more digits than the shortest ones that parse back to the same double. */
+
+/* If cJSON is compiled with CJSON_ENABLE_USDT, it has static probes of the provider cjson (needs <sys/sdt.h>):
+ * parse_start(input, length), parse_end(item, error code), error(code, position), allocate(size, arena),
+ * node(item or NULL, 1 if it came from the node cache), buffer_grow(old size, new size), print_start(item, format) and
+ * print_end(item, printed length or 0). Defining CJSON_TRACE(probe, first, second) when compiling cJSON.c calls a
+ * macro of your own at the same places instead. Without either the probes cost nothing. */
+
 /* returns the version of cJSON as a string */
 CJSON_PUBLIC(const char*) cJSON_Version(void);
 
 /* Supply malloc, realloc and free functions to cJSON */
 CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks* hooks);
+/* Free the cached items of the calling thread until at most keep are left (see CJSON_NODE_CACHE, without it there are
+ * none). Call cJSON_TrimNodeCache(0) before a thread exits or before an allocator the thread used goes away, the cache
+ * isn't freed on its own. cJSON_InitHooks empties the cache of its thread. */
+CJSON_PUBLIC(void) cJSON_TrimNodeCache(size_t keep);
+/* cJSON_InitHooks with a realloc_fn that matches malloc_fn and free_fn, so growing print buffers can happen in place
+ * instead of being copied. cJSON_Hooks itself stays unchanged for binary compatibility. realloc_fn may be NULL. */
+CJSON_PUBLIC(void) cJSON_InitHooksWithRealloc(cJSON_Hooks* hooks, void *(*realloc_fn)(void *ptr, size_t sz));
 
 
 /* Supply a block of JSON, and this returns a cJSON object you can interrogate. Call cJSON_Delete when finished. */
@@ -134,17 +210,150 @@ CJSON_PUBLIC(char *) cJSON_PrintUnformatted(const cJSON *item);
 CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON_bool fmt);
 /* Render a cJSON entity to text using a buffer already allocated in memory with length buf_len. Returns 1 on success and 0 on failure. */
 CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buf, const int len, const cJSON_bool fmt);
+/* cJSON_PrintBuffered and cJSON_PrintPreallocated with sizes beyond INT_MAX. */
+CJSON_PUBLIC(char *) cJSON_PrintBufferedWithSize(const cJSON *item, size_t prebuffer, cJSON_bool fmt);
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocatedWithSize(const cJSON *item, char *buf, size_t len, cJSON_bool fmt);
+/* Returns the exact length of the text that cJSON_PrintBuffered/cJSON_PrintPreallocated would produce for fmt, without the
+ * terminating '\0' (so a preallocated buffer needs one more byte). Returns 0 on failure. Nothing is allocated. */
+CJSON_PUBLIC(size_t) cJSON_PrintedLength(const cJSON *item, cJSON_bool fmt);
+/* A printer keeps its buffer between documents, so printing doesn't allocate once the buffer is large enough. When a
+ * document made the buffer grow beyond high_water_mark, it is freed before the next one (0 keeps it forever). */
+typedef struct cJSON_Printer cJSON_Printer;
+CJSON_PUBLIC(cJSON_Printer *) cJSON_CreatePrinter(size_t high_water_mark);
+CJSON_PUBLIC(void) cJSON_DeletePrinter(cJSON_Printer *printer);
+/* Returns the text, which belongs to the printer and stays valid until it prints again, is reset or deleted. Its length
+ * without the terminating '\0' is stored in *length if that isn't NULL. Returns NULL on failure. */
+CJSON_PUBLIC(const char *) cJSON_PrinterPrint(cJSON_Printer *printer, const cJSON *item, cJSON_bool fmt, size_t *length);
+/* Apply the high water mark now instead of before the next document. */
+CJSON_PUBLIC(void) cJSON_ResetPrinter(cJSON_Printer *printer);
+/* A piece of printed JSON (not null terminated). The members match those of struct iovec, so the chunks can be copied
+ * into an iovec array for writev or sendmsg. */
+typedef struct cJSON_Chunk
+{
+    void *base;
+    size_t length;
+} cJSON_Chunk;
+/* A pool of chunks of chunk_size bytes (0 for a default of 4096) that documents are printed into, so the output never has
+ * to be moved to a larger buffer. Only a single string or number that is larger than chunk_size gets a larger chunk. */
+typedef struct cJSON_ChunkList cJSON_ChunkList;
+CJSON_PUBLIC(cJSON_ChunkList *) cJSON_CreateChunkList(size_t chunk_size);
+CJSON_PUBLIC(void) cJSON_DeleteChunkList(cJSON_ChunkList *list);
+/* Returns the chunks of item and stores their number in *count if that isn't NULL. Returns NULL on failure. The chunks
+ * belong to the list and are reused by the next document. */
+CJSON_PUBLIC(const cJSON_Chunk *) cJSON_PrintChunks(cJSON_ChunkList *list, const cJSON *item, cJSON_bool fmt, size_t *count);
+/* Render a cJSON entity to text in pieces of a small fixed size buffer, which are handed to writer as it fills up. Only a
+ * single string or number that is larger than the buffer makes it grow. Returns 1 on success and 0 on failure (including
+ * writer returning 0), in which case part of the output may already have been written. */
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintToWriter(const cJSON *item, cJSON_bool fmt, cJSON_WriteFunction writer, void *context);
+/* cJSON_PrintToWriter with a writer that calls fwrite on file. */
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintToFile(const cJSON *item, cJSON_bool fmt, FILE *file);
+/* An NDJSON writer prints records unformatted into one buffer that is kept between them, each followed by a newline.
+ * Once the buffer holds flush_threshold bytes (0 for a default of 64 KiB), the records are handed to writer in one piece
+ * and the buffer is reused. Without a writer they stay in the buffer until cJSON_NDJSONWriterFlush is called. */
+typedef struct cJSON_NDJSONWriter cJSON_NDJSONWriter;
+CJSON_PUBLIC(cJSON_NDJSONWriter *) cJSON_CreateNDJSONWriter(size_t flush_threshold, cJSON_WriteFunction writer, void *context);
+/* Records that weren't flushed are dropped. */
+CJSON_PUBLIC(void) cJSON_DeleteNDJSONWriter(cJSON_NDJSONWriter *ndjson);
+/* Returns 0 if item couldn't be printed or writer failed, the records before it are kept then. */
+CJSON_PUBLIC(cJSON_bool) cJSON_NDJSONWriterAdd(cJSON_NDJSONWriter *ndjson, const cJSON *item);
+/* The records that weren't flushed yet and their length (in *length if that isn't NULL). */
+CJSON_PUBLIC(const char *) cJSON_NDJSONWriterText(const cJSON_NDJSONWriter *ndjson, size_t *length);
+/* Hand the records to writer (if there is one) and empty the buffer. Returns 0 if writer failed, the records are kept. */
+CJSON_PUBLIC(cJSON_bool) cJSON_NDJSONWriterFlush(cJSON_NDJSONWriter *ndjson);
+/* Render RFC 8785 canonical JSON for signing and hashing: unformatted, object members sorted by the UTF-16 code units of
+ * their keys and numbers printed like ECMAScript does. The tree isn't modified. Fails for NaN and Infinity. Raw items are
+ * printed as they are. */
+CJSON_PUBLIC(char *) cJSON_PrintCanonical(const cJSON *item);
+/* cJSON_PrintCanonical into a writer (see cJSON_PrintToWriter), e.g. to feed a hash without keeping the text. */
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintCanonicalToWriter(const cJSON *item, cJSON_WriteFunction writer, void *context);
+/* A print cache keeps the text of the arrays and objects of a tree, so printing the tree again only renders what was
+ * changed since: items that were added, inserted, replaced or detached, numbers set with cJSON_SetNumberValue and objects
+ * sorted by cJSONUtils. The tree is still walked once to find the changes. Changes to the fields of an item are not
+ * noticed and packed arrays are always printed again. A tree should only be printed with one cache. Not thread safe. */
+typedef struct cJSON_PrintCache cJSON_PrintCache;
+CJSON_PUBLIC(cJSON_PrintCache *) cJSON_CreatePrintCache(void);
+/* cJSON_Print (format != 0) or cJSON_PrintUnformatted, the items of item are marked with cJSON_IsRendered. The text of
+ * arrays and objects that weren't visited is dropped from the cache. */
+CJSON_PUBLIC(char *) cJSON_PrintWithCache(cJSON_PrintCache *cache, cJSON *item, cJSON_bool format);
+CJSON_PUBLIC(void) cJSON_DeletePrintCache(cJSON_PrintCache *cache);
 /* Delete a cJSON entity and all subentities. */
 CJSON_PUBLIC(void) cJSON_Delete(cJSON *c);
+/* A reclaimer takes over trees that are no longer used and frees them a few items at a time, so deleting a large tree
+ * doesn't stall the caller. It can be drained on another thread if it is locked, that thread should call
+ * cJSON_TrimNodeCache(0) before it exits. */
+typedef struct cJSON_Reclaimer cJSON_Reclaimer;
+CJSON_PUBLIC(cJSON_Reclaimer *) cJSON_CreateReclaimer(void);
+/* cJSON_Delete, but item is only handed to the reclaimer without touching its children. A NULL reclaimer deletes item
+ * right away. */
+CJSON_PUBLIC(void) cJSON_DeleteDeferred(cJSON_Reclaimer *reclaimer, cJSON *item);
+/* Free at most count items. Returns 1 if there are items left. */
+CJSON_PUBLIC(cJSON_bool) cJSON_Reclaim(cJSON_Reclaimer *reclaimer, size_t count);
+/* Free the items that are left and the reclaimer. */
+CJSON_PUBLIC(void) cJSON_DeleteReclaimer(cJSON_Reclaimer *reclaimer);
 
 /* Returns the number of items in an array (or object). */
 CJSON_PUBLIC(int) cJSON_GetArraySize(const cJSON *array);
 /* Retrieve item number "item" from array "array". Returns NULL if unsuccessful. */
 CJSON_PUBLIC(cJSON *) cJSON_GetArrayItem(const cJSON *array, int item);
+/* cJSON_GetArraySize and cJSON_GetArrayItem for arrays with more than INT_MAX items. */
+CJSON_PUBLIC(size_t) cJSON_GetArrayLength(const cJSON *array);
+CJSON_PUBLIC(cJSON *) cJSON_GetArrayItemAt(const cJSON *array, size_t index);
+/* Copy the numbers of an array into out, at most cap of them. Returns the size of the array (which may be more than cap)
+ * or -1 if it isn't an array or one of its elements isn't a number, out is partly filled then. */
+CJSON_PUBLIC(int) cJSON_GetNumberArray(const cJSON *array, double *out, size_t cap);
+/* The same for integers, a number that doesn't fit into an int exactly is a mismatch too. */
+CJSON_PUBLIC(int) cJSON_GetIntArray(const cJSON *array, int *out, size_t cap);
+/* Build an index for the items of an array or the members of an object, so cJSON_GetArraySize and cJSON_GetArrayItem
+ * (arrays) and looking up, detaching and replacing members by name (objects) don't have to search the list of children.
+ * The functions in this file keep the index up to date, call cJSON_BuildIndex again after changing the list of children
+ * or the names yourself. The index is allocated with the global hooks and released by cJSON_Delete or
+ * cJSON_DeleteIndex (for items in an arena, call cJSON_DeleteIndex before resetting or deleting the arena).
+ * Returns 1 on success and 0 on failure. */
+CJSON_PUBLIC(cJSON_bool) cJSON_BuildIndex(cJSON *item);
+/* Release the index built by cJSON_BuildIndex. */
+CJSON_PUBLIC(void) cJSON_DeleteIndex(cJSON *item);
+/* Make item and its children read only, so several threads can read them at the same time without locking: lazy and
+ * packed parts are loaded and large arrays and objects are indexed up front, then every item is marked with
+ * cJSON_IsFrozen. The lookup functions (cJSON_GetObjectItem*, cJSON_GetArrayItem, cJSON_GetArraySize,
+ * cJSONUtils_GetPointer) and the print functions except cJSON_PrintWithCache don't write to frozen items. The functions
+ * in this file refuse to add, detach, replace or change frozen items, cJSON_Duplicate returns a copy that isn't frozen and
+ * cJSON_Delete releases the tree as usual. Returns 1 on success and 0 on failure (item is partly frozen then). */
+CJSON_PUBLIC(cJSON_bool) cJSON_Freeze(cJSON *item);
+/* The number of bytes item and its children hold: the nodes, the strings and names they own (by their length, without
+ * the allocator's overhead), packed arrays and indexes. Memory that isn't owned (references, constant names, lazy text)
+ * isn't counted. It walks the tree, so it takes time linear in the number of items. For documents in an arena, see
+ * cJSON_GetArenaMemoryUsage. Returns 0 if item is NULL. */
+CJSON_PUBLIC(size_t) cJSON_MemoryUsage(const cJSON *item);
+/* A cursor walks item and all of its children depth first without recursion, so deep nesting can't overflow the stack,
+ * and prefetches the nodes that come next. cJSON_CursorNext returns one event per call: cJSON_CursorValue for items
+ * that aren't arrays or objects, cJSON_CursorEnter and cJSON_CursorLeave around the children of arrays and objects,
+ * cJSON_CursorDone at the end or cJSON_CursorInvalid if a lazy part is invalid JSON (or out of memory), which ends the
+ * walk as well. Lazy and packed parts are loaded on the way. Don't change the tree while walking it. */
+#define cJSON_CursorDone 0
+#define cJSON_CursorValue 1
+#define cJSON_CursorEnter 2
+#define cJSON_CursorLeave 3
+#define cJSON_CursorInvalid 4
+typedef struct cJSON_Cursor cJSON_Cursor;
+CJSON_PUBLIC(cJSON_Cursor *) cJSON_CreateCursor(const cJSON *item);
+CJSON_PUBLIC(int) cJSON_CursorNext(cJSON_Cursor *cursor);
+/* The item of the last event, its depth (0 for item itself) and its name if it is a member of an object. */
+CJSON_PUBLIC(const cJSON *) cJSON_CursorItem(const cJSON_Cursor *cursor);
+CJSON_PUBLIC(size_t) cJSON_CursorDepth(const cJSON_Cursor *cursor);
+CJSON_PUBLIC(const char *) cJSON_CursorKey(const cJSON_Cursor *cursor);
+/* After cJSON_CursorEnter, don't walk the children: the next event leaves the array or object. */
+CJSON_PUBLIC(void) cJSON_CursorSkip(cJSON_Cursor *cursor);
+CJSON_PUBLIC(void) cJSON_DeleteCursor(cJSON_Cursor *cursor);
 /* Get item "string" from object. Case insensitive. */
 CJSON_PUBLIC(cJSON *) cJSON_GetObjectItem(const cJSON *object, const char *string);
 CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemCaseSensitive(const cJSON *object, const char *string);
 CJSON_PUBLIC(cJSON_bool) cJSON_HasObjectItem(const cJSON *object, const char *string);
+/* The hash that the index of an object (see cJSON_BuildIndex) keeps a member under: djb2 of the name with tolower applied
+ * to every byte, starting at 5381 and folding each byte in with hash = (hash * 33) ^ byte. */
+CJSON_PUBLIC(size_t) cJSON_HashName(const char *name);
+/* cJSON_GetObjectItemCaseSensitive for the first length bytes of name (which must not contain a '\0'), whose
+ * cJSON_HashName is already known, e.g. because it was computed at compile time. Neither is computed again. */
+CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemWithHash(const cJSON *object, const char *name, size_t length, size_t hash);
 /* For analysing failed parses. This returns a pointer to the parse error. You'll probably need to look a few chars back to make sense of it. Defined when cJSON_Parse() returns 0. 0 when cJSON_Parse() succeeds. */
 CJSON_PUBLIC(const char *) cJSON_GetErrorPtr(void);
 
@@ -177,6 +386,34 @@ CJSON_PUBLIC(cJSON *) cJSON_CreateIntArray(const int *numbers, int count);
 CJSON_PUBLIC(cJSON *) cJSON_CreateFloatArray(const float *numbers, int count);
 CJSON_PUBLIC(cJSON *) cJSON_CreateDoubleArray(const double *numbers, int count);
 CJSON_PUBLIC(cJSON *) cJSON_CreateStringArray(const char **strings, int count);
+/* The value of an element for cJSON_CreateObjectFromArrays and cJSON_CreateArrayFromArrays, which member is used depends
+ * on its type. */
+typedef struct cJSON_Value
+{
+    /* cJSON_Number */
+    double number;
+    /* cJSON_String and cJSON_Raw, copied */
+    const char *string;
+} cJSON_Value;
+/* Create an object with count members named keys[i] (copied), or an array of count elements, of the type types[i]
+ * (cJSON_NULL, cJSON_False, cJSON_True, cJSON_Number, cJSON_String or cJSON_Raw) with the value values[i]. The list of
+ * children is linked in the same pass. Returns NULL if a type is invalid, a key or string is NULL or out of memory. */
+CJSON_PUBLIC(cJSON *) cJSON_CreateObjectFromArrays(const char * const *keys, const cJSON_Value *values, const int *types, size_t count);
+CJSON_PUBLIC(cJSON *) cJSON_CreateArrayFromArrays(const cJSON_Value *values, const int *types, size_t count);
+/* Create an array of count numbers that are kept in one buffer instead of a node each. It is printed, measured and
+ * counted without creating nodes, they are only created (and the buffer released) when the elements are needed by
+ * cJSON_GetArrayItem, cJSON_ArrayForEach, cJSON_LoadLazy, comparing or one of the functions that change it. */
+CJSON_PUBLIC(cJSON *) cJSON_CreatePackedArray(const double *numbers, int count);
+/* The cJSON_GetArraySize numbers of a packed array, they may be changed in place. NULL if array isn't packed. */
+CJSON_PUBLIC(double *) cJSON_GetPackedNumbers(cJSON *array);
+/* Create a string of the base64 (RFC 4648, padded) text of length bytes of data, which keeps the bytes instead
+ * (flagged cJSON_IsBinary, valueint is the length). It is printed by encoding them straight into the output. The text is
+ * only made in place when something needs valuestring, like cJSON_GetStringValue, comparing or cJSON_LoadLazy. */
+CJSON_PUBLIC(cJSON *) cJSON_CreateBinary(const void *data, size_t length);
+/* The bytes of a binary string and their number in length (if not NULL). A parsed string is decoded in place the
+ * first time and becomes binary. NULL if item isn't a string of padded base64 or is a frozen or reference string that
+ * isn't binary yet. The bytes may be changed in place, they are followed by a '\0'. */
+CJSON_PUBLIC(unsigned char *) cJSON_GetBinaryValue(const cJSON *item, size_t *length);
 
 /* Append item to the specified array/object. */
 CJSON_PUBLIC(void) cJSON_AddItemToArray(cJSON *array, cJSON *item);
@@ -190,6 +427,8 @@ CJSON_PUBLIC(void) cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item);
 CJSON_PUBLIC(void) cJSON_AddItemReferenceToObject(cJSON *object, const char *string, cJSON *item);
 
 /* Remove/Detatch items from Arrays/Objects. */
+/* Unlink item, a child of parent, without searching for it. */
+CJSON_PUBLIC(cJSON *) cJSON_DetachItemViaPointer(cJSON *parent, cJSON * const item);
 CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromArray(cJSON *array, int which);
 CJSON_PUBLIC(void) cJSON_DeleteItemFromArray(cJSON *array, int which);
 CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromObject(cJSON *object, const char *string);
@@ -199,6 +438,9 @@ CJSON_PUBLIC(void) cJSON_DeleteItemFromObject(cJSON *object, const char *string)
 CJSON_PUBLIC(void) cJSON_InsertItemInArray(cJSON *array, int which, cJSON *newitem); /* Shifts pre-existing items to the right. */
 CJSON_PUBLIC(void) cJSON_ReplaceItemInArray(cJSON *array, int which, cJSON *newitem);
 CJSON_PUBLIC(void) cJSON_ReplaceItemInObject(cJSON *object,const char *string,cJSON *newitem);
+/* Replace item, a child of parent, with replacement and delete it. If replacement has no key, it takes over the key of
+ * item without copying it. */
+CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemViaPointer(cJSON * const parent, cJSON * const item, cJSON *replacement);
 
 /* Duplicate a cJSON item */
 CJSON_PUBLIC(cJSON *) cJSON_Duplicate(const cJSON *item, cJSON_bool recurse);
@@ -206,12 +448,540 @@ CJSON_PUBLIC(cJSON *) cJSON_Duplicate(const cJSON *item, cJSON_bool recurse);
 need to be released. With recurse!=0, it will duplicate any children connected to the item.
 The item->next and ->prev pointers are always zero on return from Duplicate. */
 
+/* Recursively compare two cJSON items for equality, the order of object members doesn't matter.
+ * If either a or b is NULL, they are considered unequal. */
+CJSON_PUBLIC(cJSON_bool) cJSON_Compare(const cJSON *a, const cJSON *b, cJSON_bool case_sensitive);
+/* Structural hash of an item: equal items (in the sense of cJSON_Compare) have the same hash, no matter in which order
+ * the members of their objects are. It doesn't depend on memory addresses, so it is the same in every run. */
+CJSON_PUBLIC(unsigned long) cJSON_Hash(const cJSON *item);
+/* Remembers the hashes of arrays and objects, so hashing them again only hashes what was changed since: items that were
+ * added, inserted, replaced or detached and numbers set with cJSON_SetNumberValue. The tree is still walked to find the
+ * changes, but unchanged strings, names and numbers aren't hashed again. Changes to the fields of an item are not noticed
+ * and frozen items aren't cached. A tree should only be hashed with one cache. Not thread safe. */
+typedef struct cJSON_HashCache cJSON_HashCache;
+CJSON_PUBLIC(cJSON_HashCache *) cJSON_CreateHashCache(void);
+CJSON_PUBLIC(unsigned long) cJSON_HashWithCache(cJSON_HashCache *cache, const cJSON *item);
+/* cJSON_Compare that returns early if the (cached) hashes differ */
+CJSON_PUBLIC(cJSON_bool) cJSON_CompareWithCache(cJSON_HashCache *cache, const cJSON *a, const cJSON *b, cJSON_bool case_sensitive);
+CJSON_PUBLIC(void) cJSON_DeleteHashCache(cJSON_HashCache *cache);
+/* Let equal strings and equal arrays and objects (with the same members in the same order) in item share one copy:
+ * the first one keeps it, the others are flagged cJSON_IsReference and refer to it. Printing stays the same. Afterwards
+ * item is frozen (see cJSON_Freeze), because a change to one of them would show up in all the others. cJSON_Delete and
+ * cJSON_Duplicate work as usual. Not for documents in an arena. Returns 0 on failure (out of memory, invalid lazy parts
+ * or item is frozen already), some parts may be shared then. */
+CJSON_PUBLIC(cJSON_bool) cJSON_Deduplicate(cJSON *item);
+
 /* ParseWithOpts allows you to require (and check) that the JSON is null terminated, and to retrieve the pointer to the final byte parsed. */
 /* If you supply a ptr in return_parse_end and parsing fails, then return_parse_end will contain a pointer to the error. If not, then cJSON_GetErrorPtr() does the job. */
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
 
+/* Parse at most buffer_length bytes of value, the buffer doesn't have to be null terminated. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithLength(const char *value, size_t buffer_length);
+/* With require_null_terminated, anything but whitespace or a '\0' between the end of the JSON and buffer_length is an error. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated);
+
+/* Parse buffer_length bytes of buffer, unescaping strings into the buffer itself. valuestring and string of the result
+ * point into it (flagged cJSON_IsReference and cJSON_StringIsConst), so it must stay valid until the document is
+ * deleted. The content of buffer is changed even if parsing fails. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSitu(char *buffer, size_t buffer_length);
+
+/* cJSON_ParseWithLength and cJSON_Print/cJSON_PrintUnformatted that measure themselves into stats (see cJSON_Stats). */
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithStats(const char *value, size_t buffer_length, cJSON_Stats *stats);
+CJSON_PUBLIC(char *) cJSON_PrintWithStats(const cJSON *item, cJSON_bool format, cJSON_Stats *stats);
+
+/* Parse buffer_length bytes of value lazily: arrays and objects are only scanned for their end, their children are parsed
+ * when they are first needed by cJSON_GetArraySize, cJSON_GetArrayItem, cJSON_GetObjectItem*, cJSON_ArrayForEach,
+ * printing or one of the functions that change them. Errors inside them are only found then, the access fails.
+ * value must stay valid and unchanged until the document is deleted. Reading a lazy document changes it, so
+ * it must not be read from multiple threads at once. Only whitespace may follow the JSON. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseLazy(const char *value, size_t buffer_length);
+/* Parse all lazy parts of item and unpack its packed arrays, for code that walks ->child itself. Returns 0 if some part of it is invalid JSON. */
+CJSON_PUBLIC(cJSON_bool) cJSON_LoadLazy(cJSON *item);
+/* cJSON_ParseWithLength, but numbers are not converted. They keep their text instead (flagged cJSON_IsLazy, valuestring
+ * points into value and valueint is the length), which is printed unchanged. Read them with cJSON_GetNumberValue or
+ * cJSON_GetNumberText, change them with cJSON_SetNumberValue, or convert them in place with cJSON_LoadLazy for code that
+ * reads valuedouble and valueint itself. value must stay valid and unchanged until the document is deleted. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithNumberText(const char *value, size_t buffer_length);
+/* cJSON_ParseWithLength, but strings are not unescaped. They keep their escaped text instead (flagged cJSON_IsLazy,
+ * valuestring points behind the quote in value and valueint is the length, it is not null terminated), which is printed
+ * unchanged. Read them with cJSON_GetStringValue, or unescape them in place with cJSON_LoadLazy for code that reads
+ * valuestring itself. Names are unescaped as usual. value must stay valid and unchanged until the document is deleted. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithStringText(const char *value, size_t buffer_length);
+/* The value of a string, a lazy string is unescaped first. NULL if item isn't a string (or unescaping it failed). */
+CJSON_PUBLIC(char *) cJSON_GetStringValue(const cJSON *item);
+/* The length of the string of a string item and of the name of an item, 0 if there is none. Stored lengths are used, so
+ * unlike strlen these don't have to read the string. */
+CJSON_PUBLIC(size_t) cJSON_GetStringLength(const cJSON *item);
+CJSON_PUBLIC(size_t) cJSON_GetNameLength(const cJSON *item);
+/* Whether string (the valuestring or string of item) is stored in item, see CJSON_INLINE_STRINGS. Such strings must not be
+ * freed when they are replaced by hand. Always false without CJSON_INLINE_STRINGS. */
+CJSON_PUBLIC(cJSON_bool) cJSON_IsInlineString(const cJSON *item, const char *string);
+/* The value of a number (converted from its text if it has one), 0 if item isn't a number. */
+CJSON_PUBLIC(double) cJSON_GetNumberValue(const cJSON *item);
+/* The text of a number from cJSON_ParseWithNumberText, which is not null terminated. NULL if it has none. */
+CJSON_PUBLIC(const char *) cJSON_GetNumberText(const cJSON *item, size_t *length);
+/* cJSON_ParseWithLength, but arrays that only contain numbers are packed (see cJSON_CreatePackedArray). */
+CJSON_PUBLIC(cJSON *) cJSON_ParsePacked(const char *value, size_t buffer_length);
+
+/* Error codes reported in cJSON_ParseError */
+#define cJSON_Error_None 0
+#define cJSON_Error_OutOfMemory 1
+#define cJSON_Error_UnexpectedEnd 2
+#define cJSON_Error_InvalidValue 3
+#define cJSON_Error_InvalidNumber 4
+#define cJSON_Error_InvalidEscape 5
+#define cJSON_Error_InvalidUnicode 6
+#define cJSON_Error_ExpectedName 7
+#define cJSON_Error_ExpectedColon 8
+#define cJSON_Error_ExpectedArrayEnd 9
+#define cJSON_Error_ExpectedObjectEnd 10
+#define cJSON_Error_TrailingCharacters 11
+#define cJSON_Error_Aborted 12
+#define cJSON_Error_TooDeep 13
+#define cJSON_Error_InvalidUTF8 14
+#define cJSON_Error_File 15
+#define cJSON_Error_TooManyBytes 16
+#define cJSON_Error_TooManyNodes 17
+#define cJSON_Error_StringTooLong 18
+#define cJSON_Error_Codec 19
+
+typedef struct cJSON_ParseError
+{
+    /* one of the cJSON_Error_ codes */
+    int code;
+    /* offset of the error in bytes from the start of the input */
+    size_t position;
+    /* line and column of the error, both starting at 1 (0 if there is no position) */
+    size_t line;
+    size_t column;
+} cJSON_ParseError;
+
+/* Like cJSON_ParseWithOpts, but reports errors in the caller supplied error struct (if not NULL) and never touches
+ * the global error pointer, so it can be called from multiple threads at once. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithError(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated, cJSON_ParseError *error);
+/* Limits on what a single document may use while it is parsed, 0 means no limit. */
+typedef struct cJSON_ParseLimits
+{
+    /* memory for the items, strings and names of the document (without the allocator's overhead and scratch memory of
+     * the parser), counted up as it is allocated */
+    size_t max_bytes;
+    /* number of items */
+    size_t max_nodes;
+    /* how deeply arrays and objects may be nested, it can't exceed CJSON_NESTING_LIMIT */
+    size_t max_depth;
+    /* bytes of a string or name after unescaping */
+    size_t max_string_length;
+} cJSON_ParseLimits;
+/* Like cJSON_ParseWithError with require_null_terminated for buffer_length bytes of value, but parsing stops as soon as
+ * a limit is exceeded, with cJSON_Error_TooManyBytes, cJSON_Error_TooManyNodes, cJSON_Error_TooDeep or
+ * cJSON_Error_StringTooLong. limits and error may be NULL. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithLimits(const char *value, size_t buffer_length, const cJSON_ParseLimits *limits, cJSON_ParseError *error);
+/* Check that buffer_length bytes of value (or up to a '\0') are one JSON value and whitespace, with the same grammar and
+ * errors as cJSON_ParseWithError with require_null_terminated, but without building anything. cJSON_ValidateUTF8 also
+ * rejects strings and names that aren't well-formed UTF-8 with cJSON_Error_InvalidUTF8. error may be NULL. */
+CJSON_PUBLIC(cJSON_bool) cJSON_Validate(const char *value, size_t buffer_length, cJSON_ParseError *error);
+CJSON_PUBLIC(cJSON_bool) cJSON_ValidateUTF8(const char *value, size_t buffer_length, cJSON_ParseError *error);
+/* Flags for cJSON_TextEquals */
+#define cJSON_TextEquals_Unordered 1 /* the members of objects may be in any order */
+#define cJSON_TextEquals_CaseInsensitive 2 /* names are compared case insensitively, like cJSON_Compare(a, b, 0) */
+/* Whether the JSON texts a and b (a_length and b_length bytes, or up to a '\0') hold the same value: numbers are compared
+ * by value and strings after unescaping, with cJSON_TextEquals_Unordered like cJSON_Compare on the parsed trees. Both
+ * texts are read side by side without building anything, and reading stops at the first difference. Invalid texts are
+ * never equal. Objects with members in a different order take time quadratic in their size. */
+CJSON_PUBLIC(cJSON_bool) cJSON_TextEquals(const char *a, size_t a_length, const char *b, size_t b_length, int flags);
+/* Like cJSON_ParseWithError with require_null_terminated for buffer_length bytes of value, but strings and names that
+ * aren't well-formed UTF-8 are rejected with cJSON_Error_InvalidUTF8 while they are copied, so there is no need to
+ * validate the input first. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseStrictUTF8(const char *value, size_t buffer_length, cJSON_ParseError *error);
+/* cJSON_Print (format != 0) or cJSON_PrintUnformatted, but NULL if a string or name in item isn't well-formed UTF-8. */
+CJSON_PUBLIC(char *) cJSON_PrintStrictUTF8(const cJSON *item, cJSON_bool format);
+/* A whole file in memory. It is mapped where the platform supports it (so it is paged in as it is read and never
+ * copied), otherwise it is read into a buffer. The data is not null terminated, so it has to be parsed with a length,
+ * and stays valid until the file is closed. Documents that reference their input (cJSON_ParseLazy,
+ * cJSON_ParseWithNumberText, cJSON_ParseWithStringText) can point straight into it. */
+typedef struct cJSON_File cJSON_File;
+CJSON_PUBLIC(cJSON_File *) cJSON_OpenFile(const char *path);
+CJSON_PUBLIC(const char *) cJSON_GetFileData(const cJSON_File *file);
+CJSON_PUBLIC(size_t) cJSON_GetFileLength(const cJSON_File *file);
+CJSON_PUBLIC(void) cJSON_CloseFile(cJSON_File *file);
+/* Parse the file at path like cJSON_ParseWithError with require_null_terminated. If it can't be read, the error is
+ * cJSON_Error_File. error may be NULL. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseFile(const char *path, cJSON_ParseError *error);
+/* Returns a static description of a cJSON_Error_ code. */
+CJSON_PUBLIC(const char *) cJSON_GetErrorMessage(int code);
+
 CJSON_PUBLIC(void) cJSON_Minify(char *json);
 
+/* An arena hands out memory for parsed documents from large blocks, so that parsing needs only a few allocations
+ * and a whole document is freed at once. The blocks are allocated with the hooks that are active when the arena is created. */
+typedef struct cJSON_Arena cJSON_Arena;
+/* Create an arena that allocates blocks of block_size bytes, 0 selects a default size. */
+CJSON_PUBLIC(cJSON_Arena *) cJSON_CreateArena(size_t block_size);
+/* Parse into the arena. The result must NOT be passed to cJSON_Delete, it is freed with cJSON_ResetArena or cJSON_DeleteArena.
+ * Don't add items that were created outside of the arena to such a document, they would be leaked. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithArena(cJSON_Arena *arena, const char *value);
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithArenaOpts(cJSON_Arena *arena, const char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
+/* cJSON_Duplicate into the arena. The nodes of the copy are laid out next to each other in one allocation, followed by its
+ * strings, constant keys (cJSON_StringIsConst) are shared. Lazy parts of item are loaded first. */
+CJSON_PUBLIC(cJSON *) cJSON_DuplicateWithArena(cJSON_Arena *arena, const cJSON *item, cJSON_bool recurse);
+/* Free all documents in the arena at once, but keep one block around for reuse. */
+CJSON_PUBLIC(void) cJSON_ResetArena(cJSON_Arena *arena);
+/* Free the arena and all documents in it. */
+CJSON_PUBLIC(void) cJSON_DeleteArena(cJSON_Arena *arena);
+/* The number of bytes the arena holds, including blocks that aren't filled yet. */
+CJSON_PUBLIC(size_t) cJSON_GetArenaMemoryUsage(const cJSON_Arena *arena);
+
+/* A document holds one parsed document at a time in an arena (see cJSON_CreateArena for block_size). Resetting it keeps
+ * the blocks of up to retain_limit bytes in total, so parsing a document that is no bigger than the ones before
+ * allocates nothing. The same rules as for arenas apply to the parsed items. */
+typedef struct cJSON_Document cJSON_Document;
+CJSON_PUBLIC(cJSON_Document *) cJSON_CreateDocument(size_t block_size, size_t retain_limit);
+/* Reset the document and parse buffer_length bytes of value into it like cJSON_ParseWithError with
+ * require_null_terminated. The result is valid until the document is reset. error may be NULL. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseInto(cJSON_Document *document, const char *value, size_t buffer_length, cJSON_ParseError *error);
+/* Free the parsed document, but keep its memory up to the retain limit. */
+CJSON_PUBLIC(void) cJSON_ResetDocument(cJSON_Document *document);
+CJSON_PUBLIC(void) cJSON_DeleteDocument(cJSON_Document *document);
+/* The number of bytes the document holds, including the kept blocks. */
+CJSON_PUBLIC(size_t) cJSON_GetDocumentMemoryUsage(const cJSON_Document *document);
+
+/* A context carries its own allocator, so different documents can use different ones without touching cJSON_InitHooks.
+ * Everything that is created by a context function (including printed text) has to be released through the same
+ * context, with cJSON_ContextDelete or cJSON_ContextFree. Items that are removed from such a document with
+ * cJSON_Detach* have to be deleted that way as well. Errors are only reported through return_parse_end. */
+typedef struct cJSON_Context cJSON_Context;
+/* hooks == NULL uses malloc, realloc and free, realloc_fn is used as in cJSON_InitHooksWithRealloc. */
+CJSON_PUBLIC(cJSON_Context *) cJSON_CreateContext(const cJSON_Hooks *hooks, void *(*realloc_fn)(void *ptr, size_t sz));
+/* The documents of the context are not deleted. */
+CJSON_PUBLIC(void) cJSON_DeleteContext(cJSON_Context *context);
+CJSON_PUBLIC(cJSON *) cJSON_ContextParse(cJSON_Context *context, const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated);
+CJSON_PUBLIC(char *) cJSON_ContextPrint(cJSON_Context *context, const cJSON *item, cJSON_bool format);
+CJSON_PUBLIC(cJSON *) cJSON_ContextDuplicate(cJSON_Context *context, const cJSON *item, cJSON_bool recurse);
+CJSON_PUBLIC(void) cJSON_ContextDelete(cJSON_Context *context, cJSON *item);
+/* Free text returned by cJSON_ContextPrint. */
+CJSON_PUBLIC(void) cJSON_ContextFree(cJSON_Context *context, void *pointer);
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateNull(cJSON_Context *context);
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateBool(cJSON_Context *context, cJSON_bool boolean);
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateNumber(cJSON_Context *context, double num);
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateString(cJSON_Context *context, const char *string);
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateRaw(cJSON_Context *context, const char *raw);
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateArray(cJSON_Context *context);
+CJSON_PUBLIC(cJSON *) cJSON_ContextCreateObject(cJSON_Context *context);
+/* cJSON_AddItemToObject that copies string with the allocator of context. Use cJSON_AddItemToArray for arrays. */
+CJSON_PUBLIC(void) cJSON_ContextAddItemToObject(cJSON_Context *context, cJSON *object, const char *string, cJSON *item);
+
+/* A shared document is never changed and can be seen through any number of views. A view starts out sharing all of it
+ * and only copies the parts that are made writable, so a view with a few changes costs little more than the changed
+ * paths. Creating, releasing and deleting views of the same document is not thread safe. */
+typedef struct cJSON_Shared cJSON_Shared;
+typedef struct cJSON_View cJSON_View;
+/* Takes ownership of document, which must not be used directly afterwards (apart from reading). Lazy parts are loaded. */
+CJSON_PUBLIC(cJSON_Shared *) cJSON_CreateShared(cJSON *document);
+CJSON_PUBLIC(const cJSON *) cJSON_GetSharedDocument(const cJSON_Shared *shared);
+/* Give up the owner's reference, the document is deleted together with the last view. */
+CJSON_PUBLIC(void) cJSON_ReleaseShared(cJSON_Shared *shared);
+CJSON_PUBLIC(cJSON_View *) cJSON_CreateView(cJSON_Shared *shared);
+/* The root of the view, for reading only (items flagged cJSON_IsReference are shared) and printing. */
+CJSON_PUBLIC(cJSON *) cJSON_GetViewRoot(const cJSON_View *view);
+/* Make the item at the JSON pointer (RFC 6901, "" for the root) writable and return it, NULL if there is none. The
+ * item and everything on the way to it stop being shared, so its value and its children (but not their children) may
+ * be replaced, added or deleted. Pointers to items that were read before may refer to the shared document. */
+CJSON_PUBLIC(cJSON *) cJSON_GetWritableViewItem(cJSON_View *view, const char *pointer);
+CJSON_PUBLIC(void) cJSON_DeleteView(cJSON_View *view);
+
+/* A parse cache keeps the documents of recently parsed inputs, found by a hash of their bytes, so parsing the same input
+ * again only costs the hash, a comparison and a view. It evicts the least recently used documents to stay within budget
+ * bytes (counted with cJSON_MemoryUsage, plus a copy of each input). Not thread safe. */
+typedef struct cJSON_ParseCache cJSON_ParseCache;
+CJSON_PUBLIC(cJSON_ParseCache *) cJSON_CreateParseCache(size_t budget);
+/* Parse buffer_length bytes of value like cJSON_ParseWithError with require_null_terminated, or find them in the cache.
+ * Returns a new view of the document (see cJSON_CreateView) that has to be deleted with cJSON_DeleteView, it stays
+ * valid after the document is evicted or the cache is deleted. Invalid JSON isn't cached. */
+CJSON_PUBLIC(cJSON_View *) cJSON_ParseCached(cJSON_ParseCache *cache, const char *value, size_t buffer_length, cJSON_ParseError *error);
+/* The number of bytes of the budget in use. */
+CJSON_PUBLIC(size_t) cJSON_GetParseCacheUsage(const cJSON_ParseCache *cache);
+CJSON_PUBLIC(void) cJSON_DeleteParseCache(cJSON_ParseCache *cache);
+
+/* A key table keeps one copy of every distinct object member name, so documents with many objects of the same shape
+ * don't allocate the same names over and over. It can be shared by any number of parses, but not by threads.
+ * The names of documents parsed with it point into the table and are flagged cJSON_StringIsConst, the table has
+ * to be deleted after the documents. */
+typedef struct cJSON_KeyTable cJSON_KeyTable;
+CJSON_PUBLIC(cJSON_KeyTable *) cJSON_CreateKeyTable(void);
+/* Returns the number of distinct names in the table. */
+CJSON_PUBLIC(size_t) cJSON_GetKeyTableCount(const cJSON_KeyTable *table);
+CJSON_PUBLIC(void) cJSON_DeleteKeyTable(cJSON_KeyTable *table);
+/* Like cJSON_ParseWithLengthOpts, but the member names are interned in table. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithKeyTable(cJSON_KeyTable *table, const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated);
+
+/* A projection is a set of JSON pointers (RFC 6901, "" for the root) to the parts of a document that are needed.
+ * Parsing with it builds only the object members on these paths, everything else is skipped without allocating or
+ * unescaping it (and only checked as far as it takes to find its end). Arrays keep all elements, the rest of the path
+ * applies to each of them. For example "/user/name" and "/items/price" keep the name of the user and the price of every
+ * item. Returns NULL if one of the paths isn't a JSON pointer. A projection can be used by any number of parses. */
+typedef struct cJSON_Projection cJSON_Projection;
+CJSON_PUBLIC(cJSON_Projection *) cJSON_CreateProjection(const char * const *paths, size_t count);
+/* A projection that keeps every member, but captures the values at paths, and all arrays and objects nested depth
+ * levels deep (the members of the root are at 1, 0 captures none), as cJSON_Raw items with a copy of their text.
+ * They are printed verbatim, without ever being parsed. */
+CJSON_PUBLIC(cJSON_Projection *) cJSON_CreateRawCapture(const char * const *paths, size_t count, size_t depth);
+CJSON_PUBLIC(void) cJSON_DeleteProjection(cJSON_Projection *projection);
+/* Parse buffer_length bytes of value like cJSON_ParseWithError with require_null_terminated, but only the members in
+ * projection are built. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithProjection(const cJSON_Projection *projection, const char *value, size_t buffer_length, cJSON_ParseError *error);
+
+/* Receives every document of cJSON_ParseMany. Unless they were parsed into an arena, the callback owns the documents and
+ * has to cJSON_Delete them. Returning 0 stops parsing with cJSON_Error_Aborted. */
+typedef cJSON_bool (*cJSON_DocumentCallback)(cJSON *document, void *user_data);
+/* Parse all JSON documents in buffer_length bytes of value, one after another. They may be separated by whitespace, like
+ * newline delimited JSON. If arena is not NULL, the documents are allocated from it, so a batch costs only a few
+ * allocations and is freed with cJSON_ResetArena. Returns the number of documents passed to callback and reports
+ * the first error in error (if not NULL) with a position relative to value. */
+CJSON_PUBLIC(size_t) cJSON_ParseMany(const char *value, size_t buffer_length, cJSON_Arena *arena, cJSON_DocumentCallback callback, void *user_data, cJSON_ParseError *error);
+
+/* Runs task(task_data, index) once for every index below count, in any order and on any threads, and returns when all
+ * of them are finished. cJSON has no threads of its own, so a thread pool is plugged in with this. */
+typedef struct cJSON_Executor
+{
+    void (*run)(void (*task)(void *task_data, size_t index), void *task_data, size_t count, void *executor_data);
+    void *executor_data;
+} cJSON_Executor;
+/* Parse buffer_length bytes of value. If the root is an array, its elements are split into up to tasks ranges that are
+ * parsed in parallel by executor. The hooks (see cJSON_InitHooks) must be thread safe. Only whitespace may follow
+ * the JSON. Errors are reported like cJSON_ParseWithError does. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseParallel(const char *value, size_t buffer_length, const cJSON_Executor *executor, size_t tasks, cJSON_ParseError *error);
+
+/* Print item like cJSON_Print (format != 0) or cJSON_PrintUnformatted. If it is an array or object, its elements are split
+ * into up to tasks ranges that are printed in parallel by executor. The hooks must be thread safe. */
+CJSON_PUBLIC(char *) cJSON_PrintParallel(const cJSON *item, cJSON_bool format, const cJSON_Executor *executor, size_t tasks);
+
+/* An array builder collects the elements of one array from several threads without a lock: every thread appends to its
+ * own lane, which touches nothing the other lanes use (with CJSON_NODE_CACHE, the nodes come from the node cache of the
+ * thread that creates them). cJSON_ArrayBuilderFinish then links the lanes in lane order, so the result only depends on which lane an element
+ * was added to, in time proportional to the number of lanes. */
+typedef struct cJSON_ArrayBuilder cJSON_ArrayBuilder;
+CJSON_PUBLIC(cJSON_ArrayBuilder *) cJSON_CreateArrayBuilder(size_t lanes);
+/* Elements that weren't handed to an array yet are deleted. */
+CJSON_PUBLIC(void) cJSON_DeleteArrayBuilder(cJSON_ArrayBuilder *builder);
+/* Append item to lane, like cJSON_AddItemToArray. Different lanes may be used by different threads at the same time,
+ * a single lane only by one thread at a time. Returns 0 if lane doesn't exist. */
+CJSON_PUBLIC(cJSON_bool) cJSON_ArrayBuilderAdd(cJSON_ArrayBuilder *builder, size_t lane, cJSON *item);
+/* The number of elements in all lanes. */
+CJSON_PUBLIC(size_t) cJSON_ArrayBuilderCount(const cJSON_ArrayBuilder *builder);
+/* Move the elements of all lanes behind the elements of array, after which the lanes are empty and can be used again.
+ * Call it when no thread is adding anymore. Returns 0 if array isn't an array or is frozen. */
+CJSON_PUBLIC(cJSON_bool) cJSON_ArrayBuilderFinish(cJSON_ArrayBuilder *builder, cJSON *array);
+
+/* The streaming minifier does what cJSON_Minify does (including removing comments) to input that is fed in chunks of
+ * any size, with constant memory. The output is handed to writer in chunks of up to 4 KiB. */
+typedef struct cJSON_Minifier cJSON_Minifier;
+CJSON_PUBLIC(cJSON_Minifier *) cJSON_CreateMinifier(cJSON_WriteFunction writer, void *context);
+/* Minify the next chunk of the input. Returns 0 if writer failed, either now or before. */
+CJSON_PUBLIC(cJSON_bool) cJSON_MinifierFeed(cJSON_Minifier *minifier, const char *data, size_t length);
+/* Write what is left, after which the minifier can start over. Returns 0 if writer failed. */
+CJSON_PUBLIC(cJSON_bool) cJSON_MinifierFinish(cJSON_Minifier *minifier);
+CJSON_PUBLIC(void) cJSON_DeleteMinifier(cJSON_Minifier *minifier);
+/* A minifier that writes the layout of cJSON_Print instead, without building a tree. Whitespace and comments of the
+ * input are dropped like by the minifier. Feeding fails as well if the input nests deeper than CJSON_NESTING_LIMIT. */
+CJSON_PUBLIC(cJSON_Minifier *) cJSON_CreateFormatter(cJSON_WriteFunction writer, void *context);
+
+/* Callbacks of the event parser, all of them are optional. Returning 0 aborts parsing with cJSON_Error_Aborted. */
+typedef struct cJSON_SAXHandler
+{
+    cJSON_bool (*start_object)(void *context);
+    cJSON_bool (*end_object)(void *context);
+    cJSON_bool (*start_array)(void *context);
+    cJSON_bool (*end_array)(void *context);
+    /* name of the next member of the current object */
+    cJSON_bool (*key)(const char *name, void *context);
+    /* a string, number, true, false or null. The item is only valid during the call. */
+    cJSON_bool (*value)(const cJSON *item, void *context);
+} cJSON_SAXHandler;
+/* The event parser is fed the input in chunks of any size and calls the handler as it goes, without building a tree.
+ * It only keeps the nesting of arrays and objects and the string or number it is in the middle of.
+ * The input can be a sequence of documents (e.g. newline delimited JSON). */
+typedef struct cJSON_SAXParser cJSON_SAXParser;
+/* context is passed to every callback. */
+CJSON_PUBLIC(cJSON_SAXParser *) cJSON_CreateSAXParser(const cJSON_SAXHandler *handler, void *context);
+/* Parse the next chunk of the input. Returns 0 after an error, see cJSON_SAXParserGetError. */
+CJSON_PUBLIC(cJSON_bool) cJSON_SAXParserFeed(cJSON_SAXParser *parser, const char *data, size_t length);
+/* Signal the end of the input. Returns 0 if it didn't end after a complete document. */
+CJSON_PUBLIC(cJSON_bool) cJSON_SAXParserFinish(cJSON_SAXParser *parser);
+/* Position and cJSON_Error_ code of the error, counted from the start of the input. */
+CJSON_PUBLIC(void) cJSON_SAXParserGetError(const cJSON_SAXParser *parser, cJSON_ParseError *error);
+CJSON_PUBLIC(void) cJSON_DeleteSAXParser(cJSON_SAXParser *parser);
+
+/* The stream parser builds trees on top of the event parser: it is fed the input in chunks of any size and holds the
+ * part of the document that was parsed so far, so the input never has to be in one piece. */
+typedef struct cJSON_StreamParser cJSON_StreamParser;
+CJSON_PUBLIC(cJSON_StreamParser *) cJSON_CreateStreamParser(void);
+/* Parse the next chunk of the input. Returns 0 after an error, see cJSON_StreamParserGetError. */
+CJSON_PUBLIC(cJSON_bool) cJSON_StreamParserFeed(cJSON_StreamParser *parser, const char *data, size_t length);
+/* Signal the end of the input, which completes a number at the end. Returns 0 if it didn't end after a complete document. */
+CJSON_PUBLIC(cJSON_bool) cJSON_StreamParserFinish(cJSON_StreamParser *parser);
+/* Take the next complete document, in the order of the input. Returns NULL if none is complete yet, otherwise the
+ * document belongs to the caller. */
+CJSON_PUBLIC(cJSON *) cJSON_StreamParserNext(cJSON_StreamParser *parser);
+CJSON_PUBLIC(void) cJSON_StreamParserGetError(const cJSON_StreamParser *parser, cJSON_ParseError *error);
+/* Deletes the documents that weren't taken as well. */
+CJSON_PUBLIC(void) cJSON_DeleteStreamParser(cJSON_StreamParser *parser);
+/* cJSON_StreamParserFeed as a cJSON_WriteFunction, with the stream parser as context, e.g. to decompress into it. */
+CJSON_PUBLIC(cJSON_bool) cJSON_StreamParserWrite(const char *data, size_t length, void *parser);
+
+/* A codec transforms a stream chunk by chunk, e.g. to compress or decompress it with zlib or zstd. transform consumes
+ * length bytes of data and hands what it produced to writer, in as many pieces as it likes. With finish set, data is
+ * the last chunk (or empty) and the codec has to write everything it still holds. Returns 0 on failure, including
+ * writer returning 0. */
+typedef struct cJSON_Codec
+{
+    cJSON_bool (*transform)(void *codec_data, const char *data, size_t length, cJSON_bool finish, cJSON_WriteFunction writer, void *writer_context);
+    void *codec_data;
+} cJSON_Codec;
+/* Parse exactly one document from length bytes of encoded data, which is fed to codec in pieces of 4 KiB and decoded
+ * straight into the stream parser, so the decoded text never has to be in one piece. Errors are reported like
+ * cJSON_ParseWithError does, a failure of the codec with cJSON_Error_Codec. error may be NULL. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithCodec(const cJSON_Codec *codec, const char *data, size_t length, cJSON_ParseError *error);
+/* cJSON_PrintToWriter through codec into writer: every chunk of the printed text is transformed as it comes out of the
+ * buffer, so the whole text never has to be in memory. */
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintToCodec(const cJSON *item, cJSON_bool fmt, const cJSON_Codec *codec, cJSON_WriteFunction writer, void *context);
+
+/* Results of cJSON_ParseStep */
+#define cJSON_Step_Failed 0
+#define cJSON_Step_More 1
+#define cJSON_Step_Done 2
+/* Parse a document in steps of a limited size, e.g. one step per iteration of an event loop, with the stream parser.
+ * value has to stay valid until parsing is done, it ends after buffer_length bytes or at a '\0'. Only whitespace may
+ * follow the document. */
+typedef struct cJSON_ParseState cJSON_ParseState;
+CJSON_PUBLIC(cJSON_ParseState *) cJSON_CreateParseState(const char *value, size_t buffer_length);
+/* Parse up to max_bytes more of the input. Returns cJSON_Step_More until the document is complete (cJSON_Step_Done)
+ * or an error was found (cJSON_Step_Failed, see cJSON_ParseStateGetError). */
+CJSON_PUBLIC(int) cJSON_ParseStep(cJSON_ParseState *state, size_t max_bytes);
+/* After cJSON_Step_Done, the document belongs to the caller. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseStateTakeResult(cJSON_ParseState *state);
+CJSON_PUBLIC(void) cJSON_ParseStateGetError(const cJSON_ParseState *state, cJSON_ParseError *error);
+CJSON_PUBLIC(void) cJSON_DeleteParseState(cJSON_ParseState *state);
+
+/* A tape is a read-only, flat parse result: one array of entries instead of a tree of allocated items.
+ * Strings without escape sequences point into the input, which has to stay around as long as the tape and
+ * means they are NOT '\0' terminated, use the length. Anything but whitespace after the value is an error. */
+typedef struct cJSON_Tape cJSON_Tape;
+typedef struct cJSON_TapeValue cJSON_TapeValue;
+CJSON_PUBLIC(cJSON_Tape *) cJSON_ParseTape(const char *value, size_t buffer_length, cJSON_ParseError *error);
+CJSON_PUBLIC(void) cJSON_DeleteTape(cJSON_Tape *tape);
+CJSON_PUBLIC(const cJSON_TapeValue *) cJSON_TapeGetRoot(const cJSON_Tape *tape);
+/* Accessors for the values, they work like the fields and functions of cJSON with the same name. */
+CJSON_PUBLIC(int) cJSON_TapeGetType(const cJSON_TapeValue *item);
+CJSON_PUBLIC(double) cJSON_TapeGetNumber(const cJSON_TapeValue *item);
+/* The text of a string and its length (if length isn't NULL), NULL for other types. */
+CJSON_PUBLIC(const char *) cJSON_TapeGetString(const cJSON_TapeValue *item, size_t *length);
+/* The name of an object member and its length, NULL otherwise. */
+CJSON_PUBLIC(const char *) cJSON_TapeGetName(const cJSON_TapeValue *item, size_t *length);
+CJSON_PUBLIC(const cJSON_TapeValue *) cJSON_TapeGetChild(const cJSON_TapeValue *item);
+CJSON_PUBLIC(const cJSON_TapeValue *) cJSON_TapeGetNext(const cJSON_TapeValue *item);
+/* O(1), the number of children is stored in the entry. */
+CJSON_PUBLIC(int) cJSON_TapeGetArraySize(const cJSON_TapeValue *array);
+CJSON_PUBLIC(const cJSON_TapeValue *) cJSON_TapeGetArrayItem(const cJSON_TapeValue *array, int index);
+CJSON_PUBLIC(const cJSON_TapeValue *) cJSON_TapeGetObjectItem(const cJSON_TapeValue *object, const char *string);
+CJSON_PUBLIC(const cJSON_TapeValue *) cJSON_TapeGetObjectItemCaseSensitive(const cJSON_TapeValue *object, const char *string);
+
+/* A compact document is a read-only copy of a tree in a single allocation. A node takes 16 bytes (plus 8 for a number)
+ * instead of a whole cJSON struct, and strings are stored inline, but documents are limited to 4 GB. */
+typedef struct cJSON_Compact cJSON_Compact;
+/* Returns the root of the document, NULL on failure. */
+CJSON_PUBLIC(cJSON_Compact *) cJSON_CreateCompact(const cJSON *item);
+/* document has to be the root returned by cJSON_CreateCompact. */
+CJSON_PUBLIC(void) cJSON_DeleteCompact(cJSON_Compact *document);
+/* Number of bytes the document takes. */
+CJSON_PUBLIC(size_t) cJSON_GetCompactSize(const cJSON_Compact *document);
+/* The document as a position independent image of cJSON_GetCompactSize bytes, for example to write it to a file.
+ * Images can only be loaded on machines with the same byte order. */
+CJSON_PUBLIC(const void *) cJSON_GetCompactImage(const cJSON_Compact *document);
+/* Use an image in place, for example a file mapped into memory, without parsing or copying it. Returns the root or NULL
+ * if the header doesn't match. Set verify for images from untrusted sources, so all nodes are checked as well.
+ * The image has to be aligned like memory from malloc and stay valid while the document is used.
+ * The root must not be passed to cJSON_DeleteCompact. */
+CJSON_PUBLIC(const cJSON_Compact *) cJSON_LoadCompact(const void *image, size_t length, cJSON_bool verify);
+/* Create a regular tree from a node and its children. */
+CJSON_PUBLIC(cJSON *) cJSON_ExpandCompact(const cJSON_Compact *item);
+/* Accessors for the nodes, they work like the fields and functions of cJSON with the same name. */
+CJSON_PUBLIC(int) cJSON_CompactGetType(const cJSON_Compact *item);
+CJSON_PUBLIC(double) cJSON_CompactGetNumber(const cJSON_Compact *item);
+/* valuestring of strings and raw json, NULL for other types. */
+CJSON_PUBLIC(const char *) cJSON_CompactGetString(const cJSON_Compact *item);
+/* name of an object member, NULL otherwise. */
+CJSON_PUBLIC(const char *) cJSON_CompactGetName(const cJSON_Compact *item);
+CJSON_PUBLIC(const cJSON_Compact *) cJSON_CompactGetChild(const cJSON_Compact *item);
+CJSON_PUBLIC(const cJSON_Compact *) cJSON_CompactGetNext(const cJSON_Compact *item);
+/* O(1), the number of children is stored in the node. */
+CJSON_PUBLIC(int) cJSON_CompactGetArraySize(const cJSON_Compact *array);
+CJSON_PUBLIC(const cJSON_Compact *) cJSON_CompactGetArrayItem(const cJSON_Compact *array, int index);
+CJSON_PUBLIC(const cJSON_Compact *) cJSON_CompactGetObjectItem(const cJSON_Compact *object, const char *string);
+CJSON_PUBLIC(const cJSON_Compact *) cJSON_CompactGetObjectItemCaseSensitive(const cJSON_Compact *object, const char *string);
+
+/* CBOR (RFC 8949) and MessagePack. Numbers are stored as integers if they are integral and as exact as a double,
+ * otherwise as floats. Raw items can't be encoded. The result is freed with the deallocate hook (free by default) and
+ * its size is stored in *length. */
+CJSON_PUBLIC(unsigned char *) cJSON_PrintCBOR(const cJSON *item, size_t *length);
+CJSON_PUBLIC(unsigned char *) cJSON_PrintMessagePack(const cJSON *item, size_t *length);
+/* Byte strings, binary data, extension types, indefinite lengths and strings that contain '\0' aren't supported,
+ * tags are ignored. Object member names have to be strings. Errors are reported in error (if not NULL), with a line
+ * and column of 0. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseCBOR(const void *value, size_t length, cJSON_ParseError *error);
+CJSON_PUBLIC(cJSON *) cJSON_ParseMessagePack(const void *value, size_t length, cJSON_ParseError *error);
+
+/* A template is a tree printed once, with slots for the values that change. Rendering copies the printed text and only
+ * prints the values of the slots. */
+typedef struct cJSON_Template cJSON_Template;
+/* A placeholder for a value, types is a mask of the types the value may have (cJSON_Invalid for any). Trees with slots
+ * can only be printed by cJSON_CreateTemplate. */
+CJSON_PUBLIC(cJSON *) cJSON_CreateSlot(int types);
+/* The skeleton isn't needed after the template is created. */
+CJSON_PUBLIC(cJSON_Template *) cJSON_CreateTemplate(const cJSON *skeleton, cJSON_bool format);
+CJSON_PUBLIC(void) cJSON_DeleteTemplate(cJSON_Template *compiled);
+CJSON_PUBLIC(int) cJSON_GetTemplateSlotCount(const cJSON_Template *compiled);
+/* values has an item for every slot, in the order they are printed. Fails if a value doesn't match the types of its slot. */
+CJSON_PUBLIC(char *) cJSON_RenderTemplate(const cJSON_Template *compiled, const cJSON * const *values);
+CJSON_PUBLIC(cJSON_bool) cJSON_RenderTemplatePreallocated(const cJSON_Template *compiled, const cJSON * const *values, char *buffer, const int length);
+
+/* Types of the members of a struct that cJSON_ParseStruct fills. */
+#define cJSON_FieldBool 1 /* cJSON_bool */
+#define cJSON_FieldInt 2 /* int, converted like valueint */
+#define cJSON_FieldDouble 3 /* double */
+#define cJSON_FieldString 4 /* char *, allocated with the hooks of cJSON_InitHooks */
+#define cJSON_FieldChars 5 /* char[size], strings that don't fit are an error */
+#define cJSON_FieldObject 6 /* a nested struct */
+
+/* Describes a member of a struct that is stored as a member of a JSON object. */
+typedef struct cJSON_Field
+{
+    /* the name in the JSON object, a NULL name ends a list of fields */
+    const char *name;
+    /* one of the cJSON_Field types */
+    int type;
+    /* offsetof the member in the struct */
+    size_t offset;
+    /* the size of cJSON_FieldChars */
+    size_t size;
+    /* the fields of the nested struct of cJSON_FieldObject */
+    const struct cJSON_Field *fields;
+} cJSON_Field;
+
+typedef struct cJSON_Schema cJSON_Schema;
+/* Compile a list of fields. The lists have to stay valid while the schema is used. Returns NULL if a type or size is
+ * invalid or structs are nested deeper than CJSON_NESTING_LIMIT. */
+CJSON_PUBLIC(cJSON_Schema *) cJSON_CreateSchema(const cJSON_Field *fields);
+CJSON_PUBLIC(void) cJSON_DeleteSchema(cJSON_Schema *schema);
+/* Parse a JSON object straight into the struct at target, without creating any items. Members of the object that aren't
+ * in the schema and null values are skipped, members that don't appear keep their value. String members have to be
+ * NULL or allocated with the hooks, they are replaced. On failure the struct is partially filled. */
+CJSON_PUBLIC(cJSON_bool) cJSON_ParseStruct(const cJSON_Schema *schema, const char *value, size_t buffer_length, void *target, cJSON_ParseError *error);
+/* Free the string members of a struct and set them to NULL. */
+CJSON_PUBLIC(void) cJSON_FreeStructStrings(const cJSON_Schema *schema, void *target);
+/* Print a struct as an unformatted JSON object with the members in the order of the fields, without creating any items.
+ * The names are escaped when the schema is compiled. NULL strings are printed as null. */
+CJSON_PUBLIC(char *) cJSON_PrintStruct(const cJSON_Schema *schema, const void *source);
+
 /* Macros for creating things quickly. */
 #define cJSON_AddNullToObject(object,name) cJSON_AddItemToObject(object, name, cJSON_CreateNull())
 #define cJSON_AddTrueToObject(object,name) cJSON_AddItemToObject(object, name, cJSON_CreateTrue())
@@ -226,9 +996,15 @@ CJSON_PUBLIC(void) cJSON_Minify(char *json);
 /* helper for the cJSON_SetNumberValue macro */
 CJSON_PUBLIC(double) cJSON_SetNumberHelper(cJSON *object, double number);
 #define cJSON_SetNumberValue(object, number) ((object != NULL) ? cJSON_SetNumberHelper(object, (double)number) : (number))
+/* Replace the string of a cJSON_String item with a copy of valuestring. Returns the new valuestring, or NULL for other
+ * types, references, frozen items, a valuestring that points into the current one, and when out of memory. Not for
+ * documents in an arena. */
+CJSON_PUBLIC(char*) cJSON_SetValuestring(cJSON *object, const char *valuestring);
 
 /* Macro for iterating over an array */
-#define cJSON_ArrayForEach(element, array) for(element = (array != NULL) ? (array)->child : NULL; element != NULL; element = element->next)
+#define cJSON_ArrayForEach(element, array) for(element = cJSON_GetArrayItem(array, 0); element != NULL; element = element->next)
+/* The same for the values of a tape */
+#define cJSON_TapeArrayForEach(element, array) for(element = cJSON_TapeGetChild(array); element != NULL; element = cJSON_TapeGetNext(element))
 
 #ifdef __cplusplus
 }
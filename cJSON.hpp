@@ -0,0 +1,407 @@
+/*
+  Copyright (c) 2009 Dave Gamble
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#ifndef cJSON__hpp
+#define cJSON__hpp
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "cJSON.h"
+
+/* A header-only C++17 wrapper. cjson::Document owns a tree and can only be moved, cjson::Value sees an item of a
+ * document without owning it. Nothing throws: failures give empty documents and values, and empty values read as
+ * nothing. A document can use the allocator of a cJSON_Context, the values of its tree carry it along. */
+namespace cjson
+{
+
+class Document;
+
+/* The name of a member together with its length and cJSON_HashName, which the compiler computes for literals ("id"_k,
+ * guaranteed for a constexpr Key), so looking it up skips strlen and hashing. Names with bytes above 0x7F are looked up
+ * by their text instead, because tolower depends on the locale for them. */
+class Key
+{
+public:
+    constexpr Key(const char *name, std::size_t length) noexcept : name_(name), length_(length), hash_(hash(name, length)), ascii_(is_ascii(name, length)) {}
+    template <std::size_t N>
+    constexpr Key(const char (&name)[N]) noexcept : Key(name, N - 1) {}
+
+    constexpr const char *name() const noexcept { return name_; }
+    constexpr std::size_t length() const noexcept { return length_; }
+    /* only meaningful if the name is ASCII */
+    constexpr std::size_t hash() const noexcept { return hash_; }
+    constexpr bool is_ascii() const noexcept { return ascii_; }
+
+private:
+    static constexpr std::size_t hash(const char *name, std::size_t length) noexcept
+    {
+        std::size_t value = 5381;
+        for (std::size_t i = 0; i < length; i++)
+        {
+            const unsigned char byte = static_cast<unsigned char>(name[i]);
+            value = (value * 33) ^ static_cast<std::size_t>(((byte >= 'A') && (byte <= 'Z')) ? (byte + ('a' - 'A')) : byte);
+        }
+        return value;
+    }
+    static constexpr bool is_ascii(const char *name, std::size_t length) noexcept
+    {
+        for (std::size_t i = 0; i < length; i++)
+        {
+            if ((static_cast<unsigned char>(name[i]) > 0x7F) || (name[i] == '\0'))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const char *name_;
+    std::size_t length_;
+    std::size_t hash_;
+    bool ascii_;
+};
+
+namespace literals
+{
+constexpr Key operator""_k(const char *name, std::size_t length) noexcept
+{
+    return Key(name, length);
+}
+} /* namespace literals */
+
+template <typename T>
+inline constexpr bool is_readable = std::is_arithmetic_v<T> || std::is_same_v<T, std::string_view>;
+
+class Value
+{
+public:
+    class iterator
+    {
+    public:
+        iterator() noexcept : item_(nullptr), context_(nullptr) {}
+        iterator(cJSON *item, cJSON_Context *context) noexcept : item_(item), context_(context) {}
+
+        Value operator*() const noexcept { return Value(item_, context_); }
+        iterator &operator++() noexcept
+        {
+            item_ = item_->next;
+            return *this;
+        }
+        bool operator==(const iterator &other) const noexcept { return item_ == other.item_; }
+        bool operator!=(const iterator &other) const noexcept { return item_ != other.item_; }
+
+    private:
+        cJSON *item_;
+        cJSON_Context *context_;
+    };
+
+    Value() noexcept : item_(nullptr), context_(nullptr) {}
+    explicit Value(cJSON *item, cJSON_Context *context = nullptr) noexcept : item_(item), context_(context) {}
+
+    cJSON *get() const noexcept { return item_; }
+    cJSON_Context *context() const noexcept { return context_; }
+    explicit operator bool() const noexcept { return item_ != nullptr; }
+
+    bool is_null() const noexcept { return cJSON_IsNull(item_) != 0; }
+    bool is_bool() const noexcept { return cJSON_IsBool(item_) != 0; }
+    bool is_number() const noexcept { return cJSON_IsNumber(item_) != 0; }
+    bool is_string() const noexcept { return cJSON_IsString(item_) != 0; }
+    bool is_array() const noexcept { return cJSON_IsArray(item_) != 0; }
+    bool is_object() const noexcept { return cJSON_IsObject(item_) != 0; }
+    bool is_raw() const noexcept { return cJSON_IsRaw(item_) != 0; }
+
+    bool as_bool(bool fallback = false) const noexcept { return is_bool() ? (cJSON_IsTrue(item_) != 0) : fallback; }
+    double as_number(double fallback = 0) const noexcept { return is_number() ? cJSON_GetNumberValue(item_) : fallback; }
+    /* The text of a string, empty for other types. It stays valid until the string is changed or deleted. */
+    std::string_view as_string() const noexcept
+    {
+        const char *string = cJSON_GetStringValue(item_);
+        return (string != nullptr) ? std::string_view(string, cJSON_GetStringLength(item_)) : std::string_view();
+    }
+    /* The value as bool, a number type or std::string_view, or fallback if the item has another type. Numbers outside the
+     * range of an integer type are clamped to it. */
+    template <typename T>
+    T as(T fallback = T()) const noexcept
+    {
+        static_assert(is_readable<T>, "items can be read as bool, numbers and std::string_view");
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            return as_bool(fallback);
+        }
+        else if constexpr (std::is_same_v<T, std::string_view>)
+        {
+            return is_string() ? as_string() : fallback;
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            const double number = cJSON_GetNumberValue(item_);
+            if (!is_number() || (number != number))
+            {
+                return fallback;
+            }
+            if (number >= static_cast<double>(std::numeric_limits<T>::max()))
+            {
+                return std::numeric_limits<T>::max();
+            }
+            if (number <= static_cast<double>(std::numeric_limits<T>::min()))
+            {
+                return std::numeric_limits<T>::min();
+            }
+            return static_cast<T>(number);
+        }
+        else
+        {
+            return is_number() ? static_cast<T>(cJSON_GetNumberValue(item_)) : fallback;
+        }
+    }
+    /* The member key, read with as<T>. */
+    template <typename T>
+    T get(const Key &key, T fallback = T()) const noexcept
+    {
+        return (*this)[key].template as<T>(fallback);
+    }
+    /* The text of a number that wasn't converted (see cJSON_ParseWithNumberText), it has a stored length. */
+    std::string_view number_text() const noexcept
+    {
+        std::size_t length = 0;
+        const char *text = cJSON_GetNumberText(item_, &length);
+        return (text != nullptr) ? std::string_view(text, length) : std::string_view();
+    }
+    /* The name of an object member, empty otherwise. */
+    std::string_view name() const noexcept
+    {
+        return ((item_ != nullptr) && (item_->string != nullptr)) ? std::string_view(item_->string, cJSON_GetNameLength(item_)) : std::string_view();
+    }
+
+    std::size_t size() const noexcept { return (item_ != nullptr) ? cJSON_GetArrayLength(item_) : 0; }
+    /* The member with exactly this name. */
+    Value operator[](const char *name) const noexcept { return Value(cJSON_GetObjectItemCaseSensitive(item_, name), context_); }
+    Value operator[](const std::string &name) const noexcept { return (*this)[name.c_str()]; }
+    Value operator[](const Key &key) const noexcept
+    {
+        if (!key.is_ascii())
+        {
+            /* literals are null terminated */
+            return (*this)[key.name()];
+        }
+        return Value(cJSON_GetObjectItemWithHash(item_, key.name(), key.length(), key.hash()), context_);
+    }
+    Value at(std::size_t index) const noexcept { return Value(cJSON_GetArrayItemAt(item_, index), context_); }
+    /* The elements of an array or the members of an object. */
+    iterator begin() const noexcept { return iterator(cJSON_GetArrayItem(item_, 0), context_); }
+    iterator end() const noexcept { return iterator(); }
+
+    /* cJSON_Print (format) or cJSON_PrintUnformatted, empty on failure. */
+    std::string print(bool format = false) const
+    {
+        std::string text;
+        if ((item_ == nullptr) || !cJSON_PrintToWriter(item_, format, append_text, &text))
+        {
+            text.clear();
+        }
+        return text;
+    }
+
+    /* Set the value of a number. */
+    void set_number(double number) const noexcept
+    {
+        if (is_number())
+        {
+            cJSON_SetNumberHelper(item_, number);
+        }
+    }
+    /* Move item to the end of an array or object (with name), without copying it. It has to use the allocator of this
+     * value. Returns its new place, or an empty value if this isn't an array or object, item is left alone then. */
+    inline Value append(Document &&item) const noexcept;
+    inline Value add(const char *name, Document &&item) const noexcept;
+    /* Take one of the elements or the member with exactly this name out of the tree, it is kept alive by the result. */
+    inline Document detach(Value element) const noexcept;
+    inline Document detach(const char *name) const noexcept;
+
+private:
+    static cJSON_bool append_text(const char *data, std::size_t length, void *context)
+    {
+        static_cast<std::string*>(context)->append(data, length);
+        return 1;
+    }
+
+    cJSON *item_;
+    cJSON_Context *context_;
+};
+
+class Document
+{
+public:
+    Document() noexcept : item_(nullptr), context_(nullptr) {}
+    /* Takes over item, which was made by context (or the global hooks if it is NULL). */
+    explicit Document(cJSON *item, cJSON_Context *context = nullptr) noexcept : item_(item), context_(context) {}
+    Document(Document &&other) noexcept : item_(other.item_), context_(other.context_) { other.item_ = nullptr; }
+    Document &operator=(Document &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            item_ = other.item_;
+            context_ = other.context_;
+            other.item_ = nullptr;
+        }
+        return *this;
+    }
+    Document(const Document &) = delete;
+    Document &operator=(const Document &) = delete;
+    ~Document() { reset(); }
+
+    /* Parse all of text, anything but whitespace after the JSON is an error. */
+    static Document parse(std::string_view text, cJSON_Context *context = nullptr) noexcept
+    {
+        if (context != nullptr)
+        {
+            return Document(cJSON_ContextParse(context, text.data(), text.size(), nullptr, 1), context);
+        }
+        return Document(cJSON_ParseWithLengthOpts(text.data(), text.size(), nullptr, 1));
+    }
+    static Document null(cJSON_Context *context = nullptr) noexcept
+    {
+        return Document((context != nullptr) ? cJSON_ContextCreateNull(context) : cJSON_CreateNull(), context);
+    }
+    static Document boolean(bool value, cJSON_Context *context = nullptr) noexcept
+    {
+        return Document((context != nullptr) ? cJSON_ContextCreateBool(context, value) : cJSON_CreateBool(value), context);
+    }
+    static Document number(double value, cJSON_Context *context = nullptr) noexcept
+    {
+        return Document((context != nullptr) ? cJSON_ContextCreateNumber(context, value) : cJSON_CreateNumber(value), context);
+    }
+    static Document string(const char *value, cJSON_Context *context = nullptr) noexcept
+    {
+        return Document((context != nullptr) ? cJSON_ContextCreateString(context, value) : cJSON_CreateString(value), context);
+    }
+    static Document string(const std::string &value, cJSON_Context *context = nullptr) noexcept
+    {
+        return string(value.c_str(), context);
+    }
+    static Document array(cJSON_Context *context = nullptr) noexcept
+    {
+        return Document((context != nullptr) ? cJSON_ContextCreateArray(context) : cJSON_CreateArray(), context);
+    }
+    static Document object(cJSON_Context *context = nullptr) noexcept
+    {
+        return Document((context != nullptr) ? cJSON_ContextCreateObject(context) : cJSON_CreateObject(), context);
+    }
+
+    /* A deep copy with the same allocator, only needed if both have to live on. */
+    Document duplicate() const noexcept
+    {
+        if (context_ != nullptr)
+        {
+            return Document(cJSON_ContextDuplicate(context_, item_, 1), context_);
+        }
+        return Document(cJSON_Duplicate(item_, 1));
+    }
+
+    Value root() const noexcept { return Value(item_, context_); }
+    cJSON *get() const noexcept { return item_; }
+    cJSON_Context *context() const noexcept { return context_; }
+    explicit operator bool() const noexcept { return item_ != nullptr; }
+
+    /* Give up the tree without deleting it. */
+    cJSON *release() noexcept
+    {
+        cJSON *item = item_;
+        item_ = nullptr;
+        return item;
+    }
+    void reset() noexcept
+    {
+        if ((item_ != nullptr) && (context_ != nullptr))
+        {
+            cJSON_ContextDelete(context_, item_);
+        }
+        else if (item_ != nullptr)
+        {
+            cJSON_Delete(item_);
+        }
+        item_ = nullptr;
+    }
+
+private:
+    cJSON *item_;
+    cJSON_Context *context_;
+};
+
+inline Value Value::append(Document &&item) const noexcept
+{
+    cJSON *element = nullptr;
+
+    if (!item || (!is_array() && !is_object()))
+    {
+        return Value();
+    }
+    element = item.release();
+    cJSON_AddItemToArray(item_, element);
+
+    return Value(element, context_);
+}
+
+inline Value Value::add(const char *name, Document &&item) const noexcept
+{
+    cJSON *member = nullptr;
+
+    if (!item || !is_object() || (name == nullptr))
+    {
+        return Value();
+    }
+    member = item.release();
+    if (context_ != nullptr)
+    {
+        cJSON_ContextAddItemToObject(context_, item_, name, member);
+    }
+    else
+    {
+        cJSON_AddItemToObject(item_, name, member);
+    }
+
+    return Value(member, context_);
+}
+
+inline Document Value::detach(Value element) const noexcept
+{
+    if (!element || (!is_array() && !is_object()))
+    {
+        return Document();
+    }
+
+    return Document(cJSON_DetachItemViaPointer(item_, element.get()), context_);
+}
+
+inline Document Value::detach(const char *name) const noexcept
+{
+    return detach((*this)[name]);
+}
+
+} /* namespace cjson */
+
+#endif
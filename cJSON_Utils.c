@@ -8,21 +8,6 @@
 
 #include "cJSON_Utils.h"
 
-static unsigned char* cJSONUtils_strdup(const unsigned char* str)
-{
-    size_t len = 0;
-    unsigned char *copy = NULL;
-
-    len = strlen((const char*)str) + 1;
-    if (!(copy = (unsigned char*)malloc(len)))
-    {
-        return NULL;
-    }
-    memcpy(copy, str, len);
-
-    return copy;
-}
-
 static int cJSONUtils_strcasecmp(const unsigned char *s1, const unsigned char *s2)
 {
     if (!s1)
@@ -117,59 +102,205 @@ static void cJSONUtils_PointerEncodedstrcpy(unsigned char *d, const unsigned cha
     *d = '\0';
 }
 
-CJSON_PUBLIC(char *) cJSONUtils_FindPointerFromObjectTo(cJSON *object, cJSON *target)
+/* one level of the path from the root to the current item */
+typedef struct cJSONUtils_PathFrame
+{
+    cJSON *child;
+    size_t index;
+} cJSONUtils_PathFrame;
+
+/* build the pointer for the item at the end of the path in one allocation */
+static char *cJSONUtils_PathToPointer(const cJSON *object, const cJSONUtils_PathFrame *path, size_t depth)
 {
-    size_t c = 0;
-    cJSON *obj = 0;
+    size_t length = 1;
+    size_t level = 0;
+    const cJSON *parent = object;
+    unsigned char *pointer = NULL;
+    unsigned char *end = NULL;
+
+    for (level = 0; level < depth; level++)
+    {
+        if (cJSON_IsArray(parent))
+        {
+            /* check if conversion to unsigned long is valid
+             * This should be eliminated at compile time by dead code elimination
+             * if size_t is an alias of unsigned long, or if it is bigger */
+            if (path[level].index > ULONG_MAX)
+            {
+                return NULL;
+            }
+            /* enough for a 64 bit integer + '/' */
+            length += 21;
+        }
+        else
+        {
+            length += cJSONUtils_PointerEncodedstrlen((unsigned char*)path[level].child->string) + 1;
+        }
+        parent = path[level].child;
+    }
 
-    if (object == target)
+    pointer = (unsigned char*)malloc(length);
+    if (pointer == NULL)
     {
-        /* found */
-        return (char*)cJSONUtils_strdup((const unsigned char*)"");
+        return NULL;
     }
 
-    /* recursively search all children of the object */
-    for (obj = object->child; obj; (void)(obj = obj->next), c++)
+    end = pointer;
+    *end = '\0';
+    parent = object;
+    for (level = 0; level < depth; level++)
     {
-        unsigned char *found = (unsigned char*)cJSONUtils_FindPointerFromObjectTo(obj, target);
-        if (found)
+        if (cJSON_IsArray(parent))
         {
-            if (cJSON_IsArray(object))
-            {
-                /* reserve enough memory for a 64 bit integer + '/' and '\0' */
-                unsigned char *ret = (unsigned char*)malloc(strlen((char*)found) + 23);
-                /* check if conversion to unsigned long is valid
-                 * This should be eliminated at compile time by dead code elimination
-                 * if size_t is an alias of unsigned long, or if it is bigger */
-                if (c > ULONG_MAX)
-                {
-                    free(found);
-                    return NULL;
-                }
-                sprintf((char*)ret, "/%lu%s", (unsigned long)c, found); /* /<array_index><path> */
-                free(found);
+            end += sprintf((char*)end, "/%lu", (unsigned long)path[level].index); /* /<array_index> */
+        }
+        else
+        {
+            *end++ = '/';
+            cJSONUtils_PointerEncodedstrcpy(end, (unsigned char*)path[level].child->string);
+            end += strlen((char*)end);
+        }
+        parent = path[level].child;
+    }
 
-                return (char*)ret;
+    return (char*)pointer;
+}
+
+typedef struct cJSONUtils_SortedTarget
+{
+    const cJSON *target;
+    size_t position;
+} cJSONUtils_SortedTarget;
+
+static int cJSONUtils_CompareTargets(const void *a, const void *b)
+{
+    const cJSON *first = ((const cJSONUtils_SortedTarget*)a)->target;
+    const cJSON *second = ((const cJSONUtils_SortedTarget*)b)->target;
+
+    return (first > second) - (first < second);
+}
+
+/* traverse the tree once without recursion, keeping the path to the current item on a stack.
+ * targets have to be sorted, pointers[position] is set for every target that is found */
+static size_t cJSONUtils_FindPointers(cJSON *object, const cJSONUtils_SortedTarget *targets, size_t count, char **pointers)
+{
+    cJSONUtils_PathFrame *path = NULL;
+    size_t capacity = 0;
+    size_t depth = 0;
+    size_t found = 0;
+    cJSON *current = object;
+
+    while (current != NULL)
+    {
+        /* first target that is not below current */
+        size_t low = 0;
+        size_t high = count;
+        while (low < high)
+        {
+            size_t middle = low + ((high - low) / 2);
+            if (targets[middle].target < current)
+            {
+                low = middle + 1;
             }
-            else if (cJSON_IsObject(object))
+            else
             {
-                unsigned char *ret = (unsigned char*)malloc(strlen((char*)found) + cJSONUtils_PointerEncodedstrlen((unsigned char*)obj->string) + 2);
-                *ret = '/';
-                cJSONUtils_PointerEncodedstrcpy(ret + 1, (unsigned char*)obj->string);
-                strcat((char*)ret, (char*)found);
-                free(found);
+                high = middle;
+            }
+        }
+        for (; (low < count) && (targets[low].target == current); low++)
+        {
+            pointers[targets[low].position] = cJSONUtils_PathToPointer(object, path, depth);
+            found++;
+        }
+        if (found == count)
+        {
+            break;
+        }
 
-                return (char*)ret;
+        if ((cJSON_IsArray(current) || cJSON_IsObject(current)) && (current->child != NULL))
+        {
+            /* descend to the first child */
+            if (depth == capacity)
+            {
+                size_t new_capacity = (capacity == 0) ? 16 : (2 * capacity);
+                cJSONUtils_PathFrame *new_path = (cJSONUtils_PathFrame*)realloc(path, new_capacity * sizeof(cJSONUtils_PathFrame));
+                if (new_path == NULL)
+                {
+                    break;
+                }
+                path = new_path;
+                capacity = new_capacity;
             }
+            path[depth].child = current->child;
+            path[depth].index = 0;
+            depth++;
+            current = current->child;
+            continue;
+        }
 
-            /* reached leaf of the tree, found nothing */
-            free(found);
-            return NULL;
+        /* go to the next sibling, going up as long as there is none */
+        while ((depth > 0) && (path[depth - 1].child->next == NULL))
+        {
+            depth--;
         }
+        if (depth == 0)
+        {
+            break;
+        }
+        path[depth - 1].child = path[depth - 1].child->next;
+        path[depth - 1].index++;
+        current = path[depth - 1].child;
     }
 
-    /* not found */
-    return NULL;
+    free(path);
+
+    return found;
+}
+
+CJSON_PUBLIC(char *) cJSONUtils_FindPointerFromObjectTo(cJSON *object, cJSON *target)
+{
+    cJSONUtils_SortedTarget sorted;
+    char *pointer = NULL;
+
+    sorted.target = target;
+    sorted.position = 0;
+    cJSONUtils_FindPointers(object, &sorted, 1, &pointer);
+
+    return pointer;
+}
+
+CJSON_PUBLIC(size_t) cJSONUtils_FindPointersFromObjectTo(cJSON *object, cJSON * const *targets, size_t count, char **pointers)
+{
+    cJSONUtils_SortedTarget *sorted = NULL;
+    size_t found = 0;
+    size_t i = 0;
+
+    if ((targets == NULL) || (pointers == NULL))
+    {
+        return 0;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        pointers[i] = NULL;
+    }
+
+    sorted = (cJSONUtils_SortedTarget*)malloc(count * sizeof(cJSONUtils_SortedTarget) + 1);
+    if (sorted == NULL)
+    {
+        return 0;
+    }
+    for (i = 0; i < count; i++)
+    {
+        sorted[i].target = targets[i];
+        sorted[i].position = i;
+    }
+    qsort(sorted, count, sizeof(cJSONUtils_SortedTarget), cJSONUtils_CompareTargets);
+
+    found = cJSONUtils_FindPointers(object, sorted, count, pointers);
+    free(sorted);
+
+    return found;
 }
 
 CJSON_PUBLIC(cJSON *) cJSONUtils_GetPointer(cJSON *object, const char *pointer)
@@ -219,581 +350,3390 @@ CJSON_PUBLIC(cJSON *) cJSONUtils_GetPointer(cJSON *object, const char *pointer)
     return object;
 }
 
-/* JSON Patch implementation. */
-static void cJSONUtils_InplaceDecodePointerString(unsigned char *string)
+/* Compiled JSON Pointers: every reference token is decoded once */
+typedef struct cJSONUtils_PointerToken
 {
-    unsigned char *s2 = string;
-
-    if (string == NULL) {
-        return;
-    }
-
-    for (; *string; (void)s2++, string++)
-    {
-        *s2 = (*string != '~')
-            ? (*string)
-            : ((*(++string) == '0')
-                    ? '~'
-                    : '/');
-    }
-
-    *s2 = '\0';
-}
+    /* decoded member name, NULL if the token has an invalid escape sequence */
+    const char *name;
+    /* array index, -1 if the token isn't one */
+    int index;
+} cJSONUtils_PointerToken;
 
-static cJSON *cJSONUtils_PatchDetach(cJSON *object, const unsigned char *path)
+struct cJSONUtils_Pointer
 {
-    unsigned char *parentptr = NULL;
-    unsigned char *childptr = NULL;
-    cJSON *parent = NULL;
-    cJSON *ret = NULL;
-
-    /* copy path and split it in parent and child */
-    parentptr = cJSONUtils_strdup(path);
-    if (parentptr == NULL) {
-        return NULL;
-    }
+    size_t count;
+    /* followed by the decoded names */
+    cJSONUtils_PointerToken tokens[1];
+};
 
-    childptr = (unsigned char*)strrchr((char*)parentptr, '/'); /* last '/' */
-    if (childptr == NULL)
+CJSON_PUBLIC(cJSONUtils_Pointer *) cJSONUtils_CompilePointer(const char *pointer)
+{
+    cJSONUtils_Pointer *compiled = NULL;
+    unsigned char *names = NULL;
+    const unsigned char *token = NULL;
+    size_t count = 0;
+    size_t length = 0;
+    size_t i = 0;
+
+    if (pointer == NULL)
     {
-        free(parentptr);
         return NULL;
     }
-    /* split strings */
-    *childptr++ = '\0';
-
-    parent = cJSONUtils_GetPointer(object, (char*)parentptr);
-    cJSONUtils_InplaceDecodePointerString(childptr);
 
-    if (!parent)
+    /* like cJSONUtils_GetPointer, only the tokens up to the first character other than '/' count */
+    length = (*pointer == '/') ? strlen(pointer) : 0;
+    for (i = 0; i < length; i++)
     {
-        /* Couldn't find object to remove child from. */
-        ret = NULL;
+        if (pointer[i] == '/')
+        {
+            count++;
+        }
     }
-    else if (cJSON_IsArray(parent))
+
+    /* the decoded names are never longer than the pointer */
+    compiled = (cJSONUtils_Pointer*)malloc(sizeof(cJSONUtils_Pointer) + (count * sizeof(cJSONUtils_PointerToken)) + length + 1);
+    if (compiled == NULL)
     {
-        ret = cJSON_DetachItemFromArray(parent, atoi((char*)childptr));
+        return NULL;
     }
-    else if (cJSON_IsObject(parent))
+    compiled->count = count;
+    names = (unsigned char*)&compiled->tokens[count + 1];
+
+    token = (const unsigned char*)pointer;
+    for (i = 0; i < count; i++)
     {
-        ret = cJSON_DetachItemFromObject(parent, (char*)childptr);
-    }
-    free(parentptr);
+        const unsigned char *end = NULL;
+        const unsigned char *digit = NULL;
+        unsigned char *name = names;
+        size_t which = 0;
+        int valid = 1;
+
+        token++; /* skip the '/' */
+        for (end = token; *end && (*end != '/'); end++)
+        {
+        }
 
-    /* return the detachted item */
-    return ret;
-}
+        /* array index, digits only (an empty token is 0, as in cJSONUtils_GetPointer) */
+        for (digit = token; (digit < end) && (*digit >= '0') && (*digit <= '9') && (which <= INT_MAX); digit++)
+        {
+            which = (10 * which) + (size_t)(*digit - '0');
+        }
+        compiled->tokens[i].index = ((digit == end) && (which <= INT_MAX)) ? (int)which : -1;
 
-static int cJSONUtils_Compare(cJSON *a, cJSON *b)
-{
-    if ((a == NULL) || (b == NULL) || ((a->type & 0xFF) != (b->type & 0xFF)))
-    {
-        /* mismatched type. */
-        return -1;
-    }
-    switch (a->type & 0xFF)
-    {
-        case cJSON_Number:
-            /* numeric mismatch. */
-            return ((a->valueint != b->valueint) || (a->valuedouble != b->valuedouble)) ? -2 : 0;
-        case cJSON_String:
-            /* string mismatch. */
-            return (strcmp(a->valuestring, b->valuestring) != 0) ? -3 : 0;
-        case cJSON_Array:
-            for ((void)(a = a->child), b = b->child; a && b; (void)(a = a->next), b = b->next)
+        /* member name, with "~0" for '~' and "~1" for '/' */
+        for (; token < end; token++)
+        {
+            if (*token == '~')
             {
-                int err = cJSONUtils_Compare(a, b);
-                if (err)
+                if ((token[1] != '0') && (token[1] != '1'))
                 {
-                    return err;
+                    valid = 0;
+                    break;
                 }
+                *name++ = (token[1] == '0') ? '~' : '/';
+                token++;
             }
-            /* array size mismatch? (one of both children is not NULL) */
-            return (a || b) ? -4 : 0;
-        case cJSON_Object:
-            cJSONUtils_SortObject(a);
-            cJSONUtils_SortObject(b);
-            a = a->child;
-            b = b->child;
-            while (a && b)
-            {
-                int err = 0;
-                /* compare object keys */
-                if (cJSONUtils_strcasecmp((unsigned char*)a->string, (unsigned char*)b->string))
-                {
-                    /* missing member */
-                    return -6;
-                }
-                err = cJSONUtils_Compare(a, b);
-                if (err)
-                {
-                    return err;
-                }
-                a = a->next;
-                b = b->next;
+            else
+            {
+                *name++ = *token;
             }
-            /* object length mismatch (one of both children is not null) */
-            return (a || b) ? -5 : 0;
-
-        default:
-            break;
+        }
+        *name++ = '\0';
+        compiled->tokens[i].name = valid ? (const char*)names : NULL;
+        names = name;
+        token = end;
     }
-    /* null, true or false */
-    return 0;
+
+    return compiled;
 }
 
-static int cJSONUtils_ApplyPatch(cJSON *object, cJSON *patch)
+static cJSON *cJSONUtils_FollowToken(cJSON *object, const cJSONUtils_PointerToken *token)
 {
-    cJSON *op = NULL;
-    cJSON *path = NULL;
-    cJSON *value = NULL;
-    cJSON *parent = NULL;
-    int opcode = 0;
-    unsigned char *parentptr = NULL;
-    unsigned char *childptr = NULL;
-
-    op = cJSON_GetObjectItem(patch, "op");
-    path = cJSON_GetObjectItem(patch, "path");
-    if (!op || !path)
-    {
-        /* malformed patch. */
-        return 2;
-    }
-
-    /* decode operation */
-    if (!strcmp(op->valuestring, "add"))
+    if (cJSON_IsArray(object))
     {
-        opcode = 0;
+        /* uses the index of the array if it has one */
+        return (token->index >= 0) ? cJSON_GetArrayItem(object, token->index) : NULL;
     }
-    else if (!strcmp(op->valuestring, "remove"))
+    if (cJSON_IsObject(object))
     {
-        opcode = 1;
+        /* same, case insensitive like cJSONUtils_GetPointer */
+        return (token->name != NULL) ? cJSON_GetObjectItem(object, token->name) : NULL;
     }
-    else if (!strcmp(op->valuestring, "replace"))
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSONUtils_EvaluatePointer(cJSON *object, const cJSONUtils_Pointer *pointer)
+{
+    size_t i = 0;
+
+    if (pointer == NULL)
     {
-        opcode = 2;
+        return NULL;
     }
-    else if (!strcmp(op->valuestring, "move"))
+
+    for (i = 0; (i < pointer->count) && (object != NULL); i++)
     {
-        opcode = 3;
+        object = cJSONUtils_FollowToken(object, &pointer->tokens[i]);
     }
-    else if (!strcmp(op->valuestring, "copy"))
+
+    return object;
+}
+
+/* two tokens lead to the same item if their names are the same */
+static int cJSONUtils_CompareTokens(const cJSONUtils_PointerToken *a, const cJSONUtils_PointerToken *b)
+{
+    if ((a->name == NULL) || (b->name == NULL))
     {
-        opcode = 4;
+        return (a->name == NULL) - (b->name == NULL);
     }
-    else if (!strcmp(op->valuestring, "test"))
+
+    return strcmp(a->name, b->name);
+}
+
+typedef struct cJSONUtils_SortedPointer
+{
+    const cJSONUtils_Pointer *pointer;
+    size_t position;
+} cJSONUtils_SortedPointer;
+
+static int cJSONUtils_ComparePointers(const void *a, const void *b)
+{
+    const cJSONUtils_Pointer *first = ((const cJSONUtils_SortedPointer*)a)->pointer;
+    const cJSONUtils_Pointer *second = ((const cJSONUtils_SortedPointer*)b)->pointer;
+    size_t i = 0;
+    int difference = 0;
+
+    for (i = 0; (i < first->count) && (i < second->count); i++)
     {
-        /* compare value: {...} with the given path */
-        return cJSONUtils_Compare(cJSONUtils_GetPointer(object, path->valuestring), cJSON_GetObjectItem(patch, "value"));
+        difference = cJSONUtils_CompareTokens(&first->tokens[i], &second->tokens[i]);
+        if (difference != 0)
+        {
+            return difference;
+        }
     }
-    else
+
+    return (first->count > second->count) - (first->count < second->count);
+}
+
+CJSON_PUBLIC(size_t) cJSONUtils_EvaluatePointers(cJSON *object, const cJSONUtils_Pointer * const *pointers, size_t count, cJSON **results)
+{
+    cJSONUtils_SortedPointer *sorted = NULL;
+    cJSON **path = NULL;
+    const cJSONUtils_Pointer *previous = NULL;
+    size_t resolved = 0;
+    size_t longest = 0;
+    size_t found = 0;
+    size_t valid = 0;
+    size_t i = 0;
+
+    if ((pointers == NULL) || (results == NULL))
     {
-        /* unknown opcode. */
-        return 3;
+        return 0;
     }
 
-    /* Remove/Replace */
-    if ((opcode == 1) || (opcode == 2))
+    for (i = 0; i < count; i++)
     {
-        /* Get rid of old. */
-        cJSON_Delete(cJSONUtils_PatchDetach(object, (unsigned char*)path->valuestring));
-        if (opcode == 1)
+        if ((pointers[i] != NULL) && (pointers[i]->count > longest))
         {
-            /* For Remove, this is job done. */
-            return 0;
+            longest = pointers[i]->count;
         }
     }
 
-    /* Copy/Move uses "from". */
-    if ((opcode == 3) || (opcode == 4))
+    /* sorted by their tokens, pointers with a common prefix follow each other, so they form a trie that is walked
+     * depth first: every pointer starts from the deepest item it shares with the one before */
+    sorted = (cJSONUtils_SortedPointer*)malloc((count * sizeof(cJSONUtils_SortedPointer)) + ((longest + 1) * sizeof(cJSON*)));
+    if (sorted == NULL)
     {
-        cJSON *from = cJSON_GetObjectItem(patch, "from");
-        if (!from)
+        /* one by one still works */
+        for (i = 0; i < count; i++)
         {
-            /* missing "from" for copy/move. */
-            return 4;
+            results[i] = cJSONUtils_EvaluatePointer(object, pointers[i]);
+            found += (results[i] != NULL) ? 1 : 0;
         }
 
-        if (opcode == 3)
-        {
-            /* move */
-            value = cJSONUtils_PatchDetach(object, (unsigned char*)from->valuestring);
-        }
-        if (opcode == 4)
-        {
-            /* copy */
-            value = cJSONUtils_GetPointer(object, from->valuestring);
-        }
-        if (!value)
+        return found;
+    }
+    path = (cJSON**)(void*)&sorted[count];
+
+    /* missing pointers are left out */
+    for (i = 0; i < count; i++)
+    {
+        results[i] = NULL;
+        if (pointers[i] != NULL)
         {
-            /* missing "from" for copy/move. */
-            return 5;
+            sorted[valid].pointer = pointers[i];
+            sorted[valid].position = i;
+            valid++;
         }
-        if (opcode == 4)
+    }
+    qsort(sorted, valid, sizeof(cJSONUtils_SortedPointer), cJSONUtils_ComparePointers);
+
+    path[0] = object;
+    for (i = 0; i < valid; i++)
+    {
+        const cJSONUtils_Pointer *pointer = sorted[i].pointer;
+        size_t depth = 0;
+
+        /* path[0..resolved] are the items of the previous pointer */
+        if (previous != NULL)
         {
-            value = cJSON_Duplicate(value, 1);
+            while ((depth < resolved) && (depth < pointer->count)
+                    && (cJSONUtils_CompareTokens(&pointer->tokens[depth], &previous->tokens[depth]) == 0))
+            {
+                depth++;
+            }
         }
-        if (!value)
+        while ((depth < pointer->count) && (path[depth] != NULL))
         {
-            /* out of memory for copy/move. */
-            return 6;
+            path[depth + 1] = cJSONUtils_FollowToken(path[depth], &pointer->tokens[depth]);
+            depth++;
         }
-    }
-    else /* Add/Replace uses "value". */
-    {
-        value = cJSON_GetObjectItem(patch, "value");
-        if (!value)
+        resolved = depth;
+        if ((depth == pointer->count) && (path[depth] != NULL))
         {
-            /* missing "value" for add/replace. */
-            return 7;
+            results[sorted[i].position] = path[depth];
+            found++;
         }
-        value = cJSON_Duplicate(value, 1);
-        if (!value)
+        else if ((path[depth] == NULL) && (depth > 0))
         {
-            /* out of memory for add/replace. */
-            return 8;
+            /* path[depth] is where this pointer failed, not an item */
+            resolved = depth - 1;
         }
+        previous = pointer;
     }
 
-    /* Now, just add "value" to "path". */
+    free(sorted);
 
-    /* split pointer in parent and child */
-    parentptr = cJSONUtils_strdup((unsigned char*)path->valuestring);
-    childptr = (unsigned char*)strrchr((char*)parentptr, '/');
-    if (childptr)
-    {
-        *childptr++ = '\0';
-    }
-    parent = cJSONUtils_GetPointer(object, (char*)parentptr);
-    cJSONUtils_InplaceDecodePointerString(childptr);
+    return found;
+}
 
-    /* add, remove, replace, move, copy, test. */
-    if (!parent)
+CJSON_PUBLIC(void) cJSONUtils_DeletePointer(cJSONUtils_Pointer *pointer)
+{
+    free(pointer);
+}
+
+/* JSONPath-style queries, compiled into a list of steps that are matched against the children of the items on the way
+ * down, so many queries share one traversal. */
+#define cJSONUtils_QUERY_NAME 0
+#define cJSONUtils_QUERY_INDEX 1
+#define cJSONUtils_QUERY_WILDCARD 2
+#define cJSONUtils_QUERY_FILTER 3
+
+/* comparisons of filters, cJSONUtils_QUERY_EXISTS if there is none */
+#define cJSONUtils_QUERY_EXISTS 0
+#define cJSONUtils_QUERY_EQUAL 1
+#define cJSONUtils_QUERY_NOT_EQUAL 2
+#define cJSONUtils_QUERY_LESS 3
+#define cJSONUtils_QUERY_LESS_EQUAL 4
+#define cJSONUtils_QUERY_GREATER 5
+#define cJSONUtils_QUERY_GREATER_EQUAL 6
+
+/* a member name, or an array index if name is NULL */
+typedef struct cJSONUtils_QueryToken
+{
+    char *name;
+    int index;
+} cJSONUtils_QueryToken;
+
+typedef struct cJSONUtils_QueryStep
+{
+    int type;
+    /* from "..", the step matches at any depth below */
+    int descendant;
+    /* member name (cJSONUtils_QUERY_NAME) */
+    char *name;
+    /* array index (cJSONUtils_QUERY_INDEX) */
+    int index;
+    /* the path from the child to the value that is compared (cJSONUtils_QUERY_FILTER) */
+    cJSONUtils_QueryToken *path;
+    size_t path_count;
+    int comparison;
+    cJSON *value;
+} cJSONUtils_QueryStep;
+
+struct cJSONUtils_Query
+{
+    size_t count;
+    size_t size;
+    cJSONUtils_QueryStep *steps;
+};
+
+static cJSONUtils_QueryStep *cJSONUtils_AddQueryStep(cJSONUtils_Query *query, int type, int descendant)
+{
+    cJSONUtils_QueryStep *step = NULL;
+
+    if (query->count == query->size)
+    {
+        size_t size = (query->size == 0) ? 4 : (2 * query->size);
+        cJSONUtils_QueryStep *steps = (cJSONUtils_QueryStep*)realloc(query->steps, size * sizeof(cJSONUtils_QueryStep));
+        if (steps == NULL)
+        {
+            return NULL;
+        }
+        query->steps = steps;
+        query->size = size;
+    }
+
+    step = &query->steps[query->count++];
+    memset(step, '\0', sizeof(cJSONUtils_QueryStep));
+    step->type = type;
+    step->descendant = descendant;
+    step->index = -1;
+
+    return step;
+}
+
+/* A name up to one of the characters in stop, or quoted with ' or " (a backslash escapes the next character). Returns
+ * a pointer behind it and stores a copy in name, NULL if it is empty or out of memory. */
+static const char *cJSONUtils_QueryName(const char *expression, const char *stop, char **name)
+{
+    const char *end = expression;
+    char quote = '\0';
+    char *copy = NULL;
+    size_t length = 0;
+
+    if ((*expression == '\'') || (*expression == '\"'))
+    {
+        quote = *expression++;
+        for (end = expression; *end && (*end != quote); end++)
+        {
+            if ((*end == '\\') && end[1])
+            {
+                end++;
+            }
+        }
+        if (*end != quote)
+        {
+            return NULL;
+        }
+    }
+    else
+    {
+        for (end = expression; *end && (strchr(stop, *end) == NULL); end++)
+        {
+        }
+        if (end == expression)
+        {
+            return NULL;
+        }
+    }
+
+    copy = (char*)malloc((size_t)(end - expression) + 1);
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+    for (; expression < end; expression++)
+    {
+        if (quote && (*expression == '\\'))
+        {
+            expression++;
+        }
+        copy[length++] = *expression;
+    }
+    copy[length] = '\0';
+    *name = copy;
+
+    return quote ? (end + 1) : end;
+}
+
+/* digits up to a ']' */
+static const char *cJSONUtils_QueryIndex(const char *expression, int *index)
+{
+    size_t which = 0;
+    const char *digit = expression;
+
+    for (; (*digit >= '0') && (*digit <= '9') && (which <= INT_MAX); digit++)
+    {
+        which = (10 * which) + (size_t)(*digit - '0');
+    }
+    if ((digit == expression) || (which > INT_MAX) || (*digit != ']'))
+    {
+        return NULL;
+    }
+    *index = (int)which;
+
+    return digit + 1;
+}
+
+static const char *cJSONUtils_SkipSpaces(const char *expression)
+{
+    while (*expression == ' ')
+    {
+        expression++;
+    }
+
+    return expression;
+}
+
+/* "?(@path)" or "?(@path op value)" behind the '[' of a filter, up to and including the ']' */
+static const char *cJSONUtils_QueryFilter(const char *expression, cJSONUtils_QueryStep *step)
+{
+    static const char *const comparisons[] = { "==", "!=", "<=", ">=", "<", ">" };
+    static const int comparison_types[] = { cJSONUtils_QUERY_EQUAL, cJSONUtils_QUERY_NOT_EQUAL, cJSONUtils_QUERY_LESS_EQUAL, cJSONUtils_QUERY_GREATER_EQUAL, cJSONUtils_QUERY_LESS, cJSONUtils_QUERY_GREATER };
+    const char *pointer = expression;
+    size_t count = 0;
+    size_t i = 0;
+
+    if ((pointer[0] != '?') || (pointer[1] != '(') || (pointer[2] != '@'))
+    {
+        return NULL;
+    }
+
+    /* at most one token per character */
+    step->path = (cJSONUtils_QueryToken*)malloc((strlen(pointer) + 1) * sizeof(cJSONUtils_QueryToken));
+    if (step->path == NULL)
+    {
+        return NULL;
+    }
+    for (pointer += 3; (*pointer == '.') || (*pointer == '['); count++)
+    {
+        char *name = NULL;
+
+        step->path[count].name = NULL;
+        step->path[count].index = -1;
+        if (*pointer == '.')
+        {
+            pointer = cJSONUtils_QueryName(pointer + 1, ".[ )=!<>", &name);
+        }
+        else if ((pointer[1] == '\'') || (pointer[1] == '\"'))
+        {
+            pointer = cJSONUtils_QueryName(pointer + 1, "", &name);
+            pointer = ((pointer != NULL) && (*pointer == ']')) ? (pointer + 1) : NULL;
+        }
+        else
+        {
+            pointer = cJSONUtils_QueryIndex(pointer + 1, &step->path[count].index);
+        }
+        step->path[count].name = name;
+        step->path_count = count + 1;
+        if (pointer == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    pointer = cJSONUtils_SkipSpaces(pointer);
+    for (i = 0; (i < sizeof(comparisons) / sizeof(comparisons[0])) && (step->comparison == cJSONUtils_QUERY_EXISTS); i++)
+    {
+        if (strncmp(pointer, comparisons[i], strlen(comparisons[i])) == 0)
+        {
+            step->comparison = comparison_types[i];
+            pointer = cJSONUtils_SkipSpaces(pointer + strlen(comparisons[i]));
+        }
+    }
+    if (step->comparison != cJSONUtils_QUERY_EXISTS)
+    {
+        if (*pointer == '\'')
+        {
+            /* a string in single quotes */
+            char *text = NULL;
+            pointer = cJSONUtils_QueryName(pointer, "", &text);
+            if (pointer == NULL)
+            {
+                return NULL;
+            }
+            step->value = cJSON_CreateString(text);
+            free(text);
+        }
+        else
+        {
+            /* any JSON value */
+            step->value = cJSON_ParseWithOpts(pointer, &pointer, 0);
+        }
+        if (step->value == NULL)
+        {
+            return NULL;
+        }
+        pointer = cJSONUtils_SkipSpaces(pointer);
+    }
+
+    if ((pointer[0] != ')') || (pointer[1] != ']'))
+    {
+        return NULL;
+    }
+
+    return pointer + 2;
+}
+
+CJSON_PUBLIC(cJSONUtils_Query *) cJSONUtils_CompileQuery(const char *expression)
+{
+    cJSONUtils_Query *query = NULL;
+    cJSONUtils_QueryStep *step = NULL;
+
+    if ((expression == NULL) || (*expression != '$'))
+    {
+        return NULL;
+    }
+    query = (cJSONUtils_Query*)malloc(sizeof(cJSONUtils_Query));
+    if (query == NULL)
+    {
+        return NULL;
+    }
+    memset(query, '\0', sizeof(cJSONUtils_Query));
+
+    expression++;
+    while (*expression)
+    {
+        int descendant = 0;
+
+        if ((expression[0] == '.') && (expression[1] == '.'))
+        {
+            descendant = 1;
+            expression += 2;
+        }
+        else if (expression[0] == '.')
+        {
+            expression++;
+        }
+        else if (expression[0] != '[')
+        {
+            goto fail;
+        }
+
+        if ((expression[0] == '*') || ((expression[0] == '[') && (expression[1] == '*') && (expression[2] == ']')))
+        {
+            step = cJSONUtils_AddQueryStep(query, cJSONUtils_QUERY_WILDCARD, descendant);
+            expression += (expression[0] == '*') ? 1 : 3;
+        }
+        else if ((expression[0] == '[') && (expression[1] == '?'))
+        {
+            step = cJSONUtils_AddQueryStep(query, cJSONUtils_QUERY_FILTER, descendant);
+            expression = (step != NULL) ? cJSONUtils_QueryFilter(expression + 1, step) : NULL;
+        }
+        else if ((expression[0] == '[') && ((expression[1] == '\'') || (expression[1] == '\"')))
+        {
+            step = cJSONUtils_AddQueryStep(query, cJSONUtils_QUERY_NAME, descendant);
+            expression = (step != NULL) ? cJSONUtils_QueryName(expression + 1, "", &step->name) : NULL;
+            expression = ((expression != NULL) && (*expression == ']')) ? (expression + 1) : NULL;
+        }
+        else if (expression[0] == '[')
+        {
+            step = cJSONUtils_AddQueryStep(query, cJSONUtils_QUERY_INDEX, descendant);
+            expression = (step != NULL) ? cJSONUtils_QueryIndex(expression + 1, &step->index) : NULL;
+        }
+        else
+        {
+            step = cJSONUtils_AddQueryStep(query, cJSONUtils_QUERY_NAME, descendant);
+            expression = (step != NULL) ? cJSONUtils_QueryName(expression, ".[", &step->name) : NULL;
+        }
+        if (expression == NULL)
+        {
+            goto fail;
+        }
+    }
+
+    return query;
+
+fail:
+    cJSONUtils_DeleteQuery(query);
+
+    return NULL;
+}
+
+CJSON_PUBLIC(void) cJSONUtils_DeleteQuery(cJSONUtils_Query *query)
+{
+    size_t i = 0;
+    size_t j = 0;
+
+    if (query == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < query->count; i++)
+    {
+        free(query->steps[i].name);
+        for (j = 0; j < query->steps[i].path_count; j++)
+        {
+            free(query->steps[i].path[j].name);
+        }
+        free(query->steps[i].path);
+        cJSON_Delete(query->steps[i].value);
+    }
+    free(query->steps);
+    free(query);
+}
+
+/* Whether child passes the filter of step. */
+static int cJSONUtils_QueryPasses(const cJSONUtils_QueryStep *step, cJSON *child)
+{
+    size_t i = 0;
+    int difference = 0;
+
+    for (i = 0; (i < step->path_count) && (child != NULL); i++)
+    {
+        if (cJSON_IsArray(child))
+        {
+            child = (step->path[i].index >= 0) ? cJSON_GetArrayItem(child, step->path[i].index) : NULL;
+        }
+        else
+        {
+            child = (cJSON_IsObject(child) && (step->path[i].name != NULL)) ? cJSON_GetObjectItemCaseSensitive(child, step->path[i].name) : NULL;
+        }
+    }
+    if (child == NULL)
+    {
+        return 0;
+    }
+
+    switch (step->comparison)
+    {
+        case cJSONUtils_QUERY_EXISTS:
+            return 1;
+        case cJSONUtils_QUERY_EQUAL:
+            return cJSON_Compare(child, step->value, 1);
+        case cJSONUtils_QUERY_NOT_EQUAL:
+            return !cJSON_Compare(child, step->value, 1);
+        default:
+            break;
+    }
+
+    /* orderings only compare numbers with numbers and strings with strings */
+    if (cJSON_IsNumber(child) && cJSON_IsNumber(step->value))
+    {
+        difference = (cJSON_GetNumberValue(child) > cJSON_GetNumberValue(step->value)) - (cJSON_GetNumberValue(child) < cJSON_GetNumberValue(step->value));
+    }
+    else if (cJSON_IsString(child) && cJSON_IsString(step->value))
+    {
+        difference = strcmp(child->valuestring, step->value->valuestring);
+    }
+    else
+    {
+        return 0;
+    }
+
+    switch (step->comparison)
+    {
+        case cJSONUtils_QUERY_LESS:
+            return difference < 0;
+        case cJSONUtils_QUERY_LESS_EQUAL:
+            return difference <= 0;
+        case cJSONUtils_QUERY_GREATER:
+            return difference > 0;
+        default:
+            return difference >= 0;
+    }
+}
+
+/* Whether step leads from parent to child, the child at position in parent. */
+static int cJSONUtils_QueryStepMatches(const cJSONUtils_QueryStep *step, const cJSON *parent, cJSON *child, int position)
+{
+    switch (step->type)
+    {
+        case cJSONUtils_QUERY_NAME:
+            return cJSON_IsObject(parent) && (child->string != NULL) && (strcmp(child->string, step->name) == 0);
+        case cJSONUtils_QUERY_INDEX:
+            return cJSON_IsArray(parent) && (position == step->index);
+        case cJSONUtils_QUERY_WILDCARD:
+            return 1;
+        default:
+            return cJSONUtils_QueryPasses(step, child);
+    }
+}
+
+/* the next step of a query at an item */
+typedef struct cJSONUtils_QueryState
+{
+    size_t query;
+    size_t step;
+} cJSONUtils_QueryState;
+
+/* a child that is looked up instead of scanned, and its position for index steps */
+typedef struct cJSONUtils_QueryTarget
+{
+    cJSON *item;
+    int position;
+} cJSONUtils_QueryTarget;
+
+typedef struct cJSONUtils_QueryFrame
+{
+    cJSON *item;
+    /* the states of item are states[first_state] up to the first state of the next frame */
+    size_t first_state;
+    size_t state_count;
+    /* the next child to scan, or targets[target] up to target_end if they are looked up */
+    cJSON *next;
+    int position;
+    size_t first_target;
+    size_t target;
+    size_t target_end;
+} cJSONUtils_QueryFrame;
+
+typedef struct cJSONUtils_QueryWalk
+{
+    const cJSONUtils_Query * const *queries;
+    cJSONUtils_QueryCallback callback;
+    void *context;
+    cJSONUtils_QueryState *states;
+    size_t state_count;
+    size_t state_size;
+    cJSONUtils_QueryTarget *targets;
+    size_t target_count;
+    size_t target_size;
+    cJSONUtils_QueryFrame *frames;
+    size_t depth;
+    size_t frame_size;
+    size_t matches;
+} cJSONUtils_QueryWalk;
+
+/* Makes room for one more element in *buffer, with size elements of element_size. */
+static int cJSONUtils_QueryReserve(void **buffer, size_t *size, size_t count, size_t element_size)
+{
+    void *grown = NULL;
+
+    if (count < *size)
+    {
+        return 1;
+    }
+    grown = realloc(*buffer, ((*size == 0) ? 16 : (2 * *size)) * element_size);
+    if (grown == NULL)
+    {
+        return 0;
+    }
+    *buffer = grown;
+    *size = (*size == 0) ? 16 : (2 * *size);
+
+    return 1;
+}
+
+/* Adds a state for the item on top, unless it has it already. */
+static int cJSONUtils_QueryAddState(cJSONUtils_QueryWalk *walk, size_t first, size_t query, size_t step)
+{
+    size_t i = 0;
+
+    for (i = first; i < walk->state_count; i++)
+    {
+        if ((walk->states[i].query == query) && (walk->states[i].step == step))
+        {
+            return 1;
+        }
+    }
+    if (!cJSONUtils_QueryReserve((void**)&walk->states, &walk->state_size, walk->state_count, sizeof(cJSONUtils_QueryState)))
+    {
+        return 0;
+    }
+    walk->states[walk->state_count].query = query;
+    walk->states[walk->state_count].step = step;
+    walk->state_count++;
+
+    return 1;
+}
+
+/* Whether the states of frame only need single children that can be looked up through the index of the item. */
+static int cJSONUtils_QueryCanLookUp(const cJSONUtils_QueryWalk *walk, const cJSONUtils_QueryFrame *frame)
+{
+    size_t i = 0;
+
+    if (!(frame->item->type & cJSON_IsIndexed))
+    {
+        return 0;
+    }
+    for (i = frame->first_state; i < (frame->first_state + frame->state_count); i++)
+    {
+        const cJSONUtils_Query *query = walk->queries[walk->states[i].query];
+        const cJSONUtils_QueryStep *step = NULL;
+
+        if (walk->states[i].step == query->count)
+        {
+            continue;
+        }
+        step = &query->steps[walk->states[i].step];
+        if (step->descendant || ((step->type != cJSONUtils_QUERY_NAME) && (step->type != cJSONUtils_QUERY_INDEX)))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* Pushes a frame for item, whose states were just added, and reports the queries that end at it. */
+static int cJSONUtils_QueryEnter(cJSONUtils_QueryWalk *walk, cJSON *item, size_t first_state)
+{
+    cJSONUtils_QueryFrame *frame = NULL;
+    size_t open = 0;
+    size_t i = 0;
+
+    if (!cJSONUtils_QueryReserve((void**)&walk->frames, &walk->frame_size, walk->depth, sizeof(cJSONUtils_QueryFrame)))
+    {
+        return 0;
+    }
+    frame = &walk->frames[walk->depth++];
+    memset(frame, '\0', sizeof(cJSONUtils_QueryFrame));
+    frame->item = item;
+    frame->first_state = first_state;
+    frame->state_count = walk->state_count - first_state;
+    frame->first_target = walk->target_count;
+    frame->target = walk->target_count;
+    frame->target_end = walk->target_count;
+
+    for (i = first_state; i < walk->state_count; i++)
+    {
+        if (walk->states[i].step < walk->queries[walk->states[i].query]->count)
+        {
+            open++;
+            continue;
+        }
+        walk->matches++;
+        if ((walk->callback != NULL) && !walk->callback(walk->states[i].query, item, walk->context))
+        {
+            return 0;
+        }
+    }
+    if ((open == 0) || (item->child == NULL))
+    {
+        /* nothing below item can match */
+        return 1;
+    }
+
+    if (!cJSONUtils_QueryCanLookUp(walk, frame))
+    {
+        frame->next = item->child;
+        return 1;
+    }
+    for (i = first_state; i < walk->state_count; i++)
+    {
+        const cJSONUtils_Query *query = walk->queries[walk->states[i].query];
+        const cJSONUtils_QueryStep *step = NULL;
+        cJSON *target = NULL;
+        size_t j = 0;
+
+        if (walk->states[i].step == query->count)
+        {
+            continue;
+        }
+        step = &query->steps[walk->states[i].step];
+        if (step->type == cJSONUtils_QUERY_NAME)
+        {
+            target = cJSON_IsObject(item) ? cJSON_GetObjectItemCaseSensitive(item, step->name) : NULL;
+        }
+        else
+        {
+            target = cJSON_IsArray(item) ? cJSON_GetArrayItem(item, step->index) : NULL;
+        }
+        for (j = frame->target; (j < walk->target_count) && (target != NULL); j++)
+        {
+            if (walk->targets[j].item == target)
+            {
+                target = NULL;
+            }
+        }
+        if (target == NULL)
+        {
+            continue;
+        }
+        if (!cJSONUtils_QueryReserve((void**)&walk->targets, &walk->target_size, walk->target_count, sizeof(cJSONUtils_QueryTarget)))
+        {
+            return 0;
+        }
+        walk->targets[walk->target_count].item = target;
+        walk->targets[walk->target_count].position = step->index;
+        walk->target_count++;
+    }
+    frame->target_end = walk->target_count;
+
+    return 1;
+}
+
+static int cJSONUtils_QueryWalkTree(cJSONUtils_QueryWalk *walk, cJSON *object, size_t count)
+{
+    size_t i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        if ((walk->queries[i] != NULL) && !cJSONUtils_QueryAddState(walk, 0, i, 0))
+        {
+            return 0;
+        }
+    }
+    if (walk->state_count == 0)
+    {
+        return 1;
+    }
+    if (!cJSONUtils_QueryEnter(walk, object, 0))
+    {
+        return 0;
+    }
+
+    while (walk->depth > 0)
+    {
+        cJSONUtils_QueryFrame *frame = &walk->frames[walk->depth - 1];
+        cJSON *child = NULL;
+        int position = 0;
+        size_t first = walk->state_count;
+
+        if (frame->next != NULL)
+        {
+            child = frame->next;
+            position = frame->position++;
+            frame->next = child->next;
+        }
+        else if (frame->target < frame->target_end)
+        {
+            child = walk->targets[frame->target].item;
+            position = walk->targets[frame->target].position;
+            frame->target++;
+        }
+        else
+        {
+            /* all children are done */
+            walk->state_count = frame->first_state;
+            walk->target_count = frame->first_target;
+            walk->depth--;
+            continue;
+        }
+
+        for (i = frame->first_state; i < (frame->first_state + frame->state_count); i++)
+        {
+            const cJSONUtils_QueryState state = walk->states[i];
+            const cJSONUtils_Query *query = walk->queries[state.query];
+            const cJSONUtils_QueryStep *step = NULL;
+
+            if (state.step == query->count)
+            {
+                continue;
+            }
+            step = &query->steps[state.step];
+            if (cJSONUtils_QueryStepMatches(step, frame->item, child, position)
+                    && !cJSONUtils_QueryAddState(walk, first, state.query, state.step + 1))
+            {
+                return 0;
+            }
+            /* ".." keeps looking further down */
+            if (step->descendant && !cJSONUtils_QueryAddState(walk, first, state.query, state.step))
+            {
+                return 0;
+            }
+        }
+        if ((walk->state_count > first) && !cJSONUtils_QueryEnter(walk, child, first))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+CJSON_PUBLIC(size_t) cJSONUtils_EvaluateQueries(cJSON *object, const cJSONUtils_Query * const *queries, size_t count, cJSONUtils_QueryCallback callback, void *context)
+{
+    cJSONUtils_QueryWalk walk;
+
+    if ((object == NULL) || (queries == NULL))
+    {
+        return 0;
+    }
+
+    memset(&walk, '\0', sizeof(walk));
+    walk.queries = queries;
+    walk.callback = callback;
+    walk.context = context;
+    cJSONUtils_QueryWalkTree(&walk, object, count);
+
+    free(walk.states);
+    free(walk.targets);
+    free(walk.frames);
+
+    return walk.matches;
+}
+
+static cJSON_bool cJSONUtils_CollectMatch(size_t query, cJSON *match, void *context)
+{
+    (void)query;
+    cJSON_AddItemReferenceToArray((cJSON*)context, match);
+
+    return 1;
+}
+
+CJSON_PUBLIC(cJSON *) cJSONUtils_EvaluateQuery(cJSON *object, const cJSONUtils_Query *query)
+{
+    cJSON *matches = NULL;
+
+    if ((object == NULL) || (query == NULL))
+    {
+        return NULL;
+    }
+    matches = cJSON_CreateArray();
+    if (matches == NULL)
+    {
+        return NULL;
+    }
+    cJSONUtils_EvaluateQueries(object, &query, 1, cJSONUtils_CollectMatch, matches);
+
+    return matches;
+}
+
+/* JSON Patch implementation. */
+/* a change made while applying patches, undone if one of them fails */
+typedef struct cJSONUtils_Change
+{
+    cJSON *parent;
+    cJSON *item;
+    /* position of item in the children of parent */
+    size_t position;
+    /* item was inserted, otherwise detached */
+    int inserted;
+    /* inserted items are deleted when the change is undone, detached ones when all patches were applied */
+    int owned;
+} cJSONUtils_Change;
+
+typedef struct cJSONUtils_Patcher
+{
+    cJSON *object;
+    cJSONUtils_Change *changes;
+    size_t count;
+    size_t size;
+    /* the last resolved pointer: items[i] is reached by its first i tokens, which end at ends[i]. Patches only change
+     * the children of the last resolved item, so the ones on the way to it stay valid. */
+    unsigned char *path;
+    cJSON **items;
+    size_t *ends;
+    /* items[0..depth] are still valid */
+    size_t depth;
+    /* decoded name of the child of the last resolved parent */
+    unsigned char *name;
+    /* longest pointer that fits */
+    size_t capacity;
+} cJSONUtils_Patcher;
+
+/* make room for an operation on pointers of up to length bytes */
+static int cJSONUtils_PatcherReserve(cJSONUtils_Patcher *patcher, size_t length)
+{
+    void *grown = NULL;
+
+    /* an operation detaches and inserts up to three items */
+    if ((patcher->count + 3) > patcher->size)
+    {
+        size_t size = (patcher->size == 0) ? 16 : (2 * patcher->size);
+        grown = realloc(patcher->changes, size * sizeof(cJSONUtils_Change));
+        if (grown == NULL)
+        {
+            return 0;
+        }
+        patcher->changes = (cJSONUtils_Change*)grown;
+        patcher->size = size;
+    }
+
+    if ((patcher->items != NULL) && (length <= patcher->capacity))
+    {
+        return 1;
+    }
+    if ((grown = realloc(patcher->path, length + 1)) == NULL)
+    {
+        return 0;
+    }
+    patcher->path = (unsigned char*)grown;
+    if ((grown = realloc(patcher->name, length + 1)) == NULL)
+    {
+        return 0;
+    }
+    patcher->name = (unsigned char*)grown;
+    if ((grown = realloc(patcher->items, (length + 2) * sizeof(cJSON*))) == NULL)
+    {
+        return 0;
+    }
+    patcher->items = (cJSON**)grown;
+    if ((grown = realloc(patcher->ends, (length + 2) * sizeof(size_t))) == NULL)
+    {
+        return 0;
+    }
+    patcher->ends = (size_t*)grown;
+    if (patcher->capacity == 0)
+    {
+        patcher->depth = 0;
+        patcher->ends[0] = 0;
+    }
+    patcher->capacity = length;
+
+    return 1;
+}
+
+/* Resolve the first length bytes of pointer like cJSONUtils_GetPointer, starting at the deepest item the previously
+ * resolved pointer has in common with it. Sets depth to the number of tokens that were followed. */
+static cJSON *cJSONUtils_PatcherResolve(cJSONUtils_Patcher *patcher, const unsigned char *pointer, size_t length, size_t *depth)
+{
+    size_t common = 0;
+    size_t offset = 0;
+    cJSON *item = NULL;
+
+    /* tokens the same as the ones of the previous pointer */
+    while (common < patcher->depth)
+    {
+        size_t start = patcher->ends[common];
+        size_t end = patcher->ends[common + 1];
+        if ((end > length) || ((end < length) && (pointer[end] != '/')) || memcmp(pointer + start, patcher->path + start, end - start))
+        {
+            break;
+        }
+        common++;
+    }
+
+    patcher->items[0] = patcher->object;
+    offset = patcher->ends[common];
+    memcpy(patcher->path + offset, pointer + offset, length - offset);
+    item = patcher->items[common];
+    while ((offset < length) && (pointer[offset] == '/') && item)
+    {
+        const unsigned char *token = pointer + ++offset;
+        for (; (offset < length) && (pointer[offset] != '/'); offset++)
+        {
+        }
+
+        if (cJSON_IsArray(item))
+        {
+            size_t which = 0;
+            /* parse array index */
+            for (; (token < (pointer + offset)) && (*token >= '0') && (*token <= '9'); token++)
+            {
+                which = (10 * which) + (size_t)(*token - '0');
+            }
+            /* the whole token has to be the index */
+            item = ((token == (pointer + offset)) && (which <= INT_MAX)) ? cJSON_GetArrayItem(item, (int)which) : NULL;
+        }
+        else if (cJSON_IsObject(item))
+        {
+            /* GetObjectItem, the token ends with the next '/' or the end of the string */
+            for (item = item->child; item && cJSONUtils_Pstrcasecmp((unsigned char*)item->string, token); item = item->next)
+            {
+            }
+        }
+        else
+        {
+            item = NULL;
+        }
+
+        if (item != NULL)
+        {
+            common++;
+            patcher->items[common] = item;
+            patcher->ends[common] = offset;
+        }
+    }
+
+    patcher->depth = common;
+    *depth = common;
+
+    return item;
+}
+
+/* Resolve the parent of the item the pointer points to and decode the name of the item into patcher->name */
+static cJSON *cJSONUtils_PatcherParent(cJSONUtils_Patcher *patcher, const unsigned char *pointer, size_t *depth)
+{
+    const unsigned char *child = (const unsigned char*)strrchr((const char*)pointer, '/');
+    unsigned char *name = patcher->name;
+
+    if (child == NULL)
+    {
+        return NULL;
+    }
+
+    /* decode ~0 and ~1 */
+    for (child++; *child; child++)
+    {
+        if (*child != '~')
+        {
+            *name++ = *child;
+        }
+        else if (child[1] != '\0')
+        {
+            child++;
+            *name++ = (*child == '0') ? '~' : '/';
+        }
+    }
+    *name = '\0';
+
+    return cJSONUtils_PatcherResolve(patcher, pointer, (size_t)(strrchr((const char*)pointer, '/') - (const char*)pointer), depth);
+}
+
+static void cJSONUtils_PatcherRecord(cJSONUtils_Patcher *patcher, cJSON *parent, cJSON *item, size_t position, int inserted)
+{
+    cJSONUtils_Change *change = &patcher->changes[patcher->count++];
+    change->parent = parent;
+    change->item = item;
+    change->position = position;
+    change->inserted = inserted;
+    change->owned = 1;
+}
+
+/* position of an item in its parent */
+static size_t cJSONUtils_Position(const cJSON *parent, const cJSON *item)
+{
+    size_t position = 0;
+    for (parent = parent->child; parent && (parent != item); parent = parent->next)
+    {
+        position++;
+    }
+
+    return position;
+}
+
+static cJSON *cJSONUtils_PatcherDetach(cJSONUtils_Patcher *patcher, cJSON *parent, const char *name)
+{
+    cJSON *item = NULL;
+    size_t position = 0;
+
+    if (cJSON_IsArray(parent))
+    {
+        int which = atoi(name);
+        item = cJSON_DetachItemFromArray(parent, which);
+        position = (size_t)which;
+    }
+    else if (cJSON_IsObject(parent))
+    {
+        item = cJSON_GetObjectItem(parent, name);
+        if (item != NULL)
+        {
+            position = cJSONUtils_Position(parent, item);
+            cJSON_DetachItemViaPointer(parent, item);
+        }
+    }
+    if (item != NULL)
+    {
+        cJSONUtils_PatcherRecord(patcher, parent, item, position, 0);
+    }
+
+    return item;
+}
+
+/* undo all changes on failure, otherwise delete what was removed */
+static void cJSONUtils_PatcherFinish(cJSONUtils_Patcher *patcher, int failed)
+{
+    while (patcher->count > 0)
+    {
+        cJSONUtils_Change *change = &patcher->changes[--patcher->count];
+        if (failed && change->inserted)
+        {
+            cJSON_DetachItemFromArray(change->parent, (int)change->position);
+            if (change->owned)
+            {
+                cJSON_Delete(change->item);
+            }
+        }
+        else if (failed)
+        {
+            cJSON_InsertItemInArray(change->parent, (int)change->position, change->item);
+        }
+        else if (!change->inserted && change->owned)
+        {
+            cJSON_Delete(change->item);
+        }
+    }
+
+    free(patcher->changes);
+    free(patcher->path);
+    free(patcher->name);
+    free(patcher->items);
+    free(patcher->ends);
+}
+
+static int cJSONUtils_Compare(cJSON *a, cJSON *b)
+{
+    if ((a == NULL) || (b == NULL) || ((a->type & 0xFF) != (b->type & 0xFF)))
+    {
+        /* mismatched type. */
+        return -1;
+    }
+    switch (a->type & 0xFF)
+    {
+        case cJSON_Number:
+            /* numeric mismatch. */
+            return (cJSON_GetNumberValue(a) != cJSON_GetNumberValue(b)) ? -2 : 0;
+        case cJSON_String:
+            /* string mismatch. */
+            {
+                const char *value_a = cJSON_GetStringValue(a);
+                const char *value_b = cJSON_GetStringValue(b);
+                return ((value_a == NULL) || (value_b == NULL) || (strcmp(value_a, value_b) != 0)) ? -3 : 0;
+            }
+        case cJSON_Array:
+            for ((void)(a = a->child), b = b->child; a && b; (void)(a = a->next), b = b->next)
+            {
+                int err = cJSONUtils_Compare(a, b);
+                if (err)
+                {
+                    return err;
+                }
+            }
+            /* array size mismatch? (one of both children is not NULL) */
+            return (a || b) ? -4 : 0;
+        case cJSON_Object:
+            /* doesn't sort the objects, the order of the members doesn't matter */
+            return cJSON_Compare(a, b, 0) ? 0 : -5;
+
+        default:
+            break;
+    }
+    /* null, true or false */
+    return 0;
+}
+
+static int cJSONUtils_ApplyPatch(cJSONUtils_Patcher *patcher, cJSON *patch)
+{
+    cJSON *op = NULL;
+    cJSON *path = NULL;
+    cJSON *from = NULL;
+    cJSON *value = NULL;
+    cJSON *parent = NULL;
+    size_t depth = 0;
+    size_t length = 0;
+    /* change that detached the value of a move */
+    cJSONUtils_Change *moved = NULL;
+    int opcode = 0;
+
+    op = cJSON_GetObjectItem(patch, "op");
+    path = cJSON_GetObjectItem(patch, "path");
+    if (!op || !path)
+    {
+        /* malformed patch. */
+        return 2;
+    }
+
+    /* decode operation */
+    if (!strcmp(op->valuestring, "add"))
+    {
+        opcode = 0;
+    }
+    else if (!strcmp(op->valuestring, "remove"))
+    {
+        opcode = 1;
+    }
+    else if (!strcmp(op->valuestring, "replace"))
+    {
+        opcode = 2;
+    }
+    else if (!strcmp(op->valuestring, "move"))
+    {
+        opcode = 3;
+    }
+    else if (!strcmp(op->valuestring, "copy"))
+    {
+        opcode = 4;
+    }
+    else if (!strcmp(op->valuestring, "test"))
+    {
+        opcode = 5;
+    }
+    else
+    {
+        /* unknown opcode. */
+        return 3;
+    }
+
+    /* Copy/Move uses "from". */
+    if ((opcode == 3) || (opcode == 4))
+    {
+        from = cJSON_GetObjectItem(patch, "from");
+        if (!from)
+        {
+            /* missing "from" for copy/move. */
+            return 4;
+        }
+        length = strlen(from->valuestring);
+    }
+    if (strlen(path->valuestring) > length)
+    {
+        length = strlen(path->valuestring);
+    }
+    if (!cJSONUtils_PatcherReserve(patcher, length))
+    {
+        /* out of memory */
+        return ((opcode == 3) || (opcode == 4)) ? 6 : 8;
+    }
+
+    if (opcode == 5)
+    {
+        /* compare value: {...} with the given path */
+        return cJSONUtils_Compare(cJSONUtils_PatcherResolve(patcher, (unsigned char*)path->valuestring, strlen(path->valuestring), &depth), cJSON_GetObjectItem(patch, "value"));
+    }
+
+    /* Remove/Replace */
+    if ((opcode == 1) || (opcode == 2))
+    {
+        /* Get rid of old. */
+        parent = cJSONUtils_PatcherParent(patcher, (unsigned char*)path->valuestring, &depth);
+        if (parent)
+        {
+            cJSONUtils_PatcherDetach(patcher, parent, (char*)patcher->name);
+        }
+        if (opcode == 1)
+        {
+            /* For Remove, this is job done. */
+            return 0;
+        }
+    }
+
+    if (opcode == 3)
+    {
+        /* move */
+        parent = cJSONUtils_PatcherParent(patcher, (unsigned char*)from->valuestring, &depth);
+        value = parent ? cJSONUtils_PatcherDetach(patcher, parent, (char*)patcher->name) : NULL;
+        if (!value)
+        {
+            /* missing "from" for copy/move. */
+            return 5;
+        }
+        moved = &patcher->changes[patcher->count - 1];
+    }
+    else if (opcode == 4)
+    {
+        /* copy */
+        value = cJSONUtils_PatcherResolve(patcher, (unsigned char*)from->valuestring, strlen(from->valuestring), &depth);
+        if (!value)
+        {
+            /* missing "from" for copy/move. */
+            return 5;
+        }
+        value = cJSON_Duplicate(value, 1);
+        if (!value)
+        {
+            /* out of memory for copy/move. */
+            return 6;
+        }
+    }
+    else /* Add/Replace uses "value". */
+    {
+        value = cJSON_GetObjectItem(patch, "value");
+        if (!value)
+        {
+            /* missing "value" for add/replace. */
+            return 7;
+        }
+        value = cJSON_Duplicate(value, 1);
+        if (!value)
+        {
+            /* out of memory for add/replace. */
+            return 8;
+        }
+    }
+
+    /* Now, just add "value" to "path". */
+    parent = cJSONUtils_PatcherParent(patcher, (unsigned char*)path->valuestring, &depth);
+
+    /* add, remove, replace, move, copy, test. */
+    if (!parent)
+    {
+        /* Couldn't find object to add to. A moved item is put back with the other changes. */
+        if (!moved)
+        {
+            cJSON_Delete(value);
+        }
+        return 9;
+    }
+    else if (cJSON_IsArray(parent))
+    {
+        size_t size = (size_t)cJSON_GetArraySize(parent);
+        size_t position = size;
+        if (!strcmp((char*)patcher->name, "-"))
+        {
+            cJSON_AddItemToArray(parent, value);
+        }
+        else
+        {
+            int which = atoi((char*)patcher->name);
+            position = (which < 0) ? 0 : (((size_t)which < size) ? (size_t)which : size);
+            cJSON_InsertItemInArray(parent, which, value);
+        }
+        cJSONUtils_PatcherRecord(patcher, parent, value, position, 1);
+    }
+    else if (cJSON_IsObject(parent))
+    {
+        cJSONUtils_PatcherDetach(patcher, parent, (char*)patcher->name);
+        cJSON_AddItemToObject(parent, (char*)patcher->name, value);
+        cJSONUtils_PatcherRecord(patcher, parent, value, (size_t)cJSON_GetArraySize(parent) - 1, 1);
+    }
+    else
+    {
+        if (!moved)
+        {
+            cJSON_Delete(value);
+        }
+        return 0;
+    }
+    if (moved)
+    {
+        /* the moved item is owned by its new parent */
+        moved->owned = 0;
+        patcher->changes[patcher->count - 1].owned = 0;
+    }
+
+    return 0;
+}
+
+CJSON_PUBLIC(int) cJSONUtils_ApplyPatches(cJSON *object, cJSON *patches)
+{
+    cJSONUtils_Patcher patcher;
+    int err = 0;
+
+    if (!cJSON_IsArray(patches))
+    {
+        /* malformed patches. */
+        return 1;
+    }
+
+    memset(&patcher, 0, sizeof(patcher));
+    patcher.object = object;
+    for (patches = patches->child; patches; patches = patches->next)
+    {
+        if ((err = cJSONUtils_ApplyPatch(&patcher, patches)))
+        {
+            break;
+        }
+    }
+    cJSONUtils_PatcherFinish(&patcher, err != 0);
+
+    return err;
+}
+
+/* Streaming patches: only the parts of the text the patches need are parsed into a skeleton of the document, everything
+ * else is kept as a placeholder that refers to its text. The patches are applied to the skeleton, which is printed by
+ * copying the text of the placeholders. */
+typedef struct cJSONUtils_StreamNeed
+{
+    /* path or from of a patch */
+    const char *pointer;
+    /* offset of the next token while the skeleton is built */
+    size_t cursor;
+    int flags;
+} cJSONUtils_StreamNeed;
+
+/* the item is compared or copied, so it has to be parsed completely */
+#define cJSONUtils_NeedsValue 1
+/* the patch adds or removes a child of the parent, which moves the array elements after it */
+#define cJSONUtils_NeedsMembership 2
+
+typedef struct cJSONUtils_StreamRange
+{
+    const char *start;
+    const char *end;
+} cJSONUtils_StreamRange;
+
+typedef struct cJSONUtils_Stream
+{
+    const char *end;
+    cJSONUtils_StreamNeed *needs;
+    /* needs that are followed, partitioned by the child they lead to */
+    size_t *order;
+    /* text of the placeholders, an object member includes its name */
+    cJSONUtils_StreamRange *ranges;
+    size_t range_count;
+    size_t range_size;
+    /* arrays and objects of the skeleton that contain placeholders */
+    cJSON **containers;
+    size_t container_count;
+    size_t container_size;
+    /* decoded name of the current member */
+    unsigned char *key;
+    size_t key_size;
+    /* for printing */
+    cJSON_WriteFunction writer;
+    void *context;
+} cJSONUtils_Stream;
+
+/* placeholders are raw references to this string, with the index of their range in valueint */
+static char cJSONUtils_Placeholder[] = "";
+
+static const char *cJSONUtils_SkipWhitespace(const char *pointer, const char *end)
+{
+    while ((pointer < end) && ((*pointer == ' ') || (*pointer == '\t') || (*pointer == '\n') || (*pointer == '\r')))
+    {
+        pointer++;
+    }
+
+    return pointer;
+}
+
+/* pointer is at the opening quote, returns the end of the string or NULL */
+static const char *cJSONUtils_SkipString(const char *pointer, const char *end)
+{
+    for (pointer++; pointer < end; pointer++)
+    {
+        if (*pointer == '\\')
+        {
+            pointer++;
+        }
+        else if (*pointer == '\"')
+        {
+            return pointer + 1;
+        }
+    }
+
+    return NULL;
+}
+
+/* Returns the end of the value at pointer or NULL. Only the nesting is checked, not the JSON in between. */
+static const char *cJSONUtils_SkipValue(const char *pointer, const char *end)
+{
+    const char *start = pointer;
+    size_t depth = 0;
+
+    if ((pointer < end) && (*pointer == '\"'))
+    {
+        return cJSONUtils_SkipString(pointer, end);
+    }
+
+    if ((pointer < end) && ((*pointer == '[') || (*pointer == '{')))
+    {
+        for (; pointer < end; pointer++)
+        {
+            if (*pointer == '\"')
+            {
+                if ((pointer = cJSONUtils_SkipString(pointer, end)) == NULL)
+                {
+                    return NULL;
+                }
+                pointer--;
+            }
+            else if ((*pointer == '[') || (*pointer == '{'))
+            {
+                depth++;
+            }
+            else if (((*pointer == ']') || (*pointer == '}')) && (--depth == 0))
+            {
+                return pointer + 1;
+            }
+        }
+
+        return NULL;
+    }
+
+    /* number, true, false or null */
+    while ((pointer < end) && (*pointer != ',') && (*pointer != ']') && (*pointer != '}') && (*pointer != ' ') && (*pointer != '\t') && (*pointer != '\n') && (*pointer != '\r'))
+    {
+        pointer++;
+    }
+
+    return (pointer > start) ? pointer : NULL;
+}
+
+/* decode the member name at pointer into stream->key and return the end of it */
+static const char *cJSONUtils_StreamKey(cJSONUtils_Stream *stream, const char *pointer)
+{
+    const char *end = cJSONUtils_SkipString(pointer, stream->end);
+    const char *name = pointer + 1;
+    size_t length = 0;
+    cJSON *decoded = NULL;
+
+    if (end == NULL)
+    {
+        return NULL;
+    }
+    length = (size_t)(end - pointer) - 2;
+    if (memchr(name, '\\', length) != NULL)
+    {
+        /* escape sequences are left to the parser, they are rare in names */
+        decoded = cJSON_ParseWithLength(pointer, (size_t)(end - pointer));
+        if (!cJSON_IsString(decoded))
+        {
+            cJSON_Delete(decoded);
+            return NULL;
+        }
+        name = decoded->valuestring;
+        length = strlen(name);
+    }
+
+    if (length >= stream->key_size)
+    {
+        unsigned char *key = (unsigned char*)realloc(stream->key, length + 1);
+        if (key == NULL)
+        {
+            cJSON_Delete(decoded);
+            return NULL;
+        }
+        stream->key = key;
+        stream->key_size = length + 1;
+    }
+    memcpy(stream->key, name, length);
+    stream->key[length] = '\0';
+    cJSON_Delete(decoded);
+
+    return end;
+}
+
+/* does the next token of need lead to the member named stream->key or the element at index? */
+static int cJSONUtils_StreamMatches(const cJSONUtils_Stream *stream, const cJSONUtils_StreamNeed *need, int is_object, size_t index)
+{
+    const unsigned char *token = (const unsigned char*)need->pointer + need->cursor + 1;
+    size_t which = 0;
+
+    if (is_object)
+    {
+        /* case insensitive like cJSONUtils_GetPointer */
+        return !cJSONUtils_Pstrcasecmp(stream->key, token);
+    }
+
+    /* digits only, like cJSONUtils_PatcherResolve */
+    for (; (*token >= '0') && (*token <= '9'); token++)
+    {
+        which = (10 * which) + (size_t)(*token - '0');
+        if (which > INT_MAX)
+        {
+            return 0;
+        }
+    }
+
+    return ((*token == '\0') || (*token == '/')) && (which == index);
+}
+
+static cJSON *cJSONUtils_StreamPlaceholder(cJSONUtils_Stream *stream, const char *start, const char *end)
+{
+    cJSON *placeholder = NULL;
+
+    if (stream->range_count == stream->range_size)
+    {
+        size_t size = (stream->range_size == 0) ? 16 : (2 * stream->range_size);
+        cJSONUtils_StreamRange *ranges = NULL;
+        if (size > INT_MAX)
+        {
+            return NULL;
+        }
+        ranges = (cJSONUtils_StreamRange*)realloc(stream->ranges, size * sizeof(cJSONUtils_StreamRange));
+        if (ranges == NULL)
+        {
+            return NULL;
+        }
+        stream->ranges = ranges;
+        stream->range_size = size;
+    }
+
+    placeholder = cJSON_CreateNull();
+    if (placeholder == NULL)
+    {
+        return NULL;
+    }
+    placeholder->type = cJSON_Raw | cJSON_IsReference;
+    placeholder->valuestring = cJSONUtils_Placeholder;
+    placeholder->valueint = (int)stream->range_count;
+    stream->ranges[stream->range_count].start = start;
+    stream->ranges[stream->range_count].end = end;
+    stream->range_count++;
+
+    return placeholder;
+}
+
+static int cJSONUtils_IsPlaceholder(const cJSON *item)
+{
+    return ((item->type & 0xFF) == cJSON_Raw) && (item->valuestring == cJSONUtils_Placeholder);
+}
+
+/* Build the skeleton of the value at *pointer that needs order[begin..end) lead to and advance *pointer past it. The
+ * cursors of the needs are the same afterwards. This recurses once per token of the pointers, not per level of the
+ * document. */
+static cJSON *cJSONUtils_StreamBuild(cJSONUtils_Stream *stream, const char **pointer, size_t begin, size_t end)
+{
+    const char *value = *pointer;
+    const char *member = NULL;
+    cJSON *container = NULL;
+    size_t index = 0;
+    size_t i = 0;
+    int is_object = 0;
+    int parse = 0;
+    int descend = 0;
+
+    if ((value == stream->end) || ((*value != '[') && (*value != '{')))
+    {
+        /* nothing to look into */
+        parse = 1;
+    }
+    for (i = begin; (i < end) && !parse; i++)
+    {
+        const cJSONUtils_StreamNeed *need = &stream->needs[stream->order[i]];
+        const char *token = need->pointer + need->cursor;
+        parse = ((*token == '\0') && (need->flags & cJSONUtils_NeedsValue))
+            || ((*value == '[') && (*token == '/') && (need->flags & cJSONUtils_NeedsMembership) && (strchr(token + 1, '/') == NULL));
+    }
+    if (parse)
+    {
+        container = cJSON_ParseWithLengthOpts(value, (size_t)(stream->end - value), pointer, 0);
+        return container;
+    }
+
+    /* the needs that end here don't look into the value */
+    for (i = begin; i < end; i++)
+    {
+        const cJSONUtils_StreamNeed *need = &stream->needs[stream->order[i]];
+        if (need->pointer[need->cursor] == '\0')
+        {
+            size_t swap = stream->order[begin];
+            stream->order[begin++] = stream->order[i];
+            stream->order[i] = swap;
+        }
+    }
+
+    is_object = (*value == '{');
+    container = is_object ? cJSON_CreateObject() : cJSON_CreateArray();
+    if (container == NULL)
+    {
+        return NULL;
+    }
+    if (stream->container_count == stream->container_size)
+    {
+        size_t size = (stream->container_size == 0) ? 16 : (2 * stream->container_size);
+        cJSON **containers = (cJSON**)realloc(stream->containers, size * sizeof(cJSON*));
+        if (containers == NULL)
+        {
+            goto fail;
+        }
+        stream->containers = containers;
+        stream->container_size = size;
+    }
+    stream->containers[stream->container_count++] = container;
+
+    value = cJSONUtils_SkipWhitespace(value + 1, stream->end);
+    if ((value < stream->end) && (*value == (is_object ? '}' : ']')))
+    {
+        *pointer = value + 1;
+        return container;
+    }
+    for (;;)
+    {
+        size_t matching = begin;
+        cJSON *child = NULL;
+
+        member = value;
+        if (is_object)
+        {
+            if ((value == stream->end) || (*value != '\"') || ((value = cJSONUtils_StreamKey(stream, value)) == NULL))
+            {
+                goto fail;
+            }
+            value = cJSONUtils_SkipWhitespace(value, stream->end);
+            if ((value == stream->end) || (*value != ':'))
+            {
+                goto fail;
+            }
+            value = cJSONUtils_SkipWhitespace(value + 1, stream->end);
+        }
+
+        /* The needs that lead to this child continue with their next token. They stay candidates for the other
+         * children: once a member is removed, the next one with the same name (ignoring case) takes its place. */
+        descend = 0;
+        for (i = begin; i < end; i++)
+        {
+            cJSONUtils_StreamNeed *need = &stream->needs[stream->order[i]];
+            if (cJSONUtils_StreamMatches(stream, need, is_object, index))
+            {
+                size_t swap = stream->order[matching];
+                stream->order[matching++] = stream->order[i];
+                stream->order[i] = swap;
+                for (need->cursor++; (need->pointer[need->cursor] != '\0') && (need->pointer[need->cursor] != '/'); need->cursor++)
+                {
+                }
+                /* a child that is only replaced or removed can stay a placeholder */
+                descend |= (need->pointer[need->cursor] != '\0') || (need->flags & cJSONUtils_NeedsValue);
+            }
+        }
+
+        if (descend)
+        {
+            *pointer = value;
+            child = cJSONUtils_StreamBuild(stream, pointer, begin, matching);
+            if ((child != NULL) && is_object && (cJSONUtils_StreamKey(stream, member) == NULL))
+            {
+                cJSON_Delete(child);
+                child = NULL;
+            }
+            value = *pointer;
+        }
+        else if ((value = cJSONUtils_SkipValue(value, stream->end)) != NULL)
+        {
+            child = cJSONUtils_StreamPlaceholder(stream, member, value);
+        }
+        for (i = begin; i < matching; i++)
+        {
+            /* back to the token of this level */
+            cJSONUtils_StreamNeed *need = &stream->needs[stream->order[i]];
+            for (need->cursor--; need->pointer[need->cursor] != '/'; need->cursor--)
+            {
+            }
+        }
+        if (child == NULL)
+        {
+            goto fail;
+        }
+        if (is_object)
+        {
+            cJSON_AddItemToObject(container, (const char*)stream->key, child);
+        }
+        else
+        {
+            cJSON_AddItemToArray(container, child);
+        }
+
+        value = cJSONUtils_SkipWhitespace(value, stream->end);
+        if ((value < stream->end) && (*value == ','))
+        {
+            value = cJSONUtils_SkipWhitespace(value + 1, stream->end);
+            index++;
+        }
+        else if ((value < stream->end) && (*value == (is_object ? '}' : ']')))
+        {
+            *pointer = value + 1;
+            return container;
+        }
+        else
+        {
+            goto fail;
+        }
+    }
+
+fail:
+    cJSON_Delete(container);
+
+    return NULL;
+}
+
+static int cJSONUtils_StreamWrite(cJSONUtils_Stream *stream, const char *data, size_t length)
+{
+    return (length == 0) || stream->writer(data, length, stream->context);
+}
+
+/* Print the skeleton: placeholders are copied from the text and only the arrays and objects that contain them are
+ * printed here, everything else by cJSON_PrintToWriter. Their nesting is limited by the tokens of the pointers. */
+static int cJSONUtils_StreamPrint(cJSONUtils_Stream *stream, const cJSON *item)
+{
+    const cJSON *child = NULL;
+    size_t i = 0;
+    int is_object = cJSON_IsObject(item);
+
+    if (cJSONUtils_IsPlaceholder(item))
+    {
+        const cJSONUtils_StreamRange *range = &stream->ranges[item->valueint];
+        return cJSONUtils_StreamWrite(stream, range->start, (size_t)(range->end - range->start));
+    }
+
+    for (i = 0; (i < stream->container_count) && (stream->containers[i] != item); i++)
+    {
+    }
+    if (i == stream->container_count)
+    {
+        return cJSON_PrintToWriter(item, 0, stream->writer, stream->context);
+    }
+
+    if (!cJSONUtils_StreamWrite(stream, is_object ? "{" : "[", 1))
+    {
+        return 0;
+    }
+    for (child = item->child; child != NULL; child = child->next)
+    {
+        if ((child != item->child) && !cJSONUtils_StreamWrite(stream, ",", 1))
+        {
+            return 0;
+        }
+        if (is_object && !cJSONUtils_IsPlaceholder(child))
+        {
+            /* the text of placeholders includes the name */
+            cJSON name;
+            memset(&name, '\0', sizeof(name));
+            name.type = cJSON_String | cJSON_IsReference;
+            name.valuestring = child->string;
+            if (child->stored_string == child->string)
+            {
+                name.stored_valuestring = name.valuestring;
+                name.valuestring_length = child->string_length;
+            }
+            if (!cJSON_PrintToWriter(&name, 0, stream->writer, stream->context) || !cJSONUtils_StreamWrite(stream, ":", 1))
+            {
+                return 0;
+            }
+        }
+        if (!cJSONUtils_StreamPrint(stream, child))
+        {
+            return 0;
+        }
+    }
+
+    return cJSONUtils_StreamWrite(stream, is_object ? "}" : "]", 1);
+}
+
+/* The needs of a patch, 0 if it is left to cJSONUtils_ApplyPatches on the whole document */
+static size_t cJSONUtils_StreamNeeds(cJSON *patch, cJSONUtils_StreamNeed *needs)
+{
+    cJSON *op = cJSON_GetObjectItem(patch, "op");
+    cJSON *path = cJSON_GetObjectItem(patch, "path");
+    cJSON *from = cJSON_GetObjectItem(patch, "from");
+
+    if (!cJSON_IsString(op) || !cJSON_IsString(path) || (path->valuestring[0] != '/'))
+    {
+        return 0;
+    }
+    needs[0].pointer = path->valuestring;
+    if (!strcmp(op->valuestring, "add") || !strcmp(op->valuestring, "remove"))
+    {
+        needs[0].flags = cJSONUtils_NeedsMembership;
+        return 1;
+    }
+    if (!strcmp(op->valuestring, "replace"))
+    {
+        /* replacing an array element by index keeps the others where they are, "-" appends after removing the first */
+        const char *token = strrchr(path->valuestring, '/') + 1;
+        needs[0].flags = (strspn(token, "0123456789") == strlen(token)) ? 0 : cJSONUtils_NeedsMembership;
+        return 1;
+    }
+    if (!strcmp(op->valuestring, "test"))
+    {
+        needs[0].flags = cJSONUtils_NeedsValue;
+        return 1;
+    }
+    if ((strcmp(op->valuestring, "move") && strcmp(op->valuestring, "copy")) || !cJSON_IsString(from) || (from->valuestring[0] != '/'))
+    {
+        return 0;
+    }
+    needs[0].flags = cJSONUtils_NeedsMembership;
+    needs[1].pointer = from->valuestring;
+    needs[1].flags = cJSONUtils_NeedsValue | (strcmp(op->valuestring, "move") ? 0 : cJSONUtils_NeedsMembership);
+
+    return 2;
+}
+
+/* Parse, patch and print the whole document */
+static int cJSONUtils_ApplyPatchesToDocument(const char *json, size_t length, cJSON *patches, cJSON_WriteFunction writer, void *context)
+{
+    cJSON *document = cJSON_ParseWithLength(json, length);
+    int err = 0;
+
+    if (document == NULL)
+    {
+        return 10;
+    }
+    err = cJSONUtils_ApplyPatches(document, patches);
+    if (!err && !cJSON_PrintToWriter(document, 0, writer, context))
+    {
+        err = 11;
+    }
+    cJSON_Delete(document);
+
+    return err;
+}
+
+CJSON_PUBLIC(int) cJSONUtils_ApplyPatchesToWriter(const char *json, size_t length, cJSON *patches, cJSON_WriteFunction writer, void *context)
+{
+    cJSONUtils_Stream stream;
+    cJSON *skeleton = NULL;
+    cJSON *patch = NULL;
+    const char *pointer = NULL;
+    size_t count = 0;
+    size_t i = 0;
+    int err = 0;
+    /* the patches can't be applied to a skeleton */
+    int whole = 0;
+
+    if (!cJSON_IsArray(patches))
+    {
+        /* malformed patches. */
+        return 1;
+    }
+    if ((json == NULL) || (writer == NULL))
+    {
+        return (json == NULL) ? 10 : 11;
+    }
+
+    memset(&stream, 0, sizeof(stream));
+    stream.end = json + length;
+    stream.writer = writer;
+    stream.context = context;
+    count = (size_t)cJSON_GetArraySize(patches);
+    stream.needs = (cJSONUtils_StreamNeed*)malloc((2 * count + 1) * sizeof(cJSONUtils_StreamNeed));
+    stream.order = (size_t*)malloc((2 * count + 1) * sizeof(size_t));
+    if ((stream.needs == NULL) || (stream.order == NULL))
+    {
+        whole = 1;
+        goto end;
+    }
+    count = 0;
+    for (patch = patches->child; patch != NULL; patch = patch->next)
+    {
+        size_t needs = cJSON_IsObject(patch) ? cJSONUtils_StreamNeeds(patch, &stream.needs[count]) : 0;
+        if (needs == 0)
+        {
+            /* something unusual, like the root or an invalid patch */
+            whole = 1;
+            goto end;
+        }
+        count += needs;
+    }
+    for (i = 0; i < count; i++)
+    {
+        stream.needs[i].cursor = 0;
+        stream.order[i] = i;
+    }
+
+    pointer = cJSONUtils_SkipWhitespace(json, stream.end);
+    skeleton = cJSONUtils_StreamBuild(&stream, &pointer, 0, count);
+    if ((skeleton == NULL) || (cJSONUtils_SkipWhitespace(pointer, stream.end) != stream.end))
+    {
+        err = 10;
+        goto end;
+    }
+
+    err = cJSONUtils_ApplyPatches(skeleton, patches);
+    if (!err && !cJSONUtils_StreamPrint(&stream, skeleton))
+    {
+        err = 11;
+    }
+
+end:
+    cJSON_Delete(skeleton);
+    free(stream.needs);
+    free(stream.order);
+    free(stream.ranges);
+    free(stream.containers);
+    free(stream.key);
+    if (whole)
+    {
+        return cJSONUtils_ApplyPatchesToDocument(json, length, patches, writer, context);
+    }
+
+    return err;
+}
+
+static void cJSONUtils_GeneratePatch(cJSON *patches, const unsigned char *op, const unsigned char *path, const unsigned char *suffix, cJSON *val)
+{
+    cJSON *patch = cJSON_CreateObject();
+    cJSON_AddItemToObject(patch, "op", cJSON_CreateString((const char*)op));
+    if (suffix)
+    {
+        unsigned char *newpath = (unsigned char*)malloc(strlen((const char*)path) + cJSONUtils_PointerEncodedstrlen(suffix) + 2);
+        cJSONUtils_PointerEncodedstrcpy(newpath + sprintf((char*)newpath, "%s/", (const char*)path), suffix);
+        cJSON_AddItemToObject(patch, "path", cJSON_CreateString((const char*)newpath));
+        free(newpath);
+    }
+    else
+    {
+        cJSON_AddItemToObject(patch, "path", cJSON_CreateString((const char*)path));
+    }
+    if (val)
+    {
+        cJSON_AddItemToObject(patch, "value", cJSON_Duplicate(val, 1));
+    }
+    cJSON_AddItemToArray(patches, patch);
+}
+
+CJSON_PUBLIC(void) cJSONUtils_AddPatchToArray(cJSON *array, const char *op, const char *path, cJSON *val)
+{
+    cJSONUtils_GeneratePatch(array, (const unsigned char*)op, (const unsigned char*)path, 0, val);
+}
+
+/* arrays whose changed parts are bigger than this (in from elements times to elements) are compared by position */
+#define CJSON_UTILS_LCS_LIMIT (1UL << 22)
+
+/* hash and size of a subtree, stored in pre-order, so the first child of the item at index i is at i + 1 and its
+ * next sibling at i + size */
+typedef struct cJSONUtils_NodeInfo
+{
+    unsigned long hash;
+    size_t size;
+} cJSONUtils_NodeInfo;
+
+/* items whose diff was put off by cJSONUtils_GeneratePatchesParallel */
+typedef struct cJSONUtils_DiffJob
+{
+    cJSON *from;
+    size_t from_index;
+    cJSON *to;
+    size_t to_index;
+    /* offset and length of their path in paths */
+    size_t path;
+    size_t length;
+    /* the number of patches before theirs and how many they got */
+    size_t position;
+    size_t count;
+} cJSONUtils_DiffJob;
+
+typedef struct cJSONUtils_Diff
+{
+    cJSON *patches;
+    size_t count;
+    const cJSONUtils_NodeInfo *from_info;
+    const cJSONUtils_NodeInfo *to_info;
+    /* path of the current item, reused for all of them */
+    unsigned char *path;
+    size_t length;
+    size_t size;
+    /* if queue is set, everything below the root is put into jobs instead of being diffed */
+    int queue;
+    cJSONUtils_DiffJob *jobs;
+    size_t job_count;
+    size_t job_size;
+    unsigned char *paths;
+    size_t paths_length;
+    size_t paths_size;
+} cJSONUtils_Diff;
+
+/* FNV-1a */
+static unsigned long cJSONUtils_HashBytes(unsigned long hash, const unsigned char *bytes, size_t length)
+{
+    size_t i = 0;
+    for (i = 0; i < length; i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619UL;
+    }
+
+    return hash;
+}
+
+/* keys are matched case insensitive */
+static unsigned long cJSONUtils_HashKey(const unsigned char *key)
+{
+    unsigned long hash = 2166136261UL;
+    for (; *key; key++)
+    {
+        hash = (hash ^ (unsigned long)tolower(*key)) * 16777619UL;
+    }
+
+    return hash;
+}
+
+static size_t cJSONUtils_CountItems(const cJSON *item)
+{
+    size_t count = 1;
+    for (item = item->child; item; item = item->next)
+    {
+        count += cJSONUtils_CountItems(item);
+    }
+
+    return count;
+}
+
+/* equal items get the same hash, this doesn't depend on the order of object members. The infos of the children have
+ * to follow the one of item already. */
+static unsigned long cJSONUtils_HashNode(const cJSON *item, const cJSONUtils_NodeInfo *info)
+{
+    const cJSON *child = NULL;
+    size_t offset = 1;
+    unsigned long hash = 2166136261UL ^ (unsigned long)(item->type & 0xFF);
+    unsigned long members = 0;
+
+    switch (item->type & 0xFF)
+    {
+        case cJSON_Number:
+        {
+            /* 0.0 == -0.0 */
+            double number = (cJSON_GetNumberValue(item) == 0) ? 0 : cJSON_GetNumberValue(item);
+            hash = cJSONUtils_HashBytes(hash, (const unsigned char*)&number, sizeof(number));
+            break;
+        }
+
+        case cJSON_String:
+        case cJSON_Raw:
+        {
+            const char *string = cJSON_IsString(item) ? cJSON_GetStringValue(item) : item->valuestring;
+            if (string != NULL)
+            {
+                hash = cJSONUtils_HashBytes(hash, (const unsigned char*)string, strlen(string));
+            }
+            break;
+        }
+
+        case cJSON_Array:
+            for (child = item->child; child; child = child->next)
+            {
+                hash = (hash ^ info[offset].hash) * 16777619UL;
+                offset += info[offset].size;
+            }
+            break;
+
+        case cJSON_Object:
+            for (child = item->child; child; child = child->next)
+            {
+                /* summed up, so the order doesn't matter */
+                members += (cJSONUtils_HashKey((const unsigned char*)child->string) ^ info[offset].hash) * 16777619UL;
+                offset += info[offset].size;
+            }
+            hash = (hash ^ members) * 16777619UL;
+            break;
+
+        default:
+            break;
+    }
+
+    return hash;
+}
+
+static size_t cJSONUtils_HashTree(const cJSON *item, cJSONUtils_NodeInfo *info)
+{
+    const cJSON *child = NULL;
+    size_t size = 1;
+
+    for (child = item->child; child; child = child->next)
+    {
+        size += cJSONUtils_HashTree(child, info + size);
+    }
+    info->size = size;
+    info->hash = cJSONUtils_HashNode(item, info);
+
+    return size;
+}
+
+static int cJSONUtils_DiffEnsure(cJSONUtils_Diff *diff, size_t needed)
+{
+    unsigned char *path = NULL;
+    size_t size = diff->size;
+
+    if ((diff->length + needed) <= diff->size)
+    {
+        return 1;
+    }
+    while (size < (diff->length + needed))
+    {
+        size *= 2;
+    }
+    path = (unsigned char*)realloc(diff->path, size);
+    if (path == NULL)
+    {
+        return 0;
+    }
+    diff->path = path;
+    diff->size = size;
+
+    return 1;
+}
+
+/* append "/<key>" to the path, returns the previous length to be restored by cJSONUtils_DiffPop */
+static size_t cJSONUtils_DiffPushKey(cJSONUtils_Diff *diff, const unsigned char *key)
+{
+    size_t length = diff->length;
+    if (!cJSONUtils_DiffEnsure(diff, cJSONUtils_PointerEncodedstrlen(key) + 2))
+    {
+        return (size_t)-1;
+    }
+    diff->path[diff->length] = '/';
+    cJSONUtils_PointerEncodedstrcpy(diff->path + diff->length + 1, key);
+    diff->length += strlen((char*)diff->path + diff->length);
+
+    return length;
+}
+
+static size_t cJSONUtils_DiffPushIndex(cJSONUtils_Diff *diff, size_t index)
+{
+    size_t length = diff->length;
+    /* check if conversion to unsigned long is valid
+     * This should be eliminated at compile time by dead code elimination
+     * if size_t is an alias of unsigned long, or if it is bigger */
+    if ((index > ULONG_MAX) || !cJSONUtils_DiffEnsure(diff, 23)) /* Allow space for 64bit int. */
+    {
+        return (size_t)-1;
+    }
+    diff->length += (size_t)sprintf((char*)diff->path + diff->length, "/%lu", (unsigned long)index);
+
+    return length;
+}
+
+static void cJSONUtils_DiffPop(cJSONUtils_Diff *diff, size_t length)
+{
+    diff->length = length;
+    diff->path[length] = '\0';
+}
+
+static void cJSONUtils_DiffPatch(cJSONUtils_Diff *diff, const char *op, cJSON *value)
+{
+    cJSONUtils_GeneratePatch(diff->patches, (const unsigned char*)op, diff->path, NULL, value);
+    diff->count++;
+}
+
+/* put off the diff of from and to with the current path, returns 0 if there is no memory for it */
+static int cJSONUtils_DiffQueue(cJSONUtils_Diff *diff, cJSON *from, size_t from_index, cJSON *to, size_t to_index)
+{
+    cJSONUtils_DiffJob *job = NULL;
+    void *jobs = diff->jobs;
+
+    if (!cJSONUtils_QueryReserve(&jobs, &diff->job_size, diff->job_count, sizeof(cJSONUtils_DiffJob)))
+    {
+        return 0;
+    }
+    diff->jobs = (cJSONUtils_DiffJob*)jobs;
+    if ((diff->paths_length + diff->length) > diff->paths_size)
+    {
+        unsigned char *paths = NULL;
+        size_t size = (diff->paths_size == 0) ? 256 : diff->paths_size;
+        while (size < (diff->paths_length + diff->length))
+        {
+            size *= 2;
+        }
+        paths = (unsigned char*)realloc(diff->paths, size);
+        if (paths == NULL)
+        {
+            return 0;
+        }
+        diff->paths = paths;
+        diff->paths_size = size;
+    }
+    memcpy(diff->paths + diff->paths_length, diff->path, diff->length);
+
+    job = &diff->jobs[diff->job_count++];
+    job->from = from;
+    job->from_index = from_index;
+    job->to = to;
+    job->to_index = to_index;
+    job->path = diff->paths_length;
+    job->length = diff->length;
+    job->position = diff->count;
+    job->count = 0;
+    diff->paths_length += diff->length;
+
+    return 1;
+}
+
+static void cJSONUtils_DiffItems(cJSONUtils_Diff *diff, cJSON *from, size_t from_index, cJSON *to, size_t to_index);
+
+/* members of 'from' are matched with the ones of 'to' through a hash table of the keys */
+static void cJSONUtils_DiffObjects(cJSONUtils_Diff *diff, cJSON *from, size_t from_index, cJSON *to, size_t to_index)
+{
+    typedef struct
+    {
+        cJSON *item;
+        size_t index;
+        int matched;
+    } member;
+    member *members = NULL;
+    size_t *table = NULL;
+    size_t count = (size_t)cJSON_GetArraySize(to);
+    size_t mask = 1;
+    size_t index = to_index + 1;
+    size_t i = 0;
+    size_t length = 0;
+    cJSON *child = NULL;
+
+    while (mask < (2 * count))
+    {
+        mask *= 2;
+    }
+    members = (member*)malloc((count * sizeof(member)) + (mask * sizeof(size_t)));
+    if (members == NULL)
+    {
+        cJSONUtils_DiffPatch(diff, "replace", to);
+        return;
+    }
+    table = (size_t*)(void*)&members[count];
+    /* slots hold the index of a member + 1, 0 is empty */
+    memset(table, 0, mask * sizeof(size_t));
+    mask--;
+
+    for ((void)(child = to->child), i = 0; child; (void)(child = child->next), i++)
+    {
+        size_t slot = (size_t)cJSONUtils_HashKey((unsigned char*)child->string) & mask;
+        while (table[slot] != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = i + 1;
+        members[i].item = child;
+        members[i].index = index;
+        members[i].matched = 0;
+        index += diff->to_info[index].size;
+    }
+
+    for ((void)(child = from->child), index = from_index + 1; child; (void)(index += diff->from_info[index].size), child = child->next)
+    {
+        member *match = NULL;
+        size_t slot = (size_t)cJSONUtils_HashKey((unsigned char*)child->string) & mask;
+        for (; table[slot] != 0; slot = (slot + 1) & mask)
+        {
+            member *candidate = &members[table[slot] - 1];
+            if (!candidate->matched && !cJSONUtils_strcasecmp((unsigned char*)candidate->item->string, (unsigned char*)child->string))
+            {
+                match = candidate;
+                break;
+            }
+        }
+
+        length = cJSONUtils_DiffPushKey(diff, (unsigned char*)child->string);
+        if (length == (size_t)-1)
+        {
+            break;
+        }
+        if (match != NULL)
+        {
+            /* both object keys are the same */
+            match->matched = 1;
+            cJSONUtils_DiffItems(diff, child, index, match->item, match->index);
+        }
+        else
+        {
+            /* object element doesn't exist in 'to' --> remove it */
+            cJSONUtils_DiffPatch(diff, "remove", NULL);
+        }
+        cJSONUtils_DiffPop(diff, length);
+    }
+
+    /* object elements that don't exist in 'from' --> add them */
+    for (i = 0; i < count; i++)
+    {
+        if (members[i].matched)
+        {
+            continue;
+        }
+        length = cJSONUtils_DiffPushKey(diff, (unsigned char*)members[i].item->string);
+        if (length == (size_t)-1)
+        {
+            break;
+        }
+        cJSONUtils_DiffPatch(diff, "add", members[i].item);
+        cJSONUtils_DiffPop(diff, length);
+    }
+
+    free(members);
+}
+
+typedef struct cJSONUtils_Element
+{
+    cJSON *item;
+    size_t index;
+} cJSONUtils_Element;
+
+/* transform from[0..removed) into to[0..added) at position in the array: the elements that take the place of
+ * each other are diffed, the rest is removed or added. at_end is set if no elements follow them. */
+static size_t cJSONUtils_DiffRun(cJSONUtils_Diff *diff, const cJSONUtils_Element *from, size_t removed, const cJSONUtils_Element *to, size_t added, size_t position, int at_end)
+{
+    size_t i = 0;
+    size_t length = 0;
+
+    for (i = 0; i < removed; i++)
+    {
+        length = cJSONUtils_DiffPushIndex(diff, position);
+        if (length == (size_t)-1)
+        {
+            return position;
+        }
+        if (i < added)
+        {
+            cJSONUtils_DiffItems(diff, from[i].item, from[i].index, to[i].item, to[i].index);
+            position++;
+        }
+        else
+        {
+            cJSONUtils_DiffPatch(diff, "remove", NULL);
+        }
+        cJSONUtils_DiffPop(diff, length);
+    }
+    for (; i < added; i++)
+    {
+        /* at the end of the array, just append */
+        length = at_end ? cJSONUtils_DiffPushKey(diff, (const unsigned char*)"-") : cJSONUtils_DiffPushIndex(diff, position);
+        if (length == (size_t)-1)
+        {
+            return position;
+        }
+        cJSONUtils_DiffPatch(diff, "add", to[i].item);
+        cJSONUtils_DiffPop(diff, length);
+        position++;
+    }
+
+    return position;
+}
+
+/* equal prefixes and suffixes are skipped, the rest is diffed along the longest common subsequence */
+static void cJSONUtils_DiffArrays(cJSONUtils_Diff *diff, cJSON *from, size_t from_index, cJSON *to, size_t to_index)
+{
+    cJSONUtils_Element *from_elements = NULL;
+    cJSONUtils_Element *to_elements = NULL;
+    unsigned int *lcs = NULL;
+    size_t from_count = (size_t)cJSON_GetArraySize(from);
+    size_t to_count = (size_t)cJSON_GetArraySize(to);
+    size_t prefix = 0;
+    size_t suffix = 0;
+    size_t removed = 0;
+    size_t added = 0;
+    size_t position = 0;
+    size_t index = 0;
+    size_t i = 0;
+    size_t j = 0;
+    cJSON *child = NULL;
+
+    from_elements = (cJSONUtils_Element*)malloc((from_count + to_count) * sizeof(cJSONUtils_Element) + 1);
+    if (from_elements == NULL)
+    {
+        cJSONUtils_DiffPatch(diff, "replace", to);
+        return;
+    }
+    to_elements = from_elements + from_count;
+    for ((void)(child = from->child), (void)(index = from_index + 1), i = 0; child; (void)(child = child->next), i++)
+    {
+        from_elements[i].item = child;
+        from_elements[i].index = index;
+        index += diff->from_info[index].size;
+    }
+    for ((void)(child = to->child), (void)(index = to_index + 1), i = 0; child; (void)(child = child->next), i++)
+    {
+        to_elements[i].item = child;
+        to_elements[i].index = index;
+        index += diff->to_info[index].size;
+    }
+
+#define cJSONUtils_SameElement(a, b) ((diff->from_info[(a).index].hash == diff->to_info[(b).index].hash) && cJSON_Compare((a).item, (b).item, 0))
+    while ((prefix < from_count) && (prefix < to_count) && cJSONUtils_SameElement(from_elements[prefix], to_elements[prefix]))
+    {
+        prefix++;
+    }
+    while ((suffix < (from_count - prefix)) && (suffix < (to_count - prefix))
+            && cJSONUtils_SameElement(from_elements[from_count - suffix - 1], to_elements[to_count - suffix - 1]))
+    {
+        suffix++;
+    }
+#undef cJSONUtils_SameElement
+    from_elements += prefix;
+    to_elements += prefix;
+    from_count -= prefix + suffix;
+    to_count -= prefix + suffix;
+    position = prefix;
+
+    /* lcs[i * (to_count + 1) + j] is the length of the common subsequence of from[i..] and to[j..], elements with
+     * equal hashes count as equal, the ones that aren't are diffed anyway */
+    if ((from_count > 0) && (to_count > 0) && (from_count <= (CJSON_UTILS_LCS_LIMIT / (to_count + 1))))
+    {
+        lcs = (unsigned int*)malloc((from_count + 1) * (to_count + 1) * sizeof(unsigned int));
+    }
+    if (lcs == NULL)
+    {
+        /* compare by position */
+        cJSONUtils_DiffRun(diff, from_elements, from_count, to_elements, to_count, position, suffix == 0);
+        free(from_elements - prefix);
+        return;
+    }
+
+#define cJSONUtils_LCS(i, j) lcs[((i) * (to_count + 1)) + (j)]
+    for (i = from_count + 1; i-- > 0;)
+    {
+        for (j = to_count + 1; j-- > 0;)
+        {
+            if ((i == from_count) || (j == to_count))
+            {
+                cJSONUtils_LCS(i, j) = 0;
+            }
+            else if (diff->from_info[from_elements[i].index].hash == diff->to_info[to_elements[j].index].hash)
+            {
+                cJSONUtils_LCS(i, j) = cJSONUtils_LCS(i + 1, j + 1) + 1;
+            }
+            else
+            {
+                cJSONUtils_LCS(i, j) = (cJSONUtils_LCS(i + 1, j) > cJSONUtils_LCS(i, j + 1)) ? cJSONUtils_LCS(i + 1, j) : cJSONUtils_LCS(i, j + 1);
+            }
+        }
+    }
+
+    i = 0;
+    j = 0;
+    while ((i < from_count) || (j < to_count))
+    {
+        /* collect the removed and added elements up to the next common one */
+        removed = i;
+        added = j;
+        while ((i < from_count) || (j < to_count))
+        {
+            if ((i < from_count) && (j < to_count)
+                    && (diff->from_info[from_elements[i].index].hash == diff->to_info[to_elements[j].index].hash)
+                    && (cJSONUtils_LCS(i, j) == (cJSONUtils_LCS(i + 1, j + 1) + 1)))
+            {
+                break;
+            }
+            if ((j == to_count) || ((i < from_count) && (cJSONUtils_LCS(i + 1, j) >= cJSONUtils_LCS(i, j + 1))))
+            {
+                i++;
+            }
+            else
+            {
+                j++;
+            }
+        }
+        position = cJSONUtils_DiffRun(diff, from_elements + removed, i - removed, to_elements + added, j - added, position, (i == from_count) && (suffix == 0));
+        if ((i < from_count) && (j < to_count))
+        {
+            /* common element, diffed in case the hashes collided */
+            position = cJSONUtils_DiffRun(diff, from_elements + i, 1, to_elements + j, 1, position, 0);
+            i++;
+            j++;
+        }
+    }
+#undef cJSONUtils_LCS
+
+    free(lcs);
+    free(from_elements - prefix);
+}
+
+static void cJSONUtils_DiffItems(cJSONUtils_Diff *diff, cJSON *from, size_t from_index, cJSON *to, size_t to_index)
+{
+    if (diff->queue && (from_index != 0) && cJSONUtils_DiffQueue(diff, from, from_index, to, to_index))
+    {
+        return;
+    }
+
+    if ((from->type & 0xFF) != (to->type & 0xFF))
+    {
+        cJSONUtils_DiffPatch(diff, "replace", to);
+        return;
+    }
+
+    /* skip identical subtrees */
+    if ((diff->from_info[from_index].hash == diff->to_info[to_index].hash) && cJSON_Compare(from, to, 0))
+    {
+        return;
+    }
+
+    switch (from->type & 0xFF)
+    {
+        case cJSON_Number:
+        case cJSON_String:
+        case cJSON_Raw:
+            cJSONUtils_DiffPatch(diff, "replace", to);
+            return;
+
+        case cJSON_Array:
+            cJSONUtils_DiffArrays(diff, from, from_index, to, to_index);
+            return;
+
+        case cJSON_Object:
+            cJSONUtils_DiffObjects(diff, from, from_index, to, to_index);
+            return;
+
+        default:
+            break;
+    }
+}
+
+CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatches(cJSON *from, cJSON *to)
+{
+    cJSONUtils_Diff diff;
+    cJSONUtils_NodeInfo *info = NULL;
+    size_t from_count = 0;
+    cJSON *patches = cJSON_CreateArray();
+
+    if ((from == NULL) || (to == NULL))
+    {
+        return patches;
+    }
+
+    memset(&diff, 0, sizeof(diff));
+    diff.patches = patches;
+    from_count = cJSONUtils_CountItems(from);
+    info = (cJSONUtils_NodeInfo*)malloc((from_count + cJSONUtils_CountItems(to)) * sizeof(cJSONUtils_NodeInfo));
+    diff.size = 64;
+    diff.path = (unsigned char*)malloc(diff.size);
+    if ((info == NULL) || (diff.path == NULL))
+    {
+        free(info);
+        free(diff.path);
+        cJSONUtils_GeneratePatch(patches, (const unsigned char*)"replace", (const unsigned char*)"", NULL, to);
+        return patches;
+    }
+    diff.path[0] = '\0';
+
+    cJSONUtils_HashTree(from, info);
+    cJSONUtils_HashTree(to, info + from_count);
+    diff.from_info = info;
+    diff.to_info = info + from_count;
+    cJSONUtils_DiffItems(&diff, from, 0, to, 0);
+
+    free(info);
+    free(diff.path);
+
+    return patches;
+}
+
+/* children of a root that are counted and hashed by one task of cJSONUtils_GeneratePatchesParallel */
+typedef struct cJSONUtils_HashRange
+{
+    const cJSON *first;
+    size_t count;
+    /* items in their subtrees and where their infos go */
+    size_t items;
+    cJSONUtils_NodeInfo *info;
+} cJSONUtils_HashRange;
+
+/* jobs that are diffed by one task of cJSONUtils_GeneratePatchesParallel */
+typedef struct cJSONUtils_DiffBatch
+{
+    const cJSONUtils_Diff *root;
+    size_t first;
+    size_t count;
+    cJSON *patches;
+} cJSONUtils_DiffBatch;
+
+/* every range gets about the same number of children */
+static void cJSONUtils_SplitChildren(const cJSON *item, cJSONUtils_HashRange *ranges, size_t tasks)
+{
+    const cJSON *child = item->child;
+    size_t children = (size_t)cJSON_GetArraySize(item);
+    size_t i = 0;
+    size_t j = 0;
+
+    for (i = 0; i < tasks; i++)
+    {
+        ranges[i].first = child;
+        ranges[i].count = (children / tasks) + ((i < (children % tasks)) ? 1 : 0);
+        ranges[i].items = 0;
+        ranges[i].info = NULL;
+        for (j = 0; j < ranges[i].count; j++)
+        {
+            child = child->next;
+        }
+    }
+}
+
+static void cJSONUtils_CountTask(void *task_data, size_t index)
+{
+    cJSONUtils_HashRange *range = &((cJSONUtils_HashRange*)task_data)[index];
+    const cJSON *child = range->first;
+    size_t i = 0;
+
+    for (i = 0; i < range->count; i++)
+    {
+        range->items += cJSONUtils_CountItems(child);
+        child = child->next;
+    }
+}
+
+static void cJSONUtils_HashTask(void *task_data, size_t index)
+{
+    cJSONUtils_HashRange *range = &((cJSONUtils_HashRange*)task_data)[index];
+    const cJSON *child = range->first;
+    size_t size = 0;
+    size_t i = 0;
+
+    for (i = 0; i < range->count; i++)
+    {
+        size += cJSONUtils_HashTree(child, range->info + size);
+        child = child->next;
+    }
+}
+
+/* diff the jobs of the batch one after another, their patches are collected in one array */
+static void cJSONUtils_DiffTask(void *task_data, size_t index)
+{
+    cJSONUtils_DiffBatch *batch = &((cJSONUtils_DiffBatch*)task_data)[index];
+    cJSONUtils_DiffJob *job = NULL;
+    cJSONUtils_Diff diff;
+    size_t i = 0;
+
+    memset(&diff, 0, sizeof(diff));
+    diff.from_info = batch->root->from_info;
+    diff.to_info = batch->root->to_info;
+    diff.patches = cJSON_CreateArray();
+    diff.size = 64;
+    diff.path = (unsigned char*)malloc(diff.size);
+    if ((diff.patches == NULL) || (diff.path == NULL))
+    {
+        cJSON_Delete(diff.patches);
+        free(diff.path);
+        return;
+    }
+
+    for (i = 0; i < batch->count; i++)
+    {
+        job = &batch->root->jobs[batch->first + i];
+        diff.length = 0;
+        if (!cJSONUtils_DiffEnsure(&diff, job->length + 1))
+        {
+            break;
+        }
+        memcpy(diff.path, batch->root->paths + job->path, job->length);
+        diff.length = job->length;
+        diff.path[diff.length] = '\0';
+        diff.count = 0;
+        cJSONUtils_DiffItems(&diff, job->from, job->from_index, job->to, job->to_index);
+        job->count = diff.count;
+    }
+
+    free(diff.path);
+    batch->patches = diff.patches;
+}
+
+/* move up to count patches from the start of source to the end of patches */
+static void cJSONUtils_MovePatches(cJSON *patches, cJSON *source, size_t count)
+{
+    for (; (count > 0) && (source != NULL) && (source->child != NULL); count--)
+    {
+        cJSON_AddItemToArray(patches, cJSON_DetachItemViaPointer(source, source->child));
+    }
+}
+
+CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatchesParallel(cJSON *from, cJSON *to, const cJSON_Executor *executor, size_t tasks)
+{
+    cJSONUtils_Diff diff;
+    cJSONUtils_HashRange *ranges = NULL;
+    cJSONUtils_DiffBatch *batches = NULL;
+    cJSONUtils_DiffBatch single;
+    cJSONUtils_DiffJob *job = NULL;
+    cJSONUtils_NodeInfo *info = NULL;
+    cJSON *patches = NULL;
+    size_t from_count = 1;
+    size_t to_count = 1;
+    size_t moved = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    if ((from == NULL) || (to == NULL) || (executor == NULL) || (executor->run == NULL) || (tasks < 2)
+            || (tasks > ((size_t)-1 / (2 * sizeof(cJSONUtils_HashRange))))
+            || ((from->type & 0xFF) != (to->type & 0xFF)) || !(cJSON_IsArray(from) || cJSON_IsObject(from)))
+    {
+        /* nothing to split */
+        return cJSONUtils_GeneratePatches(from, to);
+    }
+
+    memset(&diff, 0, sizeof(diff));
+    patches = cJSON_CreateArray();
+    diff.patches = cJSON_CreateArray();
+    ranges = (cJSONUtils_HashRange*)malloc(2 * tasks * sizeof(cJSONUtils_HashRange));
+    diff.size = 64;
+    diff.path = (unsigned char*)malloc(diff.size);
+    if ((patches == NULL) || (diff.patches == NULL) || (ranges == NULL) || (diff.path == NULL))
+    {
+        goto serial;
+    }
+    diff.path[0] = '\0';
+
+    /* the subtrees below the roots are counted and hashed in parallel, only the roots are left */
+    cJSONUtils_SplitChildren(from, ranges, tasks);
+    cJSONUtils_SplitChildren(to, ranges + tasks, tasks);
+    executor->run(cJSONUtils_CountTask, ranges, 2 * tasks, executor->executor_data);
+    for (i = 0; i < tasks; i++)
+    {
+        from_count += ranges[i].items;
+        to_count += ranges[tasks + i].items;
+    }
+    info = (cJSONUtils_NodeInfo*)malloc((from_count + to_count) * sizeof(cJSONUtils_NodeInfo));
+    if (info == NULL)
+    {
+        goto serial;
+    }
+    for ((void)(i = 0), j = 1; i < tasks; i++)
+    {
+        ranges[i].info = info + j;
+        j += ranges[i].items;
+    }
+    for ((void)(i = 0), j = from_count + 1; i < tasks; i++)
+    {
+        ranges[tasks + i].info = info + j;
+        j += ranges[tasks + i].items;
+    }
+    executor->run(cJSONUtils_HashTask, ranges, 2 * tasks, executor->executor_data);
+    info[0].size = from_count;
+    info[0].hash = cJSONUtils_HashNode(from, info);
+    info[from_count].size = to_count;
+    info[from_count].hash = cJSONUtils_HashNode(to, info + from_count);
+    diff.from_info = info;
+    diff.to_info = info + from_count;
+
+    /* diffing the roots puts off the diffs of their children, which are split between the tasks */
+    diff.queue = 1;
+    cJSONUtils_DiffItems(&diff, from, 0, to, 0);
+    if (diff.job_count > 0)
+    {
+        if (tasks > diff.job_count)
+        {
+            tasks = diff.job_count;
+        }
+        batches = (cJSONUtils_DiffBatch*)malloc(tasks * sizeof(cJSONUtils_DiffBatch));
+        if (batches == NULL)
+        {
+            /* diff them on this thread */
+            batches = &single;
+            tasks = 1;
+        }
+        for ((void)(i = 0), j = 0; i < tasks; i++)
+        {
+            batches[i].root = &diff;
+            batches[i].first = j;
+            batches[i].count = (diff.job_count / tasks) + ((i < (diff.job_count % tasks)) ? 1 : 0);
+            batches[i].patches = NULL;
+            j += batches[i].count;
+        }
+        if (tasks > 1)
+        {
+            executor->run(cJSONUtils_DiffTask, batches, tasks, executor->executor_data);
+        }
+        else
+        {
+            cJSONUtils_DiffTask(batches, 0);
+        }
+
+        /* the patches of the jobs go where the serial diff would have put them */
+        for (i = 0; i < tasks; i++)
+        {
+            for (j = 0; j < batches[i].count; j++)
+            {
+                job = &diff.jobs[batches[i].first + j];
+                cJSONUtils_MovePatches(patches, diff.patches, job->position - moved);
+                moved = job->position;
+                cJSONUtils_MovePatches(patches, batches[i].patches, job->count);
+            }
+            cJSON_Delete(batches[i].patches);
+        }
+        if (batches != &single)
+        {
+            free(batches);
+        }
+    }
+    cJSONUtils_MovePatches(patches, diff.patches, (size_t)-1);
+
+    cJSON_Delete(diff.patches);
+    free(diff.path);
+    free(diff.jobs);
+    free(diff.paths);
+    free(ranges);
+    free(info);
+
+    return patches;
+
+serial:
+    cJSON_Delete(patches);
+    cJSON_Delete(diff.patches);
+    free(diff.path);
+    free(ranges);
+
+    return cJSONUtils_GeneratePatches(from, to);
+}
+
+static int cJSONUtils_CompareKeys(const cJSON *a, const cJSON *b, int case_sensitive)
+{
+    if (case_sensitive && a->string && b->string)
+    {
+        return strcmp(a->string, b->string);
+    }
+
+    return cJSONUtils_strcasecmp((unsigned char*)a->string, (unsigned char*)b->string);
+}
+
+/* sort lists using a bottom up mergesort, members with the same name keep their order */
+static cJSON *cJSONUtils_SortList(cJSON *list, int case_sensitive)
+{
+    cJSON *ptr = list;
+    size_t width = 1;
+
+    while (ptr && ptr->next && (cJSONUtils_CompareKeys(ptr, ptr->next, case_sensitive) <= 0))
     {
-        /* Couldn't find object to add to. */
-        free(parentptr);
-        cJSON_Delete(value);
-        return 9;
+        /* Test for list sorted. */
+        ptr = ptr->next;
     }
-    else if (cJSON_IsArray(parent))
+    if (!ptr || !ptr->next)
     {
-        if (!strcmp((char*)childptr, "-"))
+        /* Leave sorted lists unmodified. */
+        return list;
+    }
+
+    /* merge neighbouring sorted runs of width elements until there is only one */
+    for (;; width *= 2)
+    {
+        cJSON *remaining = list;
+        cJSON *tail = NULL;
+        size_t merges = 0;
+
+        list = NULL;
+        while (remaining)
         {
-            cJSON_AddItemToArray(parent, value);
+            cJSON *first = remaining;
+            cJSON *second = remaining;
+            size_t first_size = 0;
+            size_t second_size = width;
+
+            merges++;
+            for (; second && (first_size < width); first_size++)
+            {
+                second = second->next;
+            }
+
+            while ((first_size > 0) || ((second_size > 0) && second))
+            {
+                cJSON *next = NULL;
+                if ((first_size > 0) && ((second_size == 0) || !second || (cJSONUtils_CompareKeys(first, second, case_sensitive) <= 0)))
+                {
+                    next = first;
+                    first = first->next;
+                    first_size--;
+                }
+                else
+                {
+                    next = second;
+                    second = second->next;
+                    second_size--;
+                }
+
+                if (tail)
+                {
+                    tail->next = next;
+                }
+                else
+                {
+                    list = next;
+                }
+                next->prev = tail;
+                tail = next;
+            }
+            remaining = second;
         }
-        else
+        tail->next = NULL;
+
+        if (merges <= 1)
         {
-            cJSON_InsertItemInArray(parent, atoi((char*)childptr), value);
+            /* the first item points to the last one, like in lists built by cJSON */
+            list->prev = tail;
+            return list;
         }
     }
-    else if (cJSON_IsObject(parent))
+}
+
+static void cJSONUtils_Sort(cJSON *object, int case_sensitive)
+{
+    if ((object == NULL) || (object->type & cJSON_IsFrozen))
     {
-        cJSON_DeleteItemFromObject(parent, (char*)childptr);
-        cJSON_AddItemToObject(parent, (char*)childptr, value);
+        return;
     }
-    else
+
+    /* loads lazy objects */
+    cJSON_GetArraySize(object);
+    object->child = cJSONUtils_SortList(object->child, case_sensitive);
+    /* keep the order of duplicate names in the index */
+    if (object->type & cJSON_IsIndexed)
     {
-        cJSON_Delete(value);
+        cJSON_BuildIndex(object);
     }
-    free(parentptr);
+    object->type &= ~cJSON_IsRendered;
+}
 
-    return 0;
+CJSON_PUBLIC(void) cJSONUtils_SortObject(cJSON *object)
+{
+    cJSONUtils_Sort(object, 0);
 }
 
-CJSON_PUBLIC(int) cJSONUtils_ApplyPatches(cJSON *object, cJSON *patches)
+CJSON_PUBLIC(void) cJSONUtils_SortObjectCaseSensitive(cJSON *object)
 {
-    int err = 0;
+    cJSONUtils_Sort(object, 1);
+}
 
-    if (patches == NULL)
+/* an element of an array that is sorted, with its key read out once */
+typedef struct cJSONUtils_SortEntry
+{
+    cJSON *item;
+    /* order of the kinds of keys: missing, null, false, true, number, string, array or object */
+    int rank;
+    double number;
+    const char *string;
+} cJSONUtils_SortEntry;
+
+typedef struct cJSONUtils_ArraySort
+{
+    cJSONUtils_ArrayComparator compare;
+    void *context;
+    int flags;
+} cJSONUtils_ArraySort;
+
+static void cJSONUtils_ReadSortKey(cJSONUtils_SortEntry *entry, const char *key)
+{
+    cJSON *value = cJSON_IsObject(entry->item) ? cJSON_GetObjectItemCaseSensitive(entry->item, key) : NULL;
+
+    entry->number = 0;
+    entry->string = NULL;
+    if (value == NULL)
     {
-        return 1;
+        entry->rank = 0;
     }
-
-    if (cJSON_IsArray(patches))
+    else if (cJSON_IsNull(value))
     {
-        /* malformed patches. */
-        return 1;
+        entry->rank = 1;
     }
-    if (patches)
+    else if (cJSON_IsFalse(value))
     {
-        patches = patches->child;
+        entry->rank = 2;
     }
-    while (patches)
+    else if (cJSON_IsTrue(value))
     {
-        if ((err = cJSONUtils_ApplyPatch(object, patches)))
-        {
-            return err;
-        }
-        patches = patches->next;
+        entry->rank = 3;
     }
-
-    return 0;
-}
-
-static void cJSONUtils_GeneratePatch(cJSON *patches, const unsigned char *op, const unsigned char *path, const unsigned char *suffix, cJSON *val)
-{
-    cJSON *patch = cJSON_CreateObject();
-    cJSON_AddItemToObject(patch, "op", cJSON_CreateString((const char*)op));
-    if (suffix)
+    else if (cJSON_IsNumber(value))
     {
-        unsigned char *newpath = (unsigned char*)malloc(strlen((const char*)path) + cJSONUtils_PointerEncodedstrlen(suffix) + 2);
-        cJSONUtils_PointerEncodedstrcpy(newpath + sprintf((char*)newpath, "%s/", (const char*)path), suffix);
-        cJSON_AddItemToObject(patch, "path", cJSON_CreateString((const char*)newpath));
-        free(newpath);
+        entry->rank = 4;
+        entry->number = cJSON_GetNumberValue(value);
     }
-    else
+    else if (cJSON_IsString(value) && (cJSON_GetStringValue(value) != NULL))
     {
-        cJSON_AddItemToObject(patch, "path", cJSON_CreateString((const char*)path));
+        entry->rank = 5;
+        entry->string = cJSON_GetStringValue(value);
     }
-    if (val)
+    else
     {
-        cJSON_AddItemToObject(patch, "value", cJSON_Duplicate(val, 1));
+        entry->rank = 6;
     }
-    cJSON_AddItemToArray(patches, patch);
 }
 
-CJSON_PUBLIC(void) cJSONUtils_AddPatchToArray(cJSON *array, const char *op, const char *path, cJSON *val)
+static int cJSONUtils_CompareEntries(const cJSONUtils_ArraySort *sort, const cJSONUtils_SortEntry *a, const cJSONUtils_SortEntry *b)
 {
-    cJSONUtils_GeneratePatch(array, (const unsigned char*)op, (const unsigned char*)path, 0, val);
-}
+    int difference = 0;
 
-static void cJSONUtils_CompareToPatch(cJSON *patches, const unsigned char *path, cJSON *from, cJSON *to)
-{
-    if ((from == NULL) || (to == NULL))
+    if (sort->compare != NULL)
     {
-        return;
+        difference = sort->compare(a->item, b->item, sort->context);
     }
-
-    if ((from->type & 0xFF) != (to->type & 0xFF))
+    else if (a->rank != b->rank)
     {
-        cJSONUtils_GeneratePatch(patches, (const unsigned char*)"replace", path, 0, to);
-        return;
+        difference = (a->rank < b->rank) ? -1 : 1;
     }
-
-    switch ((from->type & 0xFF))
+    else if (a->rank == 4)
     {
-        case cJSON_Number:
-            if ((from->valueint != to->valueint) || (from->valuedouble != to->valuedouble))
-            {
-                cJSONUtils_GeneratePatch(patches, (const unsigned char*)"replace", path, 0, to);
-            }
-            return;
+        difference = (a->number > b->number) - (a->number < b->number);
+    }
+    else if (a->rank == 5)
+    {
+        difference = (sort->flags & cJSONUtils_SortCaseInsensitive)
+            ? cJSONUtils_strcasecmp((const unsigned char*)a->string, (const unsigned char*)b->string)
+            : strcmp(a->string, b->string);
+    }
 
-        case cJSON_String:
-            if (strcmp(from->valuestring, to->valuestring) != 0)
-            {
-                cJSONUtils_GeneratePatch(patches, (const unsigned char*)"replace", path, 0, to);
-            }
-            return;
+    return (sort->flags & cJSONUtils_SortDescending) ? -difference : difference;
+}
 
-        case cJSON_Array:
+/* bottom up mergesort of the entries between two buffers, equal entries keep their order */
+static cJSONUtils_SortEntry *cJSONUtils_SortEntries(const cJSONUtils_ArraySort *sort, cJSONUtils_SortEntry *entries, cJSONUtils_SortEntry *scratch, size_t count)
+{
+    size_t width = 1;
+
+    for (width = 1; width < count; width *= 2)
+    {
+        cJSONUtils_SortEntry *swap = NULL;
+        size_t start = 0;
+
+        for (start = 0; start < count; start += 2 * width)
         {
-            size_t c = 0;
-            unsigned char *newpath = (unsigned char*)malloc(strlen((const char*)path) + 23); /* Allow space for 64bit int. */
-            /* generate patches for all array elements that exist in "from" and "to" */
-            for ((void)(c = 0), (void)(from = from->child), to = to->child; from && to; (void)(from = from->next), (void)(to = to->next), c++)
+            size_t first = start;
+            size_t middle = ((count - start) > width) ? (start + width) : count;
+            size_t second = middle;
+            size_t end = ((count - middle) > width) ? (middle + width) : count;
+            size_t output = start;
+
+            while ((first < middle) && (second < end))
             {
-                /* check if conversion to unsigned long is valid
-                 * This should be eliminated at compile time by dead code elimination
-                 * if size_t is an alias of unsigned long, or if it is bigger */
-                if (c > ULONG_MAX)
+                if (cJSONUtils_CompareEntries(sort, &entries[second], &entries[first]) < 0)
                 {
-                    free(newpath);
-                    return;
+                    scratch[output++] = entries[second++];
                 }
-                sprintf((char*)newpath, "%s/%lu", path, (unsigned long)c); /* path of the current array element */
-                cJSONUtils_CompareToPatch(patches, newpath, from, to);
-            }
-            /* remove leftover elements from 'from' that are not in 'to' */
-            for (; from; (void)(from = from->next), c++)
-            {
-                /* check if conversion to unsigned long is valid
-                 * This should be eliminated at compile time by dead code elimination
-                 * if size_t is an alias of unsigned long, or if it is bigger */
-                if (c > ULONG_MAX)
+                else
                 {
-                    free(newpath);
-                    return;
+                    scratch[output++] = entries[first++];
                 }
-                sprintf((char*)newpath, "%lu", (unsigned long)c);
-                cJSONUtils_GeneratePatch(patches, (const unsigned char*)"remove", path, newpath, 0);
             }
-            /* add new elements in 'to' that were not in 'from' */
-            for (; to; (void)(to = to->next), c++)
+            while (first < middle)
             {
-                cJSONUtils_GeneratePatch(patches, (const unsigned char*)"add", path, (const unsigned char*)"-", to);
+                scratch[output++] = entries[first++];
             }
-            free(newpath);
-            return;
-        }
-
-        case cJSON_Object:
-        {
-            cJSON *a = NULL;
-            cJSON *b = NULL;
-            cJSONUtils_SortObject(from);
-            cJSONUtils_SortObject(to);
-
-            a = from->child;
-            b = to->child;
-            /* for all object values in the object with more of them */
-            while (a || b)
+            while (second < end)
             {
-                int diff = (!a) ? 1 : ((!b) ? -1 : cJSONUtils_strcasecmp((unsigned char*)a->string, (unsigned char*)b->string));
-                if (!diff)
-                {
-                    /* both object keys are the same */
-                    unsigned char *newpath = (unsigned char*)malloc(strlen((const char*)path) + cJSONUtils_PointerEncodedstrlen((unsigned char*)a->string) + 2);
-                    cJSONUtils_PointerEncodedstrcpy(newpath + sprintf((char*)newpath, "%s/", path), (unsigned char*)a->string);
-                    /* create a patch for the element */
-                    cJSONUtils_CompareToPatch(patches, newpath, a, b);
-                    free(newpath);
-                    a = a->next;
-                    b = b->next;
-                }
-                else if (diff < 0)
-                {
-                    /* object element doesn't exist in 'to' --> remove it */
-                    cJSONUtils_GeneratePatch(patches, (const unsigned char*)"remove", path, (unsigned char*)a->string, 0);
-                    a = a->next;
-                }
-                else
-                {
-                    /* object element doesn't exist in 'from' --> add it */
-                    cJSONUtils_GeneratePatch(patches, (const unsigned char*)"add", path, (unsigned char*)b->string, b);
-                    b = b->next;
-                }
+                scratch[output++] = entries[second++];
             }
-            return;
         }
-
-        default:
-            break;
+        swap = entries;
+        entries = scratch;
+        scratch = swap;
     }
-}
-
-CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatches(cJSON *from, cJSON *to)
-{
-    cJSON *patches = cJSON_CreateArray();
-    cJSONUtils_CompareToPatch(patches, (const unsigned char*)"", from, to);
 
-    return patches;
+    return entries;
 }
 
-/* sort lists using mergesort */
-static cJSON *cJSONUtils_SortList(cJSON *list)
+static cJSON_bool cJSONUtils_SortArrayWith(cJSON *array, const cJSONUtils_ArraySort *sort, const char *key)
 {
-    cJSON *first = list;
-    cJSON *second = list;
-    cJSON *ptr = list;
+    cJSONUtils_SortEntry *entries = NULL;
+    cJSONUtils_SortEntry *sorted = NULL;
+    cJSON *element = NULL;
+    size_t count = 0;
+    size_t i = 0;
 
-    if (!list || !list->next)
+    if (!cJSON_IsArray(array) || (array->type & cJSON_IsFrozen))
     {
-        /* One entry is sorted already. */
-        return list;
+        return 0;
     }
 
-    while (ptr && ptr->next && (cJSONUtils_strcasecmp((unsigned char*)ptr->string, (unsigned char*)ptr->next->string) < 0))
+    /* loads lazy and packed arrays */
+    cJSON_GetArrayItem(array, 0);
+    for (element = array->child; element != NULL; element = element->next)
     {
-        /* Test for list sorted. */
-        ptr = ptr->next;
+        count++;
     }
-    if (!ptr || !ptr->next)
+    if (count < 2)
     {
-        /* Leave sorted lists unmodified. */
-        return list;
+        return 1;
     }
 
-    /* reset ptr to the beginning */
-    ptr = list;
-    while (ptr)
+    /* the entries and the buffer they are merged into, the one allocation there is */
+    entries = (cJSONUtils_SortEntry*)malloc(2 * count * sizeof(cJSONUtils_SortEntry));
+    if (entries == NULL)
     {
-        /* Walk two pointers to find the middle. */
-        second = second->next;
-        ptr = ptr->next;
-        /* advances ptr two steps at a time */
-        if (ptr)
+        return 0;
+    }
+    for (element = array->child, i = 0; element != NULL; element = element->next, i++)
+    {
+        entries[i].item = element;
+        if (key != NULL)
         {
-            ptr = ptr->next;
+            cJSONUtils_ReadSortKey(&entries[i], key);
         }
     }
-    if (second && second->prev)
+
+    for (i = 1; (i < count) && (cJSONUtils_CompareEntries(sort, &entries[i - 1], &entries[i]) <= 0); i++)
     {
-        /* Split the lists */
-        second->prev->next = NULL;
     }
-
-    /* Recursively sort the sub-lists. */
-    first = cJSONUtils_SortList(first);
-    second = cJSONUtils_SortList(second);
-    list = ptr = NULL;
-
-    while (first && second) /* Merge the sub-lists */
+    if (i < count)
     {
-        if (cJSONUtils_strcasecmp((unsigned char*)first->string, (unsigned char*)second->string) < 0)
+        /* relink the children in their new order */
+        sorted = cJSONUtils_SortEntries(sort, entries, entries + count, count);
+        array->child = sorted[0].item;
+        sorted[0].item->prev = sorted[count - 1].item;
+        for (i = 1; i < count; i++)
         {
-            if (!list)
-            {
-                /* start merged list with the first element of the first list */
-                list = ptr = first;
-            }
-            else
-            {
-                /* add first element of first list to merged list */
-                ptr->next = first;
-                first->prev = ptr;
-                ptr = first;
-            }
-            first = first->next;
+            sorted[i - 1].item->next = sorted[i].item;
+            sorted[i].item->prev = sorted[i - 1].item;
         }
-        else
+        sorted[count - 1].item->next = NULL;
+
+        if (array->type & cJSON_IsIndexed)
         {
-            if (!list)
-            {
-                /* start merged list with the first element of the second list */
-                list = ptr = second;
-            }
-            else
-            {
-                /* add first element of second list to merged list */
-                ptr->next = second;
-                second->prev = ptr;
-                ptr = second;
-            }
-            second = second->next;
+            cJSON_BuildIndex(array);
         }
+        array->type &= ~(cJSON_IsRendered | cJSON_IsHashed);
     }
-    if (first)
+    free(entries);
+
+    return 1;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSONUtils_SortArray(cJSON *array, cJSONUtils_ArrayComparator compare, void *context)
+{
+    cJSONUtils_ArraySort sort;
+
+    if (compare == NULL)
     {
-        /* Append rest of first list. */
-        if (!list)
-        {
-            return first;
-        }
-        ptr->next = first;
-        first->prev = ptr;
+        return 0;
     }
-    if (second)
+    sort.compare = compare;
+    sort.context = context;
+    sort.flags = 0;
+
+    return cJSONUtils_SortArrayWith(array, &sort, NULL);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSONUtils_SortArrayByKey(cJSON *array, const char *key, int flags)
+{
+    cJSONUtils_ArraySort sort;
+
+    if (key == NULL)
     {
-        /* Append rest of second list */
-        if (!list)
-        {
-            return second;
-        }
-        ptr->next = second;
-        second->prev = ptr;
+        return 0;
     }
+    sort.compare = NULL;
+    sort.context = NULL;
+    sort.flags = flags;
 
-    return list;
+    return cJSONUtils_SortArrayWith(array, &sort, key);
 }
 
-CJSON_PUBLIC(void) cJSONUtils_SortObject(cJSON *object)
+typedef struct cJSONUtils_MergeFrame
 {
-    object->child = cJSONUtils_SortList(object->child);
-}
+    cJSON *target;
+    cJSON *patch;
+} cJSONUtils_MergeFrame;
 
 CJSON_PUBLIC(cJSON *) cJSONUtils_MergePatch(cJSON *target, cJSON *patch)
 {
+    cJSONUtils_MergeFrame *stack = NULL;
+    size_t size = 0;
+    size_t depth = 0;
+
     if (!cJSON_IsObject(patch))
     {
         /* scalar value, array or NULL, just duplicate */
@@ -807,21 +3747,77 @@ CJSON_PUBLIC(cJSON *) cJSONUtils_MergePatch(cJSON *target, cJSON *patch)
         target = cJSON_CreateObject();
     }
 
-    patch = patch->child;
-    while (patch)
+    /* objects are merged without recursion, each frame is an object of the target and the next member of the
+     * patch for it. Members are replaced where they are, so they keep their position and key. */
+    stack = (cJSONUtils_MergeFrame*)malloc(16 * sizeof(cJSONUtils_MergeFrame));
+    if (stack == NULL)
+    {
+        return target;
+    }
+    size = 16;
+    stack[0].target = target;
+    stack[0].patch = patch->child;
+    depth = 1;
+
+    while (depth > 0)
     {
-        if (cJSON_IsNull(patch))
+        cJSONUtils_MergeFrame *frame = &stack[depth - 1];
+        cJSON *member = frame->patch;
+        cJSON *existing = NULL;
+        cJSON *replacement = NULL;
+
+        if (member == NULL)
+        {
+            depth--;
+            continue;
+        }
+        frame->patch = member->next;
+
+        if (cJSON_IsNull(member))
         {
             /* NULL is the indicator to remove a value, see RFC7396 */
-            cJSON_DeleteItemFromObject(target, patch->string);
+            cJSON_DeleteItemFromObject(frame->target, member->string);
+            continue;
+        }
+
+        existing = cJSON_GetObjectItem(frame->target, member->string);
+        if (cJSON_IsObject(member) && cJSON_IsObject(existing))
+        {
+            replacement = existing;
         }
         else
         {
-            cJSON *replaceme = cJSON_DetachItemFromObject(target, patch->string);
-            cJSON_AddItemToObject(target, patch->string, cJSONUtils_MergePatch(replaceme, patch));
+            replacement = cJSON_IsObject(member) ? cJSON_CreateObject() : cJSON_Duplicate(member, 1);
+            if (existing)
+            {
+                cJSON_ReplaceItemViaPointer(frame->target, existing, replacement);
+            }
+            else
+            {
+                cJSON_AddItemToObject(frame->target, member->string, replacement);
+            }
+        }
+
+        if (cJSON_IsObject(member) && (replacement != NULL))
+        {
+            /* merge into the object */
+            if (depth == size)
+            {
+                cJSONUtils_MergeFrame *grown = (cJSONUtils_MergeFrame*)realloc(stack, 2 * size * sizeof(cJSONUtils_MergeFrame));
+                if (grown == NULL)
+                {
+                    break;
+                }
+                stack = grown;
+                size *= 2;
+            }
+            stack[depth].target = replacement;
+            stack[depth].patch = member->child;
+            depth++;
         }
-        patch = patch->next;
     }
+    free(stack);
+
     return target;
 }
 
@@ -838,8 +3834,9 @@ CJSON_PUBLIC(cJSON *) cJSONUtils_GenerateMergePatch(cJSON *from, cJSON *to)
         return cJSON_Duplicate(to, 1);
     }
 
-    cJSONUtils_SortObject(from);
-    cJSONUtils_SortObject(to);
+    /* in the order of strcmp, like the comparison below */
+    cJSONUtils_SortObjectCaseSensitive(from);
+    cJSONUtils_SortObjectCaseSensitive(to);
 
     from = from->child;
     to = to->child;
@@ -880,3 +3877,123 @@ CJSON_PUBLIC(cJSON *) cJSONUtils_GenerateMergePatch(cJSON *from, cJSON *to)
 
     return patch;
 }
+
+/* a member of the merge patch of cJSONUtils_GenerateMergePatchParallel, from or to are NULL if it only exists in one */
+typedef struct cJSONUtils_MergeEntry
+{
+    cJSON *from;
+    cJSON *to;
+    cJSON *patch;
+} cJSONUtils_MergeEntry;
+
+typedef struct cJSONUtils_MergeBatch
+{
+    cJSONUtils_MergeEntry *entries;
+    size_t count;
+} cJSONUtils_MergeBatch;
+
+static void cJSONUtils_MergeTask(void *task_data, size_t index)
+{
+    cJSONUtils_MergeBatch *batch = &((cJSONUtils_MergeBatch*)task_data)[index];
+    cJSONUtils_MergeEntry *entry = NULL;
+    size_t i = 0;
+
+    for (i = 0; i < batch->count; i++)
+    {
+        entry = &batch->entries[i];
+        if (entry->to == NULL)
+        {
+            entry->patch = cJSON_CreateNull();
+        }
+        else if (entry->from == NULL)
+        {
+            entry->patch = cJSON_Duplicate(entry->to, 1);
+        }
+        else if (cJSONUtils_Compare(entry->from, entry->to))
+        {
+            entry->patch = cJSONUtils_GenerateMergePatch(entry->from, entry->to);
+        }
+    }
+}
+
+CJSON_PUBLIC(cJSON *) cJSONUtils_GenerateMergePatchParallel(cJSON *from, cJSON *to, const cJSON_Executor *executor, size_t tasks)
+{
+    cJSONUtils_MergeEntry *entries = NULL;
+    cJSONUtils_MergeBatch *batches = NULL;
+    cJSON *patch = NULL;
+    size_t count = 0;
+    size_t i = 0;
+
+    if (!cJSON_IsObject(to) || !cJSON_IsObject(from) || (executor == NULL) || (executor->run == NULL) || (tasks < 2)
+            || (tasks > ((size_t)-1 / sizeof(cJSONUtils_MergeBatch))))
+    {
+        return cJSONUtils_GenerateMergePatch(from, to);
+    }
+
+    /* in the order of strcmp, like cJSONUtils_GenerateMergePatch */
+    cJSONUtils_SortObjectCaseSensitive(from);
+    cJSONUtils_SortObjectCaseSensitive(to);
+    entries = (cJSONUtils_MergeEntry*)malloc(((size_t)cJSON_GetArraySize(from) + (size_t)cJSON_GetArraySize(to) + 1) * sizeof(cJSONUtils_MergeEntry));
+    batches = (cJSONUtils_MergeBatch*)malloc(tasks * sizeof(cJSONUtils_MergeBatch));
+    if ((entries == NULL) || (batches == NULL))
+    {
+        free(entries);
+        free(batches);
+        return cJSONUtils_GenerateMergePatch(from, to);
+    }
+
+    /* the members are matched here, their patches are generated by the tasks */
+    from = from->child;
+    to = to->child;
+    while (from || to)
+    {
+        int compare = from ? (to ? strcmp(from->string, to->string) : -1) : 1;
+        entries[count].from = (compare <= 0) ? from : NULL;
+        entries[count].to = (compare >= 0) ? to : NULL;
+        entries[count].patch = NULL;
+        count++;
+        if (compare <= 0)
+        {
+            from = from->next;
+        }
+        if (compare >= 0)
+        {
+            to = to->next;
+        }
+    }
+
+    if (tasks > count)
+    {
+        tasks = count;
+    }
+    for (i = 0; i < tasks; i++)
+    {
+        batches[i].entries = entries + ((count / tasks) * i) + ((i < (count % tasks)) ? i : (count % tasks));
+        batches[i].count = (count / tasks) + ((i < (count % tasks)) ? 1 : 0);
+    }
+    if (tasks > 0)
+    {
+        executor->run(cJSONUtils_MergeTask, batches, tasks, executor->executor_data);
+    }
+
+    patch = cJSON_CreateObject();
+    for (i = 0; i < count; i++)
+    {
+        const char *name = (entries[i].to != NULL) ? entries[i].to->string : entries[i].from->string;
+        if (patch == NULL)
+        {
+            cJSON_Delete(entries[i].patch);
+            continue;
+        }
+        cJSON_AddItemToObject(patch, name, entries[i].patch);
+    }
+    free(entries);
+    free(batches);
+    if ((patch != NULL) && !patch->child)
+    {
+        cJSON_Delete(patch);
+        return NULL;
+    }
+
+    return patch;
+}
@@ -2,43 +2,77 @@
 
 /* Implement RFC6901 (https://tools.ietf.org/html/rfc6901) JSON Pointer spec. */
 CJSON_PUBLIC(cJSON *) cJSONUtils_GetPointer(cJSON *object, const char *pointer);
+/* A pointer that is split into tokens and decoded once, for looking it up in many documents. */
+typedef struct cJSONUtils_Pointer cJSONUtils_Pointer;
+/* Returns NULL if out of memory. */
+CJSON_PUBLIC(cJSONUtils_Pointer *) cJSONUtils_CompilePointer(const char *pointer);
+/* Same result as cJSONUtils_GetPointer, but the lookups use the index of arrays and objects if they have one (see
+ * cJSON_BuildIndex). */
+CJSON_PUBLIC(cJSON *) cJSONUtils_EvaluatePointer(cJSON *object, const cJSONUtils_Pointer *pointer);
+/* Evaluates count pointers at once, results[i] is what pointers[i] points to or NULL. Pointers that share a prefix
+ * only look it up once. Returns the number of pointers that were found. */
+CJSON_PUBLIC(size_t) cJSONUtils_EvaluatePointers(cJSON *object, const cJSONUtils_Pointer * const *pointers, size_t count, cJSON **results);
+CJSON_PUBLIC(void) cJSONUtils_DeletePointer(cJSONUtils_Pointer *pointer);
+
+/* JSONPath-style queries: "$" followed by ".name", "['name']", "[n]", ".*" or "[*]", "..name" (at any depth) and
+ * filters like "[?(@.status=='active')]" or "[?(@.price < 10)]" that compare with a JSON value or a string in single
+ * quotes; "[?(@.name)]" only tests whether a member exists. Names are case sensitive. */
+typedef struct cJSONUtils_Query cJSONUtils_Query;
+/* Returns NULL if the expression is invalid or out of memory. */
+CJSON_PUBLIC(cJSONUtils_Query *) cJSONUtils_CompileQuery(const char *expression);
+/* Called for every item that matches queries[query]; returning 0 stops the evaluation. */
+typedef cJSON_bool (*cJSONUtils_QueryCallback)(size_t query, cJSON *match, void *context);
+/* Evaluates count queries in one walk over object, only descending into items some query can still match below.
+ * Children are looked up through the index (see cJSON_BuildIndex) when all queries only want one of them.
+ * callback may be NULL. Returns the number of matches. */
+CJSON_PUBLIC(size_t) cJSONUtils_EvaluateQueries(cJSON *object, const cJSONUtils_Query * const *queries, size_t count, cJSONUtils_QueryCallback callback, void *context);
+/* Returns an array with references to the matches, NULL if out of memory. */
+CJSON_PUBLIC(cJSON *) cJSONUtils_EvaluateQuery(cJSON *object, const cJSONUtils_Query *query);
+CJSON_PUBLIC(void) cJSONUtils_DeleteQuery(cJSONUtils_Query *query);
 
 /* Implement RFC6902 (https://tools.ietf.org/html/rfc6902) JSON Patch spec. */
 CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatches(cJSON *from, cJSON *to);
+/* cJSONUtils_GeneratePatches with the subtrees below from and to hashed and diffed by up to tasks tasks of executor
+ * (see cJSON_ParseParallel). The patches are the same and in the same order. The hooks must be thread safe. */
+CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatchesParallel(cJSON *from, cJSON *to, const cJSON_Executor *executor, size_t tasks);
 /* Utility for generating patch array entries. */
 CJSON_PUBLIC(void) cJSONUtils_AddPatchToArray(cJSON *array, const char *op, const char *path, cJSON *val);
-/* Returns 0 for success. */
+/* Returns 0 for success. The patches are applied atomically: if one of them fails, the changes made by the ones
+ * before are undone and object is left as it was. */
 CJSON_PUBLIC(int) cJSONUtils_ApplyPatches(cJSON *object, cJSON *patches);
-
-/*
-// Note that ApplyPatches is NOT atomic on failure. To implement an atomic ApplyPatches, use:
-//int cJSONUtils_AtomicApplyPatches(cJSON **object, cJSON *patches)
-//{
-//    cJSON *modme = cJSON_Duplicate(*object, 1);
-//    int error = cJSONUtils_ApplyPatches(modme, patches);
-//    if (!error)
-//    {
-//        cJSON_Delete(*object);
-//        *object = modme;
-//    }
-//    else
-//    {
-//        cJSON_Delete(modme);
-//    }
-//
-//    return error;
-//}
-// Code not added to library since this strategy is a LOT slower.
-*/
+/* Apply patches to the JSON text of length bytes and hand the result to writer (see cJSON_PrintToWriter) without
+ * parsing all of it: only the values the patches need are parsed, everything else is copied as it is, so the parts in
+ * between are only checked for their nesting. The changed arrays and objects are printed unformatted. Nothing is written
+ * unless all patches apply. Returns what cJSONUtils_ApplyPatches returns, 10 if json can't be read and 11 if writer
+ * failed. */
+CJSON_PUBLIC(int) cJSONUtils_ApplyPatchesToWriter(const char *json, size_t length, cJSON *patches, cJSON_WriteFunction writer, void *context);
 
 /* Implement RFC7386 (https://tools.ietf.org/html/rfc7396) JSON Merge Patch spec. */
 /* target will be modified by patch. return value is new ptr for target. */
 CJSON_PUBLIC(cJSON *) cJSONUtils_MergePatch(cJSON *target, cJSON *patch);
 /* generates a patch to move from -> to */
 CJSON_PUBLIC(cJSON *) cJSONUtils_GenerateMergePatch(cJSON *from, cJSON *to);
+/* Same, but the members of the objects are split between up to tasks tasks of executor. The patch is the same. */
+CJSON_PUBLIC(cJSON *) cJSONUtils_GenerateMergePatchParallel(cJSON *from, cJSON *to, const cJSON_Executor *executor, size_t tasks);
 
 /* Given a root object and a target object, construct a pointer from one to the other. */
 CJSON_PUBLIC(char *) cJSONUtils_FindPointerFromObjectTo(cJSON *object, cJSON *target);
+/* Same for count targets in one traversal, pointers[i] is the pointer to targets[i] (or NULL if it isn't in object).
+ * Returns the number of targets that were found, free the pointers with free(). */
+CJSON_PUBLIC(size_t) cJSONUtils_FindPointersFromObjectTo(cJSON *object, cJSON * const *targets, size_t count, char **pointers);
 
-/* Sorts the members of the object into alphabetical order. */
+/* Sorts the members of the object into alphabetical order, case insensitive. Members with the same name keep their
+ * order. An object that is sorted already is only walked once. */
 CJSON_PUBLIC(void) cJSONUtils_SortObject(cJSON *object);
+/* Same, in the order of strcmp. */
+CJSON_PUBLIC(void) cJSONUtils_SortObjectCaseSensitive(cJSON *object);
+/* Stable sorts of the elements of an array, which are relinked in place. Returns 0 if array isn't an array, is frozen or
+ * out of memory (the order is unchanged then). */
+typedef int (*cJSONUtils_ArrayComparator)(const cJSON *a, const cJSON *b, void *context);
+CJSON_PUBLIC(cJSON_bool) cJSONUtils_SortArray(cJSON *array, cJSONUtils_ArrayComparator compare, void *context);
+/* Flags for cJSONUtils_SortArrayByKey */
+#define cJSONUtils_SortDescending 1 /* reverses the order, equal elements still keep theirs */
+#define cJSONUtils_SortCaseInsensitive 2 /* strings are compared case insensitively */
+/* Sorts the elements by the value of their member key (case sensitive), which is looked up once per element. Elements
+ * without it come first, then null, false, true, numbers, strings (strcmp) and arrays or objects, which are all equal. */
+CJSON_PUBLIC(cJSON_bool) cJSONUtils_SortArrayByKey(cJSON *array, const char *key, int flags);
@@ -0,0 +1,586 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+/* Measures how the cost of parsing, printing, duplicating, looking up and diffing an input grows when the input is made
+ * bigger, and flags inputs whose cost grows faster than their size. An input is grown along three dimensions: the widest
+ * array or object gets more copies of its children, the deepest array or object gets copies of the whole document
+ * nested into it and the longest string literal is repeated. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../cJSON.h"
+#include "../cJSON_Utils.h"
+
+/* Every operation is repeated until it ran for at least this long */
+#define MINIMUM_SECONDS 0.05
+/* an input is measured grown by these factors */
+#define SMALL_FACTOR 8
+#define LARGE_FACTOR 32
+/* the cost per byte may grow this much between the two sizes, linear cost stays at 1, quadratic cost reaches 4 */
+#define GROWTH_LIMIT 2.5
+
+typedef struct
+{
+    char *json;
+    size_t length;
+    cJSON *tree;
+    cJSON *changed; /* the second document for generating patches */
+} document;
+
+typedef struct
+{
+    double nanoseconds; /* per input byte */
+    double allocations; /* per input byte */
+} cost;
+
+enum dimension
+{
+    WIDTH,
+    DEPTH,
+    STRING,
+    DIMENSIONS
+};
+
+static const char *dimension_names[DIMENSIONS] = { "width", "depth", "string" };
+
+enum operation
+{
+    PARSE,
+    PRINT,
+    DUPLICATE,
+    LOOKUP,
+    GENERATE_PATCHES,
+    OPERATIONS
+};
+
+static const char *operation_names[OPERATIONS] = { "parse", "print", "duplicate", "lookup", "generate_patches" };
+
+static size_t allocations = 0;
+
+static void *counting_malloc(size_t size)
+{
+    allocations++;
+    return malloc(size);
+}
+
+static void counting_free(void *pointer)
+{
+    free(pointer);
+}
+
+static char *read_file(const char *filename, size_t *length)
+{
+    FILE *file = NULL;
+    long size = 0;
+    char *content = NULL;
+
+    file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    if ((fseek(file, 0, SEEK_END) != 0) || ((size = ftell(file)) < 0) || (fseek(file, 0, SEEK_SET) != 0))
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    content = (char*)malloc((size_t)size + 1);
+    if ((content != NULL) && (fread(content, 1, (size_t)size, file) != (size_t)size))
+    {
+        free(content);
+        content = NULL;
+    }
+    fclose(file);
+    if (content == NULL)
+    {
+        return NULL;
+    }
+    content[size] = '\0';
+    *length = (size_t)size;
+
+    return content;
+}
+
+static cJSON_bool is_container(const cJSON * const item)
+{
+    return cJSON_IsArray(item) || cJSON_IsObject(item);
+}
+
+static void find_widest(cJSON * const item, cJSON ** const widest, int * const width)
+{
+    cJSON *child = NULL;
+    int count = 0;
+
+    for (child = item->child; child != NULL; child = child->next)
+    {
+        count++;
+        find_widest(child, widest, width);
+    }
+    if (is_container(item) && (count > *width))
+    {
+        *widest = item;
+        *width = count;
+    }
+}
+
+static void find_deepest(cJSON * const item, const int level, cJSON ** const deepest, int * const depth)
+{
+    cJSON *child = NULL;
+
+    if (!is_container(item))
+    {
+        return;
+    }
+    if (level > *depth)
+    {
+        *deepest = item;
+        *depth = level;
+    }
+    for (child = item->child; child != NULL; child = child->next)
+    {
+        find_deepest(child, level + 1, deepest, depth);
+    }
+}
+
+static void add_copy(cJSON * const container, const cJSON * const item, const char * const name, const int suffix)
+{
+    cJSON *copy = cJSON_Duplicate(item, 1);
+    char *key = NULL;
+
+    if (!cJSON_IsObject(container))
+    {
+        cJSON_AddItemToArray(container, copy);
+        return;
+    }
+
+    /* the copies of a member get their own names, so they can be looked up */
+    key = (char*)malloc(((name == NULL) ? 0 : strlen(name)) + 16);
+    if (key == NULL)
+    {
+        cJSON_Delete(copy);
+        return;
+    }
+    sprintf(key, "%s~%d", (name == NULL) ? "" : name, suffix);
+    cJSON_AddItemToObject(container, key, copy);
+    free(key);
+}
+
+/* more copies of the children of the widest array or object */
+static cJSON *grow_width(const cJSON * const tree, const int factor)
+{
+    cJSON *grown = cJSON_Duplicate(tree, 1);
+    cJSON *widest = NULL;
+    cJSON *children = NULL;
+    const cJSON *child = NULL;
+    int width = 0;
+    int i = 0;
+
+    if (grown == NULL)
+    {
+        return NULL;
+    }
+    find_widest(grown, &widest, &width);
+    if (width < 2)
+    {
+        cJSON_Delete(grown);
+        return NULL;
+    }
+
+    children = cJSON_Duplicate(widest, 1);
+    for (i = 1; (children != NULL) && (i < factor); i++)
+    {
+        for (child = children->child; child != NULL; child = child->next)
+        {
+            add_copy(widest, child, child->string, i);
+        }
+    }
+    cJSON_Delete(children);
+
+    return grown;
+}
+
+/* copies of the whole document nested into the deepest array or object, one inside the other */
+static cJSON *grow_depth(const cJSON * const tree, const int factor)
+{
+    cJSON *grown = cJSON_Duplicate(tree, 1);
+    cJSON *deepest = NULL;
+    int depth = 0;
+    int i = 0;
+
+    if (grown == NULL)
+    {
+        return NULL;
+    }
+    find_deepest(grown, 1, &deepest, &depth);
+    if ((depth < 4) || (depth * factor > CJSON_NESTING_LIMIT))
+    {
+        cJSON_Delete(grown);
+        return NULL;
+    }
+
+    for (i = 1; i < factor; i++)
+    {
+        cJSON *copy = NULL;
+        int copy_depth = 0;
+
+        add_copy(deepest, tree, "", i);
+        copy = deepest->child->prev;
+        deepest = NULL;
+        find_deepest(copy, 1, &deepest, &copy_depth);
+        if (deepest == NULL)
+        {
+            cJSON_Delete(grown);
+            return NULL;
+        }
+    }
+
+    return grown;
+}
+
+/* The longest string literal repeated, this works on the text so escape sequences stay as they are. */
+static char *grow_string(const document * const doc, const int factor, size_t * const length)
+{
+    size_t start = 0;
+    size_t longest = 0;
+    size_t position = 0;
+    char *grown = NULL;
+    int i = 0;
+
+    for (position = 0; position < doc->length; position++)
+    {
+        size_t end = 0;
+
+        if (doc->json[position] != '\"')
+        {
+            continue;
+        }
+        for (end = position + 1; (end < doc->length) && (doc->json[end] != '\"'); end++)
+        {
+            if (doc->json[end] == '\\')
+            {
+                end++;
+            }
+        }
+        if (end >= doc->length)
+        {
+            break;
+        }
+        if ((end - position - 1) > longest)
+        {
+            start = position + 1;
+            longest = end - position - 1;
+        }
+        position = end;
+    }
+    if (longest < 8)
+    {
+        return NULL;
+    }
+
+    *length = doc->length + (longest * (size_t)(factor - 1));
+    grown = (char*)malloc(*length + 1);
+    if (grown == NULL)
+    {
+        return NULL;
+    }
+    memcpy(grown, doc->json, start + longest);
+    position = start + longest;
+    for (i = 1; i < factor; i++)
+    {
+        memcpy(grown + position, doc->json + start, longest);
+        position += longest;
+    }
+    memcpy(grown + position, doc->json + start + longest, doc->length - start - longest);
+    grown[*length] = '\0';
+
+    return grown;
+}
+
+static void delete_document(document * const doc)
+{
+    free(doc->json);
+    cJSON_Delete(doc->tree);
+    cJSON_Delete(doc->changed);
+    doc->json = NULL;
+    doc->tree = NULL;
+    doc->changed = NULL;
+}
+
+/* Parses the text of doc, it takes ownership of json. */
+static cJSON_bool load_document(document * const doc, char * const json, const size_t length)
+{
+    doc->json = json;
+    doc->length = length;
+    doc->tree = NULL;
+    doc->changed = NULL;
+    if (json == NULL)
+    {
+        return 0;
+    }
+
+    doc->tree = cJSON_ParseWithLength(json, length);
+    doc->changed = cJSON_Duplicate(doc->tree, 1);
+    if ((doc->tree == NULL) || (doc->changed == NULL))
+    {
+        delete_document(doc);
+        return 0;
+    }
+    if (is_container(doc->changed) && (doc->changed->child != NULL))
+    {
+        cJSON_DeleteItemFromArray(doc->changed, 0);
+    }
+
+    /* indexes for the lookups, and the tree isn't changed by them */
+    if (!cJSON_Freeze(doc->tree))
+    {
+        delete_document(doc);
+        return 0;
+    }
+
+    return 1;
+}
+
+static cJSON_bool grow(const document * const doc, const enum dimension dimension, const int factor, document * const grown)
+{
+    cJSON *tree = NULL;
+    char *json = NULL;
+    size_t length = 0;
+
+    switch (dimension)
+    {
+        case WIDTH:
+            tree = grow_width(doc->tree, factor);
+            break;
+        case DEPTH:
+            tree = grow_depth(doc->tree, factor);
+            break;
+        case STRING:
+            json = grow_string(doc, factor, &length);
+            break;
+        default:
+            break;
+    }
+    if (tree != NULL)
+    {
+        json = cJSON_PrintUnformatted(tree);
+        length = (json == NULL) ? 0 : strlen(json);
+        cJSON_Delete(tree);
+    }
+
+    return load_document(grown, json, length);
+}
+
+/* every item looked up by its position or name */
+static void look_up(const cJSON * const item)
+{
+    const cJSON *child = NULL;
+    int index = 0;
+
+    for (child = item->child; child != NULL; child = child->next, index++)
+    {
+        if (cJSON_IsObject(item) && (cJSON_GetObjectItemCaseSensitive(item, child->string) == NULL))
+        {
+            abort();
+        }
+        if (cJSON_IsArray(item) && (cJSON_GetArrayItem(item, index) != child))
+        {
+            abort();
+        }
+        look_up(child);
+    }
+}
+
+static void run_operation(const enum operation current, const document * const doc)
+{
+    cJSON *result = NULL;
+    cJSON *patches = NULL;
+    char *text = NULL;
+
+    switch (current)
+    {
+        case PARSE:
+            result = cJSON_ParseWithLength(doc->json, doc->length);
+            break;
+        case PRINT:
+            text = cJSON_PrintUnformatted(doc->tree);
+            break;
+        case DUPLICATE:
+            result = cJSON_Duplicate(doc->tree, 1);
+            break;
+        case LOOKUP:
+            look_up(doc->tree);
+            break;
+        case GENERATE_PATCHES:
+            /* generating patches sorts the objects, so it works on a copy */
+            result = cJSON_Duplicate(doc->tree, 1);
+            patches = cJSONUtils_GeneratePatches(result, doc->changed);
+            break;
+        default:
+            break;
+    }
+
+    cJSON_Delete(result);
+    cJSON_Delete(patches);
+    free(text);
+}
+
+static cost measure(const enum operation current, const document * const doc)
+{
+    cost measured;
+    size_t iterations = 0;
+    size_t allocations_before = 0;
+    double seconds = 0;
+    clock_t start = 0;
+
+    /* warm up and count the allocations of one run */
+    allocations_before = allocations;
+    run_operation(current, doc);
+    measured.allocations = (double)(allocations - allocations_before) / (double)doc->length;
+
+    start = clock();
+    do
+    {
+        run_operation(current, doc);
+        iterations++;
+        seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    } while (seconds < MINIMUM_SECONDS);
+    measured.nanoseconds = (seconds * 1e9) / ((double)doc->length * (double)iterations);
+
+    return measured;
+}
+
+static double growth(const double small, const double large)
+{
+    if (small <= 0)
+    {
+        return (large <= 0) ? 1 : large;
+    }
+
+    return large / small;
+}
+
+/* Returns the number of measurements that grew faster than linear. */
+static int check_input(const char * const filename)
+{
+    document doc;
+    size_t length = 0;
+    char *json = read_file(filename, &length);
+    enum dimension dimension = WIDTH;
+    int superlinear = 0;
+
+    if (!load_document(&doc, json, length))
+    {
+        printf("%s: not a JSON document\n", filename);
+        return 0;
+    }
+
+    for (dimension = WIDTH; dimension < DIMENSIONS; dimension = (enum dimension)(dimension + 1))
+    {
+        document small;
+        document large;
+        enum operation current = PARSE;
+
+        if (!grow(&doc, dimension, SMALL_FACTOR, &small))
+        {
+            continue;
+        }
+        if (!grow(&doc, dimension, LARGE_FACTOR, &large))
+        {
+            delete_document(&small);
+            continue;
+        }
+
+        for (current = PARSE; current < OPERATIONS; current = (enum operation)(current + 1))
+        {
+            cost small_cost = measure(current, &small);
+            cost large_cost = measure(current, &large);
+            double time_growth = growth(small_cost.nanoseconds, large_cost.nanoseconds);
+            double allocation_growth = growth(small_cost.allocations, large_cost.allocations);
+            cJSON_bool flagged = (time_growth > GROWTH_LIMIT) || (allocation_growth > GROWTH_LIMIT);
+
+            printf("%-24s %-6s %-16s %10.2f %10.2f ns/byte %6.2fx %8.3f %8.3f allocations/byte %6.2fx%s\n",
+                    filename,
+                    dimension_names[dimension],
+                    operation_names[current],
+                    small_cost.nanoseconds,
+                    large_cost.nanoseconds,
+                    time_growth,
+                    small_cost.allocations,
+                    large_cost.allocations,
+                    allocation_growth,
+                    flagged ? "  superlinear" : "");
+            if (flagged)
+            {
+                superlinear++;
+            }
+        }
+
+        delete_document(&small);
+        delete_document(&large);
+    }
+
+    delete_document(&doc);
+
+    return superlinear;
+}
+
+int main(int argc, char **argv)
+{
+    cJSON_Hooks hooks;
+    cJSON_bool abort_on_superlinear = 0;
+    int superlinear = 0;
+    int argument = 1;
+
+    if ((argc > 1) && (strcmp(argv[1], "--abort") == 0))
+    {
+        abort_on_superlinear = 1;
+        argument++;
+    }
+    if (argument >= argc)
+    {
+        printf("Usage:\n");
+        printf("%s [--abort] input_file...\n", argv[0]);
+        printf("\t --abort: abort on inputs whose cost grows faster than linear, so afl reports them as crashes\n");
+        printf("\t input_file: file containing a JSON document\n");
+        return EXIT_FAILURE;
+    }
+
+    hooks.malloc_fn = counting_malloc;
+    hooks.free_fn = counting_free;
+    cJSON_InitHooks(&hooks);
+
+    for (; argument < argc; argument++)
+    {
+        superlinear += check_input(argv[argument]);
+        if (abort_on_superlinear && (superlinear > 0))
+        {
+            fflush(stdout);
+            abort();
+        }
+    }
+
+    return (superlinear > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -3,6 +3,81 @@
 #include <string.h>
 #include "cJSON_Utils.h"
 
+/* collects the output of cJSONUtils_ApplyPatchesToWriter */
+typedef struct
+{
+    char data[256];
+    size_t length;
+} streamed_text;
+
+static cJSON_bool collect_text(const char *data, size_t length, void *context)
+{
+    streamed_text *text = (streamed_text*)context;
+    if ((text->length + length) >= sizeof(text->data))
+    {
+        return 0;
+    }
+    memcpy(text->data + text->length, data, length);
+    text->length += length;
+    text->data[text->length] = '\0';
+
+    return 1;
+}
+
+static int compare_numbers(const cJSON *a, const cJSON *b, void *context)
+{
+    (void)context;
+
+    return (a->valuedouble > b->valuedouble) - (a->valuedouble < b->valuedouble);
+}
+
+/* counts the matches of every query */
+static cJSON_bool count_query_match(size_t query, cJSON *match, void *context)
+{
+    (void)match;
+    ((size_t*)context)[query]++;
+
+    return 1;
+}
+
+/* runs the tasks backwards on this thread, so nothing can depend on their order */
+static void run_backwards(void (*task)(void *task_data, size_t index), void *task_data, size_t count, void *executor_data)
+{
+    (void)executor_data;
+    while (count-- > 0)
+    {
+        task(task_data, count);
+    }
+}
+
+/* 1 if the parallel patches are the same as the serial ones */
+static int same_parallel_patches(const char *from_json, const char *to_json, int merge)
+{
+    cJSON_Executor executor;
+    cJSON *from = cJSON_Parse(from_json);
+    cJSON *to = cJSON_Parse(to_json);
+    cJSON *serial = merge ? cJSONUtils_GenerateMergePatch(from, to) : cJSONUtils_GeneratePatches(from, to);
+    cJSON *parallel = NULL;
+    char *expected = cJSON_PrintUnformatted(serial);
+    char *actual = NULL;
+    int same = 0;
+
+    executor.run = run_backwards;
+    executor.executor_data = NULL;
+    parallel = merge ? cJSONUtils_GenerateMergePatchParallel(from, to, &executor, 3) : cJSONUtils_GeneratePatchesParallel(from, to, &executor, 3);
+    actual = cJSON_PrintUnformatted(parallel);
+    same = ((expected == NULL) && (actual == NULL)) || ((expected != NULL) && (actual != NULL) && !strcmp(expected, actual));
+
+    free(expected);
+    free(actual);
+    cJSON_Delete(from);
+    cJSON_Delete(to);
+    cJSON_Delete(serial);
+    cJSON_Delete(parallel);
+
+    return same;
+}
+
 int main(void)
 {
     /* Some variables */
@@ -28,6 +103,8 @@ int main(void)
         "}";
 
     const char *tests[12] = {"","/foo","/foo/0","/","/a~1b","/c%d","/e^f","/g|h","/i\\j","/k\"l","/ ","/m~0n"};
+    /* more pointers that have to give the same result when compiled */
+    const char *compiled_tests[8] = {"/FOO/1","/foo/","/foo/2","/foo/1x","/foo/99999999999999999999","/m~2n","/a~","foo"};
 
     /* JSON Apply Patch tests: */
     const char *patches[15][3] =
@@ -49,6 +126,14 @@ int main(void)
         {"{ \"foo\": [\"bar\"] }","[ { \"op\": \"add\", \"path\": \"/foo/-\", \"value\": [\"abc\", \"def\"] }]","{\"foo\": [\"bar\", [\"abc\", \"def\"]] }"}
     };
 
+    /* patches that fail after changing the document */
+    const char *atomic_patches[3] =
+    {
+        "[{\"op\":\"move\",\"from\":\"/a/0\",\"path\":\"/b/e\"},{\"op\":\"remove\",\"path\":\"/b/c\"},{\"op\":\"test\",\"path\":\"/b/e\",\"value\":2}]",
+        "[{\"op\":\"replace\",\"path\":\"/a/1\",\"value\":9},{\"op\":\"copy\",\"from\":\"/b\",\"path\":\"/a/0\"},{\"op\":\"add\",\"path\":\"/b/d\",\"value\":5},{\"op\":\"add\",\"path\":\"/x/y\",\"value\":1}]",
+        "[{\"op\":\"add\",\"path\":\"/a/-\",\"value\":4},{\"op\":\"move\",\"from\":\"/a/3\",\"path\":\"/a/0\"},{\"op\":\"move\",\"from\":\"/missing\",\"path\":\"/a/0\"}]"
+    };
+
     /* JSON Apply Merge tests: */
     const char *merges[15][3] =
     {
@@ -69,6 +154,30 @@ int main(void)
         {"{}","{\"a\":{\"bb\":{\"ccc\":null}}}", "{\"a\":{\"bb\":{}}}"}
     };
 
+    /* JSONPath-style query tests: */
+    const char *query_json =
+        "{\"store\":{\"items\":["
+        "{\"id\":1,\"price\":5,\"status\":\"active\"},"
+        "{\"id\":2,\"price\":15,\"status\":\"sold\"},"
+        "{\"id\":3,\"price\":8.5,\"status\":\"active\",\"tags\":[\"x\"]}"
+        "],\"id\":\"s\",\"name\":\"shop\"}}";
+    const char *queries_tests[12][2] =
+    {
+        {"$.store.items[*].price", "[5,15,8.5]"},
+        {"$..id", "[1,2,3,\"s\"]"},
+        {"$.store.items[?(@.status=='active')].id", "[1,3]"},
+        {"$.store.items[?(@.price < 10)].price", "[5,8.5]"},
+        {"$['store'][\"name\"]", "[\"shop\"]"},
+        {"$.store.items[1].status", "[\"sold\"]"},
+        {"$..[?(@.tags)].id", "[3]"},
+        {"$.store.items[?(@.status != \"sold\")].price", "[5,8.5]"},
+        {"$..tags[0]", "[\"x\"]"},
+        {"$.missing", "[]"},
+        {"$.store.items[?(@.id >= 2)].id", "[2,3]"},
+        {"$.store.*.missing", "[]"}
+    };
+    const char *invalid_queries[8] = {"store", "$.", "$[", "$[?(@.a==)]", "$[abc]", "$[?(@.a", "$.a[-1]", "$['a"};
+
 
     /* Misc tests */
     int numbers[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
@@ -80,6 +189,13 @@ int main(void)
     cJSON *nums = NULL;
     cJSON *num6 = NULL;
     cJSON *sortme = NULL;
+    cJSON *added = NULL;
+    cJSONUtils_Pointer *compiled_pointers[21];
+    cJSON *batch_results[21];
+    cJSONUtils_Query *queries[12];
+    size_t query_counts[12];
+    cJSON *targets[5];
+    char *found_pointers[5];
 
 
     printf("JSON Pointer Tests\n");
@@ -90,6 +206,80 @@ int main(void)
         printf("Test %d:\n%s\n\n", i + 1, output);
         free(output);
     }
+
+    printf("Compiled JSON Pointer Tests\n");
+    cJSON_BuildIndex(root);
+    for (i = 0; i < 20; i++)
+    {
+        const char *pointer = (i < 12) ? tests[i] : compiled_tests[i - 12];
+        cJSONUtils_Pointer *compiled = cJSONUtils_CompilePointer(pointer);
+        cJSON *found = cJSONUtils_EvaluatePointer(root, compiled);
+        printf("Test %d: %s\n", i + 1, (found == cJSONUtils_GetPointer(root, pointer)) ? "OK" : "FAIL");
+        cJSONUtils_DeletePointer(compiled);
+    }
+    printf("\n");
+
+    printf("Batched JSON Pointer Tests\n");
+    for (i = 0; i < 20; i++)
+    {
+        compiled_pointers[i] = cJSONUtils_CompilePointer((i < 12) ? tests[i] : compiled_tests[i - 12]);
+    }
+    compiled_pointers[20] = NULL;
+    cJSONUtils_EvaluatePointers(root, (const cJSONUtils_Pointer * const *)compiled_pointers, 21, batch_results);
+    for (i = 0; i < 21; i++)
+    {
+        cJSON *expected = (i < 20) ? cJSONUtils_GetPointer(root, (i < 12) ? tests[i] : compiled_tests[i - 12]) : NULL;
+        printf("Test %d: %s\n", i + 1, (batch_results[i] == expected) ? "OK" : "FAIL");
+        cJSONUtils_DeletePointer(compiled_pointers[i]);
+    }
+    printf("\n");
+    cJSON_Delete(root);
+
+    printf("JSONPath-style Query Tests\n");
+    root = cJSON_Parse(query_json);
+    for (i = 0; i < 24; i++)
+    {
+        cJSONUtils_Query *query = NULL;
+        cJSON *matches = NULL;
+
+        if (i == 12)
+        {
+            /* the same queries with lookups through the index */
+            cJSON_BuildIndex(root);
+            cJSON_BuildIndex(cJSON_GetObjectItem(root, "store"));
+            cJSON_BuildIndex(cJSON_GetObjectItem(cJSON_GetObjectItem(root, "store"), "items"));
+        }
+        query = cJSONUtils_CompileQuery(queries_tests[i % 12][0]);
+        matches = cJSONUtils_EvaluateQuery(root, query);
+        temp = cJSON_PrintUnformatted(matches);
+        printf("Test %d: %s = %s (%s)\n", i + 1, queries_tests[i % 12][0], temp, strcmp(temp, queries_tests[i % 12][1]) ? "FAIL" : "OK");
+        free(temp);
+        cJSON_Delete(matches);
+        cJSONUtils_DeleteQuery(query);
+    }
+    printf("\n");
+
+    printf("Batched Query Tests\n");
+    for (i = 0; i < 12; i++)
+    {
+        queries[i] = cJSONUtils_CompileQuery(queries_tests[i][0]);
+        query_counts[i] = 0;
+    }
+    printf("Matches: %lu\n", (unsigned long)cJSONUtils_EvaluateQueries(root, (const cJSONUtils_Query * const *)queries, 12, count_query_match, query_counts));
+    for (i = 0; i < 12; i++)
+    {
+        cJSON *matches = cJSONUtils_EvaluateQuery(root, queries[i]);
+        printf("Test %d: %s\n", i + 1, (query_counts[i] == (size_t)cJSON_GetArraySize(matches)) ? "OK" : "FAIL");
+        cJSON_Delete(matches);
+        cJSONUtils_DeleteQuery(queries[i]);
+    }
+    for (i = 0; i < 8; i++)
+    {
+        queries[0] = cJSONUtils_CompileQuery(invalid_queries[i]);
+        printf("Invalid %d: %s (%s)\n", i + 1, invalid_queries[i], (queries[0] == NULL) ? "OK" : "FAIL");
+        cJSONUtils_DeleteQuery(queries[0]);
+    }
+    printf("\n");
     cJSON_Delete(root);
 
 
@@ -107,6 +297,50 @@ int main(void)
         cJSON_Delete(patch);
     }
 
+    printf("JSON Streaming Apply Patch Tests\n");
+    for (i = 0; i < 15; i++)
+    {
+        cJSON *object_to_be_patched = cJSON_Parse(patches[i][0]);
+        cJSON *patch = cJSON_Parse(patches[i][1]);
+        int err = cJSONUtils_ApplyPatches(object_to_be_patched, patch);
+        char *output = cJSON_PrintUnformatted(object_to_be_patched);
+        cJSON *streamed_object = NULL;
+        char *streamed_output = NULL;
+        streamed_text streamed;
+        int streamed_err = 0;
+
+        memset(&streamed, 0, sizeof(streamed));
+        streamed_err = cJSONUtils_ApplyPatchesToWriter(patches[i][0], strlen(patches[i][0]), patch, collect_text, &streamed);
+        streamed_object = cJSON_Parse(streamed.data);
+        streamed_output = (streamed_object != NULL) ? cJSON_PrintUnformatted(streamed_object) : NULL;
+        printf("Test %d (err %d): [%s] %s\n", i + 1, streamed_err, streamed.data,
+                ((err == streamed_err) && (err ? (streamed.length == 0) : ((streamed_output != NULL) && !strcmp(output, streamed_output)))) ? "OK" : "FAIL");
+
+        free(output);
+        free(streamed_output);
+        cJSON_Delete(streamed_object);
+        cJSON_Delete(object_to_be_patched);
+        cJSON_Delete(patch);
+    }
+    printf("\n");
+
+    printf("JSON Atomic Apply Patch Tests\n");
+    for (i = 0; i < 3; i++)
+    {
+        cJSON *object_to_be_patched = cJSON_Parse("{\"a\":[1,2,3],\"b\":{\"c\":1,\"d\":2}}");
+        cJSON *patch = cJSON_Parse(atomic_patches[i]);
+        char *before_patch = cJSON_PrintUnformatted(object_to_be_patched);
+        int err = cJSONUtils_ApplyPatches(object_to_be_patched, patch);
+        char *output = cJSON_PrintUnformatted(object_to_be_patched);
+        printf("Test %d (err %d): %s\n", i + 1, err, (err != 0) && !strcmp(before_patch, output) ? "OK" : "FAIL");
+
+        free(before_patch);
+        free(output);
+        cJSON_Delete(object_to_be_patched);
+        cJSON_Delete(patch);
+    }
+    printf("\n");
+
     /* JSON Generate Patch tests: */
     printf("JSON Generate Patch Tests\n");
     for (i = 0; i < 15; i++)
@@ -131,6 +365,21 @@ int main(void)
         cJSON_Delete(patch);
     }
 
+    printf("Parallel Generate Patch Tests\n");
+    for (i = 0; i < 15; i++)
+    {
+        if (!strlen(patches[i][2]))
+        {
+            continue;
+        }
+        printf("Test %d: (%s)\n", i + 1, same_parallel_patches(patches[i][0], patches[i][2], 0) ? "OK" : "FAIL");
+    }
+    printf("Nested: (%s)\n\n", same_parallel_patches(
+                "{\"a\":[1,2,3,{\"b\":4}],\"c\":{\"d\":[5,6],\"e\":7},\"f\":8,\"g\":[9],\"h\":{\"i\":10}}",
+                "{\"a\":[1,3,{\"b\":5},6],\"c\":{\"d\":[6],\"x\":7},\"g\":[9],\"h\":[10],\"j\":11}", 0)
+            && same_parallel_patches("[1,[2,3],{\"a\":4},5,6,[7,8],9]", "[1,[2],{\"a\":5},6,[7,8,9],0,9,10]", 0)
+            && same_parallel_patches("[1,2]", "{\"a\":1}", 0) ? "OK" : "FAIL");
+
     /* Misc tests: */
     printf("JSON Pointer construct\n");
     object = cJSON_CreateObject();
@@ -146,6 +395,25 @@ int main(void)
     temp = cJSONUtils_FindPointerFromObjectTo(object, object);
     printf("Pointer: [%s]\n", temp);
     free(temp);
+
+    printf("JSON Pointer batch construct\n");
+    cJSON_AddItemToObject(object, "a/b~c", cJSON_CreateObject());
+    targets[0] = num6;
+    targets[1] = cJSON_CreateNull();
+    cJSON_AddItemToObject(cJSON_GetObjectItem(object, "a/b~c"), "d", targets[1]);
+    targets[2] = object;
+    targets[3] = sortme = cJSON_CreateNull();
+    targets[4] = num6;
+    printf("Found: %lu\n", (unsigned long)cJSONUtils_FindPointersFromObjectTo(object, targets, 5, found_pointers));
+    for (i = 0; i < 5; i++)
+    {
+        temp = cJSONUtils_FindPointerFromObjectTo(object, targets[i]);
+        printf("Pointer: [%s] %s\n", found_pointers[i] ? found_pointers[i] : "(null)",
+                ((temp == found_pointers[i]) || (temp && found_pointers[i] && !strcmp(temp, found_pointers[i]))) ? "OK" : "FAIL");
+        free(temp);
+        free(found_pointers[i]);
+    }
+    cJSON_Delete(sortme);
     cJSON_Delete(object);
 
     /* JSON Sort test: */
@@ -164,6 +432,63 @@ int main(void)
     free(after);
     cJSON_Delete(sortme);
 
+    sortme = cJSON_Parse("{\"b\":1,\"B\":2,\"a\":3,\"c\":4,\"A\":5,\"b\":6}");
+    cJSONUtils_SortObject(sortme);
+    after = cJSON_PrintUnformatted(sortme);
+    printf("Case insensitive: [%s] (%s)\n", after, (strcmp(after, "{\"a\":3,\"A\":5,\"b\":1,\"B\":2,\"b\":6,\"c\":4}")
+                || (sortme->type != cJSON_Object)) ? "FAIL" : "OK");
+    free(after);
+    cJSONUtils_SortObjectCaseSensitive(sortme);
+    after = cJSON_PrintUnformatted(sortme);
+    printf("Case sensitive: [%s] (%s)\n", after, (strcmp(after, "{\"A\":5,\"B\":2,\"a\":3,\"b\":1,\"b\":6,\"c\":4}")
+                || (sortme->type != cJSON_Object)) ? "FAIL" : "OK");
+    free(after);
+    cJSON_Delete(sortme);
+
+    /* a member linked in by hand is sorted in the next time */
+    sortme = cJSON_Parse("{\"b\":1,\"c\":2}");
+    cJSONUtils_SortObject(sortme);
+    added = cJSON_CreateNumber(0);
+    added->string = (char*)malloc(2);
+    strcpy(added->string, "a");
+    added->prev = sortme->child->prev;
+    sortme->child->prev->next = added;
+    sortme->child->prev = added;
+    cJSONUtils_SortObject(sortme);
+    after = cJSON_PrintUnformatted(sortme);
+    printf("Changed by hand: [%s] (%s)\n\n", after, strcmp(after, "{\"a\":0,\"b\":1,\"c\":2}") ? "FAIL" : "OK");
+    free(after);
+    cJSON_Delete(sortme);
+
+    printf("JSON Array Sort Tests\n");
+    sortme = cJSON_Parse("[{\"n\":\"b\",\"p\":2},{\"n\":\"B\",\"p\":1},3,{\"n\":\"a\",\"p\":2},{\"n\":null,\"p\":1.5},{\"n\":\"A\"}]");
+    cJSONUtils_SortArrayByKey(sortme, "p", 0);
+    after = cJSON_PrintUnformatted(sortme);
+    printf("By number: [%s] (%s)\n", after, strcmp(after, "[3,{\"n\":\"A\"},{\"n\":\"B\",\"p\":1},{\"n\":null,\"p\":1.5},{\"n\":\"b\",\"p\":2},{\"n\":\"a\",\"p\":2}]") ? "FAIL" : "OK");
+    free(after);
+    cJSONUtils_SortArrayByKey(sortme, "p", cJSONUtils_SortDescending);
+    after = cJSON_PrintUnformatted(sortme);
+    printf("Descending: [%s] (%s)\n", after, strcmp(after, "[{\"n\":\"b\",\"p\":2},{\"n\":\"a\",\"p\":2},{\"n\":null,\"p\":1.5},{\"n\":\"B\",\"p\":1},3,{\"n\":\"A\"}]") ? "FAIL" : "OK");
+    free(after);
+    cJSONUtils_SortArrayByKey(sortme, "n", 0);
+    after = cJSON_PrintUnformatted(sortme);
+    printf("By string: [%s] (%s)\n", after, strcmp(after, "[3,{\"n\":null,\"p\":1.5},{\"n\":\"A\"},{\"n\":\"B\",\"p\":1},{\"n\":\"a\",\"p\":2},{\"n\":\"b\",\"p\":2}]") ? "FAIL" : "OK");
+    free(after);
+    cJSONUtils_SortArrayByKey(sortme, "n", cJSONUtils_SortCaseInsensitive);
+    after = cJSON_PrintUnformatted(sortme);
+    printf("Case insensitive: [%s] (%s)\n", after, strcmp(after, "[3,{\"n\":null,\"p\":1.5},{\"n\":\"A\"},{\"n\":\"a\",\"p\":2},{\"n\":\"B\",\"p\":1},{\"n\":\"b\",\"p\":2}]") ? "FAIL" : "OK");
+    free(after);
+    printf("Last: (%s)\n", (sortme->child->prev == cJSON_GetArrayItem(sortme, 5)) && (cJSON_GetArrayItem(sortme, 5)->next == NULL) ? "OK" : "FAIL");
+    cJSON_Delete(sortme);
+    sortme = cJSON_Parse("[5,3,9,1,3,7,0,8,2,6,4]");
+    cJSONUtils_SortArray(sortme, compare_numbers, NULL);
+    after = cJSON_PrintUnformatted(sortme);
+    printf("Comparator: [%s] (%s)\n", after, strcmp(after, "[0,1,2,3,3,4,5,6,7,8,9]") ? "FAIL" : "OK");
+    free(after);
+    printf("Invalid: (%s)\n\n", (!cJSONUtils_SortArray(sortme, NULL, NULL) && !cJSONUtils_SortArrayByKey(sortme, NULL, 0)
+                && !cJSONUtils_SortArrayByKey(NULL, "a", 0) && cJSONUtils_SortArrayByKey(sortme, "a", 0)) ? "OK" : "FAIL");
+    cJSON_Delete(sortme);
+
     /* Merge tests: */
     printf("JSON Merge Patch tests\n");
     for (i = 0; i < 15; i++)
@@ -184,12 +509,33 @@ int main(void)
         cJSON_Delete(patch);
     }
 
+    /* members keep their position, also with an index */
+    {
+        cJSON *object_to_be_merged = cJSON_Parse("{\"a\":1,\"b\":{\"c\":2,\"d\":3},\"e\":4,\"f\":5}");
+        cJSON *patch = cJSON_Parse("{\"a\":{\"x\":null,\"y\":1},\"b\":{\"c\":null,\"d\":[5]},\"e\":null,\"g\":6}");
+        cJSON_BuildIndex(object_to_be_merged);
+        object_to_be_merged = cJSONUtils_MergePatch(object_to_be_merged, patch);
+        after = cJSON_PrintUnformatted(object_to_be_merged);
+        printf("In place: [%s] (%s)\n", after, strcmp(after, "{\"a\":{\"y\":1},\"b\":{\"d\":[5]},\"f\":5,\"g\":6}")
+                || (cJSON_GetObjectItem(object_to_be_merged, "g")->valueint != 6) ? "FAIL" : "OK");
+        free(after);
+        cJSON_Delete(object_to_be_merged);
+        cJSON_Delete(patch);
+    }
+
     /* Generate Merge tests: */
     for (i = 0; i < 15; i++)
     {
-        cJSON *from = cJSON_Parse(merges[i][0]);
-        cJSON *to = cJSON_Parse(merges[i][2]);
-        cJSON *patch = cJSONUtils_GenerateMergePatch(from,to);
+        cJSON *from = NULL;
+        cJSON *to = NULL;
+        cJSON *patch = NULL;
+        if (!same_parallel_patches(merges[i][0], merges[i][2], 1))
+        {
+            printf("Parallel merge patch %d (FAIL)\n", i + 1);
+        }
+        from = cJSON_Parse(merges[i][0]);
+        to = cJSON_Parse(merges[i][2]);
+        patch = cJSONUtils_GenerateMergePatch(from,to);
         from = cJSONUtils_MergePatch(from,patch);
         patchtext = cJSON_PrintUnformatted(patch);
         patchedtext = cJSON_PrintUnformatted(from);
@@ -0,0 +1,296 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+/* the node count nodes behind first, in memory that holds consecutive nodes */
+static cJSON *node_after(cJSON *first, size_t count)
+{
+    return &((node_storage*)first)[count].item;
+}
+
+static void arena_should_parse_documents(void)
+{
+    cJSON_Arena *arena = NULL;
+    cJSON *parsed = NULL;
+    char *printed = NULL;
+
+    arena = cJSON_CreateArena(0);
+    TEST_ASSERT_NOT_NULL(arena);
+
+    parsed = cJSON_ParseWithArena(arena, "{\"name\":\"Jack\",\"numbers\":[1,2,3],\"nested\":{\"flag\":true}}");
+    TEST_ASSERT_NOT_NULL(parsed);
+    TEST_ASSERT_EQUAL_STRING("Jack", cJSON_GetObjectItem(parsed, "name")->valuestring);
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetArraySize(cJSON_GetObjectItem(parsed, "numbers")));
+    TEST_ASSERT_TRUE(cJSON_IsTrue(cJSON_GetObjectItem(cJSON_GetObjectItem(parsed, "nested"), "flag")));
+
+    printed = cJSON_PrintUnformatted(parsed);
+    TEST_ASSERT_EQUAL_STRING("{\"name\":\"Jack\",\"numbers\":[1,2,3],\"nested\":{\"flag\":true}}", printed);
+    free(printed);
+
+    cJSON_DeleteArena(arena);
+}
+
+static void arena_should_place_nodes_in_blocks(void)
+{
+    cJSON_Arena *arena = NULL;
+    cJSON *parsed = NULL;
+
+    arena = cJSON_CreateArena(4096);
+    TEST_ASSERT_NOT_NULL(arena);
+
+    parsed = cJSON_ParseWithArena(arena, "[1,2]");
+    TEST_ASSERT_NOT_NULL(parsed);
+    /* the first allocations all come out of the same block */
+    TEST_ASSERT_TRUE(parsed->child == node_after(parsed, 1));
+    TEST_ASSERT_TRUE(parsed->child->next == node_after(parsed, 2));
+
+    cJSON_DeleteArena(arena);
+}
+
+static void arena_should_handle_big_strings(void)
+{
+    cJSON_Arena *arena = NULL;
+    cJSON *parsed = NULL;
+    char json[1024];
+
+    memset(json, 'a', sizeof(json));
+    json[0] = '[';
+    json[1] = '\"';
+    json[sizeof(json) - 3] = '\"';
+    json[sizeof(json) - 2] = ']';
+    json[sizeof(json) - 1] = '\0';
+
+    /* the string is bigger than a block */
+    arena = cJSON_CreateArena(256);
+    TEST_ASSERT_NOT_NULL(arena);
+
+    parsed = cJSON_ParseWithArena(arena, json);
+    TEST_ASSERT_NOT_NULL(parsed);
+    TEST_ASSERT_EQUAL_INT(sizeof(json) - 5, strlen(parsed->child->valuestring));
+
+    cJSON_DeleteArena(arena);
+}
+
+static void arena_should_be_reusable_after_reset(void)
+{
+    cJSON_Arena *arena = NULL;
+    cJSON *first = NULL;
+    cJSON *second = NULL;
+
+    arena = cJSON_CreateArena(0);
+    TEST_ASSERT_NOT_NULL(arena);
+
+    first = cJSON_ParseWithArena(arena, "{\"a\":1}");
+    TEST_ASSERT_NOT_NULL(first);
+
+    cJSON_ResetArena(arena);
+
+    second = cJSON_ParseWithArena(arena, "{\"b\":2}");
+    TEST_ASSERT_NOT_NULL(second);
+    /* the block was reused */
+    TEST_ASSERT_TRUE(first == second);
+    TEST_ASSERT_NOT_NULL(cJSON_GetObjectItem(second, "b"));
+
+    cJSON_DeleteArena(arena);
+}
+
+static void arena_should_fail_on_invalid_input(void)
+{
+    cJSON_Arena *arena = NULL;
+    const char *error = NULL;
+
+    arena = cJSON_CreateArena(0);
+    TEST_ASSERT_NOT_NULL(arena);
+
+    TEST_ASSERT_NULL(cJSON_ParseWithArena(NULL, "[]"));
+    TEST_ASSERT_NULL(cJSON_ParseWithArenaOpts(arena, "[1,2,\"abc", &error, true));
+    TEST_ASSERT_NULL(cJSON_ParseWithArenaOpts(arena, "[1,2] x", &error, true));
+    TEST_ASSERT_EQUAL_STRING("x", error);
+
+    cJSON_DeleteArena(arena);
+}
+
+static void arena_should_duplicate_into_one_block(void)
+{
+    const char json[] = "{\"name\":\"Jack\",\"numbers\":[1,2.5,3],\"nested\":{\"flag\":true,\"empty\":[]}}";
+    cJSON_Arena *arena = NULL;
+    cJSON *item = NULL;
+    cJSON *copy = NULL;
+    cJSON *numbers = NULL;
+    char *printed = NULL;
+
+    item = cJSON_Parse(json);
+    TEST_ASSERT_NOT_NULL(item);
+    cJSON_AddItemToObjectCS(item, "constant", cJSON_CreateNull());
+    arena = cJSON_CreateArena(0);
+    TEST_ASSERT_NOT_NULL(arena);
+
+    copy = cJSON_DuplicateWithArena(arena, item, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    printed = cJSON_PrintUnformatted(copy);
+    TEST_ASSERT_EQUAL_STRING("{\"name\":\"Jack\",\"numbers\":[1,2.5,3],\"nested\":{\"flag\":true,\"empty\":[]},\"constant\":null}", printed);
+    free(printed);
+
+    /* the nodes are stored in pre-order */
+    numbers = cJSON_GetObjectItem(copy, "numbers");
+    TEST_ASSERT_TRUE(numbers == node_after(copy, 2));
+    TEST_ASSERT_TRUE(numbers->child == node_after(copy, 3));
+    TEST_ASSERT_NULL(copy->next);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(copy, "constant")->string == cJSON_GetObjectItem(item, "constant")->string);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(copy, "name")->valuestring != cJSON_GetObjectItem(item, "name")->valuestring);
+
+    /* without recurse only the item itself is copied */
+    copy = cJSON_DuplicateWithArena(arena, numbers, false);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_NULL(copy->child);
+    TEST_ASSERT_TRUE(cJSON_IsArray(copy));
+    TEST_ASSERT_EQUAL_STRING("numbers", copy->string);
+
+    TEST_ASSERT_NULL(cJSON_DuplicateWithArena(NULL, item, true));
+    TEST_ASSERT_NULL(cJSON_DuplicateWithArena(arena, NULL, true));
+
+    cJSON_DeleteArena(arena);
+    cJSON_Delete(item);
+}
+
+static void arena_should_duplicate_lazy_documents(void)
+{
+    const char json[] = "[{\"a\":[1,2]},\"b\",[[]]]";
+    cJSON_Arena *arena = NULL;
+    cJSON *item = NULL;
+    cJSON *copy = NULL;
+    char *printed = NULL;
+
+    item = cJSON_ParseLazy(json, sizeof(json) - 1);
+    TEST_ASSERT_NOT_NULL(item);
+    arena = cJSON_CreateArena(0);
+    TEST_ASSERT_NOT_NULL(arena);
+
+    copy = cJSON_DuplicateWithArena(arena, item, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_BITS_LOW(cJSON_IsLazy, copy->child->type);
+    printed = cJSON_PrintUnformatted(copy);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    free(printed);
+
+    cJSON_DeleteArena(arena);
+    cJSON_Delete(item);
+}
+
+static size_t allocations = 0;
+
+static void *counting_malloc(size_t size)
+{
+    allocations++;
+    return malloc(size);
+}
+
+static void normal_free(void *pointer)
+{
+    free(pointer);
+}
+
+static void document_should_reuse_its_memory(void)
+{
+    cJSON_Hooks hooks;
+    cJSON_Document *document = NULL;
+    cJSON *parsed = NULL;
+    cJSON_ParseError error;
+    char json[8192];
+    size_t length = 0;
+    size_t usage = 0;
+
+    /* many nodes and a string that gets a block of its own */
+    length = (size_t)sprintf(json, "{\"text\":\"");
+    memset(json + length, 'x', 2000);
+    length += 2000;
+    length += (size_t)sprintf(json + length, "\",\"numbers\":[");
+    while (length < (sizeof(json) - 16))
+    {
+        length += (size_t)sprintf(json + length, "1,");
+    }
+    length += (size_t)sprintf(json + length, "2]}");
+
+    hooks.malloc_fn = counting_malloc;
+    hooks.free_fn = normal_free;
+    cJSON_InitHooks(&hooks);
+
+    document = cJSON_CreateDocument(1024, 1024 * 1024);
+    TEST_ASSERT_NOT_NULL(document);
+    parsed = cJSON_ParseInto(document, json, length, &error);
+    TEST_ASSERT_NOT_NULL(parsed);
+    usage = cJSON_GetDocumentMemoryUsage(document);
+
+    /* parsing resets it, the same document fits into the blocks of the last one */
+    allocations = 0;
+    parsed = cJSON_ParseInto(document, json, length, &error);
+    TEST_ASSERT_NOT_NULL(parsed);
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned int)allocations);
+    TEST_ASSERT_EQUAL_UINT(2000, (unsigned int)strlen(cJSON_GetObjectItem(parsed, "text")->valuestring));
+    TEST_ASSERT_EQUAL_INT(2, cJSON_GetArrayItem(cJSON_GetObjectItem(parsed, "numbers"), cJSON_GetArraySize(cJSON_GetObjectItem(parsed, "numbers")) - 1)->valueint);
+    cJSON_ResetDocument(document);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)usage, (unsigned int)cJSON_GetDocumentMemoryUsage(document));
+
+    /* errors are reported */
+    TEST_ASSERT_NULL(cJSON_ParseInto(document, "[1,", 3, &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_UnexpectedEnd, error.code);
+    cJSON_DeleteDocument(document);
+
+    /* nothing is kept beyond the limit */
+    document = cJSON_CreateDocument(1024, 4096);
+    TEST_ASSERT_NOT_NULL(document);
+    TEST_ASSERT_NOT_NULL(cJSON_ParseInto(document, json, length, NULL));
+    TEST_ASSERT_TRUE(cJSON_GetDocumentMemoryUsage(document) > 4096);
+    cJSON_ResetDocument(document);
+    TEST_ASSERT_TRUE(cJSON_GetDocumentMemoryUsage(document) <= (4096 + 256));
+    cJSON_DeleteDocument(document);
+
+    cJSON_InitHooks(NULL);
+
+    TEST_ASSERT_NULL(cJSON_ParseInto(NULL, "1", 1, NULL));
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned int)cJSON_GetDocumentMemoryUsage(NULL));
+    cJSON_ResetDocument(NULL);
+    cJSON_DeleteDocument(NULL);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(arena_should_parse_documents);
+    RUN_TEST(arena_should_place_nodes_in_blocks);
+    RUN_TEST(arena_should_handle_big_strings);
+    RUN_TEST(arena_should_be_reusable_after_reset);
+    RUN_TEST(arena_should_fail_on_invalid_input);
+    RUN_TEST(arena_should_duplicate_into_one_block);
+    RUN_TEST(arena_should_duplicate_lazy_documents);
+    RUN_TEST(document_should_reuse_its_memory);
+
+    return UNITY_END();
+}
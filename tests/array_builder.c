@@ -0,0 +1,150 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+typedef struct
+{
+    cJSON_ArrayBuilder *builder;
+    int per_lane;
+} producer;
+
+/* every task produces the numbers lane * per_lane up to (lane + 1) * per_lane into its own lane */
+static void produce(void *task_data, size_t index)
+{
+    producer *data = (producer*)task_data;
+    int i = 0;
+
+    for (i = 0; i < data->per_lane; i++)
+    {
+        TEST_ASSERT_TRUE(cJSON_ArrayBuilderAdd(data->builder, index, cJSON_CreateNumber((double)(((int)index * data->per_lane) + i))));
+    }
+}
+
+static void array_builder_should_splice_lanes_in_order(void)
+{
+    producer data;
+    cJSON *array = cJSON_Parse("[-1]");
+    cJSON *element = NULL;
+    size_t lane = 0;
+    int expected = -1;
+
+    data.builder = cJSON_CreateArrayBuilder(8);
+    data.per_lane = 100;
+    TEST_ASSERT_NOT_NULL(data.builder);
+
+    /* backwards, the order of the lanes decides and not the order they are filled in */
+    for (lane = 8; lane > 0; lane--)
+    {
+        produce(&data, lane - 1);
+    }
+    TEST_ASSERT_EQUAL_UINT(800, cJSON_ArrayBuilderCount(data.builder));
+    TEST_ASSERT_TRUE(cJSON_ArrayBuilderFinish(data.builder, array));
+    TEST_ASSERT_EQUAL_UINT(0, cJSON_ArrayBuilderCount(data.builder));
+
+    TEST_ASSERT_EQUAL_INT(801, cJSON_GetArraySize(array));
+    cJSON_ArrayForEach(element, array)
+    {
+        TEST_ASSERT_EQUAL_DOUBLE((double)expected, element->valuedouble);
+        expected++;
+    }
+    TEST_ASSERT_TRUE(array->child->prev == cJSON_GetArrayItem(array, 800));
+
+    /* the lanes can be used again, empty ones are skipped */
+    TEST_ASSERT_TRUE(cJSON_ArrayBuilderAdd(data.builder, 5, cJSON_CreateString("last")));
+    TEST_ASSERT_TRUE(cJSON_ArrayBuilderFinish(data.builder, array));
+    TEST_ASSERT_EQUAL_STRING("last", cJSON_GetArrayItem(array, 801)->valuestring);
+    TEST_ASSERT_TRUE(array->child->prev == cJSON_GetArrayItem(array, 801));
+
+    cJSON_DeleteArrayBuilder(data.builder);
+    cJSON_Delete(array);
+}
+
+static void array_builder_should_keep_the_index_up_to_date(void)
+{
+    cJSON_ArrayBuilder *builder = cJSON_CreateArrayBuilder(2);
+    cJSON *array = cJSON_CreateArray();
+    int i = 0;
+
+    for (i = 0; i < 20; i++)
+    {
+        cJSON_AddItemToArray(array, cJSON_CreateNumber(i));
+    }
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(array));
+    TEST_ASSERT_TRUE(cJSON_ArrayBuilderAdd(builder, 1, cJSON_CreateNumber(21)));
+    TEST_ASSERT_TRUE(cJSON_ArrayBuilderAdd(builder, 0, cJSON_CreateNumber(20)));
+    TEST_ASSERT_TRUE(cJSON_ArrayBuilderFinish(builder, array));
+
+    TEST_ASSERT_EQUAL_INT(22, cJSON_GetArraySize(array));
+    TEST_ASSERT_EQUAL_DOUBLE(20, cJSON_GetArrayItem(array, 20)->valuedouble);
+    TEST_ASSERT_EQUAL_DOUBLE(21, cJSON_GetArrayItem(array, 21)->valuedouble);
+
+    cJSON_DeleteArrayBuilder(builder);
+    cJSON_Delete(array);
+}
+
+static void array_builder_should_reject_invalid_arguments(void)
+{
+    cJSON_ArrayBuilder *builder = cJSON_CreateArrayBuilder(1);
+    cJSON *frozen = cJSON_CreateArray();
+    cJSON *object = cJSON_CreateObject();
+    cJSON *item = cJSON_CreateTrue();
+
+    TEST_ASSERT_NULL(cJSON_CreateArrayBuilder(0));
+    TEST_ASSERT_NOT_NULL(builder);
+    TEST_ASSERT_FALSE(cJSON_ArrayBuilderAdd(builder, 1, item));
+    TEST_ASSERT_FALSE(cJSON_ArrayBuilderAdd(builder, 0, NULL));
+    TEST_ASSERT_FALSE(cJSON_ArrayBuilderAdd(NULL, 0, item));
+    TEST_ASSERT_TRUE(cJSON_ArrayBuilderAdd(builder, 0, item));
+
+    TEST_ASSERT_TRUE(cJSON_Freeze(frozen));
+    TEST_ASSERT_FALSE(cJSON_ArrayBuilderFinish(builder, frozen));
+    TEST_ASSERT_FALSE(cJSON_ArrayBuilderFinish(builder, object));
+    TEST_ASSERT_FALSE(cJSON_ArrayBuilderFinish(builder, NULL));
+    TEST_ASSERT_FALSE(cJSON_ArrayBuilderFinish(NULL, frozen));
+    TEST_ASSERT_EQUAL_UINT(1, cJSON_ArrayBuilderCount(builder));
+    TEST_ASSERT_EQUAL_UINT(0, cJSON_ArrayBuilderCount(NULL));
+
+    /* deletes the element that is left */
+    cJSON_DeleteArrayBuilder(builder);
+    cJSON_DeleteArrayBuilder(NULL);
+    cJSON_Delete(frozen);
+    cJSON_Delete(object);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(array_builder_should_splice_lanes_in_order);
+    RUN_TEST(array_builder_should_keep_the_index_up_to_date);
+    RUN_TEST(array_builder_should_reject_invalid_arguments);
+
+    return UNITY_END();
+}
@@ -0,0 +1,327 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+typedef unsigned char *(*print_function)(const cJSON *item, size_t *length);
+typedef cJSON *(*parse_function)(const void *value, size_t length, cJSON_ParseError *error);
+
+/* Convert a string of hex digits to bytes, returns the number of bytes. */
+static size_t from_hex(const char *hex, unsigned char *bytes)
+{
+    size_t length = 0;
+    unsigned int byte = 0;
+
+    for (length = 0; hex[2 * length] != '\0'; length++)
+    {
+        TEST_ASSERT_EQUAL_INT(1, sscanf(hex + 2 * length, "%2x", &byte));
+        bytes[length] = (unsigned char)byte;
+    }
+
+    return length;
+}
+
+/* Check that json is encoded as hex and that it is decoded as json again. */
+static void assert_encoding(print_function encode, parse_function decode, const char *json, const char *hex)
+{
+    cJSON *item = cJSON_Parse(json);
+    unsigned char expected[64];
+    unsigned char *encoded = NULL;
+    size_t expected_length = from_hex(hex, expected);
+    size_t length = 0;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL_MESSAGE(item, json);
+    encoded = encode(item, &length);
+    TEST_ASSERT_NOT_NULL_MESSAGE(encoded, json);
+    TEST_ASSERT_EQUAL_UINT_MESSAGE(expected_length, length, json);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected, encoded, length, json);
+    cJSON_Delete(item);
+
+    item = decode(encoded, length, NULL);
+    TEST_ASSERT_NOT_NULL_MESSAGE(item, json);
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+
+    free(printed);
+    free(encoded);
+    cJSON_Delete(item);
+}
+
+/* Check that hex is decoded to a tree that is printed as json. */
+static void assert_decoding(parse_function decode, const char *hex, const char *json)
+{
+    unsigned char bytes[64];
+    size_t length = from_hex(hex, bytes);
+    cJSON *item = decode(bytes, length, NULL);
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL_MESSAGE(item, hex);
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(json, printed, hex);
+
+    free(printed);
+    cJSON_Delete(item);
+}
+
+static void assert_decoding_error(parse_function decode, const char *hex, int code, size_t position)
+{
+    unsigned char bytes[64];
+    size_t length = from_hex(hex, bytes);
+    cJSON_ParseError error;
+
+    TEST_ASSERT_NULL_MESSAGE(decode(bytes, length, &error), hex);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(code, error.code, hex);
+    TEST_ASSERT_EQUAL_UINT_MESSAGE(position, error.position, hex);
+    TEST_ASSERT_EQUAL_UINT(0, error.line);
+}
+
+static void assert_round_trip(print_function encode, parse_function decode, const cJSON *item)
+{
+    unsigned char *encoded = NULL;
+    size_t length = 0;
+    cJSON *decoded = NULL;
+
+    encoded = encode(item, &length);
+    TEST_ASSERT_NOT_NULL(encoded);
+    decoded = decode(encoded, length, NULL);
+    TEST_ASSERT_NOT_NULL(decoded);
+    TEST_ASSERT_TRUE(cJSON_Compare(item, decoded, true));
+
+    cJSON_Delete(decoded);
+    free(encoded);
+}
+
+static void binary_encodings_should_keep_the_example_files(void)
+{
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5", "inputs/test7", "inputs/test8", "inputs/test9", "inputs/test10", "inputs/test11" };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        char *json = read_file(files[i]);
+        cJSON *item = NULL;
+        TEST_ASSERT_NOT_NULL_MESSAGE(json, files[i]);
+        item = cJSON_Parse(json);
+        TEST_ASSERT_NOT_NULL_MESSAGE(item, files[i]);
+
+        assert_round_trip(cJSON_PrintCBOR, cJSON_ParseCBOR, item);
+        assert_round_trip(cJSON_PrintMessagePack, cJSON_ParseMessagePack, item);
+
+        cJSON_Delete(item);
+        free(json);
+    }
+}
+
+static void cbor_should_encode_like_the_rfc(void)
+{
+    /* the examples of RFC 8949, appendix A */
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "0", "00");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "23", "17");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "24", "1818");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "1000", "1903e8");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "1000000", "1a000f4240");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "1000000000000", "1b000000e8d4a51000");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "-1", "20");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "-1000", "3903e7");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "1.1", "fb3ff199999999999a");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "0.5", "fa3f000000");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "-4.1", "fbc010666666666666");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "false", "f4");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "true", "f5");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "null", "f6");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "\"\"", "60");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "\"\xc3\xbc\"", "62c3bc");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "[]", "80");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "[1,[2,3],[4,5]]", "8301820203820405");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "{\"a\":1,\"b\":[2,3]}", "a26161016162820203");
+    assert_encoding(cJSON_PrintCBOR, cJSON_ParseCBOR, "[\"a\",{\"b\":\"c\"}]", "826161a161626163");
+}
+
+static void cbor_should_decode_floats_and_tags(void)
+{
+    assert_decoding(cJSON_ParseCBOR, "f93e00", "1.5");
+    assert_decoding(cJSON_ParseCBOR, "f93c00", "1");
+    assert_decoding(cJSON_ParseCBOR, "f97bff", "65504");
+    assert_decoding(cJSON_ParseCBOR, "f90001", "5.960464477539063e-08");
+    assert_decoding(cJSON_ParseCBOR, "f9c400", "-4");
+    assert_decoding(cJSON_ParseCBOR, "f97c00", "null");
+    assert_decoding(cJSON_ParseCBOR, "f97e00", "null");
+    assert_decoding(cJSON_ParseCBOR, "fa7f7fffff", "3.4028234663852886e+38");
+    assert_decoding(cJSON_ParseCBOR, "3bffffffffffffffff", "-1.8446744073709552e+19");
+    assert_decoding(cJSON_ParseCBOR, "1bffffffffffffffff", "1.8446744073709552e+19");
+    assert_decoding(cJSON_ParseCBOR, "f7", "null");
+    /* tags are ignored */
+    assert_decoding(cJSON_ParseCBOR, "c11a514b67b0", "1363896240");
+    assert_decoding(cJSON_ParseCBOR, "d818d8186161", "\"a\"");
+}
+
+static void cbor_should_reject_invalid_input(void)
+{
+    assert_decoding_error(cJSON_ParseCBOR, "", cJSON_Error_UnexpectedEnd, 0);
+    assert_decoding_error(cJSON_ParseCBOR, "19", cJSON_Error_UnexpectedEnd, 0);
+    assert_decoding_error(cJSON_ParseCBOR, "8201", cJSON_Error_UnexpectedEnd, 0);
+    assert_decoding_error(cJSON_ParseCBOR, "820163", cJSON_Error_UnexpectedEnd, 2);
+    assert_decoding_error(cJSON_ParseCBOR, "9bffffffffffffffff", cJSON_Error_UnexpectedEnd, 0);
+    assert_decoding_error(cJSON_ParseCBOR, "0101", cJSON_Error_TrailingCharacters, 1);
+    assert_decoding_error(cJSON_ParseCBOR, "a10101", cJSON_Error_ExpectedName, 1);
+    assert_decoding_error(cJSON_ParseCBOR, "a1800101", cJSON_Error_ExpectedName, 1);
+    /* byte strings, indefinite lengths, simple values and '\0' in strings */
+    assert_decoding_error(cJSON_ParseCBOR, "4161", cJSON_Error_InvalidValue, 0);
+    assert_decoding_error(cJSON_ParseCBOR, "9f01ff", cJSON_Error_InvalidValue, 0);
+    assert_decoding_error(cJSON_ParseCBOR, "f0", cJSON_Error_InvalidValue, 0);
+    assert_decoding_error(cJSON_ParseCBOR, "626100", cJSON_Error_InvalidValue, 0);
+    TEST_ASSERT_NULL(cJSON_ParseCBOR(NULL, 0, NULL));
+}
+
+static void message_pack_should_encode_like_the_spec(void)
+{
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "0", "00");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "127", "7f");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "128", "cc80");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "65535", "cdffff");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "65536", "ce00010000");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "9007199254740992", "cf0020000000000000");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "-1", "ff");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "-32", "e0");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "-33", "d0df");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "-32768", "d18000");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "-2147483648", "d280000000");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "-2147483649", "d3ffffffff7fffffff");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "-9007199254740992", "d3ffe0000000000000");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "0.5", "ca3f000000");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "1.1", "cb3ff199999999999a");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "1e+100", "cb54b249ad2594c37d");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "false", "c2");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "true", "c3");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "null", "c0");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "\"abc\"", "a3616263");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "\"0123456789abcdef0123456789abcdef\"", "d920" "30313233343536373839616263646566" "30313233343536373839616263646566");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "[1,[],{}]", "930190" "80");
+    assert_encoding(cJSON_PrintMessagePack, cJSON_ParseMessagePack, "{\"a\":[true]}", "81a16191c3");
+}
+
+static void message_pack_should_decode_all_sizes(void)
+{
+    assert_decoding(cJSON_ParseMessagePack, "d9036162" "63", "\"abc\"");
+    assert_decoding(cJSON_ParseMessagePack, "da0001" "61", "\"a\"");
+    assert_decoding(cJSON_ParseMessagePack, "db00000001" "61", "\"a\"");
+    assert_decoding(cJSON_ParseMessagePack, "dc000101", "[1]");
+    assert_decoding(cJSON_ParseMessagePack, "dd0000000101", "[1]");
+    assert_decoding(cJSON_ParseMessagePack, "de0001a16101", "{\"a\":1}");
+    assert_decoding(cJSON_ParseMessagePack, "df00000001a16101", "{\"a\":1}");
+    assert_decoding(cJSON_ParseMessagePack, "d0ff", "-1");
+    assert_decoding(cJSON_ParseMessagePack, "d1ffff", "-1");
+    assert_decoding(cJSON_ParseMessagePack, "d2ffffffff", "-1");
+    assert_decoding(cJSON_ParseMessagePack, "d3ffffffffffffffff", "-1");
+    assert_decoding(cJSON_ParseMessagePack, "d38000000000000000", "-9.223372036854776e+18");
+    assert_decoding(cJSON_ParseMessagePack, "cc01", "1");
+    assert_decoding(cJSON_ParseMessagePack, "cd0001", "1");
+    assert_decoding(cJSON_ParseMessagePack, "ce00000001", "1");
+    assert_decoding(cJSON_ParseMessagePack, "cf0000000000000001", "1");
+}
+
+static void message_pack_should_reject_invalid_input(void)
+{
+    assert_decoding_error(cJSON_ParseMessagePack, "", cJSON_Error_UnexpectedEnd, 0);
+    assert_decoding_error(cJSON_ParseMessagePack, "cd00", cJSON_Error_UnexpectedEnd, 0);
+    assert_decoding_error(cJSON_ParseMessagePack, "9201", cJSON_Error_UnexpectedEnd, 0);
+    assert_decoding_error(cJSON_ParseMessagePack, "91a2", cJSON_Error_UnexpectedEnd, 1);
+    assert_decoding_error(cJSON_ParseMessagePack, "ddffffffff", cJSON_Error_UnexpectedEnd, 0);
+    assert_decoding_error(cJSON_ParseMessagePack, "c0c0", cJSON_Error_TrailingCharacters, 1);
+    assert_decoding_error(cJSON_ParseMessagePack, "810101", cJSON_Error_ExpectedName, 1);
+    /* binary data, extensions, unused markers and '\0' in strings */
+    assert_decoding_error(cJSON_ParseMessagePack, "c40100", cJSON_Error_InvalidValue, 0);
+    assert_decoding_error(cJSON_ParseMessagePack, "d40100", cJSON_Error_InvalidValue, 0);
+    assert_decoding_error(cJSON_ParseMessagePack, "c1", cJSON_Error_InvalidValue, 0);
+    assert_decoding_error(cJSON_ParseMessagePack, "a100", cJSON_Error_InvalidValue, 0);
+}
+
+static void binary_encodings_should_print_all_kinds_of_trees(void)
+{
+    const char lazy[] = "{\"lazy\":[1,{\"a\":\"\\n\"}],\"text\":1.25}";
+    const char text[] = "[1.5,{\"s\":\"\\u00fc\"},\"\\t\"]";
+    const double numbers[] = { 1, -2.5, 1e300 };
+    cJSON *item = cJSON_ParseLazy(lazy, sizeof(lazy) - 1);
+    cJSON *packed = cJSON_CreatePackedArray(numbers, 3);
+    cJSON *expected = cJSON_Parse("[1,-2.5,1e300]");
+    cJSON *raw = cJSON_CreateRaw("[1]");
+    unsigned char *printed_packed = NULL;
+    unsigned char *printed_expected = NULL;
+    size_t packed_length = 0;
+    size_t expected_length = 0;
+
+    TEST_ASSERT_NOT_NULL(item);
+    assert_round_trip(cJSON_PrintCBOR, cJSON_ParseCBOR, item);
+    assert_round_trip(cJSON_PrintMessagePack, cJSON_ParseMessagePack, item);
+    cJSON_Delete(item);
+
+    item = cJSON_ParseWithNumberText(text, sizeof(text) - 1);
+    TEST_ASSERT_NOT_NULL(item);
+    assert_round_trip(cJSON_PrintCBOR, cJSON_ParseCBOR, item);
+    cJSON_Delete(item);
+    item = cJSON_ParseWithStringText(text, sizeof(text) - 1);
+    TEST_ASSERT_NOT_NULL(item);
+    assert_round_trip(cJSON_PrintMessagePack, cJSON_ParseMessagePack, item);
+    cJSON_Delete(item);
+
+    /* packed arrays are encoded like regular ones, without unpacking them */
+    TEST_ASSERT_NOT_NULL(packed);
+    printed_packed = cJSON_PrintCBOR(packed, &packed_length);
+    printed_expected = cJSON_PrintCBOR(expected, &expected_length);
+    TEST_ASSERT_NOT_NULL(cJSON_GetPackedNumbers(packed));
+    TEST_ASSERT_EQUAL_UINT(expected_length, packed_length);
+    TEST_ASSERT_EQUAL_MEMORY(printed_expected, printed_packed, packed_length);
+
+    /* raw json has no binary form */
+    TEST_ASSERT_NULL(cJSON_PrintCBOR(raw, &packed_length));
+    TEST_ASSERT_NULL(cJSON_PrintMessagePack(NULL, &packed_length));
+
+    free(printed_expected);
+    free(printed_packed);
+    cJSON_Delete(raw);
+    cJSON_Delete(expected);
+    cJSON_Delete(packed);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(binary_encodings_should_keep_the_example_files);
+    RUN_TEST(cbor_should_encode_like_the_rfc);
+    RUN_TEST(cbor_should_decode_floats_and_tags);
+    RUN_TEST(cbor_should_reject_invalid_input);
+    RUN_TEST(message_pack_should_encode_like_the_spec);
+    RUN_TEST(message_pack_should_decode_all_sizes);
+    RUN_TEST(message_pack_should_reject_invalid_input);
+    RUN_TEST(binary_encodings_should_print_all_kinds_of_trees);
+
+    return UNITY_END();
+}
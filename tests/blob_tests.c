@@ -0,0 +1,210 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+/* the bytes 0, 1, 2, ... up to length, which hit all the digits */
+static void fill_bytes(unsigned char *bytes, size_t length)
+{
+    size_t i = 0;
+    for (i = 0; i < length; i++)
+    {
+        bytes[i] = (unsigned char)((i * 37) + 11);
+    }
+}
+
+/* base64 one digit at a time, to check the kernels against */
+static void reference_base64(char *text, const unsigned char *bytes, size_t length)
+{
+    static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t i = 0;
+    for (i = 0; i < length; i += 3)
+    {
+        unsigned long bits = (unsigned long)bytes[i] << 16;
+        bits |= (i + 1 < length) ? ((unsigned long)bytes[i + 1] << 8) : 0;
+        bits |= (i + 2 < length) ? bytes[i + 2] : 0;
+        *text++ = digits[(bits >> 18) & 0x3F];
+        *text++ = digits[(bits >> 12) & 0x3F];
+        *text++ = (i + 1 < length) ? digits[(bits >> 6) & 0x3F] : '=';
+        *text++ = (i + 2 < length) ? digits[bits & 0x3F] : '=';
+    }
+    *text = '\0';
+}
+
+static void binary_should_print_as_base64(void)
+{
+    unsigned char bytes[100];
+    char expected[200];
+    char printed[210];
+    size_t length = 0;
+
+    fill_bytes(bytes, sizeof(bytes));
+    for (length = 0; length <= sizeof(bytes); length++)
+    {
+        cJSON *item = cJSON_CreateBinary(bytes, length);
+        char *text = NULL;
+        TEST_ASSERT_NOT_NULL(item);
+        TEST_ASSERT_TRUE(cJSON_IsString(item));
+
+        printed[0] = '\"';
+        reference_base64(printed + 1, bytes, length);
+        strcat(printed, "\"");
+        text = cJSON_PrintUnformatted(item);
+        TEST_ASSERT_EQUAL_STRING(printed, text);
+        free(text);
+        TEST_ASSERT_TRUE(item->type & cJSON_IsBinary);
+
+        /* the text is made in place when it is needed */
+        reference_base64(expected, bytes, length);
+        TEST_ASSERT_EQUAL_STRING(expected, cJSON_GetStringValue(item));
+        TEST_ASSERT_FALSE(item->type & cJSON_IsBinary);
+        cJSON_Delete(item);
+    }
+}
+
+static void binary_should_be_decoded_on_demand(void)
+{
+    unsigned char bytes[100];
+    char json[210];
+    size_t length = 0;
+    size_t decoded = 0;
+    int lazy = 0;
+
+    fill_bytes(bytes, sizeof(bytes));
+    for (lazy = 0; lazy < 2; lazy++)
+    {
+        for (length = 0; length <= sizeof(bytes); length++)
+        {
+            cJSON *item = NULL;
+            char *printed = NULL;
+            unsigned char *value = NULL;
+
+            json[0] = '\"';
+            reference_base64(json + 1, bytes, length);
+            strcat(json, "\"");
+            item = lazy ? cJSON_ParseWithStringText(json, strlen(json)) : cJSON_Parse(json);
+            TEST_ASSERT_NOT_NULL(item);
+
+            value = cJSON_GetBinaryValue(item, &decoded);
+            TEST_ASSERT_NOT_NULL(value);
+            TEST_ASSERT_EQUAL_UINT((unsigned int)length, (unsigned int)decoded);
+            TEST_ASSERT_TRUE((length == 0) || (memcmp(bytes, value, length) == 0));
+            TEST_ASSERT_EQUAL_PTR(value, cJSON_GetBinaryValue(item, NULL));
+
+            printed = cJSON_PrintUnformatted(item);
+            TEST_ASSERT_EQUAL_STRING(json, printed);
+            free(printed);
+            cJSON_Delete(item);
+        }
+    }
+
+    /* escaped text is unescaped first */
+    {
+        cJSON *item = cJSON_ParseWithStringText("\"QU\\/D\"", 8);
+        TEST_ASSERT_NOT_NULL(item);
+        TEST_ASSERT_NOT_NULL(cJSON_GetBinaryValue(item, &decoded));
+        TEST_ASSERT_EQUAL_UINT(3, (unsigned int)decoded);
+        TEST_ASSERT_EQUAL_HEX8(0x41, cJSON_GetBinaryValue(item, NULL)[0]);
+        TEST_ASSERT_EQUAL_HEX8(0x4F, cJSON_GetBinaryValue(item, NULL)[1]);
+        TEST_ASSERT_EQUAL_HEX8(0xC3, cJSON_GetBinaryValue(item, NULL)[2]);
+        cJSON_Delete(item);
+    }
+}
+
+static void binary_should_reject_invalid_base64(void)
+{
+    const char * const invalid[] = {"\"QUJD=\"", "\"QU=D\"", "\"Q===\"", "\"QUJDRA\"", "\"QUJD RA==\"", "\"QUJDREVGR0hJSktMTU5PUFFS*1Q=\"", "\"QUJD\\nRA==\""};
+    size_t i = 0;
+    cJSON *item = NULL;
+
+    for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+    {
+        char *before = NULL;
+        item = cJSON_Parse(invalid[i]);
+        TEST_ASSERT_NOT_NULL(item);
+        before = cJSON_PrintUnformatted(item);
+        TEST_ASSERT_NULL(cJSON_GetBinaryValue(item, NULL));
+        /* the text is left as it was */
+        TEST_ASSERT_EQUAL_STRING(invalid[i], before);
+        free(before);
+        before = cJSON_PrintUnformatted(item);
+        TEST_ASSERT_EQUAL_STRING(invalid[i], before);
+        free(before);
+        cJSON_Delete(item);
+    }
+
+    item = cJSON_CreateNumber(1);
+    TEST_ASSERT_NULL(cJSON_GetBinaryValue(item, NULL));
+    cJSON_Delete(item);
+    /* frozen strings aren't changed */
+    item = cJSON_CreateString("QUJD");
+    TEST_ASSERT_TRUE(cJSON_Freeze(item));
+    TEST_ASSERT_NULL(cJSON_GetBinaryValue(item, NULL));
+    TEST_ASSERT_EQUAL_STRING("QUJD", cJSON_GetStringValue(item));
+    cJSON_Delete(item);
+    TEST_ASSERT_NULL(cJSON_CreateBinary(NULL, 1));
+}
+
+static void binary_should_be_copied_and_compared(void)
+{
+    unsigned char bytes[40];
+    cJSON *object = cJSON_CreateObject();
+    cJSON *copy = NULL;
+    cJSON *text = NULL;
+    size_t length = 0;
+
+    fill_bytes(bytes, sizeof(bytes));
+    cJSON_AddItemToObject(object, "blob", cJSON_CreateBinary(bytes, sizeof(bytes)));
+    copy = cJSON_Duplicate(object, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(copy, "blob")->type & cJSON_IsBinary);
+    TEST_ASSERT_TRUE(memcmp(bytes, cJSON_GetBinaryValue(cJSON_GetObjectItem(copy, "blob"), &length), sizeof(bytes)) == 0);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)sizeof(bytes), (unsigned int)length);
+
+    text = cJSON_Parse("{\"blob\": \"CzBVep/E6Q4zWH2ix+wRNluApcrvFDleg6jN8hc8YYar0PUaP2SJrg==\"}");
+    TEST_ASSERT_NOT_NULL(text);
+    TEST_ASSERT_TRUE(cJSON_Compare(object, text, true));
+    TEST_ASSERT_TRUE(cJSON_Compare(copy, text, true));
+
+    cJSON_Delete(object);
+    cJSON_Delete(copy);
+    cJSON_Delete(text);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(binary_should_print_as_base64);
+    RUN_TEST(binary_should_be_decoded_on_demand);
+    RUN_TEST(binary_should_reject_invalid_base64);
+    RUN_TEST(binary_should_be_copied_and_compared);
+
+    return UNITY_END();
+}
@@ -0,0 +1,194 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static void assert_canonical(const char *input, const char *expected)
+{
+    cJSON *item = cJSON_Parse(input);
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL_MESSAGE(item, "Failed to parse input.");
+    printed = cJSON_PrintCanonical(item);
+    TEST_ASSERT_NOT_NULL_MESSAGE(printed, "Failed to print canonical JSON.");
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+
+    global_hooks.deallocate(printed);
+    cJSON_Delete(item);
+}
+
+static void assert_canonical_number(double number, const char *expected)
+{
+    unsigned char printed[NUMBER_BUFFER_SIZE];
+    size_t length = render_canonical_number(number, printed);
+
+    TEST_ASSERT_EQUAL_STRING(expected, (char*)printed);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)strlen(expected), (unsigned int)length);
+}
+
+static void canonical_should_sort_members_without_modifying_the_object(void)
+{
+    const char input[] = "{\"b\":[{\"z\":1,\"y\":2}],\"a\":true,\"\":null}";
+    cJSON *item = cJSON_Parse(input);
+    char *printed = NULL;
+    char *unformatted = NULL;
+
+    TEST_ASSERT_NOT_NULL(item);
+    printed = cJSON_PrintCanonical(item);
+    TEST_ASSERT_EQUAL_STRING("{\"\":null,\"a\":true,\"b\":[{\"y\":2,\"z\":1}]}", printed);
+
+    unformatted = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING(input, unformatted);
+
+    global_hooks.deallocate(printed);
+    global_hooks.deallocate(unformatted);
+    cJSON_Delete(item);
+}
+
+static void canonical_should_sort_keys_by_utf16_code_units(void)
+{
+    /* U+1F600 is a surrogate pair in UTF-16 and comes before U+FB01, even though its UTF-8 bytes are bigger */
+    assert_canonical("{\"\\ufb01\":1,\"\\ud83d\\ude00\":2,\"\\u00e9\":3,\"e\":4}",
+            "{\"e\":4,\"\xC3\xA9\":3,\"\xF0\x9F\x98\x80\":2,\"\xEF\xAC\x81\":1}");
+}
+
+static void canonical_should_keep_duplicate_keys_in_order(void)
+{
+    assert_canonical("{\"b\":1,\"a\":2,\"b\":3,\"a\":4}", "{\"a\":2,\"a\":4,\"b\":1,\"b\":3}");
+}
+
+static void canonical_should_print_numbers_like_ecmascript(void)
+{
+    assert_canonical_number(0, "0");
+    assert_canonical_number(-0.0, "0");
+    assert_canonical_number(1, "1");
+    assert_canonical_number(-1, "-1");
+    assert_canonical_number(1.5, "1.5");
+    assert_canonical_number(0.1, "0.1");
+    assert_canonical_number(-0.000001, "-0.000001");
+    assert_canonical_number(1e-7, "1e-7");
+    assert_canonical_number(123e-20, "1.23e-18");
+    assert_canonical_number(4294967296.0, "4294967296");
+    assert_canonical_number(1e20, "100000000000000000000");
+    assert_canonical_number(1e21, "1e+21");
+    assert_canonical_number(333333333.3333333, "333333333.3333333");
+    assert_canonical_number(9007199254740993.0, "9007199254740992");
+    assert_canonical_number(1.7976931348623157e308, "1.7976931348623157e+308");
+    assert_canonical_number(5e-324, "5e-324");
+    assert_canonical_number(-1.2345678901234568e-300, "-1.2345678901234568e-300");
+}
+
+static void canonical_should_fail_for_nan_and_infinity(void)
+{
+    cJSON *array = cJSON_CreateArray();
+
+    /* not by dividing by zero, which traps with the float-divide-by-zero sanitizer */
+    cJSON_AddItemToArray(array, cJSON_CreateNumber(0));
+    array->child->valuedouble = strtod("nan", NULL);
+    TEST_ASSERT_NULL(cJSON_PrintCanonical(array));
+    cJSON_SetNumberValue(array->child, HUGE_VAL);
+    TEST_ASSERT_NULL(cJSON_PrintCanonical(array));
+
+    cJSON_Delete(array);
+}
+
+static void canonical_should_escape_minimally(void)
+{
+    assert_canonical("\"\\u0041\\/\\\"\\\\\\b\\f\\n\\r\\t\\u001f\\u007f\\u20ac\"",
+            "\"A/\\\"\\\\\\b\\f\\n\\r\\t\\u001f\x7f\xE2\x82\xAC\"");
+}
+
+typedef struct
+{
+    unsigned long hash;
+    size_t length;
+    size_t writes;
+} hash_state;
+
+static cJSON_bool hash_output(const char *data, size_t length, void *context)
+{
+    hash_state *state = (hash_state*)context;
+    size_t i = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        state->hash = (state->hash * 31) + (unsigned char)data[i];
+    }
+    state->length += length;
+    state->writes++;
+
+    return true;
+}
+
+static void canonical_should_stream_into_a_writer(void)
+{
+    const char expected_start[] = "{\"member 1\":0.125,\"member 10\":1.25,\"member 100\":12.5,\"member 1000\":125,";
+    cJSON *root = cJSON_CreateObject();
+    hash_state streamed;
+    hash_state whole;
+    char *printed = NULL;
+    char name[32];
+    int i = 0;
+
+    for (i = 2000; i > 0; i--)
+    {
+        sprintf(name, "member %d", i);
+        cJSON_AddItemToObject(root, name, cJSON_CreateNumber(i / 8.0));
+    }
+
+    memset(&streamed, 0, sizeof(streamed));
+    memset(&whole, 0, sizeof(whole));
+    TEST_ASSERT_TRUE(cJSON_PrintCanonicalToWriter(root, hash_output, &streamed));
+    printed = cJSON_PrintCanonical(root);
+    TEST_ASSERT_NOT_NULL(printed);
+    hash_output(printed, strlen(printed), &whole);
+
+    TEST_ASSERT_TRUE(streamed.writes > 1);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)whole.length, (unsigned int)streamed.length);
+    TEST_ASSERT_TRUE(whole.hash == streamed.hash);
+    TEST_ASSERT_EQUAL_INT(0, strncmp(printed, expected_start, sizeof(expected_start) - 1));
+
+    global_hooks.deallocate(printed);
+    cJSON_Delete(root);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(canonical_should_sort_members_without_modifying_the_object);
+    RUN_TEST(canonical_should_sort_keys_by_utf16_code_units);
+    RUN_TEST(canonical_should_keep_duplicate_keys_in_order);
+    RUN_TEST(canonical_should_print_numbers_like_ecmascript);
+    RUN_TEST(canonical_should_fail_for_nan_and_infinity);
+    RUN_TEST(canonical_should_escape_minimally);
+    RUN_TEST(canonical_should_stream_into_a_writer);
+
+    return UNITY_END();
+}
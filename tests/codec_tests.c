@@ -0,0 +1,262 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+/* a toy codec: xors every byte, writes in pieces of at most 3 bytes and holds back the last byte until finish */
+typedef struct
+{
+    char held;
+    cJSON_bool holding;
+    int finishes;
+    size_t fail_after;
+    size_t consumed;
+} xor_codec;
+
+static cJSON_bool xor_transform(void *codec_data, const char *data, size_t length, cJSON_bool finish, cJSON_WriteFunction writer, void *writer_context)
+{
+    xor_codec *codec = (xor_codec*)codec_data;
+    char piece[3];
+    size_t filled = 0;
+    size_t i = 0;
+
+    if (finish)
+    {
+        codec->finishes++;
+    }
+    for (i = 0; i < length; i++)
+    {
+        if (codec->holding)
+        {
+            piece[filled++] = codec->held;
+        }
+        codec->held = (char)(data[i] ^ 0x5a);
+        codec->holding = true;
+        codec->consumed++;
+        if ((codec->fail_after != 0) && (codec->consumed > codec->fail_after))
+        {
+            return false;
+        }
+        if ((filled == sizeof(piece)) || ((i + 1 == length) && (filled > 0)))
+        {
+            if (!writer(piece, filled, writer_context))
+            {
+                return false;
+            }
+            filled = 0;
+        }
+    }
+    if (finish && codec->holding)
+    {
+        codec->holding = false;
+        return writer(&codec->held, 1, writer_context);
+    }
+
+    return true;
+}
+
+static void init_codec(cJSON_Codec *codec, xor_codec *data)
+{
+    memset(data, '\0', sizeof(xor_codec));
+    codec->transform = xor_transform;
+    codec->codec_data = data;
+}
+
+typedef struct
+{
+    char text[8192];
+    size_t length;
+} sink;
+
+static cJSON_bool write_to_sink(const char *data, size_t length, void *context)
+{
+    sink *output = (sink*)context;
+
+    if ((output->length + length) > sizeof(output->text))
+    {
+        return false;
+    }
+    memcpy(output->text + output->length, data, length);
+    output->length += length;
+
+    return true;
+}
+
+static void codec_should_roundtrip_print_and_parse(void)
+{
+    cJSON_Codec codec;
+    xor_codec data;
+    sink encoded;
+    cJSON_ParseError error;
+    cJSON *item = cJSON_Parse("{\"name\":\"codec\",\"values\":[1,2.5,true,null,\"x\"],\"nested\":{\"a\":[]}}");
+    cJSON *parsed = NULL;
+    char *printed = cJSON_PrintUnformatted(item);
+    size_t i = 0;
+
+    TEST_ASSERT_NOT_NULL(printed);
+    memset(&encoded, '\0', sizeof(encoded));
+    init_codec(&codec, &data);
+    TEST_ASSERT_TRUE(cJSON_PrintToCodec(item, false, &codec, write_to_sink, &encoded));
+    TEST_ASSERT_EQUAL_INT(1, data.finishes);
+    TEST_ASSERT_TRUE(strlen(printed) == encoded.length);
+    for (i = 0; i < encoded.length; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(printed[i], encoded.text[i] ^ 0x5a);
+    }
+
+    init_codec(&codec, &data);
+    parsed = cJSON_ParseWithCodec(&codec, encoded.text, encoded.length, &error);
+    TEST_ASSERT_NOT_NULL(parsed);
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_None, error.code);
+    TEST_ASSERT_EQUAL_INT(1, data.finishes);
+    TEST_ASSERT_TRUE(cJSON_Compare(item, parsed, true));
+
+    cJSON_Delete(parsed);
+    free(printed);
+    cJSON_Delete(item);
+}
+
+static void codec_should_parse_input_longer_than_a_chunk(void)
+{
+    cJSON_Codec codec;
+    xor_codec data;
+    cJSON_ParseError error;
+    char encoded[3 * CJSON_WRITER_BUFFER_SIZE];
+    cJSON *parsed = NULL;
+    size_t i = 0;
+
+    encoded[0] = (char)('[' ^ 0x5a);
+    for (i = 1; (i + 1) < sizeof(encoded); i += 2)
+    {
+        encoded[i] = (char)('7' ^ 0x5a);
+        encoded[i + 1] = (char)(',' ^ 0x5a);
+    }
+    /* the last number is 77 */
+    encoded[sizeof(encoded) - 2] = (char)('7' ^ 0x5a);
+    encoded[sizeof(encoded) - 1] = (char)(']' ^ 0x5a);
+
+    init_codec(&codec, &data);
+    parsed = cJSON_ParseWithCodec(&codec, encoded, sizeof(encoded), &error);
+    TEST_ASSERT_NOT_NULL(parsed);
+    TEST_ASSERT_EQUAL_INT(1, data.finishes);
+    TEST_ASSERT_EQUAL_INT((int)(sizeof(encoded) / 2) - 1, cJSON_GetArraySize(parsed));
+    TEST_ASSERT_EQUAL_DOUBLE(77, cJSON_GetArrayItem(parsed, cJSON_GetArraySize(parsed) - 1)->valuedouble);
+    TEST_ASSERT_EQUAL_DOUBLE(7, cJSON_GetArrayItem(parsed, 100)->valuedouble);
+
+    cJSON_Delete(parsed);
+}
+
+static char *encode(const char *text)
+{
+    size_t length = strlen(text);
+    char *encoded = (char*)malloc(length + 1);
+    size_t i = 0;
+
+    TEST_ASSERT_NOT_NULL(encoded);
+    for (i = 0; i < length; i++)
+    {
+        encoded[i] = (char)(text[i] ^ 0x5a);
+    }
+    encoded[length] = '\0';
+
+    return encoded;
+}
+
+static void codec_should_report_errors(void)
+{
+    cJSON_Codec codec;
+    xor_codec data;
+    cJSON_ParseError error;
+    char *encoded = NULL;
+
+    /* invalid JSON after decoding */
+    encoded = encode("{\"a\":tru}");
+    init_codec(&codec, &data);
+    TEST_ASSERT_NULL(cJSON_ParseWithCodec(&codec, encoded, strlen(encoded), &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_InvalidValue, error.code);
+    free(encoded);
+
+    /* a second document */
+    encoded = encode("[1] [2]");
+    init_codec(&codec, &data);
+    TEST_ASSERT_NULL(cJSON_ParseWithCodec(&codec, encoded, strlen(encoded), &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_TrailingCharacters, error.code);
+    free(encoded);
+
+    /* the codec fails while the text is still fine */
+    encoded = encode("[1, 2, 3, 4]");
+    init_codec(&codec, &data);
+    data.fail_after = 4;
+    TEST_ASSERT_NULL(cJSON_ParseWithCodec(&codec, encoded, strlen(encoded), &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_Codec, error.code);
+    TEST_ASSERT_EQUAL_STRING("failed to decode the input", cJSON_GetErrorMessage(error.code));
+    free(encoded);
+
+    /* incomplete after decoding */
+    encoded = encode("[1, 2");
+    init_codec(&codec, &data);
+    TEST_ASSERT_NULL(cJSON_ParseWithCodec(&codec, encoded, strlen(encoded), NULL));
+    free(encoded);
+
+    init_codec(&codec, &data);
+    TEST_ASSERT_NULL(cJSON_ParseWithCodec(NULL, "", 0, NULL));
+    TEST_ASSERT_NULL(cJSON_ParseWithCodec(&codec, NULL, 1, NULL));
+    TEST_ASSERT_FALSE(cJSON_PrintToCodec(NULL, false, &codec, write_to_sink, NULL));
+}
+
+static void codec_should_fail_printing_when_the_writer_fails(void)
+{
+    cJSON_Codec codec;
+    xor_codec data;
+    sink encoded;
+    cJSON *item = cJSON_CreateArray();
+    int i = 0;
+
+    for (i = 0; i < 3000; i++)
+    {
+        cJSON_AddItemToArray(item, cJSON_CreateNumber(12345));
+    }
+    memset(&encoded, '\0', sizeof(encoded));
+    init_codec(&codec, &data);
+    TEST_ASSERT_FALSE(cJSON_PrintToCodec(item, false, &codec, write_to_sink, &encoded));
+
+    cJSON_Delete(item);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(codec_should_roundtrip_print_and_parse);
+    RUN_TEST(codec_should_parse_input_longer_than_a_chunk);
+    RUN_TEST(codec_should_report_errors);
+    RUN_TEST(codec_should_fail_printing_when_the_writer_fails);
+
+    return UNITY_END();
+}
@@ -0,0 +1,288 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static void assert_compact_round_trip(const char *json)
+{
+    cJSON *tree = cJSON_Parse(json);
+    cJSON_Compact *document = NULL;
+    cJSON *expanded = NULL;
+    char *expected = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    document = cJSON_CreateCompact(tree);
+    TEST_ASSERT_NOT_NULL(document);
+    expanded = cJSON_ExpandCompact(document);
+    TEST_ASSERT_NOT_NULL(expanded);
+
+    expected = cJSON_Print(tree);
+    printed = cJSON_Print(expanded);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+
+    free(printed);
+    free(expected);
+    cJSON_Delete(expanded);
+    cJSON_DeleteCompact(document);
+    cJSON_Delete(tree);
+}
+
+static void compact_documents_should_keep_the_example_files(void)
+{
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5", "inputs/test7", "inputs/test8", "inputs/test9", "inputs/test10", "inputs/test11" };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        char *json = read_file(files[i]);
+        TEST_ASSERT_NOT_NULL_MESSAGE(json, files[i]);
+        assert_compact_round_trip(json);
+        free(json);
+    }
+
+    assert_compact_round_trip("1.5");
+    assert_compact_round_trip("\"\"");
+    assert_compact_round_trip("[]");
+    assert_compact_round_trip("{\"\":{},\"a\":[[],[{}]],\"b\":[true,false,null]}");
+}
+
+static void compact_documents_should_be_readable(void)
+{
+    cJSON *tree = cJSON_Parse("{\"name\":\"value\",\"Number\":-2.5,\"list\":[1,\"two\",{\"three\":3}],\"empty\":{},\"yes\":true}");
+    cJSON_Compact *document = NULL;
+    const cJSON_Compact *list = NULL;
+    const cJSON_Compact *child = NULL;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    cJSON_AddItemToObject(tree, "raw", cJSON_CreateRaw("[1]"));
+    document = cJSON_CreateCompact(tree);
+    TEST_ASSERT_NOT_NULL(document);
+
+    TEST_ASSERT_EQUAL_INT(cJSON_Object, cJSON_CompactGetType(document));
+    TEST_ASSERT_NULL(cJSON_CompactGetName(document));
+    TEST_ASSERT_EQUAL_INT(6, cJSON_CompactGetArraySize(document));
+
+    TEST_ASSERT_EQUAL_STRING("value", cJSON_CompactGetString(cJSON_CompactGetObjectItem(document, "name")));
+    TEST_ASSERT_EQUAL_DOUBLE(-2.5, cJSON_CompactGetNumber(cJSON_CompactGetObjectItem(document, "number")));
+    TEST_ASSERT_NULL(cJSON_CompactGetObjectItemCaseSensitive(document, "number"));
+    TEST_ASSERT_NOT_NULL(cJSON_CompactGetObjectItemCaseSensitive(document, "Number"));
+    TEST_ASSERT_EQUAL_INT(cJSON_True, cJSON_CompactGetType(cJSON_CompactGetObjectItem(document, "yes")));
+    TEST_ASSERT_EQUAL_INT(cJSON_Raw, cJSON_CompactGetType(cJSON_CompactGetObjectItem(document, "raw")));
+    TEST_ASSERT_EQUAL_STRING("[1]", cJSON_CompactGetString(cJSON_CompactGetObjectItem(document, "raw")));
+    TEST_ASSERT_NULL(cJSON_CompactGetObjectItem(document, "missing"));
+    TEST_ASSERT_NULL(cJSON_CompactGetChild(cJSON_CompactGetObjectItem(document, "empty")));
+
+    list = cJSON_CompactGetObjectItem(document, "list");
+    TEST_ASSERT_EQUAL_STRING("list", cJSON_CompactGetName(list));
+    TEST_ASSERT_EQUAL_INT(3, cJSON_CompactGetArraySize(list));
+    TEST_ASSERT_EQUAL_DOUBLE(1, cJSON_CompactGetNumber(cJSON_CompactGetArrayItem(list, 0)));
+    TEST_ASSERT_EQUAL_STRING("two", cJSON_CompactGetString(cJSON_CompactGetArrayItem(list, 1)));
+    TEST_ASSERT_NULL(cJSON_CompactGetName(cJSON_CompactGetArrayItem(list, 1)));
+    TEST_ASSERT_NULL(cJSON_CompactGetArrayItem(list, 3));
+    TEST_ASSERT_NULL(cJSON_CompactGetArrayItem(list, -1));
+    child = cJSON_CompactGetArrayItem(list, 2);
+    TEST_ASSERT_EQUAL_DOUBLE(3, cJSON_CompactGetNumber(cJSON_CompactGetObjectItem(child, "three")));
+    TEST_ASSERT_NULL(cJSON_CompactGetNext(child));
+
+    /* wrong types */
+    TEST_ASSERT_NULL(cJSON_CompactGetString(list));
+    TEST_ASSERT_EQUAL_DOUBLE(0, cJSON_CompactGetNumber(list));
+    TEST_ASSERT_NULL(cJSON_CompactGetObjectItem(list, "two"));
+    TEST_ASSERT_EQUAL_INT(0, cJSON_CompactGetArraySize(child + 1));
+    TEST_ASSERT_EQUAL_INT(cJSON_Invalid, cJSON_CompactGetType(NULL));
+    TEST_ASSERT_NULL(cJSON_CreateCompact(NULL));
+    TEST_ASSERT_NULL(cJSON_ExpandCompact(NULL));
+    cJSON_DeleteCompact(NULL);
+
+    cJSON_DeleteCompact(document);
+    cJSON_Delete(tree);
+}
+
+static void compact_documents_should_expand_subtrees(void)
+{
+    cJSON *tree = cJSON_Parse("[{\"a\":[1,[2,3]],\"b\":{}},\"x\"]");
+    cJSON_Compact *document = NULL;
+    cJSON *expanded = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    document = cJSON_CreateCompact(tree);
+    TEST_ASSERT_NOT_NULL(document);
+
+    expanded = cJSON_ExpandCompact(cJSON_CompactGetArrayItem(document, 0));
+    TEST_ASSERT_NOT_NULL(expanded);
+    printed = cJSON_PrintUnformatted(expanded);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":[1,[2,3]],\"b\":{}}", printed);
+
+    free(printed);
+    cJSON_Delete(expanded);
+    cJSON_DeleteCompact(document);
+    cJSON_Delete(tree);
+}
+
+static void compact_documents_should_be_small(void)
+{
+    cJSON *tree = cJSON_CreateArray();
+    cJSON_Compact *document = NULL;
+    size_t tree_size = sizeof(cJSON);
+    int i = 0;
+
+    for (i = 0; i < 1000; i++)
+    {
+        cJSON *entry = cJSON_CreateObject();
+        cJSON_AddItemToObject(entry, "id", cJSON_CreateNumber(i));
+        cJSON_AddItemToObject(entry, "ok", cJSON_CreateBool(i % 2));
+        cJSON_AddItemToArray(tree, entry);
+        /* the nodes and their names, without the overhead of malloc */
+        tree_size += 3 * sizeof(cJSON) + sizeof("id") + sizeof("ok");
+    }
+
+    document = cJSON_CreateCompact(tree);
+    TEST_ASSERT_NOT_NULL(document);
+    TEST_ASSERT_EQUAL_UINT(16, sizeof(cJSON_Compact));
+    TEST_ASSERT_EQUAL_UINT(COMPACT_HEADER_SIZE + 3001 * sizeof(cJSON_Compact) + 1000 * sizeof(double) + 1000 * (sizeof("id") + sizeof("ok")), cJSON_GetCompactSize(document));
+    TEST_ASSERT_TRUE(2 * cJSON_GetCompactSize(document) < tree_size);
+
+    cJSON_DeleteCompact(document);
+    cJSON_Delete(tree);
+}
+
+static void *copy_image(const cJSON_Compact *document)
+{
+    void *image = malloc(cJSON_GetCompactSize(document));
+    TEST_ASSERT_NOT_NULL(image);
+    memcpy(image, cJSON_GetCompactImage(document), cJSON_GetCompactSize(document));
+
+    return image;
+}
+
+static void compact_images_should_be_loaded_in_place(void)
+{
+    const char json[] = "{\"name\":\"value\",\"list\":[1,\"two\",{\"three\":3}],\"empty\":{},\"yes\":true}";
+    cJSON *tree = cJSON_Parse(json);
+    cJSON_Compact *document = NULL;
+    const cJSON_Compact *loaded = NULL;
+    cJSON *expanded = NULL;
+    unsigned char *image = NULL;
+    char *printed = NULL;
+    size_t size = 0;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    document = cJSON_CreateCompact(tree);
+    TEST_ASSERT_NOT_NULL(document);
+    size = cJSON_GetCompactSize(document);
+    image = (unsigned char*)copy_image(document);
+    cJSON_DeleteCompact(document);
+
+    loaded = cJSON_LoadCompact(image, size, false);
+    TEST_ASSERT_TRUE(loaded == cJSON_LoadCompact(image, size, true));
+    TEST_ASSERT_TRUE((const unsigned char*)cJSON_GetCompactImage(loaded) == image);
+    TEST_ASSERT_EQUAL_UINT(size, cJSON_GetCompactSize(loaded));
+    TEST_ASSERT_EQUAL_STRING("two", cJSON_CompactGetString(cJSON_CompactGetArrayItem(cJSON_CompactGetObjectItem(loaded, "list"), 1)));
+    expanded = cJSON_ExpandCompact(loaded);
+    printed = cJSON_PrintUnformatted(expanded);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+
+    /* too short or not an image */
+    TEST_ASSERT_NULL(cJSON_LoadCompact(image, size - 1, false));
+    TEST_ASSERT_NULL(cJSON_LoadCompact(NULL, size, false));
+    image[0] ^= 1;
+    TEST_ASSERT_NULL(cJSON_LoadCompact(image, size, false));
+
+    free(printed);
+    cJSON_Delete(expanded);
+    free(image);
+    cJSON_Delete(tree);
+}
+
+static void compact_images_should_be_verified(void)
+{
+    cJSON *tree = cJSON_Parse("[{\"a\":[1,[2,\"x\"]],\"b\":{}},\"y\",null,{\"c\":false}]");
+    cJSON_Compact *document = NULL;
+    unsigned char *image = NULL;
+    size_t size = 0;
+    size_t position = 0;
+    unsigned int bit = 0;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    document = cJSON_CreateCompact(tree);
+    TEST_ASSERT_NOT_NULL(document);
+    size = cJSON_GetCompactSize(document);
+    image = (unsigned char*)copy_image(document);
+
+    /* whatever is changed, a verified image can be read and expanded */
+    for (position = 0; position < size; position++)
+    {
+        for (bit = 0; bit < 8; bit++)
+        {
+            const cJSON_Compact *loaded = NULL;
+            cJSON *expanded = NULL;
+
+            image[position] = (unsigned char)(image[position] ^ (1U << bit));
+            loaded = cJSON_LoadCompact(image, size, true);
+            if (loaded != NULL)
+            {
+                expanded = cJSON_ExpandCompact(loaded);
+                TEST_ASSERT_NOT_NULL(expanded);
+                TEST_ASSERT_EQUAL_INT(cJSON_CompactGetArraySize(loaded), cJSON_GetArraySize(expanded));
+                cJSON_Delete(expanded);
+            }
+            image[position] = (unsigned char)(image[position] ^ (1U << bit));
+        }
+    }
+
+    /* the links of the nodes */
+    compact_node(image, 1)->next++;
+    TEST_ASSERT_NOT_NULL(cJSON_LoadCompact(image, size, false));
+    TEST_ASSERT_NULL(cJSON_LoadCompact(image, size, true));
+    compact_node(image, 1)->next--;
+    compact_node(image, 0)->value++;
+    TEST_ASSERT_NULL(cJSON_LoadCompact(image, size, true));
+    compact_node(image, 0)->value--;
+    TEST_ASSERT_NOT_NULL(cJSON_LoadCompact(image, size, true));
+
+    free(image);
+    cJSON_DeleteCompact(document);
+    cJSON_Delete(tree);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(compact_documents_should_keep_the_example_files);
+    RUN_TEST(compact_documents_should_be_readable);
+    RUN_TEST(compact_documents_should_expand_subtrees);
+    RUN_TEST(compact_documents_should_be_small);
+    RUN_TEST(compact_images_should_be_loaded_in_place);
+    RUN_TEST(compact_images_should_be_verified);
+
+    return UNITY_END();
+}
@@ -0,0 +1,378 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static cJSON_bool compare_from_string(const char * const a, const char * const b, const cJSON_bool case_sensitive)
+{
+    cJSON *a_json = NULL;
+    cJSON *b_json = NULL;
+    cJSON_bool result = false;
+
+    a_json = cJSON_Parse(a);
+    TEST_ASSERT_NOT_NULL_MESSAGE(a_json, "Failed to parse a.");
+    b_json = cJSON_Parse(b);
+    TEST_ASSERT_NOT_NULL_MESSAGE(b_json, "Failed to parse b.");
+
+    result = cJSON_Compare(a_json, b_json, case_sensitive);
+    if (result)
+    {
+        TEST_ASSERT_TRUE_MESSAGE(cJSON_Hash(a_json) == cJSON_Hash(b_json), "Equal items have different hashes.");
+    }
+
+    cJSON_Delete(a_json);
+    cJSON_Delete(b_json);
+
+    return result;
+}
+
+static void cjson_compare_should_compare_null_pointer_as_not_equal(void)
+{
+    TEST_ASSERT_FALSE(cJSON_Compare(NULL, NULL, true));
+    TEST_ASSERT_FALSE(cJSON_Compare(NULL, NULL, false));
+}
+
+static void cjson_compare_should_load_lazy_items(void)
+{
+    const char json[] = "{\"a\":[1,{\"b\":2}],\"c\":\"d\"}";
+    cJSON *lazy = cJSON_ParseLazy(json, sizeof(json));
+    cJSON *parsed = cJSON_Parse(json);
+    unsigned long hash = cJSON_Hash(lazy);
+
+    TEST_ASSERT_NOT_NULL(lazy);
+    TEST_ASSERT_TRUE(hash == cJSON_Hash(parsed));
+    cJSON_Delete(lazy);
+
+    lazy = cJSON_ParseLazy(json, sizeof(json));
+    TEST_ASSERT_TRUE(cJSON_Compare(lazy, parsed, true));
+    TEST_ASSERT_TRUE(hash == cJSON_Hash(lazy));
+
+    cJSON_Delete(lazy);
+    cJSON_Delete(parsed);
+}
+
+static void cjson_compare_should_compare_numbers(void)
+{
+    TEST_ASSERT_TRUE(compare_from_string("1", "1", true));
+    TEST_ASSERT_TRUE(compare_from_string("0.0001", "0.0001", true));
+    TEST_ASSERT_TRUE(compare_from_string("0", "-0", true));
+    TEST_ASSERT_FALSE(compare_from_string("1", "2", true));
+    TEST_ASSERT_FALSE(compare_from_string("1", "\"1\"", false));
+}
+
+static void cjson_compare_should_compare_booleans_and_null(void)
+{
+    TEST_ASSERT_TRUE(compare_from_string("true", "true", true));
+    TEST_ASSERT_TRUE(compare_from_string("null", "null", true));
+    TEST_ASSERT_FALSE(compare_from_string("true", "false", true));
+    TEST_ASSERT_FALSE(compare_from_string("null", "false", true));
+}
+
+static void cjson_compare_should_compare_strings_and_raw(void)
+{
+    cJSON *raw1 = cJSON_CreateRaw("[1]");
+    cJSON *raw2 = cJSON_CreateRaw("[1]");
+    cJSON *raw3 = cJSON_CreateRaw("[2]");
+
+    TEST_ASSERT_TRUE(compare_from_string("\"abcdefg\"", "\"abcdefg\"", true));
+    TEST_ASSERT_FALSE(compare_from_string("\"ABCDEFG\"", "\"abcdefg\"", false));
+
+    TEST_ASSERT_TRUE(cJSON_Compare(raw1, raw2, true));
+    TEST_ASSERT_FALSE(cJSON_Compare(raw1, raw3, true));
+    TEST_ASSERT_TRUE(cJSON_Hash(raw1) == cJSON_Hash(raw2));
+
+    cJSON_Delete(raw1);
+    cJSON_Delete(raw2);
+    cJSON_Delete(raw3);
+}
+
+static void cjson_compare_should_compare_arrays(void)
+{
+    TEST_ASSERT_TRUE(compare_from_string("[]", "[]", true));
+    TEST_ASSERT_TRUE(compare_from_string("[false,true,null,42,\"string\",[],{}]", "[false, true, null, 42, \"string\", [], {}]", true));
+    TEST_ASSERT_FALSE(compare_from_string("[1,2,3]", "[3,2,1]", true));
+    TEST_ASSERT_FALSE(compare_from_string("[1,2]", "[1,2,3]", true));
+    TEST_ASSERT_FALSE(compare_from_string("[1,2,3]", "[1,2]", true));
+}
+
+static void cjson_compare_should_compare_objects(void)
+{
+    TEST_ASSERT_TRUE(compare_from_string("{}", "{}", true));
+    TEST_ASSERT_TRUE(compare_from_string("{\"a\":1,\"b\":[1,2],\"c\":{\"d\":null}}", "{\"c\":{\"d\":null},\"a\":1,\"b\":[1,2]}", true));
+    TEST_ASSERT_TRUE(compare_from_string("{\"A\":1,\"b\":2}", "{\"b\":2,\"a\":1}", false));
+    TEST_ASSERT_FALSE(compare_from_string("{\"A\":1,\"b\":2}", "{\"b\":2,\"a\":1}", true));
+    TEST_ASSERT_FALSE(compare_from_string("{\"a\":1,\"b\":2}", "{\"a\":1,\"b\":3}", true));
+    TEST_ASSERT_FALSE(compare_from_string("{\"a\":1,\"b\":2}", "{\"a\":1}", true));
+    TEST_ASSERT_FALSE(compare_from_string("{\"a\":1}", "{\"a\":1,\"b\":2}", true));
+    TEST_ASSERT_FALSE(compare_from_string("{\"a\":1,\"b\":2}", "{\"b\":2,\"c\":1}", true));
+    /* duplicate keys */
+    TEST_ASSERT_FALSE(compare_from_string("{\"a\":1,\"a\":2}", "{\"a\":1,\"b\":2}", true));
+    TEST_ASSERT_FALSE(compare_from_string("{\"a\":1,\"b\":2}", "{\"b\":2,\"b\":2}", true));
+}
+
+static void cjson_hash_should_distinguish_values(void)
+{
+    cJSON *one = cJSON_Parse("{\"a\":[1,2,{\"b\":\"c\"}]}");
+    cJSON *other = cJSON_Parse("{\"a\":[1,2,{\"b\":\"d\"}]}");
+    cJSON *swapped = cJSON_Parse("{\"a\":[2,1,{\"b\":\"c\"}]}");
+
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned int)cJSON_Hash(NULL));
+    TEST_ASSERT_TRUE(cJSON_Hash(one) == cJSON_Hash(one));
+    TEST_ASSERT_TRUE(cJSON_Hash(one) != cJSON_Hash(other));
+    TEST_ASSERT_TRUE(cJSON_Hash(one) != cJSON_Hash(swapped));
+
+    cJSON_Delete(one);
+    cJSON_Delete(other);
+    cJSON_Delete(swapped);
+}
+
+static void cjson_hash_with_cache_should_see_changes(void)
+{
+    cJSON_HashCache *cache = cJSON_CreateHashCache();
+    cJSON *root = cJSON_Parse("{\"a\":[1,2,3],\"b\":{\"c\":true}}");
+    cJSON *copy = cJSON_Duplicate(root, true);
+    unsigned long hash = 0;
+
+    TEST_ASSERT_NOT_NULL(cache);
+    hash = cJSON_HashWithCache(cache, root);
+    TEST_ASSERT_TRUE(hash == cJSON_Hash(root));
+    /* the second time it comes from the cache */
+    TEST_ASSERT_TRUE(hash == cJSON_HashWithCache(cache, root));
+    TEST_ASSERT_TRUE(cJSON_CompareWithCache(cache, root, copy, true));
+
+    cJSON_AddItemToArray(cJSON_GetObjectItem(root, "a"), cJSON_CreateNumber(4));
+    TEST_ASSERT_TRUE(cJSON_HashWithCache(cache, root) == cJSON_Hash(root));
+    TEST_ASSERT_TRUE(cJSON_HashWithCache(cache, root) != hash);
+    TEST_ASSERT_FALSE(cJSON_CompareWithCache(cache, root, copy, true));
+
+    cJSON_DeleteItemFromArray(cJSON_GetObjectItem(root, "a"), 3);
+    TEST_ASSERT_TRUE(cJSON_HashWithCache(cache, root) == hash);
+    TEST_ASSERT_TRUE(cJSON_CompareWithCache(cache, root, copy, true));
+
+    cJSON_SetNumberValue(cJSON_GetArrayItem(cJSON_GetObjectItem(root, "a"), 0), 5);
+    TEST_ASSERT_TRUE(cJSON_HashWithCache(cache, root) == cJSON_Hash(root));
+    TEST_ASSERT_FALSE(cJSON_CompareWithCache(cache, root, copy, true));
+
+    cJSON_ReplaceItemInObject(root, "b", cJSON_CreateNull());
+    TEST_ASSERT_TRUE(cJSON_HashWithCache(cache, root) == cJSON_Hash(root));
+
+    cJSON_Delete(root);
+    cJSON_Delete(copy);
+    cJSON_DeleteHashCache(cache);
+}
+
+static void cjson_hash_with_cache_should_keep_unchanged_trees(void)
+{
+    cJSON_HashCache *cache = cJSON_CreateHashCache();
+    cJSON *root = cJSON_Parse("{\"a\":[1,2,3],\"b\":{\"c\":true}}");
+    cJSON *other = cJSON_Parse("[[1],[2]]");
+    cJSON *moved = NULL;
+    size_t slot = 0;
+
+    TEST_ASSERT_NOT_NULL(cache);
+    TEST_ASSERT_TRUE(cJSON_HashWithCache(cache, root) == cJSON_Hash(root));
+    TEST_ASSERT_TRUE(cJSON_HashWithCache(cache, other) == cJSON_Hash(other));
+    TEST_ASSERT_TRUE(cache->count == 6);
+
+    /* a change to another tree doesn't drop the hash of root, so it is taken from the cache */
+    cJSON_AddItemToArray(other, cJSON_CreateNull());
+    for (slot = 0; slot < cache->size; slot++)
+    {
+        if (cache->entries[slot].item == root)
+        {
+            cache->entries[slot].hash = 42;
+        }
+    }
+    TEST_ASSERT_TRUE(cJSON_HashWithCache(cache, root) == 42);
+    TEST_ASSERT_TRUE(cJSON_HashWithCache(cache, other) == cJSON_Hash(other));
+
+    /* a moved array keeps its hash, the arrays it was moved from and to are hashed again */
+    moved = cJSON_DetachItemFromArray(other, 0);
+    cJSON_AddItemToObject(root, "d", moved);
+    TEST_ASSERT_TRUE(cJSON_HashWithCache(cache, root) == cJSON_Hash(root));
+    TEST_ASSERT_TRUE(cJSON_HashWithCache(cache, other) == cJSON_Hash(other));
+    TEST_ASSERT_TRUE(cache->count == 6);
+
+    cJSON_Delete(root);
+    cJSON_Delete(other);
+    cJSON_DeleteHashCache(cache);
+}
+
+static void cjson_hash_with_cache_should_grow(void)
+{
+    cJSON_HashCache *cache = cJSON_CreateHashCache();
+    cJSON *root = cJSON_CreateArray();
+    size_t i = 0;
+
+    for (i = 0; i < 1000; i++)
+    {
+        cJSON *inner = cJSON_CreateArray();
+        cJSON_AddItemToArray(inner, cJSON_CreateNumber((double)i));
+        cJSON_AddItemToArray(root, inner);
+    }
+    TEST_ASSERT_TRUE(cJSON_HashWithCache(cache, root) == cJSON_Hash(root));
+    TEST_ASSERT_TRUE(cache->count == 1001);
+    TEST_ASSERT_TRUE(cJSON_HashWithCache(cache, root) == cJSON_Hash(root));
+
+    cJSON_Delete(root);
+    cJSON_DeleteHashCache(cache);
+}
+
+static cJSON_bool text_equals(const char * const a, const char * const b, const int flags)
+{
+    cJSON_bool equal = cJSON_TextEquals(a, strlen(a), b, strlen(b), flags);
+
+    /* it is symmetric */
+    TEST_ASSERT_EQUAL_INT(equal, cJSON_TextEquals(b, strlen(b), a, strlen(a), flags));
+
+    return equal;
+}
+
+static void cjson_text_equals_should_compare_values(void)
+{
+    TEST_ASSERT_TRUE(text_equals("1", " 1.0e0 ", 0));
+    TEST_ASSERT_TRUE(text_equals("-0", "0", 0));
+    TEST_ASSERT_FALSE(text_equals("1", "2", 0));
+    TEST_ASSERT_TRUE(text_equals("[true, false, null]", "[true,false,null]", 0));
+    TEST_ASSERT_FALSE(text_equals("[true]", "[false]", 0));
+    TEST_ASSERT_FALSE(text_equals("null", "0", 0));
+    TEST_ASSERT_FALSE(text_equals("1", "\"1\"", 0));
+    TEST_ASSERT_FALSE(text_equals("1", "[1]", 0));
+    TEST_ASSERT_FALSE(text_equals("[]", "{}", 0));
+    TEST_ASSERT_TRUE(text_equals("[[], {}]", "[ [ ] , { } ]", 0));
+    TEST_ASSERT_FALSE(text_equals("[1, 2]", "[1]", 0));
+    TEST_ASSERT_FALSE(text_equals("[1]", "[1, 2]", 0));
+    TEST_ASSERT_FALSE(text_equals("[]", "[1]", 0));
+
+    /* strings after unescaping */
+    TEST_ASSERT_TRUE(text_equals("\"a\\u00e9\\n\\/\"", "\"a\xc3\xa9\\u000a/\"", 0));
+    TEST_ASSERT_TRUE(text_equals("\"\\ud83d\\ude00\"", "\"\xf0\x9f\x98\x80\"", 0));
+    TEST_ASSERT_FALSE(text_equals("\"\\u00e9\"", "\"\xc3\"", 0));
+    TEST_ASSERT_FALSE(text_equals("\"abc\"", "\"abd\"", 0));
+    TEST_ASSERT_FALSE(text_equals("\"abc\"", "\"ABC\"", cJSON_TextEquals_CaseInsensitive));
+
+    /* invalid or trailing text */
+    TEST_ASSERT_FALSE(text_equals("[1,", "[1,", 0));
+    TEST_ASSERT_FALSE(text_equals("1 2", "1 2", 0));
+    TEST_ASSERT_FALSE(text_equals("\"\\x\"", "\"\\x\"", 0));
+    TEST_ASSERT_FALSE(text_equals("", "", 0));
+    TEST_ASSERT_FALSE(cJSON_TextEquals(NULL, 0, "1", 1, 0));
+
+    /* only the given length is read */
+    TEST_ASSERT_TRUE(cJSON_TextEquals("[1]]", 3, "[1]", 3, 0));
+}
+
+static void cjson_text_equals_should_compare_objects(void)
+{
+    TEST_ASSERT_TRUE(text_equals("{\"a\": 1, \"b\": [2]}", "{\"a\":1,\"b\":[2]}", 0));
+    TEST_ASSERT_FALSE(text_equals("{\"a\": 1, \"b\": 2}", "{\"b\": 2, \"a\": 1}", 0));
+    TEST_ASSERT_TRUE(text_equals("{\"a\": 1, \"b\": 2}", "{\"b\": 2, \"a\": 1}", cJSON_TextEquals_Unordered));
+    TEST_ASSERT_TRUE(text_equals("{\"a\": {\"x\": [1, {\"y\": 2, \"z\": 3}]}, \"b\": 2, \"c\": \"c\"}",
+                "{\"c\": \"c\", \"a\": {\"x\": [1, {\"z\": 3, \"y\": 2}]}, \"b\": 2}", cJSON_TextEquals_Unordered));
+    TEST_ASSERT_FALSE(text_equals("{\"a\": 1, \"b\": 2}", "{\"b\": 2, \"a\": 3}", cJSON_TextEquals_Unordered));
+    TEST_ASSERT_FALSE(text_equals("{\"a\": 1, \"b\": 2}", "{\"b\": 2}", cJSON_TextEquals_Unordered));
+    TEST_ASSERT_FALSE(text_equals("{\"a\": 1, \"b\": 2}", "{\"b\": 2, \"a\": 1, \"c\": 3}", cJSON_TextEquals_Unordered));
+    TEST_ASSERT_FALSE(text_equals("{\"a\": 1, \"a\": 1}", "{\"a\": 1, \"b\": 1}", cJSON_TextEquals_Unordered));
+    TEST_ASSERT_TRUE(text_equals("{}", " { } ", cJSON_TextEquals_Unordered));
+
+    /* names after unescaping, optionally case insensitive */
+    TEST_ASSERT_TRUE(text_equals("{\"\\u0061\": 1}", "{\"a\": 1}", 0));
+    TEST_ASSERT_FALSE(text_equals("{\"A\": 1}", "{\"a\": 1}", 0));
+    TEST_ASSERT_TRUE(text_equals("{\"A\": 1}", "{\"a\": 1}", cJSON_TextEquals_CaseInsensitive));
+    TEST_ASSERT_TRUE(text_equals("{\"A\": 1, \"b\": 2}", "{\"B\": 2, \"a\": 1}", cJSON_TextEquals_Unordered | cJSON_TextEquals_CaseInsensitive));
+
+    /* invalid members */
+    TEST_ASSERT_FALSE(text_equals("{\"a\" 1}", "{\"a\" 1}", 0));
+    TEST_ASSERT_FALSE(text_equals("{\"a\": 1, \"b\": 2}", "{\"b\": 2, \"a\" 1}", cJSON_TextEquals_Unordered));
+    TEST_ASSERT_FALSE(text_equals("{\"a\": 1}", "{\"b\": [, \"a\": 1}", cJSON_TextEquals_Unordered));
+}
+
+static void cjson_text_equals_should_agree_with_cjson_compare(void)
+{
+    const char *documents[] = {
+        "{\"id\": 1, \"tags\": [\"a\", \"b\"], \"user\": {\"name\": \"x\", \"age\": 3}}",
+        "{\"tags\": [\"a\", \"b\"], \"user\": {\"age\": 3, \"name\": \"x\"}, \"id\": 1.0}",
+        "{\"tags\": [\"b\", \"a\"], \"user\": {\"age\": 3, \"name\": \"x\"}, \"id\": 1}",
+        "{\"id\": 1, \"tags\": [\"a\", \"b\"], \"user\": {\"name\": \"x\", \"age\": 4}}",
+        "{\"id\": 1, \"tags\": [\"a\", \"b\"], \"user\": {\"name\": \"x\"}}"
+    };
+    size_t i = 0;
+    size_t j = 0;
+
+    for (i = 0; i < sizeof(documents) / sizeof(documents[0]); i++)
+    {
+        for (j = 0; j < sizeof(documents) / sizeof(documents[0]); j++)
+        {
+            cJSON *a = cJSON_Parse(documents[i]);
+            cJSON *b = cJSON_Parse(documents[j]);
+
+            TEST_ASSERT_EQUAL_INT(cJSON_Compare(a, b, true), text_equals(documents[i], documents[j], cJSON_TextEquals_Unordered));
+            cJSON_Delete(a);
+            cJSON_Delete(b);
+        }
+    }
+}
+
+static void cjson_text_equals_should_handle_deep_nesting(void)
+{
+    char a[2 * 200 + 2];
+    char b[2 * 200 + 2];
+
+    memset(a, '[', 200);
+    memset(a + 200, ']', 200);
+    a[400] = '\0';
+    memcpy(b, a, sizeof(a));
+    TEST_ASSERT_TRUE(text_equals(a, b, 0));
+    b[199] = '{';
+    b[200] = '}';
+    TEST_ASSERT_FALSE(text_equals(a, b, 0));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(cjson_compare_should_compare_null_pointer_as_not_equal);
+    RUN_TEST(cjson_compare_should_load_lazy_items);
+    RUN_TEST(cjson_compare_should_compare_numbers);
+    RUN_TEST(cjson_compare_should_compare_booleans_and_null);
+    RUN_TEST(cjson_compare_should_compare_strings_and_raw);
+    RUN_TEST(cjson_compare_should_compare_arrays);
+    RUN_TEST(cjson_compare_should_compare_objects);
+    RUN_TEST(cjson_hash_should_distinguish_values);
+    RUN_TEST(cjson_hash_with_cache_should_see_changes);
+    RUN_TEST(cjson_hash_with_cache_should_keep_unchanged_trees);
+    RUN_TEST(cjson_hash_with_cache_should_grow);
+    RUN_TEST(cjson_text_equals_should_compare_values);
+    RUN_TEST(cjson_text_equals_should_compare_objects);
+    RUN_TEST(cjson_text_equals_should_agree_with_cjson_compare);
+    RUN_TEST(cjson_text_equals_should_handle_deep_nesting);
+
+    return UNITY_END();
+}
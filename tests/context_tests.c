@@ -0,0 +1,178 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+/* a context allocator that keeps track of what it hands out */
+static size_t live_allocations = 0;
+
+static void *context_malloc(size_t size)
+{
+    live_allocations++;
+    return malloc(size);
+}
+
+static void context_free(void *pointer)
+{
+    if (pointer != NULL)
+    {
+        live_allocations--;
+    }
+    free(pointer);
+}
+
+/* the global allocator must not be used while a context is */
+static void *failing_malloc(size_t size)
+{
+    (void)size;
+    TEST_FAIL_MESSAGE("The global allocator was used.");
+    return NULL;
+}
+
+static void failing_free(void *pointer)
+{
+    (void)pointer;
+    TEST_FAIL_MESSAGE("The global allocator was used.");
+}
+
+static cJSON_Hooks context_hooks = { context_malloc, context_free };
+static cJSON_Hooks failing_hooks = { failing_malloc, failing_free };
+
+static void context_should_parse_print_and_delete_with_its_allocator(void)
+{
+    const char json[] = "{\"name\":\"cJSON\",\"list\":[1,2.5,true,null,[]],\"object\":{\"a\":\"b\"}}";
+    cJSON_Context *context = cJSON_CreateContext(&context_hooks, NULL);
+    const char *end = NULL;
+    cJSON *item = NULL;
+    cJSON *copy = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(context);
+    TEST_ASSERT_EQUAL_UINT(1, (unsigned int)live_allocations);
+
+    cJSON_InitHooks(&failing_hooks);
+
+    item = cJSON_ContextParse(context, json, sizeof(json) - 1, &end, true);
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_TRUE(end == (json + sizeof(json) - 1));
+
+    copy = cJSON_ContextDuplicate(context, item, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    cJSON_ContextDelete(context, item);
+
+    printed = cJSON_ContextPrint(context, copy, false);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    cJSON_ContextFree(context, printed);
+    cJSON_ContextDelete(context, copy);
+
+    TEST_ASSERT_NULL(cJSON_ContextParse(context, "[1,}", 4, &end, false));
+    TEST_ASSERT_EQUAL_STRING("}", end);
+
+    cJSON_InitHooks(NULL);
+
+    TEST_ASSERT_EQUAL_UINT(1, (unsigned int)live_allocations);
+    cJSON_DeleteContext(context);
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned int)live_allocations);
+}
+
+static void context_should_create_items_with_its_allocator(void)
+{
+    cJSON_Context *context = cJSON_CreateContext(&context_hooks, NULL);
+    cJSON *object = NULL;
+    cJSON *array = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(context);
+    cJSON_InitHooks(&failing_hooks);
+
+    object = cJSON_ContextCreateObject(context);
+    array = cJSON_ContextCreateArray(context);
+    TEST_ASSERT_NOT_NULL(object);
+    TEST_ASSERT_NOT_NULL(array);
+    cJSON_AddItemToArray(array, cJSON_ContextCreateNull(context));
+    cJSON_AddItemToArray(array, cJSON_ContextCreateBool(context, true));
+    cJSON_AddItemToArray(array, cJSON_ContextCreateNumber(context, 42));
+    cJSON_AddItemToArray(array, cJSON_ContextCreateRaw(context, "{}"));
+    cJSON_ContextAddItemToObject(context, object, "array", array);
+    cJSON_ContextAddItemToObject(context, object, "string", cJSON_ContextCreateString(context, "text"));
+
+    printed = cJSON_ContextPrint(context, object, false);
+    TEST_ASSERT_EQUAL_STRING("{\"array\":[null,true,42,{}],\"string\":\"text\"}", printed);
+    cJSON_ContextFree(context, printed);
+
+    /* keys can be replaced, the old one is freed by the context */
+    cJSON_ContextAddItemToObject(context, array, "renamed", cJSON_DetachItemFromObject(object, "string"));
+    TEST_ASSERT_EQUAL_STRING("renamed", cJSON_GetArrayItem(array, 4)->string);
+
+    cJSON_ContextDelete(context, object);
+
+    cJSON_InitHooks(NULL);
+    cJSON_DeleteContext(context);
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned int)live_allocations);
+}
+
+static void context_functions_should_handle_null(void)
+{
+    cJSON_Context *context = cJSON_CreateContext(NULL, NULL);
+    cJSON *item = NULL;
+
+    TEST_ASSERT_NOT_NULL(context);
+    TEST_ASSERT_TRUE(context->hooks.reallocate == realloc);
+
+    TEST_ASSERT_NULL(cJSON_ContextParse(NULL, "[]", 2, NULL, false));
+    TEST_ASSERT_NULL(cJSON_ContextPrint(NULL, NULL, false));
+    TEST_ASSERT_NULL(cJSON_ContextDuplicate(NULL, NULL, false));
+    TEST_ASSERT_NULL(cJSON_ContextCreateObject(NULL));
+    TEST_ASSERT_NULL(cJSON_ContextParse(context, NULL, 0, NULL, false));
+    TEST_ASSERT_NULL(cJSON_ContextPrint(context, NULL, false));
+    TEST_ASSERT_NULL(cJSON_ContextDuplicate(context, NULL, true));
+    TEST_ASSERT_NULL(cJSON_ContextCreateString(context, NULL));
+    cJSON_ContextDelete(NULL, NULL);
+    cJSON_ContextDelete(context, NULL);
+    cJSON_ContextFree(context, NULL);
+
+    item = cJSON_ContextCreateArray(context);
+    cJSON_ContextAddItemToObject(context, item, "nothing", NULL);
+    TEST_ASSERT_NULL(item->child);
+    cJSON_ContextDelete(context, item);
+
+    cJSON_DeleteContext(context);
+    cJSON_DeleteContext(NULL);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(context_should_parse_print_and_delete_with_its_allocator);
+    RUN_TEST(context_should_create_items_with_its_allocator);
+    RUN_TEST(context_functions_should_handle_null);
+
+    return UNITY_END();
+}
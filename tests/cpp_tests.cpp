@@ -0,0 +1,249 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <utility>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "../cJSON.hpp"
+
+static void document_should_own_its_tree(void)
+{
+    cjson::Document document = cjson::Document::parse("{\"name\":\"value\",\"list\":[1,2,3]}");
+    cjson::Document moved;
+    cJSON *tree = document.get();
+
+    TEST_ASSERT_TRUE(static_cast<bool>(document));
+    moved = std::move(document);
+    TEST_ASSERT_FALSE(static_cast<bool>(document));
+    TEST_ASSERT_TRUE(moved.get() == tree);
+
+    cjson::Document constructed(std::move(moved));
+    TEST_ASSERT_TRUE(constructed.get() == tree);
+    TEST_ASSERT_NULL(moved.get());
+
+    tree = constructed.release();
+    TEST_ASSERT_FALSE(static_cast<bool>(constructed));
+    cJSON_Delete(tree);
+
+    TEST_ASSERT_FALSE(static_cast<bool>(cjson::Document::parse("{\"name\":}")));
+    TEST_ASSERT_FALSE(static_cast<bool>(cjson::Document::parse("[1] [2]")));
+    /* the text doesn't have to be null terminated */
+    TEST_ASSERT_TRUE(static_cast<bool>(cjson::Document::parse(std::string_view("[1]garbage", 3))));
+}
+
+static void value_should_read_items(void)
+{
+    const char json[] = "{\"string\":\"text\",\"number\":1.5,\"true\":true,\"null\":null,\"list\":[1,2,3],\"empty\":{}}";
+    cjson::Document document = cjson::Document::parse(json);
+    cjson::Value root = document.root();
+    double sum = 0;
+    std::string names;
+
+    TEST_ASSERT_TRUE(root.is_object());
+    TEST_ASSERT_EQUAL_UINT(6, static_cast<unsigned int>(root.size()));
+    TEST_ASSERT_TRUE(root["string"].as_string() == "text");
+    TEST_ASSERT_TRUE(root["string"].name() == "string");
+    TEST_ASSERT_EQUAL_DOUBLE(1.5, root["number"].as_number());
+    TEST_ASSERT_TRUE(root["true"].as_bool());
+    TEST_ASSERT_TRUE(root["null"].is_null());
+    TEST_ASSERT_EQUAL_INT(2, static_cast<int>(root[std::string("list")].at(1).as_number()));
+
+    /* missing and mismatched items read as nothing */
+    TEST_ASSERT_FALSE(static_cast<bool>(root["missing"]));
+    TEST_ASSERT_FALSE(static_cast<bool>(root["String"]));
+    TEST_ASSERT_TRUE(root["missing"]["deeper"].as_string().empty());
+    TEST_ASSERT_EQUAL_DOUBLE(7, root["string"].as_number(7));
+    TEST_ASSERT_TRUE(root["number"].as_bool(true));
+    TEST_ASSERT_FALSE(static_cast<bool>(root["list"].at(3)));
+    TEST_ASSERT_EQUAL_UINT(0, static_cast<unsigned int>(root["missing"].size()));
+
+    for (cjson::Value element : root["list"])
+    {
+        sum += element.as_number();
+    }
+    TEST_ASSERT_EQUAL_DOUBLE(6, sum);
+    for (cjson::Value member : root)
+    {
+        names.append(member.name());
+    }
+    TEST_ASSERT_EQUAL_STRING("stringnumbertruenulllistempty", names.c_str());
+    TEST_ASSERT_TRUE(root["empty"].begin() == root["empty"].end());
+
+    TEST_ASSERT_EQUAL_STRING(json, root.print().c_str());
+    TEST_ASSERT_TRUE(cjson::Value().print().empty());
+}
+
+static void value_should_read_number_text(void)
+{
+    const char json[] = "[12345678901234567890]";
+    cjson::Document document(cJSON_ParseWithNumberText(json, sizeof(json) - 1));
+
+    TEST_ASSERT_TRUE(document.root().at(0).number_text() == "12345678901234567890");
+    TEST_ASSERT_TRUE(cjson::Document::number(1).root().number_text().empty());
+}
+
+static void value_should_move_items_between_documents(void)
+{
+    cjson::Document source = cjson::Document::parse("{\"keep\":1,\"move\":[1,{\"a\":2}]}");
+    cjson::Document target = cjson::Document::object();
+    cjson::Document moved = source.root().detach("move");
+    cJSON *tree = moved.get();
+    cjson::Value added;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    TEST_ASSERT_EQUAL_STRING("{\"keep\":1}", source.root().print().c_str());
+
+    added = target.root().add("moved", std::move(moved));
+    TEST_ASSERT_TRUE(added.get() == tree);
+    TEST_ASSERT_FALSE(static_cast<bool>(moved));
+    added.append(cjson::Document::string(std::string("appended")));
+    added.at(0).set_number(10);
+    target.root().add("null", cjson::Document::null());
+    target.root().add("false", cjson::Document::boolean(false));
+    TEST_ASSERT_EQUAL_STRING("{\"moved\":[10,{\"a\":2},\"appended\"],\"null\":null,\"false\":false}", target.root().print().c_str());
+
+    /* nothing happens to items that can't be added */
+    moved = cjson::Document::number(1);
+    TEST_ASSERT_FALSE(static_cast<bool>(target.root()["null"].add("x", std::move(moved))));
+    TEST_ASSERT_FALSE(static_cast<bool>(target.root()["null"].append(std::move(moved))));
+    TEST_ASSERT_TRUE(static_cast<bool>(moved));
+    TEST_ASSERT_FALSE(static_cast<bool>(target.root().detach("missing")));
+
+    /* detached items go with their document */
+    moved = target.root()["moved"].detach(target.root()["moved"].at(1));
+    TEST_ASSERT_EQUAL_STRING("{\"a\":2}", moved.root().print().c_str());
+
+    cjson::Document copy = target.duplicate();
+    TEST_ASSERT_TRUE(cJSON_Compare(copy.get(), target.get(), 1));
+    TEST_ASSERT_FALSE(copy.get() == target.get());
+}
+
+using namespace cjson::literals;
+
+static void key_should_be_hashed_at_compile_time(void)
+{
+    constexpr cjson::Key key = "TimeStamp"_k;
+    constexpr cjson::Key from_array("TimeStamp");
+
+    static_assert(key.length() == 9, "the length is known at compile time");
+    static_assert(key.hash() == from_array.hash(), "the hash is known at compile time");
+    TEST_ASSERT_TRUE(key.is_ascii());
+    TEST_ASSERT_TRUE(key.hash() == cJSON_HashName("TimeStamp"));
+    TEST_ASSERT_TRUE(key.hash() == cJSON_HashName("timestamp"));
+    TEST_ASSERT_FALSE(cjson::Key("gr\xC3\xBC\xC3\x9F").is_ascii());
+}
+
+static void value_should_look_up_keys(void)
+{
+    cjson::Document document = cjson::Document::parse("{\"id\":42,\"ID\":-1,\"gr\xC3\xBC\xC3\x9F\":\"hello\",\"flag\":true,\"big\":1e30,\"text\":\"t\"}");
+    cjson::Value root = document.root();
+    int pass = 0;
+
+    /* with and without an index */
+    for (pass = 0; pass < 2; pass++)
+    {
+        TEST_ASSERT_EQUAL_INT(42, static_cast<int>(root["id"_k].as_number()));
+        TEST_ASSERT_EQUAL_INT(-1, static_cast<int>(root["ID"_k].as_number()));
+        TEST_ASSERT_FALSE(static_cast<bool>(root["Id"_k]));
+        TEST_ASSERT_FALSE(static_cast<bool>(root["i"_k]));
+        TEST_ASSERT_FALSE(static_cast<bool>(root["idx"_k]));
+        TEST_ASSERT_TRUE(root["gr\xC3\xBC\xC3\x9F"_k].as_string() == "hello");
+
+        TEST_ASSERT_TRUE(root.get<std::int64_t>("id"_k) == 42);
+        TEST_ASSERT_TRUE(root.get<unsigned int>("ID"_k) == 0);
+        TEST_ASSERT_TRUE(root.get<std::int64_t>("big"_k) == INT64_MAX);
+        TEST_ASSERT_TRUE(root.get<int>("text"_k, 5) == 5);
+        TEST_ASSERT_TRUE(root.get<int>("missing"_k, 5) == 5);
+        TEST_ASSERT_TRUE(root.get<bool>("flag"_k));
+        TEST_ASSERT_TRUE(root.get<bool>("id"_k, true));
+        TEST_ASSERT_EQUAL_DOUBLE(1e30, root.get<double>("big"_k));
+        TEST_ASSERT_TRUE(root.get<std::string_view>("text"_k) == "t");
+        TEST_ASSERT_TRUE(root.get<std::string_view>("id"_k, "none") == "none");
+
+        TEST_ASSERT_TRUE(cJSON_BuildIndex(root.get()));
+    }
+}
+
+static size_t allocations = 0;
+
+static void *counting_malloc(size_t size)
+{
+    allocations++;
+    return std::malloc(size);
+}
+
+static void counting_free(void *pointer)
+{
+    if (pointer != nullptr)
+    {
+        allocations--;
+    }
+    std::free(pointer);
+}
+
+static void document_should_use_the_allocator_of_its_context(void)
+{
+    cJSON_Hooks hooks = { counting_malloc, counting_free };
+    cJSON_Context *context = cJSON_CreateContext(&hooks, nullptr);
+    size_t created = 0;
+
+    TEST_ASSERT_NOT_NULL(context);
+    created = allocations;
+    {
+        cjson::Document document = cjson::Document::parse("{\"list\":[1,2]}", context);
+        cjson::Document other = cjson::Document::object(context);
+        TEST_ASSERT_TRUE(document.context() == context);
+        TEST_ASSERT_TRUE(allocations > created);
+
+        other.root().add("list", document.root().detach("list"));
+        other.root()["list"].append(cjson::Document::string("three", context));
+        TEST_ASSERT_TRUE(other.root()["list"].context() == context);
+        TEST_ASSERT_EQUAL_STRING("{\"list\":[1,2,\"three\"]}", other.root().print().c_str());
+
+        cjson::Document copy = other.duplicate();
+        TEST_ASSERT_TRUE(copy.context() == context);
+    }
+    /* freed nodes are kept by the node cache */
+    cJSON_TrimNodeCache(0);
+    TEST_ASSERT_EQUAL_UINT(static_cast<unsigned int>(created), static_cast<unsigned int>(allocations));
+
+    cJSON_DeleteContext(context);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(document_should_own_its_tree);
+    RUN_TEST(value_should_read_items);
+    RUN_TEST(value_should_read_number_text);
+    RUN_TEST(value_should_move_items_between_documents);
+    RUN_TEST(key_should_be_hashed_at_compile_time);
+    RUN_TEST(value_should_look_up_keys);
+    RUN_TEST(document_should_use_the_allocator_of_its_context);
+
+    return UNITY_END();
+}
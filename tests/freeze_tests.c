@@ -0,0 +1,153 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static const char large_object[] = "{\"a\":0,\"b\":1,\"c\":2,\"d\":3,\"e\":4,\"f\":5,\"g\":6,\"h\":7,\"i\":8,\"j\":9,\"k\":10,"
+                                   "\"l\":11,\"m\":12,\"n\":13,\"o\":14,\"p\":15,\"q\":[1,2,3],\"r\":{\"s\":\"t\"}}";
+
+static void assert_frozen(const cJSON *item)
+{
+    const cJSON *child = NULL;
+
+    TEST_ASSERT_BITS(cJSON_IsFrozen, cJSON_IsFrozen, item->type);
+    TEST_ASSERT_BITS(cJSON_IsLazy | cJSON_IsPacked, 0, item->type);
+    for (child = item->child; child != NULL; child = child->next)
+    {
+        assert_frozen(child);
+    }
+}
+
+static void freeze_should_load_and_index_the_tree(void)
+{
+    cJSON *lazy = cJSON_ParseLazy(large_object, sizeof(large_object) - 1);
+    cJSON *packed = cJSON_ParsePacked(large_object, sizeof(large_object) - 1);
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(lazy);
+    TEST_ASSERT_NOT_NULL(packed);
+    TEST_ASSERT_TRUE(cJSON_Freeze(lazy));
+    TEST_ASSERT_TRUE(cJSON_Freeze(packed));
+    assert_frozen(lazy);
+    assert_frozen(packed);
+
+    /* large containers are indexed, short ones are searched */
+    TEST_ASSERT_NOT_NULL(get_index(lazy));
+    TEST_ASSERT_NULL(get_index(cJSON_GetObjectItem(lazy, "q")));
+    TEST_ASSERT_EQUAL_INT(15, cJSON_GetObjectItem(packed, "p")->valueint);
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetArrayItem(cJSON_GetObjectItem(packed, "q"), 2)->valueint);
+    TEST_ASSERT_EQUAL_STRING("t", cJSON_GetObjectItem(cJSON_GetObjectItem(lazy, "r"), "s")->valuestring);
+
+    printed = cJSON_PrintUnformatted(lazy);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_STRING(large_object, printed);
+    global_hooks.deallocate(printed);
+
+    /* freezing again changes nothing */
+    TEST_ASSERT_TRUE(cJSON_Freeze(lazy));
+    TEST_ASSERT_FALSE(cJSON_Freeze(NULL));
+
+    cJSON_Delete(lazy);
+    cJSON_Delete(packed);
+}
+
+static void freeze_should_bring_existing_indexes_up_to_date(void)
+{
+    cJSON *array = cJSON_Parse("[1,2]");
+
+    TEST_ASSERT_NOT_NULL(array);
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(array));
+    cJSON_AddItemToArray(array, cJSON_CreateNumber(3));
+    TEST_ASSERT_TRUE(cJSON_Freeze(array));
+    TEST_ASSERT_NOT_NULL(get_index(array));
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetArraySize(array));
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetArrayItem(array, 2)->valueint);
+
+    /* frozen indexes aren't deleted or rebuilt */
+    cJSON_DeleteIndex(array);
+    TEST_ASSERT_NOT_NULL(get_index(array));
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(array));
+
+    cJSON_Delete(array);
+}
+
+static void frozen_items_should_not_be_changed(void)
+{
+    cJSON *object = cJSON_Parse("{\"a\":[1,2],\"b\":\"c\",\"d\":4}");
+    cJSON *item = cJSON_CreateNumber(5);
+    cJSON *copy = NULL;
+    char *before = NULL;
+    char *after = NULL;
+
+    TEST_ASSERT_NOT_NULL(object);
+    TEST_ASSERT_TRUE(cJSON_Freeze(object));
+    before = cJSON_PrintUnformatted(object);
+    TEST_ASSERT_NOT_NULL(before);
+
+    cJSON_AddItemToObject(object, "e", item);
+    cJSON_AddItemToArray(cJSON_GetObjectItem(object, "a"), item);
+    cJSON_InsertItemInArray(cJSON_GetObjectItem(object, "a"), 0, item);
+    TEST_ASSERT_NULL(cJSON_DetachItemFromObject(object, "b"));
+    TEST_ASSERT_NULL(cJSON_DetachItemFromArray(cJSON_GetObjectItem(object, "a"), 0));
+    cJSON_ReplaceItemInObject(object, "d", item);
+    cJSON_ReplaceItemInArray(cJSON_GetObjectItem(object, "a"), 1, item);
+    TEST_ASSERT_FALSE(cJSON_ReplaceItemViaPointer(object, cJSON_GetObjectItem(object, "d"), item));
+    TEST_ASSERT_EQUAL_DOUBLE(4, cJSON_SetNumberValue(cJSON_GetObjectItem(object, "d"), 6));
+    cJSON_DeleteItemFromObject(object, "b");
+    TEST_ASSERT_NULL(item->next);
+    TEST_ASSERT_NULL(item->prev);
+
+    after = cJSON_PrintUnformatted(object);
+    TEST_ASSERT_NOT_NULL(after);
+    TEST_ASSERT_EQUAL_STRING(before, after);
+    global_hooks.deallocate(after);
+
+    /* copies can be changed */
+    copy = cJSON_Duplicate(object, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_BITS(cJSON_IsFrozen, 0, copy->type);
+    TEST_ASSERT_BITS(cJSON_IsFrozen, 0, copy->child->type);
+    cJSON_AddItemToObject(copy, "e", item);
+    TEST_ASSERT_EQUAL_INT(5, cJSON_GetObjectItem(copy, "e")->valueint);
+
+    global_hooks.deallocate(before);
+    cJSON_Delete(copy);
+    cJSON_Delete(object);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(freeze_should_load_and_index_the_tree);
+    RUN_TEST(freeze_should_bring_existing_indexes_up_to_date);
+    RUN_TEST(frozen_items_should_not_be_changed);
+
+    return UNITY_END();
+}
@@ -0,0 +1,318 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static cJSON *create_object(int count)
+{
+    cJSON *object = cJSON_CreateObject();
+    char name[32];
+    int i = 0;
+
+    TEST_ASSERT_NOT_NULL(object);
+    for (i = 0; i < count; i++)
+    {
+        sprintf(name, "key%d", i);
+        cJSON_AddItemToObject(object, name, cJSON_CreateNumber(i));
+    }
+
+    return object;
+}
+
+static void assert_lookup(const cJSON *object, const char *name, int value)
+{
+    cJSON *item = cJSON_GetObjectItemCaseSensitive(object, name);
+    TEST_ASSERT_NOT_NULL_MESSAGE(item, name);
+    TEST_ASSERT_EQUAL_INT(value, item->valueint);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(object, name) == item);
+}
+
+static void index_should_find_members(void)
+{
+    cJSON *object = create_object(1000);
+    char name[32];
+    int i = 0;
+
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(object));
+    TEST_ASSERT_NOT_NULL(get_index(object));
+
+    for (i = 0; i < 1000; i++)
+    {
+        sprintf(name, "key%d", i);
+        assert_lookup(object, name, i);
+    }
+    TEST_ASSERT_EQUAL_INT(7, cJSON_GetObjectItem(object, "KEY7")->valueint);
+    TEST_ASSERT_NULL(cJSON_GetObjectItemCaseSensitive(object, "KEY7"));
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(object, "key1000"));
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(object, NULL));
+    TEST_ASSERT_TRUE(cJSON_HasObjectItem(object, "key999"));
+
+    cJSON_Delete(object);
+}
+
+static void index_should_find_the_first_of_duplicate_members(void)
+{
+    cJSON *object = cJSON_Parse("{\"a\":1,\"A\":2,\"a\":3}");
+    TEST_ASSERT_NOT_NULL(object);
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(object));
+
+    TEST_ASSERT_EQUAL_INT(1, cJSON_GetObjectItem(object, "A")->valueint);
+    TEST_ASSERT_EQUAL_INT(2, cJSON_GetObjectItemCaseSensitive(object, "A")->valueint);
+
+    cJSON_DeleteItemFromObject(object, "a");
+    TEST_ASSERT_EQUAL_INT(2, cJSON_GetObjectItem(object, "a")->valueint);
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetObjectItemCaseSensitive(object, "a")->valueint);
+
+    cJSON_Delete(object);
+}
+
+static void index_should_follow_changes(void)
+{
+    cJSON *object = create_object(10);
+    char name[32];
+    int i = 0;
+
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(object));
+
+    /* grow beyond the initial size */
+    for (i = 10; i < 100; i++)
+    {
+        sprintf(name, "key%d", i);
+        cJSON_AddItemToObject(object, name, cJSON_CreateNumber(i));
+        assert_lookup(object, name, i);
+    }
+
+    /* detach */
+    for (i = 0; i < 100; i += 2)
+    {
+        sprintf(name, "key%d", i);
+        cJSON_DeleteItemFromObject(object, name);
+        TEST_ASSERT_NULL(cJSON_GetObjectItem(object, name));
+    }
+    cJSON_Delete(cJSON_DetachItemFromArray(object, 0));
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(object, "key1"));
+
+    /* reuses the released entries */
+    cJSON_AddItemToObject(object, "new", cJSON_CreateNumber(-1));
+    assert_lookup(object, "new", -1);
+
+    /* replace */
+    cJSON_ReplaceItemInObject(object, "KEY3", cJSON_CreateNumber(-3));
+    assert_lookup(object, "KEY3", -3);
+    TEST_ASSERT_NULL(cJSON_GetObjectItemCaseSensitive(object, "key3"));
+    cJSON_ReplaceItemInArray(object, 0, cJSON_CreateNumber(-4));
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(object, "key3"));
+
+    /* insert */
+    cJSON_InsertItemInArray(object, 0, cJSON_CreateNumber(-5));
+    object->child->string = (char*)cJSON_strdup((const unsigned char*)"inserted", &global_hooks);
+    assert_lookup(object, "inserted", -5);
+
+    for (i = 5; i < 100; i += 2)
+    {
+        sprintf(name, "key%d", i);
+        assert_lookup(object, name, i);
+    }
+    TEST_ASSERT_EQUAL_INT(51, cJSON_GetArraySize(object));
+
+    cJSON_Delete(object);
+}
+
+static void index_should_not_be_shared_with_references(void)
+{
+    cJSON *object = create_object(5);
+    cJSON *container = cJSON_CreateObject();
+
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(object));
+    cJSON_AddItemReferenceToObject(container, "reference", object);
+    TEST_ASSERT_NULL(get_index(container->child));
+    TEST_ASSERT_NULL(container->child->valuestring);
+    assert_lookup(container->child, "key4", 4);
+
+    cJSON_Delete(container);
+    assert_lookup(object, "key4", 4);
+    cJSON_Delete(object);
+}
+
+static void index_should_not_be_copied(void)
+{
+    cJSON *object = create_object(5);
+    cJSON *copy = NULL;
+
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(object));
+    TEST_ASSERT_TRUE(object->type & cJSON_IsIndexed);
+    TEST_ASSERT_TRUE(cJSON_IsObject(object));
+
+    copy = cJSON_Duplicate(object, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_FALSE(copy->type & cJSON_IsIndexed);
+    TEST_ASSERT_NULL(copy->valuestring);
+    assert_lookup(copy, "key3", 3);
+    TEST_ASSERT_TRUE(cJSON_Compare(object, copy, true));
+
+    cJSON_Delete(copy);
+    cJSON_Delete(object);
+}
+
+static void assert_array_items(const cJSON *array, const int *expected, int count)
+{
+    cJSON *item = NULL;
+    int i = 0;
+
+    TEST_ASSERT_EQUAL_INT(count, cJSON_GetArraySize(array));
+    for (i = 0, item = array->child; i < count; i++, item = item->next)
+    {
+        TEST_ASSERT_TRUE(cJSON_GetArrayItem(array, i) == item);
+        TEST_ASSERT_EQUAL_INT(expected[i], item->valueint);
+    }
+    TEST_ASSERT_NULL(item);
+    TEST_ASSERT_NULL(cJSON_GetArrayItem(array, count));
+}
+
+static void index_should_index_arrays(void)
+{
+    cJSON *array = cJSON_Parse("[0,1,2,3,4,5,6,7,8,9]");
+    int i = 0;
+
+    TEST_ASSERT_NOT_NULL(array);
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(array));
+    TEST_ASSERT_NOT_NULL(get_index(array)->items);
+
+    /* grow beyond the initial size */
+    for (i = 10; i < 1000; i++)
+    {
+        cJSON_AddItemToArray(array, cJSON_CreateNumber(i));
+    }
+    TEST_ASSERT_EQUAL_INT(1000, cJSON_GetArraySize(array));
+    for (i = 0; i < 1000; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(i, cJSON_GetArrayItem(array, i)->valueint);
+    }
+    /* negative indices return the first item, like they always did */
+    TEST_ASSERT_TRUE(cJSON_GetArrayItem(array, -1) == array->child);
+
+    cJSON_Delete(array);
+}
+
+static void index_should_follow_array_changes(void)
+{
+    cJSON *array = cJSON_Parse("[0,1,2,3,4]");
+    const int after_insert[] = { -1, 0, 1, -2, 2, 3, 4, -3 };
+    const int after_detach[] = { 0, 1, 2, 3, 4 };
+    const int after_replace[] = { 10, 1, 12, 3, 4 };
+    cJSON *rest = NULL;
+
+    TEST_ASSERT_NOT_NULL(array);
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(array));
+
+    cJSON_InsertItemInArray(array, 0, cJSON_CreateNumber(-1));
+    cJSON_InsertItemInArray(array, 3, cJSON_CreateNumber(-2));
+    cJSON_InsertItemInArray(array, 100, cJSON_CreateNumber(-3));
+    assert_array_items(array, after_insert, 8);
+
+    cJSON_DeleteItemFromArray(array, 7);
+    cJSON_DeleteItemFromArray(array, 3);
+    cJSON_DeleteItemFromArray(array, 0);
+    cJSON_DeleteItemFromArray(array, 100);
+    assert_array_items(array, after_detach, 5);
+
+    cJSON_ReplaceItemInArray(array, 0, cJSON_CreateNumber(10));
+    cJSON_ReplaceItemInArray(array, 2, cJSON_CreateNumber(12));
+    assert_array_items(array, after_replace, 5);
+
+    /* changed behind the back of the index */
+    rest = array->child->next->next->next;
+    rest->prev->next = NULL;
+    array->child->prev = rest->prev;
+    rest->prev = NULL;
+    cJSON_Delete(rest);
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(array));
+    assert_array_items(array, after_replace, 3);
+
+    cJSON_Delete(array);
+}
+
+static void index_should_find_members_by_hash(void)
+{
+    cJSON *object = create_object(100);
+    const char name[] = "key42 and more";
+    int pass = 0;
+
+    TEST_ASSERT_EQUAL_UINT(cJSON_HashName("KEY42"), cJSON_HashName("key42"));
+    for (pass = 0; pass < 2; pass++)
+    {
+        TEST_ASSERT_EQUAL_INT(42, cJSON_GetObjectItemWithHash(object, name, 5, cJSON_HashName("key42"))->valueint);
+        TEST_ASSERT_EQUAL_INT(4, cJSON_GetObjectItemWithHash(object, name, 4, cJSON_HashName("key4"))->valueint);
+        TEST_ASSERT_NULL(cJSON_GetObjectItemWithHash(object, "KEY42", 5, cJSON_HashName("KEY42")));
+        TEST_ASSERT_NULL(cJSON_GetObjectItemWithHash(object, name, 3, cJSON_HashName("key")));
+        TEST_ASSERT_NULL(cJSON_GetObjectItemWithHash(NULL, name, 5, 0));
+        TEST_ASSERT_NULL(cJSON_GetObjectItemWithHash(object, NULL, 5, 0));
+        TEST_ASSERT_TRUE(cJSON_BuildIndex(object));
+    }
+
+    cJSON_Delete(object);
+}
+
+static void index_should_only_be_built_for_arrays_and_objects(void)
+{
+    cJSON *string = cJSON_CreateString("string");
+    cJSON *object = create_object(3);
+
+    TEST_ASSERT_FALSE(cJSON_BuildIndex(NULL));
+    TEST_ASSERT_FALSE(cJSON_BuildIndex(string));
+    TEST_ASSERT_NULL(get_index(string));
+
+    /* rebuilding and deleting */
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(object));
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(object));
+    cJSON_DeleteIndex(object);
+    TEST_ASSERT_NULL(get_index(object));
+    cJSON_DeleteIndex(object);
+    assert_lookup(object, "key2", 2);
+
+    cJSON_Delete(string);
+    cJSON_Delete(object);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(index_should_find_members);
+    RUN_TEST(index_should_find_the_first_of_duplicate_members);
+    RUN_TEST(index_should_follow_changes);
+    RUN_TEST(index_should_not_be_shared_with_references);
+    RUN_TEST(index_should_not_be_copied);
+    RUN_TEST(index_should_index_arrays);
+    RUN_TEST(index_should_follow_array_changes);
+    RUN_TEST(index_should_find_members_by_hash);
+    RUN_TEST(index_should_only_be_built_for_arrays_and_objects);
+
+    return UNITY_END();
+}
@@ -0,0 +1,127 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static void key_table_should_share_names(void)
+{
+    const char json[] = "[{\"id\":1,\"name\":\"a\"},{\"name\":\"b\",\"id\":2},{\"na\\u006de\":\"c\",\"id\":3,\"more\":{\"id\":4}}]";
+    cJSON_KeyTable *table = cJSON_CreateKeyTable();
+    cJSON *first = NULL;
+    cJSON *records = NULL;
+    cJSON *record = NULL;
+
+    TEST_ASSERT_NOT_NULL(table);
+    records = cJSON_ParseWithKeyTable(table, json, sizeof(json) - 1, NULL, true);
+    TEST_ASSERT_NOT_NULL(records);
+    TEST_ASSERT_EQUAL_UINT(3, (unsigned int)cJSON_GetKeyTableCount(table));
+
+    first = cJSON_GetArrayItem(records, 0);
+    cJSON_ArrayForEach(record, records)
+    {
+        cJSON *name = cJSON_GetObjectItemCaseSensitive(record, "name");
+        TEST_ASSERT_BITS_HIGH(cJSON_StringIsConst, name->type);
+        TEST_ASSERT_TRUE(cJSON_IsString(name));
+        TEST_ASSERT_TRUE(name->string == cJSON_GetObjectItemCaseSensitive(first, "name")->string);
+        TEST_ASSERT_TRUE(cJSON_GetObjectItemCaseSensitive(record, "id")->string == cJSON_GetObjectItemCaseSensitive(first, "id")->string);
+    }
+    TEST_ASSERT_TRUE(cJSON_IsObject(cJSON_GetObjectItem(cJSON_GetArrayItem(records, 2), "more")));
+    TEST_ASSERT_EQUAL_DOUBLE(4, cJSON_GetObjectItem(cJSON_GetObjectItem(cJSON_GetArrayItem(records, 2), "more"), "id")->valuedouble);
+
+    cJSON_Delete(records);
+
+    /* the table can be reused by later parses */
+    records = cJSON_ParseWithKeyTable(table, "{\"id\":5,\"other\":null}", 22, NULL, true);
+    TEST_ASSERT_NOT_NULL(records);
+    TEST_ASSERT_EQUAL_UINT(4, (unsigned int)cJSON_GetKeyTableCount(table));
+    TEST_ASSERT_TRUE(cJSON_IsNull(cJSON_GetObjectItem(records, "other")));
+    cJSON_Delete(records);
+
+    cJSON_DeleteKeyTable(table);
+}
+
+static void key_table_should_grow(void)
+{
+    cJSON_KeyTable *table = cJSON_CreateKeyTable();
+    cJSON *object = cJSON_CreateObject();
+    cJSON *parsed = NULL;
+    char *printed = NULL;
+    char name[16];
+    int i = 0;
+
+    for (i = 0; i < 1000; i++)
+    {
+        sprintf(name, "key%d", i);
+        cJSON_AddNumberToObject(object, name, i);
+    }
+    printed = cJSON_PrintUnformatted(object);
+    TEST_ASSERT_NOT_NULL(printed);
+
+    parsed = cJSON_ParseWithKeyTable(table, printed, strlen(printed), NULL, true);
+    TEST_ASSERT_NOT_NULL(parsed);
+    TEST_ASSERT_EQUAL_UINT(1000, (unsigned int)cJSON_GetKeyTableCount(table));
+    TEST_ASSERT_EQUAL_DOUBLE(999, cJSON_GetObjectItemCaseSensitive(parsed, "key999")->valuedouble);
+    cJSON_Delete(parsed);
+
+    /* a second parse doesn't add anything */
+    parsed = cJSON_ParseWithKeyTable(table, printed, strlen(printed), NULL, true);
+    TEST_ASSERT_EQUAL_UINT(1000, (unsigned int)cJSON_GetKeyTableCount(table));
+    cJSON_Delete(parsed);
+
+    free(printed);
+    cJSON_Delete(object);
+    cJSON_DeleteKeyTable(table);
+}
+
+static void key_table_should_handle_errors(void)
+{
+    cJSON_KeyTable *table = cJSON_CreateKeyTable();
+    const char *end = NULL;
+
+    TEST_ASSERT_NULL(cJSON_ParseWithKeyTable(NULL, "{}", 2, NULL, false));
+    TEST_ASSERT_NULL(cJSON_ParseWithKeyTable(table, "{\"a\":[1,{\"b\":x}]}", 17, &end, false));
+    TEST_ASSERT_EQUAL_INT('x', *end);
+    TEST_ASSERT_NULL(cJSON_ParseWithKeyTable(table, "{\"a\\q\":1}", 9, NULL, false));
+    TEST_ASSERT_NULL(cJSON_ParseWithKeyTable(table, "{\"a", 3, NULL, false));
+    TEST_ASSERT_EQUAL_UINT(2, (unsigned int)cJSON_GetKeyTableCount(table));
+
+    cJSON_DeleteKeyTable(table);
+    cJSON_DeleteKeyTable(NULL);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(key_table_should_share_names);
+    RUN_TEST(key_table_should_grow);
+    RUN_TEST(key_table_should_handle_errors);
+
+    return UNITY_END();
+}
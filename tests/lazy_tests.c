@@ -0,0 +1,365 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static void assert_lazy_prints_like_parse(const char * const json)
+{
+    cJSON *expected = cJSON_Parse(json);
+    cJSON *lazy = cJSON_ParseLazy(json, strlen(json));
+    char *expected_text = NULL;
+    char *lazy_text = NULL;
+
+    TEST_ASSERT_NOT_NULL_MESSAGE(expected, json);
+    TEST_ASSERT_NOT_NULL_MESSAGE(lazy, json);
+
+    expected_text = cJSON_Print(expected);
+    lazy_text = cJSON_Print(lazy);
+    TEST_ASSERT_NOT_NULL(lazy_text);
+    TEST_ASSERT_EQUAL_STRING(expected_text, lazy_text);
+
+    free(expected_text);
+    free(lazy_text);
+    cJSON_Delete(expected);
+    cJSON_Delete(lazy);
+}
+
+static void lazy_parse_should_match_the_parser(void)
+{
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5", "inputs/test7", "inputs/test8", "inputs/test9", "inputs/test10", "inputs/test11" };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        char *json = read_file(files[i]);
+        TEST_ASSERT_NOT_NULL_MESSAGE(json, files[i]);
+        assert_lazy_prints_like_parse(json);
+        free(json);
+    }
+
+    assert_lazy_prints_like_parse(" 1.5 ");
+    assert_lazy_prints_like_parse("\"]\"");
+    assert_lazy_prints_like_parse("[]");
+    assert_lazy_prints_like_parse("{ }");
+    assert_lazy_prints_like_parse("[\"[\\\"]\", {\"k}\":\"\\\\\"}, [[], {}], \"\\u00e4\"]");
+}
+
+static void lazy_parse_should_only_load_what_is_accessed(void)
+{
+    const char json[] = "{\"a\":[1,2,{\"b\":\"x\"}],\"c\":{\"d\":true}}";
+    cJSON *root = cJSON_ParseLazy(json, sizeof(json) - 1);
+    cJSON *a = NULL;
+    cJSON *c = NULL;
+    cJSON *element = NULL;
+    int count = 0;
+
+    TEST_ASSERT_NOT_NULL(root);
+    TEST_ASSERT_TRUE(cJSON_IsObject(root));
+    TEST_ASSERT_BITS_HIGH(cJSON_IsLazy, root->type);
+    TEST_ASSERT_NULL(root->child);
+
+    a = cJSON_GetObjectItem(root, "a");
+    TEST_ASSERT_BITS_LOW(cJSON_IsLazy, root->type);
+    TEST_ASSERT_NULL(root->valuestring);
+    TEST_ASSERT_TRUE(cJSON_IsArray(a));
+    TEST_ASSERT_BITS_HIGH(cJSON_IsLazy, a->type);
+
+    c = cJSON_GetObjectItemCaseSensitive(root, "c");
+    TEST_ASSERT_TRUE(cJSON_IsObject(c));
+    TEST_ASSERT_BITS_HIGH(cJSON_IsLazy, c->type);
+
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetArraySize(a));
+    TEST_ASSERT_EQUAL_DOUBLE(2, cJSON_GetArrayItem(a, 1)->valuedouble);
+    TEST_ASSERT_BITS_HIGH(cJSON_IsLazy, cJSON_GetArrayItem(a, 2)->type);
+    TEST_ASSERT_EQUAL_STRING("x", cJSON_GetObjectItem(cJSON_GetArrayItem(a, 2), "b")->valuestring);
+
+    cJSON_ArrayForEach(element, c)
+    {
+        TEST_ASSERT_TRUE(cJSON_IsTrue(element));
+        count++;
+    }
+    TEST_ASSERT_EQUAL_INT(1, count);
+
+    cJSON_Delete(root);
+}
+
+static void lazy_parse_should_report_errors_on_access(void)
+{
+    const char json[] = "{\"a\":[1,2,x],\"b\":1}";
+    cJSON *root = cJSON_ParseLazy(json, sizeof(json) - 1);
+    cJSON *a = NULL;
+
+    TEST_ASSERT_NOT_NULL(root);
+    TEST_ASSERT_EQUAL_DOUBLE(1, cJSON_GetObjectItem(root, "b")->valuedouble);
+
+    a = cJSON_GetObjectItem(root, "a");
+    TEST_ASSERT_NULL(cJSON_GetArrayItem(a, 0));
+    TEST_ASSERT_EQUAL_INT(0, cJSON_GetArraySize(a));
+    TEST_ASSERT_BITS_HIGH(cJSON_IsLazy, a->type);
+    TEST_ASSERT_NULL(a->child);
+    TEST_ASSERT_NULL(cJSON_PrintUnformatted(root));
+    TEST_ASSERT_FALSE(cJSON_LoadLazy(root));
+
+    cJSON_Delete(root);
+}
+
+static void lazy_parse_should_check_the_structure(void)
+{
+    char deep[CJSON_NESTING_LIMIT + 2];
+
+    TEST_ASSERT_NULL(cJSON_ParseLazy("{\"a\":[}", 7));
+    TEST_ASSERT_NULL(cJSON_ParseLazy("[1,2", 4));
+    TEST_ASSERT_NULL(cJSON_ParseLazy("[\"abc]", 6));
+    TEST_ASSERT_NULL(cJSON_ParseLazy("[\"\\\"]", 5));
+    TEST_ASSERT_NULL(cJSON_ParseLazy("[1]]", 4));
+    TEST_ASSERT_NULL(cJSON_ParseLazy("[1] x", 5));
+    TEST_ASSERT_NULL(cJSON_ParseLazy(NULL, 0));
+
+    /* the buffer end is respected */
+    TEST_ASSERT_NULL(cJSON_ParseLazy("[1]", 2));
+
+    memset(deep, '[', sizeof(deep) - 1);
+    deep[sizeof(deep) - 1] = '\0';
+    TEST_ASSERT_NULL(cJSON_ParseLazy(deep, sizeof(deep) - 1));
+}
+
+static void lazy_documents_should_be_changeable(void)
+{
+    const char json[] = "{\"list\":[1,[2]],\"object\":{}}";
+    cJSON *root = cJSON_ParseLazy(json, sizeof(json) - 1);
+    cJSON *copy = NULL;
+    cJSON *list = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(root);
+
+    /* a copy of a lazy item is lazy too */
+    copy = cJSON_Duplicate(root, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_BITS_HIGH(cJSON_IsLazy, copy->type);
+
+    list = cJSON_GetObjectItem(root, "list");
+    cJSON_AddItemToArray(list, cJSON_CreateNumber(3));
+    cJSON_AddItemToObject(cJSON_GetObjectItem(root, "object"), "new", cJSON_CreateTrue());
+    cJSON_DeleteItemFromArray(list, 0);
+    cJSON_AddItemReferenceToObject(root, "reference", cJSON_GetArrayItem(list, 0));
+
+    printed = cJSON_PrintUnformatted(root);
+    TEST_ASSERT_EQUAL_STRING("{\"list\":[[2],3],\"object\":{\"new\":true},\"reference\":[2]}", printed);
+    free(printed);
+
+    TEST_ASSERT_TRUE(cJSON_LoadLazy(copy));
+    printed = cJSON_PrintUnformatted(copy);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    free(printed);
+
+    cJSON_Delete(copy);
+    cJSON_Delete(root);
+}
+
+static void number_text_should_be_printed_unchanged(void)
+{
+    const char json[] = "[1.50,-0.0,12345678901234567890,1E+2,{\"id\":9007199254740993}]";
+    cJSON *item = cJSON_ParseWithNumberText(json, sizeof(json) - 1);
+    cJSON *number = NULL;
+    const char *text = NULL;
+    size_t length = 0;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(item);
+    number = cJSON_GetArrayItem(item, 0);
+    TEST_ASSERT_BITS(cJSON_IsLazy, cJSON_IsLazy, number->type);
+    TEST_ASSERT_TRUE(cJSON_IsNumber(number));
+    TEST_ASSERT_EQUAL_DOUBLE(1.5, cJSON_GetNumberValue(number));
+    /* reading doesn't convert it */
+    TEST_ASSERT_BITS(cJSON_IsLazy, cJSON_IsLazy, number->type);
+
+    text = cJSON_GetNumberText(cJSON_GetObjectItem(cJSON_GetArrayItem(item, 4), "id"), &length);
+    TEST_ASSERT_NOT_NULL(text);
+    TEST_ASSERT_EQUAL_UINT(16, (unsigned int)length);
+    TEST_ASSERT_EQUAL_INT(0, strncmp(text, "9007199254740993", length));
+
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)strlen(json), (unsigned int)cJSON_PrintedLength(item, false));
+    global_hooks.deallocate(printed);
+
+    /* canonical output converts them */
+    printed = cJSON_PrintCanonical(item);
+    TEST_ASSERT_EQUAL_STRING("[1.5,0,12345678901234567000,100,{\"id\":9007199254740992}]", printed);
+    global_hooks.deallocate(printed);
+
+    cJSON_Delete(item);
+}
+
+static void number_text_should_be_dropped_when_changed(void)
+{
+    const char json[] = "{\"a\":2.50,\"b\":[3.0]}";
+    cJSON *item = cJSON_ParseWithNumberText(json, sizeof(json) - 1);
+    cJSON *parsed = cJSON_Parse(json);
+    cJSON *copy = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_TRUE(cJSON_Compare(item, parsed, true));
+    TEST_ASSERT_TRUE(cJSON_Hash(item) == cJSON_Hash(parsed));
+    copy = cJSON_Duplicate(item, true);
+    TEST_ASSERT_NOT_NULL(cJSON_GetNumberText(cJSON_GetObjectItem(copy, "a"), NULL));
+
+    cJSON_SetNumberValue(cJSON_GetObjectItem(item, "a"), 4);
+    TEST_ASSERT_NULL(cJSON_GetNumberText(cJSON_GetObjectItem(item, "a"), NULL));
+    TEST_ASSERT_EQUAL_INT(4, cJSON_GetObjectItem(item, "a")->valueint);
+
+    /* converted in place for code that reads valuedouble itself */
+    TEST_ASSERT_TRUE(cJSON_LoadLazy(copy));
+    TEST_ASSERT_FALSE(cJSON_GetObjectItem(copy, "a")->type & cJSON_IsLazy);
+    TEST_ASSERT_EQUAL_DOUBLE(2.5, cJSON_GetObjectItem(copy, "a")->valuedouble);
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetObjectItem(copy, "b")->child->valueint);
+
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":4,\"b\":[3.0]}", printed);
+    global_hooks.deallocate(printed);
+    printed = cJSON_PrintUnformatted(copy);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":2.5,\"b\":[3]}", printed);
+    global_hooks.deallocate(printed);
+
+    cJSON_Delete(item);
+    cJSON_Delete(copy);
+    cJSON_Delete(parsed);
+}
+
+static void number_text_should_only_keep_valid_numbers(void)
+{
+    cJSON *item = cJSON_ParseWithNumberText("[-,1]", 5);
+    TEST_ASSERT_NULL(item);
+
+    /* what the strict scanner doesn't accept is converted as usual */
+    item = cJSON_ParseWithNumberText("[01]", 4);
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_NULL(cJSON_GetNumberText(item->child, NULL));
+    TEST_ASSERT_EQUAL_INT(1, item->child->valueint);
+    cJSON_Delete(item);
+
+    TEST_ASSERT_EQUAL_DOUBLE(0, cJSON_GetNumberValue(NULL));
+    item = cJSON_CreateString("1");
+    TEST_ASSERT_EQUAL_DOUBLE(0, cJSON_GetNumberValue(item));
+    TEST_ASSERT_NULL(cJSON_GetNumberText(item, NULL));
+    cJSON_Delete(item);
+}
+
+static void string_text_should_be_printed_unchanged(void)
+{
+    const char json[] = "{\"ab\":\"caf\\u00e9 \\/ \\\"x\\\"\",\"b\":[\"plain\",\"\"]}";
+    cJSON *item = cJSON_ParseWithStringText(json, sizeof(json) - 1);
+    cJSON *string = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(item);
+    string = cJSON_GetObjectItem(item, "ab");
+    TEST_ASSERT_NOT_NULL(string);
+    TEST_ASSERT_BITS(cJSON_IsLazy, cJSON_IsLazy, string->type);
+    TEST_ASSERT_TRUE(cJSON_IsString(string));
+
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)strlen(json), (unsigned int)cJSON_PrintedLength(item, false));
+    global_hooks.deallocate(printed);
+
+    /* canonical output unescapes them */
+    printed = cJSON_PrintCanonical(item);
+    TEST_ASSERT_EQUAL_STRING("{\"ab\":\"caf\xC3\xA9 / \\\"x\\\"\",\"b\":[\"plain\",\"\"]}", printed);
+    global_hooks.deallocate(printed);
+
+    TEST_ASSERT_EQUAL_STRING("caf\xC3\xA9 / \"x\"", cJSON_GetStringValue(string));
+    TEST_ASSERT_FALSE(string->type & cJSON_IsLazy);
+    TEST_ASSERT_EQUAL_STRING("", cJSON_GetStringValue(cJSON_GetArrayItem(cJSON_GetObjectItem(item, "b"), 1)));
+
+    cJSON_Delete(item);
+}
+
+static void string_text_should_be_compared_and_loaded(void)
+{
+    const char json[] = "[\"\\u0041\",\"a\\nb\"]";
+    cJSON *item = cJSON_ParseWithStringText(json, sizeof(json) - 1);
+    cJSON *parsed = cJSON_Parse("[\"A\",\"a\\u000ab\"]");
+    cJSON *copy = cJSON_Duplicate(item, true);
+
+    TEST_ASSERT_BITS(cJSON_IsLazy, cJSON_IsLazy, copy->child->next->type);
+    TEST_ASSERT_TRUE(cJSON_LoadLazy(copy));
+    TEST_ASSERT_EQUAL_STRING("a\nb", copy->child->next->valuestring);
+
+    TEST_ASSERT_TRUE(cJSON_Compare(item, parsed, true));
+    TEST_ASSERT_TRUE(cJSON_Hash(copy) == cJSON_Hash(parsed));
+
+    cJSON_Delete(item);
+    cJSON_Delete(copy);
+    cJSON_Delete(parsed);
+}
+
+static void string_text_should_check_escape_sequences(void)
+{
+    const char *invalid[] = { "[\"\\x\"]", "[\"\\u12\"]", "[\"\\udc00\"]", "[\"abc", "[\"\\" };
+    cJSON_ParseError error;
+    cJSON *item = NULL;
+    size_t i = 0;
+
+    /* names are unescaped as usual */
+    item = cJSON_ParseWithStringText("{\"a\\u0062\":1}", 13);
+    TEST_ASSERT_NOT_NULL(cJSON_GetObjectItem(item, "ab"));
+    TEST_ASSERT_NULL(cJSON_GetStringValue(item->child));
+    cJSON_Delete(item);
+
+    for (i = 0; i < (sizeof(invalid) / sizeof(invalid[0])); i++)
+    {
+        TEST_ASSERT_NULL_MESSAGE(cJSON_ParseWithStringText(invalid[i], strlen(invalid[i])), invalid[i]);
+        /* at the same position as the regular parser */
+        TEST_ASSERT_NULL(cJSON_ParseWithError(invalid[i], NULL, false, &error));
+        TEST_ASSERT_EQUAL_PTR(invalid[i] + error.position, cJSON_GetErrorPtr());
+    }
+
+    TEST_ASSERT_NULL(cJSON_GetStringValue(NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(lazy_parse_should_match_the_parser);
+    RUN_TEST(lazy_parse_should_only_load_what_is_accessed);
+    RUN_TEST(lazy_parse_should_report_errors_on_access);
+    RUN_TEST(lazy_parse_should_check_the_structure);
+    RUN_TEST(lazy_documents_should_be_changeable);
+    RUN_TEST(number_text_should_be_printed_unchanged);
+    RUN_TEST(number_text_should_be_dropped_when_changed);
+    RUN_TEST(number_text_should_only_keep_valid_numbers);
+    RUN_TEST(string_text_should_be_printed_unchanged);
+    RUN_TEST(string_text_should_be_compared_and_loaded);
+    RUN_TEST(string_text_should_check_escape_sequences);
+
+    return UNITY_END();
+}
@@ -0,0 +1,337 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static void assert_minified(const char * const input, const char * const expected)
+{
+    size_t length = strlen(input);
+    char *buffer = (char*)malloc(length + 1);
+
+    TEST_ASSERT_NOT_NULL(buffer);
+    memcpy(buffer, input, length + 1);
+    cJSON_Minify(buffer);
+    TEST_ASSERT_EQUAL_STRING(expected, buffer);
+
+    free(buffer);
+}
+
+static void minify_should_remove_whitespace(void)
+{
+    assert_minified("", "");
+    assert_minified(" \t\r\n", "");
+    assert_minified("{ \"a\" : [ 1 , 2 ] }\n", "{\"a\":[1,2]}");
+    /* long runs and long values are handled in blocks */
+    assert_minified("{\n                                \"a_rather_long_name_for_a_key\":\n\n\n\n\t\t\t\t\t\t\t\t\t\t\t\t12345678901234567890\n}",
+            "{\"a_rather_long_name_for_a_key\":12345678901234567890}");
+    /* other control characters are not whitespace for cJSON_Minify */
+    assert_minified("[1,\f2]", "[1,\f2]");
+}
+
+static void minify_should_keep_strings(void)
+{
+    assert_minified("[ \"a b\" , \"\\\" c \" ]", "[\"a b\",\"\\\" c \"]");
+    assert_minified("\"\\\\\" \"x\"", "\"\\\\\"\"x\"");
+    assert_minified("\"// not a comment, /* nor this */ and a very long string with spaces\"",
+            "\"// not a comment, /* nor this */ and a very long string with spaces\"");
+    /* unterminated strings are kept as they are */
+    assert_minified("[ \"abc ", "[\"abc ");
+    assert_minified("[ \"abc\\", "[\"abc\\");
+}
+
+static void minify_should_remove_comments(void)
+{
+    assert_minified("[1, // one\n 2]", "[1,2]");
+    assert_minified("[1, /* one\n two */ 2]", "[1,2]");
+    assert_minified("[1] // the end", "[1]");
+    assert_minified("[1] /* unterminated", "[1]");
+    assert_minified("[1] /*", "[1]");
+    assert_minified("[1] /", "[1]/");
+    assert_minified("1 / 2", "1/2");
+    assert_minified("{ \"key\" : \"value\" , \"k2\"  :  [ 1 , 2 , 3 ] , /* comment */ \"k3\" : 4 // x\n }   ",
+            "{\"key\":\"value\",\"k2\":[1,2,3],\"k3\":4}");
+}
+
+typedef struct
+{
+    char *data;
+    size_t length;
+    size_t size;
+    size_t calls;
+    size_t fail_after;
+} collected_output;
+
+static cJSON_bool collect(const char *data, size_t length, void *context)
+{
+    collected_output *output = (collected_output*)context;
+
+    output->calls++;
+    if ((output->fail_after != 0) && (output->calls > output->fail_after))
+    {
+        return false;
+    }
+    TEST_ASSERT_TRUE(length > 0);
+    TEST_ASSERT_TRUE(length <= 4096);
+    TEST_ASSERT_TRUE((output->length + length) < output->size);
+    memcpy(output->data + output->length, data, length);
+    output->length += length;
+    output->data[output->length] = '\0';
+
+    return true;
+}
+
+/* the streaming minifier has to give the same result as cJSON_Minify for every chunk size */
+static void assert_streamed(const char * const input)
+{
+    size_t length = strlen(input);
+    char *expected = (char*)malloc(length + 1);
+    collected_output output;
+    cJSON_Minifier *minifier = NULL;
+    size_t chunk = 0;
+    size_t position = 0;
+
+    TEST_ASSERT_NOT_NULL(expected);
+    memcpy(expected, input, length + 1);
+    cJSON_Minify(expected);
+
+    memset(&output, 0, sizeof(output));
+    output.size = length + 2;
+    output.data = (char*)malloc(output.size);
+    TEST_ASSERT_NOT_NULL(output.data);
+    minifier = cJSON_CreateMinifier(collect, &output);
+    TEST_ASSERT_NOT_NULL(minifier);
+
+    for (chunk = 1; chunk <= 17; chunk += 4)
+    {
+        output.length = 0;
+        output.data[0] = '\0';
+        for (position = 0; position < length; position += chunk)
+        {
+            TEST_ASSERT_TRUE(cJSON_MinifierFeed(minifier, input + position, ((length - position) < chunk) ? (length - position) : chunk));
+        }
+        TEST_ASSERT_TRUE(cJSON_MinifierFinish(minifier));
+        TEST_ASSERT_EQUAL_STRING(expected, output.data);
+    }
+
+    /* all at once */
+    output.length = 0;
+    output.data[0] = '\0';
+    TEST_ASSERT_TRUE(cJSON_MinifierFeed(minifier, input, length));
+    TEST_ASSERT_TRUE(cJSON_MinifierFinish(minifier));
+    TEST_ASSERT_EQUAL_STRING(expected, output.data);
+
+    cJSON_DeleteMinifier(minifier);
+    free(output.data);
+    free(expected);
+}
+
+static void minifier_should_minify_chunks(void)
+{
+    assert_streamed("");
+    assert_streamed("{ \"a\" : [ 1 , 2 ] }\n");
+    assert_streamed("[ \"a b\" , \"\\\" c \\\\\" , \"// /* */\" ]");
+    assert_streamed("[1, // one\n 2, /* two ** / */ 3 /**/ ] / 4 /");
+    assert_streamed("{\n                                \"a_rather_long_name_for_a_key\":\n\n\n\n\t\t\t\t\t\t\t\t12345678901234567890\n}");
+}
+
+static void minifier_should_minify_large_input(void)
+{
+    cJSON *item = NULL;
+    char *printed = NULL;
+    size_t i = 0;
+
+    item = cJSON_CreateArray();
+    TEST_ASSERT_NOT_NULL(item);
+    for (i = 0; i < 2000; i++)
+    {
+        cJSON *object = cJSON_CreateObject();
+        cJSON_AddItemToObject(object, "index", cJSON_CreateNumber((double)i));
+        cJSON_AddItemToObject(object, "text", cJSON_CreateString("some \"quoted\" text"));
+        cJSON_AddItemToArray(item, object);
+    }
+    printed = cJSON_Print(item);
+    TEST_ASSERT_NOT_NULL(printed);
+    assert_streamed(printed);
+
+    free(printed);
+    cJSON_Delete(item);
+}
+
+/* the formatter has to give the layout of cJSON_Print for every chunk size */
+static void assert_formatted(const char * const input)
+{
+    size_t length = strlen(input);
+    char *minified = (char*)malloc(length + 1);
+    cJSON *item = NULL;
+    char *expected = NULL;
+    collected_output output;
+    cJSON_Minifier *formatter = NULL;
+    size_t chunk = 0;
+    size_t position = 0;
+
+    /* cJSON_Parse doesn't take comments */
+    TEST_ASSERT_NOT_NULL(minified);
+    memcpy(minified, input, length + 1);
+    cJSON_Minify(minified);
+    item = cJSON_Parse(minified);
+    TEST_ASSERT_NOT_NULL(item);
+    expected = cJSON_Print(item);
+    TEST_ASSERT_NOT_NULL(expected);
+
+    memset(&output, 0, sizeof(output));
+    output.size = strlen(expected) + 2;
+    output.data = (char*)malloc(output.size);
+    TEST_ASSERT_NOT_NULL(output.data);
+    formatter = cJSON_CreateFormatter(collect, &output);
+    TEST_ASSERT_NOT_NULL(formatter);
+
+    for (chunk = 1; chunk <= 4001; chunk += 400)
+    {
+        output.length = 0;
+        output.data[0] = '\0';
+        for (position = 0; position < length; position += chunk)
+        {
+            TEST_ASSERT_TRUE(cJSON_MinifierFeed(formatter, input + position, ((length - position) < chunk) ? (length - position) : chunk));
+        }
+        TEST_ASSERT_TRUE(cJSON_MinifierFinish(formatter));
+        TEST_ASSERT_EQUAL_STRING(expected, output.data);
+    }
+
+    cJSON_DeleteMinifier(formatter);
+    free(output.data);
+    free(expected);
+    free(minified);
+    cJSON_Delete(item);
+}
+
+static void formatter_should_lay_out_like_print(void)
+{
+    const int numbers[] = {1, 2};
+    cJSON *item = NULL;
+    char *printed = NULL;
+    size_t i = 0;
+
+    assert_formatted("{}");
+    assert_formatted("[]");
+    assert_formatted("\"a \\\" /* b */\"");
+    assert_formatted("{\"a\":1,\"b\":[1,{\"c\":{}},[],[[]],{\"d\":[{}]}],\"e\":{\"f\":\"x\\\"y\"}}");
+    assert_formatted(" [ { \"a\" : { } } , // comment\n true , /* { , } */ null ]\n");
+
+    /* formatting what is formatted already */
+    item = cJSON_CreateArray();
+    TEST_ASSERT_NOT_NULL(item);
+    for (i = 0; i < 500; i++)
+    {
+        cJSON *object = cJSON_CreateObject();
+        cJSON_AddItemToObject(object, "index", cJSON_CreateNumber((double)i));
+        cJSON_AddItemToObject(object, "list", cJSON_CreateIntArray(numbers, 2));
+        cJSON_AddItemToArray(item, object);
+    }
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_NOT_NULL(printed);
+    assert_formatted(printed);
+    free(printed);
+    printed = cJSON_Print(item);
+    TEST_ASSERT_NOT_NULL(printed);
+    assert_formatted(printed);
+
+    free(printed);
+    cJSON_Delete(item);
+}
+
+static void formatter_should_fail_on_too_deep_nesting(void)
+{
+    char input[CJSON_NESTING_LIMIT + 1];
+    char data[4 * CJSON_NESTING_LIMIT];
+    collected_output output;
+    cJSON_Minifier *formatter = NULL;
+
+    memset(input, '[', sizeof(input));
+    memset(&output, 0, sizeof(output));
+    output.data = data;
+    output.size = sizeof(data);
+    formatter = cJSON_CreateFormatter(collect, &output);
+    TEST_ASSERT_NOT_NULL(formatter);
+
+    TEST_ASSERT_TRUE(cJSON_MinifierFeed(formatter, input, sizeof(input) - 1));
+    TEST_ASSERT_FALSE(cJSON_MinifierFeed(formatter, input, 1));
+    TEST_ASSERT_FALSE(cJSON_MinifierFinish(formatter));
+
+    cJSON_DeleteMinifier(formatter);
+}
+
+static void minifier_should_stop_when_the_writer_fails(void)
+{
+    char input[10000];
+    char data[10000];
+    collected_output output;
+    cJSON_Minifier *minifier = NULL;
+
+    memset(input, '1', sizeof(input));
+    memset(&output, 0, sizeof(output));
+    output.data = data;
+    output.size = sizeof(data);
+    output.fail_after = 1;
+    minifier = cJSON_CreateMinifier(collect, &output);
+    TEST_ASSERT_NOT_NULL(minifier);
+
+    TEST_ASSERT_FALSE(cJSON_MinifierFeed(minifier, input, sizeof(input)));
+    TEST_ASSERT_FALSE(cJSON_MinifierFeed(minifier, input, 1));
+    TEST_ASSERT_FALSE(cJSON_MinifierFinish(minifier));
+    TEST_ASSERT_EQUAL_UINT(2, (unsigned int)output.calls);
+
+    cJSON_DeleteMinifier(minifier);
+}
+
+static void minify_should_handle_null(void)
+{
+    cJSON_Minify(NULL);
+
+    TEST_ASSERT_NULL(cJSON_CreateMinifier(NULL, NULL));
+    TEST_ASSERT_FALSE(cJSON_MinifierFeed(NULL, "", 0));
+    TEST_ASSERT_FALSE(cJSON_MinifierFinish(NULL));
+    cJSON_DeleteMinifier(NULL);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(minify_should_remove_whitespace);
+    RUN_TEST(minify_should_keep_strings);
+    RUN_TEST(minify_should_remove_comments);
+    RUN_TEST(minifier_should_minify_chunks);
+    RUN_TEST(minifier_should_minify_large_input);
+    RUN_TEST(formatter_should_lay_out_like_print);
+    RUN_TEST(formatter_should_fail_on_too_deep_nesting);
+    RUN_TEST(minifier_should_stop_when_the_writer_fails);
+    RUN_TEST(minify_should_handle_null);
+
+    return UNITY_END();
+}
@@ -183,6 +183,1611 @@ static void typecheck_functions_should_check_type(void)
     TEST_ASSERT_TRUE(cJSON_IsRaw(item));
 }
 
+static void assert_parse_error(const char *json, int code, size_t position, size_t line, size_t column)
+{
+    cJSON_ParseError error;
+    const char *end = NULL;
+
+    memset(&error, 0xFF, sizeof(error));
+    TEST_ASSERT_NULL(cJSON_ParseWithError(json, &end, true, &error));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(code, error.code, cJSON_GetErrorMessage(error.code));
+    TEST_ASSERT_EQUAL_INT(position, error.position);
+    TEST_ASSERT_EQUAL_INT(line, error.line);
+    TEST_ASSERT_EQUAL_INT(column, error.column);
+    TEST_ASSERT_TRUE(end == (json + position));
+}
+
+static void cjson_parse_with_error_should_report_errors(void)
+{
+    assert_parse_error("", cJSON_Error_UnexpectedEnd, 0, 1, 1);
+    assert_parse_error("[1, 2", cJSON_Error_UnexpectedEnd, 5, 1, 6);
+    assert_parse_error("[1 2]", cJSON_Error_ExpectedArrayEnd, 3, 1, 4);
+    assert_parse_error("{\n\t\"a\" 1}", cJSON_Error_ExpectedColon, 7, 2, 6);
+    assert_parse_error("{1:2}", cJSON_Error_ExpectedName, 1, 1, 2);
+    assert_parse_error("{\"a\":1 \"b\":2}", cJSON_Error_ExpectedObjectEnd, 7, 1, 8);
+    assert_parse_error("[\n\n  nul]", cJSON_Error_InvalidValue, 5, 3, 3);
+    assert_parse_error("[-]", cJSON_Error_InvalidNumber, 1, 1, 2);
+    assert_parse_error("\"\\x\"", cJSON_Error_InvalidEscape, 1, 1, 2);
+    assert_parse_error("\"\\uDC00\"", cJSON_Error_InvalidUnicode, 1, 1, 2);
+    assert_parse_error("\"abc", cJSON_Error_UnexpectedEnd, 4, 1, 5);
+    assert_parse_error("[] []", cJSON_Error_TrailingCharacters, 3, 1, 4);
+}
+
+static void cjson_parse_with_error_should_not_touch_global_error(void)
+{
+    cJSON_ParseError error;
+    cJSON *item = NULL;
+
+    /* set the global error pointer */
+    TEST_ASSERT_NULL(cJSON_Parse("[1,"));
+    TEST_ASSERT_NOT_NULL(cJSON_GetErrorPtr());
+
+    TEST_ASSERT_NULL(cJSON_ParseWithError("{", NULL, false, &error));
+    TEST_ASSERT_EQUAL_STRING("", cJSON_GetErrorPtr());
+
+    item = cJSON_ParseWithError("[true]", NULL, false, &error);
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_None, error.code);
+    TEST_ASSERT_EQUAL_STRING("", cJSON_GetErrorPtr());
+    cJSON_Delete(item);
+
+    /* error struct is optional */
+    TEST_ASSERT_NULL(cJSON_ParseWithError("{", NULL, false, NULL));
+    TEST_ASSERT_NULL(cJSON_ParseWithError(NULL, NULL, false, &error));
+}
+
+static void assert_limit_exceeded(const char *json, const cJSON_ParseLimits *limits, int code)
+{
+    cJSON_ParseError error;
+
+    memset(&error, 0xFF, sizeof(error));
+    TEST_ASSERT_NULL(cJSON_ParseWithLimits(json, strlen(json), limits, &error));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(code, error.code, cJSON_GetErrorMessage(error.code));
+}
+
+static void assert_within_limits(const char *json, const cJSON_ParseLimits *limits)
+{
+    cJSON *item = cJSON_ParseWithLimits(json, strlen(json), limits, NULL);
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(item);
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    free(printed);
+    cJSON_Delete(item);
+}
+
+static void cjson_parse_with_limits_should_stop_at_the_limits(void)
+{
+    const char *document = "{\"name\":\"a string that doesn't fit into a node\",\"list\":[1,2,3]}";
+    cJSON_ParseLimits limits;
+    cJSON *item = NULL;
+    cJSON_ParseError error;
+
+    memset(&limits, '\0', sizeof(limits));
+    assert_within_limits(document, &limits);
+    assert_within_limits(document, NULL);
+    assert_limit_exceeded("[1,", NULL, cJSON_Error_UnexpectedEnd);
+
+    limits.max_nodes = 3;
+    assert_within_limits("[1,2]", &limits);
+    assert_limit_exceeded("[1,2,3]", &limits, cJSON_Error_TooManyNodes);
+    assert_within_limits("{\"a\":{\"b\":[]}}", &limits);
+    assert_limit_exceeded("{\"a\":{\"b\":[1]}}", &limits, cJSON_Error_TooManyNodes);
+    limits.max_nodes = 0;
+
+    limits.max_depth = 2;
+    assert_within_limits("[{\"a\":1},[]]", &limits);
+    assert_limit_exceeded("[[[1]]]", &limits, cJSON_Error_TooDeep);
+    assert_limit_exceeded("{\"a\":{\"b\":{}}}", &limits, cJSON_Error_TooDeep);
+    limits.max_depth = 0;
+
+    limits.max_string_length = 3;
+    assert_within_limits("{\"abc\":\"ABC\"}", &limits);
+    item = cJSON_ParseWithLimits("[\"\\u0041\\u00e9\"]", 16, &limits, NULL);
+    TEST_ASSERT_NOT_NULL(item);
+    cJSON_Delete(item);
+    assert_limit_exceeded("{\"abcd\":1}", &limits, cJSON_Error_StringTooLong);
+    assert_limit_exceeded("[\"\\u00e9\\u00e9\"]", &limits, cJSON_Error_StringTooLong);
+    limits.max_string_length = 0;
+
+    /* the smallest budget the document fits into, a byte less fails */
+    for (limits.max_bytes = 1; limits.max_bytes < 100000; limits.max_bytes++)
+    {
+        item = cJSON_ParseWithLimits(document, strlen(document), &limits, &error);
+        if (item != NULL)
+        {
+            break;
+        }
+        TEST_ASSERT_EQUAL_INT(cJSON_Error_TooManyBytes, error.code);
+    }
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_TRUE(limits.max_bytes >= (strlen("a string that doesn't fit into a node") + 1));
+    cJSON_Delete(item);
+}
+
+static cJSON *parse_unterminated(const char *json, size_t length)
+{
+    cJSON *item = NULL;
+    /* exactly sized copy without null terminator, so reading past it is detectable */
+    char *buffer = (char*)malloc(length + 1);
+    TEST_ASSERT_NOT_NULL(buffer);
+    memcpy(buffer, json, length);
+
+    item = cJSON_ParseWithLength(buffer, length);
+    free(buffer);
+
+    return item;
+}
+
+static void cjson_parse_with_length_should_stop_at_the_buffer_end(void)
+{
+    const char *end = NULL;
+    const char json[] = "[1,2]xyz";
+    cJSON *item = NULL;
+
+    item = parse_unterminated("{\"a\":[true,null,\"b\"]}", 21);
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_TRUE(cJSON_IsArray(cJSON_GetObjectItem(item, "a")));
+    cJSON_Delete(item);
+
+    item = parse_unterminated("123.5", 5);
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_EQUAL_DOUBLE(123.5, item->valuedouble);
+    cJSON_Delete(item);
+
+    /* the number ends with the buffer */
+    item = parse_unterminated("1234", 2);
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_EQUAL_INT(12, item->valueint);
+    cJSON_Delete(item);
+
+    /* truncated input */
+    TEST_ASSERT_NULL(parse_unterminated("[1,2]", 4));
+    TEST_ASSERT_NULL(parse_unterminated("\"abc\"", 4));
+    TEST_ASSERT_NULL(parse_unterminated("\"\\u0041\"", 5));
+    TEST_ASSERT_NULL(parse_unterminated("true", 3));
+    TEST_ASSERT_NULL(parse_unterminated("{\"a\"", 4));
+    TEST_ASSERT_NULL(parse_unterminated("", 0));
+
+    /* garbage behind the end of the buffer is never looked at */
+    item = cJSON_ParseWithLengthOpts(json, 5, &end, true);
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_TRUE(end == (json + 5));
+    cJSON_Delete(item);
+
+    TEST_ASSERT_NULL(cJSON_ParseWithLengthOpts(json, 6, &end, true));
+    TEST_ASSERT_TRUE(end == (json + 5));
+
+    TEST_ASSERT_NULL(cJSON_ParseWithLength(NULL, 10));
+}
+
+typedef struct
+{
+    char *data;
+    size_t length;
+    size_t writes;
+    size_t largest_write;
+    size_t fail_after;
+} collected_output;
+
+static cJSON_bool collect_output(const char *data, size_t length, void *context)
+{
+    collected_output *output = (collected_output*)context;
+
+    if ((output->fail_after != 0) && (output->writes == output->fail_after))
+    {
+        return false;
+    }
+
+    output->data = (char*)realloc(output->data, output->length + length + 1);
+    TEST_ASSERT_NOT_NULL(output->data);
+    memcpy(output->data + output->length, data, length);
+    output->length += length;
+    output->data[output->length] = '\0';
+    output->writes++;
+    if (length > output->largest_write)
+    {
+        output->largest_write = length;
+    }
+
+    return true;
+}
+
+static cJSON *create_large_document(void)
+{
+    cJSON *root = cJSON_CreateObject();
+    cJSON *array = cJSON_CreateArray();
+    char name[32];
+    int i = 0;
+
+    cJSON_AddItemToObject(root, "items", array);
+    for (i = 0; i < 2000; i++)
+    {
+        cJSON *entry = cJSON_CreateObject();
+        sprintf(name, "entry \"%d\"", i);
+        cJSON_AddItemToObject(entry, "name", cJSON_CreateString(name));
+        cJSON_AddItemToObject(entry, "value", cJSON_CreateNumber(i / 3.0));
+        cJSON_AddItemToObject(entry, "flag", cJSON_CreateBool(i % 2));
+        cJSON_AddItemToArray(array, entry);
+    }
+
+    return root;
+}
+
+static void cjson_print_to_writer_should_print_in_pieces(void)
+{
+    cJSON *document = create_large_document();
+    char *expected = NULL;
+    cJSON_bool format = false;
+
+    for (format = false; format <= true; format++)
+    {
+        collected_output output;
+        memset(&output, 0, sizeof(output));
+
+        expected = format ? cJSON_Print(document) : cJSON_PrintUnformatted(document);
+        TEST_ASSERT_TRUE(cJSON_PrintToWriter(document, format, collect_output, &output));
+        TEST_ASSERT_EQUAL_STRING(expected, output.data);
+        TEST_ASSERT_TRUE(output.writes > 1);
+        TEST_ASSERT_TRUE(output.largest_write <= CJSON_WRITER_BUFFER_SIZE);
+
+        free(expected);
+        free(output.data);
+    }
+
+    cJSON_Delete(document);
+}
+
+static void cjson_print_to_writer_should_handle_large_values(void)
+{
+    char *large = (char*)malloc(3 * CJSON_WRITER_BUFFER_SIZE);
+    cJSON *array = cJSON_CreateArray();
+    char *expected = NULL;
+    collected_output output;
+
+    TEST_ASSERT_NOT_NULL(large);
+    memset(large, 'a', 3 * CJSON_WRITER_BUFFER_SIZE - 1);
+    large[3 * CJSON_WRITER_BUFFER_SIZE - 1] = '\0';
+    cJSON_AddItemToArray(array, cJSON_CreateNumber(1));
+    cJSON_AddItemToArray(array, cJSON_CreateString(large));
+    cJSON_AddItemToArray(array, cJSON_CreateString(large));
+
+    memset(&output, 0, sizeof(output));
+    expected = cJSON_PrintUnformatted(array);
+    TEST_ASSERT_TRUE(cJSON_PrintToWriter(array, false, collect_output, &output));
+    TEST_ASSERT_EQUAL_STRING(expected, output.data);
+
+    free(expected);
+    free(output.data);
+    free(large);
+    cJSON_Delete(array);
+}
+
+static void cjson_print_to_writer_should_stop_when_the_writer_fails(void)
+{
+    cJSON *document = create_large_document();
+    collected_output output;
+
+    memset(&output, 0, sizeof(output));
+    output.fail_after = 2;
+    TEST_ASSERT_FALSE(cJSON_PrintToWriter(document, true, collect_output, &output));
+    TEST_ASSERT_EQUAL_UINT(2, output.writes);
+
+    TEST_ASSERT_FALSE(cJSON_PrintToWriter(NULL, true, collect_output, &output));
+    TEST_ASSERT_FALSE(cJSON_PrintToWriter(document, true, NULL, &output));
+
+    free(output.data);
+    cJSON_Delete(document);
+}
+
+static void cjson_print_to_file_should_print(void)
+{
+    cJSON *document = create_large_document();
+    char *expected = cJSON_Print(document);
+    char *printed = NULL;
+    FILE *file = tmpfile();
+    long length = 0;
+
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_TRUE(cJSON_PrintToFile(document, true, file));
+    TEST_ASSERT_FALSE(cJSON_PrintToFile(document, true, NULL));
+
+    length = ftell(file);
+    TEST_ASSERT_EQUAL_INT((long)strlen(expected), length);
+    printed = (char*)malloc((size_t)length + 1);
+    TEST_ASSERT_NOT_NULL(printed);
+    rewind(file);
+    TEST_ASSERT_EQUAL_UINT((size_t)length, fread(printed, 1, (size_t)length, file));
+    printed[length] = '\0';
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+
+    fclose(file);
+    free(printed);
+    free(expected);
+    cJSON_Delete(document);
+}
+
+static void cjson_printer_should_reuse_its_buffer(void)
+{
+    cJSON *document = create_large_document();
+    cJSON *small = cJSON_Parse("[1,2,3]");
+    char *expected = cJSON_Print(document);
+    cJSON_Printer *printer = cJSON_CreatePrinter(0);
+    const char *printed = NULL;
+    const char *reprinted = NULL;
+    size_t length = 0;
+
+    TEST_ASSERT_NOT_NULL(printer);
+    printed = cJSON_PrinterPrint(printer, document, true, &length);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+    TEST_ASSERT_EQUAL_UINT(strlen(expected), length);
+
+    /* once it is large enough, the buffer is neither allocated nor moved */
+    reprinted = cJSON_PrinterPrint(printer, small, false, &length);
+    TEST_ASSERT_TRUE(reprinted == printed);
+    TEST_ASSERT_EQUAL_STRING("[1,2,3]", reprinted);
+    TEST_ASSERT_EQUAL_UINT(7, length);
+    reprinted = cJSON_PrinterPrint(printer, document, true, NULL);
+    TEST_ASSERT_TRUE(reprinted == printed);
+    TEST_ASSERT_EQUAL_STRING(expected, reprinted);
+
+    TEST_ASSERT_NULL(cJSON_PrinterPrint(printer, NULL, false, NULL));
+    TEST_ASSERT_NULL(cJSON_PrinterPrint(NULL, small, false, NULL));
+    cJSON_ResetPrinter(NULL);
+    cJSON_DeletePrinter(NULL);
+
+    cJSON_DeletePrinter(printer);
+    free(expected);
+    cJSON_Delete(document);
+    cJSON_Delete(small);
+}
+
+static void cjson_printer_should_shrink_above_the_high_water_mark(void)
+{
+    cJSON *document = create_large_document();
+    cJSON *small = cJSON_Parse("{\"a\":true}");
+    char *expected = cJSON_PrintUnformatted(document);
+    cJSON_Printer *printer = cJSON_CreatePrinter(64);
+
+    TEST_ASSERT_NOT_NULL(printer);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":true}", cJSON_PrinterPrint(printer, small, false, NULL));
+    TEST_ASSERT_EQUAL_UINT(64, printer->capacity);
+
+    TEST_ASSERT_EQUAL_STRING(expected, cJSON_PrinterPrint(printer, document, false, NULL));
+    TEST_ASSERT_TRUE(printer->capacity > 64);
+
+    /* the large buffer stays until the next document or a reset */
+    cJSON_ResetPrinter(printer);
+    TEST_ASSERT_NULL(printer->buffer);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":true}", cJSON_PrinterPrint(printer, small, false, NULL));
+    TEST_ASSERT_EQUAL_UINT(64, printer->capacity);
+
+    cJSON_DeletePrinter(printer);
+    free(expected);
+    cJSON_Delete(document);
+    cJSON_Delete(small);
+}
+
+static void cjson_ndjson_writer_should_batch_records(void)
+{
+    collected_output output = { NULL, 0, 0, 0, 0 };
+    cJSON_NDJSONWriter *ndjson = cJSON_CreateNDJSONWriter(32, collect_output, &output);
+    cJSON *record = cJSON_Parse("{\"id\":1,\"tags\":[\"a\",\"b\"]}");
+    size_t length = 0;
+    int i = 0;
+
+    TEST_ASSERT_NOT_NULL(ndjson);
+    TEST_ASSERT_TRUE(cJSON_NDJSONWriterAdd(ndjson, record));
+    TEST_ASSERT_EQUAL_STRING("{\"id\":1,\"tags\":[\"a\",\"b\"]}\n", cJSON_NDJSONWriterText(ndjson, &length));
+    TEST_ASSERT_EQUAL_UINT(26, length);
+    TEST_ASSERT_EQUAL_UINT(0, output.writes);
+
+    /* the second record crosses the threshold, both are written at once */
+    cJSON_SetNumberValue(cJSON_GetObjectItem(record, "id"), 2);
+    TEST_ASSERT_TRUE(cJSON_NDJSONWriterAdd(ndjson, record));
+    TEST_ASSERT_EQUAL_UINT(1, output.writes);
+    TEST_ASSERT_EQUAL_STRING("{\"id\":1,\"tags\":[\"a\",\"b\"]}\n{\"id\":2,\"tags\":[\"a\",\"b\"]}\n", output.data);
+    TEST_ASSERT_EQUAL_STRING("", cJSON_NDJSONWriterText(ndjson, &length));
+    TEST_ASSERT_EQUAL_UINT(0, length);
+
+    /* records that are kept when the writer fails go out with the next flush */
+    output.fail_after = 1;
+    TEST_ASSERT_TRUE(cJSON_NDJSONWriterAdd(ndjson, cJSON_GetObjectItem(record, "tags")));
+    TEST_ASSERT_FALSE(cJSON_NDJSONWriterAdd(ndjson, record));
+    TEST_ASSERT_EQUAL_STRING("[\"a\",\"b\"]\n{\"id\":2,\"tags\":[\"a\",\"b\"]}\n", cJSON_NDJSONWriterText(ndjson, NULL));
+    output.fail_after = 0;
+    TEST_ASSERT_TRUE(cJSON_NDJSONWriterFlush(ndjson));
+    TEST_ASSERT_EQUAL_UINT(2, output.writes);
+    TEST_ASSERT_EQUAL_UINT(52 + 10 + 26, output.length);
+
+    TEST_ASSERT_TRUE(cJSON_NDJSONWriterFlush(ndjson));
+    TEST_ASSERT_EQUAL_UINT(2, output.writes);
+    TEST_ASSERT_FALSE(cJSON_NDJSONWriterAdd(ndjson, NULL));
+    TEST_ASSERT_FALSE(cJSON_NDJSONWriterAdd(NULL, record));
+    TEST_ASSERT_FALSE(cJSON_NDJSONWriterFlush(NULL));
+    TEST_ASSERT_NULL(cJSON_NDJSONWriterText(NULL, NULL));
+    cJSON_DeleteNDJSONWriter(NULL);
+    cJSON_DeleteNDJSONWriter(ndjson);
+
+    /* without a writer, the buffer grows until it is flushed */
+    ndjson = cJSON_CreateNDJSONWriter(0, NULL, NULL);
+    TEST_ASSERT_NOT_NULL(ndjson);
+    for (i = 0; i < 1000; i++)
+    {
+        TEST_ASSERT_TRUE(cJSON_NDJSONWriterAdd(ndjson, record));
+    }
+    cJSON_NDJSONWriterText(ndjson, &length);
+    TEST_ASSERT_EQUAL_UINT(1000 * 26, length);
+    TEST_ASSERT_TRUE(cJSON_NDJSONWriterFlush(ndjson));
+    TEST_ASSERT_EQUAL_STRING("", cJSON_NDJSONWriterText(ndjson, NULL));
+    cJSON_DeleteNDJSONWriter(ndjson);
+
+    free(output.data);
+    cJSON_Delete(record);
+}
+
+static char *join_chunks(const cJSON_Chunk * const chunks, const size_t count)
+{
+    char *joined = NULL;
+    size_t length = 0;
+    size_t i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        length += chunks[i].length;
+    }
+    joined = (char*)malloc(length + 1);
+    TEST_ASSERT_NOT_NULL(joined);
+    for (length = 0, i = 0; i < count; i++)
+    {
+        memcpy(joined + length, chunks[i].base, chunks[i].length);
+        length += chunks[i].length;
+    }
+    joined[length] = '\0';
+
+    return joined;
+}
+
+static void cjson_print_chunks_should_print_into_chunks(void)
+{
+    cJSON *document = create_large_document();
+    char *expected = cJSON_Print(document);
+    const size_t chunk_sizes[] = { 0, 1, 16, 100 };
+    cJSON_ChunkList *list = NULL;
+    const cJSON_Chunk *chunks = NULL;
+    char *joined = NULL;
+    void *first = NULL;
+    size_t count = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    for (i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++)
+    {
+        list = cJSON_CreateChunkList(chunk_sizes[i]);
+        TEST_ASSERT_NOT_NULL(list);
+
+        chunks = cJSON_PrintChunks(list, document, true, &count);
+        TEST_ASSERT_NOT_NULL(chunks);
+        TEST_ASSERT_TRUE(count > 0);
+        for (j = 0; j < count; j++)
+        {
+            TEST_ASSERT_TRUE(chunks[j].length > 0);
+            TEST_ASSERT_TRUE(chunks[j].length <= list->sizes[j]);
+            TEST_ASSERT_TRUE(list->sizes[j] >= list->chunk_size);
+        }
+        joined = join_chunks(chunks, count);
+        TEST_ASSERT_EQUAL_STRING(expected, joined);
+        free(joined);
+
+        /* the chunks are reused */
+        first = chunks[0].base;
+        chunks = cJSON_PrintChunks(list, document, true, &count);
+        TEST_ASSERT_NOT_NULL(chunks);
+        TEST_ASSERT_TRUE(chunks[0].base == first);
+        joined = join_chunks(chunks, count);
+        TEST_ASSERT_EQUAL_STRING(expected, joined);
+        free(joined);
+
+        cJSON_DeleteChunkList(list);
+    }
+
+    TEST_ASSERT_NULL(cJSON_PrintChunks(NULL, document, true, &count));
+    cJSON_DeleteChunkList(NULL);
+
+    free(expected);
+    cJSON_Delete(document);
+}
+
+static void cjson_print_chunks_should_reuse_chunks_for_smaller_documents(void)
+{
+    cJSON *document = create_large_document();
+    cJSON *small = cJSON_Parse("[\"a\",\"b\"]");
+    cJSON_ChunkList *list = cJSON_CreateChunkList(8);
+    const cJSON_Chunk *chunks = NULL;
+    char *joined = NULL;
+    size_t count = 0;
+
+    TEST_ASSERT_NOT_NULL(list);
+    TEST_ASSERT_NOT_NULL(cJSON_PrintChunks(list, document, false, &count));
+    TEST_ASSERT_TRUE(count > 2);
+
+    chunks = cJSON_PrintChunks(list, small, false, &count);
+    TEST_ASSERT_NOT_NULL(chunks);
+    joined = join_chunks(chunks, count);
+    TEST_ASSERT_EQUAL_STRING("[\"a\",\"b\"]", joined);
+    free(joined);
+
+    /* failing leaves no chunks behind */
+    cJSON_AddItemToArray(small, cJSON_CreateSlot(cJSON_Invalid));
+    TEST_ASSERT_NULL(cJSON_PrintChunks(list, small, false, &count));
+
+    cJSON_DeleteChunkList(list);
+    cJSON_Delete(document);
+    cJSON_Delete(small);
+}
+
+static void assert_printed_length(cJSON * const item)
+{
+    cJSON_bool format = false;
+
+    for (format = false; format <= true; format++)
+    {
+        /* cJSON_PrintBuffered grows its buffer, so it doesn't depend on cJSON_PrintedLength */
+        char *expected = cJSON_PrintBuffered(item, 1, format);
+        char *printed = format ? cJSON_Print(item) : cJSON_PrintUnformatted(item);
+        size_t length = cJSON_PrintedLength(item, format);
+        char *buffer = (char*)malloc(length + 1);
+
+        TEST_ASSERT_NOT_NULL(expected);
+        TEST_ASSERT_NOT_NULL(buffer);
+        TEST_ASSERT_EQUAL_UINT(strlen(expected), length);
+        TEST_ASSERT_EQUAL_STRING(expected, printed);
+
+        /* exactly enough for cJSON_PrintPreallocated */
+        TEST_ASSERT_TRUE(cJSON_PrintPreallocated(item, buffer, (int)length + 1, format));
+        TEST_ASSERT_EQUAL_STRING(expected, buffer);
+        TEST_ASSERT_FALSE(cJSON_PrintPreallocated(item, buffer, (int)length, format));
+
+        free(buffer);
+        free(printed);
+        free(expected);
+    }
+}
+
+static void cjson_printed_length_should_be_exact(void)
+{
+    cJSON *document = create_large_document();
+    cJSON *nested = cJSON_Parse("{\"a\\\"\\u0001\":[[],{},{\"b\":{\"c\":[]}}],\"\":\"\\t\\r\\n\\u001f\\u00e4\",\"n\":[0,-0.0,1e300,-123,0.1,2147483648,null,true,false]}");
+    cJSON *string = cJSON_CreateString("");
+
+    TEST_ASSERT_NOT_NULL(nested);
+    assert_printed_length(document);
+    assert_printed_length(nested);
+
+    cJSON_AddItemToObject(nested, "raw", cJSON_CreateRaw("[1, 2]"));
+    /* items without valuestring are printed as "" */
+    if (!cJSON_IsInlineString(string, string->valuestring))
+    {
+        free(string->valuestring);
+    }
+    string->valuestring = NULL;
+    cJSON_AddItemToObject(nested, "empty", string);
+    assert_printed_length(nested);
+
+    TEST_ASSERT_EQUAL_UINT(0, cJSON_PrintedLength(NULL, true));
+
+    cJSON_Delete(nested);
+    cJSON_Delete(document);
+}
+
+static void cjson_size_t_functions_should_work_like_the_int_ones(void)
+{
+    cJSON *array = cJSON_Parse("[0,1,2,3]");
+    char *printed = NULL;
+    char buffer[16];
+    size_t i = 0;
+
+    TEST_ASSERT_NOT_NULL(array);
+    TEST_ASSERT_EQUAL_UINT(4, cJSON_GetArrayLength(array));
+    TEST_ASSERT_EQUAL_UINT(0, cJSON_GetArrayLength(NULL));
+    for (i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_TRUE(cJSON_GetArrayItemAt(array, i) == cJSON_GetArrayItem(array, (int)i));
+    }
+    TEST_ASSERT_NULL(cJSON_GetArrayItemAt(array, 4));
+    TEST_ASSERT_NULL(cJSON_GetArrayItemAt(array, (size_t)-1));
+
+    printed = cJSON_PrintBufferedWithSize(array, 1, false);
+    TEST_ASSERT_EQUAL_STRING("[0,1,2,3]", printed);
+    free(printed);
+    TEST_ASSERT_TRUE(cJSON_PrintPreallocatedWithSize(array, buffer, sizeof(buffer), false));
+    TEST_ASSERT_EQUAL_STRING("[0,1,2,3]", buffer);
+    TEST_ASSERT_FALSE(cJSON_PrintPreallocatedWithSize(array, buffer, 9, false));
+
+    cJSON_Delete(array);
+}
+
+static void ensure_should_accept_sizes_beyond_int_max(void)
+{
+    unsigned char byte = 0;
+    printbuffer buffer;
+
+    if (sizeof(size_t) <= sizeof(int))
+    {
+        TEST_IGNORE_MESSAGE("size_t is not larger than int.");
+    }
+
+    /* the buffer is only pretended to be that large, nothing is written */
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.buffer = &byte;
+    buffer.length = (size_t)-1;
+    buffer.offset = (size_t)INT_MAX + 1;
+    buffer.noalloc = true;
+    TEST_ASSERT_TRUE(ensure(&buffer, (size_t)INT_MAX + 1, &global_hooks) == (&byte + buffer.offset));
+    TEST_ASSERT_NULL(ensure(&buffer, (size_t)-1, &global_hooks));
+}
+
+static char *create_nested_arrays(const size_t depth)
+{
+    char *json = (char*)malloc(2 * depth + 2);
+    TEST_ASSERT_NOT_NULL(json);
+
+    memset(json, '[', depth);
+    json[depth] = '1';
+    memset(json + depth + 1, ']', depth);
+    json[2 * depth + 1] = '\0';
+
+    return json;
+}
+
+static void cjson_parse_should_limit_the_nesting_depth(void)
+{
+    char *json = create_nested_arrays(CJSON_NESTING_LIMIT);
+    char *too_deep = create_nested_arrays(CJSON_NESTING_LIMIT + 1);
+    char *printed = NULL;
+    cJSON_ParseError error;
+    cJSON *item = NULL;
+    cJSON *copy = NULL;
+
+    item = cJSON_Parse(json);
+    TEST_ASSERT_NOT_NULL(item);
+    copy = cJSON_Duplicate(item, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    printed = cJSON_PrintUnformatted(copy);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    free(printed);
+    cJSON_Delete(copy);
+    cJSON_Delete(item);
+
+    TEST_ASSERT_NULL(cJSON_ParseWithError(too_deep, NULL, false, &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_TooDeep, error.code);
+    TEST_ASSERT_EQUAL_UINT(CJSON_NESTING_LIMIT, error.position);
+
+    free(too_deep);
+    free(json);
+}
+
+static void cjson_functions_should_not_recurse_on_deep_trees(void)
+{
+    const size_t depth = 200000;
+    cJSON *root = cJSON_CreateArray();
+    cJSON *current = root;
+    cJSON *copy = NULL;
+    char *expected = create_nested_arrays(depth + 1);
+    char *printed = NULL;
+    size_t i = 0;
+
+    /* deeper than anything the parser accepts, built by hand */
+    for (i = 0; i < depth; i++)
+    {
+        cJSON *child = cJSON_CreateArray();
+        cJSON_AddItemToArray(current, child);
+        current = child;
+    }
+    cJSON_AddItemToArray(current, cJSON_CreateNumber(1));
+
+    TEST_ASSERT_EQUAL_UINT(strlen(expected), cJSON_PrintedLength(root, false));
+    printed = cJSON_PrintUnformatted(root);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+    free(printed);
+
+    copy = cJSON_Duplicate(root, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    printed = cJSON_PrintBuffered(copy, 1, false);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+    free(printed);
+
+    cJSON_Delete(copy);
+    cJSON_Delete(root);
+    free(expected);
+}
+
+static void cjson_print_should_print_nested_objects(void)
+{
+    const char json[] = "{\"a\":{\"b\":[{},[],{\"c\":[1,{\"d\":null}]}],\"e\":{}},\"f\":[[[]]]}";
+    const char formatted[] = "{\n\t\"a\":\t{\n\t\t\"b\":\t[{\n\t\t\t}, [], {\n\t\t\t\t\"c\":\t[1, {\n\t\t\t\t\t\t\"d\":\tnull\n\t\t\t\t\t}]\n\t\t\t}],\n\t\t\"e\":\t{\n\t\t}\n\t},\n\t\"f\":\t[[[]]]\n}";
+    cJSON *item = cJSON_Parse(json);
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(item);
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    free(printed);
+    printed = cJSON_Print(item);
+    TEST_ASSERT_EQUAL_STRING(formatted, printed);
+    free(printed);
+
+    cJSON_Delete(item);
+}
+
+static void cjson_parse_in_situ_should_point_into_the_buffer(void)
+{
+    const char json[] = "{\"plain\":\"text\",\"esc\\taped\":[\"a\\nb\", \"\"], \"n\":1}";
+    char *buffer = (char*)malloc(sizeof(json));
+    cJSON *root = NULL;
+    cJSON *item = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(buffer);
+    memcpy(buffer, json, sizeof(json));
+    root = cJSON_ParseInSitu(buffer, sizeof(json) - 1);
+    TEST_ASSERT_NOT_NULL(root);
+
+    item = cJSON_GetObjectItem(root, "plain");
+    TEST_ASSERT_TRUE((item->string >= buffer) && (item->string < (buffer + sizeof(json))));
+    TEST_ASSERT_TRUE((item->valuestring >= buffer) && (item->valuestring < (buffer + sizeof(json))));
+    TEST_ASSERT_BITS_HIGH(cJSON_StringIsConst | cJSON_IsReference, item->type);
+    TEST_ASSERT_EQUAL_STRING("text", item->valuestring);
+
+    item = cJSON_GetObjectItem(root, "esc\taped");
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_BITS_HIGH(cJSON_StringIsConst, item->type);
+    TEST_ASSERT_BITS_LOW(cJSON_IsReference, item->type);
+    TEST_ASSERT_EQUAL_STRING("a\nb", cJSON_GetArrayItem(item, 0)->valuestring);
+
+    printed = cJSON_PrintUnformatted(root);
+    TEST_ASSERT_EQUAL_STRING("{\"plain\":\"text\",\"esc\\taped\":[\"a\\nb\",\"\"],\"n\":1}", printed);
+    free(printed);
+    cJSON_Delete(root);
+
+    memcpy(buffer, "[\"a\\x\"]", 7);
+    TEST_ASSERT_NULL(cJSON_ParseInSitu(buffer, 7));
+    TEST_ASSERT_NULL(cJSON_ParseInSitu(NULL, 0));
+
+    free(buffer);
+}
+
+static size_t realloc_calls = 0;
+
+static void *counting_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static void counting_free(void *pointer)
+{
+    free(pointer);
+}
+
+static void *counting_realloc(void *pointer, size_t size)
+{
+    realloc_calls++;
+    return realloc(pointer, size);
+}
+
+static void cjson_init_hooks_with_realloc_should_grow_buffers_in_place(void)
+{
+    cJSON_Hooks hooks = { counting_malloc, counting_free };
+    cJSON *item = NULL;
+    char *printed = NULL;
+
+    cJSON_InitHooksWithRealloc(&hooks, counting_realloc);
+    TEST_ASSERT_TRUE(global_hooks.reallocate == counting_realloc);
+
+    item = cJSON_Parse("[\"a fairly long string that doesn't fit\", 1, 2, 3]");
+    TEST_ASSERT_NOT_NULL(item);
+    printed = cJSON_PrintBuffered(item, 1, false);
+    TEST_ASSERT_EQUAL_STRING("[\"a fairly long string that doesn't fit\",1,2,3]", printed);
+    TEST_ASSERT_TRUE(realloc_calls > 0);
+    counting_free(printed);
+    cJSON_Delete(item);
+
+    /* custom hooks without realloc_fn don't use realloc */
+    cJSON_InitHooks(&hooks);
+    TEST_ASSERT_NULL(global_hooks.reallocate);
+
+    cJSON_InitHooks(NULL);
+    TEST_ASSERT_TRUE(global_hooks.reallocate == realloc);
+}
+
+static void cjson_delete_should_cache_nodes(void)
+{
+#ifdef CJSON_NODE_CACHE
+    cJSON *item = NULL;
+    cJSON *reused = NULL;
+    cJSON *cached = NULL;
+
+    cJSON_TrimNodeCache(0);
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned int)thread_node_cache.count);
+
+    item = cJSON_Parse("[1,[2,3],{\"a\":null}]");
+    TEST_ASSERT_NOT_NULL(item);
+    cJSON_Delete(item);
+    TEST_ASSERT_EQUAL_UINT(7, (unsigned int)thread_node_cache.count);
+
+    /* the last deleted node is handed out first and cleared */
+    cached = thread_node_cache.nodes;
+    reused = cJSON_CreateTrue();
+    TEST_ASSERT_TRUE(reused == cached);
+    TEST_ASSERT_EQUAL_UINT(6, (unsigned int)thread_node_cache.count);
+    TEST_ASSERT_NULL(reused->next);
+    TEST_ASSERT_NULL(reused->child);
+    TEST_ASSERT_EQUAL_INT(cJSON_True, reused->type);
+    cJSON_Delete(reused);
+
+    cJSON_TrimNodeCache(2);
+    TEST_ASSERT_EQUAL_UINT(2, (unsigned int)thread_node_cache.count);
+    cJSON_TrimNodeCache(0);
+    TEST_ASSERT_NULL(thread_node_cache.nodes);
+#else
+    TEST_IGNORE_MESSAGE("Compiled without the node cache.");
+#endif
+}
+
+static void cjson_reclaimer_should_free_in_steps(void)
+{
+    cJSON_Reclaimer *reclaimer = cJSON_CreateReclaimer();
+    cJSON *array = cJSON_CreateArray();
+    cJSON *object = cJSON_Parse("{\"a\":[1,2],\"b\":{\"c\":\"d\"}}");
+    cJSON *linked = cJSON_CreateArray();
+    size_t steps = 0;
+    int i = 0;
+
+    TEST_ASSERT_NOT_NULL(reclaimer);
+    TEST_ASSERT_NOT_NULL(object);
+    for (i = 0; i < 100; i++)
+    {
+        cJSON_AddItemToArray(array, cJSON_CreateNumber(i));
+    }
+    /* linked by hand, without a pointer to the last child */
+    linked->child = cJSON_CreateNull();
+    linked->child->next = cJSON_CreateString("string");
+
+    TEST_ASSERT_FALSE(cJSON_Reclaim(reclaimer, 10));
+    cJSON_DeleteDeferred(reclaimer, array);
+    cJSON_DeleteDeferred(reclaimer, object);
+    cJSON_DeleteDeferred(reclaimer, linked);
+    cJSON_DeleteDeferred(reclaimer, NULL);
+
+    /* 101 + 6 + 3 items, the last step frees what is left */
+    while (cJSON_Reclaim(reclaimer, 10))
+    {
+        steps++;
+    }
+    TEST_ASSERT_EQUAL_UINT(10, (unsigned int)steps);
+    TEST_ASSERT_NULL(reclaimer->pending);
+
+    /* what is left goes with the reclaimer */
+    cJSON_DeleteDeferred(reclaimer, cJSON_Parse("[[[1]],{\"a\":[]}]"));
+    TEST_ASSERT_TRUE(cJSON_Reclaim(reclaimer, 2));
+    cJSON_DeleteReclaimer(reclaimer);
+
+    cJSON_DeleteDeferred(NULL, cJSON_CreateObject());
+    TEST_ASSERT_FALSE(cJSON_Reclaim(NULL, 1));
+    cJSON_DeleteReclaimer(NULL);
+}
+
+static void cjson_should_store_string_lengths(void)
+{
+    cJSON *object = cJSON_Parse("{\"key\":\"a\\nb\",\"keys\":\"\\u00e9\",\"\":\"\"}");
+    cJSON *copy = NULL;
+    cJSON *item = NULL;
+    char *printed = NULL;
+    char *old = NULL;
+
+    /* the fields of 1.x keep their offsets */
+    TEST_ASSERT_TRUE(offsetof(cJSON, valuestring_length) > offsetof(cJSON, string));
+    TEST_ASSERT_TRUE(offsetof(cJSON, string_length) > offsetof(cJSON, string));
+
+    TEST_ASSERT_NOT_NULL(object);
+    item = cJSON_GetObjectItemCaseSensitive(object, "key");
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_EQUAL_UINT(3, item->valuestring_length);
+    TEST_ASSERT_EQUAL_UINT(3, item->string_length);
+    TEST_ASSERT_EQUAL_UINT(2, (unsigned int)cJSON_GetStringLength(cJSON_GetObjectItem(object, "KEYS")));
+    TEST_ASSERT_EQUAL_UINT(4, (unsigned int)cJSON_GetNameLength(cJSON_GetObjectItem(object, "KEYS")));
+    TEST_ASSERT_NOT_NULL(cJSON_GetObjectItemCaseSensitive(object, ""));
+    TEST_ASSERT_NULL(cJSON_GetObjectItemCaseSensitive(object, "ke"));
+
+    /* copies keep the lengths */
+    copy = cJSON_Duplicate(object, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_EQUAL_UINT(3, cJSON_GetObjectItem(copy, "key")->valuestring_length);
+    TEST_ASSERT_TRUE(cJSON_Compare(object, copy, true));
+
+    /* the stored lengths don't count for strings assigned by hand */
+    old = item->valuestring;
+    item->valuestring = (char*)cJSON_strdup((const unsigned char*)"longer", &global_hooks);
+    if (!cJSON_IsInlineString(item, old))
+    {
+        global_hooks.deallocate(old);
+    }
+    TEST_ASSERT_EQUAL_UINT(6, (unsigned int)cJSON_GetStringLength(item));
+    TEST_ASSERT_FALSE(cJSON_Compare(object, copy, true));
+    printed = cJSON_PrintUnformatted(object);
+    TEST_ASSERT_EQUAL_STRING("{\"key\":\"longer\",\"keys\":\"\xc3\xa9\",\"\":\"\"}", printed);
+    global_hooks.deallocate(printed);
+
+    cJSON_AddStringToObject(object, "added", "value");
+    TEST_ASSERT_EQUAL_UINT(5, cJSON_GetObjectItem(object, "added")->string_length);
+    TEST_ASSERT_EQUAL_UINT(5, cJSON_GetObjectItem(object, "added")->valuestring_length);
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned int)cJSON_GetStringLength(cJSON_GetArrayItem(NULL, 0)));
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned int)cJSON_GetNameLength(object));
+
+    cJSON_Delete(copy);
+    cJSON_Delete(object);
+}
+
+static void cjson_should_not_trust_lengths_of_strings_assigned_by_hand(void)
+{
+    cJSON *object = cJSON_Parse("{\"name\":\"a long string value\"}");
+    cJSON *item = NULL;
+    char *old = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(object);
+    item = cJSON_GetObjectItem(object, "name");
+
+    /* shorter, reading it with the old length would run past its end */
+    old = item->valuestring;
+    item->valuestring = (char*)cJSON_strdup((const unsigned char*)"s", &global_hooks);
+    printed = cJSON_PrintUnformatted(object);
+    TEST_ASSERT_EQUAL_STRING("{\"name\":\"s\"}", printed);
+    global_hooks.deallocate(printed);
+    global_hooks.deallocate(item->valuestring);
+    item->valuestring = old;
+
+    /* a renamed key */
+    old = item->string;
+    item->string = (char*)cJSON_strdup((const unsigned char*)"renamed", &global_hooks);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItemCaseSensitive(object, "renamed") == item);
+    TEST_ASSERT_NULL(cJSON_GetObjectItemCaseSensitive(object, "name"));
+    printed = cJSON_PrintUnformatted(object);
+    TEST_ASSERT_EQUAL_STRING("{\"renamed\":\"a long string value\"}", printed);
+    global_hooks.deallocate(printed);
+    if (!cJSON_IsInlineString(item, old))
+    {
+        global_hooks.deallocate(old);
+    }
+
+    /* freed first, the new string may get the address of the old one */
+    if (!cJSON_IsInlineString(item, item->valuestring))
+    {
+        global_hooks.deallocate(item->valuestring);
+    }
+    item->valuestring = (char*)cJSON_strdup((const unsigned char*)"new", &global_hooks);
+    item->valuestring_length = 0;
+    TEST_ASSERT_EQUAL_UINT(3, (unsigned int)cJSON_GetStringLength(item));
+
+    cJSON_Delete(object);
+}
+
+static void cjson_set_valuestring_should_replace_strings(void)
+{
+    cJSON *object = cJSON_Parse("{\"string\":\"medium length\",\"lazy\":\"x\",\"number\":1}");
+    cJSON *item = NULL;
+    cJSON *reference = NULL;
+    char *printed = NULL;
+    char lazy_text[] = "[\"lazy\",\"lazy\"]";
+
+    TEST_ASSERT_NOT_NULL(object);
+    item = cJSON_GetObjectItem(object, "string");
+
+    /* shorter into the same memory, then longer into a new one */
+    TEST_ASSERT_EQUAL_STRING("short", cJSON_SetValuestring(item, "short"));
+    TEST_ASSERT_EQUAL_UINT(5, (unsigned int)cJSON_GetStringLength(item));
+    TEST_ASSERT_EQUAL_STRING("a much longer string than before", cJSON_SetValuestring(item, "a much longer string than before"));
+    TEST_ASSERT_EQUAL_UINT(32, (unsigned int)cJSON_GetStringLength(item));
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING("\"a much longer string than before\"", printed);
+    global_hooks.deallocate(printed);
+
+    /* pointing into the current string */
+    TEST_ASSERT_NULL(cJSON_SetValuestring(item, item->valuestring + 2));
+    TEST_ASSERT_NULL(cJSON_SetValuestring(item, NULL));
+    TEST_ASSERT_NULL(cJSON_SetValuestring(NULL, "x"));
+    TEST_ASSERT_NULL(cJSON_SetValuestring(cJSON_GetObjectItem(object, "number"), "x"));
+    reference = cJSON_CreateArray();
+    cJSON_AddItemReferenceToArray(reference, item);
+    TEST_ASSERT_NULL(cJSON_SetValuestring(reference->child, "x"));
+    cJSON_Delete(reference);
+
+    cJSON_Delete(object);
+
+    /* a string that points into the parsed text and one that holds bytes */
+    object = cJSON_ParseWithStringText(lazy_text, sizeof(lazy_text));
+    TEST_ASSERT_NOT_NULL(object);
+    TEST_ASSERT_TRUE(cJSON_GetArrayItem(object, 0)->type & cJSON_IsLazy);
+    TEST_ASSERT_EQUAL_STRING("changed", cJSON_SetValuestring(cJSON_GetArrayItem(object, 0), "changed"));
+    TEST_ASSERT_FALSE(cJSON_GetArrayItem(object, 0)->type & cJSON_IsLazy);
+    cJSON_AddItemToArray(object, cJSON_CreateBinary("\x01\x02", 2));
+    TEST_ASSERT_EQUAL_STRING("text", cJSON_SetValuestring(cJSON_GetArrayItem(object, 2), "text"));
+    TEST_ASSERT_FALSE(cJSON_GetArrayItem(object, 2)->type & cJSON_IsBinary);
+    printed = cJSON_PrintUnformatted(object);
+    TEST_ASSERT_EQUAL_STRING("[\"changed\",\"lazy\",\"text\"]", printed);
+    TEST_ASSERT_EQUAL_STRING("[\"lazy\",\"lazy\"]", lazy_text);
+    global_hooks.deallocate(printed);
+    cJSON_Delete(object);
+}
+
+static void cjson_should_store_short_strings_in_the_items(void)
+{
+#ifdef CJSON_INLINE_STRINGS
+    const cJSON_bool inline_strings = true;
+#else
+    const cJSON_bool inline_strings = false;
+#endif
+    cJSON *object = cJSON_Parse("{\"id\":\"short\",\"a name that doesn't fit\":\"a string that doesn't fit\",\"list\":[\"\\u00e9\\n\"]}");
+    cJSON *lazy = cJSON_ParseWithStringText("[\"a\\tb\"]", 8);
+    cJSON *copy = NULL;
+    cJSON *item = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(object);
+    TEST_ASSERT_NOT_NULL(lazy);
+    item = cJSON_GetObjectItem(object, "id");
+    TEST_ASSERT_EQUAL_INT(inline_strings, cJSON_IsInlineString(item, item->string));
+    TEST_ASSERT_EQUAL_INT(inline_strings, cJSON_IsInlineString(item, item->valuestring));
+    item = cJSON_GetObjectItem(object, "a name that doesn't fit");
+    TEST_ASSERT_FALSE(cJSON_IsInlineString(item, item->string));
+    TEST_ASSERT_FALSE(cJSON_IsInlineString(item, item->valuestring));
+    item = cJSON_GetArrayItem(cJSON_GetObjectItem(object, "list"), 0);
+    TEST_ASSERT_EQUAL_INT(inline_strings, cJSON_IsInlineString(item, item->valuestring));
+    TEST_ASSERT_EQUAL_STRING("a\tb", cJSON_GetStringValue(lazy->child));
+    TEST_ASSERT_EQUAL_INT(inline_strings, cJSON_IsInlineString(lazy->child, lazy->child->valuestring));
+    TEST_ASSERT_FALSE(cJSON_IsInlineString(NULL, "id"));
+
+    copy = cJSON_Duplicate(object, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_TRUE(cJSON_Compare(object, copy, true));
+    item = cJSON_GetObjectItem(copy, "id");
+    TEST_ASSERT_EQUAL_INT(inline_strings, cJSON_IsInlineString(item, item->string));
+
+    /* the name of a replaced item is moved out of its room */
+    TEST_ASSERT_TRUE(cJSON_ReplaceItemViaPointer(object, cJSON_GetObjectItem(object, "id"), cJSON_CreateNumber(1)));
+    cJSON_AddStringToObject(object, "new", "value");
+    item = cJSON_DetachItemFromObject(object, "new");
+    cJSON_AddItemToObject(object, item->string, item);
+    TEST_ASSERT_EQUAL_INT(inline_strings, cJSON_IsInlineString(item, item->string));
+    cJSON_ReplaceItemInObject(copy, "id", cJSON_CreateString("other"));
+
+    printed = cJSON_PrintUnformatted(object);
+    TEST_ASSERT_EQUAL_STRING("{\"id\":1,\"a name that doesn't fit\":\"a string that doesn't fit\",\"list\":[\"\xc3\xa9\\n\"],\"new\":\"value\"}", printed);
+    global_hooks.deallocate(printed);
+    printed = cJSON_PrintUnformatted(copy);
+    TEST_ASSERT_EQUAL_STRING("{\"id\":\"other\",\"a name that doesn't fit\":\"a string that doesn't fit\",\"list\":[\"\xc3\xa9\\n\"]}", printed);
+    global_hooks.deallocate(printed);
+
+    cJSON_Delete(lazy);
+    cJSON_Delete(copy);
+    cJSON_Delete(object);
+}
+
+static void cjson_replace_item_via_pointer_should_keep_position_and_key(void)
+{
+    cJSON *object = cJSON_Parse("{\"a\":1,\"b\":2,\"c\":3}");
+    cJSON *b = cJSON_GetObjectItem(object, "b");
+    const char *key = b->string;
+    const cJSON_bool inline_key = cJSON_IsInlineString(b, key);
+    cJSON *replacement = cJSON_CreateString("x");
+    char *printed = NULL;
+
+    TEST_ASSERT_FALSE(cJSON_ReplaceItemViaPointer(object, NULL, replacement));
+    TEST_ASSERT_FALSE(cJSON_ReplaceItemViaPointer(NULL, b, replacement));
+
+    cJSON_BuildIndex(object);
+    TEST_ASSERT_TRUE(cJSON_ReplaceItemViaPointer(object, b, replacement));
+    /* the key is moved, not copied, unless it is stored in the item that goes away */
+    TEST_ASSERT_TRUE((replacement->string == key) || inline_key);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(object, "b") == replacement);
+
+    printed = cJSON_PrintUnformatted(object);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":\"x\",\"c\":3}", printed);
+    global_hooks.deallocate(printed);
+
+    /* a replacement with a key keeps it */
+    replacement = cJSON_CreateNull();
+    cJSON_AddItemToObject(object, "d", replacement);
+    cJSON_DetachItemFromObject(object, "d");
+    TEST_ASSERT_TRUE(cJSON_ReplaceItemViaPointer(object, cJSON_GetObjectItem(object, "a"), replacement));
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(object, "a"));
+    TEST_ASSERT_TRUE(object->child == cJSON_GetObjectItem(object, "d"));
+
+    cJSON_Delete(object);
+}
+
+/* the first child has to point to the last one and the others to the one before them */
+static void assert_linked(const cJSON *array)
+{
+    const cJSON *child = NULL;
+    const cJSON *last = NULL;
+
+    for (child = array->child; child != NULL; child = child->next)
+    {
+        if (last != NULL)
+        {
+            TEST_ASSERT_TRUE(child->prev == last);
+        }
+        last = child;
+    }
+    if (array->child != NULL)
+    {
+        TEST_ASSERT_TRUE(array->child->prev == last);
+    }
+}
+
+static void cjson_lists_should_point_to_their_last_item(void)
+{
+    cJSON *array = cJSON_CreateArray();
+    cJSON *copy = NULL;
+    cJSON *parsed = cJSON_Parse("[1,[2,3],{\"a\":4}]");
+    int numbers[3] = { 1, 2, 3 };
+    int i = 0;
+
+    assert_linked(parsed);
+    assert_linked(parsed->child->next);
+    assert_linked(parsed->child->next->next);
+
+    for (i = 0; i < 10; i++)
+    {
+        cJSON_AddItemToArray(array, cJSON_CreateNumber(i));
+        TEST_ASSERT_EQUAL_DOUBLE(i, array->child->prev->valuedouble);
+    }
+    cJSON_InsertItemInArray(array, 0, cJSON_CreateNumber(-1));
+    cJSON_InsertItemInArray(array, 5, cJSON_CreateNumber(-2));
+    cJSON_InsertItemInArray(array, 100, cJSON_CreateNumber(-3));
+    assert_linked(array);
+    TEST_ASSERT_EQUAL_DOUBLE(-3, array->child->prev->valuedouble);
+
+    cJSON_DeleteItemFromArray(array, cJSON_GetArraySize(array) - 1);
+    assert_linked(array);
+    cJSON_DeleteItemFromArray(array, 0);
+    assert_linked(array);
+    cJSON_ReplaceItemInArray(array, cJSON_GetArraySize(array) - 1, cJSON_CreateNumber(-4));
+    assert_linked(array);
+    TEST_ASSERT_EQUAL_DOUBLE(-4, array->child->prev->valuedouble);
+    cJSON_ReplaceItemInArray(array, 0, cJSON_CreateNumber(-5));
+    assert_linked(array);
+
+    copy = cJSON_Duplicate(array, true);
+    assert_linked(copy);
+    cJSON_Delete(copy);
+
+    while (cJSON_GetArraySize(array) > 1)
+    {
+        cJSON_DeleteItemFromArray(array, 1);
+        assert_linked(array);
+    }
+    /* a single child points to itself */
+    cJSON_ReplaceItemInArray(array, 0, cJSON_CreateNumber(-6));
+    TEST_ASSERT_TRUE(array->child->prev == array->child);
+    cJSON_DeleteItemFromArray(array, 0);
+    TEST_ASSERT_NULL(array->child);
+    cJSON_AddItemToArray(array, cJSON_CreateIntArray(numbers, 3));
+    assert_linked(array);
+    assert_linked(array->child);
+
+    cJSON_Delete(array);
+    cJSON_Delete(parsed);
+}
+
+static void cjson_create_from_arrays_should_build_containers(void)
+{
+    const char *keys[6] = { "null", "false", "true", "number", "a very long name that doesn't fit into a node", "raw" };
+    const int types[6] = { cJSON_NULL, cJSON_False, cJSON_True, cJSON_Number, cJSON_String, cJSON_Raw };
+    int invalid_types[2] = { cJSON_Number, cJSON_Array };
+    cJSON_Value values[6];
+    cJSON *object = NULL;
+    cJSON *array = NULL;
+    char *printed = NULL;
+
+    memset(values, '\0', sizeof(values));
+    values[3].number = 1.5;
+    values[4].string = "string";
+    values[5].string = "[1,2]";
+
+    object = cJSON_CreateObjectFromArrays(keys, values, types, 6);
+    TEST_ASSERT_NOT_NULL(object);
+    assert_linked(object);
+    printed = cJSON_PrintUnformatted(object);
+    TEST_ASSERT_EQUAL_STRING("{\"null\":null,\"false\":false,\"true\":true,\"number\":1.5,\"a very long name that doesn't fit into a node\":\"string\",\"raw\":[1,2]}", printed);
+    TEST_ASSERT_EQUAL_UINT(6, cJSON_GetNameLength(cJSON_GetObjectItem(object, "number")));
+    TEST_ASSERT_EQUAL_INT(1, cJSON_GetObjectItem(object, "number")->valueint);
+    free(printed);
+    cJSON_Delete(object);
+
+    array = cJSON_CreateArrayFromArrays(values, types, 6);
+    TEST_ASSERT_NOT_NULL(array);
+    assert_linked(array);
+    TEST_ASSERT_NULL(array->child->string);
+    printed = cJSON_PrintUnformatted(array);
+    TEST_ASSERT_EQUAL_STRING("[null,false,true,1.5,\"string\",[1,2]]", printed);
+    free(printed);
+    cJSON_Delete(array);
+
+    array = cJSON_CreateArrayFromArrays(NULL, NULL, 0);
+    TEST_ASSERT_NOT_NULL(array);
+    TEST_ASSERT_NULL(array->child);
+    cJSON_Delete(array);
+
+    TEST_ASSERT_NULL(cJSON_CreateArrayFromArrays(values, invalid_types, 2));
+    TEST_ASSERT_NULL(cJSON_CreateObjectFromArrays(NULL, values, types, 1));
+    values[4].string = NULL;
+    TEST_ASSERT_NULL(cJSON_CreateObjectFromArrays(keys, values, types, 6));
+    values[4].string = "string";
+    keys[2] = NULL;
+    TEST_ASSERT_NULL(cJSON_CreateObjectFromArrays(keys, values, types, 6));
+    TEST_ASSERT_NULL(cJSON_CreateArrayFromArrays(NULL, types, 1));
+}
+
+/* the events of a cursor over json, one letter per event and the key or depth in between */
+static void assert_cursor_events(const char * const json, const char * const expected, const cJSON_bool skip_objects)
+{
+    cJSON *item = cJSON_ParseLazy(json, strlen(json));
+    cJSON_Cursor *cursor = NULL;
+    char events[256];
+    size_t length = 0;
+    int event = 0;
+
+    TEST_ASSERT_NOT_NULL(item);
+    cursor = cJSON_CreateCursor(item);
+    TEST_ASSERT_NOT_NULL(cursor);
+    while ((event = cJSON_CursorNext(cursor)) != cJSON_CursorDone)
+    {
+        TEST_ASSERT_TRUE(length < (sizeof(events) - 16));
+        events[length++] = "?VEL!"[event];
+        if (cJSON_CursorKey(cursor) != NULL)
+        {
+            length += (size_t)sprintf(events + length, "%s", cJSON_CursorKey(cursor));
+        }
+        length += (size_t)sprintf(events + length, "%u", (unsigned int)cJSON_CursorDepth(cursor));
+        if (skip_objects && (event == cJSON_CursorEnter) && cJSON_IsObject(cJSON_CursorItem(cursor)))
+        {
+            cJSON_CursorSkip(cursor);
+        }
+    }
+    events[length] = '\0';
+    TEST_ASSERT_EQUAL_STRING(expected, events);
+    TEST_ASSERT_NULL(cJSON_CursorItem(cursor));
+    TEST_ASSERT_EQUAL_INT(cJSON_CursorDone, cJSON_CursorNext(cursor));
+
+    cJSON_DeleteCursor(cursor);
+    cJSON_Delete(item);
+}
+
+static void cjson_cursor_should_walk_depth_first(void)
+{
+    cJSON *deep = NULL;
+    cJSON *item = NULL;
+    cJSON_Cursor *cursor = NULL;
+    size_t enters = 0;
+    size_t leaves = 0;
+    size_t deepest = 0;
+    int event = 0;
+    size_t i = 0;
+
+    assert_cursor_events("1", "V0", false);
+    assert_cursor_events("[]", "E0L0", false);
+    assert_cursor_events("{\"a\":[1,{\"b\":null}],\"c\":{},\"d\":\"x\"}", "E0Ea1V2E2Vb3L2La1Ec1Lc1Vd1L0", false);
+    assert_cursor_events("[{\"a\":[1]},[{}],2]", "E0E1L1E1E2L2L1V1L0", true);
+
+    /* far deeper than the C stack would allow with recursion (and than the parser allows) */
+    item = cJSON_CreateArray();
+    TEST_ASSERT_NOT_NULL(item);
+    for (i = 1, deep = item; i < 100000; i++)
+    {
+        cJSON *inner = cJSON_CreateArray();
+        TEST_ASSERT_NOT_NULL(inner);
+        cJSON_AddItemToArray(deep, inner);
+        deep = inner;
+    }
+    cursor = cJSON_CreateCursor(item);
+    TEST_ASSERT_NOT_NULL(cursor);
+    while ((event = cJSON_CursorNext(cursor)) != cJSON_CursorDone)
+    {
+        enters += (event == cJSON_CursorEnter) ? 1 : 0;
+        leaves += (event == cJSON_CursorLeave) ? 1 : 0;
+        deepest = (cJSON_CursorDepth(cursor) > deepest) ? cJSON_CursorDepth(cursor) : deepest;
+        TEST_ASSERT_TRUE((event == cJSON_CursorEnter) || (event == cJSON_CursorLeave));
+    }
+    TEST_ASSERT_EQUAL_UINT(100000, (unsigned int)enters);
+    TEST_ASSERT_EQUAL_UINT(100000, (unsigned int)leaves);
+    TEST_ASSERT_EQUAL_UINT(99999, (unsigned int)deepest);
+    cJSON_DeleteCursor(cursor);
+    cJSON_Delete(item);
+
+    /* invalid lazy parts end the walk */
+    item = cJSON_ParseLazy("[[1,x]]", 7);
+    TEST_ASSERT_NOT_NULL(item);
+    cursor = cJSON_CreateCursor(item);
+    TEST_ASSERT_EQUAL_INT(cJSON_CursorEnter, cJSON_CursorNext(cursor));
+    TEST_ASSERT_EQUAL_INT(cJSON_CursorInvalid, cJSON_CursorNext(cursor));
+    TEST_ASSERT_EQUAL_INT(cJSON_CursorDone, cJSON_CursorNext(cursor));
+    cJSON_DeleteCursor(cursor);
+    cJSON_Delete(item);
+
+    TEST_ASSERT_NULL(cJSON_CreateCursor(NULL));
+    TEST_ASSERT_EQUAL_INT(cJSON_CursorDone, cJSON_CursorNext(NULL));
+    TEST_ASSERT_NULL(cJSON_CursorKey(NULL));
+    cJSON_CursorSkip(NULL);
+    cJSON_DeleteCursor(NULL);
+}
+
+static void cjson_deduplicate_should_share_equal_parts(void)
+{
+    const char json[] = "[{\"address\":{\"street\":\"a street with a long name\",\"tags\":[1,2]},\"kind\":\"warehouse for parts\"},"
+        "{\"address\":{\"street\":\"a street with a long name\",\"tags\":[1,2]},\"kind\":\"warehouse for parts\"},"
+        "{\"address\":{\"tags\":[1,2],\"street\":\"a street with a long name\"},\"kind\":\"warehouse for parts\"},"
+        "[0,-0,0],\"warehouse for parts\"]";
+    cJSON *item = cJSON_Parse(json);
+    cJSON *copy = NULL;
+    cJSON *first = NULL;
+    cJSON *second = NULL;
+    cJSON *third = NULL;
+    char *printed = NULL;
+    size_t usage = 0;
+
+    TEST_ASSERT_NOT_NULL(item);
+    usage = cJSON_MemoryUsage(item);
+    TEST_ASSERT_TRUE(cJSON_Deduplicate(item));
+    TEST_ASSERT_TRUE(cJSON_MemoryUsage(item) < usage);
+    TEST_ASSERT_BITS_HIGH(cJSON_IsFrozen, item->type);
+
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    free(printed);
+
+    first = cJSON_GetArrayItem(item, 0);
+    second = cJSON_GetArrayItem(item, 1);
+    third = cJSON_GetArrayItem(item, 2);
+    /* equal objects share their members, the first one owns them */
+    TEST_ASSERT_BITS_LOW(cJSON_IsReference, first->type);
+    TEST_ASSERT_BITS_HIGH(cJSON_IsReference, second->type);
+    TEST_ASSERT_TRUE(first->child == second->child);
+    /* the order of the members matters, but the parts that are equal are shared */
+    TEST_ASSERT_FALSE(cJSON_GetObjectItem(first, "address")->child == cJSON_GetObjectItem(third, "address")->child);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(cJSON_GetObjectItem(first, "address"), "tags")->child == cJSON_GetObjectItem(cJSON_GetObjectItem(third, "address"), "tags")->child);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(first, "kind")->valuestring == cJSON_GetArrayItem(item, 4)->valuestring);
+
+    copy = cJSON_Duplicate(item, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_BITS_LOW(cJSON_IsReference | cJSON_IsFrozen, cJSON_GetArrayItem(copy, 1)->type);
+    TEST_ASSERT_TRUE(cJSON_Compare(item, copy, true));
+    TEST_ASSERT_FALSE(cJSON_Deduplicate(item));
+
+    cJSON_Delete(item);
+    cJSON_Delete(copy);
+    TEST_ASSERT_FALSE(cJSON_Deduplicate(NULL));
+}
+
+static void cjson_detach_item_via_pointer_should_detach_items(void)
+{
+    cJSON *object = cJSON_Parse("{\"a\":1,\"b\":2,\"c\":3}");
+    cJSON *item = NULL;
+    cJSON *detached = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NULL(cJSON_DetachItemViaPointer(object, NULL));
+    TEST_ASSERT_NULL(cJSON_DetachItemViaPointer(NULL, object->child));
+
+    cJSON_ArrayForEach(item, object)
+    {
+        if (strcmp(item->string, "b") == 0)
+        {
+            break;
+        }
+    }
+    detached = cJSON_DetachItemViaPointer(object, item);
+    TEST_ASSERT_TRUE(detached == item);
+    TEST_ASSERT_NULL(item->prev);
+    TEST_ASSERT_NULL(item->next);
+    cJSON_Delete(item);
+    assert_linked(object);
+
+    /* the last and the first one */
+    cJSON_Delete(cJSON_DetachItemViaPointer(object, object->child->prev));
+    assert_linked(object);
+    printed = cJSON_PrintUnformatted(object);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1}", printed);
+    global_hooks.deallocate(printed);
+    cJSON_Delete(cJSON_DetachItemViaPointer(object, object->child));
+    TEST_ASSERT_NULL(object->child);
+
+    cJSON_Delete(object);
+}
+
+static void cjson_get_number_array_should_copy_numbers(void)
+{
+    const double packed[] = { 4, 5 };
+    cJSON *array = cJSON_Parse("[1,2.5,-3]");
+    cJSON *item = NULL;
+    double numbers[4] = { 0, 0, 0, 0 };
+    int integers[4] = { 0, 0, 0, 0 };
+
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetNumberArray(array, numbers, 4));
+    TEST_ASSERT_EQUAL_DOUBLE(2.5, numbers[1]);
+    TEST_ASSERT_EQUAL_DOUBLE(-3, numbers[2]);
+    /* only as many as fit, but the size is reported */
+    numbers[1] = 0;
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetNumberArray(array, numbers, 1));
+    TEST_ASSERT_EQUAL_DOUBLE(0, numbers[1]);
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetNumberArray(array, NULL, 0));
+
+    /* 2.5 isn't an integer */
+    TEST_ASSERT_EQUAL_INT(-1, cJSON_GetIntArray(array, integers, 4));
+    cJSON_ReplaceItemInArray(array, 1, cJSON_CreateNumber(2));
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetIntArray(array, integers, 4));
+    TEST_ASSERT_EQUAL_INT(-3, integers[2]);
+    cJSON_AddItemToArray(array, cJSON_CreateNumber(1e10));
+    TEST_ASSERT_EQUAL_INT(-1, cJSON_GetIntArray(array, integers, 4));
+
+    cJSON_AddItemToArray(array, cJSON_CreateString("x"));
+    TEST_ASSERT_EQUAL_INT(-1, cJSON_GetNumberArray(array, numbers, 4));
+    TEST_ASSERT_EQUAL_INT(-1, cJSON_GetNumberArray(NULL, numbers, 4));
+    TEST_ASSERT_EQUAL_INT(-1, cJSON_GetNumberArray(array, NULL, 4));
+    item = cJSON_CreateObject();
+    TEST_ASSERT_EQUAL_INT(-1, cJSON_GetNumberArray(item, numbers, 4));
+    cJSON_Delete(item);
+    cJSON_Delete(array);
+
+    /* packed arrays stay packed */
+    array = cJSON_CreatePackedArray(packed, 2);
+    TEST_ASSERT_EQUAL_INT(2, cJSON_GetNumberArray(array, numbers, 4));
+    TEST_ASSERT_EQUAL_DOUBLE(5, numbers[1]);
+    TEST_ASSERT_EQUAL_INT(2, cJSON_GetIntArray(array, integers, 4));
+    TEST_ASSERT_EQUAL_INT(4, integers[0]);
+    TEST_ASSERT_NOT_NULL(cJSON_GetPackedNumbers(array));
+    cJSON_Delete(array);
+}
+
+static void cjson_open_file_should_load_whole_files(void)
+{
+    char *expected = read_file("inputs/test7");
+    cJSON_File *file = cJSON_OpenFile("inputs/test7");
+    cJSON *lazy = NULL;
+
+    TEST_ASSERT_NOT_NULL(expected);
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_UINT(strlen(expected), cJSON_GetFileLength(file));
+    TEST_ASSERT_EQUAL_MEMORY(expected, cJSON_GetFileData(file), strlen(expected));
+
+    /* documents may point into the file while it is open */
+    lazy = cJSON_ParseWithStringText(cJSON_GetFileData(file), cJSON_GetFileLength(file));
+    TEST_ASSERT_NOT_NULL(lazy);
+    TEST_ASSERT_EQUAL_STRING("SUNNYVALE", cJSON_GetStringValue(cJSON_GetObjectItem(cJSON_GetArrayItem(lazy, 1), "City")));
+    cJSON_Delete(lazy);
+
+    cJSON_CloseFile(file);
+    free(expected);
+
+    TEST_ASSERT_NULL(cJSON_OpenFile("inputs/does_not_exist"));
+    TEST_ASSERT_NULL(cJSON_OpenFile(NULL));
+    TEST_ASSERT_NULL(cJSON_GetFileData(NULL));
+    TEST_ASSERT_EQUAL_UINT(0, cJSON_GetFileLength(NULL));
+    cJSON_CloseFile(NULL);
+}
+
+static void cjson_parse_file_should_parse_files(void)
+{
+    char *json = read_file("inputs/test1");
+    cJSON *expected = NULL;
+    cJSON *item = NULL;
+    cJSON_ParseError error;
+
+    TEST_ASSERT_NOT_NULL(json);
+    expected = cJSON_Parse(json);
+    item = cJSON_ParseFile("inputs/test1", &error);
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_None, error.code);
+    TEST_ASSERT_TRUE(cJSON_Compare(expected, item, true));
+    cJSON_Delete(item);
+    cJSON_Delete(expected);
+    free(json);
+
+    TEST_ASSERT_NULL(cJSON_ParseFile("inputs/does_not_exist", &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_File, error.code);
+    TEST_ASSERT_EQUAL_UINT(0, error.position);
+    /* a directory can be opened, but not read */
+    TEST_ASSERT_NULL(cJSON_ParseFile("inputs", &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_File, error.code);
+}
+
+/* every allocation starts with its size, so the bytes that are in use can be counted */
+typedef union
+{
+    size_t size;
+    double alignment;
+} tracking_header;
+
+static size_t live_bytes = 0;
+
+static void *tracking_malloc(size_t size)
+{
+    tracking_header *header = (tracking_header*)malloc(sizeof(tracking_header) + size);
+    if (header == NULL)
+    {
+        return NULL;
+    }
+    header->size = size;
+    live_bytes += size;
+
+    return header + 1;
+}
+
+static void tracking_free(void *pointer)
+{
+    tracking_header *header = (tracking_header*)pointer - 1;
+    if (pointer == NULL)
+    {
+        return;
+    }
+    live_bytes -= header->size;
+    free(header);
+}
+
+static void cjson_memory_usage_should_count_what_a_tree_holds(void)
+{
+    cJSON_Hooks hooks = { tracking_malloc, tracking_free };
+    const double numbers[] = { 1, 2, 3 };
+    cJSON *object = NULL;
+    cJSON *array = NULL;
+    cJSON *shared = NULL;
+    cJSON_Arena *arena = NULL;
+    size_t before = 0;
+    size_t usage = 0;
+    int i = 0;
+
+    cJSON_InitHooks(&hooks);
+    before = live_bytes;
+
+    object = cJSON_CreateObject();
+    array = cJSON_CreateArray();
+    cJSON_AddItemToObject(object, "array", array);
+    for (i = 0; i < 40; i++)
+    {
+        cJSON_AddItemToArray(array, cJSON_CreateString("a string"));
+    }
+    cJSON_AddItemToObject(object, "packed", cJSON_CreatePackedArray(numbers, 3));
+    cJSON_AddItemToObject(object, "raw", cJSON_CreateRaw("[1, 2]"));
+    cJSON_AddItemToObjectCS(object, "constant name", cJSON_CreateNull());
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(object));
+    TEST_ASSERT_TRUE(cJSON_BuildIndex(array));
+    TEST_ASSERT_EQUAL_UINT(live_bytes - before, cJSON_MemoryUsage(object));
+
+    /* references don't count what they refer to */
+    shared = cJSON_CreateString("shared");
+    before = live_bytes;
+    usage = cJSON_MemoryUsage(object);
+    cJSON_AddItemReferenceToObject(object, "reference", shared);
+    cJSON_AddItemReferenceToArray(array, object->child);
+    TEST_ASSERT_EQUAL_UINT(live_bytes - before, cJSON_MemoryUsage(object) - usage);
+
+    cJSON_Delete(object);
+    cJSON_Delete(shared);
+
+    before = live_bytes;
+    arena = cJSON_CreateArena(0);
+    TEST_ASSERT_NOT_NULL(cJSON_ParseWithArena(arena, "{\"a\":[1,2,3],\"b\":\"text\"}"));
+    TEST_ASSERT_EQUAL_UINT(live_bytes - before, cJSON_GetArenaMemoryUsage(arena));
+    cJSON_DeleteArena(arena);
+    cJSON_InitHooks(NULL);
+
+    TEST_ASSERT_EQUAL_UINT(0, cJSON_MemoryUsage(NULL));
+    TEST_ASSERT_EQUAL_UINT(0, cJSON_GetArenaMemoryUsage(NULL));
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -192,6 +1797,43 @@ int main(void)
     RUN_TEST(cjson_get_object_item_should_get_object_items);
     RUN_TEST(cjson_get_object_item_case_sensitive_should_get_object_items);
     RUN_TEST(typecheck_functions_should_check_type);
+    RUN_TEST(cjson_parse_with_error_should_report_errors);
+    RUN_TEST(cjson_parse_with_error_should_not_touch_global_error);
+    RUN_TEST(cjson_parse_with_limits_should_stop_at_the_limits);
+    RUN_TEST(cjson_parse_with_length_should_stop_at_the_buffer_end);
+    RUN_TEST(cjson_print_to_writer_should_print_in_pieces);
+    RUN_TEST(cjson_print_to_writer_should_handle_large_values);
+    RUN_TEST(cjson_print_to_writer_should_stop_when_the_writer_fails);
+    RUN_TEST(cjson_print_to_file_should_print);
+    RUN_TEST(cjson_printer_should_reuse_its_buffer);
+    RUN_TEST(cjson_printer_should_shrink_above_the_high_water_mark);
+    RUN_TEST(cjson_ndjson_writer_should_batch_records);
+    RUN_TEST(cjson_print_chunks_should_print_into_chunks);
+    RUN_TEST(cjson_print_chunks_should_reuse_chunks_for_smaller_documents);
+    RUN_TEST(cjson_printed_length_should_be_exact);
+    RUN_TEST(cjson_size_t_functions_should_work_like_the_int_ones);
+    RUN_TEST(ensure_should_accept_sizes_beyond_int_max);
+    RUN_TEST(cjson_parse_should_limit_the_nesting_depth);
+    RUN_TEST(cjson_functions_should_not_recurse_on_deep_trees);
+    RUN_TEST(cjson_print_should_print_nested_objects);
+    RUN_TEST(cjson_parse_in_situ_should_point_into_the_buffer);
+    RUN_TEST(cjson_init_hooks_with_realloc_should_grow_buffers_in_place);
+    RUN_TEST(cjson_delete_should_cache_nodes);
+    RUN_TEST(cjson_reclaimer_should_free_in_steps);
+    RUN_TEST(cjson_should_store_string_lengths);
+    RUN_TEST(cjson_should_not_trust_lengths_of_strings_assigned_by_hand);
+    RUN_TEST(cjson_set_valuestring_should_replace_strings);
+    RUN_TEST(cjson_should_store_short_strings_in_the_items);
+    RUN_TEST(cjson_replace_item_via_pointer_should_keep_position_and_key);
+    RUN_TEST(cjson_lists_should_point_to_their_last_item);
+    RUN_TEST(cjson_create_from_arrays_should_build_containers);
+    RUN_TEST(cjson_cursor_should_walk_depth_first);
+    RUN_TEST(cjson_deduplicate_should_share_equal_parts);
+    RUN_TEST(cjson_detach_item_via_pointer_should_detach_items);
+    RUN_TEST(cjson_get_number_array_should_copy_numbers);
+    RUN_TEST(cjson_open_file_should_load_whole_files);
+    RUN_TEST(cjson_parse_file_should_parse_files);
+    RUN_TEST(cjson_memory_usage_should_count_what_a_tree_holds);
 
     return UNITY_END();
 }
@@ -0,0 +1,205 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static void assert_printed(const cJSON * const item, const cJSON_bool format, const char *expected)
+{
+    char *printed = format ? cJSON_Print(item) : cJSON_PrintUnformatted(item);
+
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)strlen(expected), (unsigned int)cJSON_PrintedLength(item, format));
+    global_hooks.deallocate(printed);
+}
+
+static void packed_arrays_should_print_without_nodes(void)
+{
+    const double numbers[] = { 1, -2.5, 1e300, 0 };
+    cJSON *array = cJSON_CreatePackedArray(numbers, 4);
+    char buffer[64];
+
+    TEST_ASSERT_NOT_NULL(array);
+    TEST_ASSERT_TRUE(cJSON_IsArray(array));
+    TEST_ASSERT_BITS(cJSON_IsPacked, cJSON_IsPacked, array->type);
+    TEST_ASSERT_EQUAL_INT(4, cJSON_GetArraySize(array));
+
+    assert_printed(array, false, "[1,-2.5,1e+300,0]");
+    assert_printed(array, true, "[1, -2.5, 1e+300, 0]");
+    TEST_ASSERT_TRUE(cJSON_PrintPreallocated(array, buffer, sizeof(buffer), false));
+    TEST_ASSERT_EQUAL_STRING("[1,-2.5,1e+300,0]", buffer);
+    TEST_ASSERT_FALSE(cJSON_PrintPreallocated(array, buffer, 10, false));
+
+    /* still packed */
+    TEST_ASSERT_NULL(array->child);
+    TEST_ASSERT_NOT_NULL(cJSON_GetPackedNumbers(array));
+
+    cJSON_Delete(array);
+}
+
+static void packed_arrays_should_be_changed_in_place(void)
+{
+    const double numbers[] = { 1, 2, 3 };
+    cJSON *array = cJSON_CreatePackedArray(numbers, 3);
+    double *packed = cJSON_GetPackedNumbers(array);
+    size_t i = 0;
+
+    TEST_ASSERT_NOT_NULL(packed);
+    TEST_ASSERT_FALSE(packed == numbers);
+    for (i = 0; i < 3; i++)
+    {
+        packed[i] *= 2;
+    }
+    assert_printed(array, false, "[2,4,6]");
+
+    cJSON_Delete(array);
+}
+
+static void packed_arrays_should_unpack_when_elements_are_needed(void)
+{
+    const double numbers[] = { 1, 2, 3 };
+    cJSON *array = cJSON_CreatePackedArray(numbers, 3);
+    cJSON *element = NULL;
+    double sum = 0;
+
+    cJSON_ArrayForEach(element, array)
+    {
+        TEST_ASSERT_TRUE(cJSON_IsNumber(element));
+        sum += element->valuedouble;
+    }
+    TEST_ASSERT_EQUAL_DOUBLE(6, sum);
+    TEST_ASSERT_NULL(cJSON_GetPackedNumbers(array));
+    TEST_ASSERT_FALSE(array->type & cJSON_IsPacked);
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetArrayItem(array, 2)->valueint);
+    TEST_ASSERT_TRUE(array->child->prev == cJSON_GetArrayItem(array, 2));
+
+    cJSON_Delete(array);
+
+    /* by changing it */
+    array = cJSON_CreatePackedArray(numbers, 3);
+    cJSON_AddItemToArray(array, cJSON_CreateString("x"));
+    assert_printed(array, false, "[1,2,3,\"x\"]");
+    cJSON_Delete(array);
+}
+
+static void packed_arrays_should_be_duplicated_and_compared(void)
+{
+    const double numbers[] = { 1, 2, 3 };
+    cJSON *array = cJSON_CreatePackedArray(numbers, 3);
+    cJSON *copy = cJSON_Duplicate(array, true);
+    cJSON *parsed = cJSON_Parse("[1,2,3]");
+
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_NOT_NULL(cJSON_GetPackedNumbers(copy));
+    TEST_ASSERT_FALSE(cJSON_GetPackedNumbers(copy) == cJSON_GetPackedNumbers(array));
+    assert_printed(copy, false, "[1,2,3]");
+
+    TEST_ASSERT_TRUE(cJSON_Compare(copy, parsed, true));
+    TEST_ASSERT_EQUAL_UINT((unsigned int)cJSON_Hash(parsed), (unsigned int)cJSON_Hash(array));
+
+    cJSON_Delete(array);
+    cJSON_Delete(copy);
+    cJSON_Delete(parsed);
+}
+
+static void packed_arrays_should_handle_edge_cases(void)
+{
+    const double number = 1;
+    cJSON *array = cJSON_CreatePackedArray(NULL, 0);
+
+    /* nothing to pack */
+    TEST_ASSERT_NOT_NULL(array);
+    TEST_ASSERT_FALSE(array->type & cJSON_IsPacked);
+    assert_printed(array, false, "[]");
+    cJSON_Delete(array);
+
+    TEST_ASSERT_NULL(cJSON_CreatePackedArray(NULL, 1));
+    TEST_ASSERT_NULL(cJSON_CreatePackedArray(&number, -1));
+    TEST_ASSERT_NULL(cJSON_GetPackedNumbers(NULL));
+}
+
+static void parse_packed_should_pack_arrays_of_numbers(void)
+{
+    const char json[] = "{\"samples\":[ 1, 2.5 ,-3e2 ],\"mixed\":[1,\"a\"],\"empty\":[],\"nested\":[[4],[5,6]]}";
+    cJSON *item = cJSON_ParsePacked(json, sizeof(json) - 1);
+    cJSON *samples = NULL;
+    cJSON *nested = NULL;
+
+    TEST_ASSERT_NOT_NULL(item);
+    samples = cJSON_GetObjectItem(item, "samples");
+    TEST_ASSERT_NOT_NULL(cJSON_GetPackedNumbers(samples));
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetArraySize(samples));
+    TEST_ASSERT_EQUAL_DOUBLE(-300, cJSON_GetPackedNumbers(samples)[2]);
+    TEST_ASSERT_EQUAL_STRING("samples", samples->string);
+
+    TEST_ASSERT_NULL(cJSON_GetPackedNumbers(cJSON_GetObjectItem(item, "mixed")));
+    TEST_ASSERT_NULL(cJSON_GetPackedNumbers(cJSON_GetObjectItem(item, "empty")));
+    nested = cJSON_GetObjectItem(item, "nested");
+    TEST_ASSERT_NULL(cJSON_GetPackedNumbers(nested));
+    TEST_ASSERT_NOT_NULL(cJSON_GetPackedNumbers(nested->child));
+    TEST_ASSERT_NOT_NULL(cJSON_GetPackedNumbers(nested->child->next));
+
+    assert_printed(item, false, "{\"samples\":[1,2.5,-300],\"mixed\":[1,\"a\"],\"empty\":[],\"nested\":[[4],[5,6]]}");
+    cJSON_Delete(item);
+
+    /* the root */
+    item = cJSON_ParsePacked("[1,2]", 5);
+    TEST_ASSERT_NOT_NULL(cJSON_GetPackedNumbers(item));
+    cJSON_Delete(item);
+
+    /* numbers that grow the buffer */
+    item = cJSON_ParsePacked("[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19]", 51);
+    TEST_ASSERT_EQUAL_INT(20, cJSON_GetArraySize(item));
+    TEST_ASSERT_EQUAL_DOUBLE(19, cJSON_GetPackedNumbers(item)[19]);
+    cJSON_Delete(item);
+}
+
+static void parse_packed_should_report_errors(void)
+{
+    TEST_ASSERT_NULL(cJSON_ParsePacked("[1,2", 4));
+    TEST_ASSERT_NULL(cJSON_ParsePacked("[1,-]", 5));
+    TEST_ASSERT_NULL(cJSON_ParsePacked("[1,2,]", 6));
+    TEST_ASSERT_NULL(cJSON_ParsePacked("{\"a\":[1,2],\"b\":x}", 17));
+    TEST_ASSERT_EQUAL_STRING("x}", cJSON_GetErrorPtr());
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(packed_arrays_should_print_without_nodes);
+    RUN_TEST(packed_arrays_should_be_changed_in_place);
+    RUN_TEST(packed_arrays_should_unpack_when_elements_are_needed);
+    RUN_TEST(packed_arrays_should_be_duplicated_and_compared);
+    RUN_TEST(packed_arrays_should_handle_edge_cases);
+    RUN_TEST(parse_packed_should_pack_arrays_of_numbers);
+    RUN_TEST(parse_packed_should_report_errors);
+
+    return UNITY_END();
+}
@@ -30,7 +30,7 @@
 
 static cJSON item[1];
 
-static const unsigned char *error_pointer = NULL;
+static parse_context context = { &global_hooks, NULL, cJSON_Error_None, NULL, NULL };
 
 static void assert_is_array(cJSON *array_item)
 {
@@ -46,13 +46,15 @@ static void assert_is_array(cJSON *array_item)
 
 static void assert_not_array(const char *json)
 {
-    TEST_ASSERT_NULL(parse_array(item, (const unsigned char*)json, &error_pointer, &global_hooks));
+    context.end = (const unsigned char*)json + strlen(json);
+    TEST_ASSERT_NULL(parse_array(item, (const unsigned char*)json, &context));
     assert_is_invalid(item);
 }
 
 static void assert_parse_array(const char *json)
 {
-    TEST_ASSERT_NOT_NULL(parse_array(item, (const unsigned char*)json, &error_pointer, &global_hooks));
+    context.end = (const unsigned char*)json + strlen(json);
+    TEST_ASSERT_NOT_NULL(parse_array(item, (const unsigned char*)json, &context));
     assert_is_array(item);
 }
 
@@ -82,7 +84,10 @@ static void parse_array_should_parse_arrays_with_one_element(void)
 
     assert_parse_array("[[]]");
     assert_has_child(item);
-    assert_is_array(item->child);
+    assert_has_type(item->child, cJSON_Array);
+    /* the only child is also the last one */
+    TEST_ASSERT_TRUE(item->child->prev == item->child);
+    TEST_ASSERT_NULL(item->child->next);
     assert_has_no_child(item->child);
     reset(item);
 
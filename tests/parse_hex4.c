@@ -64,10 +64,32 @@ static void parse_hex4_should_parse_mixed_case(void)
     TEST_ASSERT_EQUAL_INT(0xBEEF, parse_hex4((const unsigned char*)"BEEF"));
 }
 
+static void parse_hex4_should_reject_non_digits(void)
+{
+    unsigned char digits[5] = "1234";
+    unsigned int character = 0;
+    size_t position = 0;
+
+    for (position = 0; position < 4; position++)
+    {
+        for (character = 0; character < 256; character++)
+        {
+            if (isxdigit((int)character))
+            {
+                continue;
+            }
+            memcpy(digits, "1234", 4);
+            digits[position] = (unsigned char)character;
+            TEST_ASSERT_EQUAL_INT(0, parse_hex4(digits));
+        }
+    }
+}
+
 int main(void)
 {
     UNITY_BEGIN();
     RUN_TEST(parse_hex4_should_parse_all_combinations);
     RUN_TEST(parse_hex4_should_parse_mixed_case);
+    RUN_TEST(parse_hex4_should_reject_non_digits);
     return UNITY_END();
 }
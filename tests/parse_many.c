@@ -0,0 +1,145 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+typedef struct
+{
+    cJSON *documents;
+    size_t limit;
+    cJSON_bool in_arena;
+} collector;
+
+static cJSON_bool collect(cJSON *document, void *user_data)
+{
+    collector *target = (collector*)user_data;
+
+    if (target->in_arena)
+    {
+        /* arena documents can't be linked into a normal tree */
+        cJSON_AddItemToArray(target->documents, cJSON_Duplicate(document, true));
+    }
+    else
+    {
+        cJSON_AddItemToArray(target->documents, document);
+    }
+
+    return (size_t)cJSON_GetArraySize(target->documents) < target->limit;
+}
+
+static void assert_parse_many(const char * const input, const size_t length, cJSON_Arena * const arena, const char * const expected, const size_t expected_count, const int expected_code, const size_t expected_position)
+{
+    collector target;
+    cJSON_ParseError error;
+    char *printed = NULL;
+
+    target.documents = cJSON_CreateArray();
+    target.limit = (size_t)-1;
+    target.in_arena = (arena != NULL);
+
+    TEST_ASSERT_EQUAL_UINT((unsigned int)expected_count, (unsigned int)cJSON_ParseMany(input, length, arena, collect, &target, &error));
+    TEST_ASSERT_EQUAL_INT(expected_code, error.code);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)expected_position, (unsigned int)error.position);
+
+    printed = cJSON_PrintUnformatted(target.documents);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+
+    free(printed);
+    cJSON_Delete(target.documents);
+}
+
+static void parse_many_should_parse_newline_delimited_json(void)
+{
+    const char json[] = "{\"a\":1}\n{\"a\":2}\r\n\n[true,null]\n\"x\" 3.5\n";
+
+    assert_parse_many(json, sizeof(json) - 1, NULL, "[{\"a\":1},{\"a\":2},[true,null],\"x\",3.5]", 5, cJSON_Error_None, 0);
+    assert_parse_many("", 0, NULL, "[]", 0, cJSON_Error_None, 0);
+    assert_parse_many(" \n ", 3, NULL, "[]", 0, cJSON_Error_None, 0);
+}
+
+static void parse_many_should_parse_concatenated_documents(void)
+{
+    assert_parse_many("[1]{}\"a\"\"b\"true", 15, NULL, "[[1],{},\"a\",\"b\",true]", 5, cJSON_Error_None, 0);
+    /* a '\0' ends the input */
+    assert_parse_many("[1] [2]\0[3]", 11, NULL, "[[1],[2]]", 2, cJSON_Error_None, 0);
+}
+
+static void parse_many_should_stop_at_errors(void)
+{
+    const char json[] = "{\"a\":1}\n{\"a\":}\n{\"a\":3}\n";
+
+    assert_parse_many(json, sizeof(json) - 1, NULL, "[{\"a\":1}]", 1, cJSON_Error_InvalidValue, 13);
+    /* the buffer end is respected */
+    assert_parse_many("[1] [2]", 6, NULL, "[[1]]", 1, cJSON_Error_UnexpectedEnd, 6);
+}
+
+static void parse_many_should_use_the_arena(void)
+{
+    const char json[] = "{\"a\":[1,2]}\n{\"b\":\"text\"}\n";
+    cJSON_Arena *arena = cJSON_CreateArena(0);
+
+    TEST_ASSERT_NOT_NULL(arena);
+    assert_parse_many(json, sizeof(json) - 1, arena, "[{\"a\":[1,2]},{\"b\":\"text\"}]", 2, cJSON_Error_None, 0);
+    cJSON_ResetArena(arena);
+    assert_parse_many(json, sizeof(json) - 1, arena, "[{\"a\":[1,2]},{\"b\":\"text\"}]", 2, cJSON_Error_None, 0);
+    cJSON_DeleteArena(arena);
+}
+
+static void parse_many_should_be_stoppable(void)
+{
+    collector target;
+    cJSON_ParseError error;
+
+    target.documents = cJSON_CreateArray();
+    target.limit = 2;
+    target.in_arena = false;
+
+    TEST_ASSERT_EQUAL_UINT(2, (unsigned int)cJSON_ParseMany("1 2 3 4", 7, NULL, collect, &target, &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_Aborted, error.code);
+    TEST_ASSERT_EQUAL_UINT(3, (unsigned int)error.position);
+    TEST_ASSERT_EQUAL_INT(2, cJSON_GetArraySize(target.documents));
+    cJSON_Delete(target.documents);
+
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned int)cJSON_ParseMany(NULL, 0, NULL, collect, &target, &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_InvalidValue, error.code);
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned int)cJSON_ParseMany("1", 1, NULL, NULL, NULL, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(parse_many_should_parse_newline_delimited_json);
+    RUN_TEST(parse_many_should_parse_concatenated_documents);
+    RUN_TEST(parse_many_should_stop_at_errors);
+    RUN_TEST(parse_many_should_use_the_arena);
+    RUN_TEST(parse_many_should_be_stoppable);
+
+    return UNITY_END();
+}
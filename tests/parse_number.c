@@ -30,6 +30,8 @@
 
 static cJSON item[1];
 
+static parse_context context = { &global_hooks, NULL, cJSON_Error_None, NULL, NULL };
+
 static void assert_is_number(cJSON *number_item)
 {
     TEST_ASSERT_NOT_NULL_MESSAGE(number_item, "Item is NULL.");
@@ -45,7 +47,8 @@ static void assert_is_number(cJSON *number_item)
 
 static void assert_parse_number(const char *string, int integer, double real)
 {
-    TEST_ASSERT_NOT_NULL(parse_number(item, (const unsigned char*)string));
+    context.end = (const unsigned char*)string + strlen(string);
+    TEST_ASSERT_NOT_NULL(parse_number(item, (const unsigned char*)string, &context));
     assert_is_number(item);
     TEST_ASSERT_EQUAL_INT(integer, item->valueint);
     TEST_ASSERT_EQUAL_DOUBLE(real, item->valuedouble);
@@ -92,6 +95,69 @@ static void parse_number_should_parse_negative_reals(void)
     assert_parse_number("-123e-128", 0, -123e-128);
 }
 
+static void assert_parse_number_like_strtod(const char *string)
+{
+    double expected = strtod(string, NULL);
+    context.end = (const unsigned char*)string + strlen(string);
+    TEST_ASSERT_NOT_NULL(parse_number(item, (const unsigned char*)string, &context));
+    /* has to be bit exact, not only within a delta */
+    TEST_ASSERT_TRUE_MESSAGE(memcmp(&expected, &item->valuedouble, sizeof(double)) == 0, string);
+}
+
+static void parse_number_should_round_correctly(void)
+{
+    assert_parse_number_like_strtod("0.1");
+    assert_parse_number_like_strtod("0.3");
+    assert_parse_number_like_strtod("-0.0");
+    assert_parse_number_like_strtod("3.141592653589793");
+    assert_parse_number_like_strtod("123456789012345");
+    assert_parse_number_like_strtod("1234567890123456789");
+    assert_parse_number_like_strtod("9007199254740993");
+    assert_parse_number_like_strtod("0.000000000000000000000000000001");
+    assert_parse_number_like_strtod("1.7976931348623157e308");
+    assert_parse_number_like_strtod("2.2250738585072014e-308");
+    assert_parse_number_like_strtod("4.9e-324");
+    assert_parse_number_like_strtod("1e22");
+    assert_parse_number_like_strtod("1e23");
+    assert_parse_number_like_strtod("8.5e-23");
+    assert_parse_number_like_strtod("0e999999");
+    assert_parse_number_like_strtod("1e400");
+}
+
+static void parse_number_should_stop_after_the_number(void)
+{
+    const char *string = "-12.5e1,";
+    context.end = (const unsigned char*)string + strlen(string);
+    TEST_ASSERT_TRUE(parse_number(item, (const unsigned char*)string, &context) == (const unsigned char*)string + 7);
+    TEST_ASSERT_EQUAL_DOUBLE(-125.0, item->valuedouble);
+    TEST_ASSERT_EQUAL_INT(-125, item->valueint);
+
+    string = "1e";
+    context.end = (const unsigned char*)string + strlen(string);
+#ifdef CJSON_INTEGER_ONLY
+    /* without strtod, incomplete exponents and fractions are errors */
+    TEST_ASSERT_NULL(parse_number(item, (const unsigned char*)string, &context));
+#else
+    /* incomplete exponents and fractions are left to strtod, which stops before them */
+    TEST_ASSERT_TRUE(parse_number(item, (const unsigned char*)string, &context) == (const unsigned char*)string + 1);
+    TEST_ASSERT_EQUAL_DOUBLE(1.0, item->valuedouble);
+#endif
+}
+
+static void parse_number_should_not_depend_on_the_locale(void)
+{
+    if ((setlocale(LC_NUMERIC, "de_DE.UTF-8") == NULL) && (setlocale(LC_NUMERIC, "de_DE") == NULL))
+    {
+        TEST_IGNORE_MESSAGE("no locale with a ',' decimal point available");
+    }
+
+    assert_parse_number("1.5", 1, 1.5);
+    /* too long for the fast path */
+    assert_parse_number("1.00000000000000000001", 1, 1.0);
+
+    setlocale(LC_NUMERIC, "C");
+}
+
 int main(void)
 {
     /* initialize cJSON item */
@@ -102,5 +168,8 @@ int main(void)
     RUN_TEST(parse_number_should_parse_positive_integers);
     RUN_TEST(parse_number_should_parse_positive_reals);
     RUN_TEST(parse_number_should_parse_negative_reals);
+    RUN_TEST(parse_number_should_round_correctly);
+    RUN_TEST(parse_number_should_stop_after_the_number);
+    RUN_TEST(parse_number_should_not_depend_on_the_locale);
     return UNITY_END();
 }
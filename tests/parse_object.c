@@ -30,7 +30,7 @@
 
 static cJSON item[1];
 
-static const unsigned char *error_pointer = NULL;
+static parse_context context = { &global_hooks, NULL, cJSON_Error_None, NULL, NULL };
 
 static void assert_is_object(cJSON *object_item)
 {
@@ -54,14 +54,16 @@ static void assert_is_child(cJSON *child_item, const char *name, int type)
 
 static void assert_not_object(const char *json)
 {
-    TEST_ASSERT_NULL(parse_object(item, (const unsigned char*)json, &error_pointer, &global_hooks));
+    context.end = (const unsigned char*)json + strlen(json);
+    TEST_ASSERT_NULL(parse_object(item, (const unsigned char*)json, &context));
     assert_is_invalid(item);
     reset(item);
 }
 
 static void assert_parse_object(const char *json)
 {
-    TEST_ASSERT_NOT_NULL(parse_object(item, (const unsigned char*)json, &error_pointer, &global_hooks));
+    context.end = (const unsigned char*)json + strlen(json);
+    TEST_ASSERT_NOT_NULL(parse_object(item, (const unsigned char*)json, &context));
     assert_is_object(item);
 }
 
@@ -0,0 +1,158 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+/* runs the tasks backwards on the calling thread, so they can't depend on each other's order */
+static void run_backwards(void (*task)(void *task_data, size_t index), void *task_data, size_t count, void *executor_data)
+{
+    size_t *runs = (size_t*)executor_data;
+
+    while (count > 0)
+    {
+        count--;
+        task(task_data, count);
+        (*runs)++;
+    }
+}
+
+static void assert_parse_parallel(const char * const json, const size_t tasks)
+{
+    size_t runs = 0;
+    cJSON_Executor executor;
+    cJSON_ParseError expected_error;
+    cJSON_ParseError error;
+    cJSON *expected = NULL;
+    cJSON *actual = NULL;
+    char *expected_text = NULL;
+    char *actual_text = NULL;
+
+    executor.run = run_backwards;
+    executor.executor_data = &runs;
+
+    expected = cJSON_ParseWithError(json, NULL, true, &expected_error);
+    actual = cJSON_ParseParallel(json, strlen(json), &executor, tasks, &error);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(expected_error.code, error.code, json);
+    TEST_ASSERT_EQUAL_UINT_MESSAGE((unsigned int)expected_error.position, (unsigned int)error.position, json);
+    TEST_ASSERT_TRUE(runs <= tasks);
+
+    if (expected == NULL)
+    {
+        TEST_ASSERT_NULL(actual);
+        return;
+    }
+    TEST_ASSERT_NOT_NULL_MESSAGE(actual, json);
+
+    expected_text = cJSON_PrintUnformatted(expected);
+    actual_text = cJSON_PrintUnformatted(actual);
+    TEST_ASSERT_EQUAL_STRING(expected_text, actual_text);
+
+    free(expected_text);
+    free(actual_text);
+    cJSON_Delete(expected);
+    cJSON_Delete(actual);
+}
+
+static void parse_parallel_should_split_large_arrays(void)
+{
+    cJSON *records = cJSON_CreateArray();
+    cJSON *record = NULL;
+    char *json = NULL;
+    size_t tasks = 0;
+    int i = 0;
+
+    for (i = 0; i < 1000; i++)
+    {
+        record = cJSON_CreateObject();
+        cJSON_AddNumberToObject(record, "id", i);
+        cJSON_AddStringToObject(record, "name", "a \"quoted\", [bracketed] name");
+        cJSON_AddItemToObject(record, "list", cJSON_CreateIntArray(&i, 1));
+        cJSON_AddItemToArray(records, record);
+    }
+    json = cJSON_Print(records);
+    TEST_ASSERT_NOT_NULL(json);
+
+    for (tasks = 1; tasks <= 64; tasks *= 2)
+    {
+        assert_parse_parallel(json, tasks);
+    }
+    assert_parse_parallel(json, 999);
+    assert_parse_parallel(json, 5000);
+
+    free(json);
+    cJSON_Delete(records);
+}
+
+static void parse_parallel_should_handle_small_documents(void)
+{
+    assert_parse_parallel("[]", 4);
+    assert_parse_parallel(" [ ] ", 4);
+    assert_parse_parallel("[1]", 4);
+    assert_parse_parallel("[1,2,3,4,5,6,7,8]", 4);
+    assert_parse_parallel("[[1,2],[3,4],{\"a\":[5]}]", 3);
+    assert_parse_parallel("{\"a\":[1,2,3]}", 4);
+    assert_parse_parallel("\"string\"", 4);
+    assert_parse_parallel("1.5", 4);
+}
+
+static void parse_parallel_should_report_errors_like_the_parser(void)
+{
+    const char *invalid[] = {
+        "[1,2,3,4,5,6,7,x]",
+        "[1,2,3,4,5,6,7,]",
+        "[1,,2,3,4,5,6,7]",
+        "[1,2,3,4 5,6,7,8]",
+        "[1,2,3,4,5,6,7,8}",
+        "[[1,2},3,4,5,6,7,8]",
+        "[1,2,3,4,5,6,7,8] x",
+        "[1,2,3,4,5,6,7,8",
+        "[\"1,2,3,4,5,6,7,8]",
+        "[1,2,3,{\"a\" 4},5,6,7,8]",
+        ""
+    };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(invalid) / sizeof(invalid[0])); i++)
+    {
+        assert_parse_parallel(invalid[i], 8);
+    }
+
+    TEST_ASSERT_NULL(cJSON_ParseParallel(NULL, 0, NULL, 4, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(parse_parallel_should_split_large_arrays);
+    RUN_TEST(parse_parallel_should_handle_small_documents);
+    RUN_TEST(parse_parallel_should_report_errors_like_the_parser);
+
+    return UNITY_END();
+}
@@ -30,7 +30,7 @@
 
 static cJSON item[1];
 
-static const unsigned char *error_pointer = NULL;
+static parse_context context = { &global_hooks, NULL, cJSON_Error_None, NULL, NULL };
 
 static void assert_is_string(cJSON *string_item)
 {
@@ -47,7 +47,8 @@ static void assert_is_string(cJSON *string_item)
 
 static void assert_parse_string(const char *string, const char *expected)
 {
-    TEST_ASSERT_NOT_NULL_MESSAGE(parse_string(item, (const unsigned char*)string, &error_pointer, &global_hooks), "Couldn't parse string.");
+    context.end = (const unsigned char*)string + strlen(string);
+    TEST_ASSERT_NOT_NULL_MESSAGE(parse_string(item, (const unsigned char*)string, &context), "Couldn't parse string.");
     assert_is_string(item);
     TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, item->valuestring, "The parsed result isn't as expected.");
     global_hooks.deallocate(item->valuestring);
@@ -55,7 +56,8 @@ static void assert_parse_string(const char *string, const char *expected)
 }
 
 #define assert_not_parse_string(string) \
-    TEST_ASSERT_NULL_MESSAGE(parse_string(item, (const unsigned char*)string, &error_pointer, &global_hooks), "Malformed string should not be accepted");\
+    context.end = (const unsigned char*)string + strlen(string);\
+    TEST_ASSERT_NULL_MESSAGE(parse_string(item, (const unsigned char*)string, &context), "Malformed string should not be accepted");\
     assert_is_invalid(item)
 
 
@@ -80,6 +82,78 @@ static void parse_string_should_parse_utf16_surrogate_pairs(void)
     reset(item);
 }
 
+/* the straightforward encoding to compare the decoder against */
+static size_t encode_utf8(unsigned long codepoint, unsigned char *output)
+{
+    if (codepoint < 0x80)
+    {
+        output[0] = (unsigned char)codepoint;
+        return 1;
+    }
+    if (codepoint < 0x800)
+    {
+        output[0] = (unsigned char)(0xC0 | (codepoint >> 6));
+        output[1] = (unsigned char)(0x80 | (codepoint & 0x3F));
+        return 2;
+    }
+    if (codepoint < 0x10000)
+    {
+        output[0] = (unsigned char)(0xE0 | (codepoint >> 12));
+        output[1] = (unsigned char)(0x80 | ((codepoint >> 6) & 0x3F));
+        output[2] = (unsigned char)(0x80 | (codepoint & 0x3F));
+        return 3;
+    }
+    output[0] = (unsigned char)(0xF0 | (codepoint >> 18));
+    output[1] = (unsigned char)(0x80 | ((codepoint >> 12) & 0x3F));
+    output[2] = (unsigned char)(0x80 | ((codepoint >> 6) & 0x3F));
+    output[3] = (unsigned char)(0x80 | (codepoint & 0x3F));
+    return 4;
+}
+
+static void parse_string_should_decode_every_utf16_escape(void)
+{
+    unsigned char escape[13];
+    unsigned char expected[4];
+    unsigned char decoded[4];
+    unsigned char *decoded_pointer = NULL;
+    unsigned long code = 0;
+    unsigned long low = 0;
+    size_t length = 0;
+
+    for (code = 1; code <= 0xFFFF; code++)
+    {
+        sprintf((char*)escape, (code & 1) ? "\\u%04lx" : "\\u%04lX", code);
+        decoded_pointer = decoded;
+        if ((code >= 0xD800) && (code <= 0xDFFF))
+        {
+            /* lone surrogates */
+            TEST_ASSERT_EQUAL_INT(0, utf16_literal_to_utf8(escape, escape + 6, &decoded_pointer));
+            continue;
+        }
+        length = encode_utf8(code, expected);
+        TEST_ASSERT_EQUAL_INT(6, utf16_literal_to_utf8(escape, escape + 6, &decoded_pointer));
+        TEST_ASSERT_EQUAL_INT(length, decoded_pointer - decoded);
+        TEST_ASSERT_EQUAL_MEMORY(expected, decoded, length);
+    }
+
+    for (code = 0xD800; code <= 0xDBFF; code++)
+    {
+        for (low = 0xDC00; low <= 0xDFFF; low += 0x3F)
+        {
+            sprintf((char*)escape, "\\u%04lX\\u%04lx", code, low);
+            decoded_pointer = decoded;
+            length = encode_utf8(0x10000 + ((code & 0x3FF) << 10) + (low & 0x3FF), expected);
+            TEST_ASSERT_EQUAL_INT(12, utf16_literal_to_utf8(escape, escape + 12, &decoded_pointer));
+            TEST_ASSERT_EQUAL_INT(4, decoded_pointer - decoded);
+            TEST_ASSERT_EQUAL_MEMORY(expected, decoded, 4);
+        }
+        sprintf((char*)escape, "\\u%04lX\\u0041", code);
+        decoded_pointer = decoded;
+        TEST_ASSERT_EQUAL_INT(0, utf16_literal_to_utf8(escape, escape + 12, &decoded_pointer));
+        TEST_ASSERT_EQUAL_INT(0, utf16_literal_to_utf8(escape, escape + 11, &decoded_pointer));
+    }
+}
+
 static void parse_string_should_not_parse_non_strings(void)
 {
     assert_not_parse_string("this\" is not a string\"");
@@ -109,6 +183,82 @@ static void parse_string_should_parse_bug_94(void)
     reset(item);
 }
 
+static void parse_string_should_parse_long_strings(void)
+{
+    /* escape sequences at every offset relative to the 16 byte chunks */
+    char json[64];
+    char expected[64];
+    size_t offset = 0;
+
+    for (offset = 0; offset < 40; offset++)
+    {
+        memset(json, 'a', sizeof(json));
+        memset(expected, 'a', sizeof(expected));
+        json[0] = '\"';
+        json[offset + 1] = '\\';
+        json[offset + 2] = 'n';
+        json[50] = '\"';
+        json[51] = '\0';
+        expected[offset] = '\n';
+        expected[48] = '\0';
+        assert_parse_string(json, expected);
+
+        /* closing quote at every offset */
+        memset(json, 'b', sizeof(json));
+        memset(expected, 'b', sizeof(expected));
+        json[0] = '\"';
+        json[offset + 1] = '\"';
+        json[offset + 2] = '\0';
+        expected[offset] = '\0';
+        assert_parse_string(json, expected);
+    }
+    reset(item);
+}
+
+static void parse_string_should_not_read_past_the_end(void)
+{
+    /* exactly sized buffer without null terminator */
+    const char string[] = "\"0123456789abcdef0123456789abcdef0123456789abcdef";
+    unsigned char *buffer = (unsigned char*)malloc(sizeof(string) - 1);
+    TEST_ASSERT_NOT_NULL(buffer);
+    memcpy(buffer, string, sizeof(string) - 1);
+
+    context.end = buffer + sizeof(string) - 1;
+    TEST_ASSERT_NULL(parse_string(item, buffer, &context));
+    TEST_ASSERT_TRUE(context.error_position == context.end);
+
+    buffer[sizeof(string) - 2] = '\\';
+    TEST_ASSERT_NULL(parse_string(item, buffer, &context));
+    TEST_ASSERT_TRUE(context.error_position == context.end);
+
+    free(buffer);
+    reset(item);
+}
+
+static void parse_string_should_unescape_in_situ(void)
+{
+    char string[] = "\"a\\tb\\u20AC\\uD83D\\udc31c\" rest";
+    internal_hooks in_situ_hooks = global_hooks;
+    parse_context in_situ_context = { NULL, NULL, cJSON_Error_None, NULL, NULL };
+    const unsigned char *end = NULL;
+
+    in_situ_hooks.in_situ = (unsigned char*)string;
+    in_situ_context.hooks = &in_situ_hooks;
+    in_situ_context.end = (const unsigned char*)string + strlen(string);
+
+    end = parse_string(item, (const unsigned char*)string, &in_situ_context);
+    TEST_ASSERT_NOT_NULL(end);
+    TEST_ASSERT_EQUAL_STRING(" rest", (const char*)end);
+    assert_has_type(item, cJSON_String);
+    TEST_ASSERT_BITS_HIGH(cJSON_IsReference, item->type);
+    TEST_ASSERT_TRUE(item->valuestring == (string + 1));
+    TEST_ASSERT_EQUAL_STRING("a\tb\xE2\x82\xAC\xF0\x9F\x90\xB1" "c", item->valuestring);
+
+    /* the string belongs to the input */
+    item->valuestring = NULL;
+    reset(item);
+}
+
 int main(void)
 {
     /* initialize cJSON item and error pointer */
@@ -117,9 +267,13 @@ int main(void)
     UNITY_BEGIN();
     RUN_TEST(parse_string_should_parse_strings);
     RUN_TEST(parse_string_should_parse_utf16_surrogate_pairs);
+    RUN_TEST(parse_string_should_decode_every_utf16_escape);
     RUN_TEST(parse_string_should_not_parse_non_strings);
     RUN_TEST(parse_string_should_not_parse_invalid_backslash);
     RUN_TEST(parse_string_should_parse_bug_94);
     RUN_TEST(parse_string_should_not_overflow_with_closing_backslash);
+    RUN_TEST(parse_string_should_parse_long_strings);
+    RUN_TEST(parse_string_should_not_read_past_the_end);
+    RUN_TEST(parse_string_should_unescape_in_situ);
     return UNITY_END();
 }
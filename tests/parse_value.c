@@ -29,7 +29,7 @@
 #include "common.h"
 
 static cJSON item[1];
-const unsigned char *error_pointer = NULL;
+static parse_context context = { &global_hooks, NULL, cJSON_Error_None, NULL, NULL };
 
 static void assert_is_value(cJSON *value_item, int type)
 {
@@ -44,7 +44,8 @@ static void assert_is_value(cJSON *value_item, int type)
 
 static void assert_parse_value(const char *string, int type)
 {
-    TEST_ASSERT_NOT_NULL(parse_value(item, (const unsigned char*)string, &error_pointer, &global_hooks));
+    context.end = (const unsigned char*)string + strlen(string);
+    TEST_ASSERT_NOT_NULL(parse_value(item, (const unsigned char*)string, &context));
     assert_is_value(item, type);
 }
 
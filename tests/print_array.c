@@ -29,26 +29,29 @@ static void assert_print_array(const char * const expected, const char * const i
     unsigned char printed_unformatted[1024];
     unsigned char printed_formatted[1024];
 
-    const unsigned char *error_pointer;
+    parse_context context = { &global_hooks, NULL, cJSON_Error_None, NULL, NULL };
     cJSON item[1];
 
     printbuffer formatted_buffer;
     printbuffer unformatted_buffer;
 
     /* buffer for formatted printing */
+    memset(&formatted_buffer, 0, sizeof(formatted_buffer));
     formatted_buffer.buffer = printed_formatted;
     formatted_buffer.length = sizeof(printed_formatted);
     formatted_buffer.offset = 0;
     formatted_buffer.noalloc = true;
 
     /* buffer for unformatted printing */
+    memset(&unformatted_buffer, 0, sizeof(unformatted_buffer));
     unformatted_buffer.buffer = printed_unformatted;
     unformatted_buffer.length = sizeof(printed_unformatted);
     unformatted_buffer.offset = 0;
     unformatted_buffer.noalloc = true;
 
     memset(item, 0, sizeof(item));
-    TEST_ASSERT_NOT_NULL_MESSAGE(parse_array(item, (const unsigned char*)input, &error_pointer, &global_hooks), "Failed to parse array.");
+    context.end = (const unsigned char*)input + strlen(input);
+    TEST_ASSERT_NOT_NULL_MESSAGE(parse_array(item, (const unsigned char*)input, &context), "Failed to parse array.");
 
     TEST_ASSERT_TRUE_MESSAGE(print_array(item, 0, false, &unformatted_buffer, &global_hooks), "Failed to print unformatted string.");
     TEST_ASSERT_EQUAL_STRING_MESSAGE(input, printed_unformatted, "Unformatted array is not correct.");
@@ -0,0 +1,221 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static void assert_print_cached(cJSON_PrintCache * const cache, cJSON * const item, const cJSON_bool format)
+{
+    char *expected = format ? cJSON_Print(item) : cJSON_PrintUnformatted(item);
+    char *actual = cJSON_PrintWithCache(cache, item, format);
+
+    TEST_ASSERT_NOT_NULL(actual);
+    TEST_ASSERT_EQUAL_STRING(expected, actual);
+    free(expected);
+    free(actual);
+}
+
+static void assert_prints_like_the_printer(cJSON_PrintCache * const cache, cJSON * const item)
+{
+    /* twice, the second time from the cache */
+    assert_print_cached(cache, item, true);
+    assert_print_cached(cache, item, true);
+    assert_print_cached(cache, item, false);
+    assert_print_cached(cache, item, false);
+}
+
+static void print_cache_should_match_the_printer(void)
+{
+    const char *documents[] = { "[]", "{}", "[1,[],{}]", "{\"a\":{\"b\":[1,{\"c\":null}]},\"d\":[[[true]]]}", "\"string\"", "1.5" };
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5", "inputs/test7" };
+    cJSON_PrintCache *cache = NULL;
+    cJSON *item = NULL;
+    char *json = NULL;
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(documents) / sizeof(documents[0])); i++)
+    {
+        cache = cJSON_CreatePrintCache();
+        item = cJSON_Parse(documents[i]);
+        TEST_ASSERT_NOT_NULL(cache);
+        TEST_ASSERT_NOT_NULL(item);
+        assert_prints_like_the_printer(cache, item);
+        cJSON_Delete(item);
+        cJSON_DeletePrintCache(cache);
+    }
+
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        cache = cJSON_CreatePrintCache();
+        json = read_file(files[i]);
+        TEST_ASSERT_NOT_NULL(json);
+        item = cJSON_Parse(json);
+        TEST_ASSERT_NOT_NULL(item);
+        assert_prints_like_the_printer(cache, item);
+        cJSON_Delete(item);
+        free(json);
+        cJSON_DeletePrintCache(cache);
+    }
+}
+
+static void print_cache_should_follow_changes(void)
+{
+    cJSON_PrintCache *cache = cJSON_CreatePrintCache();
+    cJSON *item = cJSON_Parse("{\"a\":{\"b\":[1,2,{\"c\":3}]},\"d\":{\"e\":\"x\",\"f\":[]},\"g\":[[4],[5]]}");
+    cJSON *b = NULL;
+    cJSON *moved = NULL;
+
+    TEST_ASSERT_NOT_NULL(cache);
+    TEST_ASSERT_NOT_NULL(item);
+    b = cJSON_GetObjectItem(cJSON_GetObjectItem(item, "a"), "b");
+    assert_prints_like_the_printer(cache, item);
+
+    cJSON_SetNumberValue(cJSON_GetObjectItem(cJSON_GetArrayItem(b, 2), "c"), 33);
+    assert_prints_like_the_printer(cache, item);
+
+    cJSON_AddItemToArray(b, cJSON_CreateString("added"));
+    assert_prints_like_the_printer(cache, item);
+
+    cJSON_InsertItemInArray(cJSON_GetArrayItem(cJSON_GetObjectItem(item, "g"), 1), 0, cJSON_CreateNull());
+    assert_prints_like_the_printer(cache, item);
+
+    cJSON_ReplaceItemInObject(cJSON_GetObjectItem(item, "d"), "e", cJSON_CreateString("y"));
+    assert_prints_like_the_printer(cache, item);
+
+    cJSON_AddItemToArray(cJSON_GetObjectItem(cJSON_GetObjectItem(item, "d"), "f"), cJSON_CreateTrue());
+    assert_prints_like_the_printer(cache, item);
+
+    cJSON_DeleteItemFromArray(b, 0);
+    assert_prints_like_the_printer(cache, item);
+
+    /* unchanged, but at a different depth */
+    moved = cJSON_DetachItemFromObject(item, "g");
+    cJSON_AddItemToArray(b, moved);
+    assert_prints_like_the_printer(cache, item);
+    cJSON_AddItemToObject(item, "g", cJSON_DetachItemViaPointer(b, moved));
+    assert_prints_like_the_printer(cache, item);
+
+    cJSON_Delete(item);
+    cJSON_DeletePrintCache(cache);
+}
+
+static void print_cache_should_copy_unchanged_text(void)
+{
+    cJSON_PrintCache *cache = cJSON_CreatePrintCache();
+    cJSON *item = cJSON_Parse("{\"a\":[1,2],\"b\":[{\"c\":3}]}");
+    cJSON *a = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(item);
+    a = cJSON_GetObjectItem(item, "a");
+    printed = cJSON_PrintWithCache(cache, item, false);
+    free(printed);
+    TEST_ASSERT_TRUE(item->type & cJSON_IsRendered);
+    TEST_ASSERT_TRUE(a->child->type & cJSON_IsRendered);
+    TEST_ASSERT_EQUAL_UINT(4, (unsigned int)cache->count);
+
+    /* changing a field directly isn't noticed */
+    a->child->valuedouble = 10;
+    a->child->valueint = 10;
+    printed = cJSON_PrintWithCache(cache, item, false);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":[1,2],\"b\":[{\"c\":3}]}", printed);
+    free(printed);
+
+    /* only what was changed is printed again */
+    cJSON_SetNumberValue(cJSON_GetObjectItem(cJSON_GetArrayItem(cJSON_GetObjectItem(item, "b"), 0), "c"), 30);
+    TEST_ASSERT_FALSE(cJSON_GetObjectItem(cJSON_GetArrayItem(cJSON_GetObjectItem(item, "b"), 0), "c")->type & cJSON_IsRendered);
+    printed = cJSON_PrintWithCache(cache, item, false);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":[1,2],\"b\":[{\"c\":30}]}", printed);
+    free(printed);
+
+    cJSON_SetNumberValue(a->child, 10);
+    printed = cJSON_PrintWithCache(cache, item, false);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":[10,2],\"b\":[{\"c\":30}]}", printed);
+    free(printed);
+
+    /* the text of items that aren't in the tree anymore is dropped */
+    cJSON_DeleteItemFromObject(item, "b");
+    printed = cJSON_PrintWithCache(cache, item, false);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":[10,2]}", printed);
+    free(printed);
+    TEST_ASSERT_EQUAL_UINT(2, (unsigned int)cache->count);
+
+    cJSON_Delete(item);
+    cJSON_DeletePrintCache(cache);
+}
+
+static void print_cache_should_print_packed_and_lazy_arrays(void)
+{
+    const double numbers[] = { 1, 2, 3 };
+    const char json[] = "{\"lazy\":[{\"a\":[1,2]},\"b\"]}";
+    cJSON_PrintCache *cache = cJSON_CreatePrintCache();
+    cJSON *item = cJSON_ParseLazy(json, sizeof(json) - 1);
+    cJSON *packed = cJSON_CreatePackedArray(numbers, 3);
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_NOT_NULL(packed);
+    cJSON_AddItemToObject(item, "packed", packed);
+    printed = cJSON_PrintWithCache(cache, item, false);
+    TEST_ASSERT_EQUAL_STRING("{\"lazy\":[{\"a\":[1,2]},\"b\"],\"packed\":[1,2,3]}", printed);
+    free(printed);
+
+    cJSON_GetPackedNumbers(packed)[1] = 20;
+    printed = cJSON_PrintWithCache(cache, item, false);
+    TEST_ASSERT_EQUAL_STRING("{\"lazy\":[{\"a\":[1,2]},\"b\"],\"packed\":[1,20,3]}", printed);
+    free(printed);
+    assert_prints_like_the_printer(cache, item);
+
+    cJSON_Delete(item);
+    cJSON_DeletePrintCache(cache);
+}
+
+static void print_cache_should_fail_on_invalid_arguments(void)
+{
+    cJSON_PrintCache *cache = cJSON_CreatePrintCache();
+    cJSON *item = cJSON_CreateArray();
+
+    TEST_ASSERT_NULL(cJSON_PrintWithCache(NULL, item, false));
+    TEST_ASSERT_NULL(cJSON_PrintWithCache(cache, NULL, false));
+    cJSON_DeletePrintCache(NULL);
+
+    cJSON_Delete(item);
+    cJSON_DeletePrintCache(cache);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(print_cache_should_match_the_printer);
+    RUN_TEST(print_cache_should_follow_changes);
+    RUN_TEST(print_cache_should_copy_unchanged_text);
+    RUN_TEST(print_cache_should_print_packed_and_lazy_arrays);
+    RUN_TEST(print_cache_should_fail_on_invalid_arguments);
+
+    return UNITY_END();
+}
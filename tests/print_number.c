@@ -29,6 +29,7 @@ static void assert_print_number(const char *expected, double input)
     unsigned char printed[1024];
     cJSON item[1];
     printbuffer buffer;
+    memset(&buffer, 0, sizeof(buffer));
     buffer.buffer = printed;
     buffer.length = sizeof(printed);
     buffer.offset = 0;
@@ -63,19 +64,20 @@ static void print_number_should_print_positive_integers(void)
 static void print_number_should_print_positive_reals(void)
 {
     assert_print_number("0.123", 0.123);
-    assert_print_number("1.000000e-09", 10e-10);
+    assert_print_number("1e-09", 10e-10);
     assert_print_number("1000000000000", 10e11);
-    assert_print_number("1.230000e+129", 123e+127);
-    assert_print_number("0", 123e-128); /* TODO: Maybe this shouldn't be 0 */
+    assert_print_number("1.23e+129", 123e+127);
+    assert_print_number("1.23e-126", 123e-128);
+    assert_print_number("3.14", 3.14);
 }
 
 static void print_number_should_print_negative_reals(void)
 {
     assert_print_number("-0.0123", -0.0123);
-    assert_print_number("-1.000000e-09", -10e-10);
-    assert_print_number("-1000000000000000000000", -10e20);
-    assert_print_number("-1.230000e+129", -123e+127);
-    assert_print_number("-1.230000e-126", -123e-128);
+    assert_print_number("-1e-09", -10e-10);
+    assert_print_number("-1e+21", -10e20);
+    assert_print_number("-1.23e+129", -123e+127);
+    assert_print_number("-1.23e-126", -123e-128);
 }
 
 static void print_number_should_print_non_number(void)
@@ -87,19 +89,56 @@ static void print_number_should_print_non_number(void)
     /* assert_print_number("null", -INFTY); */
 }
 
-static void trim_trailing_zeroes_should_trim_trailing_zeroes(void)
+static void print_number_should_print_the_shortest_representation(void)
 {
+    assert_print_number("0.1", 0.1);
+    assert_print_number("0.30000000000000004", 0.1 + 0.2);
+    assert_print_number("123456.789", 123456.789);
+    assert_print_number("1e+300", 1e300);
+    assert_print_number("2147483648", 2147483648.0);
+    assert_print_number("9007199254740992", 9007199254740992.0);
+    assert_print_number("1e+15", 1e15);
+    assert_print_number("1.7976931348623157e+308", 1.7976931348623157e308);
+#ifndef CJSON_INTEGER_ONLY
+    /* Grisu3 isn't sure about this one, so it is found with printf */
+    assert_print_number("421.6238993710692", 421.6238993710692);
+#else
+    /* without printf it gets digits that round trip, just not the shortest ones */
+    assert_print_number("421.62389937106917", 421.6238993710692);
+#endif
+}
+
+static void print_number_should_print_the_shortest_representation_of_subnormal_numbers(void)
+{
+    assert_print_number("5e-324", 5e-324);
+    assert_print_number("-5e-324", -5e-324);
+    assert_print_number("1e-310", 1e-310);
+    assert_print_number("2.225073858507201e-308", 2.225073858507201e-308);
+    assert_print_number("2.2250738585072014e-308", 2.2250738585072014e-308);
+}
+
+static void print_number_should_round_trip(void)
+{
+    const double numbers[] = { 0.1, 1.0 / 3.0, 2.0 / 3.0, 3.141592653589793, 1.7976931348623157e308, 2.2250738585072014e-308, 4.9e-324, 123456789.123456789, -0.000123456789 };
+    unsigned char printed[64];
     printbuffer buffer;
-    unsigned char number[100];
-    buffer.length = sizeof(number);
-    buffer.buffer = number;
-
-    strcpy((char*)number, "10.00");
-    buffer.offset = sizeof("10.00") - 1;
-    TEST_ASSERT_TRUE(trim_trailing_zeroes(&buffer));
-    TEST_ASSERT_EQUAL_UINT8('\0', buffer.buffer[buffer.offset]);
-    TEST_ASSERT_EQUAL_STRING("10", number);
-    TEST_ASSERT_EQUAL_UINT(sizeof("10") - 1, buffer.offset);
+    cJSON item[1];
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(numbers) / sizeof(numbers[0])); i++)
+    {
+        memset(&buffer, 0, sizeof(buffer));
+        buffer.buffer = printed;
+        buffer.length = sizeof(printed);
+        buffer.offset = 0;
+        buffer.noalloc = true;
+        memset(item, 0, sizeof(item));
+        cJSON_SetNumberValue(item, numbers[i]);
+
+        TEST_ASSERT_TRUE(print_number(item, &buffer, &global_hooks));
+        TEST_ASSERT_EQUAL_UINT(strlen((const char*)printed), buffer.offset);
+        TEST_ASSERT_TRUE_MESSAGE(strtod((const char*)printed, NULL) == numbers[i], (const char*)printed);
+    }
 }
 
 int main(void)
@@ -113,7 +152,9 @@ int main(void)
     RUN_TEST(print_number_should_print_positive_reals);
     RUN_TEST(print_number_should_print_negative_reals);
     RUN_TEST(print_number_should_print_non_number);
-    RUN_TEST(trim_trailing_zeroes_should_trim_trailing_zeroes);
+    RUN_TEST(print_number_should_print_the_shortest_representation);
+    RUN_TEST(print_number_should_print_the_shortest_representation_of_subnormal_numbers);
+    RUN_TEST(print_number_should_round_trip);
 
     return UNITY_END();
 }
@@ -29,26 +29,29 @@ static void assert_print_object(const char * const expected, const char * const
     unsigned char printed_unformatted[1024];
     unsigned char printed_formatted[1024];
 
-    const unsigned char *error_pointer;
+    parse_context context = { &global_hooks, NULL, cJSON_Error_None, NULL, NULL };
     cJSON item[1];
 
     printbuffer formatted_buffer;
     printbuffer unformatted_buffer;
 
     /* buffer for formatted printing */
+    memset(&formatted_buffer, 0, sizeof(formatted_buffer));
     formatted_buffer.buffer = printed_formatted;
     formatted_buffer.length = sizeof(printed_formatted);
     formatted_buffer.offset = 0;
     formatted_buffer.noalloc = true;
 
     /* buffer for unformatted printing */
+    memset(&unformatted_buffer, 0, sizeof(unformatted_buffer));
     unformatted_buffer.buffer = printed_unformatted;
     unformatted_buffer.length = sizeof(printed_unformatted);
     unformatted_buffer.offset = 0;
     unformatted_buffer.noalloc = true;
 
     memset(item, 0, sizeof(item));
-    TEST_ASSERT_NOT_NULL_MESSAGE(parse_object(item, (const unsigned char*)input, &error_pointer, &global_hooks), "Failed to parse object.");
+    context.end = (const unsigned char*)input + strlen(input);
+    TEST_ASSERT_NOT_NULL_MESSAGE(parse_object(item, (const unsigned char*)input, &context), "Failed to parse object.");
 
     TEST_ASSERT_TRUE_MESSAGE(print_object(item, 0, false, &unformatted_buffer, &global_hooks), "Failed to print unformatted string.");
     TEST_ASSERT_EQUAL_STRING_MESSAGE(input, printed_unformatted, "Unformatted object is not correct.");
@@ -79,6 +82,68 @@ static void print_object_should_print_objects_with_multiple_elements(void)
     assert_print_object("{\n\t\"one\":\t1,\n\t\"NULL\":\tnull,\n\t\"TRUE\":\ttrue,\n\t\"FALSE\":\tfalse,\n\t\"array\":\t[],\n\t\"world\":\t\"hello\",\n\t\"object\":\t{\n\t}\n}", "{\"one\":1,\"NULL\":null,\"TRUE\":true,\"FALSE\":false,\"array\":[],\"world\":\"hello\",\"object\":{}}");
 }
 
+static void print_object_should_print_shared_names_of_many_records(void)
+{
+    static const char *names[40];
+    static char storage[40][8];
+    static const char long_name[] = "a name that is too long to be kept with the other rendered names";
+    cJSON *shared = cJSON_CreateArray();
+    cJSON *copied = cJSON_CreateArray();
+    cJSON_KeyTable *table = cJSON_CreateKeyTable();
+    cJSON *interned = NULL;
+    char *expected = NULL;
+    char *printed = NULL;
+    int i = 0;
+    int j = 0;
+
+    for (j = 0; j < 40; j++)
+    {
+        sprintf(storage[j], "k%d", j);
+        names[j] = storage[j];
+    }
+    /* more names than the cache has slots, some of them escaped */
+    names[3] = "quote\"d";
+    names[4] = "\t\x01";
+    names[5] = long_name;
+    for (i = 0; i < 100; i++)
+    {
+        cJSON *record = cJSON_CreateObject();
+        cJSON *copy = cJSON_CreateObject();
+        for (j = 0; j < 40; j++)
+        {
+            cJSON_AddItemToObjectCS(record, names[j], cJSON_CreateNumber(i + j));
+            cJSON_AddItemToObject(copy, names[j], cJSON_CreateNumber(i + j));
+        }
+        cJSON_AddItemToArray(shared, record);
+        cJSON_AddItemToArray(copied, copy);
+    }
+
+    expected = cJSON_PrintUnformatted(copied);
+    printed = cJSON_PrintUnformatted(shared);
+    TEST_ASSERT_NOT_NULL(expected);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+    global_hooks.deallocate(printed);
+
+    /* interned names are shared as well */
+    interned = cJSON_ParseWithKeyTable(table, expected, strlen(expected), NULL, true);
+    TEST_ASSERT_NOT_NULL(interned);
+    printed = cJSON_PrintUnformatted(interned);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+    global_hooks.deallocate(printed);
+    global_hooks.deallocate(expected);
+
+    expected = cJSON_Print(copied);
+    printed = cJSON_PrintBuffered(shared, 16, true);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+    global_hooks.deallocate(printed);
+    global_hooks.deallocate(expected);
+
+    cJSON_Delete(interned);
+    cJSON_DeleteKeyTable(table);
+    cJSON_Delete(copied);
+    cJSON_Delete(shared);
+}
+
 int main(void)
 {
     /* initialize cJSON item */
@@ -87,6 +152,7 @@ int main(void)
     RUN_TEST(print_object_should_print_empty_objects);
     RUN_TEST(print_object_should_print_objects_with_one_element);
     RUN_TEST(print_object_should_print_objects_with_multiple_elements);
+    RUN_TEST(print_object_should_print_shared_names_of_many_records);
 
     return UNITY_END();
 }
@@ -0,0 +1,151 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+/* runs the tasks backwards on the calling thread, so they can't depend on each other's order */
+static void run_backwards(void (*task)(void *task_data, size_t index), void *task_data, size_t count, void *executor_data)
+{
+    size_t *runs = (size_t*)executor_data;
+
+    while (count > 0)
+    {
+        count--;
+        task(task_data, count);
+        (*runs)++;
+    }
+}
+
+static void assert_print_parallel(const cJSON * const item, const size_t tasks)
+{
+    size_t runs = 0;
+    cJSON_Executor executor;
+    char *expected = NULL;
+    char *actual = NULL;
+
+    executor.run = run_backwards;
+    executor.executor_data = &runs;
+
+    expected = cJSON_Print(item);
+    actual = cJSON_PrintParallel(item, true, &executor, tasks);
+    TEST_ASSERT_NOT_NULL(actual);
+    TEST_ASSERT_EQUAL_STRING(expected, actual);
+    free(expected);
+    free(actual);
+
+    expected = cJSON_PrintUnformatted(item);
+    actual = cJSON_PrintParallel(item, false, &executor, tasks);
+    TEST_ASSERT_NOT_NULL(actual);
+    TEST_ASSERT_EQUAL_STRING(expected, actual);
+    free(expected);
+    free(actual);
+
+    TEST_ASSERT_TRUE(runs <= (2 * tasks));
+}
+
+static void print_parallel_should_match_the_printer(void)
+{
+    cJSON *records = cJSON_CreateArray();
+    cJSON *object = cJSON_CreateObject();
+    cJSON *record = NULL;
+    size_t tasks = 0;
+    char name[16];
+    int i = 0;
+
+    for (i = 0; i < 1000; i++)
+    {
+        record = cJSON_CreateObject();
+        cJSON_AddNumberToObject(record, "id", i);
+        cJSON_AddStringToObject(record, "name", "a \"quoted\"\n name");
+        cJSON_AddItemToObject(record, "list", cJSON_CreateIntArray(&i, 1));
+        cJSON_AddItemToObject(record, "empty", cJSON_CreateObject());
+        cJSON_AddItemToArray(records, record);
+
+        sprintf(name, "member%d", i);
+        cJSON_AddItemToObject(object, name, cJSON_Duplicate(record, true));
+    }
+
+    for (tasks = 1; tasks <= 64; tasks *= 2)
+    {
+        assert_print_parallel(records, tasks);
+        assert_print_parallel(object, tasks);
+    }
+    assert_print_parallel(records, 999);
+    assert_print_parallel(object, 5000);
+
+    cJSON_Delete(records);
+    cJSON_Delete(object);
+}
+
+static void print_parallel_should_handle_small_documents(void)
+{
+    const char *documents[] = { "[]", "{}", "[1]", "[1,2,3]", "{\"a\":{\"b\":[]},\"c\":null}", "\"string\"", "1.5", "true" };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(documents) / sizeof(documents[0])); i++)
+    {
+        cJSON *item = cJSON_Parse(documents[i]);
+        TEST_ASSERT_NOT_NULL(item);
+        assert_print_parallel(item, 4);
+        cJSON_Delete(item);
+    }
+
+    TEST_ASSERT_NULL(cJSON_PrintParallel(NULL, true, NULL, 4));
+}
+
+static void print_parallel_should_load_lazy_documents(void)
+{
+    const char json[] = "[{\"a\":[1,2]},[3,{\"b\":4}],5,\"six\"]";
+    cJSON *lazy = cJSON_ParseLazy(json, sizeof(json) - 1);
+    cJSON_Executor executor;
+    size_t runs = 0;
+    char *printed = NULL;
+
+    executor.run = run_backwards;
+    executor.executor_data = &runs;
+
+    TEST_ASSERT_NOT_NULL(lazy);
+    printed = cJSON_PrintParallel(lazy, false, &executor, 3);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    TEST_ASSERT_EQUAL_UINT(3, (unsigned int)runs);
+
+    free(printed);
+    cJSON_Delete(lazy);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(print_parallel_should_match_the_printer);
+    RUN_TEST(print_parallel_should_handle_small_documents);
+    RUN_TEST(print_parallel_should_load_lazy_documents);
+
+    return UNITY_END();
+}
@@ -28,6 +28,7 @@ static void assert_print_string(const char *expected, const char *input)
 {
     unsigned char printed[1024];
     printbuffer buffer;
+    memset(&buffer, 0, sizeof(buffer));
     buffer.buffer = printed;
     buffer.length = sizeof(printed);
     buffer.offset = 0;
@@ -64,6 +65,29 @@ static void print_string_should_print_utf8(void)
     assert_print_string("\"ü猫慕\"", "ü猫慕");
 }
 
+static void print_string_should_escape_long_strings(void)
+{
+    char input[64];
+    char expected[80];
+    size_t offset = 0;
+
+    /* character to escape at every offset relative to the 16 byte chunks, with UTF-8 around it */
+    for (offset = 0; offset < 40; offset++)
+    {
+        memset(input, '\xC3', 48);
+        input[offset] = '\"';
+        input[48] = '\0';
+        expected[0] = '\"';
+        memset(expected + 1, '\xC3', 48);
+        expected[offset + 1] = '\\';
+        expected[offset + 2] = '\"';
+        memset(expected + offset + 3, '\xC3', 48 - offset - 1);
+        expected[50] = '\"';
+        expected[51] = '\0';
+        assert_print_string(expected, input);
+    }
+}
+
 int main(void)
 {
     /* initialize cJSON item */
@@ -72,6 +96,7 @@ int main(void)
     RUN_TEST(print_string_should_print_empty_strings);
     RUN_TEST(print_string_should_print_ascii);
     RUN_TEST(print_string_should_print_utf8);
+    RUN_TEST(print_string_should_escape_long_strings);
 
     return UNITY_END();
 }
@@ -0,0 +1,236 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static size_t allocations = 0;
+
+static void *counting_malloc(size_t size)
+{
+    allocations++;
+    return malloc(size);
+}
+
+static void normal_free(void *pointer)
+{
+    free(pointer);
+}
+
+static void assert_projected(const char * const *paths, size_t count, const char *json, const char *expected)
+{
+    cJSON_Projection *projection = cJSON_CreateProjection(paths, count);
+    cJSON_ParseError error;
+    cJSON *item = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(projection);
+    item = cJSON_ParseWithProjection(projection, json, strlen(json), &error);
+    TEST_ASSERT_NOT_NULL_MESSAGE(item, json);
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_None, error.code);
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+
+    free(printed);
+    cJSON_Delete(item);
+    cJSON_DeleteProjection(projection);
+}
+
+static void projection_should_keep_only_the_paths(void)
+{
+    const char *paths[] = { "/id", "/user/name", "/items/price", "/meta" };
+    const char *everything[] = { "" };
+    const char *nothing[] = { "/missing" };
+    const char json[] = "{\"id\":1,\"skip\":[1,{\"a\":\"]\"}],\"user\":{\"age\":30,\"name\":\"Ann\",\"tags\":[\"x\"]},"
+        "\"items\":[{\"price\":1.5,\"name\":\"a\"},{\"name\":\"b\"},{\"price\":2,\"price\":3},4],"
+        "\"meta\":{\"nested\":{\"deep\":[null]}},\"rest\":\"\\\"}\"}";
+
+    assert_projected(paths, 4, json,
+        "{\"id\":1,\"user\":{\"name\":\"Ann\"},\"items\":[{\"price\":1.5},{},{\"price\":2,\"price\":3},4],\"meta\":{\"nested\":{\"deep\":[null]}}}");
+    assert_projected(everything, 1, json, "{\"id\":1,\"skip\":[1,{\"a\":\"]\"}],\"user\":{\"age\":30,\"name\":\"Ann\",\"tags\":[\"x\"]},"
+        "\"items\":[{\"price\":1.5,\"name\":\"a\"},{\"name\":\"b\"},{\"price\":2,\"price\":3},4],"
+        "\"meta\":{\"nested\":{\"deep\":[null]}},\"rest\":\"\\\"}\"}");
+    assert_projected(nothing, 1, json, "{}");
+    assert_projected(nothing, 1, "[1,\"a\",{}]", "[1,\"a\",{}]");
+    assert_projected(paths, 4, "\"only a string\"", "\"only a string\"");
+}
+
+static void projection_should_match_escaped_names(void)
+{
+    const char *paths[] = { "/a~1b", "/c~0d", "/user", "/user/name" };
+
+    /* "/user" covers "/user/name" */
+    assert_projected(paths, 4, "{\"a/b\":1,\"c~d\":2,\"a~1b\":3,\"\\u0075ser\":{\"x\":4},\"user2\":5}", "{\"a/b\":1,\"c~d\":2,\"user\":{\"x\":4}}");
+}
+
+static void projection_should_reject_invalid_pointers(void)
+{
+    const char *no_slash[] = { "name" };
+    const char *bad_escape[] = { "/a~2" };
+    const char *null_path[] = { NULL };
+
+    TEST_ASSERT_NULL(cJSON_CreateProjection(no_slash, 1));
+    TEST_ASSERT_NULL(cJSON_CreateProjection(bad_escape, 1));
+    TEST_ASSERT_NULL(cJSON_CreateProjection(null_path, 1));
+    TEST_ASSERT_NULL(cJSON_CreateProjection(NULL, 1));
+    TEST_ASSERT_NULL(cJSON_ParseWithProjection(NULL, "{}", 2, NULL));
+}
+
+static void projection_should_report_errors_in_skipped_members(void)
+{
+    const char *paths[] = { "/a" };
+    const char *inputs[] = { "{\"b\" 1}", "{\"b\":1,}", "{\"b\":[1}", "{\"b\":\"x", "{\"b\":nul}", "{\"b\":1 \"a\":2}", "{\"b\":1} x", "{\"b\"" };
+    const int codes[] = { cJSON_Error_ExpectedColon, cJSON_Error_ExpectedName, cJSON_Error_ExpectedArrayEnd, cJSON_Error_UnexpectedEnd,
+        cJSON_Error_InvalidValue, cJSON_Error_ExpectedObjectEnd, cJSON_Error_TrailingCharacters, cJSON_Error_UnexpectedEnd };
+    cJSON_Projection *projection = cJSON_CreateProjection(paths, 1);
+    cJSON_ParseError error;
+    size_t i = 0;
+
+    TEST_ASSERT_NOT_NULL(projection);
+    for (i = 0; i < (sizeof(inputs) / sizeof(inputs[0])); i++)
+    {
+        TEST_ASSERT_NULL_MESSAGE(cJSON_ParseWithProjection(projection, inputs[i], strlen(inputs[i]), &error), inputs[i]);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(codes[i], error.code, inputs[i]);
+    }
+    cJSON_DeleteProjection(projection);
+}
+
+static void projection_should_not_allocate_skipped_members(void)
+{
+    const char *paths[] = { "/key7" };
+    cJSON_Projection *projection = cJSON_CreateProjection(paths, 1);
+    cJSON *object = cJSON_CreateObject();
+    cJSON *item = NULL;
+    cJSON_Hooks hooks;
+    char name[32];
+    char *json = NULL;
+    int i = 0;
+
+    TEST_ASSERT_NOT_NULL(projection);
+    for (i = 0; i < 300; i++)
+    {
+        sprintf(name, "key%d", i);
+        cJSON_AddItemToObject(object, name, cJSON_CreateString("a \\ \"value\""));
+    }
+    json = cJSON_PrintUnformatted(object);
+    TEST_ASSERT_NOT_NULL(json);
+    cJSON_Delete(object);
+
+    hooks.malloc_fn = counting_malloc;
+    hooks.free_fn = normal_free;
+    cJSON_InitHooks(&hooks);
+    allocations = 0;
+    item = cJSON_ParseWithProjection(projection, json, strlen(json), NULL);
+#ifdef CJSON_INLINE_STRINGS
+    /* the object and the member, which holds its name and value */
+    TEST_ASSERT_EQUAL_UINT(2, allocations);
+#else
+    /* the object, the member, its name and its value */
+    TEST_ASSERT_EQUAL_UINT(4, allocations);
+#endif
+    cJSON_InitHooks(NULL);
+
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_EQUAL_INT(1, cJSON_GetArraySize(item));
+    TEST_ASSERT_EQUAL_STRING("a \\ \"value\"", cJSON_GetObjectItem(item, "key7")->valuestring);
+
+    cJSON_Delete(item);
+    free(json);
+    cJSON_DeleteProjection(projection);
+}
+
+static void raw_capture_should_keep_the_text_of_the_paths(void)
+{
+    const char *paths[] = { "/payload", "/items/payload", "/id" };
+    const char json[] = "{\"id\": 12.50, \"headers\": {\"to\": \"x\"}, \"payload\": { \"a\": [1, 2], \"b\": \"\\\"}\" },"
+        " \"items\": [{\"payload\": [ true ]}, 3]}";
+    cJSON_Projection *projection = cJSON_CreateRawCapture(paths, 3, 0);
+    cJSON_ParseError error;
+    cJSON *item = NULL;
+    cJSON *payload = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(projection);
+    item = cJSON_ParseWithProjection(projection, json, strlen(json), &error);
+    TEST_ASSERT_NOT_NULL(item);
+
+    payload = cJSON_GetObjectItem(item, "payload");
+    TEST_ASSERT_TRUE(cJSON_IsRaw(payload));
+    TEST_ASSERT_EQUAL_STRING("{ \"a\": [1, 2], \"b\": \"\\\"}\" }", payload->valuestring);
+    TEST_ASSERT_TRUE(cJSON_IsRaw(cJSON_GetObjectItem(item, "id")));
+    TEST_ASSERT_TRUE(cJSON_IsObject(cJSON_GetObjectItem(item, "headers")));
+
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING("{\"id\":12.50,\"headers\":{\"to\":\"x\"},\"payload\":{ \"a\": [1, 2], \"b\": \"\\\"}\" },\"items\":[{\"payload\":[ true ]},3]}", printed);
+    free(printed);
+    cJSON_Delete(item);
+
+    /* the raw text is only checked as far as it takes to find its end */
+    TEST_ASSERT_NULL(cJSON_ParseWithProjection(projection, "{\"payload\":[1}", 14, &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_ExpectedArrayEnd, error.code);
+    cJSON_DeleteProjection(projection);
+}
+
+static void raw_capture_should_capture_nested_values_at_the_depth(void)
+{
+    const char json[] = "{\"a\":{\"b\":{\"c\":1},\"s\":\"x\"},\"d\":[[1],2],\"e\":3}";
+    cJSON_Projection *projection = cJSON_CreateRawCapture(NULL, 0, 2);
+    cJSON *item = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(projection);
+    item = cJSON_ParseWithProjection(projection, json, strlen(json), NULL);
+    TEST_ASSERT_NOT_NULL(item);
+
+    TEST_ASSERT_TRUE(cJSON_IsObject(cJSON_GetObjectItem(item, "a")));
+    TEST_ASSERT_TRUE(cJSON_IsRaw(cJSON_GetObjectItem(cJSON_GetObjectItem(item, "a"), "b")));
+    TEST_ASSERT_TRUE(cJSON_IsString(cJSON_GetObjectItem(cJSON_GetObjectItem(item, "a"), "s")));
+    TEST_ASSERT_TRUE(cJSON_IsRaw(cJSON_GetArrayItem(cJSON_GetObjectItem(item, "d"), 0)));
+    TEST_ASSERT_TRUE(cJSON_IsNumber(cJSON_GetArrayItem(cJSON_GetObjectItem(item, "d"), 1)));
+
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    free(printed);
+    cJSON_Delete(item);
+    cJSON_DeleteProjection(projection);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(projection_should_keep_only_the_paths);
+    RUN_TEST(projection_should_match_escaped_names);
+    RUN_TEST(projection_should_reject_invalid_pointers);
+    RUN_TEST(projection_should_report_errors_in_skipped_members);
+    RUN_TEST(projection_should_not_allocate_skipped_members);
+    RUN_TEST(raw_capture_should_keep_the_text_of_the_paths);
+    RUN_TEST(raw_capture_should_capture_nested_values_at_the_depth);
+
+    return UNITY_END();
+}
@@ -0,0 +1,557 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+/* rebuilds the tree from the events */
+typedef struct
+{
+    cJSON *stack[64];
+    size_t depth;
+    char *name;
+    cJSON *documents;
+    size_t events;
+    size_t abort_after;
+} tree_builder;
+
+static cJSON_bool add_item(tree_builder *builder, cJSON *item)
+{
+    TEST_ASSERT_NOT_NULL(item);
+    builder->events++;
+    if ((builder->abort_after != 0) && (builder->events >= builder->abort_after))
+    {
+        cJSON_Delete(item);
+        return false;
+    }
+
+    if (builder->depth == 0)
+    {
+        cJSON_AddItemToArray(builder->documents, item);
+    }
+    else if (cJSON_IsObject(builder->stack[builder->depth - 1]))
+    {
+        TEST_ASSERT_NOT_NULL(builder->name);
+        cJSON_AddItemToObject(builder->stack[builder->depth - 1], builder->name, item);
+        free(builder->name);
+        builder->name = NULL;
+    }
+    else
+    {
+        cJSON_AddItemToArray(builder->stack[builder->depth - 1], item);
+    }
+
+    return true;
+}
+
+static cJSON_bool open_container(tree_builder *builder, cJSON *container)
+{
+    if (!add_item(builder, container))
+    {
+        return false;
+    }
+    TEST_ASSERT_TRUE(builder->depth < (sizeof(builder->stack) / sizeof(builder->stack[0])));
+    builder->stack[builder->depth++] = container;
+
+    return true;
+}
+
+static cJSON_bool on_start_object(void *context)
+{
+    return open_container((tree_builder*)context, cJSON_CreateObject());
+}
+
+static cJSON_bool on_start_array(void *context)
+{
+    return open_container((tree_builder*)context, cJSON_CreateArray());
+}
+
+static cJSON_bool on_end(void *context)
+{
+    tree_builder *builder = (tree_builder*)context;
+    TEST_ASSERT_TRUE(builder->depth > 0);
+    builder->depth--;
+
+    return true;
+}
+
+static cJSON_bool on_key(const char *name, void *context)
+{
+    tree_builder *builder = (tree_builder*)context;
+    TEST_ASSERT_NULL(builder->name);
+    builder->name = (char*)cJSON_strdup((const unsigned char*)name, &global_hooks);
+
+    return true;
+}
+
+static cJSON_bool on_value(const cJSON *item, void *context)
+{
+    tree_builder *builder = (tree_builder*)context;
+
+    switch (item->type)
+    {
+        case cJSON_String:
+            return add_item(builder, cJSON_CreateString(item->valuestring));
+        case cJSON_Number:
+            return add_item(builder, cJSON_CreateNumber(item->valuedouble));
+        case cJSON_True:
+            TEST_ASSERT_EQUAL_INT(1, item->valueint);
+            return add_item(builder, cJSON_CreateTrue());
+        case cJSON_False:
+            return add_item(builder, cJSON_CreateFalse());
+        case cJSON_NULL:
+            return add_item(builder, cJSON_CreateNull());
+        default:
+            TEST_FAIL_MESSAGE("Unexpected value type.");
+            return false;
+    }
+}
+
+static const cJSON_SAXHandler handler = { on_start_object, on_end, on_start_array, on_end, on_key, on_value };
+
+static void init_builder(tree_builder *builder)
+{
+    memset(builder, 0, sizeof(tree_builder));
+    builder->documents = cJSON_CreateArray();
+    TEST_ASSERT_NOT_NULL(builder->documents);
+}
+
+static void free_builder(tree_builder *builder)
+{
+    cJSON_Delete(builder->documents);
+    free(builder->name);
+}
+
+/* feed json in chunks of chunk_size bytes and compare the result to cJSON_Parse */
+static void assert_sax_parses(const char *json, size_t chunk_size)
+{
+    cJSON_SAXParser *parser = NULL;
+    tree_builder builder;
+    cJSON *expected = cJSON_Parse(json);
+    char *expected_string = NULL;
+    char *actual_string = NULL;
+    size_t length = strlen(json);
+    size_t offset = 0;
+
+    TEST_ASSERT_NOT_NULL(expected);
+    init_builder(&builder);
+    parser = cJSON_CreateSAXParser(&handler, &builder);
+    TEST_ASSERT_NOT_NULL(parser);
+
+    for (offset = 0; offset < length; offset += chunk_size)
+    {
+        size_t remaining = length - offset;
+        TEST_ASSERT_TRUE(cJSON_SAXParserFeed(parser, json + offset, (remaining < chunk_size) ? remaining : chunk_size));
+    }
+    TEST_ASSERT_TRUE(cJSON_SAXParserFinish(parser));
+    TEST_ASSERT_EQUAL_INT(0, builder.depth);
+    TEST_ASSERT_EQUAL_INT(1, cJSON_GetArraySize(builder.documents));
+
+    expected_string = cJSON_PrintUnformatted(expected);
+    actual_string = cJSON_PrintUnformatted(builder.documents->child);
+    TEST_ASSERT_EQUAL_STRING(expected_string, actual_string);
+
+    free(expected_string);
+    free(actual_string);
+    cJSON_Delete(expected);
+    free_builder(&builder);
+    cJSON_DeleteSAXParser(parser);
+}
+
+static void sax_parser_should_parse_the_example_files(void)
+{
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5", "inputs/test7", "inputs/test8", "inputs/test9", "inputs/test10", "inputs/test11" };
+    const size_t chunk_sizes[] = { 1, 2, 3, 7, 16, 100000 };
+    size_t i = 0;
+    size_t j = 0;
+
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        char *json = read_file(files[i]);
+        TEST_ASSERT_NOT_NULL_MESSAGE(json, files[i]);
+        for (j = 0; j < (sizeof(chunk_sizes) / sizeof(chunk_sizes[0])); j++)
+        {
+            assert_sax_parses(json, chunk_sizes[j]);
+        }
+        free(json);
+    }
+}
+
+static void sax_parser_should_handle_tokens_split_across_chunks(void)
+{
+    const char json[] = "{\"key\\\"\\u00e4\\ud83d\\ude00\":[true,false,null,-12.5e3,\"a\\\\b\\n\"],\"n\":0}";
+    size_t i = 0;
+
+    for (i = 1; i < sizeof(json); i++)
+    {
+        assert_sax_parses(json, i);
+    }
+    assert_sax_parses("12345", 2);
+    assert_sax_parses("  \"top level string\"  ", 3);
+}
+
+static void sax_parser_should_parse_sequences_of_documents(void)
+{
+    const char ndjson[] = "{\"a\":1}\n[2]\n3 \"four\"\ntrue\n";
+    cJSON_SAXParser *parser = NULL;
+    tree_builder builder;
+    char *printed = NULL;
+
+    init_builder(&builder);
+    parser = cJSON_CreateSAXParser(&handler, &builder);
+    TEST_ASSERT_NOT_NULL(parser);
+
+    TEST_ASSERT_TRUE(cJSON_SAXParserFeed(parser, ndjson, sizeof(ndjson) - 1));
+    TEST_ASSERT_TRUE(cJSON_SAXParserFinish(parser));
+
+    printed = cJSON_PrintUnformatted(builder.documents);
+    TEST_ASSERT_EQUAL_STRING("[{\"a\":1},[2],3,\"four\",true]", printed);
+
+    free(printed);
+    free_builder(&builder);
+    cJSON_DeleteSAXParser(parser);
+}
+
+static void assert_sax_error(const char *json, int code, size_t position, size_t line, size_t column)
+{
+    cJSON_SAXParser *parser = NULL;
+    cJSON_ParseError error = { cJSON_Error_None, 0, 0, 0 };
+    tree_builder builder;
+    size_t i = 0;
+
+    init_builder(&builder);
+    parser = cJSON_CreateSAXParser(&handler, &builder);
+    TEST_ASSERT_NOT_NULL(parser);
+
+    /* byte by byte, so the error is found right where it is */
+    for (i = 0; json[i] != '\0'; i++)
+    {
+        if (!cJSON_SAXParserFeed(parser, json + i, 1))
+        {
+            break;
+        }
+    }
+    if (json[i] == '\0')
+    {
+        TEST_ASSERT_FALSE(cJSON_SAXParserFinish(parser));
+    }
+    /* parsing doesn't continue after an error */
+    TEST_ASSERT_FALSE(cJSON_SAXParserFeed(parser, "1", 1));
+    TEST_ASSERT_FALSE(cJSON_SAXParserFinish(parser));
+
+    cJSON_SAXParserGetError(parser, &error);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(code, error.code, cJSON_GetErrorMessage(error.code));
+    TEST_ASSERT_EQUAL_UINT(position, error.position);
+    TEST_ASSERT_EQUAL_UINT(line, error.line);
+    TEST_ASSERT_EQUAL_UINT(column, error.column);
+
+    free_builder(&builder);
+    cJSON_DeleteSAXParser(parser);
+}
+
+static void sax_parser_should_report_errors(void)
+{
+    assert_sax_error("", cJSON_Error_UnexpectedEnd, 0, 1, 1);
+    assert_sax_error("[1, 2", cJSON_Error_UnexpectedEnd, 5, 1, 6);
+    assert_sax_error("[1 2]", cJSON_Error_ExpectedArrayEnd, 3, 1, 4);
+    assert_sax_error("{\n\t\"a\" 1}", cJSON_Error_ExpectedColon, 7, 2, 6);
+    assert_sax_error("{1:2}", cJSON_Error_ExpectedName, 1, 1, 2);
+    assert_sax_error("{\"a\":1 \"b\":2}", cJSON_Error_ExpectedObjectEnd, 7, 1, 8);
+    assert_sax_error("[\n\n  nul]", cJSON_Error_InvalidValue, 8, 3, 6);
+    assert_sax_error("[-]", cJSON_Error_InvalidNumber, 1, 1, 2);
+    assert_sax_error("\"\\x\"", cJSON_Error_InvalidEscape, 1, 1, 2);
+    assert_sax_error("\"\\uDC00\"", cJSON_Error_InvalidUnicode, 1, 1, 2);
+    assert_sax_error("\"abc", cJSON_Error_UnexpectedEnd, 4, 1, 5);
+    assert_sax_error("[] ]", cJSON_Error_InvalidValue, 3, 1, 4);
+}
+
+static void sax_parser_should_limit_the_nesting_depth(void)
+{
+    cJSON_SAXHandler empty_handler;
+    cJSON_SAXParser *parser = NULL;
+    cJSON_ParseError error = { cJSON_Error_None, 0, 0, 0 };
+    size_t i = 0;
+
+    memset(&empty_handler, 0, sizeof(empty_handler));
+    parser = cJSON_CreateSAXParser(&empty_handler, NULL);
+    TEST_ASSERT_NOT_NULL(parser);
+    for (i = 0; i < CJSON_NESTING_LIMIT; i++)
+    {
+        TEST_ASSERT_TRUE(cJSON_SAXParserFeed(parser, "[", 1));
+    }
+    TEST_ASSERT_FALSE(cJSON_SAXParserFeed(parser, "[", 1));
+
+    cJSON_SAXParserGetError(parser, &error);
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_TooDeep, error.code);
+    TEST_ASSERT_EQUAL_UINT(CJSON_NESTING_LIMIT, error.position);
+
+    cJSON_DeleteSAXParser(parser);
+}
+
+static void sax_parser_should_stop_when_the_handler_aborts(void)
+{
+    cJSON_SAXParser *parser = NULL;
+    cJSON_ParseError error = { cJSON_Error_None, 0, 0, 0 };
+    tree_builder builder;
+
+    init_builder(&builder);
+    builder.abort_after = 3;
+    parser = cJSON_CreateSAXParser(&handler, &builder);
+    TEST_ASSERT_NOT_NULL(parser);
+
+    TEST_ASSERT_FALSE(cJSON_SAXParserFeed(parser, "[1, [2], 3]", 11));
+    cJSON_SAXParserGetError(parser, &error);
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_Aborted, error.code);
+    TEST_ASSERT_EQUAL_UINT(4, error.position);
+    TEST_ASSERT_EQUAL_INT(3, builder.events);
+
+    free_builder(&builder);
+    cJSON_DeleteSAXParser(parser);
+}
+
+static void sax_parser_should_work_without_callbacks(void)
+{
+    cJSON_SAXHandler empty_handler;
+    cJSON_SAXParser *parser = NULL;
+
+    memset(&empty_handler, 0, sizeof(empty_handler));
+    TEST_ASSERT_NULL(cJSON_CreateSAXParser(NULL, NULL));
+    parser = cJSON_CreateSAXParser(&empty_handler, NULL);
+    TEST_ASSERT_NOT_NULL(parser);
+
+    TEST_ASSERT_TRUE(cJSON_SAXParserFeed(parser, "{\"a\":[1,\"b\",{}]}", 16));
+    TEST_ASSERT_TRUE(cJSON_SAXParserFeed(parser, NULL, 0));
+    TEST_ASSERT_FALSE(cJSON_SAXParserFeed(NULL, "1", 1));
+    TEST_ASSERT_TRUE(cJSON_SAXParserFinish(parser));
+
+    cJSON_DeleteSAXParser(parser);
+    cJSON_DeleteSAXParser(NULL);
+}
+
+static void assert_stream_parses(const char *json, size_t chunk_size)
+{
+    cJSON_StreamParser *parser = cJSON_CreateStreamParser();
+    cJSON *expected = cJSON_Parse(json);
+    cJSON *actual = NULL;
+    size_t length = strlen(json);
+    size_t offset = 0;
+
+    TEST_ASSERT_NOT_NULL(parser);
+    TEST_ASSERT_NOT_NULL(expected);
+    for (offset = 0; offset < length; offset += chunk_size)
+    {
+        size_t remaining = length - offset;
+        TEST_ASSERT_TRUE(cJSON_StreamParserFeed(parser, json + offset, (remaining < chunk_size) ? remaining : chunk_size));
+        if (actual == NULL)
+        {
+            /* the document is complete before trailing whitespace */
+            actual = cJSON_StreamParserNext(parser);
+        }
+    }
+    TEST_ASSERT_TRUE(cJSON_StreamParserFinish(parser));
+    if (actual == NULL)
+    {
+        /* a number at the end is only complete now */
+        actual = cJSON_StreamParserNext(parser);
+    }
+    TEST_ASSERT_NOT_NULL(actual);
+    TEST_ASSERT_NULL(cJSON_StreamParserNext(parser));
+    TEST_ASSERT_TRUE(cJSON_Compare(expected, actual, true));
+
+    cJSON_Delete(expected);
+    cJSON_Delete(actual);
+    cJSON_DeleteStreamParser(parser);
+}
+
+static void stream_parser_should_build_trees(void)
+{
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5", "inputs/test7", "inputs/test8", "inputs/test9", "inputs/test10", "inputs/test11" };
+    const size_t chunk_sizes[] = { 1, 3, 16, 100000 };
+    size_t i = 0;
+    size_t j = 0;
+
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        char *json = read_file(files[i]);
+        TEST_ASSERT_NOT_NULL_MESSAGE(json, files[i]);
+        for (j = 0; j < (sizeof(chunk_sizes) / sizeof(chunk_sizes[0])); j++)
+        {
+            assert_stream_parses(json, chunk_sizes[j]);
+        }
+        free(json);
+    }
+    assert_stream_parses("12345", 2);
+    assert_stream_parses("{\"a\":{\"b\":[[],{}]},\"c\":\"\\u00e4\"}", 1);
+}
+
+static void stream_parser_should_return_documents_as_they_end(void)
+{
+    const char ndjson[] = "{\"a\":1}\n[2] 3 \"four\"\n[";
+    cJSON_StreamParser *parser = cJSON_CreateStreamParser();
+    cJSON *document = NULL;
+    cJSON_ParseError error;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(parser);
+    TEST_ASSERT_TRUE(cJSON_StreamParserFeed(parser, ndjson, 5));
+    TEST_ASSERT_NULL(cJSON_StreamParserNext(parser));
+    TEST_ASSERT_TRUE(cJSON_StreamParserFeed(parser, ndjson + 5, sizeof(ndjson) - 6));
+
+    document = cJSON_StreamParserNext(parser);
+    printed = cJSON_PrintUnformatted(document);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1}", printed);
+    TEST_ASSERT_NULL(document->next);
+    free(printed);
+    cJSON_Delete(document);
+
+    document = cJSON_StreamParserNext(parser);
+    TEST_ASSERT_TRUE(cJSON_IsArray(document));
+    cJSON_Delete(document);
+    document = cJSON_StreamParserNext(parser);
+    TEST_ASSERT_EQUAL_INT(3, document->valueint);
+    cJSON_Delete(document);
+
+    /* the open array isn't complete, the string before it is */
+    TEST_ASSERT_FALSE(cJSON_StreamParserFinish(parser));
+    cJSON_StreamParserGetError(parser, &error);
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_UnexpectedEnd, error.code);
+    document = cJSON_StreamParserNext(parser);
+    TEST_ASSERT_EQUAL_STRING("four", cJSON_GetStringValue(document));
+    cJSON_Delete(document);
+    TEST_ASSERT_NULL(cJSON_StreamParserNext(parser));
+
+    /* the documents that weren't taken and the partial one are deleted with the parser */
+    cJSON_DeleteStreamParser(parser);
+    parser = cJSON_CreateStreamParser();
+    TEST_ASSERT_NOT_NULL(parser);
+    TEST_ASSERT_TRUE(cJSON_StreamParserFeed(parser, "[1] {\"a\":[{\"b\"", strlen("[1] {\"a\":[{\"b\"")));
+    TEST_ASSERT_FALSE(cJSON_StreamParserFeed(parser, "}", 1));
+    cJSON_StreamParserGetError(parser, &error);
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_ExpectedColon, error.code);
+    cJSON_DeleteStreamParser(parser);
+
+    /* several documents still queued */
+    parser = cJSON_CreateStreamParser();
+    TEST_ASSERT_NOT_NULL(parser);
+    TEST_ASSERT_TRUE(cJSON_StreamParserFeed(parser, "[1] [2] \"a\" \"b\" 1 2 ", strlen("[1] [2] \"a\" \"b\" 1 2 ")));
+    TEST_ASSERT_TRUE(cJSON_StreamParserFinish(parser));
+    cJSON_DeleteStreamParser(parser);
+
+    TEST_ASSERT_NULL(cJSON_StreamParserNext(NULL));
+    TEST_ASSERT_FALSE(cJSON_StreamParserFeed(NULL, "1", 1));
+    cJSON_DeleteStreamParser(NULL);
+}
+
+static void parse_step_should_parse_in_steps(void)
+{
+    char *json = read_file("inputs/test1");
+    cJSON *expected = NULL;
+    cJSON *actual = NULL;
+    cJSON_ParseState *state = NULL;
+    size_t steps = 0;
+    int status = cJSON_Step_More;
+
+    TEST_ASSERT_NOT_NULL(json);
+    expected = cJSON_Parse(json);
+    TEST_ASSERT_NOT_NULL(expected);
+
+    /* the terminating '\0' ends the input */
+    state = cJSON_CreateParseState(json, strlen(json) + 1);
+    TEST_ASSERT_NOT_NULL(state);
+    while (status == cJSON_Step_More)
+    {
+        TEST_ASSERT_NULL(cJSON_ParseStateTakeResult(state));
+        status = cJSON_ParseStep(state, 64);
+        steps++;
+    }
+    TEST_ASSERT_EQUAL_INT(cJSON_Step_Done, status);
+    TEST_ASSERT_EQUAL_UINT((strlen(json) + 63) / 64, steps);
+    TEST_ASSERT_EQUAL_INT(cJSON_Step_Done, cJSON_ParseStep(state, 64));
+
+    actual = cJSON_ParseStateTakeResult(state);
+    TEST_ASSERT_TRUE(cJSON_Compare(expected, actual, true));
+    TEST_ASSERT_NULL(cJSON_ParseStateTakeResult(state));
+
+    cJSON_Delete(actual);
+    cJSON_Delete(expected);
+    cJSON_DeleteParseState(state);
+    free(json);
+}
+
+static void assert_step_error(const char *json, size_t max_bytes, int code, size_t position)
+{
+    cJSON_ParseState *state = cJSON_CreateParseState(json, strlen(json));
+    cJSON_ParseError error;
+    int status = cJSON_Step_More;
+
+    TEST_ASSERT_NOT_NULL(state);
+    while (status == cJSON_Step_More)
+    {
+        status = cJSON_ParseStep(state, max_bytes);
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(cJSON_Step_Failed, status, json);
+    TEST_ASSERT_NULL(cJSON_ParseStateTakeResult(state));
+    cJSON_ParseStateGetError(state, &error);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(code, error.code, json);
+    TEST_ASSERT_EQUAL_UINT_MESSAGE(position, error.position, json);
+
+    cJSON_DeleteParseState(state);
+}
+
+static void parse_step_should_report_errors(void)
+{
+    assert_step_error("", 1, cJSON_Error_UnexpectedEnd, 0);
+    assert_step_error("[1,", 0, cJSON_Error_UnexpectedEnd, 3);
+    assert_step_error("[1,]", 2, cJSON_Error_InvalidValue, 3);
+    assert_step_error("[1] 2", 2, cJSON_Error_TrailingCharacters, 4);
+    assert_step_error("[1] {}", 100, cJSON_Error_TrailingCharacters, 4);
+    assert_step_error("\"a\" \"b\"", 1, cJSON_Error_TrailingCharacters, 4);
+
+    TEST_ASSERT_NULL(cJSON_CreateParseState(NULL, 0));
+    TEST_ASSERT_EQUAL_INT(cJSON_Step_Failed, cJSON_ParseStep(NULL, 1));
+    cJSON_DeleteParseState(NULL);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(sax_parser_should_parse_the_example_files);
+    RUN_TEST(sax_parser_should_handle_tokens_split_across_chunks);
+    RUN_TEST(sax_parser_should_parse_sequences_of_documents);
+    RUN_TEST(sax_parser_should_report_errors);
+    RUN_TEST(sax_parser_should_limit_the_nesting_depth);
+    RUN_TEST(sax_parser_should_stop_when_the_handler_aborts);
+    RUN_TEST(sax_parser_should_work_without_callbacks);
+    RUN_TEST(stream_parser_should_build_trees);
+    RUN_TEST(stream_parser_should_return_documents_as_they_end);
+    RUN_TEST(parse_step_should_parse_in_steps);
+    RUN_TEST(parse_step_should_report_errors);
+
+    return UNITY_END();
+}
@@ -0,0 +1,119 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* the counters are compiled in for these tests */
+#ifndef CJSON_ENABLE_STATS
+#define CJSON_ENABLE_STATS
+#endif
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static const char document[] = "{\"a\":[1,2,{\"b\":[true]}],\"name\":\"cJSON\",\"empty\":{}}";
+
+static void parse_with_stats_should_count(void)
+{
+    cJSON_Stats stats;
+    cJSON *item = NULL;
+
+    memset(&stats, 0xFF, sizeof(stats));
+    item = cJSON_ParseWithStats(document, sizeof(document) - 1, &stats);
+    TEST_ASSERT_NOT_NULL(item);
+
+    /* object, a, 1, 2, {}, b, true, name, empty */
+    TEST_ASSERT_EQUAL_UINT(9, (unsigned int)stats.nodes);
+    TEST_ASSERT_EQUAL_UINT(4, (unsigned int)stats.max_depth);
+#ifdef CJSON_INLINE_STRINGS
+    /* every item is an allocation, the keys are stored in them */
+    TEST_ASSERT_TRUE(stats.allocations >= 9);
+#else
+    /* every item and every object key is an allocation */
+    TEST_ASSERT_TRUE(stats.allocations >= 13);
+#endif
+    TEST_ASSERT_TRUE(stats.allocated_bytes >= 9 * sizeof(cJSON));
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned int)stats.peak_buffer_size);
+    TEST_ASSERT_TRUE(stats.seconds >= 0);
+
+    cJSON_Delete(item);
+}
+
+static void parse_with_stats_should_fail_like_parse(void)
+{
+    cJSON_Stats stats;
+
+    TEST_ASSERT_NULL(cJSON_ParseWithStats("[1,}", 4, &stats));
+    TEST_ASSERT_EQUAL_STRING("}", cJSON_GetErrorPtr());
+    TEST_ASSERT_NULL(cJSON_ParseWithStats(NULL, 4, &stats));
+}
+
+static void print_with_stats_should_count(void)
+{
+    cJSON_Stats stats;
+    cJSON *item = cJSON_Parse(document);
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(item);
+
+    printed = cJSON_PrintWithStats(item, false, &stats);
+    TEST_ASSERT_EQUAL_STRING(document, printed);
+    TEST_ASSERT_EQUAL_UINT(9, (unsigned int)stats.nodes);
+    TEST_ASSERT_EQUAL_UINT(sizeof(document), (unsigned int)stats.peak_buffer_size);
+    TEST_ASSERT_TRUE(stats.allocations >= 1);
+    global_hooks.deallocate(printed);
+
+    printed = cJSON_PrintWithStats(item, true, &stats);
+    TEST_ASSERT_EQUAL_UINT(strlen(printed) + 1, (unsigned int)stats.peak_buffer_size);
+    global_hooks.deallocate(printed);
+
+    cJSON_Delete(item);
+}
+
+static void with_stats_should_accept_no_stats(void)
+{
+    cJSON *item = cJSON_ParseWithStats(document, sizeof(document) - 1, NULL);
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(item);
+    printed = cJSON_PrintWithStats(item, false, NULL);
+    TEST_ASSERT_EQUAL_STRING(document, printed);
+
+    global_hooks.deallocate(printed);
+    cJSON_Delete(item);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(parse_with_stats_should_count);
+    RUN_TEST(parse_with_stats_should_fail_like_parse);
+    RUN_TEST(print_with_stats_should_count);
+    RUN_TEST(with_stats_should_accept_no_stats);
+
+    return UNITY_END();
+}
@@ -0,0 +1,281 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+typedef struct
+{
+    int x;
+    int y;
+} point;
+
+typedef struct
+{
+    int id;
+    double score;
+    cJSON_bool active;
+    char *name;
+    char code[4];
+    point position;
+} message;
+
+static const cJSON_Field point_fields[] =
+{
+    { "x", cJSON_FieldInt, offsetof(point, x), 0, NULL },
+    { "y", cJSON_FieldInt, offsetof(point, y), 0, NULL },
+    { NULL, 0, 0, 0, NULL }
+};
+
+static const cJSON_Field message_fields[] =
+{
+    { "id", cJSON_FieldInt, offsetof(message, id), 0, NULL },
+    { "score", cJSON_FieldDouble, offsetof(message, score), 0, NULL },
+    { "active", cJSON_FieldBool, offsetof(message, active), 0, NULL },
+    { "name", cJSON_FieldString, offsetof(message, name), 0, NULL },
+    { "code", cJSON_FieldChars, offsetof(message, code), sizeof(((message*)NULL)->code), NULL },
+    { "position", cJSON_FieldObject, offsetof(message, position), 0, point_fields },
+    { NULL, 0, 0, 0, NULL }
+};
+
+static cJSON_bool parse_message(cJSON_Schema *schema, const char *json, message *parsed, cJSON_ParseError *error)
+{
+    return cJSON_ParseStruct(schema, json, strlen(json), parsed, error);
+}
+
+static void structs_should_be_parsed(void)
+{
+    cJSON_Schema *schema = cJSON_CreateSchema(message_fields);
+    message parsed;
+    cJSON_ParseError error;
+
+    TEST_ASSERT_NOT_NULL(schema);
+    memset(&parsed, '\0', sizeof(parsed));
+    TEST_ASSERT_TRUE(parse_message(schema, " { \"id\" : 42, \"score\": -1.5e2, \"active\": true, \"name\": \"Jos\\u00e9\",\n"
+        "\"code\": \"abc\", \"position\": { \"x\": 3, \"y\": -4 } } ", &parsed, &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_None, error.code);
+    TEST_ASSERT_EQUAL_INT(42, parsed.id);
+    TEST_ASSERT_EQUAL_DOUBLE(-150, parsed.score);
+    TEST_ASSERT_TRUE(parsed.active);
+    TEST_ASSERT_EQUAL_STRING("Jos\xc3\xa9", parsed.name);
+    TEST_ASSERT_EQUAL_STRING("abc", parsed.code);
+    TEST_ASSERT_EQUAL_INT(3, parsed.position.x);
+    TEST_ASSERT_EQUAL_INT(-4, parsed.position.y);
+
+    /* unknown members and null are skipped, missing members keep their value, a repeated member replaces the first */
+    TEST_ASSERT_TRUE(parse_message(schema, "{\"extra\":{\"id\":[1,{\"x\":\"}\"}]},\"name\":\"a\",\"more\":\"\\\"\",\"id\":null,"
+        "\"position\":{\"z\":[],\"y\":1e10},\"name\":\"b\",\"n\\u0061me\":\"c\\n\",\"active\":false,\"last\":-0.5}", &parsed, NULL));
+    TEST_ASSERT_EQUAL_INT(42, parsed.id);
+    TEST_ASSERT_EQUAL_STRING("c\n", parsed.name);
+    TEST_ASSERT_EQUAL_INT(3, parsed.position.x);
+    TEST_ASSERT_EQUAL_INT(INT_MAX, parsed.position.y);
+    TEST_ASSERT_FALSE(parsed.active);
+    TEST_ASSERT_EQUAL_STRING("abc", parsed.code);
+
+    TEST_ASSERT_TRUE(parse_message(schema, "{}", &parsed, NULL));
+    TEST_ASSERT_TRUE(parse_message(schema, "{\"position\":{}}", &parsed, NULL));
+    TEST_ASSERT_EQUAL_STRING("c\n", parsed.name);
+
+    cJSON_FreeStructStrings(schema, &parsed);
+    TEST_ASSERT_NULL(parsed.name);
+    cJSON_DeleteSchema(schema);
+}
+
+static void assert_struct_error(cJSON_Schema *schema, const char *json, int code, size_t position)
+{
+    message parsed;
+    cJSON_ParseError error;
+
+    memset(&parsed, '\0', sizeof(parsed));
+    TEST_ASSERT_FALSE_MESSAGE(parse_message(schema, json, &parsed, &error), json);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(code, error.code, json);
+    TEST_ASSERT_EQUAL_UINT_MESSAGE(position, error.position, json);
+    cJSON_FreeStructStrings(schema, &parsed);
+}
+
+static void structs_should_report_errors(void)
+{
+    cJSON_Schema *schema = cJSON_CreateSchema(message_fields);
+    message parsed;
+
+    TEST_ASSERT_NOT_NULL(schema);
+    assert_struct_error(schema, "", cJSON_Error_UnexpectedEnd, 0);
+    assert_struct_error(schema, "[]", cJSON_Error_InvalidValue, 0);
+    assert_struct_error(schema, "{\"id\":\"1\"}", cJSON_Error_InvalidValue, 6);
+    assert_struct_error(schema, "{\"id\":-}", cJSON_Error_InvalidNumber, 6);
+    assert_struct_error(schema, "{\"name\":1}", cJSON_Error_InvalidValue, 8);
+    assert_struct_error(schema, "{\"active\":1}", cJSON_Error_InvalidValue, 10);
+    assert_struct_error(schema, "{\"position\":[1]}", cJSON_Error_InvalidValue, 12);
+    assert_struct_error(schema, "{\"code\":\"abcd\"}", cJSON_Error_InvalidValue, 8);
+    assert_struct_error(schema, "{\"name\":\"\\x\"}", cJSON_Error_InvalidEscape, 9);
+    assert_struct_error(schema, "{\"name\":\"a\",}", cJSON_Error_ExpectedName, 12);
+    assert_struct_error(schema, "{\"name\" \"a\"}", cJSON_Error_ExpectedColon, 8);
+    assert_struct_error(schema, "{\"id\":1 \"a\"}", cJSON_Error_ExpectedObjectEnd, 8);
+    assert_struct_error(schema, "{\"position\":{\"x\":1}", cJSON_Error_UnexpectedEnd, 19);
+    assert_struct_error(schema, "{\"other\":[1}", cJSON_Error_ExpectedArrayEnd, 11);
+    assert_struct_error(schema, "{\"other\":\"a}", cJSON_Error_UnexpectedEnd, 12);
+    assert_struct_error(schema, "{} {}", cJSON_Error_TrailingCharacters, 3);
+
+    memset(&parsed, '\0', sizeof(parsed));
+    TEST_ASSERT_FALSE(cJSON_ParseStruct(NULL, "{}", 2, &parsed, NULL));
+    TEST_ASSERT_FALSE(cJSON_ParseStruct(schema, NULL, 2, &parsed, NULL));
+    TEST_ASSERT_FALSE(cJSON_ParseStruct(schema, "{}", 2, NULL, NULL));
+    /* strings that were stored before the error can be freed */
+    TEST_ASSERT_FALSE(parse_message(schema, "{\"name\":\"a\",\"id\":true}", &parsed, NULL));
+    TEST_ASSERT_EQUAL_STRING("a", parsed.name);
+    cJSON_FreeStructStrings(schema, &parsed);
+
+    cJSON_DeleteSchema(schema);
+}
+
+static const cJSON_Field recursive_fields[] =
+{
+    { "self", cJSON_FieldObject, 0, 0, recursive_fields },
+    { NULL, 0, 0, 0, NULL }
+};
+
+static void schemas_should_check_the_fields(void)
+{
+    cJSON_Field fields[3];
+    cJSON_Schema *schema = NULL;
+
+    memset(fields, '\0', sizeof(fields));
+    fields[0].name = "a";
+    fields[0].type = cJSON_FieldInt;
+    schema = cJSON_CreateSchema(fields);
+    TEST_ASSERT_NOT_NULL(schema);
+    cJSON_DeleteSchema(schema);
+
+    fields[1].name = "b";
+    fields[1].type = cJSON_FieldChars;
+    TEST_ASSERT_NULL(cJSON_CreateSchema(fields));
+    fields[1].type = 100;
+    TEST_ASSERT_NULL(cJSON_CreateSchema(fields));
+    fields[1].type = cJSON_FieldObject;
+    TEST_ASSERT_NULL(cJSON_CreateSchema(fields));
+    fields[1].fields = point_fields;
+    schema = cJSON_CreateSchema(fields);
+    TEST_ASSERT_NOT_NULL(schema);
+    cJSON_DeleteSchema(schema);
+
+    TEST_ASSERT_NULL(cJSON_CreateSchema(recursive_fields));
+    TEST_ASSERT_NULL(cJSON_CreateSchema(NULL));
+    cJSON_DeleteSchema(NULL);
+
+    /* an empty schema skips everything */
+    fields[0].name = NULL;
+    schema = cJSON_CreateSchema(fields);
+    TEST_ASSERT_NOT_NULL(schema);
+    TEST_ASSERT_TRUE(cJSON_ParseStruct(schema, "{\"a\":1}", 7, fields, NULL));
+    cJSON_DeleteSchema(schema);
+}
+
+static void structs_should_be_printed(void)
+{
+    cJSON_Schema *schema = cJSON_CreateSchema(message_fields);
+    message source;
+    message parsed;
+    char name[] = "say \"hi\"\n";
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(schema);
+    memset(&source, '\0', sizeof(source));
+    source.id = -42;
+    source.score = 1.5;
+    source.active = 1;
+    source.name = name;
+    strcpy(source.code, "ab");
+    source.position.x = 3;
+    source.position.y = 4;
+
+    printed = cJSON_PrintStruct(schema, &source);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_STRING("{\"id\":-42,\"score\":1.5,\"active\":true,\"name\":\"say \\\"hi\\\"\\n\",\"code\":\"ab\",\"position\":{\"x\":3,\"y\":4}}", printed);
+
+    /* round trip */
+    memset(&parsed, '\0', sizeof(parsed));
+    TEST_ASSERT_TRUE(parse_message(schema, printed, &parsed, NULL));
+    TEST_ASSERT_EQUAL_INT(-42, parsed.id);
+    TEST_ASSERT_EQUAL_STRING(source.name, parsed.name);
+    TEST_ASSERT_EQUAL_STRING("ab", parsed.code);
+    TEST_ASSERT_EQUAL_INT(4, parsed.position.y);
+    cJSON_FreeStructStrings(schema, &parsed);
+    free(printed);
+
+    /* NULL strings */
+    source.name = NULL;
+    source.active = 0;
+    printed = cJSON_PrintStruct(schema, &source);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_NOT_NULL(strstr(printed, "\"active\":false,\"name\":null,"));
+    free(printed);
+
+    /* unterminated chars */
+    memcpy(source.code, "abcd", 4);
+    TEST_ASSERT_NULL(cJSON_PrintStruct(schema, &source));
+    TEST_ASSERT_NULL(cJSON_PrintStruct(NULL, &source));
+    TEST_ASSERT_NULL(cJSON_PrintStruct(schema, NULL));
+
+    cJSON_DeleteSchema(schema);
+}
+
+static void struct_names_should_be_escaped(void)
+{
+    static const cJSON_Field fields[] =
+    {
+        { "a\"b", cJSON_FieldInt, offsetof(point, x), 0, NULL },
+        { "\xc3\xbc", cJSON_FieldInt, offsetof(point, y), 0, NULL },
+        { NULL, 0, 0, 0, NULL }
+    };
+    cJSON_Schema *schema = cJSON_CreateSchema(fields);
+    point source;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(schema);
+    source.x = 1;
+    source.y = 2;
+    printed = cJSON_PrintStruct(schema, &source);
+    TEST_ASSERT_EQUAL_STRING("{\"a\\\"b\":1,\"\xc3\xbc\":2}", printed);
+    free(printed);
+
+    cJSON_DeleteSchema(schema);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(structs_should_be_parsed);
+    RUN_TEST(structs_should_report_errors);
+    RUN_TEST(schemas_should_check_the_fields);
+    RUN_TEST(structs_should_be_printed);
+    RUN_TEST(struct_names_should_be_escaped);
+
+    return UNITY_END();
+}
@@ -0,0 +1,264 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static char *copy_text(const char *text, const size_t length)
+{
+    char *copy = (char*)malloc(length + 1);
+    TEST_ASSERT_NOT_NULL(copy);
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+
+    return copy;
+}
+
+/* build a tree from a tape value to compare it with the result of cJSON_Parse */
+static cJSON *tape_to_tree(const cJSON_TapeValue *value)
+{
+    const cJSON_TapeValue *child = NULL;
+    const char *string = NULL;
+    cJSON *item = NULL;
+    char *text = NULL;
+    size_t length = 0;
+
+    switch (cJSON_TapeGetType(value))
+    {
+        case cJSON_NULL:
+            return cJSON_CreateNull();
+        case cJSON_True:
+            return cJSON_CreateTrue();
+        case cJSON_False:
+            return cJSON_CreateFalse();
+        case cJSON_Number:
+            return cJSON_CreateNumber(cJSON_TapeGetNumber(value));
+        case cJSON_String:
+            string = cJSON_TapeGetString(value, &length);
+            text = copy_text(string, length);
+            item = cJSON_CreateString(text);
+            free(text);
+            return item;
+        case cJSON_Array:
+            item = cJSON_CreateArray();
+            cJSON_TapeArrayForEach(child, value)
+            {
+                TEST_ASSERT_NULL(cJSON_TapeGetName(child, NULL));
+                cJSON_AddItemToArray(item, tape_to_tree(child));
+            }
+            return item;
+        case cJSON_Object:
+            item = cJSON_CreateObject();
+            cJSON_TapeArrayForEach(child, value)
+            {
+                string = cJSON_TapeGetName(child, &length);
+                TEST_ASSERT_NOT_NULL(string);
+                text = copy_text(string, length);
+                cJSON_AddItemToObject(item, text, tape_to_tree(child));
+                free(text);
+            }
+            return item;
+        default:
+            TEST_FAIL_MESSAGE("Unexpected type.");
+            return NULL;
+    }
+}
+
+static void assert_tape_matches_tree(const char *json)
+{
+    cJSON *expected = cJSON_Parse(json);
+    cJSON_Tape *tape = cJSON_ParseTape(json, strlen(json), NULL);
+    cJSON *actual = NULL;
+    char *expected_string = NULL;
+    char *actual_string = NULL;
+
+    TEST_ASSERT_NOT_NULL(expected);
+    TEST_ASSERT_NOT_NULL(tape);
+    actual = tape_to_tree(cJSON_TapeGetRoot(tape));
+    expected_string = cJSON_PrintUnformatted(expected);
+    actual_string = cJSON_PrintUnformatted(actual);
+    TEST_ASSERT_EQUAL_STRING(expected_string, actual_string);
+    TEST_ASSERT_EQUAL_INT(cJSON_GetArraySize(expected), cJSON_TapeGetArraySize(cJSON_TapeGetRoot(tape)));
+
+    free(actual_string);
+    free(expected_string);
+    cJSON_Delete(actual);
+    cJSON_Delete(expected);
+    cJSON_DeleteTape(tape);
+}
+
+static void tape_should_parse_the_example_files(void)
+{
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5", "inputs/test7", "inputs/test8", "inputs/test9", "inputs/test10", "inputs/test11" };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        char *json = read_file(files[i]);
+        TEST_ASSERT_NOT_NULL_MESSAGE(json, files[i]);
+        assert_tape_matches_tree(json);
+        free(json);
+    }
+
+    assert_tape_matches_tree(" 1.5 ");
+    assert_tape_matches_tree("\"\"");
+    assert_tape_matches_tree("[]");
+    assert_tape_matches_tree("{}");
+    assert_tape_matches_tree("{\"\":{},\"a\":[[],[{}],{\"b\":[true,false,null]}],\"c\\n\":\"\\u00e4\\\"\"}");
+}
+
+static void tape_strings_should_point_into_the_input(void)
+{
+    const char json[] = "{\"plain\":\"text\",\"esc\\taped\":\"a\\nb\"}";
+    cJSON_Tape *tape = cJSON_ParseTape(json, sizeof(json) - 1, NULL);
+    const cJSON_TapeValue *root = cJSON_TapeGetRoot(tape);
+    const cJSON_TapeValue *plain = NULL;
+    const cJSON_TapeValue *escaped = NULL;
+    const char *text = NULL;
+    size_t length = 0;
+
+    TEST_ASSERT_NOT_NULL(tape);
+    plain = cJSON_TapeGetObjectItemCaseSensitive(root, "plain");
+    escaped = cJSON_TapeGetObjectItemCaseSensitive(root, "esc\taped");
+    TEST_ASSERT_NOT_NULL(plain);
+    TEST_ASSERT_NOT_NULL(escaped);
+
+    text = cJSON_TapeGetString(plain, &length);
+    TEST_ASSERT_TRUE(text == json + 10);
+    TEST_ASSERT_EQUAL_UINT(4, length);
+    TEST_ASSERT_TRUE(cJSON_TapeGetName(plain, NULL) == json + 2);
+
+    /* unescaped strings are copied and terminated */
+    text = cJSON_TapeGetString(escaped, &length);
+    TEST_ASSERT_FALSE((text >= json) && (text < json + sizeof(json)));
+    TEST_ASSERT_EQUAL_STRING("a\nb", text);
+    TEST_ASSERT_EQUAL_UINT(3, length);
+    TEST_ASSERT_EQUAL_STRING("esc\taped", cJSON_TapeGetName(escaped, &length));
+    TEST_ASSERT_EQUAL_UINT(8, length);
+
+    cJSON_DeleteTape(tape);
+}
+
+static void tape_should_be_navigable(void)
+{
+    const char json[] = "{\"Name\":\"x\",\"list\":[1,[2,3],{\"deep\":[4]},5],\"n\":-1.5}";
+    cJSON_Tape *tape = cJSON_ParseTape(json, sizeof(json) - 1, NULL);
+    const cJSON_TapeValue *root = cJSON_TapeGetRoot(tape);
+    const cJSON_TapeValue *list = NULL;
+    const cJSON_TapeValue *element = NULL;
+    double sum = 0;
+
+    TEST_ASSERT_NOT_NULL(tape);
+    TEST_ASSERT_EQUAL_INT(cJSON_Object, cJSON_TapeGetType(root));
+    TEST_ASSERT_EQUAL_INT(3, cJSON_TapeGetArraySize(root));
+    TEST_ASSERT_NOT_NULL(cJSON_TapeGetObjectItem(root, "name"));
+    TEST_ASSERT_NULL(cJSON_TapeGetObjectItemCaseSensitive(root, "name"));
+    TEST_ASSERT_NULL(cJSON_TapeGetObjectItem(root, "Nam"));
+    TEST_ASSERT_EQUAL_DOUBLE(-1.5, cJSON_TapeGetNumber(cJSON_TapeGetObjectItem(root, "n")));
+
+    list = cJSON_TapeGetObjectItem(root, "list");
+    TEST_ASSERT_EQUAL_INT(4, cJSON_TapeGetArraySize(list));
+    cJSON_TapeArrayForEach(element, list)
+    {
+        sum += cJSON_TapeGetNumber(element);
+    }
+    TEST_ASSERT_EQUAL_DOUBLE(6, sum);
+    TEST_ASSERT_EQUAL_DOUBLE(5, cJSON_TapeGetNumber(cJSON_TapeGetArrayItem(list, 3)));
+    TEST_ASSERT_EQUAL_DOUBLE(3, cJSON_TapeGetNumber(cJSON_TapeGetArrayItem(cJSON_TapeGetArrayItem(list, 1), 1)));
+    element = cJSON_TapeGetObjectItem(cJSON_TapeGetArrayItem(list, 2), "deep");
+    TEST_ASSERT_EQUAL_DOUBLE(4, cJSON_TapeGetNumber(cJSON_TapeGetChild(element)));
+    TEST_ASSERT_NULL(cJSON_TapeGetArrayItem(list, 4));
+    TEST_ASSERT_NULL(cJSON_TapeGetArrayItem(list, -1));
+
+    /* wrong types */
+    TEST_ASSERT_NULL(cJSON_TapeGetString(list, NULL));
+    TEST_ASSERT_NULL(cJSON_TapeGetChild(cJSON_TapeGetObjectItem(root, "n")));
+    TEST_ASSERT_NULL(cJSON_TapeGetObjectItem(list, "deep"));
+    TEST_ASSERT_EQUAL_INT(cJSON_Invalid, cJSON_TapeGetType(NULL));
+    TEST_ASSERT_NULL(cJSON_TapeGetRoot(NULL));
+
+    cJSON_DeleteTape(tape);
+}
+
+static void assert_tape_error(const char *json, const size_t length)
+{
+    cJSON_ParseError expected;
+    cJSON_ParseError error;
+    char *terminated = copy_text(json, length);
+
+    TEST_ASSERT_NULL(cJSON_ParseWithError(terminated, NULL, true, &expected));
+    TEST_ASSERT_NULL(cJSON_ParseTape(json, length, &error));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(expected.code, error.code, json);
+    TEST_ASSERT_EQUAL_UINT_MESSAGE(expected.position, error.position, json);
+    TEST_ASSERT_EQUAL_UINT(expected.line, error.line);
+    TEST_ASSERT_EQUAL_UINT(expected.column, error.column);
+
+    free(terminated);
+}
+
+static void tape_should_report_errors_like_the_parser(void)
+{
+    const char *invalid[] = { "", "[1, 2", "[1 2]", "{\n\t\"a\" 1}", "{1:2}", "{\"a\":1 \"b\":2}", "[\n\n  nul]", "[-]", "\"\\x\"", "\"abc", "[] ]", "{\"a\":\"\\uDC00\"}" };
+    cJSON_ParseError error;
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(invalid) / sizeof(invalid[0])); i++)
+    {
+        assert_tape_error(invalid[i], strlen(invalid[i]));
+    }
+    /* the buffer ends in the middle of the value */
+    assert_tape_error("[1, 2]", 5);
+
+    TEST_ASSERT_NULL(cJSON_ParseTape(NULL, 0, &error));
+}
+
+static void tape_should_stop_at_the_buffer_end(void)
+{
+    const char json[] = "[\"abc\", 12]xyz";
+    cJSON_Tape *tape = cJSON_ParseTape(json, 11, NULL);
+    size_t length = 0;
+
+    TEST_ASSERT_NOT_NULL(tape);
+    TEST_ASSERT_EQUAL_DOUBLE(12, cJSON_TapeGetNumber(cJSON_TapeGetArrayItem(cJSON_TapeGetRoot(tape), 1)));
+    TEST_ASSERT_NOT_NULL(cJSON_TapeGetString(cJSON_TapeGetChild(cJSON_TapeGetRoot(tape)), &length));
+    TEST_ASSERT_EQUAL_UINT(3, length);
+    cJSON_DeleteTape(tape);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(tape_should_parse_the_example_files);
+    RUN_TEST(tape_strings_should_point_into_the_input);
+    RUN_TEST(tape_should_be_navigable);
+    RUN_TEST(tape_should_report_errors_like_the_parser);
+    RUN_TEST(tape_should_stop_at_the_buffer_end);
+
+    return UNITY_END();
+}
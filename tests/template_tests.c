@@ -0,0 +1,199 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+/* {"status":"ok","id":<number>,"user":{"name":<string>,"tags":<any>},"list":[1,<bool>]} */
+static cJSON *create_skeleton(void)
+{
+    cJSON *skeleton = cJSON_CreateObject();
+    cJSON *user = NULL;
+    cJSON *list = NULL;
+
+    TEST_ASSERT_NOT_NULL(skeleton);
+    cJSON_AddStringToObject(skeleton, "status", "ok");
+    cJSON_AddItemToObject(skeleton, "id", cJSON_CreateSlot(cJSON_Number));
+    user = cJSON_CreateObject();
+    cJSON_AddItemToObject(skeleton, "user", user);
+    cJSON_AddItemToObject(user, "name", cJSON_CreateSlot(cJSON_String));
+    cJSON_AddItemToObject(user, "tags", cJSON_CreateSlot(cJSON_Invalid));
+    list = cJSON_CreateArray();
+    cJSON_AddItemToObject(skeleton, "list", list);
+    cJSON_AddItemToArray(list, cJSON_CreateNumber(1));
+    cJSON_AddItemToArray(list, cJSON_CreateSlot(cJSON_True | cJSON_False));
+
+    return skeleton;
+}
+
+/* The skeleton with the slots replaced by the values. */
+static cJSON *create_filled(const cJSON * const skeleton, cJSON * const * const values)
+{
+    cJSON *filled = cJSON_Duplicate(skeleton, true);
+    cJSON *user = cJSON_GetObjectItem(filled, "user");
+
+    TEST_ASSERT_NOT_NULL(filled);
+    cJSON_ReplaceItemInObject(filled, "id", cJSON_Duplicate(values[0], true));
+    cJSON_ReplaceItemInObject(user, "name", cJSON_Duplicate(values[1], true));
+    cJSON_ReplaceItemInObject(user, "tags", cJSON_Duplicate(values[2], true));
+    cJSON_ReplaceItemInArray(cJSON_GetObjectItem(filled, "list"), 1, cJSON_Duplicate(values[3], true));
+
+    return filled;
+}
+
+static void assert_rendered_like_printed(const cJSON_bool format)
+{
+    cJSON *skeleton = create_skeleton();
+    cJSON_Template *compiled = cJSON_CreateTemplate(skeleton, format);
+    cJSON *values[4];
+    cJSON *filled = NULL;
+    char *rendered = NULL;
+    char *printed = NULL;
+    char buffer[512];
+
+    TEST_ASSERT_NOT_NULL(compiled);
+    TEST_ASSERT_EQUAL_INT(4, cJSON_GetTemplateSlotCount(compiled));
+
+    values[0] = cJSON_CreateNumber(42);
+    values[1] = cJSON_CreateString("\"quoted\"");
+    values[2] = cJSON_Parse("[\"a\",{\"b\":[]}]");
+    values[3] = cJSON_CreateTrue();
+    filled = create_filled(skeleton, values);
+    /* the skeleton isn't needed any more */
+    cJSON_Delete(skeleton);
+
+    rendered = cJSON_RenderTemplate(compiled, (const cJSON * const *)values);
+    printed = format ? cJSON_Print(filled) : cJSON_PrintUnformatted(filled);
+    TEST_ASSERT_NOT_NULL(rendered);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_STRING(printed, rendered);
+
+    TEST_ASSERT_TRUE(cJSON_RenderTemplatePreallocated(compiled, (const cJSON * const *)values, buffer, (int)sizeof(buffer)));
+    TEST_ASSERT_EQUAL_STRING(printed, buffer);
+    TEST_ASSERT_FALSE(cJSON_RenderTemplatePreallocated(compiled, (const cJSON * const *)values, buffer, (int)strlen(printed)));
+
+    free(rendered);
+    free(printed);
+    cJSON_Delete(values[0]);
+    cJSON_Delete(values[1]);
+    cJSON_Delete(values[2]);
+    cJSON_Delete(values[3]);
+    cJSON_Delete(filled);
+    cJSON_DeleteTemplate(compiled);
+}
+
+static void templates_should_render_like_print_unformatted(void)
+{
+    assert_rendered_like_printed(false);
+}
+
+static void templates_should_render_like_print(void)
+{
+    assert_rendered_like_printed(true);
+}
+
+static void templates_should_check_the_values(void)
+{
+    cJSON *skeleton = create_skeleton();
+    cJSON_Template *compiled = cJSON_CreateTemplate(skeleton, false);
+    cJSON *values[4];
+
+    TEST_ASSERT_NOT_NULL(compiled);
+    values[0] = cJSON_CreateNumber(1);
+    values[1] = cJSON_CreateNumber(2);
+    values[2] = cJSON_CreateNull();
+    values[3] = cJSON_CreateFalse();
+
+    /* a number for a string */
+    TEST_ASSERT_NULL(cJSON_RenderTemplate(compiled, (const cJSON * const *)values));
+    /* missing values */
+    TEST_ASSERT_NULL(cJSON_RenderTemplate(compiled, NULL));
+    cJSON_Delete(values[1]);
+    values[1] = NULL;
+    TEST_ASSERT_NULL(cJSON_RenderTemplate(compiled, (const cJSON * const *)values));
+    /* slots can't be values */
+    values[1] = cJSON_CreateSlot(cJSON_Invalid);
+    TEST_ASSERT_NULL(cJSON_RenderTemplate(compiled, (const cJSON * const *)values));
+
+    /* trees with slots can't be printed normally */
+    TEST_ASSERT_NULL(cJSON_PrintUnformatted(skeleton));
+
+    cJSON_Delete(values[0]);
+    cJSON_Delete(values[1]);
+    cJSON_Delete(values[2]);
+    cJSON_Delete(values[3]);
+    cJSON_Delete(skeleton);
+    cJSON_DeleteTemplate(compiled);
+}
+
+static void templates_should_handle_edge_cases(void)
+{
+    cJSON *slot = cJSON_CreateSlot(cJSON_Invalid);
+    cJSON *constant = cJSON_Parse("{\"a\":[1,2]}");
+    cJSON_Template *compiled = cJSON_CreateTemplate(slot, false);
+    cJSON *value = cJSON_CreateString("root");
+    char *rendered = NULL;
+
+    /* a slot as the root */
+    TEST_ASSERT_NOT_NULL(compiled);
+    TEST_ASSERT_EQUAL_INT(1, cJSON_GetTemplateSlotCount(compiled));
+    rendered = cJSON_RenderTemplate(compiled, (const cJSON * const *)&value);
+    TEST_ASSERT_EQUAL_STRING("\"root\"", rendered);
+    free(rendered);
+    cJSON_DeleteTemplate(compiled);
+
+    /* no slots at all */
+    compiled = cJSON_CreateTemplate(constant, false);
+    TEST_ASSERT_NOT_NULL(compiled);
+    TEST_ASSERT_EQUAL_INT(0, cJSON_GetTemplateSlotCount(compiled));
+    rendered = cJSON_RenderTemplate(compiled, NULL);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":[1,2]}", rendered);
+    free(rendered);
+    cJSON_DeleteTemplate(compiled);
+
+    TEST_ASSERT_NULL(cJSON_CreateTemplate(NULL, false));
+    TEST_ASSERT_NULL(cJSON_RenderTemplate(NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(0, cJSON_GetTemplateSlotCount(NULL));
+    cJSON_DeleteTemplate(NULL);
+
+    cJSON_Delete(slot);
+    cJSON_Delete(constant);
+    cJSON_Delete(value);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(templates_should_render_like_print_unformatted);
+    RUN_TEST(templates_should_render_like_print);
+    RUN_TEST(templates_should_check_the_values);
+    RUN_TEST(templates_should_handle_edge_cases);
+
+    return UNITY_END();
+}
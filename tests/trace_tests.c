@@ -0,0 +1,135 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* record the probes instead of compiling them out, has to come before cJSON.c is included */
+static void record_probe(const char *probe);
+#define CJSON_TRACE(probe, first, second) record_probe(#probe)
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static const char *probes[] = {"parse_start", "parse_end", "error", "allocate", "node", "buffer_grow", "print_start", "print_end"};
+static int fired[sizeof(probes) / sizeof(probes[0])];
+
+static void record_probe(const char *probe)
+{
+    size_t i = 0;
+    for (i = 0; i < sizeof(probes) / sizeof(probes[0]); i++)
+    {
+        if (strcmp(probes[i], probe) == 0)
+        {
+            fired[i]++;
+            return;
+        }
+    }
+    TEST_FAIL_MESSAGE("unknown probe");
+}
+
+static int count(const char *probe)
+{
+    size_t i = 0;
+    for (i = 0; i < sizeof(probes) / sizeof(probes[0]); i++)
+    {
+        if (strcmp(probes[i], probe) == 0)
+        {
+            return fired[i];
+        }
+    }
+    return -1;
+}
+
+static void reset_probes(void)
+{
+    memset(fired, 0, sizeof(fired));
+}
+
+static void trace_should_fire_on_parse(void)
+{
+    cJSON *item = NULL;
+
+    reset_probes();
+    item = cJSON_Parse("{\"name\": \"a string long enough to be allocated\", \"list\": [1, 2, 3]}");
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_EQUAL_INT(1, count("parse_start"));
+    TEST_ASSERT_EQUAL_INT(1, count("parse_end"));
+    TEST_ASSERT_EQUAL_INT(0, count("error"));
+    TEST_ASSERT_EQUAL_INT(6, count("node"));
+    TEST_ASSERT_TRUE(count("allocate") > 0);
+    cJSON_Delete(item);
+}
+
+static void trace_should_fire_on_errors(void)
+{
+    reset_probes();
+    TEST_ASSERT_NULL(cJSON_Parse("[1, 2,"));
+    TEST_ASSERT_EQUAL_INT(1, count("parse_start"));
+    TEST_ASSERT_EQUAL_INT(1, count("parse_end"));
+    TEST_ASSERT_TRUE(count("error") > 0);
+}
+
+static void trace_should_fire_on_print(void)
+{
+    cJSON *item = cJSON_Parse("[\"a string long enough to make the buffer grow\", 1, 2, 3, 4, 5]");
+    char *printed = NULL;
+    char buffer[256];
+    TEST_ASSERT_NOT_NULL(item);
+
+    reset_probes();
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_NOT_NULL(printed);
+    free(printed);
+    TEST_ASSERT_EQUAL_INT(1, count("print_start"));
+    TEST_ASSERT_EQUAL_INT(1, count("print_end"));
+
+    reset_probes();
+    printed = cJSON_PrintBuffered(item, 1, false);
+    TEST_ASSERT_NOT_NULL(printed);
+    free(printed);
+    TEST_ASSERT_EQUAL_INT(1, count("print_start"));
+    TEST_ASSERT_EQUAL_INT(1, count("print_end"));
+    TEST_ASSERT_TRUE(count("buffer_grow") > 0);
+
+    reset_probes();
+    TEST_ASSERT_TRUE(cJSON_PrintPreallocated(item, buffer, (int)sizeof(buffer), true));
+    TEST_ASSERT_EQUAL_INT(1, count("print_start"));
+    TEST_ASSERT_EQUAL_INT(1, count("print_end"));
+    TEST_ASSERT_EQUAL_INT(0, count("buffer_grow"));
+
+    cJSON_Delete(item);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(trace_should_fire_on_parse);
+    RUN_TEST(trace_should_fire_on_errors);
+    RUN_TEST(trace_should_fire_on_print);
+
+    return UNITY_END();
+}
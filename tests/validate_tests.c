@@ -0,0 +1,241 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static size_t allocations = 0;
+
+static void *counting_malloc(size_t size)
+{
+    allocations++;
+    return malloc(size);
+}
+
+static void normal_free(void *pointer)
+{
+    free(pointer);
+}
+
+/* cJSON_Validate has to agree with cJSON_ParseWithError on the result and the error. */
+static void assert_validates_like_parse(const char *json)
+{
+    cJSON_ParseError parse_error;
+    cJSON_ParseError validate_error;
+    cJSON *parsed = cJSON_ParseWithError(json, NULL, true, &parse_error);
+    cJSON_bool valid = cJSON_Validate(json, strlen(json), &validate_error);
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(parsed != NULL, valid, json);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(parse_error.code, validate_error.code, json);
+    TEST_ASSERT_EQUAL_UINT_MESSAGE(parse_error.position, validate_error.position, json);
+    TEST_ASSERT_EQUAL_UINT_MESSAGE(parse_error.line, validate_error.line, json);
+    TEST_ASSERT_EQUAL_UINT_MESSAGE(parse_error.column, validate_error.column, json);
+
+    cJSON_Delete(parsed);
+}
+
+static void validate_should_accept_the_example_files(void)
+{
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5", "inputs/test7", "inputs/test8", "inputs/test9", "inputs/test10", "inputs/test11" };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        char *json = read_file(files[i]);
+        TEST_ASSERT_NOT_NULL_MESSAGE(json, files[i]);
+        TEST_ASSERT_TRUE_MESSAGE(cJSON_Validate(json, strlen(json), NULL), files[i]);
+        TEST_ASSERT_TRUE_MESSAGE(cJSON_ValidateUTF8(json, strlen(json), NULL), files[i]);
+        assert_validates_like_parse(json);
+        free(json);
+    }
+}
+
+static void validate_should_report_errors_like_parse(void)
+{
+    const char *inputs[] =
+    {
+        "", " ", "nul", "tru", "[", "[1", "[1,", "[1,]", "[1 2]", "{", "{\"a\"", "{\"a\":", "{\"a\":1,}", "{1:2}",
+        "{\"a\" 1}", "{\"a\":1]", "[1}", "[}", "\"abc", "\"a\\", "\"\\x\"", "\"\\u12\"", "\"\\ud800\"", "\"\\udc00\"",
+        "\"\\u0000\"", "-", "01", "1.", "1e", "-a", "1.5e+", "[1] 2", "{} x", "[\n  1,\n  @]", "[[[[[[]]]]]]]",
+        "{\"a\":{\"b\":[{\"c\":\"\\\"\"}]}}", "[true,false,null]", " 12.5e-3 "
+    };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(inputs) / sizeof(inputs[0])); i++)
+    {
+        assert_validates_like_parse(inputs[i]);
+    }
+}
+
+static void validate_should_limit_the_nesting_depth(void)
+{
+    char *json = (char*)malloc(2 * (CJSON_NESTING_LIMIT + 1) + 1);
+    cJSON_ParseError error;
+
+    TEST_ASSERT_NOT_NULL(json);
+    memset(json, '[', CJSON_NESTING_LIMIT);
+    memset(json + CJSON_NESTING_LIMIT, ']', CJSON_NESTING_LIMIT);
+    json[2 * CJSON_NESTING_LIMIT] = '\0';
+    TEST_ASSERT_TRUE(cJSON_Validate(json, strlen(json), NULL));
+
+    memset(json, '[', CJSON_NESTING_LIMIT + 1);
+    memset(json + CJSON_NESTING_LIMIT + 1, ']', CJSON_NESTING_LIMIT + 1);
+    json[2 * (CJSON_NESTING_LIMIT + 1)] = '\0';
+    TEST_ASSERT_FALSE(cJSON_Validate(json, strlen(json), &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_TooDeep, error.code);
+    TEST_ASSERT_EQUAL_UINT(CJSON_NESTING_LIMIT, error.position);
+
+    free(json);
+}
+
+static void validate_utf8_should_reject_malformed_utf8(void)
+{
+    const char *valid[] = { "\"\xc3\xa4\"", "{\"\xe2\x82\xac\":\"\xf0\x9f\x98\x80\"}", "\"\xed\x9f\xbf \xf4\x8f\xbf\xbf\"", "\"0123456789abcdef0123456789abcdef\xc3\xa4\"" };
+    const char *invalid[] = { "\"\xc3\"", "\"\xc0\xaf\"", "\"\xe0\x80\xaf\"", "\"\xed\xa0\x80\"", "\"\xf4\x90\x80\x80\"", "\"\xff\"", "{\"a\xc3\":1}", "\"0123456789abcdef0123456789abcdef\x80\"" };
+    const size_t positions[] = { 1, 1, 1, 1, 1, 1, 3, 33 };
+    cJSON_ParseError error;
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(valid) / sizeof(valid[0])); i++)
+    {
+        TEST_ASSERT_TRUE_MESSAGE(cJSON_ValidateUTF8(valid[i], strlen(valid[i]), NULL), valid[i]);
+    }
+    for (i = 0; i < (sizeof(invalid) / sizeof(invalid[0])); i++)
+    {
+        /* only the strict check looks at the bytes */
+        TEST_ASSERT_TRUE(cJSON_Validate(invalid[i], strlen(invalid[i]), NULL));
+        TEST_ASSERT_FALSE(cJSON_ValidateUTF8(invalid[i], strlen(invalid[i]), &error));
+        TEST_ASSERT_EQUAL_INT(cJSON_Error_InvalidUTF8, error.code);
+        TEST_ASSERT_EQUAL_UINT(positions[i], error.position);
+    }
+}
+
+static void strict_parse_should_reject_malformed_utf8_like_validate(void)
+{
+    const char *inputs[] = { "\"\xc3\"", "\"\xc0\xaf\"", "\"\xed\xa0\x80\"", "\"\xf4\x90\x80\x80\"", "{\"a\xc3\":1}", "[\"ok\",\"\\n\xff\"]", "\"\xc3\\n\"", "\"0123456789abcdef0123456789abcdef\x80\"" };
+    cJSON_ParseError parse_error;
+    cJSON_ParseError validate_error;
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(inputs) / sizeof(inputs[0])); i++)
+    {
+        cJSON *item = cJSON_ParseWithLength(inputs[i], strlen(inputs[i]));
+        TEST_ASSERT_NOT_NULL_MESSAGE(item, inputs[i]);
+        cJSON_Delete(item);
+
+        TEST_ASSERT_NULL(cJSON_ParseStrictUTF8(inputs[i], strlen(inputs[i]), &parse_error));
+        TEST_ASSERT_FALSE(cJSON_ValidateUTF8(inputs[i], strlen(inputs[i]), &validate_error));
+        TEST_ASSERT_EQUAL_INT(cJSON_Error_InvalidUTF8, parse_error.code);
+        TEST_ASSERT_EQUAL_UINT_MESSAGE(validate_error.position, parse_error.position, inputs[i]);
+    }
+}
+
+static void strict_parse_should_accept_well_formed_utf8(void)
+{
+    const char json[] = "{\"\xc3\xa4\":[\"\xe2\x82\xac\\u00e4\xf0\x9f\x98\x80\",\"\\ud83d\\ude00\"]}";
+    cJSON_ParseError error;
+    cJSON *item = cJSON_ParseStrictUTF8(json, strlen(json), &error);
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_None, error.code);
+    TEST_ASSERT_EQUAL_STRING("\xe2\x82\xac\xc3\xa4\xf0\x9f\x98\x80", cJSON_GetArrayItem(cJSON_GetObjectItem(item, "\xc3\xa4"), 0)->valuestring);
+
+    printed = cJSON_PrintStrictUTF8(item, false);
+    TEST_ASSERT_EQUAL_STRING("{\"\xc3\xa4\":[\"\xe2\x82\xac\xc3\xa4\xf0\x9f\x98\x80\",\"\xf0\x9f\x98\x80\"]}", printed);
+    free(printed);
+    cJSON_Delete(item);
+
+    /* only whitespace may follow */
+    TEST_ASSERT_NULL(cJSON_ParseStrictUTF8("[] x", 4, &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_TrailingCharacters, error.code);
+}
+
+static void strict_print_should_reject_malformed_utf8(void)
+{
+    cJSON *object = cJSON_CreateObject();
+    char *printed = NULL;
+
+    cJSON_AddItemToObject(object, "name", cJSON_CreateString("\xc3\xa4"));
+    printed = cJSON_PrintStrictUTF8(object, true);
+    TEST_ASSERT_NOT_NULL(printed);
+    free(printed);
+
+    cJSON_AddItemToObject(object, "bad\xc3", cJSON_CreateNull());
+    TEST_ASSERT_NULL(cJSON_PrintStrictUTF8(object, true));
+    cJSON_DeleteItemFromObject(object, "bad\xc3");
+
+    cJSON_AddItemToObject(object, "value", cJSON_CreateString("\xed\xa0\x80"));
+    TEST_ASSERT_NULL(cJSON_PrintStrictUTF8(object, false));
+
+    /* the usual printing copies the bytes */
+    printed = cJSON_PrintUnformatted(object);
+    TEST_ASSERT_NOT_NULL(printed);
+    free(printed);
+
+    cJSON_Delete(object);
+}
+
+static void validate_should_not_allocate(void)
+{
+    cJSON_Hooks hooks;
+    char *json = read_file("inputs/test7");
+
+    TEST_ASSERT_NOT_NULL(json);
+    hooks.malloc_fn = counting_malloc;
+    hooks.free_fn = normal_free;
+    cJSON_InitHooks(&hooks);
+
+    allocations = 0;
+    TEST_ASSERT_TRUE(cJSON_ValidateUTF8(json, strlen(json), NULL));
+    TEST_ASSERT_FALSE(cJSON_Validate("[1,2,{\"a\":]", 12, NULL));
+    TEST_ASSERT_EQUAL_UINT(0, allocations);
+
+    cJSON_InitHooks(NULL);
+    free(json);
+
+    /* the length limits the input */
+    TEST_ASSERT_TRUE(cJSON_Validate("[1] garbage", 3, NULL));
+    TEST_ASSERT_FALSE(cJSON_Validate(NULL, 0, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(validate_should_accept_the_example_files);
+    RUN_TEST(validate_should_report_errors_like_parse);
+    RUN_TEST(validate_should_limit_the_nesting_depth);
+    RUN_TEST(validate_utf8_should_reject_malformed_utf8);
+    RUN_TEST(strict_parse_should_reject_malformed_utf8_like_validate);
+    RUN_TEST(strict_parse_should_accept_well_formed_utf8);
+    RUN_TEST(strict_print_should_reject_malformed_utf8);
+    RUN_TEST(validate_should_not_allocate);
+
+    return UNITY_END();
+}
@@ -0,0 +1,240 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static const char base_json[] = "{\"name\":\"base\",\"limits\":{\"cpu\":2,\"memory\":512},\"list\":[1,[2,3],\"four\"],\"a/b~c\":true}";
+
+static void assert_printed(const char * const expected, const cJSON * const item)
+{
+    char *printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+    free(printed);
+}
+
+static void view_should_share_the_document(void)
+{
+    cJSON_Shared *shared = cJSON_CreateShared(cJSON_Parse(base_json));
+    cJSON_View *view = NULL;
+    cJSON *root = NULL;
+
+    TEST_ASSERT_NOT_NULL(shared);
+    view = cJSON_CreateView(shared);
+    TEST_ASSERT_NOT_NULL(view);
+
+    root = cJSON_GetViewRoot(view);
+    TEST_ASSERT_BITS_HIGH(cJSON_IsReference, root->type);
+    TEST_ASSERT_TRUE(root->child == cJSON_GetSharedDocument(shared)->child);
+    assert_printed(base_json, root);
+
+    /* the owner can go first */
+    cJSON_ReleaseShared(shared);
+    assert_printed(base_json, cJSON_GetViewRoot(view));
+    cJSON_DeleteView(view);
+}
+
+static void view_should_copy_only_the_changed_path(void)
+{
+    cJSON_Shared *shared = cJSON_CreateShared(cJSON_Parse(base_json));
+    const cJSON *document = cJSON_GetSharedDocument(shared);
+    cJSON_View *first = cJSON_CreateView(shared);
+    cJSON_View *second = cJSON_CreateView(shared);
+    cJSON *limits = NULL;
+    cJSON *item = NULL;
+
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+
+    limits = cJSON_GetWritableViewItem(first, "/limits");
+    TEST_ASSERT_NOT_NULL(limits);
+    cJSON_ReplaceItemInObject(limits, "cpu", cJSON_CreateNumber(8));
+    cJSON_AddItemToObject(limits, "disk", cJSON_CreateNumber(100));
+
+    item = cJSON_GetWritableViewItem(first, "/list/2");
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_EQUAL_STRING("four", item->valuestring);
+    TEST_ASSERT_TRUE(item->valuestring != cJSON_GetArrayItem(cJSON_GetObjectItem(document, "list"), 2)->valuestring);
+    if (!cJSON_IsInlineString(item, item->valuestring))
+    {
+        global_hooks.deallocate(item->valuestring);
+    }
+    item->valuestring = (char*)cJSON_strdup((const unsigned char*)"five", &global_hooks);
+
+    item = cJSON_GetWritableViewItem(second, "/list/1");
+    TEST_ASSERT_NOT_NULL(item);
+    cJSON_DeleteItemFromArray(item, 0);
+
+    assert_printed("{\"name\":\"base\",\"limits\":{\"cpu\":8,\"memory\":512,\"disk\":100},\"list\":[1,[2,3],\"five\"],\"a/b~c\":true}", cJSON_GetViewRoot(first));
+    assert_printed("{\"name\":\"base\",\"limits\":{\"cpu\":2,\"memory\":512},\"list\":[1,[3],\"four\"],\"a/b~c\":true}", cJSON_GetViewRoot(second));
+    assert_printed(base_json, document);
+
+    /* siblings of the changed path are still shared */
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(cJSON_GetViewRoot(first), "list")->child->next->child == cJSON_GetArrayItem(cJSON_GetObjectItem(document, "list"), 1)->child);
+
+    cJSON_DeleteView(first);
+    cJSON_ReleaseShared(shared);
+    cJSON_DeleteView(second);
+}
+
+static void view_should_follow_json_pointers(void)
+{
+    cJSON_Shared *shared = cJSON_CreateShared(cJSON_Parse(base_json));
+    cJSON_View *view = cJSON_CreateView(shared);
+
+    TEST_ASSERT_NOT_NULL(view);
+    TEST_ASSERT_TRUE(cJSON_GetWritableViewItem(view, "") == cJSON_GetViewRoot(view));
+    TEST_ASSERT_TRUE(cJSON_IsTrue(cJSON_GetWritableViewItem(view, "/a~1b~0c")));
+    TEST_ASSERT_EQUAL_INT(2, cJSON_GetWritableViewItem(view, "/list/1/0")->valueint);
+
+    TEST_ASSERT_NULL(cJSON_GetWritableViewItem(view, "limits"));
+    TEST_ASSERT_NULL(cJSON_GetWritableViewItem(view, "/missing"));
+    TEST_ASSERT_NULL(cJSON_GetWritableViewItem(view, "/list/3"));
+    TEST_ASSERT_NULL(cJSON_GetWritableViewItem(view, "/list/01"));
+    TEST_ASSERT_NULL(cJSON_GetWritableViewItem(view, "/list/"));
+    TEST_ASSERT_NULL(cJSON_GetWritableViewItem(view, "/a~2b"));
+    TEST_ASSERT_NULL(cJSON_GetWritableViewItem(view, "/name/x"));
+    TEST_ASSERT_NULL(cJSON_GetWritableViewItem(view, NULL));
+    TEST_ASSERT_NULL(cJSON_GetWritableViewItem(NULL, ""));
+
+    cJSON_DeleteView(view);
+    cJSON_ReleaseShared(shared);
+}
+
+static void parse_cache_should_share_documents_of_the_same_input(void)
+{
+    cJSON_ParseCache *cache = cJSON_CreateParseCache(1 << 20);
+    cJSON_View *first = NULL;
+    cJSON_View *second = NULL;
+    cJSON_ParseError error;
+    size_t usage = 0;
+
+    TEST_ASSERT_NOT_NULL(cache);
+    first = cJSON_ParseCached(cache, base_json, strlen(base_json), &error);
+    TEST_ASSERT_NOT_NULL(first);
+    usage = cJSON_GetParseCacheUsage(cache);
+    TEST_ASSERT_TRUE(usage > 0);
+
+    second = cJSON_ParseCached(cache, base_json, strlen(base_json), &error);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_None, error.code);
+    TEST_ASSERT_TRUE(cJSON_GetViewRoot(first)->child == cJSON_GetViewRoot(second)->child);
+    TEST_ASSERT_EQUAL_UINT(usage, cJSON_GetParseCacheUsage(cache));
+
+    /* views are copy on write */
+    cJSON_ReplaceItemInObject(cJSON_GetWritableViewItem(second, ""), "name", cJSON_CreateString("changed"));
+    assert_printed(base_json, cJSON_GetViewRoot(first));
+    cJSON_DeleteView(second);
+
+    /* a prefix is a different input */
+    second = cJSON_ParseCached(cache, "[1] ", 3, &error);
+    assert_printed("[1]", cJSON_GetViewRoot(second));
+    cJSON_DeleteView(second);
+
+    /* invalid JSON isn't cached */
+    TEST_ASSERT_NULL(cJSON_ParseCached(cache, "[1,", 3, &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_UnexpectedEnd, error.code);
+    TEST_ASSERT_NULL(cJSON_ParseCached(cache, "[1] x", 5, &error));
+    TEST_ASSERT_EQUAL_INT(cJSON_Error_TrailingCharacters, error.code);
+
+    /* views outlive the cache */
+    cJSON_DeleteParseCache(cache);
+    assert_printed(base_json, cJSON_GetViewRoot(first));
+    cJSON_DeleteView(first);
+}
+
+static void parse_cache_should_evict_the_least_recently_used(void)
+{
+    char inputs[40][16];
+    cJSON_ParseCache *cache = NULL;
+    cJSON_View *view = NULL;
+    size_t budget = 0;
+    size_t i = 0;
+
+    for (i = 0; i < 40; i++)
+    {
+        sprintf(inputs[i], "[%lu]", (unsigned long)i);
+    }
+
+    /* measure what one entry costs */
+    cache = cJSON_CreateParseCache((size_t)-1);
+    cJSON_DeleteView(cJSON_ParseCached(cache, inputs[10], strlen(inputs[10]), NULL));
+    budget = cJSON_GetParseCacheUsage(cache) * 4;
+    cJSON_DeleteParseCache(cache);
+
+    cache = cJSON_CreateParseCache(budget);
+    TEST_ASSERT_NOT_NULL(cache);
+    for (i = 10; i < 40; i++)
+    {
+        view = cJSON_ParseCached(cache, inputs[i], strlen(inputs[i]), NULL);
+        TEST_ASSERT_NOT_NULL(view);
+        TEST_ASSERT_EQUAL_INT((int)i, cJSON_GetArrayItem(cJSON_GetViewRoot(view), 0)->valueint);
+        cJSON_DeleteView(view);
+        TEST_ASSERT_TRUE(cJSON_GetParseCacheUsage(cache) <= budget);
+
+        /* [10] stays in use */
+        cJSON_DeleteView(cJSON_ParseCached(cache, inputs[10], strlen(inputs[10]), NULL));
+    }
+    TEST_ASSERT_EQUAL_UINT(budget, cJSON_GetParseCacheUsage(cache));
+    TEST_ASSERT_EQUAL_UINT(4, cache->count);
+    TEST_ASSERT_TRUE(cache->newest->length == strlen(inputs[10]) && (memcmp(cache->newest->text, inputs[10], 4) == 0));
+    cJSON_DeleteParseCache(cache);
+
+    /* too large for the budget, it is parsed but not kept */
+    cache = cJSON_CreateParseCache(16);
+    view = cJSON_ParseCached(cache, base_json, strlen(base_json), NULL);
+    TEST_ASSERT_NOT_NULL(view);
+    TEST_ASSERT_EQUAL_UINT(0, cJSON_GetParseCacheUsage(cache));
+    assert_printed(base_json, cJSON_GetViewRoot(view));
+    cJSON_DeleteView(view);
+    cJSON_DeleteParseCache(cache);
+}
+
+static void shared_functions_should_handle_null(void)
+{
+    TEST_ASSERT_NULL(cJSON_CreateShared(NULL));
+    TEST_ASSERT_NULL(cJSON_GetSharedDocument(NULL));
+    TEST_ASSERT_NULL(cJSON_CreateView(NULL));
+    TEST_ASSERT_NULL(cJSON_GetViewRoot(NULL));
+    cJSON_ReleaseShared(NULL);
+    cJSON_DeleteView(NULL);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(view_should_share_the_document);
+    RUN_TEST(view_should_copy_only_the_changed_path);
+    RUN_TEST(view_should_follow_json_pointers);
+    RUN_TEST(parse_cache_should_share_documents_of_the_same_input);
+    RUN_TEST(parse_cache_should_evict_the_least_recently_used);
+    RUN_TEST(shared_functions_should_handle_null);
+
+    return UNITY_END();
+}